@@ -845,7 +845,7 @@ def handle_conn(conn, addr):
                             cell_id = kpi.get("cellObjectID", "N/A")
                             print(f"[AI-DUMMY] Recommendation request filtered: cellId={cell_id}")
                     # Send reply (for backward compatibility with polling mode)
-                    reply = json.dumps({"no_action": True}).encode("utf-8")
+                    reply = json.dumps({"type": "recommendation", "id": msg.get("id"), "no_action": True}).encode("utf-8")
                     conn.sendall(struct.pack("!I", len(reply)) + reply)
                 else:
                     # Fallback: print raw JSON for unknown types
@@ -36,6 +36,10 @@ MAX_FRAME = 1024 * 1024  # 1MB max frame size
 xapp_connections = {}  # {addr: conn} - connections from xApp
 ai_connection = None  # Connection to external AI server
 connections_lock = threading.Lock()
+# Outstanding recommendation requests, oldest first: [(xapp addr, request id)]
+# The AI replies {"type":"recommendation","id":N,...}; an untagged reply
+# answers the oldest request
+pending_recommendations = []
 
 # CSV output files
 CSV_GNB_FILE = "gnb_kpis.csv"
@@ -218,8 +222,128 @@ def process_kpi_for_csv(msg):
     except Exception as e:
         print(f"[RELAY] Error processing KPI for CSV: {e}")
 
-def recv_framed(conn):
-    """Receive a length-prefixed frame from connection"""
+# Version byte of the binary KPI frames of the xApp (AI_KPI_FORMAT=binary),
+# see kpm_binary_encoder.h; a JSON frame starts with '{'
+KPI_BINARY_VERSION = 1
+
+RRC_EVENTS = {0: "b1", 1: "a3", 2: "a5", 3: "periodic"}
+
+class KpiBinaryReader:
+    """Cursor over a binary KPI frame, integers in network byte order"""
+    def __init__(self, data):
+        self.data = data
+        self.off = 0
+
+    def unpack(self, fmt):
+        values = struct.unpack_from(fmt, self.data, self.off)
+        self.off += struct.calcsize(fmt)
+        return values
+
+    def u8(self):
+        self.off += 1
+        return self.data[self.off - 1]
+
+    def str(self):
+        n = self.u8()
+        self.off += n
+        return self.data[self.off - n:self.off]
+
+def decode_kpi_binary(data):
+    """Decode a binary KPI frame to the message of the JSON encoding:
+    {"type":"kpi","meid":...,"kpi":{"serviceModel":"KPM","format":"F1",...}}"""
+    r = KpiBinaryReader(data)
+    version, flags, rx_time = r.unpack("!BBQ")
+    if version != KPI_BINARY_VERSION:
+        raise ValueError(f"unsupported binary KPI version {version}")
+    kpi = {"serviceModel": "KPM", "format": "F1", "rxTime": rx_time}
+    if flags & 1:
+        kpi["collectionStartTime"] = r.unpack("!Q")[0]
+    meid = r.str().decode("utf-8", "replace")
+    cell_id = r.str()
+    if cell_id:
+        kpi["cellObjectID"] = cell_id.decode("utf-8", "replace")
+    node_id, pm_containers = r.unpack("!iI")
+    if node_id >= 0:
+        kpi["node_id"] = node_id
+    names = []  # the names of the measurements, in the order of their first occurrence
+
+    def signal_quality(r):
+        mask = r.u8()
+        sq = {}
+        for bit, key in ((1, "rsrp"), (2, "rsrq"), (4, "sinr")):
+            if mask & bit:
+                sq[key] = r.u8()
+        return sq
+
+    def measurement(r):
+        tag = r.u8()
+        meas = {}
+        kind, value = tag & 0x0F, tag >> 4
+        if kind == 1:
+            names.append(r.str().decode("utf-8", "replace"))
+            meas["name"] = names[-1]
+        elif kind == 2:
+            meas["id"] = r.unpack("!I")[0]
+        elif kind == 3:
+            meas["name"] = names[r.unpack("!H")[0]]
+        if value == 1:
+            meas["value"] = r.unpack("!q")[0]
+        elif value == 2:
+            meas["value"] = r.unpack("!d")[0]
+        elif value == 3:
+            meas["value"] = None
+        elif value == 4:
+            event = r.u8()
+            meas["rrcEvent"] = RRC_EVENTS.get(event, str(event))
+            serving = r.u8()
+            if serving == 1:
+                cells = []
+                for _ in range(r.u8()):
+                    cell = {"servCellId": r.u8()}
+                    sq = signal_quality(r)
+                    if sq:
+                        cell["signalQuality"] = sq
+                    cells.append(cell)
+                if cells:
+                    meas["servingCells"] = cells
+            elif serving == 2:
+                pci, rsrp, rsrq = r.unpack("!HBB")
+                meas["servingCell"] = {"physCellId": pci, "rsrp": rsrp, "rsrq": rsrq}
+            neighbors = []
+            for _ in range(r.u8()):
+                cell = {}
+                if r.u8() & 1:
+                    cell["physCellId"] = r.unpack("!H")[0]
+                sq = signal_quality(r)
+                if sq:
+                    cell["signalQuality"] = sq
+                neighbors.append(cell)
+            if neighbors:
+                meas["neighborCells"] = neighbors
+        return meas
+
+    count = r.unpack("!H")[0]
+    if count:
+        kpi["measurements"] = [measurement(r) for _ in range(count)]
+    count = r.unpack("!H")[0]
+    if count:
+        ues = []
+        for _ in range(count):
+            ue = {}
+            ue_id = r.str()
+            if ue_id:
+                ue["ueId"] = ue_id.hex()
+            ue["node_id"] = r.unpack("!i")[0]
+            n = r.unpack("!H")[0]
+            if n:
+                ue["measurements"] = [measurement(r) for _ in range(n)]
+            ues.append(ue)
+        kpi["ues"] = ues
+    kpi["pmContainers"] = pm_containers
+    return {"type": "kpi", "meid": meid, "kpi": kpi}
+
+def recv_frame_bytes(conn):
+    """Receive a length-prefixed frame from connection, as bytes"""
     try:
         # Read length (4 bytes, network byte order)
         len_data = conn.recv(4)
@@ -239,11 +363,16 @@ def recv_framed(conn):
                 return None
             msg_data += chunk
         
-        return msg_data.decode("utf-8")
+        return msg_data
     except Exception as e:
         print(f"[RELAY] Error receiving framed message: {e}")
         return None
 
+def recv_framed(conn):
+    """Receive a length-prefixed frame from connection"""
+    data = recv_frame_bytes(conn)
+    return None if data is None else data.decode("utf-8")
+
 def send_framed(conn, text):
     """Send a length-prefixed frame to connection"""
     try:
@@ -313,6 +442,26 @@ def receive_from_ai(conn):
                                         print(f"[RELAY] ❌ Failed to forward to xApp {addr}")
                                 except Exception as e:
                                     print(f"[RELAY] ❌ Error forwarding to xApp {addr}: {e}")
+                elif msg_type == "recommendation" or (msg_type == "unknown" and pending_recommendations):
+                    # Reply to a recommendation request, forwarded to the xApp
+                    # that sent it; an untagged reply answers the oldest one
+                    with connections_lock:
+                        target = None
+                        for request in pending_recommendations:
+                            if msg_type == "unknown" or request[1] == msg.get("id"):
+                                target = request
+                                break
+                        if target is None:
+                            print(f"[RELAY] ⚠️  Recommendation for no outstanding request, dropping: {text[:200]}")
+                            continue
+                        pending_recommendations.remove(target)
+                        if msg_type == "unknown":
+                            text = json.dumps({"type": "recommendation", "id": target[1], "cmd": msg}
+                                              if "no_action" not in msg else
+                                              {"type": "recommendation", "id": target[1], "no_action": True})
+                        xapp_conn = xapp_connections.get(target[0])
+                        if xapp_conn is None or not send_framed(xapp_conn, text):
+                            print(f"[RELAY] ❌ Failed to forward recommendation to xApp {target[0]}")
                 else:
                     print(f"[RELAY] ⚠️  Unknown message type from AI: {msg_type}")
                     
@@ -329,6 +478,12 @@ def receive_from_ai(conn):
     finally:
         with connections_lock:
             ai_connection = None
+            # the replies to the outstanding requests are lost with the AI
+            for addr, request_id in pending_recommendations:
+                xapp_conn = xapp_connections.get(addr)
+                if xapp_conn is not None:
+                    send_framed(xapp_conn, json.dumps({"type": "recommendation", "id": request_id, "no_action": True}))
+            pending_recommendations.clear()
         conn.close()
         print(f"[RELAY] Reconnecting to external AI...")
         # Reconnect in background
@@ -345,15 +500,21 @@ def handle_xapp_connection(conn, addr):
     
     try:
         while True:
-            text = recv_framed(conn)
-            if text is None:
+            data = recv_frame_bytes(conn)
+            if data is None:
                 break
             
             try:
-                msg = json.loads(text)
+                if data[0] == KPI_BINARY_VERSION:
+                    # binary KPI, forwarded as JSON so that the AI sees a single format
+                    msg = decode_kpi_binary(data)
+                    text = json.dumps(msg)
+                else:
+                    text = data.decode("utf-8")
+                    msg = json.loads(text)
                 msg_type = msg.get("type", "unknown")
                 
-                print(f"[RELAY] ← Received from xApp {addr}: type={msg_type}, size={len(text)} bytes")
+                print(f"[RELAY] ← Received from xApp {addr}: type={msg_type}, size={len(data)} bytes")
                 
                 if msg_type == "kpi":
                     # Write KPI to CSV files
@@ -377,38 +538,34 @@ def handle_xapp_connection(conn, addr):
                                 with connections_lock:
                                     ai_connection = None
                 elif msg_type == "recommendation_request":
-                    # Forward recommendation request to external AI
+                    # Forward recommendation request to external AI; the reply
+                    # is forwarded back by receive_from_ai, so that several
+                    # requests can be outstanding
                     meid = msg.get("meid", "unknown")
-                    print(f"[RELAY] → Forwarding recommendation request to external AI: meid={meid}")
+                    request_id = msg.get("id")
+                    no_action = json.dumps({"type": "recommendation", "id": request_id, "no_action": True})
+                    print(f"[RELAY] → Forwarding recommendation request {request_id} to external AI: meid={meid}")
                     
                     with connections_lock:
                         if ai_connection is None:
                             print(f"[RELAY] ⚠️  External AI not connected, dropping request")
-                            # Send empty response back to xApp
-                            reply = json.dumps({"no_action": True})
-                            send_framed(conn, reply)
+                            send_framed(conn, no_action)
                         else:
                             try:
-                                if send_framed(ai_connection, text):
-                                    # Wait for response from AI and forward back to xApp
-                                    response = recv_framed(ai_connection)
-                                    if response:
-                                        print(f"[RELAY] ← Received recommendation response from AI, forwarding to xApp")
-                                        send_framed(conn, response)
-                                    else:
-                                        print(f"[RELAY] ❌ No response from AI, sending no_action")
-                                        reply = json.dumps({"no_action": True})
-                                        send_framed(conn, reply)
-                                else:
+                                pending_recommendations.append((addr, request_id))
+                                if not send_framed(ai_connection, text):
                                     print(f"[RELAY] ❌ Failed to forward recommendation request")
-                                    reply = json.dumps({"no_action": True})
-                                    send_framed(conn, reply)
+                                    pending_recommendations.remove((addr, request_id))
+                                    send_framed(conn, no_action)
                             except Exception as e:
                                 print(f"[RELAY] ❌ Error forwarding recommendation request: {e}")
-                                with connections_lock:
-                                    ai_connection = None
-                                reply = json.dumps({"no_action": True})
-                                send_framed(conn, reply)
+                                ai_connection = None
+                                send_framed(conn, no_action)
+                elif msg_type == "control_result":
+                    # Forward the result of a control command to external AI
+                    with connections_lock:
+                        if ai_connection is not None:
+                            send_framed(ai_connection, text)
                 else:
                     print(f"[RELAY] ⚠️  Unknown message type from xApp: {msg_type}")
                     
@@ -63,6 +63,8 @@ rte|10092|$E2MGR_IP:4801
 rte|1101|$E2TERM_IP:38000
 rte|1102|$E2MGR_IP:3801
 rte|12001|$E2MGR_IP:3801
+rte|12041|$XAPP_IP:4560
+rte|12042|$XAPP_IP:4560
 mse|12050|$(echo $XAPP_IP | cut -d "." -f 4)|$XAPP_IP:4560
 newrt|end
 EOF
@@ -0,0 +1,310 @@
+/*
+ * kpm_encode_bench.cc
+ *
+ * Cost of the KPI reports sent to the AI: bytes per report and encode time,
+ * JSON vs binary (kpm_binary_encoder.h), for DU reports of 10, 100 and 500
+ * UEs. The reports go through procRicIndication, as the received ones; the
+ * time of the decode of the KPM message, common to both, is given apart.
+ *
+ *   make kpm_encode_bench && ./kpm_encode_bench [ues...]
+ */
+
+#include "xapp-mgmt/msgs_proc.hpp"
+#include "xapp-mgmt/kpm_binary_encoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "E2AP-PDU.h"
+#include "InitiatingMessage.h"
+#include "RICindication.h"
+#include "ProtocolIE-Field.h"
+#include "E2SM-KPM-IndicationHeader.h"
+#include "E2SM-KPM-IndicationHeader-Format1.h"
+#include "GlobalE2node-gNB-ID.h"
+#include "E2SM-KPM-IndicationMessage.h"
+#include "E2SM-KPM-IndicationMessage-Format1.h"
+#include "PM-Containers-Item.h"
+#include "PM-Info-Item.h"
+#include "PerUE-PM-Item.h"
+#include "L3-RRC-Measurements.h"
+#include "ServingCellMeasurements.h"
+#include "MeasResultNeighCells.h"
+#include "MeasResultServMOList.h"
+#include "MeasResultServMO.h"
+#include "MeasResultListNR.h"
+#include "MeasResultNR.h"
+#include "MeasQuantityResults.h"
+}
+
+namespace {
+
+const char* kMeid = "gnb:131-133-31000000";
+
+// per UE measurements of the ns-3 DU and CU-UP reports
+const char* kUeMeasurements[] = {
+    "DRB.UEThpDl.UEID", "DRB.PdcpSduVolumeDl_Filter.UEID", "Tot.PdcpSduNbrDl.UEID",
+    "DRB.PdcpPduNbrDl.Qos.UEID", "DRB.PdcpSduDelayDl.UEID", "QosFlow.PdcpPduVolumeDL_Filter.UEID",
+    "RRU.PrbUsedDl.UEID", "TB.TotNbrDl.1.UEID", "TB.TotNbrDlInitial.Qpsk.UEID",
+    "TB.TotNbrDlInitial.16Qam.UEID", "TB.TotNbrDlInitial.64Qam.UEID", "DRB.BufferSize.Qos.UEID",
+};
+
+const char* kCellMeasurements[] = {
+    "RRU.PrbUsedDl", "RRU.PrbAvailDl", "TB.TotNbrDl.1", "DRB.MeanActiveUeDl",
+    "TB.TotNbrDlInitial", "TB.ErrTotalNbrDl.1", "RRC.ConnMean", "DRB.UEThpDl",
+};
+
+template <class T>
+T* alloc() {
+    return static_cast<T*>(calloc(1, sizeof(T)));
+}
+
+long* alloc_long(long v) {
+    long* p = alloc<long>();
+    *p = v;
+    return p;
+}
+
+PM_Info_Item_t* make_measurement(const char* name, size_t i) {
+    PM_Info_Item_t* item = alloc<PM_Info_Item_t>();
+    item->pmType.present = MeasurementType_PR_measName;
+    OCTET_STRING_fromString(&item->pmType.choice.measName, name);
+    if (i % 3 == 2) {
+        item->pmVal.present = MeasurementValue_PR_valueReal;
+        item->pmVal.choice.valueReal = 1234.5678 * (i + 1);
+    } else {
+        item->pmVal.present = MeasurementValue_PR_valueInt;
+        item->pmVal.choice.valueInt = long(100000 * (i + 1) + i);
+    }
+    return item;
+}
+
+MeasQuantityResults_t* make_signal_quality(long v) {
+    MeasQuantityResults_t* mq = alloc<MeasQuantityResults_t>();
+    mq->rsrp = alloc_long(v % 128);
+    mq->rsrq = alloc_long((v + 7) % 128);
+    mq->sinr = alloc_long((v + 13) % 128);
+    return mq;
+}
+
+// the L3 serving and neighbour cell measurements of a UE
+PM_Info_Item_t* make_rrc_measurement(size_t ue) {
+    PM_Info_Item_t* item = alloc<PM_Info_Item_t>();
+    item->pmType.present = MeasurementType_PR_measName;
+    OCTET_STRING_fromString(&item->pmType.choice.measName, "HO.SrcCellQual.RS-SINR.UEID");
+    item->pmVal.present = MeasurementValue_PR_valueRRC;
+    L3_RRC_Measurements_t* rrc = alloc<L3_RRC_Measurements_t>();
+    item->pmVal.choice.valueRRC = rrc;
+    rrc->rrcEvent = RRCEvent_periodic;
+
+    rrc->servingCellMeasurements = alloc<ServingCellMeasurements_t>();
+    rrc->servingCellMeasurements->present = ServingCellMeasurements_PR_nr_measResultServingMOList;
+    MeasResultServMOList_t* serving = alloc<MeasResultServMOList_t>();
+    rrc->servingCellMeasurements->choice.nr_measResultServingMOList = serving;
+    MeasResultServMO_t* mo = alloc<MeasResultServMO_t>();
+    mo->servCellId = 1;
+    mo->measResultServingCell.physCellId = alloc_long(1111 % 1008);
+    mo->measResultServingCell.measResult.cellResults.resultsSSB_Cell = make_signal_quality(long(ue));
+    ASN_SEQUENCE_ADD(&serving->list, mo);
+
+    rrc->measResultNeighCells = alloc<MeasResultNeighCells_t>();
+    rrc->measResultNeighCells->present = MeasResultNeighCells_PR_measResultListNR;
+    MeasResultListNR_t* neighbours = alloc<MeasResultListNR_t>();
+    rrc->measResultNeighCells->choice.measResultListNR = neighbours;
+    for (long n = 0; n < 4; n++) {
+        MeasResultNR_t* nr = alloc<MeasResultNR_t>();
+        nr->physCellId = alloc_long(n + 2);
+        nr->measResult.cellResults.resultsSSB_Cell = make_signal_quality(long(ue) + n);
+        ASN_SEQUENCE_ADD(&neighbours->list, nr);
+    }
+    return item;
+}
+
+// PER encoding of a KPM Format1 report of ues UEs
+std::vector<uint8_t> make_report(size_t ues) {
+    E2SM_KPM_IndicationMessage_t* kpm = alloc<E2SM_KPM_IndicationMessage_t>();
+    kpm->present = E2SM_KPM_IndicationMessage_PR_indicationMessage_Format1;
+    E2SM_KPM_IndicationMessage_Format1_t* f1 = alloc<E2SM_KPM_IndicationMessage_Format1_t>();
+    kpm->choice.indicationMessage_Format1 = f1;
+    OCTET_STRING_fromString(&f1->cellObjectID, "1111");
+    // the containers are not in the KPI reports, but one is mandatory
+    ASN_SEQUENCE_ADD(&f1->pm_Containers.list, alloc<PM_Containers_Item_t>());
+
+    f1->list_of_PM_Information = alloc<E2SM_KPM_IndicationMessage_Format1::E2SM_KPM_IndicationMessage_Format1__list_of_PM_Information>();
+    for (size_t i = 0; i < sizeof(kCellMeasurements) / sizeof(kCellMeasurements[0]); i++) {
+        ASN_SEQUENCE_ADD(&f1->list_of_PM_Information->list, make_measurement(kCellMeasurements[i], i));
+    }
+
+    f1->list_of_matched_UEs = alloc<E2SM_KPM_IndicationMessage_Format1::E2SM_KPM_IndicationMessage_Format1__list_of_matched_UEs>();
+    for (size_t u = 0; u < ues; u++) {
+        PerUE_PM_Item_t* ue = alloc<PerUE_PM_Item_t>();
+        char imsi[16];
+        snprintf(imsi, sizeof(imsi), "%015zu", size_t(111000000000000ULL) + u + 1);
+        OCTET_STRING_fromString(&ue->ueId, imsi);
+        ue->list_of_PM_Information = alloc<PerUE_PM_Item::PerUE_PM_Item__list_of_PM_Information>();
+        for (size_t i = 0; i < sizeof(kUeMeasurements) / sizeof(kUeMeasurements[0]); i++) {
+            ASN_SEQUENCE_ADD(&ue->list_of_PM_Information->list, make_measurement(kUeMeasurements[i], u + i));
+        }
+        ASN_SEQUENCE_ADD(&ue->list_of_PM_Information->list, make_rrc_measurement(u));
+        ASN_SEQUENCE_ADD(&f1->list_of_matched_UEs->list, ue);
+    }
+
+    std::vector<uint8_t> out(1 << 20);
+    asn_enc_rval_t er;
+    for (;;) {
+        er = asn_encode_to_buffer(0, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_KPM_IndicationMessage,
+                                  kpm, out.data(), out.size());
+        if (er.encoded < 0) {
+            fprintf(stderr, "KPM encode failed: %s\n", er.failed_type ? er.failed_type->name : "?");
+            exit(1);
+        }
+        if (size_t(er.encoded) <= out.size()) {
+            break;
+        }
+        out.resize(er.encoded);
+    }
+    out.resize(er.encoded);
+    ASN_STRUCT_FREE(asn_DEF_E2SM_KPM_IndicationMessage, kpm);
+    return out;
+}
+
+// PER encoding of a KPM Format1 indication header
+std::vector<uint8_t> make_header() {
+    E2SM_KPM_IndicationHeader_t* header = alloc<E2SM_KPM_IndicationHeader_t>();
+    header->present = E2SM_KPM_IndicationHeader_PR_indicationHeader_Format1;
+    E2SM_KPM_IndicationHeader_Format1_t* h1 = alloc<E2SM_KPM_IndicationHeader_Format1_t>();
+    header->choice.indicationHeader_Format1 = h1;
+    uint8_t ts[8] = {0, 0, 1, 0x8f, 0x12, 0x34, 0x56, 0x78};
+    OCTET_STRING_fromBuf(&h1->collectionStartTime, reinterpret_cast<const char*>(ts), sizeof(ts));
+    h1->id_GlobalE2node_ID.present = GlobalE2node_ID_PR_gNB;
+    h1->id_GlobalE2node_ID.choice.gNB = alloc<GlobalE2node_gNB_ID_t>();
+    GlobalE2node_gNB_ID_t* gnb = h1->id_GlobalE2node_ID.choice.gNB;
+    OCTET_STRING_fromBuf(&gnb->global_gNB_ID.plmn_id, "\x13\xf1\x84", 3);
+    gnb->global_gNB_ID.gnb_id.present = GNB_ID_Choice_PR_gnb_ID;
+    gnb->global_gNB_ID.gnb_id.choice.gnb_ID.buf = static_cast<uint8_t*>(calloc(1, 4));
+    gnb->global_gNB_ID.gnb_id.choice.gnb_ID.size = 4;
+
+    std::vector<uint8_t> out(256);
+    asn_enc_rval_t er = asn_encode_to_buffer(0, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_KPM_IndicationHeader,
+                                             header, out.data(), out.size());
+    if (er.encoded < 0 || size_t(er.encoded) > out.size()) {
+        fprintf(stderr, "KPM header encode failed\n");
+        exit(1);
+    }
+    out.resize(er.encoded);
+    ASN_STRUCT_FREE(asn_DEF_E2SM_KPM_IndicationHeader, header);
+    return out;
+}
+
+RICindication_IEs_t* make_ie(long id, RICindication_IEs__value_PR present, const std::vector<uint8_t>& bytes) {
+    RICindication_IEs_t* ie = alloc<RICindication_IEs_t>();
+    ie->id = id;
+    ie->criticality = Criticality_reject;
+    ie->value.present = present;
+    OCTET_STRING_t* os = present == RICindication_IEs__value_PR_RICindicationHeader
+        ? &ie->value.choice.RICindicationHeader
+        : &ie->value.choice.RICindicationMessage;
+    OCTET_STRING_fromBuf(os, reinterpret_cast<const char*>(bytes.data()), int(bytes.size()));
+    return ie;
+}
+
+// the RIC Indication of a report, as decoded by process_ric_indication
+E2AP_PDU_t* make_indication(size_t ues, size_t& report_size) {
+    std::vector<uint8_t> report = make_report(ues);
+    report_size = report.size();
+
+    E2AP_PDU_t* pdu = alloc<E2AP_PDU_t>();
+    pdu->present = E2AP_PDU_PR_initiatingMessage;
+    pdu->choice.initiatingMessage = alloc<InitiatingMessage_t>();
+    pdu->choice.initiatingMessage->procedureCode = ProcedureCode_id_RICindication;
+    pdu->choice.initiatingMessage->value.present = InitiatingMessage__value_PR_RICindication;
+    RICindication_t* ind = &pdu->choice.initiatingMessage->value.choice.RICindication;
+    ASN_SEQUENCE_ADD(&ind->protocolIEs.list,
+                     make_ie(ProtocolIE_ID_id_RICindicationHeader, RICindication_IEs__value_PR_RICindicationHeader, make_header()));
+    ASN_SEQUENCE_ADD(&ind->protocolIEs.list,
+                     make_ie(ProtocolIE_ID_id_RICindicationMessage, RICindication_IEs__value_PR_RICindicationMessage, report));
+    return pdu;
+}
+
+double now_us() {
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double median(std::vector<double>& v) {
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    return v[v.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; i++) {
+        sizes.push_back(std::strtoul(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes = {10, 100, 500};
+    }
+    mdclog_level_set(MDCLOG_ERR);
+
+    printf("%6s %10s %10s %10s %12s %12s %12s %10s\n",
+           "ues", "per_bytes", "json_bytes", "bin_bytes", "decode_us", "json_enc_us", "bin_enc_us", "speedup");
+    for (size_t ues : sizes) {
+        size_t report_size = 0;
+        E2AP_PDU_t* pdu = make_indication(ues, report_size);
+        const OCTET_STRING_t& msg = pdu->choice.initiatingMessage->value.choice.RICindication
+                                        .protocolIEs.list.array[1]->value.choice.RICindicationMessage;
+        int iterations = int(std::max<size_t>(51, 50000 / std::max<size_t>(ues, 1)));
+        KpmBinaryEncoder encoder;
+
+        // the three are interleaved, and their medians kept, so that they
+        // see the same state of the machine
+        std::vector<double> decode_us, json_us, bin_us;
+        size_t json_bytes = 0;
+        for (int i = 0; i < iterations; i++) {
+            // decode of the KPM message only, common to both encodings
+            double t0 = now_us();
+            E2SM_KPM_IndicationMessage_t* kpm = 0;
+            asn_decode(0, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_KPM_IndicationMessage,
+                       (void**)&kpm, msg.buf, msg.size);
+            ASN_STRUCT_FREE(asn_DEF_E2SM_KPM_IndicationMessage, kpm);
+            double t1 = now_us();
+            decode_us.push_back(t1 - t0);
+
+            // JSON, wrapped as AiTcpClient::SendKpi does
+            std::string kpi = procRicIndication(pdu, 0, kMeid);
+            std::string frame;
+            frame.reserve(kpi.size() + 64);
+            frame.append(4, '\0');
+            frame += "{\"type\":\"kpi\",\"meid\":\"";
+            frame += kMeid;
+            frame += "\",\"kpi\":";
+            frame += kpi;
+            frame += '}';
+            json_bytes = frame.size();
+            double t2 = now_us();
+            json_us.push_back(t2 - t1);
+
+            // binary, into the reused buffer
+            encoder.Clear();
+            procRicIndication(pdu, 0, kMeid, &encoder);
+            bin_us.push_back(now_us() - t2);
+        }
+        double decode = median(decode_us);
+        double json = median(json_us) - decode;
+        double bin = median(bin_us) - decode;
+
+        printf("%6zu %10zu %10zu %10zu %12.1f %12.1f %12.1f %9.1fx\n",
+               ues, report_size, json_bytes, encoder.frame_size(), decode, json, bin,
+               bin > 0 ? json / bin : 0.0);
+        ASN_STRUCT_FREE(asn_DEF_E2AP_PDU, pdu);
+    }
+    return 0;
+}
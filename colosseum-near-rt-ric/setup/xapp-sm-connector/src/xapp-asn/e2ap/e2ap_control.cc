@@ -142,7 +142,7 @@ bool ric_control_request::set_fields(InitiatingMessage_t *initMsg, ric_control_h
   ies_ricreq->value.present = RICcontrolRequest_IEs__value_PR_RICrequestID;
   RICrequestID_t *ricrequest_ie = &ies_ricreq->value.choice.RICrequestID;
   ricrequest_ie->ricRequestorID = dinput.req_id;
-  //ricrequest_ie->ricRequestSequenceNumber = dinput.req_seq_no;
+  ricrequest_ie->ricInstanceID = dinput.req_seq_no;
   ASN_SEQUENCE_ADD(&(ric_control_request->protocolIEs), &(IE_array[ie_index]));
 
   // Mandatory IE
@@ -240,7 +240,7 @@ bool ric_control_request:: get_fields(InitiatingMessage_t * init_msg,  ric_contr
 
       case (ProtocolIE_ID_id_RICrequestID):
   	dout.req_id = memb_ptr->value.choice.RICrequestID.ricRequestorID;
-  	//dout.req_seq_no = memb_ptr->value.choice.RICrequestID.ricRequestSequenceNumber;
+  	dout.req_seq_no = memb_ptr->value.choice.RICrequestID.ricInstanceID;
   	break;
 	
       case (ProtocolIE_ID_id_RANfunctionID):
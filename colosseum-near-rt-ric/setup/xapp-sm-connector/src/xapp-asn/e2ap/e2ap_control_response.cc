@@ -190,7 +190,7 @@ bool ric_control_response::set_fields(SuccessfulOutcome_t *successMsg, ric_contr
 	ies_ricreq->value.present = RICcontrolAcknowledge_IEs__value_PR_RICrequestID;
 	RICrequestID_t *ricrequest_ie = &ies_ricreq->value.choice.RICrequestID;
 	ricrequest_ie->ricRequestorID = dinput.req_id;
-	//ricrequest_ie->ricRequestSequenceNumber = dinput.req_seq_no;
+	ricrequest_ie->ricInstanceID = dinput.req_seq_no;
 	//ASN_SEQUENCE_ADD(&(ric_acknowledge->protocolIEs), ies_ricreq);
 
 	ie_index = 1;
@@ -246,7 +246,7 @@ bool ric_control_response::set_fields(UnsuccessfulOutcome_t *unsuccessMsg, ric_c
 	ies_ricreq->value.present = RICcontrolFailure_IEs__value_PR_RICrequestID;
 	RICrequestID_t *ricrequest_ie = &(ies_ricreq->value.choice.RICrequestID);
 	ricrequest_ie->ricRequestorID = dinput.req_id;
-	//ricrequest_ie->ricRequestSequenceNumber = dinput.req_seq_no;
+	ricrequest_ie->ricInstanceID = dinput.req_seq_no;
 	//ASN_SEQUENCE_ADD(&(ric_failure->protocolIEs), ies_ricreq);
 
 	ie_index = 1;
@@ -326,17 +326,22 @@ bool ric_control_response:: get_fields(SuccessfulOutcome_t * success_msg,  ric_c
 
 		case (ProtocolIE_ID_id_RICrequestID):
   			dout.req_id = memb_ptr->value.choice.RICrequestID.ricRequestorID;
-		//dout.req_seq_no = memb_ptr->value.choice.RICrequestID.ricRequestSequenceNumber;
+		dout.req_seq_no = memb_ptr->value.choice.RICrequestID.ricInstanceID;
 		break;
 
 		case (ProtocolIE_ID_id_RANfunctionID):
   			dout.func_id = memb_ptr->value.choice.RANfunctionID;
 		break;
 
-		case (ProtocolIE_ID_id_Cause):
+		case (ProtocolIE_ID_id_RICcontrolStatus):
   			dout.control_status = memb_ptr->value.choice.RICcontrolStatus;
 		break;
 
+		case (ProtocolIE_ID_id_RICcontrolOutcome):
+  			dout.control_outcome = memb_ptr->value.choice.RICcontrolOutcome.buf;
+		dout.control_outcome_size = memb_ptr->value.choice.RICcontrolOutcome.size;
+		break;
+
 		}
 
 	}
@@ -367,7 +372,7 @@ bool ric_control_response:: get_fields(UnsuccessfulOutcome_t * unsuccess_msg,  r
 
 		case (ProtocolIE_ID_id_RICrequestID):
   			dout.req_id = memb_ptr->value.choice.RICrequestID.ricRequestorID;
-		//dout.req_seq_no = memb_ptr->value.choice.RICrequestID.ricRequestSequenceNumber;
+		dout.req_seq_no = memb_ptr->value.choice.RICrequestID.ricInstanceID;
 		break;
 
 		case (ProtocolIE_ID_id_RANfunctionID):
@@ -402,6 +407,12 @@ bool ric_control_response:: get_fields(UnsuccessfulOutcome_t * unsuccess_msg,  r
 			dout.sub_cause = -1;
 			break;
 		}
+		break;
+
+		case (ProtocolIE_ID_id_RICcontrolOutcome):
+  			dout.control_outcome = memb_ptr->value.choice.RICcontrolOutcome.buf;
+		dout.control_outcome_size = memb_ptr->value.choice.RICcontrolOutcome.size;
+		break;
 
 		default:
 			break;
@@ -1,18 +1,20 @@
 #include "ai_tcp_client.h"
 
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <unistd.h>
-#include <poll.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdlib>
 #include <cstring>
-#include <mutex>
-#include <thread>
-#include <atomic>
-#include <functional>
-#include <chrono>
+#include <future>
+#include <utility>
+#include <vector>
 #include <rapidjson/document.h>
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
@@ -21,20 +23,83 @@ extern "C" {
 #include "mdclog/mdclog.h"
 }
 
+namespace {
+
+const uint32_t kMaxFrameLen = 1024 * 1024; // 1MB sanity cap
+const int kEpollTimeoutMs = 100;
+const int kStatsLogIntervalS = 10;
+
+// The command of a control message or of a recommendation, "cmd" or
+// "command", either a JSON string or an object; empty if there is none
+std::string ExtractCommand(const rapidjson::Value& doc) {
+    for (const char* key : {"cmd", "command"}) {
+        if (!doc.HasMember(key)) {
+            continue;
+        }
+        const rapidjson::Value& cmd = doc[key];
+        if (cmd.IsString()) {
+            return std::string(cmd.GetString(), cmd.GetStringLength());
+        }
+        if (cmd.IsObject()) {
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            cmd.Accept(writer);
+            return std::string(buffer.GetString(), buffer.GetSize());
+        }
+        mdclog_write(MDCLOG_WARN, "[AI-TCP] %s field exists but is neither string nor object (type=%d)",
+                     key, cmd.GetType());
+        return std::string();
+    }
+    return std::string();
+}
+
+// Convention of the untagged replies: empty / "{}" / contains "no_action" => no command
+bool IsNoAction(const std::string& reply) {
+    return reply.empty() || reply == "{}" || reply.find("no_action") != std::string::npos;
+}
+
+std::string Trim(const std::string& s) {
+    const char* ws = " \t\r\n";
+    auto start = s.find_first_not_of(ws);
+    if (start == std::string::npos) {
+        return std::string();
+    }
+    auto end = s.find_last_not_of(ws);
+    return s.substr(start, end - start + 1);
+}
+
+} // namespace
+
 AiTcpClient::AiTcpClient(const std::string& host, int port)
+    : AiTcpClient(host, port, Options())
+{
+}
+
+AiTcpClient::AiTcpClient(const std::string& host, int port, const Options& options)
     : host_(host),
       port_(port),
+      options_(options),
       sock_(-1),
-      listener_running_(false),
-      control_listener_running_(false)
+      epoll_fd_(-1),
+      connecting_(false),
+      was_connected_(false),
+      want_write_(false),
+      out_off_(0),
+      next_request_id_(1),
+      link_down_(false),
+      wake_fd_(-1),
+      running_(false)
 {
 }
 
 AiTcpClient::~AiTcpClient() {
-    StopControlCommandListener();
-    if (sock_ >= 0) {
-        close(sock_);
-        sock_ = -1;
+    if (io_thread_) {
+        running_ = false;
+        wakeup();
+        io_thread_->join();
+    }
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
     }
 }
 
@@ -44,431 +109,618 @@ bool AiTcpClient::SendKpi(const std::string& meid,
     // Send decoded JSON directly (kpi_json is already a decoded E2SM JSON object)
     // Schema: {"type":"kpi","meid":"...","kpi":{...decoded JSON...}}
     // kpi_json is already a valid JSON object, so embed it directly
-    std::string msg = "{\"type\":\"kpi\",\"meid\":\"" + meid + "\",\"kpi\":" + kpi_json + "}";
-
-    std::lock_guard<std::mutex> lock(mtx_);
-    if (!ensureConnected()) {
-        mdclog_write(MDCLOG_ERR, "[AI-TCP] Failed to connect when sending KPI (MEID=%s)",
-                     meid.c_str());
+    std::string msg;
+    msg.reserve(kpi_json.size() + meid.size() + 32);
+    msg += "{\"type\":\"kpi\",\"meid\":\"";
+    msg += meid;
+    msg += "\",\"kpi\":";
+    msg += kpi_json;
+    msg += '}';
+
+    if (!enqueue(msg, meid)) {
         return false;
     }
+    mdclog_write(MDCLOG_DEBUG, "[AI-TCP] Queued KPI (MEID=%s, bytes=%zu)",
+                 meid.c_str(), kpi_json.size());
+    return true;
+}
 
-    if (!sendFramed(msg)) {
-        mdclog_write(MDCLOG_ERR, "[AI-TCP] Failed to send KPI frame (MEID=%s)", meid.c_str());
-        reset();
+bool AiTcpClient::SendKpiFrame(const std::string& meid,
+                               const char* frame,
+                               size_t frame_size)
+{
+    if (!enqueueFrame(std::string(frame, frame_size), meid)) {
         return false;
     }
+    mdclog_write(MDCLOG_DEBUG, "[AI-TCP] Queued binary KPI (MEID=%s, bytes=%zu)",
+                 meid.c_str(), frame_size);
+    return true;
+}
 
-    mdclog_write(MDCLOG_DEBUG, "[AI-TCP] Sent KPI (MEID=%s, bytes=%zu)",
-                 meid.c_str(), msg.size());
+bool AiTcpClient::SendControlResult(const std::string& meid,
+                                    bool ok,
+                                    long requestor_id,
+                                    long instance_id,
+                                    const std::string& outcome_json)
+{
+    // Schema: {"type":"control_result","meid":"...","requestorId":N,"instanceId":N,
+    //          "ok":bool,"outcome":{...}|null}
+    std::string msg = "{\"type\":\"control_result\",\"meid\":\"" + meid +
+                      "\",\"requestorId\":" + std::to_string(requestor_id) +
+                      ",\"instanceId\":" + std::to_string(instance_id) +
+                      ",\"ok\":" + (ok ? "true" : "false") +
+                      ",\"outcome\":" + (outcome_json.empty() ? "null" : outcome_json) + "}";
+
+    if (!enqueue(msg, std::string())) {
+        mdclog_write(MDCLOG_ERR, "[AI-TCP] Dropped control result (MEID=%s, instance=%ld)",
+                     meid.c_str(), instance_id);
+        return false;
+    }
+    mdclog_write(MDCLOG_DEBUG, "[AI-TCP] Queued control result (MEID=%s, instance=%ld, ok=%d)",
+                 meid.c_str(), instance_id, ok ? 1 : 0);
     return true;
 }
 
-bool AiTcpClient::GetRecommendation(const std::string& meid,
-                                    const std::string& kpi_json,
-                                    std::string& out_cmd_json)
+uint64_t AiTcpClient::RequestRecommendation(const std::string& meid,
+                                            const std::string& kpi_json,
+                                            RecommendationHandler handler)
 {
-    // Request: send decoded JSON directly
-    // {"type":"recommendation_request","meid":"...","kpi":{...decoded JSON...}}
-    std::string req = "{\"type\":\"recommendation_request\",\"meid\":\"" + meid +
-                      "\",\"kpi\":" + kpi_json + "}";
+    ensureStarted();
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (link_down_) {
+            mdclog_write(MDCLOG_ERR, "[AI-TCP] AI not connected, no recommendation (MEID=%s)",
+                         meid.c_str());
+            return 0;
+        }
+        id = next_request_id_++;
+        PendingRequest& request = pending_[id];
+        request.handler = std::move(handler);
+        request.deadline = std::chrono::steady_clock::now() +
+                           std::chrono::milliseconds(options_.request_timeout_ms);
+    }
 
-    std::lock_guard<std::mutex> lock(mtx_);
-    if (!ensureConnected()) {
-        mdclog_write(MDCLOG_ERR, "[AI-TCP] Failed to connect for recommendation (MEID=%s)",
+    // Request: send decoded JSON directly
+    // {"type":"recommendation_request","id":N,"meid":"...","kpi":{...decoded JSON...}}
+    std::string req = "{\"type\":\"recommendation_request\",\"id\":" + std::to_string(id) +
+                      ",\"meid\":\"" + meid + "\",\"kpi\":" + kpi_json + "}";
+    if (!enqueue(req, std::string())) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        // The I/O thread may have failed the request in the meantime, on a
+        // reset or a timeout: its handler is then called, and the request
+        // must be reported as queued.
+        if (pending_.erase(id) == 0) {
+            return id;
+        }
+        mdclog_write(MDCLOG_ERR, "[AI-TCP] Failed to queue recommendation_request (MEID=%s)",
                      meid.c_str());
-        return false;
+        return 0;
     }
 
-    if (!sendFramed(req)) {
-        mdclog_write(MDCLOG_ERR, "[AI-TCP] Failed to send recommendation_request (MEID=%s)",
-                     meid.c_str());
-        reset();
+    std::lock_guard<std::mutex> lock(mtx_);
+    stats_.requests_sent++;
+    return id;
+}
+
+bool AiTcpClient::GetRecommendation(const std::string& meid,
+                                    const std::string& kpi_json,
+                                    std::string& out_cmd_json)
+{
+    ensureStarted();
+    if (std::this_thread::get_id() == io_thread_->get_id()) {
+        mdclog_write(MDCLOG_ERR, "[AI-TCP] GetRecommendation called by the I/O thread, use RequestRecommendation");
         return false;
     }
 
-    // Read reply frame
-    uint32_t len_net = 0;
-    if (!recvAll(&len_net, sizeof(len_net))) {
-        mdclog_write(MDCLOG_ERR, "[AI-TCP] Failed to read reply length (MEID=%s)",
-                     meid.c_str());
-        reset();
+    // the I/O thread always completes the request: reply, timeout or lost connection
+    auto reply = std::make_shared<std::promise<std::pair<bool, std::string>>>();
+    std::future<std::pair<bool, std::string>> done = reply->get_future();
+    uint64_t id = RequestRecommendation(meid, kpi_json,
+        [reply](bool ok, const std::string& cmd_json) { reply->set_value(std::make_pair(ok, cmd_json)); });
+    if (id == 0) {
         return false;
     }
 
-    uint32_t len = ntohl(len_net);
-    if (len == 0 || len > 1024 * 1024) { // 1MB sanity cap
-        mdclog_write(MDCLOG_ERR, "[AI-TCP] Invalid reply length=%u (MEID=%s)",
-                     len, meid.c_str());
-        reset();
+    std::pair<bool, std::string> result = done.get();
+    if (!result.first) {
+        mdclog_write(MDCLOG_DEBUG, "[AI-TCP] No action in reply from AI (MEID=%s, id=%lu)",
+                     meid.c_str(), (unsigned long)id);
         return false;
     }
 
-    std::string reply(len, '\0');
-    if (!recvAll(&reply[0], len)) {
-        mdclog_write(MDCLOG_ERR, "[AI-TCP] Failed to read reply body (MEID=%s)",
-                     meid.c_str());
-        reset();
-        return false;
+    // Otherwise: reply is the exact command JSON to send to ns-3.
+    out_cmd_json = std::move(result.second);
+    mdclog_write(MDCLOG_INFO, "[AI-TCP] Got recommendation for MEID=%s: %s",
+                 meid.c_str(), out_cmd_json.c_str());
+    return true;
+}
+
+void AiTcpClient::StartControlCommandListener(std::function<bool(const std::string&, const std::string&)> handler) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        control_cmd_handler_ = std::move(handler);
+        mdclog_write(MDCLOG_INFO, "[AI-TCP] Control command handler installed");
     }
+    // Connect proactively so that commands are received even before KPIs are sent
+    ensureStarted();
+}
+
+void AiTcpClient::StopControlCommandListener() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    control_cmd_handler_ = nullptr;
+    // The I/O thread keeps running, it also carries the KPIs
+    mdclog_write(MDCLOG_INFO, "[AI-TCP] Control command handler removed");
+}
 
-    // Trim whitespace
-    auto trim = [](std::string& s) {
-        const char* ws = " \t\r\n";
-        auto start = s.find_first_not_of(ws);
-        auto end   = s.find_last_not_of(ws);
-        if (start == std::string::npos) { s.clear(); return; }
-        s = s.substr(start, end - start + 1);
-    };
+AiTcpClient::Stats AiTcpClient::GetStats() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Stats stats = stats_;
+    stats.queue_frames = queue_.size();
+    stats.requests_pending = pending_.size();
+    return stats;
+}
+
+bool AiTcpClient::enqueue(const std::string& json, const std::string& kpi_meid) {
+    std::string frame;
+    frame.reserve(sizeof(uint32_t) + json.size());
+    uint32_t len_net = htonl(static_cast<uint32_t>(json.size()));
+    frame.append(reinterpret_cast<const char*>(&len_net), sizeof(len_net));
+    frame += json;
+    return enqueueFrame(std::move(frame), kpi_meid);
+}
 
-    trim(reply);
+bool AiTcpClient::enqueueFrame(std::string frame, const std::string& kpi_meid) {
+    ensureStarted();
 
-    // Convention:
-    // - empty / "{}" / contains "no_action" => no command
-    if (reply.empty() ||
-        reply == "{}" ||
-        reply.find("no_action") != std::string::npos)
+    bool is_kpi = !kpi_meid.empty();
+    bool wake = false;
     {
-        mdclog_write(MDCLOG_DEBUG,
-                     "[AI-TCP] No action in reply from AI (MEID=%s, raw=\"%s\")",
-                     meid.c_str(), reply.c_str());
-        return false;
-    }
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (is_kpi && options_.coalesce_kpi) {
+            // the AI is behind: the KPI not sent yet is superseded by this one
+            auto it = queued_kpi_.find(kpi_meid);
+            if (it != queued_kpi_.end()) {
+                stats_.queue_bytes = stats_.queue_bytes - it->second->bytes.size() + frame.size();
+                stats_.queue_bytes_peak = std::max(stats_.queue_bytes_peak, stats_.queue_bytes);
+                it->second->bytes.swap(frame);
+                stats_.kpi_coalesced++;
+                return true;
+            }
+        }
 
-    // Otherwise: reply is the exact command JSON to send to ns-3.
-    out_cmd_json = reply;
+        if ((is_kpi && link_down_) || stats_.queue_bytes + frame.size() > options_.max_queue_bytes) {
+            uint64_t& dropped = is_kpi ? stats_.kpi_dropped : stats_.frames_dropped;
+            dropped++;
+            if ((dropped & (dropped - 1)) == 0) {
+                // powers of two only, so that a long outage does not flood the log
+                mdclog_write(MDCLOG_WARN, "[AI-TCP] %s, dropped %lu %s frames (queued %zu bytes)",
+                             link_down_ ? "AI not connected" : "Send queue full",
+                             (unsigned long)dropped, is_kpi ? "KPI" : "other", stats_.queue_bytes);
+            }
+            return false;
+        }
 
-    mdclog_write(MDCLOG_INFO,
-                 "[AI-TCP] Got recommendation for MEID=%s: %s",
-                 meid.c_str(), out_cmd_json.c_str());
+        wake = queue_.empty();
+        stats_.queue_bytes += frame.size();
+        stats_.queue_bytes_peak = std::max(stats_.queue_bytes_peak, stats_.queue_bytes);
+        queue_.push_back(OutFrame{std::move(frame), is_kpi ? kpi_meid : std::string()});
+        if (is_kpi && options_.coalesce_kpi) {
+            // push_back keeps the references to the elements of a deque
+            queued_kpi_[kpi_meid] = &queue_.back();
+        }
+    }
+    if (wake) {
+        wakeup();
+    }
     return true;
 }
 
-bool AiTcpClient::ensureConnected() {
-    if (sock_ >= 0) {
-        // Verify socket is still valid by checking if it's still connected
-        // (simple check - try to get socket error)
-        int error = 0;
-        socklen_t len = sizeof(error);
-        if (getsockopt(sock_, SOL_SOCKET, SO_ERROR, &error, &len) == 0 && error == 0) {
-            return true;
-        } else {
-            // Socket is broken, reset it
-            mdclog_write(MDCLOG_WARN, "[AI-TCP] Socket appears broken, resetting connection");
-            reset();
+void AiTcpClient::ensureStarted() {
+    std::call_once(start_once_, [this] {
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ < 0) {
+            mdclog_write(MDCLOG_ERR, "[AI-TCP] eventfd() failed: %s", strerror(errno));
         }
+        mdclog_write(MDCLOG_INFO, "[AI-TCP] Starting I/O thread for %s:%d", host_.c_str(), port_);
+        running_ = true;
+        io_thread_.reset(new std::thread(&AiTcpClient::ioLoop, this));
+    });
+}
+
+void AiTcpClient::wakeup() {
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t n = write(wake_fd_, &one, sizeof(one));
+        (void)n; // EAGAIN only if the counter saturates, the thread is then awake anyway
     }
+}
 
-    int s = socket(AF_INET, SOCK_STREAM, 0);
-    if (s < 0) {
-        mdclog_write(MDCLOG_ERR, "[AI-TCP] socket() failed: %s", strerror(errno));
-        return false;
+void AiTcpClient::ioLoop() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        mdclog_write(MDCLOG_ERR, "[AI-TCP] epoll_create1() failed: %s", strerror(errno));
+        return;
+    }
+    epoll_event wake_ev{};
+    wake_ev.events = EPOLLIN;
+    wake_ev.data.fd = wake_fd_;
+    if (wake_fd_ >= 0) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_ev);
+    }
+    next_connect_ = std::chrono::steady_clock::now();
+    next_stats_log_ = next_connect_ + std::chrono::seconds(kStatsLogIntervalS);
+
+    while (running_) {
+        if (sock_ < 0 && std::chrono::steady_clock::now() >= next_connect_) {
+            startConnect();
+        }
+
+        epoll_event events[8];
+        int n = epoll_wait(epoll_fd_, events, 8, kEpollTimeoutMs);
+        if (n < 0 && errno != EINTR) {
+            mdclog_write(MDCLOG_ERR, "[AI-TCP] epoll_wait() failed: %s", strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            if (events[i].data.fd == wake_fd_) {
+                uint64_t count;
+                ssize_t r = read(wake_fd_, &count, sizeof(count));
+                (void)r;
+                // new frames: sent now, unless the previous ones are still being written
+                if (sock_ >= 0 && !connecting_ && !want_write_) {
+                    onWritable();
+                }
+                continue;
+            }
+            if (sock_ < 0 || events[i].data.fd != sock_) {
+                continue; // closed earlier in this iteration
+            }
+            if (connecting_) {
+                int error = 0;
+                socklen_t len = sizeof(error);
+                getsockopt(sock_, SOL_SOCKET, SO_ERROR, &error, &len);
+                if (error != 0) {
+                    reset(std::string("connect() failed: ") + strerror(error));
+                } else {
+                    onConnected();
+                }
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                onReadable();
+            }
+            if (sock_ >= 0 && (events[i].events & EPOLLOUT)) {
+                onWritable();
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        expireRequests(now);
+        if (now >= next_stats_log_) {
+            logStats();
+            next_stats_log_ = now + std::chrono::seconds(kStatsLogIntervalS);
+        }
     }
 
+    reset("shutdown");
+    close(epoll_fd_);
+    epoll_fd_ = -1;
+    mdclog_write(MDCLOG_INFO, "[AI-TCP] I/O thread exited");
+}
+
+bool AiTcpClient::startConnect() {
     sockaddr_in addr{};
     addr.sin_family = AF_INET;
     addr.sin_port = htons(port_);
-
     if (inet_pton(AF_INET, host_.c_str(), &addr.sin_addr) <= 0) {
-        mdclog_write(MDCLOG_ERR, "[AI-TCP] inet_pton(%s) failed", host_.c_str());
-        close(s);
+        reset("inet_pton(" + host_ + ") failed");
         return false;
     }
 
-    if (connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
-        mdclog_write(MDCLOG_ERR, "[AI-TCP] connect(%s:%d) failed: %s",
-                     host_.c_str(), port_, strerror(errno));
-        close(s);
+    int s = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (s < 0) {
+        reset(std::string("socket() failed: ") + strerror(errno));
         return false;
     }
-
+    int one = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
     sock_ = s;
-    mdclog_write(MDCLOG_INFO, "[AI-TCP] Connected to AI at %s:%d (socket=%d)",
-                 host_.c_str(), port_, sock_);
-    
-    // Notify listener that socket is now available
-    if (listener_running_) {
-        mdclog_write(MDCLOG_INFO, "[AI-TCP] Socket connected - listener can now receive messages");
-    }
-    
-    return true;
-}
 
-bool AiTcpClient::sendFramed(const std::string& json) {
-    uint32_t len = static_cast<uint32_t>(json.size());
-    uint32_t len_net = htonl(len);
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLOUT;
+    ev.data.fd = sock_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, sock_, &ev);
+    want_write_ = true;
 
-    if (!sendAll(&len_net, sizeof(len_net))) {
-        return false;
+    if (connect(sock_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+        onConnected();
+        return true;
     }
-    if (!sendAll(json.data(), len)) {
+    if (errno != EINPROGRESS) {
+        reset(std::string("connect() failed: ") + strerror(errno));
         return false;
     }
+    connecting_ = true;
     return true;
 }
 
-bool AiTcpClient::sendAll(const void* buf, size_t len) {
-    const char* p = static_cast<const char*>(buf);
-    while (len > 0) {
-        ssize_t n = send(sock_, p, len, 0);
-        if (n <= 0) {
-            mdclog_write(MDCLOG_ERR, "[AI-TCP] send() failed: %s", strerror(errno));
-            return false;
+void AiTcpClient::onConnected() {
+    connecting_ = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (was_connected_) {
+            stats_.reconnects++;
         }
-        p += n;
-        len -= static_cast<size_t>(n);
+        link_down_ = false;
     }
-    return true;
+    was_connected_ = true;
+    mdclog_write(MDCLOG_INFO, "[AI-TCP] Connected to AI at %s:%d (socket=%d)",
+                 host_.c_str(), port_, sock_);
+    onWritable();
 }
 
-bool AiTcpClient::recvAll(void* buf, size_t len) {
-    char* p = static_cast<char*>(buf);
-    while (len > 0) {
-        ssize_t n = recv(sock_, p, len, 0);
-        if (n <= 0) {
-            mdclog_write(MDCLOG_ERR, "[AI-TCP] recv() failed: %s", strerror(errno));
-            return false;
+void AiTcpClient::onWritable() {
+    for (;;) {
+        if (out_off_ == out_buf_.size()) {
+            // all the frames queued meanwhile, in one write
+            out_buf_.clear();
+            out_off_ = 0;
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (queue_.empty()) {
+                break;
+            }
+            for (const OutFrame& frame : queue_) {
+                out_buf_ += frame.bytes;
+            }
+            stats_.frames_sent += queue_.size();
+            queue_.clear();
+            queued_kpi_.clear();
+        }
+
+        ssize_t n = send(sock_, out_buf_.data() + out_off_, out_buf_.size() - out_off_, MSG_NOSIGNAL);
+        if (n > 0) {
+            out_off_ += static_cast<size_t>(n);
+            std::lock_guard<std::mutex> lock(mtx_);
+            stats_.bytes_sent += static_cast<size_t>(n);
+            stats_.queue_bytes -= static_cast<size_t>(n);
+            continue;
         }
-        p += n;
-        len -= static_cast<size_t>(n);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // the AI is behind: the frames wait in the queue, coalesced if enabled
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                stats_.send_blocked++;
+            }
+            updateEvents(true);
+            return;
+        }
+        reset(std::string("send() failed: ") + strerror(errno));
+        return;
     }
-    return true;
+    updateEvents(false);
 }
 
-void AiTcpClient::reset() {
-    if (sock_ >= 0) {
-        mdclog_write(MDCLOG_INFO, "[AI-TCP] Closing AI connection (socket=%d)", sock_);
-        close(sock_);
-        sock_ = -1;
-        mdclog_write(MDCLOG_DEBUG, "[AI-TCP] Connection reset - listener will wait for reconnection");
+void AiTcpClient::onReadable() {
+    char buf[64 * 1024];
+    for (;;) {
+        ssize_t n = recv(sock_, buf, sizeof(buf), 0);
+        if (n > 0) {
+            in_buf_.append(buf, static_cast<size_t>(n));
+            if (static_cast<size_t>(n) < sizeof(buf)) {
+                break;
+            }
+            continue;
+        }
+        if (n == 0) {
+            reset("connection closed by AI");
+            return;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        reset(std::string("recv() failed: ") + strerror(errno));
+        return;
+    }
+
+    size_t off = 0;
+    while (in_buf_.size() - off >= sizeof(uint32_t)) {
+        uint32_t len_net = 0;
+        std::memcpy(&len_net, in_buf_.data() + off, sizeof(len_net));
+        uint32_t len = ntohl(len_net);
+        if (len == 0 || len > kMaxFrameLen) {
+            reset("invalid frame length " + std::to_string(len));
+            return;
+        }
+        if (in_buf_.size() - off - sizeof(uint32_t) < len) {
+            break;
+        }
+        handleFrame(in_buf_.substr(off + sizeof(uint32_t), len));
+        off += sizeof(uint32_t) + len;
     }
+    in_buf_.erase(0, off);
 }
 
-// Config listener methods removed - config file writing is no longer supported.
-// All control should go through the direct RIC control path via StartControlCommandListener().
+void AiTcpClient::handleFrame(const std::string& json) {
+    mdclog_write(MDCLOG_DEBUG, "[AI-TCP] Received message from AI (len=%zu): %s",
+                 json.size(), json.substr(0, 200).c_str());
 
-void AiTcpClient::StartControlCommandListener(std::function<bool(const std::string&, const std::string&)> handler) {
-    bool need_connect = false;
-    {
-        std::lock_guard<std::mutex> lock(mtx_);
-        control_cmd_handler_ = std::move(handler);
-        control_listener_running_ = true;
-        mdclog_write(MDCLOG_INFO, "[AI-TCP] Control command handler installed");
-        
-        // Check if we need to connect (check inside lock for thread safety)
-        need_connect = (sock_ < 0);
-    }
-    
-    // Try to establish connection proactively so listener can receive commands
-    // even before KPIs are sent (call outside of lock since ensureConnected locks)
-    if (need_connect) {
-        mdclog_write(MDCLOG_INFO, "[AI-TCP] Attempting to connect to AI server at %s:%d for control commands...", 
-                     host_.c_str(), port_);
-        ensureConnected();
-        // Note: ensureConnected will log success/failure
-    }
-    
-    // If the main listener isn't running yet, start it
-    // (it will handle control commands)
+    rapidjson::Document doc;
+    bool is_object = !doc.Parse(json.c_str(), json.size()).HasParseError() && doc.IsObject();
+    std::string type;
+    if (is_object && doc.HasMember("type") && doc["type"].IsString()) {
+        type = doc["type"].GetString();
+    }
+
+    if (type == "control") {
+        // Expected format: {"type":"control","meid":"...","cmd":{...}}
+        // or: {"type":"control","meid":"...","command":{...}}
+        std::function<bool(const std::string&, const std::string&)> handler;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            handler = control_cmd_handler_;
+        }
+        if (!handler) {
+            mdclog_write(MDCLOG_WARN, "[AI-TCP] Control command received without a handler, ignored");
+            return;
+        }
+        std::string meid;
+        if (doc.HasMember("meid") && doc["meid"].IsString()) {
+            meid = doc["meid"].GetString();
+        }
+        std::string cmd_json = ExtractCommand(doc);
+        if (meid.empty() || cmd_json.empty()) {
+            mdclog_write(MDCLOG_WARN, "[AI-TCP] Received control command but missing meid or cmd: meid='%s', cmd='%s'",
+                         meid.c_str(), cmd_json.c_str());
+            return;
+        }
+        mdclog_write(MDCLOG_INFO, "[AI-TCP] Control command: meid='%s', cmd_json='%s'",
+                     meid.c_str(), cmd_json.c_str());
+        handler(meid, cmd_json);
+        return;
+    }
+
+    if (type == "recommendation" && doc.HasMember("id") && doc["id"].IsUint64()) {
+        std::string cmd_json = ExtractCommand(doc);
+        bool ok = !cmd_json.empty() && !doc.HasMember("no_action");
+        completeRequest(doc["id"].GetUint64(), ok, cmd_json);
+        return;
+    }
+
+    // Config messages (qos, handover, energy, etc.) are received but not written to CSV files.
+    // All control should go through the direct RIC control path with "type":"control".
+    if (type == "config" || type == "qos" || type == "handover" || type == "energy") {
+        mdclog_write(MDCLOG_INFO, "[AI-TCP] Received config message (CSV file writing disabled). Use direct RIC control with \"type\":\"control\" instead: %s",
+                     json.substr(0, 200).c_str());
+        return;
+    }
+
+    // Untagged reply: answers the oldest outstanding request
+    uint64_t oldest = 0;
     {
         std::lock_guard<std::mutex> lock(mtx_);
-        if (!listener_running_) {
-            listener_running_ = true;
-            listener_thread_ = std::unique_ptr<std::thread>(new std::thread(&AiTcpClient::configListenerLoop, this));
-            mdclog_write(MDCLOG_INFO, "[AI-TCP] Started listener thread for control commands");
-        } else {
-            mdclog_write(MDCLOG_INFO, "[AI-TCP] Listener thread already running, handler installed");
+        if (!pending_.empty()) {
+            oldest = pending_.begin()->first;
         }
     }
+    if (type.empty() && oldest != 0) {
+        std::string reply = Trim(json);
+        completeRequest(oldest, !IsNoAction(reply), reply);
+        return;
+    }
+    mdclog_write(MDCLOG_WARN, "[AI-TCP] Unexpected message from AI (type='%s'), ignored", type.c_str());
 }
 
-void AiTcpClient::StopControlCommandListener() {
-    std::lock_guard<std::mutex> lock(mtx_);
-    
-    if (!control_listener_running_) {
+void AiTcpClient::updateEvents(bool want_write) {
+    if (sock_ < 0 || want_write == want_write_) {
         return;
     }
-    
-    control_listener_running_ = false;
-    control_cmd_handler_ = nullptr;
-    
-    // Note: We don't stop the listener thread here because it might be needed for other purposes.
-    // The listener will continue running if listener_running_ is still true.
-    
-    mdclog_write(MDCLOG_INFO, "[AI-TCP] Control command handler removed (listener thread continues running)");
+    epoll_event ev{};
+    ev.events = EPOLLIN | (want_write ? EPOLLOUT : 0);
+    ev.data.fd = sock_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, sock_, &ev);
+    want_write_ = want_write;
 }
 
-void AiTcpClient::configListenerLoop() {
-    mdclog_write(MDCLOG_INFO, "[AI-TCP] Listener loop started (waiting for connection...)");
-    int consecutive_no_connection = 0;
-    while (listener_running_) {
-        int current_sock = -1;
-        {
-            std::lock_guard<std::mutex> lock(mtx_);
-            current_sock = sock_;
-        }
-        
-        // Sleep outside of lock if not connected
-        if (current_sock < 0) {
-            consecutive_no_connection++;
-            // Try to connect every 10 seconds (100 iterations * 100ms)
-            if (consecutive_no_connection % 100 == 0) {
-                // Try to establish connection
-                {
-                    std::lock_guard<std::mutex> lock(mtx_);
-                    if (sock_ < 0) {
-                        mdclog_write(MDCLOG_INFO, "[AI-TCP] Attempting to connect to AI server at %s:%d...", 
-                                     host_.c_str(), port_);
-                        // Unlock before calling ensureConnected (it will lock again)
-                    }
-                }
-                // Call ensureConnected without holding the lock
-                ensureConnected();
-            }
-            // Log every 50 iterations (5 seconds) that we're waiting (but only at DEBUG level)
-            if (consecutive_no_connection % 50 == 0 && consecutive_no_connection <= 200) {
-                // Only log first few times to avoid spam
-                mdclog_write(MDCLOG_DEBUG, "[AI-TCP] Listener waiting for socket connection (waited %d seconds)...", 
-                            consecutive_no_connection / 10);
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            continue;
+void AiTcpClient::reset(const std::string& reason) {
+    if (sock_ >= 0) {
+        mdclog_write(connecting_ ? MDCLOG_DEBUG : MDCLOG_INFO, "[AI-TCP] Closing AI connection (socket=%d): %s",
+                     sock_, reason.c_str());
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, sock_, nullptr);
+        close(sock_);
+        sock_ = -1;
+    }
+    connecting_ = false;
+    want_write_ = false;
+    in_buf_.clear();
+    next_connect_ = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(options_.reconnect_interval_ms);
+
+    // the outstanding requests fail, their replies are lost with the connection
+    std::map<uint64_t, PendingRequest> failed;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!link_down_ && running_) {
+            mdclog_write(MDCLOG_WARN, "[AI-TCP] AI at %s:%d unreachable (%s), retrying every %d ms",
+                         host_.c_str(), port_, reason.c_str(), options_.reconnect_interval_ms);
         }
-        
-        // Reset counter when connected
-        if (consecutive_no_connection > 0) {
-            mdclog_write(MDCLOG_INFO, "[AI-TCP] Listener detected socket connection (socket=%d)", current_sock);
-            consecutive_no_connection = 0;
-        }
-        
-        // Poll outside of lock to avoid blocking other operations
-        pollfd pfd{};
-        pfd.fd = current_sock;
-        pfd.events = POLLIN;
-        int ret = poll(&pfd, 1, 100); // 100ms timeout
-        
-        if (ret > 0 && (pfd.revents & POLLIN)) {
-            // Data available, try to read a config message
-            mdclog_write(MDCLOG_DEBUG, "[AI-TCP] Data available on socket, reading message...");
-            std::lock_guard<std::mutex> lock(mtx_);
-            uint32_t len_net = 0;
-            if (recvAll(&len_net, sizeof(len_net))) {
-                uint32_t len = ntohl(len_net);
-                if (len > 0 && len <= 1024 * 1024) {
-                    std::string config_json(len, '\0');
-                    if (recvAll(&config_json[0], len)) {
-                        mdclog_write(MDCLOG_DEBUG, "[AI-TCP] Received message from AI (len=%u): %s", 
-                                    len, config_json.substr(0, 200).c_str());
-                        // Check if it's a control command message
-                        if (config_json.find("\"type\":\"control\"") != std::string::npos || 
-                            config_json.find("\"type\": \"control\"") != std::string::npos) {
-                            mdclog_write(MDCLOG_INFO, "[AI-TCP] ✅ Detected control command message (len=%u)", len);
-                            // This is a control command - parse and route to control command handler
-                            if (control_cmd_handler_) {
-                                // Parse JSON to extract meid and cmd using rapidjson
-                                // Expected format: {"type":"control","meid":"...","cmd":{...}}
-                                // or: {"type":"control","meid":"...","command":{...}}
-                                rapidjson::Document doc;
-                                if (doc.Parse(config_json.c_str()).HasParseError()) {
-                                    mdclog_write(MDCLOG_WARN, "[AI-TCP] Failed to parse control command JSON: %s", 
-                                                config_json.c_str());
-                                    continue;
-                                }
-                                
-                                if (!doc.IsObject()) {
-                                    mdclog_write(MDCLOG_WARN, "[AI-TCP] Control command is not a JSON object: %s", 
-                                                config_json.c_str());
-                                    continue;
-                                }
-                                
-                                // Extract meid
-                                std::string meid;
-                                if (doc.HasMember("meid") && doc["meid"].IsString()) {
-                                    meid = doc["meid"].GetString();
-                                }
-                                
-                                // Extract cmd (try "cmd" first, then "command")
-                                std::string cmd_json;
-                                if (doc.HasMember("cmd")) {
-                                    if (doc["cmd"].IsString()) {
-                                        // If cmd is a string, use it directly
-                                        cmd_json = doc["cmd"].GetString();
-                                        mdclog_write(MDCLOG_INFO, "[AI-TCP] cmd is a string: '%s'", cmd_json.c_str());
-                                    } else if (doc["cmd"].IsObject()) {
-                                        // If cmd is an object, serialize it
-                                        rapidjson::StringBuffer buffer;
-                                        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-                                        doc["cmd"].Accept(writer);
-                                        cmd_json = buffer.GetString();
-                                        mdclog_write(MDCLOG_INFO, "[AI-TCP] cmd is an object, serialized to: '%s'", cmd_json.c_str());
-                                    } else {
-                                        mdclog_write(MDCLOG_WARN, "[AI-TCP] cmd field exists but is neither string nor object (type=%d)", doc["cmd"].GetType());
-                                    }
-                                } else if (doc.HasMember("command")) {
-                                    if (doc["command"].IsString()) {
-                                        // If command is a string, use it directly
-                                        cmd_json = doc["command"].GetString();
-                                        mdclog_write(MDCLOG_INFO, "[AI-TCP] command is a string: '%s'", cmd_json.c_str());
-                                    } else if (doc["command"].IsObject()) {
-                                        // If command is an object, serialize it
-                                        rapidjson::StringBuffer buffer;
-                                        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-                                        doc["command"].Accept(writer);
-                                        cmd_json = buffer.GetString();
-                                        mdclog_write(MDCLOG_INFO, "[AI-TCP] command is an object, serialized to: '%s'", cmd_json.c_str());
-                                    } else {
-                                        mdclog_write(MDCLOG_WARN, "[AI-TCP] command field exists but is neither string nor object");
-                                    }
-                                } else {
-                                    mdclog_write(MDCLOG_WARN, "[AI-TCP] No 'cmd' or 'command' field found in control message");
-                                }
-                                
-                                if (!meid.empty() && !cmd_json.empty()) {
-                                    mdclog_write(MDCLOG_INFO, "[AI-TCP] ✅ Extracted control command: meid='%s', cmd_json='%s' (len=%zu)", 
-                                                meid.c_str(), cmd_json.c_str(), cmd_json.size());
-                                    mdclog_write(MDCLOG_INFO, "[AI-TCP] → Forwarding to send_ctrl_ callback...");
-                                    control_cmd_handler_(meid, cmd_json);
-                                    mdclog_write(MDCLOG_INFO, "[AI-TCP] ✅ send_ctrl_ callback returned");
-                                } else {
-                                    mdclog_write(MDCLOG_WARN, "[AI-TCP] ❌ Received control command but missing meid or cmd: meid='%s' (len=%zu), cmd='%s' (len=%zu)", 
-                                                meid.c_str(), meid.size(), cmd_json.c_str(), cmd_json.size());
-                                }
-                            }
-                            continue;
-                        }
-                        
-                        // Config messages (qos, handover, energy, etc.) are received but not written to CSV files.
-                        // The xApp can still receive these JSONs from the AI, but they are logged and ignored.
-                        // All control should go through the direct RIC control path with "type":"control".
-                        if (config_json.find("\"type\":\"config\"") != std::string::npos ||
-                            config_json.find("\"type\":\"qos\"") != std::string::npos ||
-                            config_json.find("\"type\":\"handover\"") != std::string::npos ||
-                            config_json.find("\"type\":\"energy\"") != std::string::npos) {
-                            mdclog_write(MDCLOG_INFO, "[AI-TCP] Received config message (CSV file writing disabled). Use direct RIC control with \"type\":\"control\" instead: %s", 
-                                        config_json.substr(0, 200).c_str());
-                            continue;
-                        }
-                        // Otherwise it might be a recommendation response, but we can't handle it here
-                        // since GetRecommendation expects it. This is a limitation of the current design.
-                    }
-                }
+        link_down_ = true;
+        stats_.queue_bytes -= out_buf_.size() - out_off_;
+        failed.swap(pending_);
+        stats_.requests_failed += failed.size();
+    }
+    out_buf_.clear();
+    out_off_ = 0;
+    for (auto& request : failed) {
+        request.second.handler(false, std::string());
+    }
+}
+
+void AiTcpClient::expireRequests(std::chrono::steady_clock::time_point now) {
+    std::vector<RecommendationHandler> expired;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            if (it->second.deadline <= now) {
+                mdclog_write(MDCLOG_WARN, "[AI-TCP] Recommendation request %lu timed out",
+                             (unsigned long)it->first);
+                expired.push_back(std::move(it->second.handler));
+                it = pending_.erase(it);
             } else {
-                // Connection lost, reset
-                mdclog_write(MDCLOG_WARN, "[AI-TCP] Failed to read message length, resetting connection");
-                reset();
+                ++it;
             }
-        } else if (ret < 0) {
-            // Error
-            mdclog_write(MDCLOG_WARN, "[AI-TCP] Poll error, resetting connection");
-            reset();
         }
-        // If ret == 0, timeout - just continue loop
+        stats_.requests_timed_out += expired.size();
+    }
+    for (auto& handler : expired) {
+        handler(false, std::string());
     }
-    
-    mdclog_write(MDCLOG_INFO, "[AI-TCP] Listener loop exited");
 }
 
-// Global singleton with env-configurable host/port
+void AiTcpClient::completeRequest(uint64_t id, bool ok, const std::string& cmd_json) {
+    RecommendationHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = pending_.find(id);
+        if (it == pending_.end()) {
+            mdclog_write(MDCLOG_DEBUG, "[AI-TCP] Reply to request %lu, no longer outstanding",
+                         (unsigned long)id);
+            return;
+        }
+        handler = std::move(it->second.handler);
+        pending_.erase(it);
+    }
+    handler(ok, cmd_json);
+}
+
+void AiTcpClient::logStats() {
+    Stats stats = GetStats();
+    bool behind = stats.kpi_dropped != logged_stats_.kpi_dropped ||
+                  stats.frames_dropped != logged_stats_.frames_dropped ||
+                  stats.kpi_coalesced != logged_stats_.kpi_coalesced ||
+                  stats.requests_timed_out != logged_stats_.requests_timed_out;
+    mdclog_write(behind ? MDCLOG_WARN : MDCLOG_DEBUG,
+                 "[AI-TCP] Stats: sent %lu frames/%lu bytes, queued %zu frames/%zu bytes (peak %zu), "
+                 "KPI dropped %lu coalesced %lu, other dropped %lu, send blocked %lu, "
+                 "requests %lu pending %zu timed out %lu failed %lu, reconnects %lu",
+                 (unsigned long)stats.frames_sent, (unsigned long)stats.bytes_sent,
+                 stats.queue_frames, stats.queue_bytes, stats.queue_bytes_peak,
+                 (unsigned long)stats.kpi_dropped, (unsigned long)stats.kpi_coalesced,
+                 (unsigned long)stats.frames_dropped, (unsigned long)stats.send_blocked,
+                 (unsigned long)stats.requests_sent, stats.requests_pending,
+                 (unsigned long)stats.requests_timed_out, (unsigned long)stats.requests_failed,
+                 (unsigned long)stats.reconnects);
+    logged_stats_ = stats;
+}
+
+// Global singleton with env-configurable host/port and backpressure options
 AiTcpClient& GetAiTcpClient() {
     static std::string host = [] {
         const char* h = std::getenv("AI_HOST");
@@ -480,6 +732,23 @@ AiTcpClient& GetAiTcpClient() {
         return p ? std::atoi(p) : 5000;
     }();
 
-    static AiTcpClient client(host, port);
+    static AiTcpClient::Options options = [] {
+        AiTcpClient::Options o;
+        if (const char* v = std::getenv("AI_MAX_QUEUE_BYTES")) {
+            o.max_queue_bytes = std::strtoull(v, nullptr, 10);
+        }
+        if (const char* v = std::getenv("AI_COALESCE_KPI")) {
+            o.coalesce_kpi = std::atoi(v) != 0;
+        }
+        if (const char* v = std::getenv("AI_REQUEST_TIMEOUT_MS")) {
+            o.request_timeout_ms = std::atoi(v);
+        }
+        if (const char* v = std::getenv("AI_KPI_FORMAT")) {
+            o.binary_kpi = std::string(v) == "binary";
+        }
+        return o;
+    }();
+
+    static AiTcpClient client(host, port, options);
     return client;
 }
@@ -6,6 +6,11 @@
 #include <memory>
 #include <atomic>
 #include <thread>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
 
 // Thin client used by msgs_proc.cc to talk to the external AI over TCP.
 //
@@ -13,31 +18,108 @@
 // - Length-prefixed frames: [uint32 len in network byte order][JSON bytes]
 // - KPI message:
 //     {"type":"kpi","meid":"...","kpi":{...}}
-// - Recommendation request:
-//     {"type":"recommendation_request","meid":"...","kpi":{...}}
-// - Recommendation reply (convention used here):
-//     - empty / "{}" / contains "no_action"  => no action
-//     - otherwise: body is the exact command JSON to send to ns-3
+//   or, with AI_KPI_FORMAT=binary, the KPM Format1 reports in the binary
+//   encoding of kpm_binary_encoder.h, told apart by their first byte
+// - Result of a control command, once applied by ns-3:
+//     {"type":"control_result","meid":"...","requestorId":1,"instanceId":42,
+//      "ok":true,"outcome":{...}}
+// - Recommendation request, tagged with an id unique on the connection:
+//     {"type":"recommendation_request","id":17,"meid":"...","kpi":{...}}
+// - Recommendation reply, carrying the id of its request:
+//     {"type":"recommendation","id":17,"cmd":{...}}
+//     {"type":"recommendation","id":17,"no_action":true}
+//   An untagged reply (the exact command JSON, or empty / "{}" / containing
+//   "no_action" for no action) answers the oldest outstanding request.
+//
+// All the frames are multiplexed on one connection, owned by an I/O thread
+// (epoll): the senders only append to a send queue, so a KPI is never held
+// behind an outstanding recommendation, and several recommendations can be
+// outstanding at once.
+//
+// Environment (read by GetAiTcpClient):
+// - AI_HOST, AI_PORT: the AI server (default 127.0.0.1:5000)
+// - AI_MAX_QUEUE_BYTES: bound of the send queue, KPI frames beyond it are
+//   dropped (default 8 MiB)
+// - AI_COALESCE_KPI: if 1, a queued KPI frame that is not sent yet is
+//   replaced by the next KPI of the same MEID (default 0)
+// - AI_REQUEST_TIMEOUT_MS: timeout of the recommendation requests (default 5000)
+// - AI_KPI_FORMAT: json, or binary for the KPM Format1 reports (default json,
+//   which is easier to debug)
 //
 class AiTcpClient {
 public:
+    struct Options {
+        size_t max_queue_bytes = 8 * 1024 * 1024;
+        bool coalesce_kpi = false;
+        int request_timeout_ms = 5000;
+        int reconnect_interval_ms = 1000;
+        bool binary_kpi = false;
+    };
+
+    // Backpressure statistics, since the creation of the client
+    struct Stats {
+        uint64_t frames_sent = 0;
+        uint64_t bytes_sent = 0;
+        uint64_t kpi_dropped = 0;        // KPI frames dropped, send queue full or AI unreachable
+        uint64_t kpi_coalesced = 0;      // KPI frames replaced by a newer one of the same MEID
+        uint64_t frames_dropped = 0;     // other frames dropped, send queue full or disconnected
+        uint64_t send_blocked = 0;       // times the socket buffer was full
+        uint64_t requests_sent = 0;
+        uint64_t requests_timed_out = 0;
+        uint64_t requests_failed = 0;    // outstanding when the connection was lost
+        uint64_t reconnects = 0;
+        size_t queue_frames = 0;         // frames waiting in the send queue
+        size_t queue_bytes = 0;          // bytes waiting, including the partially sent frame
+        size_t queue_bytes_peak = 0;
+        size_t requests_pending = 0;
+    };
+
+    // Completion of an asynchronous recommendation request, called by the
+    // I/O thread: ok is false on no action, timeout or error
+    using RecommendationHandler = std::function<void(bool ok, const std::string& cmd_json)>;
+
     // Does NOT connect immediately; connection is established on first use.
     AiTcpClient(const std::string& host, int port);
+    AiTcpClient(const std::string& host, int port, const Options& options);
     ~AiTcpClient();
 
     // Best-effort, fire-and-forget KPI publish.
-    // Returns true on successful send, false otherwise.
+    // Returns true if the frame was queued, false if it was dropped.
     bool SendKpi(const std::string& meid,
                  const std::string& kpi_json);
 
-    // Synchronous request/response:
+    // Same, for a KPI frame already encoded, with its length prefix (see
+    // KpmBinaryEncoder)
+    bool SendKpiFrame(const std::string& meid,
+                      const char* frame,
+                      size_t frame_size);
+
+    // Best-effort, fire-and-forget publish of the RIC Control Acknowledge or
+    // Failure of a control command; outcome_json is the RICcontrolOutcome
+    // reported by ns-3 (a JSON object), or empty if there is none.
+    bool SendControlResult(const std::string& meid,
+                           bool ok,
+                           long requestor_id,
+                           long instance_id,
+                           const std::string& outcome_json);
+
+    // Asynchronous request/response: sends KPI/context to AI, handler is
+    // called once with the command, or ok=false on no action, timeout or
+    // error. Returns the id of the request, 0 if it could not be queued
+    // (the handler is then not called).
+    uint64_t RequestRecommendation(const std::string& meid,
+                                   const std::string& kpi_json,
+                                   RecommendationHandler handler);
+
+    // Synchronous request/response, on top of RequestRecommendation:
     // - Sends KPI/context to AI
     // - If AI returns a command, writes JSON into out_cmd_json and returns true.
     // - If no action or error, returns false.
+    // Only the caller waits, the other frames are still sent meanwhile.
     bool GetRecommendation(const std::string& meid,
                            const std::string& kpi_json,
                            std::string& out_cmd_json);
-    
+
     // Listen for reactive control commands from AI (non-blocking, runs in background)
     // When AI sends a control command, calls handler(meid, cmd_json)
     // Expected message format: {"type":"control","meid":"...","cmd":{...}}
@@ -45,26 +127,70 @@ public:
     void StartControlCommandListener(std::function<bool(const std::string&, const std::string&)> handler);
     void StopControlCommandListener();
 
+    Stats GetStats() const;
+    const Options& GetOptions() const { return options_; }
+
 private:
-    bool ensureConnected();
-    bool sendFramed(const std::string& json);
-    bool sendAll(const void* buf, size_t len);
-    bool recvAll(void* buf, size_t len);
-    void reset();
+    // A frame of the send queue, with its length prefix
+    struct OutFrame {
+        std::string bytes;
+        std::string meid;   // for the coalescing of the KPI frames, empty otherwise
+    };
+
+    struct PendingRequest {
+        RecommendationHandler handler;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    bool enqueue(const std::string& json, const std::string& kpi_meid);
+    bool enqueueFrame(std::string frame, const std::string& kpi_meid);
+    void ensureStarted();
+    void wakeup();
+
+    // I/O thread
+    void ioLoop();
+    bool startConnect();
+    void onConnected();
+    void onWritable();
+    void onReadable();
+    void handleFrame(const std::string& json);
+    void updateEvents(bool want_write);
+    void reset(const std::string& reason);
+    void expireRequests(std::chrono::steady_clock::time_point now);
+    void completeRequest(uint64_t id, bool ok, const std::string& cmd_json);
+    void logStats();
 
     std::string host_;
     int         port_;
-    int         sock_;
-    std::mutex mtx_;
-    
-    // Listener thread for receiving messages from AI
-    std::atomic<bool> listener_running_;
-    std::unique_ptr<std::thread> listener_thread_;
-    void configListenerLoop();  // Named for historical reasons, now only handles control commands
-    
-    // Control command listener (for reactive control commands)
+    Options     options_;
+
+    // owned by the I/O thread
+    int  sock_;
+    int  epoll_fd_;
+    bool connecting_;
+    bool was_connected_;
+    bool want_write_;
+    std::string out_buf_;       // frames being written
+    size_t      out_off_;
+    std::string in_buf_;        // bytes received, not yet a complete frame
+    std::chrono::steady_clock::time_point next_connect_;
+    std::chrono::steady_clock::time_point next_stats_log_;
+    Stats logged_stats_;        // at the previous log of the statistics
+
+    // shared with the senders
+    mutable std::mutex mtx_;
+    std::deque<OutFrame> queue_;
+    std::unordered_map<std::string, OutFrame*> queued_kpi_;  // MEID -> its queued KPI frame
+    std::map<uint64_t, PendingRequest> pending_;             // by id, i.e., oldest first
+    uint64_t next_request_id_;
+    Stats stats_;
+    bool link_down_;            // the last connection attempt failed, or the connection was lost
     std::function<bool(const std::string&, const std::string&)> control_cmd_handler_;
-    std::atomic<bool> control_listener_running_;
+
+    int wake_fd_;               // eventfd, to wake up the I/O thread
+    std::once_flag start_once_;
+    std::atomic<bool> running_;
+    std::unique_ptr<std::thread> io_thread_;
 };
 
 // Global accessor used by msgs_proc.cc so we don't pass instances around.
@@ -0,0 +1,343 @@
+#include "kpm_binary_encoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+extern "C" {
+#include "PM-Info-Item.h"
+#include "PerUE-PM-Item.h"
+#include "MeasurementType.h"
+#include "MeasurementValue.h"
+#include "L3-RRC-Measurements.h"
+#include "MeasQuantityResults.h"
+#include "ServingCellMeasurements.h"
+#include "MeasResultNeighCells.h"
+#include "MeasResultServMOList.h"
+#include "MeasResultServMO.h"
+#include "MeasResultNR.h"
+#include "MeasResultListNR.h"
+#include "MeasResultPCell.h"
+}
+
+namespace {
+
+const size_t kMaxCellReport = 8;   // maxCellReport of the neighbour cells
+const size_t kMaxStr = 255;
+
+enum : uint8_t {
+    TYPE_NONE = 0, TYPE_NAME = 1, TYPE_ID = 2, TYPE_NAME_REF = 3,
+};
+
+enum : uint8_t {
+    VALUE_NONE = 0, VALUE_INT = 1, VALUE_REAL = 2, VALUE_NULL = 3, VALUE_RRC = 4,
+};
+
+enum : uint8_t {
+    SERVING_NONE = 0, SERVING_NR = 1, SERVING_EUTRA = 2,
+};
+
+} // namespace
+
+KpmBinaryEncoder::KpmBinaryEncoder()
+    : len_(0),
+      generation_(0),
+      name_count_(0),
+      has_collection_start_(false),
+      collection_start_ms_(0)
+{
+    buf_.resize(4096);
+    names_.resize(256, Name{0, 0, 0, 0, 0});
+}
+
+void KpmBinaryEncoder::Clear() {
+    len_ = 0;
+    has_collection_start_ = false;
+}
+
+void KpmBinaryEncoder::SetCollectionStartTime(uint64_t ms) {
+    has_collection_start_ = true;
+    collection_start_ms_ = ms;
+}
+
+uint8_t* KpmBinaryEncoder::reserve(size_t n) {
+    if (len_ + n > buf_.size()) {
+        buf_.resize(std::max(buf_.size() * 2, len_ + n));
+    }
+    uint8_t* p = buf_.data() + len_;
+    len_ += n;
+    return p;
+}
+
+void KpmBinaryEncoder::putU8(uint8_t v) {
+    *reserve(1) = v;
+}
+
+void KpmBinaryEncoder::putU16(uint16_t v) {
+    uint8_t* p = reserve(2);
+    p[0] = uint8_t(v >> 8);
+    p[1] = uint8_t(v);
+}
+
+void KpmBinaryEncoder::putU32(uint32_t v) {
+    uint8_t* p = reserve(4);
+    p[0] = uint8_t(v >> 24);
+    p[1] = uint8_t(v >> 16);
+    p[2] = uint8_t(v >> 8);
+    p[3] = uint8_t(v);
+}
+
+void KpmBinaryEncoder::putU64(uint64_t v) {
+    putU32(uint32_t(v >> 32));
+    putU32(uint32_t(v));
+}
+
+void KpmBinaryEncoder::putStr(const void* data, size_t len) {
+    len = std::min(len, kMaxStr);
+    putU8(uint8_t(len));
+    if (len > 0) {
+        memcpy(reserve(len), data, len);
+    }
+}
+
+bool KpmBinaryEncoder::putName(const uint8_t* name, size_t len) {
+    len = std::min(len, kMaxStr);
+    uint32_t hash = 2166136261u;    // FNV-1a
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ name[i]) * 16777619u;
+    }
+
+    size_t mask = names_.size() - 1;
+    size_t slot = hash & mask;
+    for (; names_[slot].generation == generation_; slot = (slot + 1) & mask) {
+        const Name& n = names_[slot];
+        if (n.hash == hash && n.len == len && memcmp(buf_.data() + n.off, name, len) == 0) {
+            putU16(n.index);
+            return true;
+        }
+    }
+
+    putU8(uint8_t(len));
+    if (name_count_ == UINT16_MAX) {
+        // no index left, the next occurrences are written in full
+        memcpy(reserve(len), name, len);
+        return false;
+    }
+    names_[slot] = Name{generation_, hash, uint32_t(len_), uint16_t(len), name_count_++};
+    memcpy(reserve(len), name, len);
+
+    if (size_t(name_count_) * 2 > names_.size()) {
+        // rehash into a table twice as large
+        std::vector<Name> previous(names_.size() * 2, Name{0, 0, 0, 0, 0});
+        previous.swap(names_);
+        mask = names_.size() - 1;
+        for (const Name& n : previous) {
+            if (n.generation != generation_) {
+                continue;
+            }
+            for (slot = n.hash & mask; names_[slot].generation == generation_; slot = (slot + 1) & mask) {
+            }
+            names_[slot] = n;
+        }
+    }
+    return false;
+}
+
+void KpmBinaryEncoder::putSignalQuality(const MeasQuantityResults_t* mq) {
+    uint8_t mask = 0;
+    if (mq) {
+        mask = (mq->rsrp ? 1 : 0) | (mq->rsrq ? 2 : 0) | (mq->sinr ? 4 : 0);
+    }
+    putU8(mask);
+    if (mask & 1) { putU8(uint8_t(*mq->rsrp)); }
+    if (mask & 2) { putU8(uint8_t(*mq->rsrq)); }
+    if (mask & 4) { putU8(uint8_t(*mq->sinr)); }
+}
+
+void KpmBinaryEncoder::putMeasurement(const PM_Info_Item_t* item) {
+    // the tag is completed once the type and the value are known
+    size_t tag_off = len_;
+    putU8(0);
+    uint8_t type = TYPE_NONE;
+    uint8_t value = VALUE_NONE;
+
+    if (item->pmType.present == MeasurementType_PR_measName) {
+        bool known = putName(item->pmType.choice.measName.buf,
+                             item->pmType.choice.measName.buf ? item->pmType.choice.measName.size : 0);
+        type = known ? TYPE_NAME_REF : TYPE_NAME;
+    } else if (item->pmType.present == MeasurementType_PR_measID) {
+        type = TYPE_ID;
+        putU32(uint32_t(item->pmType.choice.measID));
+    }
+
+    switch (item->pmVal.present) {
+    case MeasurementValue_PR_valueInt:
+        value = VALUE_INT;
+        putU64(uint64_t(int64_t(item->pmVal.choice.valueInt)));
+        break;
+    case MeasurementValue_PR_valueReal: {
+        value = VALUE_REAL;
+        uint64_t bits;
+        static_assert(sizeof(bits) == sizeof(item->pmVal.choice.valueReal), "IEEE 754 double");
+        memcpy(&bits, &item->pmVal.choice.valueReal, sizeof(bits));
+        putU64(bits);
+        break;
+    }
+    case MeasurementValue_PR_noValue:
+        value = VALUE_NULL;
+        break;
+    case MeasurementValue_PR_valueRRC: {
+        const L3_RRC_Measurements_t* rrc = item->pmVal.choice.valueRRC;
+        if (!rrc) {
+            break;
+        }
+        value = VALUE_RRC;
+        putU8(uint8_t(rrc->rrcEvent));
+
+        const ServingCellMeasurements_t* serving = rrc->servingCellMeasurements;
+        if (serving && serving->present == ServingCellMeasurements_PR_nr_measResultServingMOList
+            && serving->choice.nr_measResultServingMOList) {
+            const MeasResultServMOList_t* list = serving->choice.nr_measResultServingMOList;
+            putU8(SERVING_NR);
+            size_t count_off = len_;
+            uint8_t count = 0;
+            putU8(0);
+            for (int i = 0; i < list->list.count && count < UINT8_MAX; i++) {
+                const MeasResultServMO_t* mo = list->list.array[i];
+                if (!mo) {
+                    continue;
+                }
+                putU8(uint8_t(mo->servCellId));
+                putSignalQuality(mo->measResultServingCell.measResult.cellResults.resultsSSB_Cell);
+                count++;
+            }
+            buf_[count_off] = count;
+        } else if (serving && serving->present == ServingCellMeasurements_PR_eutra_measResultPCell
+                   && serving->choice.eutra_measResultPCell) {
+            const MeasResultPCell_t* pcell = serving->choice.eutra_measResultPCell;
+            putU8(SERVING_EUTRA);
+            putU16(uint16_t(pcell->eutra_PhysCellId));
+            putU8(uint8_t(pcell->rsrpResult));
+            putU8(uint8_t(pcell->rsrqResult));
+        } else {
+            putU8(SERVING_NONE);
+        }
+
+        const MeasResultNeighCells_t* neigh = rrc->measResultNeighCells;
+        size_t count_off = len_;
+        putU8(0);
+        if (neigh && neigh->present == MeasResultNeighCells_PR_measResultListNR
+            && neigh->choice.measResultListNR) {
+            const MeasResultListNR_t* list = neigh->choice.measResultListNR;
+            uint8_t count = 0;
+            for (int i = 0; i < list->list.count && size_t(i) < kMaxCellReport; i++) {
+                const MeasResultNR_t* nr = list->list.array[i];
+                if (!nr) {
+                    continue;
+                }
+                putU8(nr->physCellId ? 1 : 0);
+                if (nr->physCellId) {
+                    putU16(uint16_t(*nr->physCellId));
+                }
+                putSignalQuality(nr->measResult.cellResults.resultsSSB_Cell);
+                count++;
+            }
+            buf_[count_off] = count;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    buf_[tag_off] = uint8_t(type | (value << 4));
+}
+
+void KpmBinaryEncoder::Encode(const std::string& meid,
+                              const E2SM_KPM_IndicationMessage_Format1_t* f1,
+                              int node_id,
+                              UeNodeIdFn ue_node_id)
+{
+    len_ = 0;
+    reserve(sizeof(uint32_t));   // length of the frame, known at the end
+    // a new generation empties the table of the names
+    if (++generation_ == 0) {
+        std::fill(names_.begin(), names_.end(), Name{0, 0, 0, 0, 0});
+        generation_ = 1;
+    }
+    name_count_ = 0;
+
+    putU8(kVersion);
+    putU8(has_collection_start_ ? 1 : 0);
+    putU64(uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count()));
+    if (has_collection_start_) {
+        putU64(collection_start_ms_);
+    }
+    putStr(meid.data(), meid.size());
+
+    static const char kNoCell[] = "NRCellCU";
+    const OCTET_STRING_t& cell = f1->cellObjectID;
+    if (cell.buf && !(cell.size == sizeof(kNoCell) - 1 && memcmp(cell.buf, kNoCell, cell.size) == 0)) {
+        putStr(cell.buf, cell.size);
+    } else {
+        putU8(0);
+    }
+    putU32(uint32_t(node_id));
+    putU32(uint32_t(f1->pm_Containers.list.count));
+
+    // the counts are patched once the items are written, the null ones
+    // being skipped
+    size_t count_off = len_;
+    uint16_t count = 0;
+    putU16(0);
+    if (f1->list_of_PM_Information) {
+        for (int i = 0; i < f1->list_of_PM_Information->list.count && count < UINT16_MAX; i++) {
+            const PM_Info_Item_t* item = f1->list_of_PM_Information->list.array[i];
+            if (item) {
+                putMeasurement(item);
+                count++;
+            }
+        }
+    }
+    buf_[count_off] = uint8_t(count >> 8);
+    buf_[count_off + 1] = uint8_t(count);
+
+    size_t ues_off = len_;
+    uint16_t ues = 0;
+    putU16(0);
+    if (f1->list_of_matched_UEs) {
+        for (int i = 0; i < f1->list_of_matched_UEs->list.count && ues < UINT16_MAX; i++) {
+            const PerUE_PM_Item_t* ue = f1->list_of_matched_UEs->list.array[i];
+            if (!ue) {
+                continue;
+            }
+            putStr(ue->ueId.buf, ue->ueId.buf ? ue->ueId.size : 0);
+            putU32(uint32_t(ue_node_id(ue->ueId.buf, ue->ueId.buf ? ue->ueId.size : 0, size_t(i))));
+
+            count_off = len_;
+            count = 0;
+            putU16(0);
+            if (ue->list_of_PM_Information) {
+                for (int j = 0; j < ue->list_of_PM_Information->list.count && count < UINT16_MAX; j++) {
+                    const PM_Info_Item_t* item = ue->list_of_PM_Information->list.array[j];
+                    if (item) {
+                        putMeasurement(item);
+                        count++;
+                    }
+                }
+            }
+            buf_[count_off] = uint8_t(count >> 8);
+            buf_[count_off + 1] = uint8_t(count);
+            ues++;
+        }
+    }
+    buf_[ues_off] = uint8_t(ues >> 8);
+    buf_[ues_off + 1] = uint8_t(ues);
+
+    uint32_t payload = uint32_t(len_ - sizeof(uint32_t));
+    buf_[0] = uint8_t(payload >> 24);
+    buf_[1] = uint8_t(payload >> 16);
+    buf_[2] = uint8_t(payload >> 8);
+    buf_[3] = uint8_t(payload);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include "E2SM-KPM-IndicationMessage-Format1.h"
+}
+
+// Compact binary encoding of the E2SM-KPM Format1 indication messages, sent
+// to the AI relay instead of their JSON when AI_KPI_FORMAT=binary.
+//
+// The report is written straight from the asn1c decode tree into a buffer
+// that is kept across the reports, already framed as the other messages of
+// the connection: [uint32 len][payload]. The first byte of the payload is
+// the version of the encoding, which tells the binary frames from the JSON
+// ones (a JSON frame starts with '{').
+//
+// All the integers are in network byte order, as the length of the frame.
+//
+//   payload := u8  version (1)
+//              u8  flags            bit 0: collectionStartTime present
+//              u64 rxTime           reception by the xApp, us since the epoch
+//              [u64 collectionStartTime]  ms, from the indication header
+//              str meid
+//              str cellObjectID     empty if absent or "NRCellCU"
+//              i32 node_id          -1 if unknown
+//              u32 pmContainers
+//              u16 count, meas[count]     cell measurements
+//              u16 count, ue[count]       list_of_matched_UEs
+//   ue      := str ueId (raw bytes), i32 node_id, u16 count, meas[count]
+//   meas    := u8  tag              low nibble: type, 0 none, 1 name, 2 id,
+//                                   3 name already in the report
+//                                   high nibble: value, 0 none, 1 int,
+//                                   2 real, 3 noValue, 4 RRC
+//              [str name | u32 id | u16 name index]
+//              [i64 int | f64 real | rrc]
+//   rrc     := u8  rrcEvent
+//              u8  serving          0 none, 1 NR serving cells, 2 E-UTRA PCell
+//              NR:     u8 count, {u8 servCellId, sq}[count]
+//              E-UTRA: u16 physCellId, u8 rsrp, u8 rsrq
+//              u8  count, neigh[count]    NR neighbour cells, at most 8
+//   neigh   := u8  flags            bit 0: physCellId present
+//              [u16 physCellId], sq
+//   sq      := u8  mask             bit 0 rsrp, bit 1 rsrq, bit 2 sinr
+//              u8 for each value present
+//   str     := u8 len, bytes
+//
+// The names of the measurements, the same for all the UEs, are written once
+// per report: their first occurrence is numbered from 0, in order, and the
+// next ones refer to it by its index.
+//
+// ai_relay_server.py decodes it back to the dict of the JSON encoding.
+class KpmBinaryEncoder {
+public:
+    static const uint8_t kVersion = 1;
+
+    // node_id of a UE of the report, from its ueId and its index in the list
+    using UeNodeIdFn = int (*)(const uint8_t* ue_id, size_t len, size_t index);
+
+    KpmBinaryEncoder();
+
+    // Forget the previous report, the memory is kept
+    void Clear();
+
+    // Collection start time of the next report, from its indication header
+    void SetCollectionStartTime(uint64_t ms);
+
+    // Encode a report; meid and node_id are the ones of the E2 node
+    void Encode(const std::string& meid,
+                const E2SM_KPM_IndicationMessage_Format1_t* f1,
+                int node_id,
+                UeNodeIdFn ue_node_id);
+
+    // The encoded frame, with its length prefix; empty if there is none
+    const char* frame() const { return reinterpret_cast<const char*>(buf_.data()); }
+    size_t frame_size() const { return len_; }
+    bool empty() const { return len_ == 0; }
+
+private:
+    uint8_t* reserve(size_t n);
+    void putU8(uint8_t v);
+    void putU16(uint16_t v);
+    void putU32(uint32_t v);
+    void putU64(uint64_t v);
+    void putStr(const void* data, size_t len);
+    void putMeasurement(const PM_Info_Item* item);
+    void putSignalQuality(const struct MeasQuantityResults* mq);
+    // true if the name was already in the report, written as its index
+    bool putName(const uint8_t* name, size_t len);
+
+    // A name of the report, its bytes being the ones written in buf_
+    struct Name {
+        uint32_t generation;    // the report it belongs to, 0 for none
+        uint32_t hash;
+        uint32_t off;
+        uint16_t len;
+        uint16_t index;
+    };
+
+    std::vector<uint8_t> buf_;
+    size_t len_;
+    std::vector<Name> names_;   // open addressing, at most half full
+    uint32_t generation_;
+    uint16_t name_count_;
+    bool has_collection_start_;
+    uint64_t collection_start_ms_;
+};
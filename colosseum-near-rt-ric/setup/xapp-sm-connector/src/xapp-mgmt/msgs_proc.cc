@@ -33,6 +33,7 @@
  // #include "xapp.hpp"
  
  #include "ai_tcp_client.h"
+ #include "kpm_binary_encoder.h"
  
  // E2SM (HelloWorld) indication decode support available in this repo
  #include "../xapp-asn/e2sm/e2sm_indication.hpp"
@@ -40,6 +41,7 @@
  extern "C" {
  #include "asn_application.h"
  #include "E2SM-KPM-IndicationHeader.h"
+ #include "E2SM-KPM-IndicationHeader-Format1.h"
  #include "E2SM-KPM-IndicationMessage.h"
  #include "E2SM-KPM-IndicationMessage-Format1.h"
  #include "PM-Info-Item.h"
@@ -180,6 +182,12 @@
  {
 	 GetAiTcpClient().SendKpi(meid, kpi_json);
  }
+
+ static inline void PublishKpiToExternal(const std::string& meid,
+										 const KpmBinaryEncoder& kpi)
+ {
+	 GetAiTcpClient().SendKpiFrame(meid, kpi.frame(), kpi.frame_size());
+ }
  
  static inline std::string RequestRecommendation(const std::string& meid,
 												 const std::string& kpi_json)
@@ -255,12 +263,17 @@
  
 			 std::string meid_str(reinterpret_cast<char*>(me_id));
  
-			 // Decode E2SM and get decoded JSON
-			 std::string decoded_json = process_ric_indication(message->mtype, me_id, message->payload, message->len, me_id);
+			 // Decode E2SM and get decoded JSON, or the binary encoding of the
+			 // KPM Format1 reports if selected (AI_KPI_FORMAT=binary)
+			 static thread_local KpmBinaryEncoder kpi_encoder;
+			 KpmBinaryEncoder* binary = GetAiTcpClient().GetOptions().binary_kpi ? &kpi_encoder : nullptr;
+			 std::string decoded_json = process_ric_indication(message->mtype, me_id, message->payload, message->len, me_id, binary);
  
 			 // 1) Forward decoded KPI to external system (non-blocking, fire-and-forget)
 			 // Only send if we successfully decoded, otherwise skip (don't send raw hex)
-			 if (!decoded_json.empty()) {
+			 if (binary && !binary->empty()) {
+				 PublishKpiToExternal(meid_str, *binary);
+			 } else if (!decoded_json.empty()) {
 				 PublishKpiToExternal(meid_str, decoded_json);
 				 // Note: The external system will reactively send control commands back
 				 // via the control command listener (set up in main). No polling needed.
@@ -274,6 +287,46 @@
 			 break;
 		 }
  
+		 case RIC_CONTROL_ACK:
+		 case RIC_CONTROL_FAILURE: {
+			 // the response of ns-3 once the command is applied, pushed to the AI
+			 unsigned char me_id[RMR_MAX_MEID] = {};
+			 std::string meid_str(rmr_get_meid(message, me_id) ? reinterpret_cast<char*>(me_id) : "");
+
+			 E2AP_PDU_t *pdu = nullptr;
+			 auto retval = asn_decode(nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2AP_PDU, (void **) &pdu, message->payload, message->len);
+			 if (retval.code != RC_OK) {
+				 mdclog_write(MDCLOG_ERR, "Failed to decode RIC control response of type = %d", message->mtype);
+				 ASN_STRUCT_FREE(asn_DEF_E2AP_PDU, pdu);
+				 break;
+			 }
+
+			 ric_control_response response;
+			 ric_control_helper dout {};
+			 bool ok = false;
+			 bool res = false;
+			 if (pdu->present == E2AP_PDU_PR_successfulOutcome) {
+				 ok = true;
+				 res = response.get_fields(pdu->choice.successfulOutcome, dout);
+			 } else if (pdu->present == E2AP_PDU_PR_unsuccessfulOutcome) {
+				 res = response.get_fields(pdu->choice.unsuccessfulOutcome, dout);
+			 }
+			 if (res) {
+				 std::string outcome;
+				 if (dout.control_outcome && dout.control_outcome_size > 0) {
+					 outcome.assign(reinterpret_cast<char*>(dout.control_outcome), dout.control_outcome_size);
+				 }
+				 mdclog_write(MDCLOG_INFO, "RIC control %s for MEID=%s, instance=%ld",
+							  ok ? "acknowledge" : "failure", meid_str.c_str(), dout.req_seq_no);
+				 GetAiTcpClient().SendControlResult(meid_str, ok, dout.req_id, dout.req_seq_no, outcome);
+			 } else {
+				 mdclog_write(MDCLOG_ERR, "Invalid RIC control response: %s", response.get_error().c_str());
+			 }
+			 ASN_STRUCT_FREE(asn_DEF_E2AP_PDU, pdu);
+			 *resend = false;
+			 break;
+		 }
+
 		 case (RIC_SUB_RESP): {
 				 mdclog_write(MDCLOG_INFO, "Received subscription message of type = %d", message->mtype);
  
@@ -314,7 +367,7 @@
  
  };
  
- std::string process_ric_indication(int message_type, transaction_identifier id, const void *message_payload, size_t message_len, const unsigned char* me_id) {
+ std::string process_ric_indication(int message_type, transaction_identifier id, const void *message_payload, size_t message_len, const unsigned char* me_id, KpmBinaryEncoder* binary) {
  
 	 std::cout << "In Process RIC indication" << std::endl;
 	 std::cout << "ID " << id << std::endl;
@@ -329,18 +382,30 @@
        meid_str = std::string(reinterpret_cast<const char*>(me_id));
    }
  
+   if (binary) {
+	 binary->Clear();
+   }
+
    // print decoded payload
    if (retval.code == RC_OK) {
-	 char *printBuffer;
-	 size_t size;
-	 FILE *stream = open_memstream(&printBuffer, &size);
-	 asn_fprint(stream, &asn_DEF_E2AP_PDU, pdu);
-	 mdclog_write(MDCLOG_DEBUG, "Decoded E2AP PDU: %s", printBuffer);
+	 // printing the whole PDU costs more than its decode, skip it if not logged
+	 if (mdclog_level_get() >= MDCLOG_DEBUG) {
+		 char *printBuffer;
+		 size_t size;
+		 FILE *stream = open_memstream(&printBuffer, &size);
+		 asn_fprint(stream, &asn_DEF_E2AP_PDU, pdu);
+		 fclose(stream);
+		 mdclog_write(MDCLOG_DEBUG, "Decoded E2AP PDU: %s", printBuffer);
+		 free(printBuffer);
+	 }
  
-	 return procRicIndication(pdu, id, meid_str);
+	 std::string decoded = procRicIndication(pdu, id, meid_str, binary);
+	 ASN_STRUCT_FREE(asn_DEF_E2AP_PDU, pdu);
+	 return decoded;
    }
 	 else {
 		 std::cout << "process_ric_indication, retval.code " << retval.code << std::endl;
+		 ASN_STRUCT_FREE(asn_DEF_E2AP_PDU, pdu);
 		 return std::string();
 	 }
  }
@@ -355,26 +420,97 @@
  static int g_next_ue_node_id = 3; // UEs start at node 3 (gNB is node 2)
  static std::mutex g_ue_map_mutex;
 
- std::string procRicIndication(E2AP_PDU_t *e2apMsg, transaction_identifier gnb_id, const std::string& meid_str)
+ // node_id of a UE of a report, from its ueId in hex or its index in the report
+ static int lookup_ue_node_id(const std::string& ue_id_hex, size_t i)
+ {
+	 int ue_node_id = -1;
+	 if (!ue_id_hex.empty()) {
+		 std::lock_guard<std::mutex> lock(g_ue_map_mutex);
+		 auto it = g_ueId_to_nodeId.find(ue_id_hex);
+		 if (it != g_ueId_to_nodeId.end()) {
+			 // This UE was seen before, use existing node_id
+			 ue_node_id = it->second;
+		 } else {
+			 // First time seeing this UE, assign next available node_id
+			 ue_node_id = g_next_ue_node_id++;
+			 g_ueId_to_nodeId[ue_id_hex] = ue_node_id;
+			 mdclog_write(MDCLOG_INFO, "Mapped new UE ueId=%s to node_id=%d", 
+						  ue_id_hex.c_str(), ue_node_id);
+		 }
+	 } else {
+		 // Fallback: use index-based assignment if ueId is missing
+		 ue_node_id = 3 + static_cast<int>(i);
+		 mdclog_write(MDCLOG_WARN, "UE entry %zu has no ueId, using fallback node_id=%d", 
+					  i, ue_node_id);
+	 }
+	 return ue_node_id;
+ }
+
+ static int lookup_ue_node_id_raw(const uint8_t* ue_id, size_t len, size_t i)
+ {
+	 static const char* hex_chars = "0123456789abcdef";
+	 std::string ue_id_hex;
+	 ue_id_hex.reserve(len * 2);
+	 for (size_t j = 0; j < len; j++) {
+		 ue_id_hex += hex_chars[(ue_id[j] >> 4) & 0xF];
+		 ue_id_hex += hex_chars[ue_id[j] & 0xF];
+	 }
+	 return lookup_ue_node_id(ue_id_hex, i);
+ }
+
+ std::string procRicIndication(E2AP_PDU_t *e2apMsg, transaction_identifier gnb_id, const std::string& meid_str, KpmBinaryEncoder* binary)
  {
 	uint8_t idx;
 	RICindication_t *ricIndication;
  
-	printf("\nE2AP : RIC Indication received");
+	mdclog_write(MDCLOG_DEBUG, "E2AP : RIC Indication received");
 	ricIndication = &e2apMsg->choice.initiatingMessage->value.choice.RICindication;
  
-	printf("protocolIEs elements %d\n", ricIndication->protocolIEs.list.count);
+	mdclog_write(MDCLOG_DEBUG, "protocolIEs elements %d", ricIndication->protocolIEs.list.count);
  
 	for (idx = 0; idx < ricIndication->protocolIEs.list.count; idx++)
 	{
 	   switch(ricIndication->protocolIEs.list.array[idx]->id)
 	   {
+				 case 25:  // RIC indication header
+				 {
+					 // only the binary reports carry the collection start time
+					 if (!binary) {
+						 break;
+					 }
+					 RICindicationHeader_t& header = ricIndication->protocolIEs.list.array[idx]-> \
+																		  value.choice.RICindicationHeader;
+					 E2SM_KPM_IndicationHeader_t *kpm_header = 0;
+					 asn_dec_rval_t hdr_res = asn_decode(0,
+														 ATS_ALIGNED_BASIC_PER,
+														 &asn_DEF_E2SM_KPM_IndicationHeader,
+														 (void**)&kpm_header,
+														 header.buf,
+														 header.size);
+					 if (kpm_header && hdr_res.code == RC_OK
+						 && kpm_header->present == E2SM_KPM_IndicationHeader_PR_indicationHeader_Format1
+						 && kpm_header->choice.indicationHeader_Format1) {
+						 // ns-3 writes the ms since the epoch, in network byte order
+						 const TimeStamp_t& ts = kpm_header->choice.indicationHeader_Format1->collectionStartTime;
+						 if (ts.buf && ts.size == sizeof(uint64_t)) {
+							 uint64_t ms = 0;
+							 for (size_t i = 0; i < ts.size; i++) {
+								 ms = (ms << 8) | ts.buf[i];
+							 }
+							 binary->SetCollectionStartTime(ms);
+						 }
+					 }
+					 if (kpm_header) {
+						 ASN_STRUCT_FREE(asn_DEF_E2SM_KPM_IndicationHeader, kpm_header);
+					 }
+					 break;
+				 }
 				 case 28:  // RIC indication type
 				 {
 					 long ricindicationType = ricIndication->protocolIEs.list.array[idx]-> \
 																		  value.choice.RICindicationType;
  
-					 printf("ricindicationType %ld\n", ricindicationType);
+					 mdclog_write(MDCLOG_DEBUG, "ricindicationType %ld", ricindicationType);
  
 					 break;
 				 }
@@ -620,121 +756,114 @@
 									 return -1; // Could not extract
 								 };
 								 
-								 // Start building JSON with basic info
-								 std::string json = "{\"serviceModel\":\"KPM\",\"format\":\"F1\"";
+								 if (binary) {
+									 // Compact binary report, written from the decode tree
+									 std::string cell_id;
+									 if (f1->cellObjectID.buf && f1->cellObjectID.size > 0) {
+										 cell_id = std::string((char*)f1->cellObjectID.buf, f1->cellObjectID.size);
+									 }
+									 binary->Encode(meid_str, f1, extract_node_id(cell_id), &lookup_ue_node_id_raw);
+									 decoded_ok = true;
+									 mdclog_write(MDCLOG_INFO, "Encoded KPM E2SM message Format1 (ues=%d, bytes=%zu)",
+												  f1->list_of_matched_UEs ? f1->list_of_matched_UEs->list.count : 0, binary->frame_size());
+								 } else {
+									 // Start building JSON with basic info
+									 std::string json = "{\"serviceModel\":\"KPM\",\"format\":\"F1\"";
 								 
-								 // Add cellObjectID and node_id if present
-								 int node_id = -1;
-								 std::string cell_id;
-								 if (f1->cellObjectID.buf && f1->cellObjectID.size > 0) {
-									 cell_id = std::string((char*)f1->cellObjectID.buf, f1->cellObjectID.size);
-									 // Only add if it's a valid cell ID (not "NRCellCU" or empty)
-									 if (cell_id != "NRCellCU" && !cell_id.empty()) {
-										 json += ",\"cellObjectID\":\"" + json_escape((unsigned char*)cell_id.c_str(), cell_id.size()) + "\"";
+									 // Add cellObjectID and node_id if present
+									 int node_id = -1;
+									 std::string cell_id;
+									 if (f1->cellObjectID.buf && f1->cellObjectID.size > 0) {
+										 cell_id = std::string((char*)f1->cellObjectID.buf, f1->cellObjectID.size);
+										 // Only add if it's a valid cell ID (not "NRCellCU" or empty)
+										 if (cell_id != "NRCellCU" && !cell_id.empty()) {
+											 json += ",\"cellObjectID\":\"" + json_escape((unsigned char*)cell_id.c_str(), cell_id.size()) + "\"";
+										 }
 									 }
-								 }
 								 
-								 // Extract node_id from MEID (preferred) or cell_id (fallback)
-								 node_id = extract_node_id(cell_id);
-								 if (node_id >= 0) {
-									 json += ",\"node_id\":" + std::to_string(node_id);
-								 }
+									 // Extract node_id from MEID (preferred) or cell_id (fallback)
+									 node_id = extract_node_id(cell_id);
+									 if (node_id >= 0) {
+										 json += ",\"node_id\":" + std::to_string(node_id);
+									 }
 								 
-								 // Extract PM measurements from list_of_PM_Information (cell-level)
-								 if (f1->list_of_PM_Information && f1->list_of_PM_Information->list.count > 0) {
-									 json += ",\"measurements\":[";
-									 for (size_t i = 0; i < f1->list_of_PM_Information->list.count; i++) {
-										 PM_Info_Item_t* pm_item = f1->list_of_PM_Information->list.array[i];
-										 if (pm_item) {
-											 if (i > 0) json += ",";
-											 json += extract_measurement(pm_item);
+									 // Extract PM measurements from list_of_PM_Information (cell-level)
+									 if (f1->list_of_PM_Information && f1->list_of_PM_Information->list.count > 0) {
+										 json += ",\"measurements\":[";
+										 for (size_t i = 0; i < f1->list_of_PM_Information->list.count; i++) {
+											 PM_Info_Item_t* pm_item = f1->list_of_PM_Information->list.array[i];
+											 if (pm_item) {
+												 if (i > 0) json += ",";
+												 json += extract_measurement(pm_item);
+											 }
 										 }
+										 json += "]";
 									 }
-									 json += "]";
-								 }
 								 
-								 // Extract per-UE measurements from list_of_matched_UEs
-								 if (f1->list_of_matched_UEs && f1->list_of_matched_UEs->list.count > 0) {
-									 json += ",\"ues\":[";
+									 // Extract per-UE measurements from list_of_matched_UEs
+									 if (f1->list_of_matched_UEs && f1->list_of_matched_UEs->list.count > 0) {
+										 json += ",\"ues\":[";
 									 
-									 // Use stable mapping: ueId -> node_id
-									 // This ensures the same UE always gets the same node_id,
-									 // regardless of the order in list_of_matched_UEs.
-									 // In ns-3: gNB is node 2, UEs start at node 3.
+										 // Use stable mapping: ueId -> node_id
+										 // This ensures the same UE always gets the same node_id,
+										 // regardless of the order in list_of_matched_UEs.
+										 // In ns-3: gNB is node 2, UEs start at node 3.
 									 
-									 for (size_t i = 0; i < f1->list_of_matched_UEs->list.count; i++) {
-										 PerUE_PM_Item_t* ue_item = f1->list_of_matched_UEs->list.array[i];
-										 if (ue_item) {
-											 if (i > 0) json += ",";
-											 json += "{";
+										 for (size_t i = 0; i < f1->list_of_matched_UEs->list.count; i++) {
+											 PerUE_PM_Item_t* ue_item = f1->list_of_matched_UEs->list.array[i];
+											 if (ue_item) {
+												 if (i > 0) json += ",";
+												 json += "{";
 											 
-											 // Extract UE ID first (needed for stable mapping)
-											 std::string ue_id_hex;
-											 if (ue_item->ueId.buf && ue_item->ueId.size > 0) {
-												 ue_id_hex.reserve(ue_item->ueId.size * 2);
-												 static const char* hex_chars = "0123456789abcdef";
-												 for (size_t j = 0; j < ue_item->ueId.size; j++) {
-													 unsigned char c = ue_item->ueId.buf[j];
-													 ue_id_hex += hex_chars[(c >> 4) & 0xF];
-													 ue_id_hex += hex_chars[c & 0xF];
+												 // Extract UE ID first (needed for stable mapping)
+												 std::string ue_id_hex;
+												 if (ue_item->ueId.buf && ue_item->ueId.size > 0) {
+													 ue_id_hex.reserve(ue_item->ueId.size * 2);
+													 static const char* hex_chars = "0123456789abcdef";
+													 for (size_t j = 0; j < ue_item->ueId.size; j++) {
+														 unsigned char c = ue_item->ueId.buf[j];
+														 ue_id_hex += hex_chars[(c >> 4) & 0xF];
+														 ue_id_hex += hex_chars[c & 0xF];
+													 }
+													 json += "\"ueId\":\"" + ue_id_hex + "\"";
 												 }
-												 json += "\"ueId\":\"" + ue_id_hex + "\"";
-											 }
 											 
-											 // Get or assign stable node_id for this ueId
-											 int ue_node_id = -1;
-											 if (!ue_id_hex.empty()) {
-												 std::lock_guard<std::mutex> lock(g_ue_map_mutex);
-												 auto it = g_ueId_to_nodeId.find(ue_id_hex);
-												 if (it != g_ueId_to_nodeId.end()) {
-													 // This UE was seen before, use existing node_id
-													 ue_node_id = it->second;
-												 } else {
-													 // First time seeing this UE, assign next available node_id
-													 ue_node_id = g_next_ue_node_id++;
-													 g_ueId_to_nodeId[ue_id_hex] = ue_node_id;
-													 mdclog_write(MDCLOG_INFO, "Mapped new UE ueId=%s to node_id=%d", 
-																  ue_id_hex.c_str(), ue_node_id);
-												 }
-											 } else {
-												 // Fallback: use index-based assignment if ueId is missing
-												 ue_node_id = 3 + static_cast<int>(i);
-												 mdclog_write(MDCLOG_WARN, "UE entry %zu has no ueId, using fallback node_id=%d", 
-															  i, ue_node_id);
-											 }
+												 // Get or assign stable node_id for this ueId
+												 int ue_node_id = lookup_ue_node_id(ue_id_hex, i);
 											 
-											 json += ",\"node_id\":" + std::to_string(ue_node_id);
+												 json += ",\"node_id\":" + std::to_string(ue_node_id);
 											 
-											 // Extract per-UE measurements
-											 if (ue_item->list_of_PM_Information && ue_item->list_of_PM_Information->list.count > 0) {
-												 json += ",\"measurements\":[";
-												 for (size_t j = 0; j < ue_item->list_of_PM_Information->list.count; j++) {
-													 PM_Info_Item_t* pm_item = ue_item->list_of_PM_Information->list.array[j];
-													 if (pm_item) {
-														 if (j > 0) json += ",";
-														 json += extract_measurement(pm_item);
+												 // Extract per-UE measurements
+												 if (ue_item->list_of_PM_Information && ue_item->list_of_PM_Information->list.count > 0) {
+													 json += ",\"measurements\":[";
+													 for (size_t j = 0; j < ue_item->list_of_PM_Information->list.count; j++) {
+														 PM_Info_Item_t* pm_item = ue_item->list_of_PM_Information->list.array[j];
+														 if (pm_item) {
+															 if (j > 0) json += ",";
+															 json += extract_measurement(pm_item);
+														 }
 													 }
+													 json += "]";
 												 }
-												 json += "]";
-											 }
 											 
-											 json += "}";
+												 json += "}";
+											 }
 										 }
+										 json += "]";
 									 }
-									 json += "]";
-								 }
 								 
-								 // Add PM containers count
-								 size_t pm_cont_count = f1->pm_Containers.list.count;
-								 json += ",\"pmContainers\":" + std::to_string(pm_cont_count);
+									 // Add PM containers count
+									 size_t pm_cont_count = f1->pm_Containers.list.count;
+									 json += ",\"pmContainers\":" + std::to_string(pm_cont_count);
 								 
-								 json += "}";
-								 out_json = json;
-								 decoded_ok = true;
-								 size_t meas_count = f1->list_of_PM_Information ? f1->list_of_PM_Information->list.count : 0;
-								 size_t ue_count = f1->list_of_matched_UEs ? f1->list_of_matched_UEs->list.count : 0;
-								 mdclog_write(MDCLOG_INFO, "Decoded KPM E2SM message Format1 (pmContainers=%zu, measurements=%zu, ues=%zu)", 
-											  pm_cont_count, meas_count, ue_count);
+									 json += "}";
+									 out_json = json;
+									 decoded_ok = true;
+									 size_t meas_count = f1->list_of_PM_Information ? f1->list_of_PM_Information->list.count : 0;
+									 size_t ue_count = f1->list_of_matched_UEs ? f1->list_of_matched_UEs->list.count : 0;
+									 mdclog_write(MDCLOG_INFO, "Decoded KPM E2SM message Format1 (pmContainers=%zu, measurements=%zu, ues=%zu)", 
+												  pm_cont_count, meas_count, ue_count);
+								 }
 							 }
 						 } else {
 							 out_json = "{\"serviceModel\":\"KPM\",\"format\":\"unknown\"}";
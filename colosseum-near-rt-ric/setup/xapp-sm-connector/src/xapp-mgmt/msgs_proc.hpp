@@ -50,6 +50,7 @@
 #define MAX_RMR_RECV_SIZE 2<<15
 
 class Xapp;
+class KpmBinaryEncoder;
 class XappMsgHandler{
 public:
     using ControlSender = std::function<void(const std::string&, const std::string&)>;
@@ -90,7 +91,10 @@ public:
     }
 };
 
-std::string process_ric_indication(int message_type, transaction_identifier id, const void *message_payload, size_t message_len, const unsigned char* me_id = nullptr);
-std::string procRicIndication(E2AP_PDU_t *e2apMsg, transaction_identifier gnb_id, const std::string& meid_str = "");
+// If binary is not null, a KPM Format1 report is written into it instead of
+// being returned as JSON (the returned string is then empty); the other
+// reports are still returned as JSON.
+std::string process_ric_indication(int message_type, transaction_identifier id, const void *message_payload, size_t message_len, const unsigned char* me_id = nullptr, KpmBinaryEncoder* binary = nullptr);
+std::string procRicIndication(E2AP_PDU_t *e2apMsg, transaction_identifier gnb_id, const std::string& meid_str = "", KpmBinaryEncoder* binary = nullptr);
 
 #endif /* XAPP_MSG_XAPP_MSG_HPP_ */
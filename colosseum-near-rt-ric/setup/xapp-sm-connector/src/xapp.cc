@@ -23,6 +23,7 @@
  */
 
 #include "xapp.hpp"
+#include <atomic>
 
 #define BUFFER_SIZE 1024
 
@@ -392,6 +393,10 @@ void Xapp::send_ric_control_request(char* payload, std::string gnb_id) {
  	// helpers
  	ric_control_helper din {};
 	din.func_id = 300;  // Must match the function ID registered in ns-3 (MmWaveEnbNetDevice registers with 300)
+	// the RIC Control Acknowledge/Failure of ns-3 carries the instance id
+	// back, correlating it with the request (ricInstanceID is 0..65535)
+	static std::atomic<long> control_seq_no {0};
+	din.req_seq_no = (control_seq_no++ % 65535) + 1;
 	const char* msg = payload;
 	din.control_msg_size = strlen(msg) + 1;
 	din.control_msg = (uint8_t*) calloc(din.control_msg_size, sizeof(uint8_t));
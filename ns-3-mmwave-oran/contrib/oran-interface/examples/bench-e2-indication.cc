@@ -0,0 +1,228 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/oran-interface.h"
+#include "ns3/mmwave-indication-message-helper.h"
+#include "e2sim_defs.h"
+#include "encode_e2apv1.hpp"
+#include "outbound_queue.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+using namespace ns3;
+
+/**
+* Benchmark the encode+send cost of E2AP RIC Indications carrying a DU report
+* with 10, 100 and 1000 UEs.
+* The "legacy" run reproduces the previous path, i.e., the KPM header and
+* message copied into a heap-allocated E2AP PDU tree, encoded into a new
+* buffer and copied into a MAX_SCTP_BUFFER sctp_buffer_t (truncating larger
+* PDUs), with the PDU checks and debug prints of the default e2sim build.
+* The indications are written to a local SOCK_SEQPACKET socket pair, drained
+* by a second thread.
+*
+* Sample usage: ./ns3 run 'bench-e2-indication --n=10000 --ues=10,100,1000'
+*/
+
+static const E2Termination::RicSubscriptionRequest_rval_s subscription = {24, 0, 2, 1};
+
+static Ptr<KpmIndicationMessage>
+MakeDuMessage (uint32_t ues)
+{
+  Ptr<MmWaveIndicationMessageHelper> helper = Create<MmWaveIndicationMessageHelper> (
+      IndicationMessageHelper::IndicationMessageType::Du, false, false);
+
+  for (uint32_t i = 1; i <= ues; ++i)
+    {
+      std::ostringstream imsi;
+      imsi << std::setw (5) << std::setfill ('0') << i;
+      long v = i * 17;
+      helper->AddDuUePmItem (imsi.str (), v, v, v, v, v, v, v * 100, 10, v, v, v, v, v, v, v,
+                             v, v, v, v, v, v, v * 1000, 123.4);
+    }
+  long c = ues * 17;
+  helper->AddDuCellPmItem (c, c, c, c, c, 10, c, c * 100, c, c, c, c, c, c, c, c, c, c, c, c,
+                           c, c * 1000, ues);
+
+  Ptr<CellResourceReport> cellResRep = Create<CellResourceReport> ();
+  cellResRep->m_plmId = "111";
+  cellResRep->m_nrCellId = 2;
+  cellResRep->dlAvailablePrbs = 139;
+  cellResRep->ulAvailablePrbs = 139;
+
+  Ptr<ServedPlmnPerCell> servedPlmnPerCell = Create<ServedPlmnPerCell> ();
+  servedPlmnPerCell->m_plmId = "111";
+  servedPlmnPerCell->m_nrCellId = 2;
+
+  Ptr<EpcDuPmContainer> epcDuVal = Create<EpcDuPmContainer> ();
+  epcDuVal->m_qci = 1;
+  epcDuVal->m_dlPrbUsage = 50;
+  epcDuVal->m_ulPrbUsage = 0;
+
+  servedPlmnPerCell->m_perQciReportItems.insert (epcDuVal);
+  cellResRep->m_servedPlmnPerCellItems.insert (servedPlmnPerCell);
+  helper->AddDuCellResRepPmItem (cellResRep);
+  helper->FillDuValues ("1112");
+
+  return helper->CreateIndicationMessage ();
+}
+
+static Ptr<KpmIndicationHeader>
+MakeHeader ()
+{
+  KpmIndicationHeader::KpmRicIndicationHeaderValues headerValues;
+  headerValues.m_plmId = "111";
+  headerValues.m_gnbId = "2";
+  headerValues.m_nrCellId = 2;
+  headerValues.m_timestamp = 1630068655325;
+  return Create<KpmIndicationHeader> (KpmIndicationHeader::GlobalE2nodeType::gNB, headerValues);
+}
+
+static uint64_t
+RunLegacy (uint32_t n, int fd, Ptr<KpmIndicationHeader> header,
+           Ptr<KpmIndicationMessage> message, size_t &encodedSize)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      E2AP_PDU *pdu = new E2AP_PDU;
+      encoding::generate_e2apv1_indication_request_parameterized (
+          pdu, subscription.requestorId, subscription.instanceId, subscription.ranFuncionId,
+          subscription.actionId, 1, (uint8_t *) header->m_buffer, header->m_size,
+          (uint8_t *) message->m_buffer, message->m_size);
+
+      // previous E2Sim::encode_and_send_sctp_data
+      uint8_t *buf;
+      sctp_buffer_t data;
+      data.len = aper_encode_to_new_buffer (&asn_DEF_E2AP_PDU, nullptr, pdu, (void **) &buf);
+      ASN_STRUCT_FREE_CONTENTS_ONLY (asn_DEF_E2AP_PDU, pdu);
+      encodedSize = data.len;
+      data.len = std::min (data.len, MAX_SCTP_BUFFER);
+      memcpy (data.buffer, buf, data.len);
+      NS_ABORT_MSG_IF (send (fd, data.buffer, data.len, 0) != data.len, "send failed");
+      free (buf);
+      delete pdu;
+    }
+  return time.End ();
+}
+
+static uint64_t
+RunByReference (uint32_t n, int fd, Ptr<KpmIndicationHeader> header,
+                Ptr<KpmIndicationMessage> message, size_t &encodedSize)
+{
+  OutboundPdu out = {nullptr, 0, 0, {}};
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      // E2Sim::send_indication with the outbound queue disabled
+      encoding::indication_pdu ind;
+      encoding::build_e2apv1_indication_by_reference (
+          ind, subscription.requestorId, subscription.instanceId, subscription.ranFuncionId,
+          subscription.actionId, 1, (uint8_t *) header->m_buffer, header->m_size,
+          (uint8_t *) message->m_buffer, message->m_size);
+      out.len = 0;
+      asn_enc_rval_t er = asn_encode (nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2AP_PDU,
+                                      &ind.pdu, append_to_outbound_pdu, &out);
+      NS_ABORT_MSG_IF (er.encoded < 0, "encoding failed");
+      encodedSize = out.len;
+      NS_ABORT_MSG_IF (send (fd, out.buf, out.len, 0) != (ssize_t) out.len, "send failed");
+    }
+  uint64_t deltaMs = time.End ();
+  free (out.buf);
+  return deltaMs;
+}
+
+static void
+Report (const char *name, uint32_t n, uint64_t minDelay, size_t encodedSize, bool truncates)
+{
+  double usPerIndication = minDelay * 1e3 / n;
+  double indicationsPerSecond = minDelay > 0 ? n * 1e3 / minDelay : 0;
+  std::cout << usPerIndication << " us/indication, " << indicationsPerSecond
+            << " indications/s, " << encodedSize << " bytes"
+            << (truncates && encodedSize > MAX_SCTP_BUFFER ? " (truncated on the wire)" : "") << "\t"
+            << name << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t n = 10000;
+  std::string uesList = "10,100,1000";
+  uint32_t minIterations = 1;
+  bool legacy = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("n", "number of indications", n);
+  cmd.AddValue ("ues", "comma separated numbers of UEs in the DU report", uesList);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over",
+                minIterations);
+  cmd.AddValue ("legacy", "also run the copying baseline", legacy);
+  cmd.Parse (argc, argv);
+
+  int fds[2];
+  NS_ABORT_MSG_IF (socketpair (AF_UNIX, SOCK_SEQPACKET, 0, fds) != 0, "socketpair failed");
+  int sndbuf = 4 << 20;
+  setsockopt (fds[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof (sndbuf));
+  std::thread reader ([&fds] () {
+    std::vector<uint8_t> buf (1 << 20);
+    while (recv (fds[1], buf.data (), buf.size (), 0) > 0)
+      {
+      }
+  });
+
+  Ptr<KpmIndicationHeader> header = MakeHeader ();
+  std::stringstream uesStream (uesList);
+  std::string item;
+  while (std::getline (uesStream, item, ','))
+    {
+      uint32_t ues = std::stoul (item);
+      Ptr<KpmIndicationMessage> message = MakeDuMessage (ues);
+      std::cout << "Running bench-e2-indication with n=" << n << " ues=" << ues
+                << " (KPM message " << message->m_size << " bytes)" << std::endl;
+
+      size_t encodedSize = 0;
+      uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+      for (uint32_t i = 0; i < minIterations; i++)
+        {
+          minDelay = std::min (minDelay, RunByReference (n, fds[0], header, message, encodedSize));
+        }
+      Report ("By reference, reused buffer", n, minDelay, encodedSize, false);
+
+      if (legacy)
+        {
+          minDelay = std::numeric_limits<uint64_t>::max ();
+          for (uint32_t i = 0; i < minIterations; i++)
+            {
+              minDelay = std::min (minDelay, RunLegacy (n, fds[0], header, message, encodedSize));
+            }
+          Report ("Legacy copies", n, minDelay, encodedSize, true);
+        }
+    }
+
+  shutdown (fds[0], SHUT_RDWR);
+  reader.join ();
+  close (fds[0]);
+  close (fds[1]);
+  return 0;
+}
@@ -0,0 +1,255 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/oran-interface.h"
+#include "ns3/mmwave-indication-message-helper.h"
+
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+* Benchmark the build of the KPM indications (header and DU, CU-UP and CU-CP
+* messages, i.e., the fill of the helper, the asn1c trees and the encoding)
+* with and without an Asn1cArena, for 10, 100 and 1000 UEs.
+* The heap allocations are counted by wrapping malloc, calloc and realloc
+* (glibc only), the ones of the C++ objects of the helpers included.
+*
+* Sample usage: ./ns3 run 'bench-kpm-arena --n=1000 --ues=10,100,1000'
+*/
+
+#ifdef __GLIBC__
+extern "C" {
+void *__libc_malloc (size_t size);
+void *__libc_calloc (size_t nmemb, size_t size);
+void *__libc_realloc (void *ptr, size_t size);
+}
+
+static uint64_t g_heapAllocations = 0;
+
+extern "C" void *
+malloc (size_t size)
+{
+  ++g_heapAllocations;
+  return __libc_malloc (size);
+}
+
+extern "C" void *
+calloc (size_t nmemb, size_t size)
+{
+  ++g_heapAllocations;
+  return __libc_calloc (nmemb, size);
+}
+
+extern "C" void *
+realloc (void *ptr, size_t size)
+{
+  ++g_heapAllocations;
+  return __libc_realloc (ptr, size);
+}
+#else
+static const uint64_t g_heapAllocations = 0;
+#endif
+
+static std::string
+Imsi (uint32_t i)
+{
+  std::ostringstream imsi;
+  imsi << std::setw (5) << std::setfill ('0') << i;
+  return imsi.str ();
+}
+
+static Ptr<KpmIndicationMessage>
+BuildDu (uint32_t ues)
+{
+  Ptr<MmWaveIndicationMessageHelper> helper = Create<MmWaveIndicationMessageHelper> (
+      IndicationMessageHelper::IndicationMessageType::Du, false, false);
+
+  for (uint32_t i = 1; i <= ues; ++i)
+    {
+      long v = i * 17;
+      helper->AddDuUePmItem (Imsi (i), v, v, v, v, v, v, v * 100, 10, v, v, v, v, v, v, v, v, v,
+                             v, v, v, v, v * 1000, 123.4);
+    }
+  long c = ues * 17;
+  helper->AddDuCellPmItem (c, c, c, c, c, 10, c, c * 100, c, c, c, c, c, c, c, c, c, c, c, c, c,
+                           c * 1000, ues);
+
+  Ptr<CellResourceReport> cellResRep = Create<CellResourceReport> ();
+  cellResRep->m_plmId = "111";
+  cellResRep->m_nrCellId = 2;
+  cellResRep->dlAvailablePrbs = 139;
+  cellResRep->ulAvailablePrbs = 139;
+
+  Ptr<ServedPlmnPerCell> servedPlmnPerCell = Create<ServedPlmnPerCell> ();
+  servedPlmnPerCell->m_plmId = "111";
+  servedPlmnPerCell->m_nrCellId = 2;
+
+  Ptr<EpcDuPmContainer> epcDuVal = Create<EpcDuPmContainer> ();
+  epcDuVal->m_qci = 1;
+  epcDuVal->m_dlPrbUsage = 50;
+  epcDuVal->m_ulPrbUsage = 0;
+
+  servedPlmnPerCell->m_perQciReportItems.insert (epcDuVal);
+  cellResRep->m_servedPlmnPerCellItems.insert (servedPlmnPerCell);
+  helper->AddDuCellResRepPmItem (cellResRep);
+  helper->FillDuValues ("1112");
+
+  return helper->CreateIndicationMessage ();
+}
+
+static Ptr<KpmIndicationMessage>
+BuildCuUp (uint32_t ues)
+{
+  Ptr<MmWaveIndicationMessageHelper> helper = Create<MmWaveIndicationMessageHelper> (
+      IndicationMessageHelper::IndicationMessageType::CuUp, false, false);
+
+  for (uint32_t i = 1; i <= ues; ++i)
+    {
+      helper->AddCuUpUePmItem (Imsi (i), i * 100, i * 10, i * 1.5, i * 0.1, i * 0.2);
+    }
+  helper->AddCuUpCellPmItem (1.5);
+  helper->FillCuUpValues ("111", ues * 100, ues * 10);
+
+  return helper->CreateIndicationMessage ();
+}
+
+static Ptr<KpmIndicationMessage>
+BuildCuCp (uint32_t ues)
+{
+  Ptr<MmWaveIndicationMessageHelper> helper = Create<MmWaveIndicationMessageHelper> (
+      IndicationMessageHelper::IndicationMessageType::CuCp, false, false);
+
+  for (uint32_t i = 1; i <= ues; ++i)
+    {
+      Ptr<L3RrcMeasurements> serving =
+          L3RrcMeasurements::CreateL3RrcUeSpecificSinrServing (2, 2, 60);
+      Ptr<L3RrcMeasurements> neigh = L3RrcMeasurements::CreateL3RrcUeSpecificSinrNeigh ();
+      for (long cell = 3; cell < 7; ++cell)
+        {
+          neigh->AddNeighbourCellMeasurement (cell, 40 + cell);
+        }
+      helper->AddCuCpUePmItem (Imsi (i), 1, 0, serving, neigh);
+    }
+  helper->FillCuCpValues (ues);
+
+  return helper->CreateIndicationMessage ();
+}
+
+static Ptr<KpmIndicationHeader>
+BuildHeader ()
+{
+  KpmIndicationHeader::KpmRicIndicationHeaderValues headerValues;
+  headerValues.m_plmId = "111";
+  headerValues.m_gnbId = "2";
+  headerValues.m_nrCellId = 2;
+  headerValues.m_timestamp = 1630068655325;
+  return Create<KpmIndicationHeader> (KpmIndicationHeader::GlobalE2nodeType::gNB, headerValues);
+}
+
+struct Result
+{
+  uint64_t delayMs;
+  double heapAllocationsPerReport;
+  uint64_t arenaAllocationsPerReport;
+  size_t arenaBytes;
+  size_t encodedSize;
+};
+
+static Result
+Run (uint32_t n, uint32_t ues, Ptr<KpmIndicationMessage> (*build) (uint32_t), Asn1cArena *arena)
+{
+  Result result = {0, 0, 0, 0, 0};
+
+  // the first report warms up the arena and the allocator
+  {
+    Asn1cArenaScope scope (arena);
+    build (ues);
+  }
+
+  uint64_t heapAllocations = g_heapAllocations;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Asn1cArenaScope scope (arena);
+      Ptr<KpmIndicationHeader> header = BuildHeader ();
+      Ptr<KpmIndicationMessage> message = build (ues);
+      result.encodedSize = header->m_size + message->m_size;
+      if (arena != nullptr)
+        {
+          result.arenaAllocationsPerReport = arena->GetAllocations ();
+          result.arenaBytes = arena->GetUsedBytes ();
+        }
+    }
+  result.delayMs = time.End ();
+  result.heapAllocationsPerReport = (double) (g_heapAllocations - heapAllocations) / n;
+  return result;
+}
+
+static void
+Report (const char *name, uint32_t n, const Result &result)
+{
+  std::cout << result.delayMs * 1e3 / n << " us/report, " << result.heapAllocationsPerReport
+            << " heap allocations/report";
+  if (result.arenaBytes > 0)
+    {
+      std::cout << ", " << result.arenaAllocationsPerReport << " arena allocations ("
+                << result.arenaBytes << " bytes)/report";
+    }
+  std::cout << ", " << result.encodedSize << " encoded bytes\t" << name << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t n = 1000;
+  std::string uesList = "10,100,1000";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("n", "number of reports of each type", n);
+  cmd.AddValue ("ues", "comma separated numbers of UEs in the reports", uesList);
+  cmd.Parse (argc, argv);
+
+  struct
+  {
+    const char *name;
+    Ptr<KpmIndicationMessage> (*build) (uint32_t);
+  } types[] = {{"DU", BuildDu}, {"CU-UP", BuildCuUp}, {"CU-CP", BuildCuCp}};
+
+  std::stringstream uesStream (uesList);
+  std::string item;
+  while (std::getline (uesStream, item, ','))
+    {
+      uint32_t ues = std::stoul (item);
+      for (const auto &type : types)
+        {
+          std::cout << "Running bench-kpm-arena with n=" << n << " ues=" << ues << " report="
+                    << type.name << std::endl;
+          Report ("Heap", n, Run (n, ues, type.build, nullptr));
+
+          Asn1cArena arena;
+          Report ("Arena", n, Run (n, ues, type.build, &arena));
+          std::cout << "Arena capacity " << arena.GetCapacity () << " bytes, "
+                    << arena.GetHeapAllocations () << " blocks requested" << std::endl;
+        }
+    }
+
+  return 0;
+}
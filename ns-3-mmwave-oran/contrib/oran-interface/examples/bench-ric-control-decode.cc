@@ -0,0 +1,236 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/oran-interface.h"
+
+#include <cstdlib>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+* Benchmark the decode of the simple JSON control commands, in commands/s:
+* - "Search": the previous extraction, a std::string::find of each key of the
+*   command, followed by the comparison of the name of the command
+* - "Decode": RicControlCommandDecoder, one command per message
+* - "Batch": RicControlCommandDecoder, batches of commands
+* - "Apply": RicControlMessage::ApplySimpleCommand with the batches, i.e.,
+*   the decode and the events, the commands targeting nodes that do not exist
+*
+* Sample usage: ./ns3 run 'bench-ric-control-decode --n=1000000 --batch=64'
+*/
+
+static bool
+SearchNumber (const std::string &s, const char *key, double &value)
+{
+  size_t k = s.find (key);
+  if (k == std::string::npos)
+    {
+      return false;
+    }
+  k = s.find (':', k);
+  if (k == std::string::npos)
+    {
+      return false;
+    }
+  while (k + 1 < s.size () && s[k + 1] == ' ')
+    {
+      ++k;
+    }
+  char *end = nullptr;
+  value = strtod (s.c_str () + k + 1, &end);
+  return end != s.c_str () + k + 1;
+}
+
+static bool
+SearchString (const std::string &s, const char *key, std::string &value)
+{
+  size_t k = s.find (key);
+  if (k == std::string::npos)
+    {
+      return false;
+    }
+  k = s.find ('"', s.find (':', k));
+  size_t e = s.find ('"', k + 1);
+  if (k == std::string::npos || e == std::string::npos)
+    {
+      return false;
+    }
+  value.assign (s.begin () + k + 1, s.begin () + e);
+  return true;
+}
+
+/**
+* The extraction of the fields done before RicControlCommandDecoder
+* \param json the message
+* \return the sum of the fields, so that the extraction is not optimized out
+*/
+static double
+Search (const std::string &json)
+{
+  std::string cmd;
+  double node = 0;
+  double a = 0;
+  double b = 0;
+  if (!SearchString (json, "\"cmd\"", cmd))
+    {
+      return 0;
+    }
+  if (cmd == "handover-trigger")
+    {
+      SearchNumber (json, "\"node\"", node);
+      SearchNumber (json, "\"ueId\"", a);
+      SearchNumber (json, "\"targetCellId\"", b);
+    }
+  else if (cmd == "set-mcs")
+    {
+      SearchNumber (json, "\"node\"", node);
+      SearchNumber (json, "\"mcs\"", a);
+    }
+  else if (cmd == "set-bandwidth")
+    {
+      SearchNumber (json, "\"node\"", node);
+      SearchNumber (json, "\"bandwidth\"", a);
+    }
+  else if (cmd == "set-flow-rate")
+    {
+      SearchNumber (json, "\"node\"", node);
+      SearchNumber (json, "\"app\"", a);
+      SearchNumber (json, "\"rateMbps\"", b);
+    }
+  else if (cmd == "set-enb-txpower")
+    {
+      SearchNumber (json, "\"node\"", node);
+      SearchNumber (json, "\"txPowerDbm\"", a);
+    }
+  return node + a + b;
+}
+
+/**
+* \param i the index of the command
+* \return a command of the mix of the benchmark
+*/
+static std::string
+Command (uint32_t i)
+{
+  // nodes that do not exist, so that the commands are only looked up when applied
+  uint32_t node = 1000 + i % 7;
+  std::ostringstream json;
+  switch (i % 5)
+    {
+    case 0:
+      json << "{\"cmd\":\"set-mcs\",\"node\":" << node << ",\"mcs\":" << i % 29 << "}";
+      break;
+    case 1:
+      json << "{\"cmd\":\"set-flow-rate\",\"node\":" << node << ",\"app\":0,\"rateMbps\":"
+           << 1 + i % 50 << ".5}";
+      break;
+    case 2:
+      json << "{\"cmd\":\"set-enb-txpower\",\"node\":" << node << ",\"txPowerDbm\":" << i % 30
+           << "}";
+      break;
+    case 3:
+      json << "{\"cmd\":\"handover-trigger\",\"node\":" << node << ",\"ueId\":" << 1 + i % 10
+           << ",\"targetCellId\":" << 2 + i % 4 << "}";
+      break;
+    default:
+      json << "{\"cmd\":\"set-bandwidth\",\"node\":" << node << ",\"bandwidth\":" << 100 + i % 100
+           << "}";
+      break;
+    }
+  return json.str ();
+}
+
+static void
+Report (const char *name, uint64_t commands, uint64_t delayMs, double check)
+{
+  std::cout << commands * 1e3 / std::max<uint64_t> (delayMs, 1) << " commands/s, "
+            << delayMs * 1e6 / commands << " ns/command\t" << name << " (" << check << ")"
+            << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+  uint32_t batch = 64;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("n", "number of commands of each run", n);
+  cmd.AddValue ("batch", "number of commands of the batches", batch);
+  cmd.Parse (argc, argv);
+
+  const uint32_t distinct = 1000;
+  std::vector<std::string> singles;
+  for (uint32_t i = 0; i < distinct; ++i)
+    {
+      singles.push_back (Command (i));
+    }
+  std::vector<std::string> batches;
+  for (uint32_t i = 0; i < distinct; ++i)
+    {
+      std::string json = "{\"cmds\":[";
+      for (uint32_t j = 0; j < batch; ++j)
+        {
+          json += (j > 0 ? "," : "") + Command (i * batch + j);
+        }
+      batches.push_back (json + "]}");
+    }
+  uint32_t nBatches = std::max<uint32_t> (n / batch, 1);
+
+  std::cout << "Running bench-ric-control-decode with n=" << n << " batch=" << batch
+            << std::endl;
+
+  SystemWallClockMs time;
+  double check = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      check += Search (singles[i % distinct]);
+    }
+  Report ("Search", n, time.End (), check);
+
+  std::vector<RicControlCommand> commands;
+  check = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      RicControlCommandDecoder::Decode (singles[i % distinct], commands);
+      check += commands[0].m_node + commands[0].m_mcs + commands[0].m_rateMbps;
+    }
+  Report ("Decode", n, time.End (), check);
+
+  check = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < nBatches; ++i)
+    {
+      RicControlCommandDecoder::Decode (batches[i % distinct], commands);
+      check += commands.size ();
+    }
+  Report ("Batch", uint64_t (nBatches) * batch, time.End (), check);
+
+  time.Start ();
+  for (uint32_t i = 0; i < nBatches; ++i)
+    {
+      RicControlMessage::ApplySimpleCommand (batches[i % distinct]);
+    }
+  Simulator::Run ();
+  Report ("Apply", uint64_t (nBatches) * batch, time.End (), Simulator::GetEventCount ());
+  Simulator::Destroy ();
+
+  return 0;
+}
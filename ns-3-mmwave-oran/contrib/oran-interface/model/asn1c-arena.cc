@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/asn1c-arena.h>
+#include <ns3/abort.h>
+#include <ns3/assert.h>
+#include <ns3/log.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+  #include "asn_SET_OF.h"
+}
+
+NS_LOG_COMPONENT_DEFINE ("Asn1cArena");
+
+namespace ns3 {
+
+static const size_t ARENA_ALIGNMENT = alignof (std::max_align_t);
+
+thread_local Asn1cArena *Asn1cArena::s_current = nullptr;
+
+Asn1cArena::Asn1cArena (size_t blockSize)
+  : m_blockSize (blockSize),
+    m_offset (0),
+    m_usedBytes (0),
+    m_allocations (0),
+    m_heapAllocations (0)
+{
+  NS_LOG_FUNCTION (this << blockSize);
+}
+
+Asn1cArena::~Asn1cArena ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (s_current != this, "Destroying an arena that is still installed");
+  for (auto &block : m_blocks)
+    {
+      free (block.data);
+    }
+}
+
+void
+Asn1cArena::AddBlock (size_t minSize)
+{
+  size_t size = std::max (m_blockSize, minSize);
+  uint8_t *data = (uint8_t *) aligned_alloc (ARENA_ALIGNMENT,
+                                             (size + ARENA_ALIGNMENT - 1)
+                                                 / ARENA_ALIGNMENT * ARENA_ALIGNMENT);
+  NS_ABORT_MSG_IF (data == nullptr, "Out of memory for the asn1c arena");
+  m_blocks.push_back ({data, size});
+  m_offset = 0;
+  m_blockSize = size * 2;
+  ++m_heapAllocations;
+}
+
+void *
+Asn1cArena::Allocate (size_t size)
+{
+  size = (std::max<size_t> (size, 1) + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+  if (m_blocks.empty () || m_offset + size > m_blocks.back ().size)
+    {
+      AddBlock (size);
+    }
+  uint8_t *ptr = m_blocks.back ().data + m_offset;
+  m_offset += size;
+  m_usedBytes += size;
+  ++m_allocations;
+  memset (ptr, 0, size);
+  return ptr;
+}
+
+bool
+Asn1cArena::Owns (const void *ptr) const
+{
+  const uint8_t *p = (const uint8_t *) ptr;
+  for (const auto &block : m_blocks)
+    {
+      if (p >= block.data && p < block.data + block.size)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+Asn1cArena::Reset ()
+{
+  NS_LOG_FUNCTION (this << m_allocations << m_usedBytes);
+  if (m_blocks.size () > 1)
+    {
+      // merge the blocks, so that the next report of the same size fits in one
+      size_t capacity = GetCapacity ();
+      for (auto &block : m_blocks)
+        {
+          free (block.data);
+        }
+      m_blocks.clear ();
+      m_blockSize = capacity;
+      AddBlock (capacity);
+    }
+  m_offset = 0;
+  m_usedBytes = 0;
+  m_allocations = 0;
+}
+
+uint64_t
+Asn1cArena::GetAllocations () const
+{
+  return m_allocations;
+}
+
+size_t
+Asn1cArena::GetUsedBytes () const
+{
+  return m_usedBytes;
+}
+
+size_t
+Asn1cArena::GetCapacity () const
+{
+  size_t capacity = 0;
+  for (const auto &block : m_blocks)
+    {
+      capacity += block.size;
+    }
+  return capacity;
+}
+
+uint64_t
+Asn1cArena::GetHeapAllocations () const
+{
+  return m_heapAllocations;
+}
+
+Asn1cArena *
+Asn1cArena::GetCurrent ()
+{
+  return s_current;
+}
+
+void *
+Asn1cArena::Calloc (size_t nmemb, size_t size)
+{
+  if (s_current != nullptr)
+    {
+      return s_current->Allocate (nmemb * size);
+    }
+  return calloc (nmemb, size);
+}
+
+void
+Asn1cArena::Free (void *ptr)
+{
+  if (s_current != nullptr && s_current->Owns (ptr))
+    {
+      return;
+    }
+  free (ptr);
+}
+
+void
+Asn1cArena::StructFree (asn_TYPE_descriptor_t &td, void *ptr)
+{
+  if (ptr == nullptr || (s_current != nullptr && s_current->Owns (ptr)))
+    {
+      return;
+    }
+  ASN_STRUCT_FREE (td, ptr);
+}
+
+int
+Asn1cArena::SequenceAdd (void *list, void *item)
+{
+  asn_anonymous_set_ *set = _A_SET_FROM_VOID (list);
+  if (s_current == nullptr || (set->array != nullptr && !s_current->Owns (set->array)))
+    {
+      return asn_set_add (list, item);
+    }
+  if (item == nullptr)
+    {
+      return -1;
+    }
+
+  if (set->count == set->size)
+    {
+      // the old array is left in the arena, it is released with the report
+      int size = set->size ? set->size << 1 : 4;
+      void **array = (void **) s_current->Allocate (size * sizeof (void *));
+      if (set->count > 0)
+        {
+          memcpy (array, set->array, set->count * sizeof (void *));
+        }
+      set->array = array;
+      set->size = size;
+    }
+  set->array[set->count++] = item;
+  return 0;
+}
+
+int
+Asn1cArena::Long2Integer (INTEGER_t *st, long value)
+{
+  if (s_current == nullptr)
+    {
+      return asn_long2INTEGER (st, value);
+    }
+  if (st == nullptr)
+    {
+      return -1;
+    }
+
+  // big-endian two's complement, without the redundant leading bytes
+  uint8_t bytes[sizeof (long)];
+  unsigned long v = (unsigned long) value;
+  for (size_t i = 0; i < sizeof (long); ++i)
+    {
+      bytes[sizeof (long) - 1 - i] = (uint8_t) (v >> (8 * i));
+    }
+  size_t start = 0;
+  while (start < sizeof (long) - 1
+         && ((bytes[start] == 0x00 && !(bytes[start + 1] & 0x80))
+             || (bytes[start] == 0xff && (bytes[start + 1] & 0x80))))
+    {
+      ++start;
+    }
+
+  st->size = sizeof (long) - start;
+  st->buf = (uint8_t *) s_current->Allocate (st->size);
+  memcpy (st->buf, bytes + start, st->size);
+  return 0;
+}
+
+Asn1cArenaScope::Asn1cArenaScope (Asn1cArena *arena)
+  : m_arena (arena),
+    m_previous (Asn1cArena::s_current)
+{
+  if (m_arena != nullptr)
+    {
+      Asn1cArena::s_current = m_arena;
+    }
+}
+
+Asn1cArenaScope::~Asn1cArenaScope ()
+{
+  if (m_arena != nullptr)
+    {
+      Asn1cArena::s_current = m_previous;
+      m_arena->Reset ();
+    }
+}
+
+} // namespace ns3
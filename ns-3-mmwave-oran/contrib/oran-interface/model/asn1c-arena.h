@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASN1C_ARENA_H
+#define ASN1C_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <sys/types.h>
+
+extern "C" {
+  #include "constr_TYPE.h"
+  #include "INTEGER.h"
+}
+
+namespace ns3 {
+
+/**
+* Bump allocator for the asn1c structures of a RIC Indication.
+*
+* The KPM indication header and message are built as trees of small
+* calloc'ed asn1c structures, which are encoded once and then released.
+* While an arena is installed with an Asn1cArenaScope, the fill functions of
+* KpmIndicationHeader and KpmIndicationMessage and the constructors of the
+* wrappers in asn1c-types.h take their memory from the arena, and the
+* matching frees become no-ops: the whole tree is released in one shot when
+* the scope ends. The arena keeps its memory across reports, so that once it
+* has grown to the size of a report no further heap allocation is needed.
+*
+* Every wrapper and asn1c structure created under a scope must be destroyed
+* before the scope ends, and a tree must be entirely built either inside or
+* outside of a scope.
+*/
+class Asn1cArena
+{
+public:
+  /**
+  * \param blockSize the size of the first block, in bytes
+  */
+  Asn1cArena (size_t blockSize = 64 * 1024);
+  ~Asn1cArena ();
+
+  Asn1cArena (const Asn1cArena &) = delete;
+  Asn1cArena &operator= (const Asn1cArena &) = delete;
+
+  /**
+  * \param size the number of bytes
+  * \return zeroed memory, aligned for any asn1c type
+  */
+  void *Allocate (size_t size);
+
+  /**
+  * \param ptr a pointer
+  * \return true if the pointer was returned by Allocate
+  */
+  bool Owns (const void *ptr) const;
+
+  /**
+  * Release all the allocations at once. If more than one block was needed,
+  * the blocks are merged into a single one for the next report.
+  */
+  void Reset ();
+
+  /**
+  * \return the number of allocations since the last Reset
+  */
+  uint64_t GetAllocations () const;
+
+  /**
+  * \return the number of bytes allocated since the last Reset
+  */
+  size_t GetUsedBytes () const;
+
+  /**
+  * \return the total size of the blocks
+  */
+  size_t GetCapacity () const;
+
+  /**
+  * \return the number of blocks requested to the heap since the creation
+  */
+  uint64_t GetHeapAllocations () const;
+
+  /**
+  * \return the arena installed on this thread, or nullptr
+  */
+  static Asn1cArena *GetCurrent ();
+
+  /**
+  * calloc replacement for the asn1c structures of the indications
+  */
+  static void *Calloc (size_t nmemb, size_t size);
+
+  /**
+  * free replacement, a no-op for the memory of the current arena
+  */
+  static void Free (void *ptr);
+
+  /**
+  * ASN_STRUCT_FREE replacement, a no-op for the trees of the current arena
+  */
+  static void StructFree (asn_TYPE_descriptor_t &td, void *ptr);
+
+  /**
+  * ASN_SEQUENCE_ADD replacement, that grows the list in the current arena
+  * \param list pointer to an A_SEQUENCE_OF or A_SET_OF
+  * \param item the item to append
+  * \return 0 on success, -1 otherwise
+  */
+  static int SequenceAdd (void *list, void *item);
+
+  /**
+  * asn_long2INTEGER replacement, that takes the buffer from the current arena
+  */
+  static int Long2Integer (INTEGER_t *st, long value);
+
+private:
+  friend class Asn1cArenaScope;
+
+  struct Block
+  {
+    uint8_t *data;
+    size_t size;
+  };
+
+  void AddBlock (size_t minSize);
+
+  std::vector<Block> m_blocks; //!< the blocks, m_blocks.back () is the current one
+  size_t m_blockSize; //!< the size of the next block
+  size_t m_offset; //!< first free byte in the current block
+  size_t m_usedBytes;
+  uint64_t m_allocations;
+  uint64_t m_heapAllocations;
+
+  static thread_local Asn1cArena *s_current;
+};
+
+/**
+* Install an arena for the lifetime of the scope, and reset it at the end.
+* A null arena leaves the heap allocation in place.
+*/
+class Asn1cArenaScope
+{
+public:
+  Asn1cArenaScope (Asn1cArena *arena);
+  ~Asn1cArenaScope ();
+
+  Asn1cArenaScope (const Asn1cArenaScope &) = delete;
+  Asn1cArenaScope &operator= (const Asn1cArenaScope &) = delete;
+
+private:
+  Asn1cArena *m_arena;
+  Asn1cArena *m_previous;
+};
+
+} // namespace ns3
+
+#endif /* ASN1C_ARENA_H */
@@ -0,0 +1,734 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ric-control-command.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace ns3 {
+
+namespace {
+
+/// An entry of a perfect hash table of names
+struct Entry
+{
+  const char *name; //!< the name, nullptr if the slot is empty
+  size_t len;       //!< the length of the name
+  uint8_t id;       //!< the value of the name
+};
+
+/// A perfect hash table with N slots, N being a power of 2
+template <size_t N>
+struct Table
+{
+  Entry slots[N]; //!< the slots
+};
+
+constexpr size_t
+Length (const char *s)
+{
+  size_t n = 0;
+  while (s[n] != '\0')
+    {
+      n++;
+    }
+  return n;
+}
+
+/**
+* The hash of a name, from its length and its last character
+* \param len the length of the name
+* \param last the last character of the name
+* \param mult the multiplier of the table
+* \param mask the number of slots of the table minus 1
+* \return the slot of the name
+*/
+constexpr size_t
+Hash (size_t len, char last, unsigned mult, size_t mask)
+{
+  return (len + mult * static_cast<unsigned char> (last)) & mask;
+}
+
+template <size_t N, size_t M>
+constexpr bool
+IsPerfect (const char *const (&names)[M], unsigned mult)
+{
+  bool used[N] = {};
+  for (size_t i = 0; i < M; i++)
+    {
+      size_t len = Length (names[i]);
+      size_t slot = Hash (len, names[i][len - 1], mult, N - 1);
+      if (used[slot])
+        {
+          return false;
+        }
+      used[slot] = true;
+    }
+  return true;
+}
+
+template <size_t N, size_t M>
+constexpr Table<N>
+MakeTable (const char *const (&names)[M], unsigned mult)
+{
+  Table<N> table = {};
+  for (size_t i = 0; i < M; i++)
+    {
+      size_t len = Length (names[i]);
+      table.slots[Hash (len, names[i][len - 1], mult, N - 1)] = {names[i], len,
+                                                                 static_cast<uint8_t> (i)};
+    }
+  return table;
+}
+
+template <size_t N>
+int
+Lookup (const Table<N> &table, unsigned mult, const char *name, size_t len)
+{
+  if (len == 0)
+    {
+      return -1;
+    }
+  const Entry &entry = table.slots[Hash (len, name[len - 1], mult, N - 1)];
+  if (entry.len != len || std::memcmp (entry.name, name, len) != 0)
+    {
+      return -1;
+    }
+  return entry.id;
+}
+
+/// The names of the commands, indexed by RicControlCommand::Type
+constexpr const char *g_commandNames[RicControlCommand::NUM_TYPES] = {
+    "stop",          "handover-trigger", "set-mcs",        "set-bandwidth",
+    "set-flow-rate", "set-enb-txpower",  "set-slice-quota", "set-ue-slice"};
+constexpr unsigned g_commandMult = 7; //!< the multiplier of the hash of the commands
+static_assert (IsPerfect<16> (g_commandNames, g_commandMult), "Collision in the command table");
+constexpr Table<16> g_commands = MakeTable<16> (g_commandNames, g_commandMult); //!< the commands
+
+/// The keys of the messages
+enum Key : uint8_t
+{
+  KEY_CMD,
+  KEY_CMDS,
+  KEY_NODE,
+  KEY_UE_ID,
+  KEY_TARGET_CELL_ID,
+  KEY_MCS,
+  KEY_BANDWIDTH,
+  KEY_APP,
+  KEY_RATE_MBPS,
+  KEY_TX_POWER_DBM,
+  KEY_ID,
+  KEY_SST,
+  KEY_SD,
+  KEY_PRB_MIN,
+  KEY_PRB_MAX,
+  KEY_PRIORITY,
+  NUM_KEYS
+};
+
+/// The names of the keys, indexed by Key
+constexpr const char *g_keyNames[NUM_KEYS] = {"cmd",
+                                              "cmds",
+                                              "node",
+                                              "ueId",
+                                              "targetCellId",
+                                              "mcs",
+                                              "bandwidth",
+                                              "app",
+                                              "rateMbps",
+                                              "txPowerDbm",
+                                              "id",
+                                              "sST",
+                                              "sD",
+                                              "prbMin",
+                                              "prbMax",
+                                              "priority"};
+constexpr unsigned g_keyMult = 5; //!< the multiplier of the hash of the keys
+static_assert (IsPerfect<64> (g_keyNames, g_keyMult), "Collision in the key table");
+constexpr Table<64> g_keys = MakeTable<64> (g_keyNames, g_keyMult); //!< the keys
+
+/// The fields set by the number keys, indexed by Key
+constexpr uint16_t g_keyFields[NUM_KEYS] = {0,
+                                            0,
+                                            RicControlCommand::NODE,
+                                            RicControlCommand::UE_ID,
+                                            RicControlCommand::TARGET_CELL_ID,
+                                            RicControlCommand::MCS,
+                                            RicControlCommand::BANDWIDTH,
+                                            RicControlCommand::APP,
+                                            RicControlCommand::RATE_MBPS,
+                                            RicControlCommand::TX_POWER_DBM,
+                                            RicControlCommand::ID,
+                                            RicControlCommand::SST,
+                                            RicControlCommand::SD,
+                                            RicControlCommand::PRB_MIN,
+                                            RicControlCommand::PRB_MAX,
+                                            RicControlCommand::PRIORITY};
+
+/// The mandatory fields of the commands, indexed by RicControlCommand::Type
+constexpr uint16_t g_requiredFields[RicControlCommand::NUM_TYPES] = {
+    0,
+    RicControlCommand::NODE | RicControlCommand::UE_ID | RicControlCommand::TARGET_CELL_ID,
+    RicControlCommand::NODE | RicControlCommand::MCS,
+    RicControlCommand::BANDWIDTH,
+    RicControlCommand::APP | RicControlCommand::RATE_MBPS,
+    RicControlCommand::NODE | RicControlCommand::TX_POWER_DBM,
+    RicControlCommand::NODE | RicControlCommand::SST | RicControlCommand::PRB_MIN |
+        RicControlCommand::PRB_MAX,
+    RicControlCommand::NODE | RicControlCommand::UE_ID | RicControlCommand::SST};
+
+/// Maximum nesting of the skipped values
+constexpr unsigned g_maxDepth = 32;
+
+/**
+* Recursive descent tokenizer of a null-terminated message, which stops at
+* the first error
+*/
+class Parser
+{
+public:
+  /**
+  * \param begin the first character of the message
+  * \param end the terminating null character of the message
+  */
+  Parser (const char *begin, const char *end)
+    : m_p (begin),
+      m_end (end)
+  {
+  }
+
+  /**
+  * Parse the whole message
+  * \param commands the commands, appended in the order of the message
+  * \return the status
+  */
+  RicControlCommandDecoder::Status
+  ParseMessage (std::vector<RicControlCommand> &commands)
+  {
+    RicControlCommand command;
+    bool named = false;
+    bool batch = false;
+    RicControlCommandDecoder::Status status = ParseCommand (command, named, &commands, batch);
+    if (status != RicControlCommandDecoder::OK)
+      {
+        return status;
+      }
+    SkipSpaces ();
+    if (m_p != m_end)
+      {
+        return RicControlCommandDecoder::SYNTAX_ERROR;
+      }
+    if (named)
+      {
+        // the command outside of the batch, if any, comes first
+        commands.insert (commands.begin (), command);
+      }
+    return named || batch ? RicControlCommandDecoder::OK : RicControlCommandDecoder::NO_COMMAND;
+  }
+
+private:
+  void
+  SkipSpaces ()
+  {
+    while (m_p != m_end && (*m_p == ' ' || *m_p == '\t' || *m_p == '\n' || *m_p == '\r'))
+      {
+        m_p++;
+      }
+  }
+
+  /**
+  * Consume a character, after the spaces
+  * \param c the character
+  * \return true if the next character was c
+  */
+  bool
+  Consume (char c)
+  {
+    SkipSpaces ();
+    if (m_p != m_end && *m_p == c)
+      {
+        m_p++;
+        return true;
+      }
+    return false;
+  }
+
+  /**
+  * Parse a string, without unescaping it
+  * \param begin the first character of the string
+  * \param len the length of the string
+  * \return true if a string was parsed
+  */
+  bool
+  ParseString (const char *&begin, size_t &len)
+  {
+    if (!Consume ('"'))
+      {
+        return false;
+      }
+    begin = m_p;
+    while (m_p != m_end && *m_p != '"')
+      {
+        if (*m_p == '\\' && m_p + 1 != m_end)
+          {
+            m_p++;
+          }
+        m_p++;
+      }
+    if (m_p == m_end)
+      {
+        return false;
+      }
+    len = m_p - begin;
+    m_p++;
+    return true;
+  }
+
+  /**
+  * Parse a number, also if quoted
+  * \param value the number
+  * \return true if a number was parsed
+  */
+  bool
+  ParseNumber (double &value)
+  {
+    SkipSpaces ();
+    bool quoted = m_p != m_end && *m_p == '"';
+    const char *begin = m_p + (quoted ? 1 : 0);
+    if (begin == m_end || (*begin != '-' && (*begin < '0' || *begin > '9')))
+      {
+        return false;
+      }
+    // the message is null-terminated, strtod stops at its end at the latest
+    char *numberEnd = nullptr;
+    value = std::strtod (begin, &numberEnd);
+    if (numberEnd == begin || !std::isfinite (value))
+      {
+        return false;
+      }
+    // strtod also accepts what JSON does not, e.g., -inf, nan or 0x1p3
+    for (const char *c = begin; c != numberEnd; c++)
+      {
+        if ((*c < '0' || *c > '9') && *c != '-' && *c != '+' && *c != '.' && *c != 'e' &&
+            *c != 'E')
+          {
+            return false;
+          }
+      }
+    m_p = numberEnd;
+    return !quoted || Consume ('"');
+  }
+
+  /**
+  * Skip a value of any type
+  * \param depth the nesting of the value
+  * \return true if a value was skipped
+  */
+  bool
+  SkipValue (unsigned depth)
+  {
+    SkipSpaces ();
+    if (m_p == m_end || depth > g_maxDepth)
+      {
+        return false;
+      }
+    const char *s;
+    size_t len;
+    switch (*m_p)
+      {
+      case '"':
+        return ParseString (s, len);
+      case '{':
+        m_p++;
+        if (Consume ('}'))
+          {
+            return true;
+          }
+        do
+          {
+            if (!ParseString (s, len) || !Consume (':') || !SkipValue (depth + 1))
+              {
+                return false;
+              }
+          }
+        while (Consume (','));
+        return Consume ('}');
+      case '[':
+        m_p++;
+        if (Consume (']'))
+          {
+            return true;
+          }
+        do
+          {
+            if (!SkipValue (depth + 1))
+              {
+                return false;
+              }
+          }
+        while (Consume (','));
+        return Consume (']');
+      default:
+        // numbers and literals
+        s = m_p;
+        while (m_p != m_end && *m_p != ',' && *m_p != '}' && *m_p != ']' && *m_p != ' ' &&
+               *m_p != '\t' && *m_p != '\n' && *m_p != '\r')
+          {
+            m_p++;
+          }
+        return m_p != s;
+      }
+  }
+
+  /**
+  * Parse the object of a command
+  * \param command the command
+  * \param named set to true if the object has a "cmd"
+  * \param batch the vector the commands of "cmds" are appended to, nullptr
+  *        if the object is already in a batch
+  * \param hasBatch set to true if the object has a "cmds"
+  * \return the status
+  */
+  RicControlCommandDecoder::Status
+  ParseCommand (RicControlCommand &command, bool &named, std::vector<RicControlCommand> *batch,
+                bool &hasBatch)
+  {
+    if (!Consume ('{'))
+      {
+        return RicControlCommandDecoder::SYNTAX_ERROR;
+      }
+    if (Consume ('}'))
+      {
+        return RicControlCommandDecoder::OK;
+      }
+    do
+      {
+        const char *key;
+        size_t keyLen;
+        if (!ParseString (key, keyLen) || !Consume (':'))
+          {
+            return RicControlCommandDecoder::SYNTAX_ERROR;
+          }
+        int id = Lookup (g_keys, g_keyMult, key, keyLen);
+        if (id == KEY_CMD)
+          {
+            const char *name;
+            size_t nameLen;
+            if (!ParseString (name, nameLen))
+              {
+                return RicControlCommandDecoder::SYNTAX_ERROR;
+              }
+            if (!RicControlCommandDecoder::LookupCommand (name, nameLen, command.m_type))
+              {
+                return RicControlCommandDecoder::UNKNOWN_COMMAND;
+              }
+            named = true;
+          }
+        else if (id == KEY_CMDS && batch)
+          {
+            RicControlCommandDecoder::Status status = ParseBatch (*batch);
+            if (status != RicControlCommandDecoder::OK)
+              {
+                return status;
+              }
+            hasBatch = true;
+          }
+        else if (id > KEY_CMDS)
+          {
+            double value;
+            if (!ParseNumber (value))
+              {
+                return RicControlCommandDecoder::SYNTAX_ERROR;
+              }
+            if (!SetField (command, static_cast<Key> (id), value))
+              {
+                return RicControlCommandDecoder::INVALID_VALUE;
+              }
+          }
+        else if (!SkipValue (0))
+          {
+            return RicControlCommandDecoder::SYNTAX_ERROR;
+          }
+      }
+    while (Consume (','));
+    return Consume ('}') ? RicControlCommandDecoder::OK : RicControlCommandDecoder::SYNTAX_ERROR;
+  }
+
+  /**
+  * Parse the array of a batch
+  * \param batch the vector the commands are appended to
+  * \return the status
+  */
+  RicControlCommandDecoder::Status
+  ParseBatch (std::vector<RicControlCommand> &batch)
+  {
+    if (!Consume ('['))
+      {
+        return RicControlCommandDecoder::SYNTAX_ERROR;
+      }
+    if (Consume (']'))
+      {
+        return RicControlCommandDecoder::OK;
+      }
+    do
+      {
+        RicControlCommand command;
+        bool named = false;
+        bool hasBatch = false;
+        RicControlCommandDecoder::Status status =
+            ParseCommand (command, named, nullptr, hasBatch);
+        if (status != RicControlCommandDecoder::OK)
+          {
+            return status;
+          }
+        if (!named)
+          {
+            return RicControlCommandDecoder::NO_COMMAND;
+          }
+        batch.push_back (command);
+      }
+    while (Consume (','));
+    return Consume (']') ? RicControlCommandDecoder::OK : RicControlCommandDecoder::SYNTAX_ERROR;
+  }
+
+  /**
+  * Set a field of a command
+  * \param command the command
+  * \param key the key of the field
+  * \param value the value
+  * \return false if the value is not valid for the field
+  */
+  static bool
+  SetField (RicControlCommand &command, Key key, double value)
+  {
+    uint32_t *id = nullptr;
+    switch (key)
+      {
+      case KEY_NODE:
+        id = &command.m_node;
+        break;
+      case KEY_UE_ID:
+        id = &command.m_ueId;
+        break;
+      case KEY_TARGET_CELL_ID:
+        id = &command.m_targetCellId;
+        break;
+      case KEY_APP:
+        id = &command.m_app;
+        break;
+      case KEY_SST:
+        id = &command.m_sst;
+        break;
+      case KEY_SD:
+        id = &command.m_sd;
+        break;
+      case KEY_PRIORITY:
+        id = &command.m_priority;
+        break;
+      case KEY_MCS:
+        command.m_mcs = value;
+        break;
+      case KEY_BANDWIDTH:
+        command.m_bandwidth = value;
+        break;
+      case KEY_RATE_MBPS:
+        command.m_rateMbps = value;
+        break;
+      case KEY_TX_POWER_DBM:
+        command.m_txPowerDbm = value;
+        break;
+      case KEY_PRB_MIN:
+        command.m_prbMin = value;
+        break;
+      case KEY_PRB_MAX:
+        command.m_prbMax = value;
+        break;
+      case KEY_ID:
+        // any integer a double represents exactly
+        if (!(value >= 0) || value > 9007199254740992.0 || value != static_cast<uint64_t> (value))
+          {
+            return false;
+          }
+        command.m_id = static_cast<uint64_t> (value);
+        break;
+      default:
+        return false;
+      }
+    if (id)
+      {
+        // identifiers are rounded to the closest integer
+        if (!(value >= 0) || value > std::numeric_limits<uint32_t>::max ())
+          {
+            return false;
+          }
+        *id = static_cast<uint32_t> (value + 0.5);
+      }
+    command.m_fields |= g_keyFields[key];
+    return true;
+  }
+
+  const char *m_p;   //!< the next character
+  const char *m_end; //!< the end of the message
+};
+
+} // namespace
+
+const char *
+RicControlCommand::GetName (Type type)
+{
+  return type < NUM_TYPES ? g_commandNames[type] : "";
+}
+
+RicControlCommandDecoder::Status
+RicControlCommandDecoder::Decode (const std::string &json, std::vector<RicControlCommand> &commands)
+{
+  commands.clear ();
+  Parser parser (json.c_str (), json.c_str () + json.size ());
+  Status status = parser.ParseMessage (commands);
+  for (auto it = commands.begin (); status == OK && it != commands.end (); ++it)
+    {
+      status = Validate (*it);
+    }
+  if (status != OK)
+    {
+      commands.clear ();
+    }
+  return status;
+}
+
+RicControlCommandDecoder::Status
+RicControlCommandDecoder::Validate (const RicControlCommand &command)
+{
+  uint16_t required = g_requiredFields[command.m_type];
+  if ((command.m_fields & required) != required)
+    {
+      return MISSING_FIELD;
+    }
+  switch (command.m_type)
+    {
+    case RicControlCommand::SET_MCS: {
+      int mcs = static_cast<int> (command.m_mcs);
+      if (!(command.m_mcs > -1) || mcs > 28)
+        {
+          return INVALID_VALUE;
+        }
+      break;
+    }
+    case RicControlCommand::SET_BANDWIDTH:
+      if (!(command.m_bandwidth >= 0) || command.m_bandwidth >= 256)
+        {
+          return INVALID_VALUE;
+        }
+      break;
+    case RicControlCommand::SET_FLOW_RATE:
+      if (!(command.m_rateMbps > 0))
+        {
+          return INVALID_VALUE;
+        }
+      break;
+    case RicControlCommand::SET_SLICE_QUOTA:
+      if (command.m_sst > 255 || command.m_sd > 0xFFFFFF || command.m_priority > 255 ||
+          !(command.m_prbMin >= 0) || !(command.m_prbMin <= command.m_prbMax) ||
+          command.m_prbMax > 100)
+        {
+          return INVALID_VALUE;
+        }
+      break;
+    case RicControlCommand::SET_UE_SLICE:
+      if (command.m_sst > 255 || command.m_sd > 0xFFFFFF)
+        {
+          return INVALID_VALUE;
+        }
+      break;
+    default:
+      break;
+    }
+  return OK;
+}
+
+const char *
+RicControlCommandDecoder::GetStatusString (Status status)
+{
+  switch (status)
+    {
+    case OK:
+      return "ok";
+    case SYNTAX_ERROR:
+      return "syntax error";
+    case NO_COMMAND:
+      return "no cmd";
+    case UNKNOWN_COMMAND:
+      return "unknown cmd";
+    case MISSING_FIELD:
+      return "missing field";
+    case INVALID_VALUE:
+      return "invalid value";
+    default:
+      return "unknown status";
+    }
+}
+
+bool
+RicControlCommandDecoder::LookupCommand (const char *name, size_t len, RicControlCommand::Type &type)
+{
+  int id = Lookup (g_commands, g_commandMult, name, len);
+  if (id < 0)
+    {
+      return false;
+    }
+  type = static_cast<RicControlCommand::Type> (id);
+  return true;
+}
+
+const char *
+RicControlResult::GetCodeString (Code code)
+{
+  switch (code)
+    {
+    case OK:
+      return "OK";
+    case BAD_REQUEST:
+      return "BAD_REQUEST";
+    case NOT_FOUND:
+      return "NOT_FOUND";
+    case INVALID_STATE:
+      return "INVALID_STATE";
+    case UNSUPPORTED:
+      return "UNSUPPORTED";
+    default:
+      return "UNKNOWN";
+    }
+}
+
+RicControlResult::Code
+RicControlResult::FromDecoderStatus (RicControlCommandDecoder::Status status)
+{
+  switch (status)
+    {
+    case RicControlCommandDecoder::OK:
+      return OK;
+    case RicControlCommandDecoder::UNKNOWN_COMMAND:
+      return UNSUPPORTED;
+    default:
+      return BAD_REQUEST;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RIC_CONTROL_COMMAND_H
+#define RIC_CONTROL_COMMAND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+* A command of the simple JSON control messages applied by
+* RicControlMessage::ApplySimpleCommand, e.g.,
+* {"cmd":"set-mcs","node":2,"mcs":10}
+*/
+struct RicControlCommand
+{
+  /// The command
+  enum Type : uint8_t
+  {
+    STOP,             ///< stop the simulation
+    HANDOVER_TRIGGER, ///< "node", "ueId", "targetCellId"
+    SET_MCS,          ///< "node", "mcs"
+    SET_BANDWIDTH,    ///< "bandwidth", optional "node"
+    SET_FLOW_RATE,    ///< "app", "rateMbps", optional "node"
+    SET_ENB_TXPOWER,  ///< "node", "txPowerDbm"
+    SET_SLICE_QUOTA,  ///< "node", "sST", "prbMin", "prbMax", optional "sD", "priority"
+    SET_UE_SLICE,     ///< "node", "ueId" (IMSI), "sST", optional "sD"
+    NUM_TYPES         ///< number of commands, not a command
+  };
+
+  /// The fields of the commands, as bits of m_fields
+  enum Field : uint16_t
+  {
+    NODE = 1 << 0,           ///< "node"
+    UE_ID = 1 << 1,          ///< "ueId"
+    TARGET_CELL_ID = 1 << 2, ///< "targetCellId"
+    MCS = 1 << 3,            ///< "mcs"
+    BANDWIDTH = 1 << 4,      ///< "bandwidth"
+    APP = 1 << 5,            ///< "app"
+    RATE_MBPS = 1 << 6,      ///< "rateMbps"
+    TX_POWER_DBM = 1 << 7,   ///< "txPowerDbm"
+    ID = 1 << 8,             ///< "id"
+    SST = 1 << 9,            ///< "sST"
+    SD = 1 << 10,            ///< "sD"
+    PRB_MIN = 1 << 11,       ///< "prbMin"
+    PRB_MAX = 1 << 12,       ///< "prbMax"
+    PRIORITY = 1 << 13,      ///< "priority"
+  };
+
+  Type m_type {STOP};          //!< the command
+  uint16_t m_fields {0};       //!< the fields present in the message
+  uint32_t m_node {0};         //!< the node id
+  uint32_t m_ueId {0};         //!< the UE (RNTI or IMSI)
+  uint32_t m_targetCellId {0}; //!< the target cell of the handover
+  uint32_t m_app {0};          //!< the index of the application on the node
+  double m_mcs {0};            //!< the MCS
+  double m_bandwidth {0};      //!< the bandwidth
+  double m_rateMbps {0};       //!< the rate of the flow, in Mbps
+  double m_txPowerDbm {0};     //!< the tx power, in dBm
+  uint32_t m_sst {0};          //!< the slice/service type of the S-NSSAI
+  uint32_t m_sd {0xFFFFFF};    //!< the slice differentiator of the S-NSSAI, 0xFFFFFF if none
+  double m_prbMin {0};         //!< the minimum PRB share of the slice, in percent
+  double m_prbMax {0};         //!< the maximum PRB share of the slice, in percent
+  uint32_t m_priority {0};     //!< the priority of the slice, lowest first
+  uint64_t m_id {0};           //!< the correlation id of the controller, reported back
+
+  /**
+  * \param field a field
+  * \return true if the field is present
+  */
+  bool Has (Field field) const
+  {
+    return (m_fields & field) != 0;
+  }
+
+  /**
+  * \param type a command
+  * \return the name of the command in the messages
+  */
+  static const char *GetName (Type type);
+};
+
+/**
+* Single pass decoder of the simple JSON control messages.
+*
+* A message is either a single command, {"cmd":"set-mcs","node":2,"mcs":10},
+* or a batch of commands, {"cmds":[{"cmd":...},{"cmd":...}]}, which are then
+* applied together. The message is tokenized once, left to right, without
+* copying the strings: each key is resolved with a perfect hash of its length
+* and last character, followed by a single comparison, and so are the names
+* of the commands. Unknown keys are skipped with their values. The decoded
+* commands are validated, a message with an invalid command being rejected
+* as a whole.
+*/
+class RicControlCommandDecoder
+{
+public:
+  /// The result of the decode of a message
+  enum Status : uint8_t
+  {
+    OK,              ///< the commands are valid
+    SYNTAX_ERROR,    ///< the message is not valid JSON
+    NO_COMMAND,      ///< the message has neither "cmd" nor "cmds"
+    UNKNOWN_COMMAND, ///< the name of a command is not known
+    MISSING_FIELD,   ///< a mandatory field of a command is missing
+    INVALID_VALUE,   ///< a field has a value out of range
+  };
+
+  /**
+  * Decode a message
+  * \param json the message
+  * \param commands the decoded commands; the vector is cleared first, its
+  *        capacity is kept, so that it does not need to grow again when reused
+  * \return the status, the commands being valid only if it is OK
+  */
+  static Status Decode (const std::string &json, std::vector<RicControlCommand> &commands);
+
+  /**
+  * \param status a status
+  * \return a description of the status
+  */
+  static const char *GetStatusString (Status status);
+
+  /**
+  * Check the mandatory fields and the ranges of the values of a command
+  * \param command the command
+  * \return OK, MISSING_FIELD or INVALID_VALUE
+  */
+  static Status Validate (const RicControlCommand &command);
+
+  /**
+  * Resolve the name of a command
+  * \param name the first character of the name
+  * \param len the length of the name
+  * \param type the command, set if found
+  * \return true if the name is the one of a command
+  */
+  static bool LookupCommand (const char *name, size_t len, RicControlCommand::Type &type);
+};
+
+/**
+* The result of a command, reported to the RIC with the codes of
+* RuntimeControlAPI.md
+*/
+struct RicControlResult
+{
+  /// The result
+  enum Code : uint8_t
+  {
+    OK,            ///< the command was applied
+    BAD_REQUEST,   ///< the message is not valid
+    NOT_FOUND,     ///< the node, device or application does not exist
+    INVALID_STATE, ///< the target cannot apply the command in its current state
+    UNSUPPORTED,   ///< the command is not implemented
+  };
+
+  Code m_code {OK};    //!< the result
+  std::string m_error; //!< the description of the error, empty if OK
+
+  /**
+  * \param code a result
+  * \return its name in the responses, e.g., "NOT_FOUND"
+  */
+  static const char *GetCodeString (Code code);
+
+  /**
+  * \param status the status of the decode of a message
+  * \return the code of the status, BAD_REQUEST or UNSUPPORTED
+  */
+  static Code FromDecoderStatus (RicControlCommandDecoder::Status status);
+};
+
+} // namespace ns3
+
+#endif /* RIC_CONTROL_COMMAND_H */
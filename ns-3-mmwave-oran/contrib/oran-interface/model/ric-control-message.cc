@@ -0,0 +1,703 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+ 
+#include "ric-control-message.h"
+#include <ns3/oran-interface.h>
+#include <ns3/asn1c-types.h>
+#include <ns3/log.h>
+#include <bitset>
+#include <iomanip>   // at top of file for std::setw, std::setfill, std::hex
+#include <sstream>
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/vector.h"
+
+// #include "control-gateway.h" // Might not be needed for V2 standalone
+#include <ns3/mmwave-enb-net-device.h>
+#include <ns3/mmwave-enb-mac.h>
+#include <ns3/mmwave-component-carrier-enb.h>
+#include <ns3/onoff-application.h>
+#include <ns3/data-rate.h>
+#include <ns3/mmwave-flex-tti-mac-scheduler.h>
+#include <ns3/lte-enb-rrc.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RicControlMessage");
+
+
+namespace {
+
+/**
+* \param code the result
+* \param error the description of the error
+* \return the result, after logging it
+*/
+RicControlResult
+Fail (RicControlResult::Code code, const std::string &error)
+{
+  NS_LOG_WARN (error);
+  return {code, error};
+}
+
+/**
+* Find the mmWave eNB device of a node
+* \param nodeId the id of the node
+* \return the device, nullptr if the node does not exist or has none
+*/
+Ptr<mmwave::MmWaveEnbNetDevice>
+FindMmWaveEnbNetDevice (uint32_t nodeId)
+{
+  if (nodeId >= NodeList::GetNNodes ())
+    {
+      return nullptr;
+    }
+  Ptr<Node> node = NodeList::GetNode (nodeId);
+  for (uint32_t i = 0; i < node->GetNDevices (); ++i)
+    {
+      Ptr<mmwave::MmWaveEnbNetDevice> enbDev =
+          DynamicCast<mmwave::MmWaveEnbNetDevice> (node->GetDevice (i));
+      if (enbDev)
+        {
+          return enbDev;
+        }
+    }
+  return nullptr;
+}
+
+/**
+* Get the primary component carrier of an mmWave eNB device, i.e., the one
+* with id 0 or else the first one
+* \param enbDev the device
+* \return the component carrier, nullptr if there is none
+*/
+Ptr<mmwave::MmWaveComponentCarrierEnb>
+GetPrimaryComponentCarrier (Ptr<mmwave::MmWaveEnbNetDevice> enbDev)
+{
+  std::map<uint8_t, Ptr<mmwave::MmWaveComponentCarrier>> ccMap = enbDev->GetCcMap ();
+  if (ccMap.empty ())
+    {
+      return nullptr;
+    }
+  auto ccIt = ccMap.find (0);
+  if (ccIt == ccMap.end () || !ccIt->second)
+    {
+      ccIt = ccMap.begin ();
+    }
+  return DynamicCast<mmwave::MmWaveComponentCarrierEnb> (ccIt->second);
+}
+
+std::string
+NoEnbError (const char *cmd, uint32_t nodeId)
+{
+  return std::string (cmd) + ": node " + std::to_string (nodeId) + " has no MmWaveEnbNetDevice";
+}
+
+RicControlResult
+ApplyHandoverTrigger (const RicControlCommand &command)
+{
+  Ptr<mmwave::MmWaveEnbNetDevice> enbDev = FindMmWaveEnbNetDevice (command.m_node);
+  if (!enbDev)
+    {
+      return Fail (RicControlResult::NOT_FOUND, NoEnbError ("handover-trigger", command.m_node));
+    }
+  if (!enbDev->GetRrc ())
+    {
+      return Fail (RicControlResult::INVALID_STATE,
+                   "handover-trigger: node " + std::to_string (command.m_node) + " has no RRC");
+    }
+  // TODO: Implement public SendHandoverRequest in LteEnbRrc or expose it
+  // For now, we just log the action
+  NS_LOG_INFO ("handover-trigger: Triggering HO for UE " << command.m_ueId << " from gNB "
+                                                         << command.m_node << " to Cell "
+                                                         << command.m_targetCellId
+                                                         << " (Mock Action)");
+  return Fail (RicControlResult::UNSUPPORTED, "handover-trigger: not implemented, mock action");
+}
+
+RicControlResult
+ApplySetMcs (const RicControlCommand &command)
+{
+  Ptr<mmwave::MmWaveEnbNetDevice> enbDev = FindMmWaveEnbNetDevice (command.m_node);
+  if (!enbDev)
+    {
+      return Fail (RicControlResult::NOT_FOUND, NoEnbError ("set-mcs", command.m_node));
+    }
+  Ptr<mmwave::MmWaveComponentCarrierEnb> cc = GetPrimaryComponentCarrier (enbDev);
+  Ptr<mmwave::MmWaveFlexTtiMacSchedulerBase> flexSched =
+      cc ? DynamicCast<mmwave::MmWaveFlexTtiMacSchedulerBase> (cc->GetMacScheduler ()) : nullptr;
+  if (!flexSched)
+    {
+      return Fail (RicControlResult::UNSUPPORTED, "set-mcs: node " +
+                                                      std::to_string (command.m_node) +
+                                                      " has no FlexTti scheduler");
+    }
+  int mcs = static_cast<int> (command.m_mcs);
+  flexSched->SetAttribute ("FixedMcsDl", BooleanValue (true));
+  flexSched->SetAttribute ("McsDefaultDl", UintegerValue (mcs));
+  flexSched->SetAttribute ("FixedMcsUl", BooleanValue (true));
+  flexSched->SetAttribute ("McsDefaultUl", UintegerValue (mcs));
+  NS_LOG_INFO ("set-mcs: node " << command.m_node << " MCS set to " << mcs << " (DL and UL)");
+  return {};
+}
+
+RicControlResult
+ApplySetBandwidth (const RicControlCommand &command)
+{
+  // the node is optional, the first eNB is used if it is not given or has no eNB
+  Ptr<mmwave::MmWaveEnbNetDevice> enbDev;
+  uint32_t nodeId = 0;
+  if (command.Has (RicControlCommand::NODE) && command.m_node > 0)
+    {
+      nodeId = command.m_node;
+      enbDev = FindMmWaveEnbNetDevice (nodeId);
+    }
+  for (nodeId = enbDev ? nodeId : 0; !enbDev && nodeId < NodeList::GetNNodes (); ++nodeId)
+    {
+      enbDev = FindMmWaveEnbNetDevice (nodeId);
+      if (enbDev)
+        {
+          break;
+        }
+    }
+  if (!enbDev)
+    {
+      return Fail (RicControlResult::NOT_FOUND,
+                   "set-bandwidth: no MmWaveEnbNetDevice found in any node");
+    }
+  uint8_t bandwidth = static_cast<uint8_t> (command.m_bandwidth);
+  if (bandwidth == 0)
+    {
+      NS_LOG_WARN ("set-bandwidth: bandwidth is 0, this may be invalid");
+    }
+  enbDev->SetBandwidth (bandwidth);
+  NS_LOG_INFO ("set-bandwidth: node " << nodeId << " bandwidth set to " << +bandwidth
+                                      << " (confirmed " << +enbDev->GetBandwidth () << ")");
+  return {};
+}
+
+/**
+* Find the first OnOff application of a node
+* \param node the node
+* \param appIndex the index of the application, set if found
+* \return the application, nullptr if the node has none
+*/
+Ptr<OnOffApplication>
+FindOnOffApplication (Ptr<Node> node, uint32_t &appIndex)
+{
+  for (uint32_t i = 0; i < node->GetNApplications (); ++i)
+    {
+      Ptr<OnOffApplication> onoffApp = DynamicCast<OnOffApplication> (node->GetApplication (i));
+      if (onoffApp)
+        {
+          appIndex = i;
+          return onoffApp;
+        }
+    }
+  return nullptr;
+}
+
+RicControlResult
+ApplySetFlowRate (const RicControlCommand &command)
+{
+  // the application at the index on the node, else the first OnOff application
+  // of the node, else the first one of any node
+  Ptr<OnOffApplication> onoffApp;
+  uint32_t nodeId = command.m_node;
+  uint32_t appIndex = command.m_app;
+  bool hasNode = command.Has (RicControlCommand::NODE) && nodeId < NodeList::GetNNodes ();
+  if (hasNode)
+    {
+      Ptr<Node> node = NodeList::GetNode (nodeId);
+      if (appIndex < node->GetNApplications ())
+        {
+          onoffApp = DynamicCast<OnOffApplication> (node->GetApplication (appIndex));
+        }
+      if (!onoffApp)
+        {
+          onoffApp = FindOnOffApplication (node, appIndex);
+        }
+    }
+  for (uint32_t i = 0; !onoffApp && i < NodeList::GetNNodes (); ++i)
+    {
+      onoffApp = FindOnOffApplication (NodeList::GetNode (i), appIndex);
+      nodeId = i;
+    }
+  if (!onoffApp)
+    {
+      return Fail (RicControlResult::NOT_FOUND, "set-flow-rate: no OnOffApplication found in the " +
+                                                    std::to_string (NodeList::GetNNodes ()) +
+                                                    " nodes");
+    }
+  std::ostringstream rateStr;
+  rateStr << std::fixed << std::setprecision (2) << command.m_rateMbps << "Mbps";
+  onoffApp->SetAttribute ("DataRate", DataRateValue (DataRate (rateStr.str ())));
+  NS_LOG_INFO ("set-flow-rate: node " << nodeId << " app " << appIndex << " rate set to "
+                                      << rateStr.str ());
+  return {};
+}
+
+RicControlResult
+ApplySetEnbTxPower (const RicControlCommand &command)
+{
+  Ptr<mmwave::MmWaveEnbNetDevice> enbDev = FindMmWaveEnbNetDevice (command.m_node);
+  if (!enbDev)
+    {
+      return Fail (RicControlResult::NOT_FOUND, NoEnbError ("set-enb-txpower", command.m_node));
+    }
+  Ptr<mmwave::MmWaveComponentCarrierEnb> cc = GetPrimaryComponentCarrier (enbDev);
+  Ptr<mmwave::MmWaveEnbPhy> phy = cc ? cc->GetPhy () : nullptr;
+  if (!phy)
+    {
+      return Fail (RicControlResult::INVALID_STATE, "set-enb-txpower: node " +
+                                                        std::to_string (command.m_node) +
+                                                        " has no PHY");
+    }
+  phy->SetAttribute ("TxPower", DoubleValue (command.m_txPowerDbm));
+  NS_LOG_INFO ("set-enb-txpower: node " << command.m_node << " TxPower set to "
+                                        << command.m_txPowerDbm << " dBm");
+  return {};
+}
+
+/**
+* Get the FlexTTI scheduler of the primary component carrier of a node
+* \param nodeId the id of the node
+* \param cmd the name of the command, for the errors
+* \param [out] result the error, if the scheduler is not found
+* \return the scheduler, nullptr if it is not found
+*/
+Ptr<mmwave::MmWaveFlexTtiMacSchedulerBase>
+FindFlexTtiScheduler (uint32_t nodeId, const char *cmd, RicControlResult &result)
+{
+  Ptr<mmwave::MmWaveEnbNetDevice> enbDev = FindMmWaveEnbNetDevice (nodeId);
+  if (!enbDev)
+    {
+      result = Fail (RicControlResult::NOT_FOUND, NoEnbError (cmd, nodeId));
+      return nullptr;
+    }
+  Ptr<mmwave::MmWaveComponentCarrierEnb> cc = GetPrimaryComponentCarrier (enbDev);
+  Ptr<mmwave::MmWaveFlexTtiMacSchedulerBase> flexSched =
+      cc ? DynamicCast<mmwave::MmWaveFlexTtiMacSchedulerBase> (cc->GetMacScheduler ()) : nullptr;
+  if (!flexSched)
+    {
+      result = Fail (RicControlResult::UNSUPPORTED, std::string (cmd) + ": node " +
+                                                        std::to_string (nodeId) +
+                                                        " has no FlexTti scheduler");
+    }
+  return flexSched;
+}
+
+RicControlResult
+ApplySetSliceQuota (const RicControlCommand &command)
+{
+  RicControlResult result;
+  Ptr<mmwave::MmWaveFlexTtiMacSchedulerBase> flexSched =
+      FindFlexTtiScheduler (command.m_node, "set-slice-quota", result);
+  if (!flexSched)
+    {
+      return result;
+    }
+  mmwave::MmWaveFlexTtiMacSchedulerBase::SliceQuota quota;
+  quota.m_minShare = command.m_prbMin / 100;
+  quota.m_maxShare = command.m_prbMax / 100;
+  quota.m_priority = static_cast<uint8_t> (command.m_priority);
+  uint32_t sNssai = mmwave::MmWaveFlexTtiMacSchedulerBase::MakeSNssai (
+      static_cast<uint8_t> (command.m_sst), command.m_sd);
+  flexSched->SetSliceQuota (sNssai, quota);
+  NS_LOG_INFO ("set-slice-quota: node " << command.m_node << " slice " << command.m_sst << "/"
+                                        << command.m_sd << " PRB share [" << command.m_prbMin
+                                        << ", " << command.m_prbMax << "]%, priority "
+                                        << command.m_priority);
+  return result;
+}
+
+RicControlResult
+ApplySetUeSlice (const RicControlCommand &command)
+{
+  RicControlResult result;
+  Ptr<mmwave::MmWaveFlexTtiMacSchedulerBase> flexSched =
+      FindFlexTtiScheduler (command.m_node, "set-ue-slice", result);
+  if (!flexSched)
+    {
+      return result;
+    }
+  // the UEs are identified by IMSI, as in the KPM reports
+  Ptr<LteEnbRrc> rrc = FindMmWaveEnbNetDevice (command.m_node)->GetRrc ();
+  if (rrc)
+    {
+      for (const auto &ue : rrc->GetUeMap ())
+        {
+          if (ue.second->GetImsi () == command.m_ueId)
+            {
+              flexSched->SetUeSlice (ue.first, mmwave::MmWaveFlexTtiMacSchedulerBase::MakeSNssai (
+                                                   static_cast<uint8_t> (command.m_sst),
+                                                   command.m_sd));
+              NS_LOG_INFO ("set-ue-slice: node " << command.m_node << " UE " << command.m_ueId
+                                                 << " (RNTI " << ue.first << ") moved to slice "
+                                                 << command.m_sst << "/" << command.m_sd);
+              return result;
+            }
+        }
+    }
+  return Fail (RicControlResult::NOT_FOUND, "set-ue-slice: node " +
+                                                std::to_string (command.m_node) +
+                                                " serves no UE with IMSI " +
+                                                std::to_string (command.m_ueId));
+}
+
+/**
+* Append a result to a JSON object, without the braces
+* \param json the object
+* \param result the result
+*/
+void
+AppendResult (std::ostringstream &json, const RicControlResult &result)
+{
+  json << "\"ok\":" << (result.m_code == RicControlResult::OK ? "true" : "false");
+  if (result.m_code != RicControlResult::OK)
+    {
+      json << ",\"code\":\"" << RicControlResult::GetCodeString (result.m_code)
+           << "\",\"error\":\"";
+      for (char c : result.m_error)
+        {
+          if (c == '"' || c == '\\')
+            {
+              json << '\\';
+            }
+          json << c;
+        }
+      json << '"';
+    }
+}
+
+/**
+* \param code the result of a request
+* \return the CauseRIC of the RIC Control Failure
+*/
+long
+GetCause (RicControlResult::Code code)
+{
+  switch (code)
+    {
+    case RicControlResult::BAD_REQUEST:
+      return CauseRIC_control_message_invalid;
+    case RicControlResult::UNSUPPORTED:
+      return CauseRIC_action_not_supported;
+    default:
+      return CauseRIC_unspecified;
+    }
+}
+
+} // namespace
+
+void
+RicControlResponder::Send (const std::vector<RicControlCommand> &commands,
+                           const std::vector<RicControlResult> &results) const
+{
+  if (!m_e2term)
+    {
+      return;
+    }
+  // the request fails with its first failed command
+  RicControlResult request;
+  for (const RicControlResult &result : results)
+    {
+      if (result.m_code != RicControlResult::OK)
+        {
+          request = result;
+          break;
+        }
+    }
+  std::ostringstream json;
+  json << '{';
+  AppendResult (json, request);
+  json << ",\"time\":" << Simulator::Now ().GetSeconds () << ",\"results\":[";
+  for (size_t i = 0; i < commands.size () && i < results.size (); ++i)
+    {
+      json << (i > 0 ? ",{" : "{");
+      if (commands[i].Has (RicControlCommand::ID))
+        {
+          json << "\"id\":" << commands[i].m_id << ',';
+        }
+      json << "\"cmd\":\"" << RicControlCommand::GetName (commands[i].m_type) << "\",";
+      AppendResult (json, results[i]);
+      json << '}';
+    }
+  json << "]}";
+  m_e2term->SendRicControlResponse (m_requestId, m_ranFunctionId,
+                                    request.m_code == RicControlResult::OK,
+                                    GetCause (request.m_code), json.str ());
+}
+
+void
+RicControlResponder::Send (const RicControlResult &result) const
+{
+  if (!m_e2term)
+    {
+      return;
+    }
+  std::ostringstream json;
+  json << '{';
+  AppendResult (json, result);
+  json << ",\"time\":" << Simulator::Now ().GetSeconds () << '}';
+  m_e2term->SendRicControlResponse (m_requestId, m_ranFunctionId,
+                                    result.m_code == RicControlResult::OK,
+                                    GetCause (result.m_code), json.str ());
+}
+
+void
+RicControlResponder::ScheduleSend (uint32_t context, const RicControlResult &result) const
+{
+  if (m_e2term)
+    {
+      RicControlResponder responder = *this;
+      Simulator::ScheduleWithContext (context, Seconds (0),
+                                      [responder, result] () { responder.Send (result); });
+    }
+}
+
+void
+RicControlMessage::ApplySimpleCommand (const std::string &json,
+                                       const RicControlResponder &responder)
+{
+  NS_LOG_FUNCTION (json);
+
+  // the decode runs on the thread of the E2 termination, and the buffer of
+  // the thread is reused by the following messages
+  static thread_local std::vector<RicControlCommand> commands;
+  RicControlCommandDecoder::Status status = RicControlCommandDecoder::Decode (json, commands);
+  if (status != RicControlCommandDecoder::OK)
+    {
+      RicControlResult result = Fail (RicControlResult::FromDecoderStatus (status),
+                                      std::string ("control command rejected, ") +
+                                          RicControlCommandDecoder::GetStatusString (status));
+      NS_LOG_WARN ("Rejected control message: " << json);
+      responder.ScheduleSend (Simulator::NO_CONTEXT, result);
+      return;
+    }
+
+  // all the commands of the message are applied by the same event, the
+  // scheduling being the one the simulator supports from other threads
+  Simulator::ScheduleWithContext (Simulator::NO_CONTEXT, Seconds (0),
+                                  [batch = commands, responder] () {
+                                    ApplyCommands (batch, responder);
+                                  });
+}
+
+void
+RicControlMessage::ApplyCommands (const std::vector<RicControlCommand> &commands,
+                                  const RicControlResponder &responder)
+{
+  std::vector<RicControlResult> results;
+  results.reserve (commands.size ());
+  for (const RicControlCommand &command : commands)
+    {
+      NS_LOG_LOGIC ("Applying " << RicControlCommand::GetName (command.m_type));
+      switch (command.m_type)
+        {
+        case RicControlCommand::STOP:
+          NS_LOG_INFO ("stop: Stopping simulator now");
+          Simulator::Stop ();
+          results.emplace_back ();
+          break;
+        case RicControlCommand::HANDOVER_TRIGGER:
+          results.push_back (ApplyHandoverTrigger (command));
+          break;
+        case RicControlCommand::SET_MCS:
+          results.push_back (ApplySetMcs (command));
+          break;
+        case RicControlCommand::SET_BANDWIDTH:
+          results.push_back (ApplySetBandwidth (command));
+          break;
+        case RicControlCommand::SET_FLOW_RATE:
+          results.push_back (ApplySetFlowRate (command));
+          break;
+        case RicControlCommand::SET_ENB_TXPOWER:
+          results.push_back (ApplySetEnbTxPower (command));
+          break;
+        case RicControlCommand::SET_SLICE_QUOTA:
+          results.push_back (ApplySetSliceQuota (command));
+          break;
+        case RicControlCommand::SET_UE_SLICE:
+          results.push_back (ApplySetUeSlice (command));
+          break;
+        default:
+          results.push_back (Fail (RicControlResult::UNSUPPORTED, "unknown command"));
+          break;
+        }
+    }
+  responder.Send (commands, results);
+}
+
+
+RicControlMessage::RicControlMessage (E2AP_PDU_t* pdu, E2Termination *e2term)
+{
+  m_responder.m_e2term = e2term;
+  DecodeRicControlMessage (pdu);
+  NS_LOG_INFO ("End of RicControlMessage::RicControlMessage()");
+}
+
+RicControlMessage::~RicControlMessage ()
+{
+
+}
+
+void
+RicControlMessage::DecodeRicControlMessage(E2AP_PDU_t* pdu)
+{
+    if (!pdu) {
+        NS_LOG_ERROR("pdu is null");
+        return;
+    }
+    if (pdu->present != E2AP_PDU_PR_initiatingMessage) {
+        NS_LOG_ERROR("PDU is not InitiatingMessage");
+        return;
+    }
+
+    InitiatingMessage_t* mess = pdu->choice.initiatingMessage;
+    if (mess->value.present != InitiatingMessage__value_PR_RICcontrolRequest) {
+        NS_LOG_ERROR("InitiatingMessage is not RICcontrolRequest");
+        return;
+    }
+
+    auto* request = (RICcontrolRequest_t*)&mess->value.choice.RICcontrolRequest;
+    // the request is dumped only when debugging, as this is done for every message
+    const bool dump = g_log.IsEnabled(LOG_DEBUG);
+    if (dump) {
+        xer_fprint(stderr, &asn_DEF_RICcontrolRequest, request);
+    }
+
+    const size_t ieCount = request->protocolIEs.list.count;
+    NS_LOG_DEBUG("IE count = " << ieCount);
+    if (ieCount == 0) {
+        NS_LOG_ERROR("RICcontrolRequest has no IEs");
+        return;
+    }
+
+    const uint8_t* rawCtrlMsgBuf = nullptr;
+    size_t rawCtrlMsgLen = 0;
+
+    for (size_t i = 0; i < ieCount; ++i) {
+        RICcontrolRequest_IEs_t* ie = request->protocolIEs.list.array[i];
+        switch (ie->value.present) {
+        case RICcontrolRequest_IEs__value_PR_RICrequestID:
+            m_ricRequestId = ie->value.choice.RICrequestID;
+            NS_LOG_DEBUG("RICrequestID: requestor=" << m_ricRequestId.ricRequestorID
+                         << " instance=" << m_ricRequestId.ricInstanceID);
+            break;
+
+        case RICcontrolRequest_IEs__value_PR_RANfunctionID:
+            m_ranFunctionId = ie->value.choice.RANfunctionID;
+            NS_LOG_DEBUG("RANfunctionID=" << m_ranFunctionId);
+            break;
+
+        case RICcontrolRequest_IEs__value_PR_RICcontrolMessage:
+            rawCtrlMsgBuf = ie->value.choice.RICcontrolMessage.buf;
+            rawCtrlMsgLen = ie->value.choice.RICcontrolMessage.size;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // RAW dump of the control message payload
+    std::string ascii;
+    if (rawCtrlMsgBuf && rawCtrlMsgLen > 0) {
+        // Remove null terminator if present (the xApp sends null-terminated strings)
+        size_t actualLen = rawCtrlMsgLen;
+        if (rawCtrlMsgLen > 0 && rawCtrlMsgBuf[rawCtrlMsgLen - 1] == '\0') {
+            actualLen = rawCtrlMsgLen - 1;
+        }
+        
+        ascii.assign(reinterpret_cast<const char*>(rawCtrlMsgBuf), actualLen);
+        
+        // Trim any trailing whitespace or nulls
+        while (!ascii.empty() && (ascii.back() == '\0' || ascii.back() == ' ' || ascii.back() == '\n' || ascii.back() == '\r')) {
+            ascii.pop_back();
+        }
+        
+        if (dump) {
+            static const char* HEX = "0123456789abcdef";
+            std::string hex; hex.reserve(rawCtrlMsgLen * 2);
+            for (size_t i = 0; i < rawCtrlMsgLen; ++i) {
+                unsigned char c = rawCtrlMsgBuf[i];
+                hex.push_back(HEX[(c >> 4) & 0xF]);
+                hex.push_back(HEX[c & 0xF]);
+            }
+            NS_LOG_DEBUG("RAW RICcontrolMessage len=" << rawCtrlMsgLen << " (actual=" << ascii.size()
+                         << ") ascii='" << ascii << "' hex=" << hex);
+        }
+    } else {
+        NS_LOG_DEBUG("RAW RICcontrolMessage is empty or missing");
+    }
+
+    m_payload = ascii;
+    m_responder.m_requestId = m_ricRequestId;
+    m_responder.m_ranFunctionId = m_ranFunctionId;
+
+    // Proof-of-concept: interpret a tiny JSON with "cmd" and apply it. The
+    // control configurations with a "type" are applied by the E2 node.
+    if (!ascii.empty() && ascii.find("\"cmd\"") == std::string::npos) {
+        NS_LOG_DEBUG ("No cmd in the control message, not a simple command");
+    } else if (!ascii.empty()) {
+        m_simpleCommand = true;
+        ApplySimpleCommand(ascii, m_responder);
+    } else {
+        NS_LOG_ERROR("Control message payload is empty, cannot apply command");
+    }
+}
+
+
+
+
+std::string
+RicControlMessage::GetSecondaryCellIdHO ()
+{
+  return m_secondaryCellId;
+}
+
+std::vector<RANParameterItem>
+RicControlMessage::ExtractRANParametersFromControlMessage (
+    E2SM_RC_ControlMessage_Format1_t *e2SmRcControlMessageFormat1)
+{
+  std::vector<RANParameterItem> ranParameterList;
+  int count = e2SmRcControlMessageFormat1->ranParameters_List->list.count;
+  for (int i = 0; i < count; i++)
+    {
+      RANParameter_Item_t *ranParameterItem =
+          e2SmRcControlMessageFormat1->ranParameters_List->list.array[i];
+      for (RANParameterItem extractedParameter :
+           RANParameterItem::ExtractRANParametersFromRANParameter (ranParameterItem))
+        {
+          ranParameterList.push_back (extractedParameter);
+        }
+    }
+
+  return ranParameterList;
+}
+
+} // namespace ns3
@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+ 
+#ifndef RIC_CONTROL_MESSAGE_H
+#define RIC_CONTROL_MESSAGE_H
+
+#include "ns3/object.h"
+#include <ns3/asn1c-types.h>
+#include <ns3/ric-control-command.h>
+
+extern "C" {
+  #include "E2AP-PDU.h"
+  #include "E2SM-RC-ControlHeader.h"
+  #include "E2SM-RC-ControlMessage.h"
+  #include "E2SM-RC-ControlHeader-Format1.h"
+  #include "E2SM-RC-ControlMessage-Format1.h"
+  #include "RICcontrolRequest.h"
+  #include "ProtocolIE-Field.h"
+  #include "InitiatingMessage.h"
+  #include "CellGlobalID.h"
+  #include "NRCGI.h"
+ }
+
+namespace ns3 {
+
+  class E2Termination;
+
+  /**
+  * Sends the RIC Control Acknowledge or Failure of a control request once
+  * its commands are applied, with the results of the commands in the
+  * RICcontrolOutcome, e.g.,
+  * {"ok":false,"code":"NOT_FOUND","error":"...","time":1.2,
+  *  "results":[{"id":7,"cmd":"set-mcs","ok":true},{"cmd":"set-mcs","ok":false,...}]}
+  * Must be used in the simulator thread.
+  */
+  struct RicControlResponder
+  {
+    E2Termination *m_e2term {nullptr};  //!< the termination of the request, no response if null
+    RICrequestID_t m_requestId {0, 0};   //!< the id of the request
+    long m_ranFunctionId {0};            //!< the RAN function of the request
+
+    /**
+    * Respond to a request, which fails with its first failed command
+    * \param commands the commands of the request
+    * \param results the results of the commands
+    */
+    void Send (const std::vector<RicControlCommand> &commands,
+               const std::vector<RicControlResult> &results) const;
+
+    /**
+    * Respond to a request without commands, e.g., rejected by the decoder
+    * \param result the result of the request
+    */
+    void Send (const RicControlResult &result) const;
+
+    /**
+    * Schedule the response to a request without commands, now. Can be
+    * called from any thread.
+    * \param context the context of the event
+    * \param result the result of the request
+    */
+    void ScheduleSend (uint32_t context, const RicControlResult &result) const;
+  };
+
+  class RicControlMessage : public SimpleRefCount<RicControlMessage>
+  {
+  public:
+    enum ControlMessageRequestIdType { TS = 1001, QoS = 1002
+    };
+
+    /**
+    * Decode a simple JSON command, or a batch of commands, and schedule it
+    * now. Can be called from any thread; a message with an invalid command
+    * is dropped as a whole.
+    *
+    * \param json the message, see RicControlCommandDecoder
+    * \param responder the response to the request, sent once applied
+    */
+    static void ApplySimpleCommand(const std::string& json,
+                                   const RicControlResponder &responder = RicControlResponder ());
+
+    /**
+    * Apply decoded commands, in order, in the simulator thread
+    *
+    * \param commands the commands
+    * \param responder the response to the request, sent once applied
+    */
+    static void ApplyCommands (const std::vector<RicControlCommand> &commands,
+                               const RicControlResponder &responder = RicControlResponder ());
+
+    /**
+    * \param pdu the RIC Control Request
+    * \param e2term the termination that received it, to respond to the
+    *        simple commands once applied
+    */
+    RicControlMessage(E2AP_PDU_t* pdu, E2Termination *e2term = nullptr);
+    ~RicControlMessage ();
+
+    ControlMessageRequestIdType m_requestType;
+    
+    static std::vector<RANParameterItem> ExtractRANParametersFromControlMessage (
+      E2SM_RC_ControlMessage_Format1_t *e2SmRcControlMessageFormat1);
+    
+    std::vector<RANParameterItem> m_valuesExtracted;
+    RANfunctionID_t m_ranFunctionId {0};
+    RICrequestID_t m_ricRequestId {0, 0};
+    RICcallProcessID_t m_ricCallProcessId;
+    E2SM_RC_ControlHeader_Format1_t *m_e2SmRcControlHeaderFormat1{nullptr};
+    std::string m_payload; //!< the RICcontrolMessage, trimmed, e.g., a JSON control configuration
+    bool m_simpleCommand {false}; //!< true if the payload is a simple command, already scheduled
+    RicControlResponder m_responder; //!< the response to the request
+    std::string GetSecondaryCellIdHO ();
+
+  private:
+    /**
+    * Decodes the RIC Control message .
+    *
+    * \param pdu PDU passed by the RIC
+    */
+    void DecodeRicControlMessage (E2AP_PDU_t *pdu);
+    std::string m_secondaryCellId;
+  };
+}
+
+#endif /* RIC_CONTROL_MESSAGE_V2_H */
@@ -0,0 +1,456 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/ric-control-command.h"
+#include "ns3/test.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \file ric-control-command-test-suite.cc
+ * \ingroup test
+ *
+ * \brief Checks the decode of the simple JSON control messages by
+ * RicControlCommandDecoder: the tokenizer, the lookup of the keys and of the
+ * commands, the mandatory fields, the batches and the statuses of the
+ * invalid messages.
+ */
+
+/// A message and the status of its decode
+struct DecodeCase
+{
+  const char *json;                        //!< the message
+  RicControlCommandDecoder::Status status; //!< the expected status
+};
+
+/**
+ * Check the tokenizer on valid messages written in different ways
+ */
+class RicControlCommandTokenizerTestCase : public TestCase
+{
+public:
+  RicControlCommandTokenizerTestCase ()
+    : TestCase ("Tokenizer of the control messages")
+  {
+  }
+
+private:
+  void DoRun () override;
+};
+
+void
+RicControlCommandTokenizerTestCase::DoRun ()
+{
+  // the same command, with spaces, quoted numbers, keys in any order and
+  // unknown keys of any type
+  const char *messages[] = {
+      "{\"cmd\":\"set-mcs\",\"node\":2,\"mcs\":10}",
+      " \r\n{ \"cmd\" :\t\"set-mcs\" , \"node\" : 2 , \"mcs\" : 10 }\n ",
+      "{\"mcs\":\"10\",\"node\":\"2\",\"cmd\":\"set-mcs\"}",
+      "{\"node\":2.0,\"mcs\":1e1,\"cmd\":\"set-mcs\"}",
+      "{\"cmd\":\"set-mcs\",\"comment\":\"a \\\"quoted\\\" }\",\"node\":2,\"mcs\":10}",
+      "{\"cmd\":\"set-mcs\",\"extra\":{\"a\":[1,{\"b\":null},\"]\"],\"c\":{}},"
+      "\"node\":2,\"mcs\":10}",
+      "{\"cmd\":\"set-mcs\",\"flag\":true,\"none\":null,\"list\":[],\"node\":2,\"mcs\":10}",
+  };
+  for (const char *json : messages)
+    {
+      std::vector<RicControlCommand> commands;
+      RicControlCommandDecoder::Status status = RicControlCommandDecoder::Decode (json, commands);
+      NS_TEST_ASSERT_MSG_EQ (status, RicControlCommandDecoder::OK, json);
+      NS_TEST_ASSERT_MSG_EQ (commands.size (), 1, json);
+      NS_TEST_EXPECT_MSG_EQ (commands[0].m_type, RicControlCommand::SET_MCS, json);
+      NS_TEST_EXPECT_MSG_EQ (commands[0].m_node, 2, json);
+      NS_TEST_EXPECT_MSG_EQ_TOL (commands[0].m_mcs, 10, 1e-9, json);
+      NS_TEST_EXPECT_MSG_EQ (commands[0].m_fields,
+                             (RicControlCommand::NODE | RicControlCommand::MCS), json);
+    }
+
+  // identifiers are rounded, the other values are kept as they are
+  std::vector<RicControlCommand> commands;
+  RicControlCommandDecoder::Decode (
+      "{\"cmd\":\"set-enb-txpower\",\"node\":6.6,\"txPowerDbm\":-12.25}", commands);
+  NS_TEST_ASSERT_MSG_EQ (commands.size (), 1, "set-enb-txpower not decoded");
+  NS_TEST_EXPECT_MSG_EQ (commands[0].m_node, 7, "Identifier not rounded");
+  NS_TEST_EXPECT_MSG_EQ_TOL (commands[0].m_txPowerDbm, -12.25, 1e-9, "Wrong tx power");
+}
+
+/**
+ * Check the perfect hash lookups of the commands and of the keys
+ */
+class RicControlCommandLookupTestCase : public TestCase
+{
+public:
+  RicControlCommandLookupTestCase ()
+    : TestCase ("Lookup of the commands and of the keys")
+  {
+  }
+
+private:
+  void DoRun () override;
+};
+
+void
+RicControlCommandLookupTestCase::DoRun ()
+{
+  for (uint8_t t = 0; t < RicControlCommand::NUM_TYPES; t++)
+    {
+      RicControlCommand::Type type = static_cast<RicControlCommand::Type> (t);
+      const char *name = RicControlCommand::GetName (type);
+      RicControlCommand::Type found = RicControlCommand::NUM_TYPES;
+      NS_TEST_EXPECT_MSG_EQ (
+          RicControlCommandDecoder::LookupCommand (name, std::strlen (name), found), true, name);
+      NS_TEST_EXPECT_MSG_EQ (found, type, name);
+    }
+
+  // names hashing to the slot of a command: same length and last character
+  const char *unknown[] = {"", "sto", "stops", "stoP", "xtop", "set-mcz", "sel-mcs",
+                           "set-bandwidtH", "handover-triggeR", "set-ue-slicf"};
+  for (const char *name : unknown)
+    {
+      RicControlCommand::Type found = RicControlCommand::NUM_TYPES;
+      NS_TEST_EXPECT_MSG_EQ (
+          RicControlCommandDecoder::LookupCommand (name, std::strlen (name), found), false, name);
+      NS_TEST_EXPECT_MSG_EQ (found, RicControlCommand::NUM_TYPES, name);
+    }
+  NS_TEST_EXPECT_MSG_EQ (std::string (RicControlCommand::GetName (RicControlCommand::NUM_TYPES)),
+                         "", "Name of a command that does not exist");
+
+  // each key sets its own field
+  std::vector<RicControlCommand> commands;
+  RicControlCommandDecoder::Status status = RicControlCommandDecoder::Decode (
+      "{\"cmd\":\"stop\",\"node\":1,\"ueId\":2,\"targetCellId\":3,\"mcs\":4,\"bandwidth\":5,"
+      "\"app\":6,\"rateMbps\":7,\"txPowerDbm\":8,\"id\":9,\"sST\":10,\"sD\":11,\"prbMin\":12,"
+      "\"prbMax\":13,\"priority\":14}",
+      commands);
+  NS_TEST_ASSERT_MSG_EQ (status, RicControlCommandDecoder::OK, "All the keys not decoded");
+  NS_TEST_ASSERT_MSG_EQ (commands.size (), 1, "All the keys not decoded");
+  const RicControlCommand &c = commands[0];
+  NS_TEST_EXPECT_MSG_EQ (c.m_fields, (1 << 14) - 1, "Missing fields");
+  NS_TEST_EXPECT_MSG_EQ (c.m_node, 1, "node");
+  NS_TEST_EXPECT_MSG_EQ (c.m_ueId, 2, "ueId");
+  NS_TEST_EXPECT_MSG_EQ (c.m_targetCellId, 3, "targetCellId");
+  NS_TEST_EXPECT_MSG_EQ_TOL (c.m_mcs, 4, 1e-9, "mcs");
+  NS_TEST_EXPECT_MSG_EQ_TOL (c.m_bandwidth, 5, 1e-9, "bandwidth");
+  NS_TEST_EXPECT_MSG_EQ (c.m_app, 6, "app");
+  NS_TEST_EXPECT_MSG_EQ_TOL (c.m_rateMbps, 7, 1e-9, "rateMbps");
+  NS_TEST_EXPECT_MSG_EQ_TOL (c.m_txPowerDbm, 8, 1e-9, "txPowerDbm");
+  NS_TEST_EXPECT_MSG_EQ (c.m_id, 9, "id");
+  NS_TEST_EXPECT_MSG_EQ (c.m_sst, 10, "sST");
+  NS_TEST_EXPECT_MSG_EQ (c.m_sd, 11, "sD");
+  NS_TEST_EXPECT_MSG_EQ_TOL (c.m_prbMin, 12, 1e-9, "prbMin");
+  NS_TEST_EXPECT_MSG_EQ_TOL (c.m_prbMax, 13, 1e-9, "prbMax");
+  NS_TEST_EXPECT_MSG_EQ (c.m_priority, 14, "priority");
+
+  // keys are case sensitive, unknown ones are skipped
+  RicControlCommandDecoder::Decode ("{\"cmd\":\"stop\",\"Node\":1,\"nodes\":2,\"sd\":3}",
+                                    commands);
+  NS_TEST_ASSERT_MSG_EQ (commands.size (), 1, "Unknown keys not skipped");
+  NS_TEST_EXPECT_MSG_EQ (commands[0].m_fields, 0, "Unknown keys decoded");
+}
+
+/**
+ * Check that each mandatory field of each command is required
+ */
+class RicControlCommandRequiredFieldsTestCase : public TestCase
+{
+public:
+  RicControlCommandRequiredFieldsTestCase ()
+    : TestCase ("Mandatory fields of the commands")
+  {
+  }
+
+private:
+  void DoRun () override;
+};
+
+void
+RicControlCommandRequiredFieldsTestCase::DoRun ()
+{
+  /// A valid command and its mandatory fields
+  struct Command
+  {
+    const char *name;                  //!< the name of the command
+    std::vector<std::string> required; //!< the mandatory fields
+    std::vector<std::string> optional; //!< the optional fields
+  };
+  const std::vector<Command> commands = {
+      {"stop", {}, {}},
+      {"handover-trigger", {"\"node\":1", "\"ueId\":2", "\"targetCellId\":3"}, {}},
+      {"set-mcs", {"\"node\":1", "\"mcs\":28"}, {}},
+      {"set-bandwidth", {"\"bandwidth\":100"}, {"\"node\":1"}},
+      {"set-flow-rate", {"\"app\":0", "\"rateMbps\":2.5"}, {"\"node\":1"}},
+      {"set-enb-txpower", {"\"node\":1", "\"txPowerDbm\":30"}, {}},
+      {"set-slice-quota",
+       {"\"node\":1", "\"sST\":1", "\"prbMin\":10", "\"prbMax\":60"},
+       {"\"sD\":1", "\"priority\":2"}},
+      {"set-ue-slice", {"\"node\":1", "\"ueId\":5", "\"sST\":2"}, {"\"sD\":16777215"}},
+  };
+  NS_TEST_ASSERT_MSG_EQ (commands.size (), RicControlCommand::NUM_TYPES, "Commands not tested");
+
+  for (const Command &command : commands)
+    {
+      std::vector<RicControlCommand> decoded;
+      for (size_t missing = 0; missing <= command.required.size (); missing++)
+        {
+          std::string json = std::string ("{\"cmd\":\"") + command.name + "\"";
+          for (size_t i = 0; i < command.required.size (); i++)
+            {
+              if (i != missing)
+                {
+                  json += "," + command.required[i];
+                }
+            }
+          RicControlCommandDecoder::Status status =
+              RicControlCommandDecoder::Decode (json + "}", decoded);
+          bool complete = missing == command.required.size ();
+          NS_TEST_EXPECT_MSG_EQ (status,
+                                 (complete ? RicControlCommandDecoder::OK
+                                           : RicControlCommandDecoder::MISSING_FIELD),
+                                 json);
+          NS_TEST_EXPECT_MSG_EQ (decoded.empty (), !complete, json);
+
+          if (complete)
+            {
+              for (const std::string &field : command.optional)
+                {
+                  json += "," + field;
+                }
+              status = RicControlCommandDecoder::Decode (json + "}", decoded);
+              NS_TEST_EXPECT_MSG_EQ (status, RicControlCommandDecoder::OK, json);
+            }
+        }
+    }
+
+  // the slice differentiator defaults to none
+  std::vector<RicControlCommand> decoded;
+  RicControlCommandDecoder::Decode ("{\"cmd\":\"set-ue-slice\",\"node\":1,\"ueId\":5,\"sST\":2}",
+                                    decoded);
+  NS_TEST_ASSERT_MSG_EQ (decoded.size (), 1, "set-ue-slice not decoded");
+  NS_TEST_EXPECT_MSG_EQ (decoded[0].Has (RicControlCommand::SD), false, "sD set");
+  NS_TEST_EXPECT_MSG_EQ (decoded[0].m_sd, 0xFFFFFF, "Wrong default sD");
+}
+
+/**
+ * Check the decode of the batches of commands
+ */
+class RicControlCommandBatchTestCase : public TestCase
+{
+public:
+  RicControlCommandBatchTestCase ()
+    : TestCase ("Batches of commands")
+  {
+  }
+
+private:
+  void DoRun () override;
+};
+
+void
+RicControlCommandBatchTestCase::DoRun ()
+{
+  std::vector<RicControlCommand> commands;
+  RicControlCommandDecoder::Status status = RicControlCommandDecoder::Decode (
+      "{\"cmds\":[{\"cmd\":\"set-mcs\",\"node\":1,\"mcs\":3},"
+      "{\"cmd\":\"set-enb-txpower\",\"node\":2,\"txPowerDbm\":20},"
+      "{\"cmd\":\"set-mcs\",\"node\":3,\"mcs\":5}],\"id\":42}",
+      commands);
+  NS_TEST_ASSERT_MSG_EQ (status, RicControlCommandDecoder::OK, "Batch not decoded");
+  NS_TEST_ASSERT_MSG_EQ (commands.size (), 3, "Wrong number of commands");
+  NS_TEST_EXPECT_MSG_EQ (commands[0].m_type, RicControlCommand::SET_MCS, "Wrong order");
+  NS_TEST_EXPECT_MSG_EQ (commands[0].m_node, 1, "Wrong order");
+  NS_TEST_EXPECT_MSG_EQ (commands[1].m_type, RicControlCommand::SET_ENB_TXPOWER, "Wrong order");
+  NS_TEST_EXPECT_MSG_EQ (commands[2].m_node, 3, "Wrong order");
+  for (const RicControlCommand &command : commands)
+    {
+      NS_TEST_EXPECT_MSG_EQ (command.Has (RicControlCommand::ID), false,
+                             "The id of the batch is not the one of its commands");
+    }
+
+  // a command next to the batch comes first, wherever it is in the message
+  const char *mixed[] = {
+      "{\"cmd\":\"stop\",\"cmds\":[{\"cmd\":\"set-bandwidth\",\"bandwidth\":50}]}",
+      "{\"cmds\":[{\"cmd\":\"set-bandwidth\",\"bandwidth\":50}],\"cmd\":\"stop\"}",
+  };
+  for (const char *json : mixed)
+    {
+      status = RicControlCommandDecoder::Decode (json, commands);
+      NS_TEST_ASSERT_MSG_EQ (status, RicControlCommandDecoder::OK, json);
+      NS_TEST_ASSERT_MSG_EQ (commands.size (), 2, json);
+      NS_TEST_EXPECT_MSG_EQ (commands[0].m_type, RicControlCommand::STOP, json);
+      NS_TEST_EXPECT_MSG_EQ (commands[1].m_type, RicControlCommand::SET_BANDWIDTH, json);
+    }
+
+  // an empty batch is valid and has no command
+  status = RicControlCommandDecoder::Decode ("{\"cmds\":[ ]}", commands);
+  NS_TEST_EXPECT_MSG_EQ (status, RicControlCommandDecoder::OK, "Empty batch");
+  NS_TEST_EXPECT_MSG_EQ (commands.size (), 0, "Empty batch");
+
+  // an invalid command rejects the whole batch, and the vector keeps its capacity
+  commands.reserve (64);
+  size_t capacity = commands.capacity ();
+  status = RicControlCommandDecoder::Decode (
+      "{\"cmds\":[{\"cmd\":\"set-mcs\",\"node\":1,\"mcs\":3},{\"cmd\":\"set-mcs\",\"node\":1,"
+      "\"mcs\":29}]}",
+      commands);
+  NS_TEST_EXPECT_MSG_EQ (status, RicControlCommandDecoder::INVALID_VALUE, "Invalid batch");
+  NS_TEST_EXPECT_MSG_EQ (commands.size (), 0, "Commands of an invalid batch");
+  NS_TEST_EXPECT_MSG_EQ (commands.capacity (), capacity, "Capacity not kept");
+
+  // batches do not nest, a nested "cmds" is skipped
+  status = RicControlCommandDecoder::Decode (
+      "{\"cmds\":[{\"cmd\":\"stop\",\"cmds\":[{\"cmd\":\"set-bandwidth\",\"bandwidth\":50}]}]}",
+      commands);
+  NS_TEST_EXPECT_MSG_EQ (status, RicControlCommandDecoder::OK, "Nested batch");
+  NS_TEST_EXPECT_MSG_EQ (commands.size (), 1, "Nested batch decoded");
+}
+
+/**
+ * Check the status of the invalid messages
+ */
+class RicControlCommandErrorTestCase : public TestCase
+{
+public:
+  RicControlCommandErrorTestCase ()
+    : TestCase ("Statuses of the invalid messages")
+  {
+  }
+
+private:
+  void DoRun () override;
+};
+
+void
+RicControlCommandErrorTestCase::DoRun ()
+{
+  const DecodeCase cases[] = {
+      // not JSON
+      {"", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"cmd", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"stop\"", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"stop\"} x", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\" \"stop\"}", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"stop\",}", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"stop}", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":stop}", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmds\":{}}", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmds\":[{\"cmd\":\"stop\"}}", RicControlCommandDecoder::SYNTAX_ERROR},
+      // nested deeper than the tokenizer skips
+      {"{\"cmd\":\"stop\",\"x\":[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[["
+       "0]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]}",
+       RicControlCommandDecoder::SYNTAX_ERROR},
+      // not numbers
+      {"{\"cmd\":\"set-mcs\",\"node\":-,\"mcs\":-}", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"set-mcs\",\"node\":1,\"mcs\":\"\"}", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"set-mcs\",\"node\":1,\"mcs\":\"-\"}", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"set-mcs\",\"node\":1,\"mcs\":true}", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"set-mcs\",\"node\":1,\"mcs\":\"10}", RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"set-enb-txpower\",\"node\":1,\"txPowerDbm\":-inf}",
+       RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"set-enb-txpower\",\"node\":1,\"txPowerDbm\":-nan}",
+       RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"set-enb-txpower\",\"node\":1,\"txPowerDbm\":1e999}",
+       RicControlCommandDecoder::SYNTAX_ERROR},
+      {"{\"cmd\":\"set-enb-txpower\",\"node\":1,\"txPowerDbm\":0x1p3}",
+       RicControlCommandDecoder::SYNTAX_ERROR},
+      // no command
+      {"{}", RicControlCommandDecoder::NO_COMMAND},
+      {"{\"node\":1,\"mcs\":3}", RicControlCommandDecoder::NO_COMMAND},
+      {"{\"cmds\":[{\"node\":1}]}", RicControlCommandDecoder::NO_COMMAND},
+      // unknown command
+      {"{\"cmd\":\"reboot\"}", RicControlCommandDecoder::UNKNOWN_COMMAND},
+      {"{\"cmd\":\"\"}", RicControlCommandDecoder::UNKNOWN_COMMAND},
+      {"{\"cmds\":[{\"cmd\":\"stop\"},{\"cmd\":\"set-mcs-all\"}]}",
+       RicControlCommandDecoder::UNKNOWN_COMMAND},
+      // missing field
+      {"{\"cmd\":\"set-mcs\",\"node\":1}", RicControlCommandDecoder::MISSING_FIELD},
+      // invalid values
+      {"{\"cmd\":\"set-mcs\",\"node\":-1,\"mcs\":3}", RicControlCommandDecoder::INVALID_VALUE},
+      {"{\"cmd\":\"set-mcs\",\"node\":4294967296,\"mcs\":3}",
+       RicControlCommandDecoder::INVALID_VALUE},
+      {"{\"cmd\":\"set-mcs\",\"node\":1,\"mcs\":29}", RicControlCommandDecoder::INVALID_VALUE},
+      {"{\"cmd\":\"set-mcs\",\"node\":1,\"mcs\":-1}", RicControlCommandDecoder::INVALID_VALUE},
+      {"{\"cmd\":\"set-bandwidth\",\"bandwidth\":256}", RicControlCommandDecoder::INVALID_VALUE},
+      {"{\"cmd\":\"set-flow-rate\",\"app\":0,\"rateMbps\":0}",
+       RicControlCommandDecoder::INVALID_VALUE},
+      {"{\"cmd\":\"set-slice-quota\",\"node\":1,\"sST\":1,\"prbMin\":70,\"prbMax\":60}",
+       RicControlCommandDecoder::INVALID_VALUE},
+      {"{\"cmd\":\"set-slice-quota\",\"node\":1,\"sST\":1,\"prbMin\":0,\"prbMax\":101}",
+       RicControlCommandDecoder::INVALID_VALUE},
+      {"{\"cmd\":\"set-slice-quota\",\"node\":1,\"sST\":256,\"prbMin\":0,\"prbMax\":10}",
+       RicControlCommandDecoder::INVALID_VALUE},
+      {"{\"cmd\":\"set-ue-slice\",\"node\":1,\"ueId\":1,\"sST\":1,\"sD\":16777216}",
+       RicControlCommandDecoder::INVALID_VALUE},
+      {"{\"cmd\":\"stop\",\"id\":1.5}", RicControlCommandDecoder::INVALID_VALUE},
+      {"{\"cmd\":\"stop\",\"id\":-1}", RicControlCommandDecoder::INVALID_VALUE},
+  };
+
+  std::vector<RicControlCommand> commands;
+  for (const DecodeCase &c : cases)
+    {
+      commands.assign (2, RicControlCommand ());
+      RicControlCommandDecoder::Status status = RicControlCommandDecoder::Decode (c.json, commands);
+      NS_TEST_EXPECT_MSG_EQ (status, c.status, c.json);
+      NS_TEST_EXPECT_MSG_EQ (commands.empty (), true, c.json);
+    }
+
+  // the statuses and their result codes
+  NS_TEST_EXPECT_MSG_EQ (std::string (RicControlCommandDecoder::GetStatusString (
+                             RicControlCommandDecoder::SYNTAX_ERROR)),
+                         "syntax error", "Wrong description");
+  NS_TEST_EXPECT_MSG_EQ (std::string (RicControlCommandDecoder::GetStatusString (
+                             static_cast<RicControlCommandDecoder::Status> (200))),
+                         "unknown status", "Wrong description");
+  NS_TEST_EXPECT_MSG_EQ (RicControlResult::FromDecoderStatus (RicControlCommandDecoder::OK),
+                         RicControlResult::OK, "Wrong code");
+  NS_TEST_EXPECT_MSG_EQ (
+      RicControlResult::FromDecoderStatus (RicControlCommandDecoder::UNKNOWN_COMMAND),
+      RicControlResult::UNSUPPORTED, "Wrong code");
+  for (RicControlCommandDecoder::Status status :
+       {RicControlCommandDecoder::SYNTAX_ERROR, RicControlCommandDecoder::NO_COMMAND,
+        RicControlCommandDecoder::MISSING_FIELD, RicControlCommandDecoder::INVALID_VALUE})
+    {
+      NS_TEST_EXPECT_MSG_EQ (RicControlResult::FromDecoderStatus (status),
+                             RicControlResult::BAD_REQUEST,
+                             RicControlCommandDecoder::GetStatusString (status));
+    }
+}
+
+/**
+ * \ingroup test
+ *
+ * The test suite of RicControlCommandDecoder
+ */
+class RicControlCommandTestSuite : public TestSuite
+{
+public:
+  RicControlCommandTestSuite ()
+    : TestSuite ("ric-control-command", UNIT)
+  {
+    AddTestCase (new RicControlCommandTokenizerTestCase, TestCase::QUICK);
+    AddTestCase (new RicControlCommandLookupTestCase, TestCase::QUICK);
+    AddTestCase (new RicControlCommandRequiredFieldsTestCase, TestCase::QUICK);
+    AddTestCase (new RicControlCommandBatchTestCase, TestCase::QUICK);
+    AddTestCase (new RicControlCommandErrorTestCase, TestCase::QUICK);
+  }
+};
+
+static RicControlCommandTestSuite g_ricControlCommandTestSuite; //!< the test suite
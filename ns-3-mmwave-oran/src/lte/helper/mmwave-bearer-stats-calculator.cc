@@ -37,6 +37,7 @@
 #include "ns3/nstime.h"
 #include "ns3/string.h"
 #include <ns3/boolean.h>
+#include <ns3/enum.h>
 #include <ns3/log.h>
 
 #include <algorithm>
@@ -56,7 +57,10 @@ MmWaveBearerStatsCalculator::MmWaveBearerStatsCalculator()
     : m_firstWrite(true),
       m_pendingOutput(false),
       m_aggregatedStats(true),
-      m_protocolType("RLC")
+      m_protocolType("RLC"),
+      m_outputFormat(MmWaveTraceSink::TEXT),
+      m_traceBufferSize(1 << 20),
+      m_traceFlushInterval(Seconds(1))
 {
     NS_LOG_FUNCTION(this);
 }
@@ -64,7 +68,10 @@ MmWaveBearerStatsCalculator::MmWaveBearerStatsCalculator()
 MmWaveBearerStatsCalculator::MmWaveBearerStatsCalculator(std::string protocolType)
     : m_firstWrite(true),
       m_pendingOutput(false),
-      m_aggregatedStats(true)
+      m_aggregatedStats(true),
+      m_outputFormat(MmWaveTraceSink::TEXT),
+      m_traceBufferSize(1 << 20),
+      m_traceFlushInterval(Seconds(1))
 {
     NS_LOG_FUNCTION(this);
     m_protocolType = protocolType;
@@ -119,7 +126,25 @@ MmWaveBearerStatsCalculator::GetTypeId(void)
                           "Choice to show the results aggregated of disaggregated.",
                           BooleanValue(true),
                           MakeBooleanAccessor(&MmWaveBearerStatsCalculator::m_aggregatedStats),
-                          MakeBooleanChecker());
+                          MakeBooleanChecker())
+            .AddAttribute("OutputFormat",
+                          "Format of the per-PDU traces written when AggregatedStats is false.",
+                          EnumValue(MmWaveTraceSink::TEXT),
+                          MakeEnumAccessor(&MmWaveBearerStatsCalculator::m_outputFormat),
+                          MakeEnumChecker(MmWaveTraceSink::TEXT,
+                                          "Text",
+                                          MmWaveTraceSink::BINARY,
+                                          "Binary"))
+            .AddAttribute("TraceBufferSize",
+                          "Size in bytes of the write buffer of the per-PDU traces.",
+                          UintegerValue(1 << 20),
+                          MakeUintegerAccessor(&MmWaveBearerStatsCalculator::m_traceBufferSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TraceFlushInterval",
+                          "Maximum interval between two writes of the per-PDU traces to file.",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&MmWaveBearerStatsCalculator::m_traceFlushInterval),
+                          MakeTimeChecker());
     return tid;
 }
 
@@ -131,6 +156,8 @@ MmWaveBearerStatsCalculator::DoDispose()
     {
         ShowResults();
     }
+    m_ulTraceSink.Close();
+    m_dlTraceSink.Close();
 }
 
 void
@@ -187,14 +214,15 @@ MmWaveBearerStatsCalculator::UlTxPdu(uint16_t cellId,
     }
     else
     {
-        if (!m_ulOutFile.is_open())
-        {
-            m_ulOutFile.open(GetUlOutputFilename().c_str());
-            m_ulOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
-        }
-        m_ulOutFile << "Tx\t" << Simulator::Now().GetNanoSeconds() / 1.0e9 << "\t" << cellId << "\t"
-                    << imsi << "\t" << rnti << "\t" << (uint32_t)lcid << "\t" << packetSize << "\t"
-                    << 0 << "\t" << std::endl;
+        WritePduRecord(m_ulTraceSink,
+                       GetUlOutputFilename(),
+                       "Tx",
+                       cellId,
+                       imsi,
+                       rnti,
+                       lcid,
+                       packetSize,
+                       0);
     }
 }
 
@@ -221,14 +249,15 @@ MmWaveBearerStatsCalculator::DlTxPdu(uint16_t cellId,
     }
     else
     {
-        if (!m_dlOutFile.is_open())
-        {
-            m_dlOutFile.open(GetDlOutputFilename().c_str());
-            m_dlOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
-        }
-        m_dlOutFile << "Tx\t" << Simulator::Now().GetNanoSeconds() / 1.0e9 << "\t" << cellId << "\t"
-                    << imsi << "\t" << rnti << "\t" << (uint32_t)lcid << "\t" << packetSize << "\t"
-                    << 0 << "\t" << std::endl;
+        WritePduRecord(m_dlTraceSink,
+                       GetDlOutputFilename(),
+                       "Tx",
+                       cellId,
+                       imsi,
+                       rnti,
+                       lcid,
+                       packetSize,
+                       0);
     }
 }
 
@@ -260,20 +289,22 @@ MmWaveBearerStatsCalculator::UlRxPdu(uint16_t cellId,
                 m_ulPduSize[p] = CreateObject<MinMaxAvgTotalCalculator<uint32_t>>();
             }
             m_ulDelay[p]->Update(delay);
+            m_ulDelaySketch[p].Add(delay);
             m_ulPduSize[p]->Update(packetSize);
         }
         m_pendingOutput = true;
     }
     else
     {
-        if (!m_ulOutFile.is_open())
-        {
-            m_ulOutFile.open(GetUlOutputFilename().c_str());
-            m_ulOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
-        }
-        m_ulOutFile << "Rx\t" << Simulator::Now().GetNanoSeconds() / 1.0e9 << "\t" << cellId << "\t"
-                    << imsi << "\t" << rnti << "\t" << (uint32_t)lcid << "\t" << packetSize << "\t"
-                    << delay << "\t" << std::endl;
+        WritePduRecord(m_ulTraceSink,
+                       GetUlOutputFilename(),
+                       "Rx",
+                       cellId,
+                       imsi,
+                       rnti,
+                       lcid,
+                       packetSize,
+                       delay);
 
         NS_LOG_DEBUG("Rx\t" << Simulator::Now().GetNanoSeconds() / 1.0e9 << "\t" << cellId << "\t"
                             << imsi << "\t" << rnti << "\t" << (uint32_t)lcid << "\t" << packetSize
@@ -310,26 +341,65 @@ MmWaveBearerStatsCalculator::DlRxPdu(uint16_t cellId,
                 m_dlPduSize[p] = CreateObject<MinMaxAvgTotalCalculator<uint32_t>>();
             }
             m_dlDelay[p]->Update(delay);
+            m_dlDelaySketch[p].Add(delay);
             m_dlPduSize[p]->Update(packetSize);
         }
         m_pendingOutput = true;
     }
     else
     {
-        if (!m_dlOutFile.is_open())
-        {
-            m_dlOutFile.open(GetDlOutputFilename().c_str());
-            m_dlOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
-        }
-        m_dlOutFile << "Rx\t" << Simulator::Now().GetNanoSeconds() / 1.0e9 << "\t" << cellId << "\t"
-                    << imsi << "\t" << rnti << "\t" << (uint32_t)lcid << "\t" << packetSize << "\t"
-                    << delay << "\t" << std::endl;
+        WritePduRecord(m_dlTraceSink,
+                       GetDlOutputFilename(),
+                       "Rx",
+                       cellId,
+                       imsi,
+                       rnti,
+                       lcid,
+                       packetSize,
+                       delay);
         NS_LOG_DEBUG("Rx\t" << Simulator::Now().GetNanoSeconds() / 1.0e9 << "\t" << cellId << "\t"
                             << imsi << "\t" << rnti << "\t" << (uint32_t)lcid << "\t" << packetSize
                             << "\t" << delay << "\t" << std::endl);
     }
 }
 
+void
+MmWaveBearerStatsCalculator::WritePduRecord(MmWaveTraceSink& sink,
+                                            const std::string& filename,
+                                            const char* type,
+                                            uint16_t cellId,
+                                            uint64_t imsi,
+                                            uint16_t rnti,
+                                            uint8_t lcid,
+                                            uint32_t packetSize,
+                                            uint64_t delay)
+{
+    if (!sink.IsOpen())
+    {
+        sink.SetFormat(m_outputFormat);
+        sink.SetBufferSize(m_traceBufferSize);
+        sink.SetFlushInterval(m_traceFlushInterval);
+        sink.Open(filename,
+                  {{"TYPE", MmWaveTraceSink::FIELD_TAG},
+                   {"TIME", MmWaveTraceSink::FIELD_DOUBLE},
+                   {"CellId", MmWaveTraceSink::FIELD_UINT16},
+                   {"IMSI", MmWaveTraceSink::FIELD_UINT64},
+                   {"RNTI", MmWaveTraceSink::FIELD_UINT16},
+                   {"LCID", MmWaveTraceSink::FIELD_UINT8},
+                   {"SIZE", MmWaveTraceSink::FIELD_UINT32},
+                   {"DELAY", MmWaveTraceSink::FIELD_UINT64}});
+    }
+    sink.AddTag(type)
+        .AddDouble(Simulator::Now().GetNanoSeconds() / 1.0e9)
+        .AddUint(cellId)
+        .AddUint(imsi)
+        .AddUint(rnti)
+        .AddUint(lcid)
+        .AddUint(packetSize)
+        .AddUint(delay);
+    sink.EndRecord();
+}
+
 void
 MmWaveBearerStatsCalculator::ShowResults(void)
 {
@@ -359,11 +429,11 @@ MmWaveBearerStatsCalculator::ShowResults(void)
         ulOutFile << "% start\tend\tCellId\tIMSI\tRNTI\tLCID\tnTxPDUs\tTxBytes\tnRxPDUs\tRxBytes\t";
         ulOutFile << "delay\tstdDev\tmin\tmax\t";
         ulOutFile << "PduSize\tstdDev\tmin\tmax";
-        ulOutFile << std::endl;
+        ulOutFile << "\n";
         dlOutFile << "% start\tend\tCellId\tIMSI\tRNTI\tLCID\tnTxPDUs\tTxBytes\tnRxPDUs\tRxBytes\t";
         dlOutFile << "delay\tstdDev\tmin\tmax\t";
         dlOutFile << "PduSize\tstdDev\tmin\tmax";
-        dlOutFile << std::endl;
+        dlOutFile << "\n";
     }
     else
     {
@@ -428,7 +498,7 @@ MmWaveBearerStatsCalculator::WriteUlResults(std::ofstream& outFile)
         {
             outFile << (*it) << "\t";
         }
-        outFile << std::endl;
+        outFile << "\n";
     }
 
     outFile.close();
@@ -474,7 +544,7 @@ MmWaveBearerStatsCalculator::WriteDlResults(std::ofstream& outFile)
         {
             outFile << (*it) << "\t";
         }
-        outFile << std::endl;
+        outFile << "\n";
     }
 
     outFile.close();
@@ -490,6 +560,7 @@ MmWaveBearerStatsCalculator::ResetResults(void)
     m_ulRxData.erase(m_ulRxData.begin(), m_ulRxData.end());
     m_ulTxData.erase(m_ulTxData.begin(), m_ulTxData.end());
     m_ulDelay.erase(m_ulDelay.begin(), m_ulDelay.end());
+    m_ulDelaySketch.clear();
     m_ulPduSize.erase(m_ulPduSize.begin(), m_ulPduSize.end());
 
     m_dlTxPackets.erase(m_dlTxPackets.begin(), m_dlTxPackets.end());
@@ -497,6 +568,7 @@ MmWaveBearerStatsCalculator::ResetResults(void)
     m_dlRxData.erase(m_dlRxData.begin(), m_dlRxData.end());
     m_dlTxData.erase(m_dlTxData.begin(), m_dlTxData.end());
     m_dlDelay.erase(m_dlDelay.begin(), m_dlDelay.end());
+    m_dlDelaySketch.clear();
     m_dlPduSize.erase(m_dlPduSize.begin(), m_dlPduSize.end());
 }
 
@@ -530,6 +602,7 @@ MmWaveBearerStatsCalculator::ResetResultsForImsiLcid(uint64_t imsi, uint16_t lci
     {
         m_ulDelay.erase(ulDelayEntry);
     }
+    m_ulDelaySketch.erase(ImsiLcidPair_t(imsi, lcid));
     auto ulPduSizeEntry = m_ulPduSize.find(ImsiLcidPair_t(imsi, lcid));
     if (ulPduSizeEntry != m_ulPduSize.end())
     {
@@ -561,6 +634,7 @@ MmWaveBearerStatsCalculator::ResetResultsForImsiLcid(uint64_t imsi, uint16_t lci
     {
         m_dlDelay.erase(dlDelayEntry);
     }
+    m_dlDelaySketch.erase(ImsiLcidPair_t(imsi, lcid));
     auto dlPduSizeEntry = m_dlPduSize.find(ImsiLcidPair_t(imsi, lcid));
     if (dlPduSizeEntry != m_dlPduSize.end())
     {
@@ -640,6 +714,31 @@ MmWaveBearerStatsCalculator::GetUlDelay(uint64_t imsi, uint8_t lcid)
     return m_ulDelay[p]->getMean();
 }
 
+double
+MmWaveBearerStatsCalculator::GetUlDelayQuantile(uint64_t imsi, uint8_t lcid, double q)
+{
+    NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid << q);
+    QuantileSketchMap::const_iterator it = m_ulDelaySketch.find(ImsiLcidPair_t(imsi, lcid));
+    if (it == m_ulDelaySketch.end())
+    {
+        NS_LOG_ERROR("UL delay for " << imsi << " not found");
+        return 0;
+    }
+    return it->second.GetQuantile(q);
+}
+
+MmWaveQuantileSketch
+MmWaveBearerStatsCalculator::GetUlDelaySketch(uint64_t imsi, uint8_t lcid)
+{
+    NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
+    QuantileSketchMap::const_iterator it = m_ulDelaySketch.find(ImsiLcidPair_t(imsi, lcid));
+    if (it == m_ulDelaySketch.end())
+    {
+        return MmWaveQuantileSketch();
+    }
+    return it->second;
+}
+
 std::vector<double>
 MmWaveBearerStatsCalculator::GetUlDelayStats(uint64_t imsi, uint8_t lcid)
 {
@@ -746,6 +845,31 @@ MmWaveBearerStatsCalculator::GetDlDelay(uint64_t imsi, uint8_t lcid)
     return m_dlDelay[p]->getMean();
 }
 
+double
+MmWaveBearerStatsCalculator::GetDlDelayQuantile(uint64_t imsi, uint8_t lcid, double q)
+{
+    NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid << q);
+    QuantileSketchMap::const_iterator it = m_dlDelaySketch.find(ImsiLcidPair_t(imsi, lcid));
+    if (it == m_dlDelaySketch.end())
+    {
+        NS_LOG_ERROR("DL delay for " << imsi << " not found");
+        return 0;
+    }
+    return it->second.GetQuantile(q);
+}
+
+MmWaveQuantileSketch
+MmWaveBearerStatsCalculator::GetDlDelaySketch(uint64_t imsi, uint8_t lcid)
+{
+    NS_LOG_FUNCTION(this << imsi << (uint16_t)lcid);
+    QuantileSketchMap::const_iterator it = m_dlDelaySketch.find(ImsiLcidPair_t(imsi, lcid));
+    if (it == m_dlDelaySketch.end())
+    {
+        return MmWaveQuantileSketch();
+    }
+    return it->second;
+}
+
 std::vector<double>
 MmWaveBearerStatsCalculator::GetDlDelayStats(uint64_t imsi, uint8_t lcid)
 {
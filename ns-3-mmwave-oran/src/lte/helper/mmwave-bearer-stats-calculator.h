@@ -31,6 +31,8 @@
 #include "ns3/basic-data-calculators.h"
 #include "ns3/lte-common.h"
 #include "ns3/lte-stats-calculator.h"
+#include "ns3/mmwave-quantile-sketch.h"
+#include "ns3/mmwave-trace-sink.h"
 #include "ns3/object.h"
 #include "ns3/uinteger.h"
 
@@ -52,6 +54,8 @@ typedef std::map<ImsiLcidPair_t, uint64_t> Uint64Map;
 typedef std::map<ImsiLcidPair_t, Ptr<MinMaxAvgTotalCalculator<uint32_t>>> Uint32StatsMap;
 /// Container: (IMSI, LCID) pair, uint64_t calculator
 typedef std::map<ImsiLcidPair_t, Ptr<MinMaxAvgTotalCalculator<uint64_t>>> Uint64StatsMap;
+/// Container: (IMSI, LCID) pair, quantile sketch
+typedef std::map<ImsiLcidPair_t, MmWaveQuantileSketch> QuantileSketchMap;
 /// Container: (IMSI, LCID) pair, double
 typedef std::map<ImsiLcidPair_t, double> DoubleMap;
 /// Container: (IMSI, LCID) pair, LteFlowId_t
@@ -273,6 +277,25 @@ class MmWaveBearerStatsCalculator : public LteStatsCalculator
      */
     std::vector<double> GetUlDelayStats(uint64_t imsi, uint8_t lcid);
 
+    /**
+     * Gets a quantile of the uplink RLC to RLC delay, estimated with a
+     * relative accuracy of 1%
+     * @param imsi IMSI of the UE
+     * @param lcid LCID
+     * @param q the quantile, e.g., 0.95
+     * @return the delay quantile in nanoseconds, 0 if no PDU has been received
+     */
+    double GetUlDelayQuantile(uint64_t imsi, uint8_t lcid, double q);
+
+    /**
+     * Gets the sketch of the uplink RLC to RLC delay, e.g., to merge the
+     * delays of several bearers
+     * @param imsi IMSI of the UE
+     * @param lcid LCID
+     * @return the delay sketch, empty if no PDU has been received
+     */
+    MmWaveQuantileSketch GetUlDelaySketch(uint64_t imsi, uint8_t lcid);
+
     /**
      * Gets the uplink PDU size statistics: average, min, max and standard deviation.
      * @param imsi IMSI of the UE
@@ -337,6 +360,25 @@ class MmWaveBearerStatsCalculator : public LteStatsCalculator
      */
     std::vector<double> GetDlDelayStats(uint64_t imsi, uint8_t lcid);
 
+    /**
+     * Gets a quantile of the downlink RLC to RLC delay, estimated with a
+     * relative accuracy of 1%
+     * @param imsi IMSI of the UE
+     * @param lcid LCID
+     * @param q the quantile, e.g., 0.95
+     * @return the delay quantile in nanoseconds, 0 if no PDU has been received
+     */
+    double GetDlDelayQuantile(uint64_t imsi, uint8_t lcid, double q);
+
+    /**
+     * Gets the sketch of the downlink RLC to RLC delay, e.g., to merge the
+     * delays of several bearers
+     * @param imsi IMSI of the UE
+     * @param lcid LCID
+     * @return the delay sketch, empty if no PDU has been received
+     */
+    MmWaveQuantileSketch GetDlDelaySketch(uint64_t imsi, uint8_t lcid);
+
     /**
      * Gets the downlink PDU size statistics: average, min, max and standard deviation.
      * @param imsi IMSI of the UE
@@ -348,6 +390,29 @@ class MmWaveBearerStatsCalculator : public LteStatsCalculator
     void ResetResultsForImsiLcid(uint64_t imsi, uint16_t lcid);
 
   private:
+    /**
+     * Writes a per-PDU record when the results are not aggregated, opening
+     * the trace file at the first call
+     * @param sink the UL or DL trace sink
+     * @param filename the name of the trace file
+     * @param type "Tx" or "Rx"
+     * @param cellId Cell ID of the attached Enb
+     * @param imsi IMSI of the UE who received the PDU
+     * @param rnti C-RNTI of the UE who received the PDU
+     * @param lcid LCID through which the PDU has been received
+     * @param packetSize size of the PDU in bytes
+     * @param delay RLC to RLC delay in nanoseconds, 0 for Tx
+     */
+    void WritePduRecord(MmWaveTraceSink& sink,
+                        const std::string& filename,
+                        const char* type,
+                        uint16_t cellId,
+                        uint64_t imsi,
+                        uint16_t rnti,
+                        uint8_t lcid,
+                        uint32_t packetSize,
+                        uint64_t delay);
+
     /**
      * Called after each epoch to write collected
      * statistics to output files. During first call
@@ -392,21 +457,23 @@ class MmWaveBearerStatsCalculator : public LteStatsCalculator
 
     FlowIdMap m_flowId; //!< List of FlowIds, ie. (RNTI, LCID) by (IMSI, LCID) pair
 
-    Uint32Map m_dlCellId;       //!< List of DL CellIds by (IMSI, LCID) pair
-    Uint32Map m_dlTxPackets;    //!< Number of DL TX Packets by (IMSI, LCID) pair
-    Uint32Map m_dlRxPackets;    //!< Number of DL RX Packets by (IMSI, LCID) pair
-    Uint64Map m_dlTxData;       //!< Amount of DL TX Data by (IMSI, LCID) pair
-    Uint64Map m_dlRxData;       //!< Amount of DL RX Data by (IMSI, LCID) pair
-    Uint64StatsMap m_dlDelay;   //!< DL delay by (IMSI, LCID) pair
-    Uint32StatsMap m_dlPduSize; //!< DL PDU Size by (IMSI, LCID) pair
-
-    Uint32Map m_ulCellId;       //!< List of UL CellIds by (IMSI, LCID) pair
-    Uint32Map m_ulTxPackets;    //!< Number of UL TX Packets by (IMSI, LCID) pair
-    Uint32Map m_ulRxPackets;    //!< Number of UL RX Packets by (IMSI, LCID) pair
-    Uint64Map m_ulTxData;       //!< Amount of UL TX Data by (IMSI, LCID) pair
-    Uint64Map m_ulRxData;       //!< Amount of UL RX Data by (IMSI, LCID) pair
-    Uint64StatsMap m_ulDelay;   //!< UL delay by (IMSI, LCID) pair
-    Uint32StatsMap m_ulPduSize; //!< UL PDU Size by (IMSI, LCID) pair
+    Uint32Map m_dlCellId;              //!< List of DL CellIds by (IMSI, LCID) pair
+    Uint32Map m_dlTxPackets;           //!< Number of DL TX Packets by (IMSI, LCID) pair
+    Uint32Map m_dlRxPackets;           //!< Number of DL RX Packets by (IMSI, LCID) pair
+    Uint64Map m_dlTxData;              //!< Amount of DL TX Data by (IMSI, LCID) pair
+    Uint64Map m_dlRxData;              //!< Amount of DL RX Data by (IMSI, LCID) pair
+    Uint64StatsMap m_dlDelay;          //!< DL delay by (IMSI, LCID) pair
+    QuantileSketchMap m_dlDelaySketch; //!< DL delay distribution by (IMSI, LCID) pair
+    Uint32StatsMap m_dlPduSize;        //!< DL PDU Size by (IMSI, LCID) pair
+
+    Uint32Map m_ulCellId;              //!< List of UL CellIds by (IMSI, LCID) pair
+    Uint32Map m_ulTxPackets;           //!< Number of UL TX Packets by (IMSI, LCID) pair
+    Uint32Map m_ulRxPackets;           //!< Number of UL RX Packets by (IMSI, LCID) pair
+    Uint64Map m_ulTxData;              //!< Amount of UL TX Data by (IMSI, LCID) pair
+    Uint64Map m_ulRxData;              //!< Amount of UL RX Data by (IMSI, LCID) pair
+    Uint64StatsMap m_ulDelay;          //!< UL delay by (IMSI, LCID) pair
+    QuantileSketchMap m_ulDelaySketch; //!< UL delay distribution by (IMSI, LCID) pair
+    Uint32StatsMap m_ulPduSize;        //!< UL PDU Size by (IMSI, LCID) pair
 
     /**
      * Start time of the on going epoch
@@ -448,8 +515,12 @@ class MmWaveBearerStatsCalculator : public LteStatsCalculator
      */
     std::string m_ulPdcpOutputFilename;
 
-    std::ofstream m_dlOutFile;
-    std::ofstream m_ulOutFile;
+    MmWaveTraceSink m_dlTraceSink; //!< DL per-PDU trace, used if results are not aggregated
+    MmWaveTraceSink m_ulTraceSink; //!< UL per-PDU trace, used if results are not aggregated
+
+    MmWaveTraceSink::Format m_outputFormat; //!< format of the per-PDU traces
+    uint32_t m_traceBufferSize;             //!< write buffer size of the per-PDU traces
+    Time m_traceFlushInterval;              //!< maximum interval between two writes
 };
 
 } // namespace mmwave
@@ -0,0 +1,192 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mmwave-quantile-sketch.h"
+
+#include <ns3/assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+MmWaveQuantileSketch::MmWaveQuantileSketch(double relativeAccuracy, uint32_t maxBins)
+    : m_maxBins(maxBins),
+      m_offset(0),
+      m_zeroCount(0),
+      m_count(0),
+      m_min(std::numeric_limits<double>::max()),
+      m_max(std::numeric_limits<double>::lowest())
+{
+    NS_ASSERT_MSG(relativeAccuracy > 0 && relativeAccuracy < 1, "Invalid relative accuracy");
+    NS_ASSERT_MSG(maxBins > 0, "At least one bucket is needed");
+    m_gamma = (1 + relativeAccuracy) / (1 - relativeAccuracy);
+    m_multiplier = 1 / std::log(m_gamma);
+}
+
+int32_t
+MmWaveQuantileSketch::GetKey(double value) const
+{
+    return static_cast<int32_t>(std::ceil(std::log(value) * m_multiplier));
+}
+
+double
+MmWaveQuantileSketch::GetValue(int32_t key) const
+{
+    // the bucket covers (gamma^(key-1), gamma^key]
+    return 2 * std::exp(key / m_multiplier) / (m_gamma + 1);
+}
+
+void
+MmWaveQuantileSketch::AddToKey(int32_t key, uint64_t count)
+{
+    if (m_bins.empty())
+    {
+        m_offset = key;
+        m_bins.push_back(count);
+        return;
+    }
+
+    int32_t high = std::max(key, m_offset + static_cast<int32_t>(m_bins.size()) - 1);
+    int32_t low = std::max(std::min(key, m_offset), high - static_cast<int32_t>(m_maxBins) + 1);
+
+    if (low > m_offset)
+    {
+        // collapse the buckets below low into low
+        auto collapsed =
+            std::min<std::size_t>(static_cast<std::size_t>(low - m_offset), m_bins.size());
+        uint64_t collapsedCount = std::accumulate(m_bins.begin(), m_bins.begin() + collapsed,
+                                                  static_cast<uint64_t>(0));
+        m_bins.erase(m_bins.begin(), m_bins.begin() + collapsed);
+        m_offset = low;
+        m_bins.resize(std::max<std::size_t>(m_bins.size(), 1), 0);
+        m_bins.front() += collapsedCount;
+    }
+    else if (low < m_offset)
+    {
+        m_bins.insert(m_bins.begin(), static_cast<std::size_t>(m_offset - low), 0);
+        m_offset = low;
+    }
+    if (high >= m_offset + static_cast<int32_t>(m_bins.size()))
+    {
+        m_bins.resize(static_cast<std::size_t>(high - m_offset + 1), 0);
+    }
+
+    m_bins[std::max(key, low) - m_offset] += count;
+}
+
+void
+MmWaveQuantileSketch::Add(double value)
+{
+    ++m_count;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+    if (value <= 0)
+    {
+        ++m_zeroCount;
+        return;
+    }
+    AddToKey(GetKey(value), 1);
+}
+
+void
+MmWaveQuantileSketch::Merge(const MmWaveQuantileSketch& other)
+{
+    NS_ASSERT_MSG(m_gamma == other.m_gamma, "Merging sketches with a different accuracy");
+    if (other.m_count == 0)
+    {
+        return;
+    }
+    m_count += other.m_count;
+    m_zeroCount += other.m_zeroCount;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    for (std::size_t i = 0; i < other.m_bins.size(); ++i)
+    {
+        if (other.m_bins[i] > 0)
+        {
+            AddToKey(other.m_offset + static_cast<int32_t>(i), other.m_bins[i]);
+        }
+    }
+}
+
+double
+MmWaveQuantileSketch::GetQuantile(double q) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+    // the extremes are tracked exactly
+    if (q <= 0)
+    {
+        return m_min;
+    }
+    if (q >= 1)
+    {
+        return m_max;
+    }
+    double rank = q * (m_count - 1);
+
+    uint64_t cumulative = m_zeroCount;
+    if (cumulative > rank)
+    {
+        return std::min(0.0, m_max);
+    }
+    for (std::size_t i = 0; i < m_bins.size(); ++i)
+    {
+        cumulative += m_bins[i];
+        if (cumulative > rank)
+        {
+            double value = GetValue(m_offset + static_cast<int32_t>(i));
+            return std::min(m_max, std::max(m_min, value));
+        }
+    }
+    return m_max;
+}
+
+uint64_t
+MmWaveQuantileSketch::GetCount() const
+{
+    return m_count;
+}
+
+uint32_t
+MmWaveQuantileSketch::GetNumBins() const
+{
+    return m_bins.size();
+}
+
+void
+MmWaveQuantileSketch::Reset()
+{
+    m_bins.clear();
+    m_offset = 0;
+    m_zeroCount = 0;
+    m_count = 0;
+    m_min = std::numeric_limits<double>::max();
+    m_max = std::numeric_limits<double>::lowest();
+}
+
+} // namespace mmwave
+
+} // namespace ns3
@@ -0,0 +1,121 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MMWAVE_QUANTILE_SKETCH_H_
+#define MMWAVE_QUANTILE_SKETCH_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+/**
+ * \ingroup lte
+ *
+ * Mergeable quantile sketch with bounded memory, following the DDSketch
+ * approach (Masson et al., VLDB 2019).
+ *
+ * Positive samples are counted in logarithmically spaced buckets, so that any
+ * quantile is returned with a relative error of at most the configured
+ * accuracy. Samples that are not positive are counted separately. At most
+ * maxBins buckets are kept: when the range of the samples would need more,
+ * the lowest buckets are collapsed, i.e., the accuracy guarantee is kept for
+ * the upper quantiles, which are the ones of interest for latency.
+ */
+class MmWaveQuantileSketch
+{
+  public:
+    /**
+     * Create an empty sketch
+     * @param relativeAccuracy the relative accuracy of the quantiles, in (0, 1)
+     * @param maxBins the maximum number of buckets
+     */
+    MmWaveQuantileSketch(double relativeAccuracy = 0.01, uint32_t maxBins = 1024);
+
+    /**
+     * Add a sample
+     * @param value the sample
+     */
+    void Add(double value);
+
+    /**
+     * Add the samples of another sketch, with the same relative accuracy
+     * @param other the other sketch
+     */
+    void Merge(const MmWaveQuantileSketch& other);
+
+    /**
+     * Get an estimate of a quantile
+     * @param q the quantile, in [0, 1]
+     * @return the estimate, or 0 if the sketch is empty
+     */
+    double GetQuantile(double q) const;
+
+    /**
+     * @return the number of samples
+     */
+    uint64_t GetCount() const;
+
+    /**
+     * @return the number of buckets currently allocated
+     */
+    uint32_t GetNumBins() const;
+
+    /**
+     * Remove all the samples
+     */
+    void Reset();
+
+  private:
+    /**
+     * @param value a positive sample
+     * @return the index of the bucket of the sample
+     */
+    int32_t GetKey(double value) const;
+
+    /**
+     * @param key the index of a bucket
+     * @return the value that represents the samples of the bucket
+     */
+    double GetValue(int32_t key) const;
+
+    /**
+     * Add samples to a bucket, collapsing the lowest buckets if needed
+     * @param key the index of the bucket
+     * @param count the number of samples
+     */
+    void AddToKey(int32_t key, uint64_t count);
+
+    double m_gamma;               //!< ratio between the bounds of a bucket
+    double m_multiplier;          //!< 1 / log(gamma)
+    uint32_t m_maxBins;           //!< maximum number of buckets
+    std::vector<uint64_t> m_bins; //!< contiguous buckets, starting from index m_offset
+    int32_t m_offset;             //!< index of the first bucket in m_bins
+    uint64_t m_zeroCount;         //!< number of samples that are not positive
+    uint64_t m_count;             //!< total number of samples
+    double m_min;                 //!< smallest sample
+    double m_max;                 //!< largest sample
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* MMWAVE_QUANTILE_SKETCH_H_ */
@@ -0,0 +1,431 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mmwave-trace-sink.h"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MmWaveTraceSink");
+
+namespace mmwave
+{
+
+/// Magic string at the beginning of a BINARY trace
+static const char TRACE_MAGIC[8] = {'M', 'M', 'W', 'T', 'R', 'A', 'C', 'E'};
+/// Version of the BINARY trace format
+static const uint16_t TRACE_VERSION = 1;
+/// Marker used to detect traces written with a different byte order
+static const uint32_t TRACE_BYTE_ORDER = 0x01020304;
+/// Width of a FIELD_TAG column in BINARY format
+static const uint32_t TAG_WIDTH = 4;
+
+MmWaveTraceSink::MmWaveTraceSink()
+    : m_format(TEXT),
+      m_bufferSize(1 << 20),
+      m_flushInterval(Seconds(1)),
+      m_lastFlush(Seconds(0)),
+      m_field(0)
+{
+}
+
+MmWaveTraceSink::~MmWaveTraceSink()
+{
+    Close();
+}
+
+void
+MmWaveTraceSink::SetFormat(Format format)
+{
+    m_format = format;
+}
+
+MmWaveTraceSink::Format
+MmWaveTraceSink::GetFormat() const
+{
+    return m_format;
+}
+
+void
+MmWaveTraceSink::SetBufferSize(uint32_t bytes)
+{
+    m_bufferSize = bytes;
+}
+
+void
+MmWaveTraceSink::SetFlushInterval(Time interval)
+{
+    m_flushInterval = interval;
+}
+
+uint32_t
+MmWaveTraceSink::GetFieldWidth(FieldType type)
+{
+    switch (type)
+    {
+    case FIELD_TAG:
+        return TAG_WIDTH;
+    case FIELD_UINT8:
+        return 1;
+    case FIELD_UINT16:
+        return 2;
+    case FIELD_UINT32:
+        return 4;
+    case FIELD_UINT64:
+    case FIELD_INT64:
+    case FIELD_DOUBLE:
+        return 8;
+    }
+    return 0;
+}
+
+void
+MmWaveTraceSink::Open(const std::string& filename,
+                      const std::vector<Column>& schema,
+                      const std::string& textHeader)
+{
+    NS_LOG_FUNCTION(this << filename);
+    NS_ASSERT_MSG(!schema.empty(), "Empty trace schema");
+    m_schema = schema;
+    m_field = 0;
+    m_buffer.clear();
+    m_buffer.reserve(m_bufferSize + 256);
+
+    std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+    if (m_format == BINARY)
+    {
+        mode |= std::ios_base::binary;
+    }
+    m_file.open(filename.c_str(), mode);
+    if (!m_file.is_open())
+    {
+        NS_FATAL_ERROR("Could not open tracefile " << filename);
+    }
+
+    if (m_format == TEXT)
+    {
+        if (textHeader.empty())
+        {
+            for (uint32_t i = 0; i < m_schema.size(); ++i)
+            {
+                m_buffer += (i == 0 ? "" : "\t") + m_schema[i].m_name;
+            }
+        }
+        else
+        {
+            m_buffer += textHeader;
+        }
+        m_buffer += '\n';
+    }
+    else
+    {
+        NS_ASSERT_MSG(m_schema.size() <= UINT16_MAX, "Too many columns");
+        AppendBinary(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        AppendBinary(&TRACE_VERSION, sizeof(TRACE_VERSION));
+        AppendBinary(&TRACE_BYTE_ORDER, sizeof(TRACE_BYTE_ORDER));
+        uint16_t numColumns = m_schema.size();
+        AppendBinary(&numColumns, sizeof(numColumns));
+        for (const auto& column : m_schema)
+        {
+            uint8_t type = column.m_type;
+            uint8_t nameLength = std::min<std::size_t>(column.m_name.size(), UINT8_MAX);
+            AppendBinary(&type, sizeof(type));
+            AppendBinary(&nameLength, sizeof(nameLength));
+            AppendBinary(column.m_name.data(), nameLength);
+        }
+    }
+    Flush();
+}
+
+bool
+MmWaveTraceSink::IsOpen() const
+{
+    return m_file.is_open();
+}
+
+void
+MmWaveTraceSink::Flush()
+{
+    if (!m_file.is_open() || m_buffer.empty())
+    {
+        return;
+    }
+    m_file.write(m_buffer.data(), m_buffer.size());
+    m_file.flush();
+    m_buffer.clear();
+}
+
+void
+MmWaveTraceSink::Close()
+{
+    if (m_file.is_open())
+    {
+        NS_ASSERT_MSG(m_field == 0, "Closing a trace in the middle of a record");
+        Flush();
+        m_file.close();
+    }
+}
+
+MmWaveTraceSink::FieldType
+MmWaveTraceSink::NextField(FieldType type)
+{
+    NS_ASSERT_MSG(m_field < m_schema.size(), "Too many fields in the trace record");
+    FieldType columnType = m_schema[m_field].m_type;
+    NS_ASSERT_MSG(type == columnType ||
+                      (type == FIELD_UINT64 && columnType >= FIELD_UINT8 &&
+                       columnType <= FIELD_UINT64),
+                  "Field " << m_schema[m_field].m_name << " does not match the trace schema");
+    if (m_format == TEXT && m_field > 0)
+    {
+        m_buffer += '\t';
+    }
+    ++m_field;
+    return columnType;
+}
+
+void
+MmWaveTraceSink::AppendBinary(const void* data, uint32_t size)
+{
+    m_buffer.append(static_cast<const char*>(data), size);
+}
+
+MmWaveTraceSink&
+MmWaveTraceSink::AddTag(const char* value)
+{
+    NextField(FIELD_TAG);
+    if (m_format == TEXT)
+    {
+        m_buffer += value;
+    }
+    else
+    {
+        char tag[TAG_WIDTH] = {0};
+        std::memcpy(tag, value, strnlen(value, TAG_WIDTH));
+        AppendBinary(tag, TAG_WIDTH);
+    }
+    return *this;
+}
+
+MmWaveTraceSink&
+MmWaveTraceSink::AddUint(uint64_t value)
+{
+    FieldType type = NextField(FIELD_UINT64);
+    if (m_format == TEXT)
+    {
+        char text[24];
+        int length = std::snprintf(text, sizeof(text), "%" PRIu64, value);
+        m_buffer.append(text, length);
+    }
+    else
+    {
+        // the value is stored in host byte order, take its low order bytes
+        uint8_t u8 = value;
+        uint16_t u16 = value;
+        uint32_t u32 = value;
+        switch (type)
+        {
+        case FIELD_UINT8:
+            AppendBinary(&u8, sizeof(u8));
+            break;
+        case FIELD_UINT16:
+            AppendBinary(&u16, sizeof(u16));
+            break;
+        case FIELD_UINT32:
+            AppendBinary(&u32, sizeof(u32));
+            break;
+        default:
+            AppendBinary(&value, sizeof(value));
+            break;
+        }
+    }
+    return *this;
+}
+
+MmWaveTraceSink&
+MmWaveTraceSink::AddInt(int64_t value)
+{
+    NextField(FIELD_INT64);
+    if (m_format == TEXT)
+    {
+        char text[24];
+        int length = std::snprintf(text, sizeof(text), "%" PRId64, value);
+        m_buffer.append(text, length);
+    }
+    else
+    {
+        AppendBinary(&value, sizeof(value));
+    }
+    return *this;
+}
+
+MmWaveTraceSink&
+MmWaveTraceSink::AddDouble(double value)
+{
+    NextField(FIELD_DOUBLE);
+    if (m_format == TEXT)
+    {
+        // same representation as the default std::ostream formatting
+        char text[32];
+        int length = std::snprintf(text, sizeof(text), "%g", value);
+        m_buffer.append(text, length);
+    }
+    else
+    {
+        AppendBinary(&value, sizeof(value));
+    }
+    return *this;
+}
+
+void
+MmWaveTraceSink::EndRecord()
+{
+    NS_ASSERT_MSG(m_field == m_schema.size(), "Incomplete trace record");
+    m_field = 0;
+    if (m_format == TEXT)
+    {
+        m_buffer += '\n';
+    }
+
+    if (m_buffer.size() >= m_bufferSize)
+    {
+        Flush();
+        m_lastFlush = Simulator::Now();
+    }
+    else if (Simulator::Now() - m_lastFlush >= m_flushInterval)
+    {
+        Flush();
+        m_lastFlush = Simulator::Now();
+    }
+}
+
+bool
+MmWaveTraceSink::ConvertToText(std::istream& in, std::ostream& out, char separator)
+{
+    char magic[sizeof(TRACE_MAGIC)];
+    uint16_t version;
+    uint32_t byteOrder;
+    uint16_t numColumns;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&byteOrder), sizeof(byteOrder));
+    in.read(reinterpret_cast<char*>(&numColumns), sizeof(numColumns));
+    if (!in || std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0 ||
+        version != TRACE_VERSION || byteOrder != TRACE_BYTE_ORDER || numColumns == 0)
+    {
+        NS_LOG_ERROR("Not a binary trace, or written with a different byte order");
+        return false;
+    }
+
+    std::vector<Column> schema(numColumns);
+    uint32_t recordSize = 0;
+    for (auto& column : schema)
+    {
+        uint8_t type;
+        uint8_t nameLength;
+        in.read(reinterpret_cast<char*>(&type), sizeof(type));
+        in.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
+        column.m_name.resize(nameLength);
+        in.read(&column.m_name[0], nameLength);
+        if (!in || type > FIELD_DOUBLE)
+        {
+            NS_LOG_ERROR("Corrupted binary trace header");
+            return false;
+        }
+        column.m_type = static_cast<FieldType>(type);
+        recordSize += GetFieldWidth(column.m_type);
+    }
+
+    for (uint16_t i = 0; i < numColumns; ++i)
+    {
+        out << (i == 0 ? "" : std::string(1, separator)) << schema[i].m_name;
+    }
+    out << '\n';
+
+    std::vector<char> record(recordSize);
+    while (in.read(record.data(), recordSize))
+    {
+        const char* field = record.data();
+        for (uint16_t i = 0; i < numColumns; ++i)
+        {
+            if (i > 0)
+            {
+                out << separator;
+            }
+            switch (schema[i].m_type)
+            {
+            case FIELD_TAG:
+                out << std::string(field, strnlen(field, TAG_WIDTH));
+                break;
+            case FIELD_UINT8: {
+                uint8_t value;
+                std::memcpy(&value, field, sizeof(value));
+                out << +value;
+                break;
+            }
+            case FIELD_UINT16: {
+                uint16_t value;
+                std::memcpy(&value, field, sizeof(value));
+                out << value;
+                break;
+            }
+            case FIELD_UINT32: {
+                uint32_t value;
+                std::memcpy(&value, field, sizeof(value));
+                out << value;
+                break;
+            }
+            case FIELD_UINT64: {
+                uint64_t value;
+                std::memcpy(&value, field, sizeof(value));
+                out << value;
+                break;
+            }
+            case FIELD_INT64: {
+                int64_t value;
+                std::memcpy(&value, field, sizeof(value));
+                out << value;
+                break;
+            }
+            case FIELD_DOUBLE: {
+                double value;
+                std::memcpy(&value, field, sizeof(value));
+                out << value;
+                break;
+            }
+            }
+            field += GetFieldWidth(schema[i].m_type);
+        }
+        out << '\n';
+    }
+
+    if (in.gcount() != 0)
+    {
+        NS_LOG_WARN("Truncated last record in binary trace");
+    }
+    return true;
+}
+
+} // namespace mmwave
+
+} // namespace ns3
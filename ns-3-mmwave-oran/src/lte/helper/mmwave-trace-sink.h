@@ -0,0 +1,217 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MMWAVE_TRACE_SINK_H_
+#define MMWAVE_TRACE_SINK_H_
+
+#include "ns3/nstime.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+/**
+ * \ingroup lte
+ *
+ * Buffered writer for the per-event trace files of the mmWave module
+ * (RxPacketTrace, PHY transmission traces, per-PDU RLC/PDCP stats).
+ *
+ * A trace is described by a schema, i.e., an ordered list of typed columns,
+ * and records are written field by field with the Add* methods, followed by
+ * EndRecord. Two output formats share the same schema:
+ *
+ *   - TEXT: one tab separated line per record, preceded by a header line.
+ *   - BINARY: a small header describing the schema, followed by fixed-width
+ *     records in host byte order. Binary files can be converted back to
+ *     text with ConvertToText (see utils/mmwave-trace-converter.cc).
+ *
+ * In both cases records are accumulated in memory and written to the file
+ * when the buffer exceeds the configured size, or when the configured
+ * simulation time has elapsed since the last write, and when the sink is
+ * closed.
+ */
+class MmWaveTraceSink
+{
+  public:
+    /// Output format of the trace file
+    enum Format
+    {
+        TEXT,
+        BINARY
+    };
+
+    /// Type of a column, which also determines its width in BINARY format
+    enum FieldType : uint8_t
+    {
+        FIELD_TAG = 0, //!< short string (up to 4 characters, e.g., "DL", "Tx")
+        FIELD_UINT8 = 1,
+        FIELD_UINT16 = 2,
+        FIELD_UINT32 = 3,
+        FIELD_UINT64 = 4,
+        FIELD_INT64 = 5,
+        FIELD_DOUBLE = 6
+    };
+
+    /// A column of the trace schema
+    struct Column
+    {
+        std::string m_name; //!< column name
+        FieldType m_type;   //!< column type
+    };
+
+    MmWaveTraceSink();
+    ~MmWaveTraceSink();
+
+    MmWaveTraceSink(const MmWaveTraceSink&) = delete;
+    MmWaveTraceSink& operator=(const MmWaveTraceSink&) = delete;
+
+    /**
+     * Set the output format, which is applied the next time the sink is opened
+     * @param format the output format
+     */
+    void SetFormat(Format format);
+
+    /**
+     * @return the output format
+     */
+    Format GetFormat() const;
+
+    /**
+     * Set the size of the in-memory buffer, in bytes
+     * @param bytes the buffer size
+     */
+    void SetBufferSize(uint32_t bytes);
+
+    /**
+     * Set the maximum interval, in simulation time, between two writes to the file
+     * @param interval the flush interval
+     */
+    void SetFlushInterval(Time interval);
+
+    /**
+     * Open the trace file and write the header
+     * @param filename the name of the file
+     * @param schema the columns of each record
+     * @param textHeader the header line written in TEXT format, if empty the
+     *        column names are used
+     */
+    void Open(const std::string& filename,
+              const std::vector<Column>& schema,
+              const std::string& textHeader = "");
+
+    /**
+     * @return true if the trace file is open
+     */
+    bool IsOpen() const;
+
+    /**
+     * Write the buffered records to the file
+     */
+    void Flush();
+
+    /**
+     * Flush and close the trace file
+     */
+    void Close();
+
+    /**
+     * Append a FIELD_TAG field to the current record
+     * @param value the tag, truncated to 4 characters in BINARY format
+     * @return this sink
+     */
+    MmWaveTraceSink& AddTag(const char* value);
+
+    /**
+     * Append an unsigned integer field to the current record. The column can
+     * be of any unsigned type, the value is truncated to its width.
+     * @param value the value
+     * @return this sink
+     */
+    MmWaveTraceSink& AddUint(uint64_t value);
+
+    /**
+     * Append a FIELD_INT64 field to the current record
+     * @param value the value
+     * @return this sink
+     */
+    MmWaveTraceSink& AddInt(int64_t value);
+
+    /**
+     * Append a FIELD_DOUBLE field to the current record
+     * @param value the value
+     * @return this sink
+     */
+    MmWaveTraceSink& AddDouble(double value);
+
+    /**
+     * Terminate the current record, and write the buffer to the file if
+     * the size or time threshold has been reached
+     */
+    void EndRecord();
+
+    /**
+     * Convert a BINARY trace to text
+     * @param in the binary trace
+     * @param out the output stream
+     * @param separator the field separator, e.g., ',' for CSV or '\t' for TSV
+     * @return false if the input is not a valid binary trace
+     */
+    static bool ConvertToText(std::istream& in, std::ostream& out, char separator);
+
+    /**
+     * @param type a column type
+     * @return the width of the column in BINARY format
+     */
+    static uint32_t GetFieldWidth(FieldType type);
+
+  private:
+    /**
+     * Append the separator before a new field, if needed, and check the type
+     * of the field against the schema
+     * @param type the type of the field
+     * @return the type of the column in the schema
+     */
+    FieldType NextField(FieldType type);
+
+    /**
+     * Append raw bytes to the buffer
+     * @param data the bytes
+     * @param size the number of bytes
+     */
+    void AppendBinary(const void* data, uint32_t size);
+
+    std::ofstream m_file;         //!< output file
+    std::string m_buffer;         //!< records not yet written to the file
+    std::vector<Column> m_schema; //!< columns of each record
+    Format m_format;              //!< output format
+    uint32_t m_bufferSize;        //!< size threshold for writing to the file
+    Time m_flushInterval;         //!< time threshold for writing to the file
+    Time m_lastFlush;             //!< time of the last write to the file
+    uint32_t m_field;             //!< index of the next field in the current record
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* MMWAVE_TRACE_SINK_H_ */
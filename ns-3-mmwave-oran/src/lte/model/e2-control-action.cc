@@ -0,0 +1,515 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "e2-control-action.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace ns3
+{
+
+namespace
+{
+
+/// The names of the CSV control files, indexed by E2ControlAction::Type
+const char* const g_fileNames[E2ControlAction::NUM_TYPES] = {"ts_actions_for_ns3.csv",
+                                                             "es_actions_for_ns3.csv",
+                                                             "qos_actions.csv",
+                                                             "enb_txpower_actions.csv",
+                                                             "ue_txpower_actions.csv",
+                                                             "cbr_actions.csv",
+                                                             "prb_cap_actions.csv"};
+
+/// The "type" of the JSON configurations, indexed by E2ControlAction::Type
+const char* const g_configTypes[E2ControlAction::NUM_TYPES] = {"handover",
+                                                               "energy",
+                                                               "qos",
+                                                               "set-enb-txpower",
+                                                               "set-ue-txpower",
+                                                               "set-cbr",
+                                                               "cap-ue-prb"};
+
+/// A range of characters of a line or of a JSON configuration
+struct Token
+{
+    const char* m_begin{nullptr}; //!< the first character
+    const char* m_end{nullptr};   //!< past the last character
+
+    /// \return true if the range is empty
+    bool Empty() const
+    {
+        return m_begin == m_end;
+    }
+
+    /// \return a copy of the characters
+    std::string Str() const
+    {
+        return std::string(m_begin, m_end);
+    }
+
+    /**
+     * \param s a null-terminated string
+     * \return true if the characters are equal to s
+     */
+    bool Equals(const char* s) const
+    {
+        std::size_t len = std::strlen(s);
+        return static_cast<std::size_t>(m_end - m_begin) == len &&
+               std::equal(m_begin, m_end, s);
+    }
+};
+
+bool
+IsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+Token
+Trim(const char* begin, const char* end)
+{
+    while (begin != end && IsSpace(*begin))
+    {
+        begin++;
+    }
+    while (end != begin && IsSpace(*(end - 1)))
+    {
+        end--;
+    }
+    return Token{begin, end};
+}
+
+// The numbers are parsed in place: the tokens are followed by a delimiter, so
+// strto* stop at their end, and the whole token has to be consumed.
+
+bool
+ToInt(Token t, int64_t& value)
+{
+    if (t.Empty())
+    {
+        return false;
+    }
+    char* end = nullptr;
+    long long v = std::strtoll(t.m_begin, &end, 10);
+    if (end != t.m_end)
+    {
+        return false;
+    }
+    value = v;
+    return true;
+}
+
+bool
+ToUint(Token t, uint64_t max, uint64_t& value)
+{
+    if (t.Empty() || *t.m_begin == '-')
+    {
+        return false;
+    }
+    char* end = nullptr;
+    unsigned long long v = std::strtoull(t.m_begin, &end, 10);
+    if (end != t.m_end || v > max)
+    {
+        return false;
+    }
+    value = v;
+    return true;
+}
+
+bool
+ToDouble(Token t, double& value)
+{
+    if (t.Empty())
+    {
+        return false;
+    }
+    char* end = nullptr;
+    double v = std::strtod(t.m_begin, &end);
+    if (end != t.m_end)
+    {
+        return false;
+    }
+    value = v;
+    return true;
+}
+
+uint16_t
+TokenToRnti(Token t)
+{
+    uint64_t id = 0;
+    if (t.m_end - t.m_begin > 5 && std::equal(t.m_begin, t.m_begin + 3, "111"))
+    {
+        // an IMSI, i.e., PLMN ID followed by the UE number
+        t.m_begin += 3;
+    }
+    if (!ToUint(t, std::numeric_limits<uint16_t>::max(), id))
+    {
+        return 0;
+    }
+    return static_cast<uint16_t>(id);
+}
+
+/**
+ * Find the value of a key of a JSON object, without nested objects
+ * \param begin the first character of the object
+ * \param end past the last character of the object
+ * \param key the key, without quotes
+ * \param value the value, without quotes if it is a string
+ * \return true if the key was found
+ */
+bool
+FindValue(const char* begin, const char* end, const char* key, Token& value)
+{
+    std::size_t keyLen = std::strlen(key);
+    const char* p = begin;
+    while (true)
+    {
+        p = std::find(p, end, '"');
+        if (end - p < static_cast<std::ptrdiff_t>(keyLen + 2))
+        {
+            return false;
+        }
+        if (p[keyLen + 1] == '"' && std::equal(p + 1, p + 1 + keyLen, key))
+        {
+            p += keyLen + 2;
+            while (p != end && IsSpace(*p))
+            {
+                p++;
+            }
+            if (p != end && *p == ':')
+            {
+                break;
+            }
+            continue;
+        }
+        // skip the whole string, which is either another key or a value
+        p = std::find(p + 1, end, '"');
+        if (p == end)
+        {
+            return false;
+        }
+        p++;
+    }
+    p++;
+    while (p != end && IsSpace(*p))
+    {
+        p++;
+    }
+    if (p != end && *p == '"')
+    {
+        const char* close = std::find(p + 1, end, '"');
+        if (close == end)
+        {
+            return false;
+        }
+        value = Token{p + 1, close};
+        return true;
+    }
+    const char* valueEnd = p;
+    while (valueEnd != end && *valueEnd != ',' && *valueEnd != '}' && *valueEnd != ']' &&
+           !IsSpace(*valueEnd))
+    {
+        valueEnd++;
+    }
+    value = Token{p, valueEnd};
+    return !value.Empty();
+}
+
+/**
+ * Set the fields of an action of a given type from its two parameters, which
+ * are the last two fields of a CSV line or the values of a JSON command
+ * \param first the first parameter
+ * \param second the second parameter
+ * \param ueIdIsImsi true if the UE identifiers are the ones of the xApp control
+ *        API, false if they are RNTIs
+ * \param action the action, whose type is set
+ * \return true if the parameters are valid
+ */
+bool
+ParseParameters(Token first, Token second, bool ueIdIsImsi, E2ControlAction& action)
+{
+    uint64_t id = 0;
+    uint64_t count = 0;
+    switch (action.m_type)
+    {
+    case E2ControlAction::HANDOVER:
+        if (!ToUint(first, std::numeric_limits<uint64_t>::max(), action.m_imsi) ||
+            !ToUint(second, std::numeric_limits<uint16_t>::max(), id))
+        {
+            return false;
+        }
+        action.m_cellId = id;
+        return true;
+    case E2ControlAction::HO_ALLOWED: {
+        int64_t allowed = 0;
+        if (!ToUint(first, std::numeric_limits<uint16_t>::max(), id))
+        {
+            return false;
+        }
+        if (second.Equals("true") || second.Equals("false"))
+        {
+            allowed = second.Equals("true");
+        }
+        else if (!ToInt(second, allowed))
+        {
+            return false;
+        }
+        action.m_cellId = id;
+        action.m_value = allowed != 0;
+        return true;
+    }
+    case E2ControlAction::ENB_TX_POWER:
+        if (!ToUint(first, std::numeric_limits<uint16_t>::max(), id) ||
+            !ToDouble(second, action.m_value))
+        {
+            return false;
+        }
+        action.m_cellId = id;
+        return true;
+    case E2ControlAction::QOS:
+    case E2ControlAction::UE_TX_POWER:
+    case E2ControlAction::PRB_CAP:
+        if (ueIdIsImsi)
+        {
+            id = TokenToRnti(first);
+        }
+        else if (!ToUint(first, std::numeric_limits<uint16_t>::max(), id))
+        {
+            return false;
+        }
+        if (id == 0)
+        {
+            return false;
+        }
+        action.m_rnti = id;
+        if (action.m_type == E2ControlAction::PRB_CAP)
+        {
+            if (!ToUint(second, std::numeric_limits<uint32_t>::max(), count))
+            {
+                return false;
+            }
+            action.m_maxPrb = count;
+            return true;
+        }
+        if (!ToDouble(second, action.m_value))
+        {
+            return false;
+        }
+        return action.m_type != E2ControlAction::QOS ||
+               (action.m_value >= 0 && action.m_value <= 1);
+    case E2ControlAction::CBR:
+        action.m_dataRate = first.Str();
+        if (!second.Empty())
+        {
+            if (!ToUint(second, std::numeric_limits<uint32_t>::max(), count) || count == 0)
+            {
+                return false;
+            }
+            action.m_packetSize = count;
+        }
+        return !action.m_dataRate.empty() || action.m_packetSize != 0;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+const char*
+E2ControlAction::GetFileName(Type type)
+{
+    return type < NUM_TYPES ? g_fileNames[type] : "";
+}
+
+bool
+E2ControlAction::GetTypeFromFileName(const std::string& fileName, Type& type)
+{
+    std::size_t slash = fileName.find_last_of('/');
+    const char* baseName = fileName.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+    for (uint8_t t = 0; t < NUM_TYPES; t++)
+    {
+        if (std::strcmp(baseName, g_fileNames[t]) == 0)
+        {
+            type = static_cast<Type>(t);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+E2ControlAction::ParseCsvLine(Type type, const std::string& line, E2ControlAction& action)
+{
+    Token fields[3];
+    const char* p = line.c_str();
+    const char* end = p + line.size();
+    for (Token& field : fields)
+    {
+        const char* comma = std::find(p, end, ',');
+        field = Trim(p, comma);
+        p = comma == end ? end : comma + 1;
+    }
+
+    E2ControlAction parsed;
+    parsed.m_type = type;
+    if (!ToInt(fields[0], parsed.m_timestamp) ||
+        !ParseParameters(fields[1], fields[2], false, parsed))
+    {
+        return false;
+    }
+    action = std::move(parsed);
+    return true;
+}
+
+std::size_t
+E2ControlAction::ParseConfig(const std::string& json, std::vector<E2ControlAction>& actions)
+{
+    const char* begin = json.c_str();
+    const char* end = begin + json.size();
+
+    Token token;
+    if (!FindValue(begin, end, "type", token))
+    {
+        return 0;
+    }
+    uint8_t type = 0;
+    while (type < NUM_TYPES && !token.Equals(g_configTypes[type]))
+    {
+        type++;
+    }
+    if (type == NUM_TYPES)
+    {
+        return 0;
+    }
+
+    E2ControlAction action;
+    action.m_type = static_cast<Type>(type);
+    if (FindValue(begin, end, "timestamp", token) && !ToInt(token, action.m_timestamp))
+    {
+        return 0;
+    }
+
+    if (action.m_type == CBR)
+    {
+        Token rate;
+        Token packetSize;
+        FindValue(begin, end, "rate", rate);
+        FindValue(begin, end, "pktBytes", packetSize);
+        if (!ParseParameters(rate, packetSize, true, action))
+        {
+            return 0;
+        }
+        actions.push_back(std::move(action));
+        return 1;
+    }
+
+    // the keys of the parameters of each command, in the order of ParseParameters
+    static const char* const keys[NUM_TYPES][2] = {{"imsi", "targetCellId"},
+                                                   {"cellId", "hoAllowed"},
+                                                   {"ueId", "percentage"},
+                                                   {"cellId", "dbm"},
+                                                   {"ueId", "dbm"},
+                                                   {"rate", "pktBytes"},
+                                                   {"ueId", "maxPrb"}};
+    const char* commands = std::strstr(begin, "\"commands\"");
+    if (!commands)
+    {
+        return 0;
+    }
+    const char* p = std::find(commands, end, '[');
+    const char* arrayEnd = std::find(p, end, ']');
+    std::size_t numParsed = 0;
+    while (true)
+    {
+        const char* objBegin = std::find(p, arrayEnd, '{');
+        const char* objEnd = std::find(objBegin, arrayEnd, '}');
+        if (objEnd == arrayEnd)
+        {
+            break;
+        }
+        Token first;
+        Token second;
+        E2ControlAction command = action;
+        if (FindValue(objBegin, objEnd, keys[type][0], first) &&
+            FindValue(objBegin, objEnd, keys[type][1], second) &&
+            ParseParameters(first, second, true, command))
+        {
+            actions.push_back(std::move(command));
+            numParsed++;
+        }
+        p = objEnd + 1;
+    }
+    return numParsed;
+}
+
+uint16_t
+E2ControlAction::UeIdToRnti(const std::string& ueId)
+{
+    return TokenToRnti(Trim(ueId.c_str(), ueId.c_str() + ueId.size()));
+}
+
+E2ControlActionQueue::E2ControlActionQueue(std::size_t capacity)
+    : m_capacity(capacity)
+{
+}
+
+void
+E2ControlActionQueue::SetCapacity(std::size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_capacity = capacity;
+}
+
+std::size_t
+E2ControlActionQueue::Push(const std::vector<E2ControlAction>& actions, bool& drainNeeded)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::size_t numQueued =
+        std::min(actions.size(), m_capacity - std::min(m_capacity, m_actions.size()));
+    m_actions.insert(m_actions.end(), actions.begin(), actions.begin() + numQueued);
+    m_numDropped += actions.size() - numQueued;
+    drainNeeded = numQueued > 0 && !m_drainPending;
+    m_drainPending = m_drainPending || numQueued > 0;
+    return numQueued;
+}
+
+void
+E2ControlActionQueue::PopAll(std::vector<E2ControlAction>& actions)
+{
+    actions.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    actions.swap(m_actions);
+    m_drainPending = false;
+}
+
+std::size_t
+E2ControlActionQueue::GetSize() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_actions.size();
+}
+
+uint64_t
+E2ControlActionQueue::GetNumDropped() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numDropped;
+}
+
+} // namespace ns3
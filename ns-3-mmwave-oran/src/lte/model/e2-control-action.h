@@ -0,0 +1,176 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef E2_CONTROL_ACTION_H_
+#define E2_CONTROL_ACTION_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup lte
+ *
+ * A control action of the external controller of LteEnbNetDevice, parsed
+ * either from a line of one of the CSV control files or from a JSON control
+ * configuration received with a RIC Control Request.
+ *
+ * The CSV lines have three fields, the first one being the timestamp in ms:
+ * - HANDOVER (ts_actions_for_ns3.csv): ts, imsi, targetCellId
+ * - HO_ALLOWED (es_actions_for_ns3.csv): ts, cellId, hoAllowed
+ * - QOS (qos_actions.csv): ts, rnti, percentage
+ * - ENB_TX_POWER (enb_txpower_actions.csv): ts, cellId, dBm
+ * - UE_TX_POWER (ue_txpower_actions.csv): ts, rnti, dBm
+ * - CBR (cbr_actions.csv): ts, data rate, packet size, with empty fields left unchanged
+ * - PRB_CAP (prb_cap_actions.csv): ts, rnti, maxPrb
+ *
+ * The JSON configurations are the ones of the xApp control API, e.g.,
+ * {"type":"qos","commands":[{"ueId":"111000000000001","percentage":0.7}]},
+ * with the UE identifiers converted to RNTIs as done by the xApp when it
+ * writes the CSV files, so that both paths produce the same actions.
+ */
+struct E2ControlAction
+{
+    /// The type of action
+    enum Type : uint8_t
+    {
+        HANDOVER,     ///< handover of a UE to a target cell
+        HO_ALLOWED,   ///< (dis)allow handovers to a secondary cell, i.e., energy saving
+        QOS,          ///< PDCP split percentage of a UE
+        ENB_TX_POWER, ///< tx power of the eNB
+        UE_TX_POWER,  ///< tx power of a UE
+        CBR,          ///< rate and packet size of the OnOff applications
+        PRB_CAP,      ///< maximum number of PRBs of a UE
+        NUM_TYPES     ///< number of types, not a type
+    };
+
+    Type m_type{HANDOVER};    //!< the type of action
+    int64_t m_timestamp{0};   //!< the timestamp in ms, used if the actions are pre-scheduled
+    uint64_t m_imsi{0};       //!< the IMSI, for HANDOVER
+    uint16_t m_rnti{0};       //!< the RNTI, for QOS, UE_TX_POWER and PRB_CAP
+    uint16_t m_cellId{0};     //!< the (target) cell, for HANDOVER, HO_ALLOWED and ENB_TX_POWER
+    double m_value{0};        //!< percentage for QOS, dBm for the tx power, 0/1 for HO_ALLOWED
+    std::string m_dataRate;   //!< the data rate for CBR, empty if unchanged
+    uint32_t m_packetSize{0}; //!< the packet size in bytes for CBR, 0 if unchanged
+    uint32_t m_maxPrb{0};     //!< the maximum number of PRBs, for PRB_CAP
+
+    /**
+     * \param type the type of action
+     * \return the name of the CSV control file of the type
+     */
+    static const char* GetFileName(Type type);
+
+    /**
+     * Get the type of the actions of a CSV control file
+     * \param fileName the path of the file
+     * \param type the type, set if found
+     * \return true if the file is a control file
+     */
+    static bool GetTypeFromFileName(const std::string& fileName, Type& type);
+
+    /**
+     * Parse a line of a CSV control file
+     * \param type the type of the actions of the file
+     * \param line the line
+     * \param action the action, set if the line is valid
+     * \return true if the line is valid
+     */
+    static bool ParseCsvLine(Type type, const std::string& line, E2ControlAction& action);
+
+    /**
+     * Parse a JSON control configuration and append its actions
+     * \param json the configuration
+     * \param actions the vector the actions are appended to
+     * \return the number of actions appended, 0 if the configuration is not valid
+     */
+    static std::size_t ParseConfig(const std::string& json, std::vector<E2ControlAction>& actions);
+
+    /**
+     * Convert a UE identifier of the xApp control API to an RNTI, i.e., remove
+     * the PLMN prefix "111" from an IMSI, or take a short identifier as is
+     * \param ueId the identifier
+     * \return the RNTI, or 0 if the identifier is not valid
+     */
+    static uint16_t UeIdToRnti(const std::string& ueId);
+};
+
+/**
+ * \ingroup lte
+ *
+ * Bounded queue of the control actions received by the E2 termination
+ * thread, consumed by the simulator thread.
+ *
+ * The producer pushes the actions of a message and is told whether the
+ * queue was idle, in which case it schedules a single drain event; further
+ * messages received before the drain are appended to the same batch. When
+ * the queue is full, the new actions are dropped and counted.
+ */
+class E2ControlActionQueue
+{
+  public:
+    /**
+     * Create a queue
+     * \param capacity the maximum number of queued actions
+     */
+    explicit E2ControlActionQueue(std::size_t capacity = 1024);
+
+    /**
+     * \param capacity the maximum number of queued actions
+     */
+    void SetCapacity(std::size_t capacity);
+
+    /**
+     * Push actions, from any thread
+     * \param actions the actions
+     * \param drainNeeded set to true if no drain was pending, i.e., the
+     *        caller has to schedule one
+     * \return the number of actions queued, the others being dropped
+     */
+    std::size_t Push(const std::vector<E2ControlAction>& actions, bool& drainNeeded);
+
+    /**
+     * Move the queued actions out of the queue, in the order they were pushed,
+     * and mark the drain as done
+     * \param actions the vector the actions are moved to, whose previous
+     *        content is discarded
+     */
+    void PopAll(std::vector<E2ControlAction>& actions);
+
+    /**
+     * \return the number of queued actions
+     */
+    std::size_t GetSize() const;
+
+    /**
+     * \return the number of actions dropped because the queue was full
+     */
+    uint64_t GetNumDropped() const;
+
+  private:
+    mutable std::mutex m_mutex;              //!< protects the members below
+    std::vector<E2ControlAction> m_actions;  //!< the queued actions
+    std::size_t m_capacity;                  //!< the maximum number of queued actions
+    bool m_drainPending{false};              //!< true if a drain is scheduled
+    uint64_t m_numDropped{0};                //!< number of dropped actions
+};
+
+} // namespace ns3
+
+#endif /* E2_CONTROL_ACTION_H_ */
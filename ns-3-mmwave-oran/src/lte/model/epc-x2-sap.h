@@ -32,6 +32,7 @@
 
 #include <bitset>
 #include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -364,6 +365,20 @@ class EpcX2Sap
         Ptr<Packet> ueData;    ///< UE data
     };
 
+    /**
+     * \brief Parameters of the UE DATA primitive for a batch of packets
+     *
+     * Forward the UE data buffered in the source eNB (sourceCellId) at handover to the
+     * target eNB (targetCellId) using a GTP-U tunnel (gtpTeid), in one primitive
+     */
+    struct UeDataBatchParams
+    {
+        uint16_t sourceCellId;           ///< source cell ID
+        uint16_t targetCellId;           ///< target cell ID
+        uint32_t gtpTeid;                ///< GTP TEID
+        std::vector<Ptr<Packet>> ueData; ///< UE data, in order
+    };
+
     struct SecondaryHandoverParams
     {
         uint64_t imsi;
@@ -492,6 +507,8 @@ class EpcX2SapProvider : public EpcX2Sap
 
     virtual void SendUeData(UeDataParams params) = 0;
 
+    virtual void SendUeDataBatch(UeDataBatchParams params) = 0;
+
     virtual void SetEpcX2PdcpUser(uint32_t teid, EpcX2PdcpUser* s) = 0;
 
     virtual void SetEpcX2RlcUser(uint32_t teid, EpcX2RlcUser* s) = 0;
@@ -521,6 +538,8 @@ class EpcX2SapProvider : public EpcX2Sap
     // to forward the packets in the RLC buffers in the source cell as if they were generated by a
     // PDCP
     virtual void ForwardRlcPdu(UeDataParams params) = 0;
+    // as ForwardRlcPdu, for a batch of packets of the same TEID
+    virtual void ForwardRlcPduBatch(UeDataBatchParams params) = 0;
 };
 
 /**
@@ -667,6 +686,12 @@ class EpcX2SpecificEpcX2SapProvider : public EpcX2SapProvider
      */
     virtual void SendUeData(UeDataParams params);
 
+    /**
+     * Send UE data function, for a batch of packets
+     * \param params the UE data parameters
+     */
+    virtual void SendUeDataBatch(UeDataBatchParams params);
+
     virtual void SetEpcX2PdcpUser(uint32_t teid, EpcX2PdcpUser* s);
 
     virtual void SetEpcX2RlcUser(uint32_t teid, EpcX2RlcUser* s);
@@ -693,6 +718,8 @@ class EpcX2SpecificEpcX2SapProvider : public EpcX2SapProvider
 
     virtual void ForwardRlcPdu(UeDataParams params);
 
+    virtual void ForwardRlcPduBatch(UeDataBatchParams params);
+
   private:
     EpcX2SpecificEpcX2SapProvider();
     C* m_x2; ///< owner class
@@ -766,6 +793,13 @@ EpcX2SpecificEpcX2SapProvider<C>::SendUeData(UeDataParams params)
     m_x2->DoSendUeData(params);
 }
 
+template <class C>
+void
+EpcX2SpecificEpcX2SapProvider<C>::SendUeDataBatch(UeDataBatchParams params)
+{
+    m_x2->DoSendUeDataBatch(params, false);
+}
+
 /**
  * EpcX2SpecificEpcX2SapUser
  */
@@ -861,6 +895,13 @@ EpcX2SpecificEpcX2SapProvider<C>::ForwardRlcPdu(UeDataParams params)
     m_x2->DoSendMcPdcpPdu(params);
 }
 
+template <class C>
+void
+EpcX2SpecificEpcX2SapProvider<C>::ForwardRlcPduBatch(UeDataBatchParams params)
+{
+    m_x2->DoSendUeDataBatch(params, true);
+}
+
 ///////////////////////////////////////
 
 template <class C>
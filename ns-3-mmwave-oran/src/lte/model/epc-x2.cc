@@ -1225,6 +1225,43 @@ EpcX2::DoSendUeData(EpcX2SapProvider::UeDataParams params)
     sourceSocket->SendTo(packet, 0, InetSocketAddress(targetIpAddr, m_x2uUdpPort));
 }
 
+void
+EpcX2::DoSendUeDataBatch(const EpcX2SapProvider::UeDataBatchParams& params, bool mcForward)
+{
+    NS_LOG_FUNCTION(this << params.ueData.size() << mcForward);
+
+    NS_LOG_LOGIC("sourceCellId = " << params.sourceCellId);
+    NS_LOG_LOGIC("targetCellId = " << params.targetCellId);
+    NS_LOG_LOGIC("gtpTeid = " << params.gtpTeid);
+
+    // the socket and the header are looked up and built once for the whole batch
+    auto socketIt = m_x2InterfaceSockets.find(params.targetCellId);
+    NS_ASSERT_MSG(socketIt != m_x2InterfaceSockets.end(),
+                  "Missing infos for targetCellId = " << params.targetCellId);
+    Ptr<Socket> sourceSocket = socketIt->second->m_localUserPlaneSocket;
+    InetSocketAddress targetAddr(socketIt->second->m_remoteIpAddr, m_x2uUdpPort);
+
+    GtpuHeader gtpu;
+    gtpu.SetTeid(params.gtpTeid);
+    if (mcForward)
+    {
+        // add a message type to the gtpu header, so that it is possible to distinguish at
+        // receiver
+        gtpu.SetMessageType(EpcX2Header::McForwardDownlinkData);
+    }
+    EpcX2Tag tag(Simulator::Now());
+
+    NS_LOG_INFO("Forward " << params.ueData.size() << " packets of UE DATA through X2 interface");
+    for (const Ptr<Packet>& packet : params.ueData)
+    {
+        gtpu.SetLength(packet->GetSize() + gtpu.GetSerializedSize() -
+                       8); /// \todo This should be done in GtpuHeader
+        packet->AddHeader(gtpu);
+        packet->AddPacketTag(tag);
+        sourceSocket->SendTo(packet, 0, targetAddr);
+    }
+}
+
 void
 EpcX2::DoSendMcPdcpPdu(EpcX2Sap::UeDataParams params)
 {
@@ -246,6 +246,14 @@ class EpcX2 : public Object
      * \param params EpcX2SapProvider::UeDataParams
      */
     virtual void DoSendUeData(EpcX2SapProvider::UeDataParams params);
+    /**
+     * Send a batch of UE data of the same TEID, as DoSendUeData or DoSendMcPdcpPdu
+     *
+     * \param params EpcX2SapProvider::UeDataBatchParams
+     * \param mcForward whether the packets are forwarded RLC PDUs, as with DoSendMcPdcpPdu
+     */
+    virtual void DoSendUeDataBatch(const EpcX2SapProvider::UeDataBatchParams& params,
+                                   bool mcForward);
     virtual void DoSendMcPdcpPdu(EpcX2SapProvider::UeDataParams params);
     virtual void DoReceiveMcPdcpSdu(EpcX2SapProvider::UeDataParams params);
     virtual void DoSendUeSinrUpdate(EpcX2Sap::UeImsiSinrParams params);
@@ -132,17 +132,20 @@ LteEnbNetDevice::GetCurrentDirectory()
 void
 LteEnbNetDevice::ReadControlFile()
 {
-    std::cout << "[NS3-CTRL] ReadControlFile() CALLED at time: " << Simulator::Now().GetMilliSeconds() 
-              << "ms for cellId=" << m_cellId << " filename='" << m_controlFilename << "'" << std::endl;
-    
-    NS_LOG_UNCOND(Simulator::Now().GetMilliSeconds()
-                << " [NS3-CTRL] Reading control file: " << m_controlFilename);
+    NS_LOG_FUNCTION(this);
+
+    if (m_controlSource == CONTROL_SOURCE_E2 ||
+        (m_controlSource == CONTROL_SOURCE_AUTO && m_e2ControlReceived && !m_useSemaphores))
+    {
+        // the actions are pushed by ControlMessageReceivedCallback, no need to poll
+        NS_LOG_INFO("Cell " << m_cellId << " receives the control actions through E2, "
+                            << "stop reading the control files");
+        return;
+    }
+
     NS_LOG_INFO(Simulator::Now().GetMilliSeconds()
                 << " I will try to read the control file " << m_controlFilename);
     // Open the control file and read control commands
-    std::cout << "[NS3-CTRL] ReadControlFile: m_controlFilename='" << m_controlFilename 
-              << "' m_useSemaphores=" << m_useSemaphores << std::endl;
-    
     if (m_controlFilename != "")
     {
         // Extract directory from control filename
@@ -156,18 +159,7 @@ LteEnbNetDevice::ReadControlFile()
         {
             controlDir = "."; // Current directory if no path
         }
-        
-        // List of all control files to check in the directory
-        std::vector<std::string> controlFiles = {
-            controlDir + "/qos_actions.csv",
-            controlDir + "/ts_actions_for_ns3.csv",
-            controlDir + "/es_actions_for_ns3.csv",
-            controlDir + "/enb_txpower_actions.csv",
-            controlDir + "/ue_txpower_actions.csv",
-            controlDir + "/cbr_actions.csv",
-            controlDir + "/prb_cap_actions.csv"
-        };
-        
+
         if (m_useSemaphores)
         {
             sem_t* metricsReadySemaphore = sem_open(m_metricsReadySemaphoreName.c_str(), 0);
@@ -196,9 +188,13 @@ LteEnbNetDevice::ReadControlFile()
             controlSemaphore = nullptr;
         }
 
-        // Read all control files in the directory
-        for (const auto& filename : controlFiles)
+        // Read all control files in the directory, one per type of action
+        std::vector<E2ControlAction> actions;
+        for (uint8_t t = 0; t < E2ControlAction::NUM_TYPES; t++)
         {
+            auto type = static_cast<E2ControlAction::Type>(t);
+            std::string filename = controlDir + "/" + E2ControlAction::GetFileName(type);
+
             // Check if file exists and is readable
             struct stat fileStat;
             if (stat(filename.c_str(), &fileStat) != 0)
@@ -206,7 +202,7 @@ LteEnbNetDevice::ReadControlFile()
                 // File doesn't exist, skip it
                 continue;
             }
-            
+
             // Check if file is empty
             if (fileStat.st_size == 0)
             {
@@ -214,7 +210,7 @@ LteEnbNetDevice::ReadControlFile()
                 m_controlFileMtimes.erase(filename);
                 continue;
             }
-            
+
             // Check if file has been modified since last read
             // Only read if modification time is newer than last read, or if we haven't read it before
             auto it = m_controlFileMtimes.find(filename);
@@ -223,634 +219,319 @@ LteEnbNetDevice::ReadControlFile()
                 // File hasn't changed since last read, skip it
                 continue;
             }
-            
-            std::cout << "[NS3-CTRL] Attempting to open file: " << filename << std::endl;
+
             std::ifstream csv{};
             csv.open(filename.c_str(), std::ifstream::in);
             if (!csv.is_open())
             {
                 // File exists but can't be opened, skip it (don't fatal error)
-                std::cout << "[NS3-CTRL] Warning: Can't open control file: " << filename << " (skipping)" << std::endl;
+                NS_LOG_WARN("Can't open control file " << filename << ", skipping it");
                 continue;
             }
-            std::cout << "[NS3-CTRL] Successfully opened control file: " << filename << std::endl;
-            NS_LOG_UNCOND("[NS3-CTRL] Successfully opened control file: " << filename);
+
+            actions.clear();
             std::string line;
+            while (std::getline(csv, line))
+            {
+                if (line == "" || line == "\r")
+                {
+                    // skip empty lines
+                    continue;
+                }
+                E2ControlAction action;
+                if (E2ControlAction::ParseCsvLine(type, line, action))
+                {
+                    actions.push_back(std::move(action));
+                }
+                else
+                {
+                    NS_LOG_WARN("Skipping invalid line of " << filename << ": " << line);
+                }
+            }
+            csv.close();
+
+            NS_LOG_INFO("Read " << actions.size() << " control actions from " << filename);
+            ApplyControlActions(actions, m_scheduleControlMessages);
 
-            if (filename.find("ts_actions_for_ns3.csv") != std::string::npos)
-            { // TODO adapt to the scheduling of the messages
+            // Update modification time tracking AFTER reading (prevents re-reading same file)
+            // Use the original fileStat.st_mtime we captured before reading
+            m_controlFileMtimes[filename] = fileStat.st_mtime;
 
-                long long timestamp{};
+            if (!m_scheduleControlMessages)
+            { // no need to delete stuff in this mode
+                // This clears the written file without deleting the OS file reference.
+                std::ofstream csvDelete{};
+                csvDelete.open(filename.c_str(), std::ios::trunc);
+                csvDelete.close();
 
-                while (std::getline(csv, line))
+                // After clearing, update modification time to the new cleared file's time
+                // This ensures we don't re-read the cleared file
+                struct stat newStat;
+                if (stat(filename.c_str(), &newStat) == 0)
                 {
-                    if (line == "")
-                    {
-                        // skip empty lines
-                        continue;
-                    }
-                    
-                    // Check if line has enough fields (at least 3 commas = 4 fields)
-                    size_t commaCount = std::count(line.begin(), line.end(), ',');
-                    if (commaCount < 2)
-                    {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping invalid handover line (not enough fields): " << line);
-                        continue;
-                    }
-                    
-                    NS_LOG_INFO("Read handover command");
-                    std::stringstream lineStream(line);
-                    std::string cell;
+                    m_controlFileMtimes[filename] = newStat.st_mtime;
+                }
+                else
+                {
+                    // File doesn't exist anymore, remove from tracking
+                    m_controlFileMtimes.erase(filename);
+                }
 
-                    std::getline(lineStream, cell, ',');
-                    if (cell.empty())
-                    {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping handover line with empty timestamp");
-                        continue;
-                    }
-                    try {
-                        timestamp = std::stoll(cell);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping handover line with invalid timestamp: " << cell);
-                        continue;
-                    }
+                NS_LOG_INFO("File flushed: " << filename);
+            }
+        }
 
-                    uint64_t imsi;
-                    std::getline(lineStream, cell, ',');
-                    if (cell.empty())
-                    {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping handover line with empty IMSI");
-                        continue;
-                    }
-                    try {
-                        imsi = std::stoull(cell);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping handover line with invalid IMSI: " << cell);
-                        continue;
-                    }
+        // Since the message digestion and the control are mutually exclusive,
+        // there is no need to reschedule this action again in the first case.
+        if (!m_scheduleControlMessages)
+        {
+            // Now that we have a semaphore control, the code will stop, thus avoiding endless
+            // function calls This means that we can safely fix the check at each m_e2Periodicity
+            // (which will be always delayed by 5ms due to the settomgs in the constructor)
+            ScheduleReadControlFile(Seconds(m_e2Periodicity));
+        }
+    }
+}
 
-                    uint16_t targetCellId;
-                    std::getline(lineStream, cell, ',');
-                    if (cell.empty())
-                    {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping handover line with empty targetCellId");
-                        continue;
-                    }
-                    // uncomment the next line if need to remove PLM ID, first 3 digits always 111
-                    // cell.erase(0, 3);
-                    try {
-                        targetCellId = std::stoi(cell);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping handover line with invalid targetCellId: " << cell);
-                        continue;
-                    }
+void
+LteEnbNetDevice::ScheduleReadControlFile(Time delay)
+{
+    NS_LOG_FUNCTION(this << delay);
+    if (m_controlFilename == "" || m_controlSource == CONTROL_SOURCE_E2)
+    {
+        NS_LOG_INFO("Cell " << m_cellId << " does not read the control files");
+        return;
+    }
+    // SetE2Termination and UpdateConfig both start the reads, keep a single sequence
+    m_readControlFileEvent.Cancel();
+    m_readControlFileEvent =
+        Simulator::Schedule(delay, &LteEnbNetDevice::ReadControlFile, this);
+}
 
-                    NS_LOG_INFO("Handover command for timestamp " << timestamp << " imsi " << imsi
-                                                                  << " targetCellId "
-                                                                  << targetCellId);
+void
+LteEnbNetDevice::DrainControlQueue()
+{
+    NS_LOG_FUNCTION(this);
+    m_controlQueue.PopAll(m_drainedActions);
+    NS_LOG_INFO("Cell " << m_cellId << " applies " << m_drainedActions.size()
+                        << " control actions received through E2");
+    ApplyControlActions(m_drainedActions, false);
+}
 
-                    uint16_t rntiUe = m_rrc->GetRntiFromImsi(imsi);
-                    if (rntiUe == 0)
-                    {
-                        NS_LOG_WARN("[NS3-CTRL] Could not find RNTI for IMSI " << imsi << ", skipping handover");
-                        continue;
-                    }
-                    
-                    // Check if UE exists in UeMap before accessing
-                    auto ueMap = m_rrc->GetUeMap();
-                    if (ueMap.find(rntiUe) == ueMap.end())
-                    {
-                        NS_LOG_WARN("[NS3-CTRL] RNTI " << rntiUe << " not found in UeMap for IMSI " << imsi << ", skipping handover");
-                        continue;
-                    }
-                    
-                    Ptr<UeManager> ueManager = m_rrc->GetUeManager(rntiUe);
-                    if (!ueManager)
-                    {
-                        NS_LOG_WARN("[NS3-CTRL] Could not get UeManager for RNTI " << rntiUe << ", skipping handover");
-                        continue;
-                    }
-                    
-                    uint16_t sourceCellId = ueManager->GetMmWaveCellId();
-                    if (sourceCellId == targetCellId)
-                    {
-                        NS_LOG_WARN("Source CellId and Target CellId are the same "
-                                    << unsigned(sourceCellId) << ", ignoring HO request");
-                        continue;
-                    }
+void
+LteEnbNetDevice::ApplyControlActions(const std::vector<E2ControlAction>& actions,
+                                     bool preSchedule)
+{
+    NS_LOG_FUNCTION(this << actions.size() << preSchedule);
+    if (actions.empty())
+    {
+        return;
+    }
 
-                    m_rrc->TakeUeHoControl(imsi);
-                    Simulator::ScheduleWithContext(1,
-                                                   Seconds(0),
-                                                   &LteEnbRrc::PerformHandoverToTargetCell,
-                                                   m_rrc,
-                                                   imsi,
-                                                   targetCellId);
-                }
-            }
-            else if (filename.find("es_actions_for_ns3.csv") != std::string::npos)
+    std::map<uint16_t, Ptr<UeManager>> ueMap = m_rrc->GetUeMap();
+    bool evictUsers = false;
+    int64_t lastHoAllowedTimestamp = 0;
+    for (const E2ControlAction& action : actions)
+    {
+        switch (action.m_type)
+        {
+        case E2ControlAction::HANDOVER: { // TODO adapt to the scheduling of the messages
+            uint64_t imsi = action.m_imsi;
+            uint16_t targetCellId = action.m_cellId;
+            NS_LOG_INFO("Handover command for timestamp " << action.m_timestamp << " imsi "
+                                                          << imsi << " targetCellId "
+                                                          << targetCellId);
+
+            uint16_t rntiUe = m_rrc->GetRntiFromImsi(imsi);
+            if (rntiUe == 0)
             {
-                long long timestamp{};
-                uint8_t counter = 0;
-                while (std::getline(csv, line))
-                {
-                    if (line == "")
-                    {
-                        // skip empty lines
-                        continue;
-                    }
-                    NS_LOG_INFO("Read evict users command");
-                    counter++;
-                    std::stringstream lineStream(line);
-                    std::string cell;
-
-                    std::getline(lineStream, cell, ',');
-                    timestamp = std::stoll(cell);
-
-                    uint16_t cellId;
-                    std::getline(lineStream, cell, ',');
-                    // uncomment the next line if need to remove PLM ID, first 3 digits always 111
-                    // cell.erase(0, 3);
-                    cellId = std::stoi(cell);
-
-                    bool hoAllowed; // TODO enforce correctness by checking what value is written in
-                                    // the file (should be 0 for false and 1 for true now)
-                    std::getline(lineStream, cell, ',');
-                    hoAllowed = std::stoi(cell);
-
-                    NS_LOG_INFO("Set allowed command with timestamp "
-                                << timestamp << " cellId " << cellId << " hoAllowed " << hoAllowed);
-
-                    // set the status of the cell (On/Off)
-                    if (!m_scheduleControlMessages)
-                    {
-                        m_rrc->SetSecondaryCellHandoverAllowedStatus(cellId, hoAllowed);
-                    }
-                    else
-                    { // Here we pre-schedule all the functions to be executed during the simulation
-                        Simulator::Schedule(MilliSeconds(timestamp),
-                                            &LteEnbRrc::SetSecondaryCellHandoverAllowedStatus,
-                                            m_rrc,
-                                            cellId,
-                                            hoAllowed);
-                    }
-                }
-
-                if (counter > 0)
-                { // we want this to be triggered only when we have some new data to process
-                    // Triggers (or schedules) the handovers for UEs in the Off cells
-                    if (!m_scheduleControlMessages)
-                    {
-                        m_rrc->EvictUsersFromSecondaryCell();
-                    }
-                    else
-                    {
-                        // we introduce a minimum offset of 0.001 to make sure that this is
-                        // scheduled after. This may be unnecessary according to the internal
-                        // working of ns-3 But ¯\_(ツ)_/¯
-                        Simulator::Schedule(MilliSeconds(timestamp + 0.001),
-                                            &LteEnbRrc::EvictUsersFromSecondaryCell,
-                                            m_rrc);
-                    }
-                }
+                NS_LOG_WARN("Could not find RNTI for IMSI " << imsi << ", skipping handover");
+                break;
             }
-            else if (filename.find("qos_actions.csv") != std::string::npos)
-            { // TODO adapt to the scheduling of the messages
-                std::cout << "[NS3-CTRL] Found QoS control file, reading commands..." << std::endl;
-                long long timestamp{};
-                std::unordered_map<uint16_t, double> uePercentages{};
-                NS_LOG_UNCOND("[NS3-CTRL] Found QoS control file, reading commands...");
-                NS_LOG_INFO("Read QoS command");
-                while (std::getline(csv, line))
-                {
-                    if (line == "")
-                    {
-                        // skip empty lines
-                        continue;
-                    }
 
-                    std::stringstream lineStream(line);
-                    std::string data;
-
-                    std::getline(lineStream, data, ',');
-                    timestamp = std::stoll(data);
+            // Check if UE exists in UeMap before accessing
+            if (ueMap.find(rntiUe) == ueMap.end())
+            {
+                NS_LOG_WARN("RNTI " << rntiUe << " not found in UeMap for IMSI " << imsi
+                                    << ", skipping handover");
+                break;
+            }
 
-                    uint16_t ueId;
-                    std::getline(lineStream, data, ',');
-                    // uncomment the next line if need to remove PLM ID, first 3 digits always 111
-                    // cell.erase(0, 3);
-                    ueId = std::stoi(data);
+            Ptr<UeManager> ueManager = m_rrc->GetUeManager(rntiUe);
+            if (!ueManager)
+            {
+                NS_LOG_WARN("Could not get UeManager for RNTI " << rntiUe
+                                                                << ", skipping handover");
+                break;
+            }
 
-                    double uePerc;
-                    std::getline(lineStream, data, ',');
-                    uePerc = std::stof(data);
-                    if (uePerc < 0 || uePerc > 1)
-                    {
-                        NS_LOG_ERROR("Wrong value for ueid " << uePerc << " percentage ");
-                    }
-                    else
-                    {
-                        std::cout << "[NS3-CTRL] Parsed QoS command: RNTI=" << ueId << " percentage=" << uePerc << std::endl;
-                        NS_LOG_UNCOND("[NS3-CTRL] Parsed QoS command: RNTI=" << ueId << " percentage=" << uePerc);
-                        NS_LOG_INFO("Set ue percentage command with timestamp "
-                                    << timestamp << " ueId " << ueId << "percentage" << uePerc);
-                        uePercentages.insert({ueId, uePerc});
-                    }
-                }
+            uint16_t sourceCellId = ueManager->GetMmWaveCellId();
+            if (sourceCellId == targetCellId)
+            {
+                NS_LOG_WARN("Source CellId and Target CellId are the same "
+                            << unsigned(sourceCellId) << ", ignoring HO request");
+                break;
+            }
 
-                std::cout << "[NS3-CTRL] Parsed " << uePercentages.size() << " QoS commands, checking UeMap..." << std::endl;
-                auto ueMap = m_rrc->GetUeMap();
-                std::cout << "[NS3-CTRL] UeMap has " << ueMap.size() << " UEs. RNTIs: ";
-                for (std::pair<uint16_t, ns3::Ptr<ns3::UeManager>> ue : ueMap)
-                {
-                    std::cout << ue.first << " ";
-                }
-                std::cout << std::endl;
-                
-                for (std::pair<uint16_t, double> uePercentage : uePercentages)
-                {
-                    uint16_t ueId = uePercentage.first; // Already RNTI (xApp converts IMSI->RNTI)
-                    std::cout << "[NS3-CTRL] Looking for RNTI=" << ueId << " in UeMap..." << std::endl;
-                    if (ueMap.find(ueId) == ueMap.end())
-                    {
-                        std::cout << "[NS3-CTRL] WARNING: RNTI=" << ueId << " not found in UeMap. Available RNTIs: ";
-                        for (std::pair<uint16_t, ns3::Ptr<ns3::UeManager>> ue : ueMap)
-                        {
-                            std::cout << ue.first << " ";
-                        }
-                        std::cout << std::endl;
-                        NS_LOG_ERROR(ueId << " not found in UeMap");
-                        NS_LOG_ERROR("Current map status:");
-                        for (std::pair<uint16_t, ns3::Ptr<ns3::UeManager>> ue : ueMap)
-                        {
-                            NS_LOG_ERROR(ue.first);
-                        }
-                        NS_LOG_WARN("Skipping QoS command for unknown RNTI: " << ueId);
-                        continue; // Skip instead of fatal error
-                    }
-                    double percentage = uePercentage.second;
-                    std::cout << "[NS3-CTRL] Applying QoS: RNTI=" << ueId << " percentage=" << percentage << std::endl;
-                    NS_LOG_UNCOND("[NS3-CTRL] Applying QoS: RNTI=" << ueId << " percentage=" << percentage);
-                    this->SetUeQoS(ueId, percentage);
-                }
+            m_rrc->TakeUeHoControl(imsi);
+            Simulator::ScheduleWithContext(1,
+                                           Seconds(0),
+                                           &LteEnbRrc::PerformHandoverToTargetCell,
+                                           m_rrc,
+                                           imsi,
+                                           targetCellId);
+            break;
+        }
+        case E2ControlAction::HO_ALLOWED: {
+            bool hoAllowed = action.m_value != 0;
+            NS_LOG_INFO("Set allowed command with timestamp " << action.m_timestamp << " cellId "
+                                                              << action.m_cellId
+                                                              << " hoAllowed " << hoAllowed);
+
+            // set the status of the cell (On/Off)
+            if (!preSchedule)
+            {
+                m_rrc->SetSecondaryCellHandoverAllowedStatus(action.m_cellId, hoAllowed);
             }
-            else if (filename.find("enb_txpower_actions.csv") != std::string::npos)
+            else
+            { // Here we pre-schedule all the functions to be executed during the simulation
+                Simulator::Schedule(MilliSeconds(action.m_timestamp),
+                                    &LteEnbRrc::SetSecondaryCellHandoverAllowedStatus,
+                                    m_rrc,
+                                    action.m_cellId,
+                                    hoAllowed);
+            }
+            evictUsers = true;
+            lastHoAllowedTimestamp = action.m_timestamp;
+            break;
+        }
+        case E2ControlAction::QOS: {
+            // the xApp converts the IMSI to the RNTI
+            if (ueMap.find(action.m_rnti) == ueMap.end())
             {
-                std::cout << "[NS3-CTRL] Found eNB TX power control file, reading commands..." << std::endl;
-                NS_LOG_UNCOND("[NS3-CTRL] Found eNB TX power control file, reading commands...");
-                
-                while (std::getline(csv, line))
-                {
-                    if (line == "")
-                    {
-                        continue;
-                    }
-                    
-                    // Check if line has enough fields
-                    size_t commaCount = std::count(line.begin(), line.end(), ',');
-                    if (commaCount < 2)
-                    {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping invalid eNB TX power line (not enough fields): " << line);
-                        continue;
-                    }
-                    
-                    std::stringstream lineStream(line);
-                    std::string data;
-                    
-                    std::getline(lineStream, data, ',');
-                    if (data.empty()) continue;
-                    long long timestamp{};
-                    try {
-                        timestamp = std::stoll(data);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping eNB TX power line with invalid timestamp: " << data);
-                        continue;
-                    }
-                    
-                    uint16_t cellId;
-                    std::getline(lineStream, data, ',');
-                    if (data.empty()) continue;
-                    try {
-                        cellId = std::stoi(data);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping eNB TX power line with invalid cellId: " << data);
-                        continue;
-                    }
-                    
-                    double dbm;
-                    std::getline(lineStream, data, ',');
-                    if (data.empty()) continue;
-                    try {
-                        dbm = std::stod(data);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping eNB TX power line with invalid dbm: " << data);
-                        continue;
-                    }
-                    
-                    // Only apply if this is our cell
-                    if (cellId == m_cellId)
-                    {
-                        std::cout << "[NS3-CTRL] Applying eNB TX Power: cellId=" << cellId << " dbm=" << dbm << std::endl;
-                        NS_LOG_UNCOND("[NS3-CTRL] Applying eNB TX Power: cellId=" << cellId << " dbm=" << dbm);
-                        Ptr<LteEnbPhy> phy = GetPhy();
-                        if (phy)
-                        {
-                            phy->SetAttribute("TxPower", DoubleValue(dbm));
-                        }
-                        else
-                        {
-                            NS_LOG_ERROR("[NS3-CTRL] Failed to get eNB PHY for TX power setting");
-                        }
-                    }
-                }
+                NS_LOG_WARN("Skipping QoS command for unknown RNTI: " << action.m_rnti);
+                break;
             }
-            else if (filename.find("ue_txpower_actions.csv") != std::string::npos)
+            NS_LOG_INFO("Set ue percentage command with timestamp "
+                        << action.m_timestamp << " ueId " << action.m_rnti << " percentage "
+                        << action.m_value);
+            SetUeQoS(action.m_rnti, action.m_value);
+            break;
+        }
+        case E2ControlAction::ENB_TX_POWER: {
+            // Only apply if this is our cell
+            if (action.m_cellId != m_cellId)
             {
-                std::cout << "[NS3-CTRL] Found UE TX power control file, reading commands..." << std::endl;
-                NS_LOG_UNCOND("[NS3-CTRL] Found UE TX power control file, reading commands...");
-                auto ueMap = m_rrc->GetUeMap();
-                
-                while (std::getline(csv, line))
-                {
-                    if (line == "")
-                    {
-                        continue;
-                    }
-                    
-                    // Check if line has enough fields
-                    size_t commaCount = std::count(line.begin(), line.end(), ',');
-                    if (commaCount < 2)
-                    {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping invalid UE TX power line (not enough fields): " << line);
-                        continue;
-                    }
-                    
-                    std::stringstream lineStream(line);
-                    std::string data;
-                    
-                    std::getline(lineStream, data, ',');
-                    if (data.empty()) continue;
-                    long long timestamp{};
-                    try {
-                        timestamp = std::stoll(data);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping UE TX power line with invalid timestamp: " << data);
-                        continue;
-                    }
-                    
-                    uint16_t rnti;
-                    std::getline(lineStream, data, ',');
-                    if (data.empty()) continue;
-                    try {
-                        rnti = std::stoi(data);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping UE TX power line with invalid RNTI: " << data);
-                        continue;
-                    }
-                    
-                    double dbm;
-                    std::getline(lineStream, data, ',');
-                    if (data.empty()) continue;
-                    try {
-                        dbm = std::stod(data);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping UE TX power line with invalid dbm: " << data);
-                        continue;
-                    }
-                    
-                    if (ueMap.find(rnti) != ueMap.end())
-                    {
-                        std::cout << "[NS3-CTRL] Applying UE TX Power: RNTI=" << rnti << " dbm=" << dbm << std::endl;
-                        NS_LOG_UNCOND("[NS3-CTRL] Applying UE TX Power: RNTI=" << rnti << " dbm=" << dbm);
-                        
-                        // Get IMSI from RNTI, then find UE node
-                        uint64_t imsi = m_rrc->GetImsiFromRnti(rnti);
-                        if (imsi != 0)
-                        {
-                            // Find UE node by iterating NodeList
-                            for (uint32_t i = 0; i < NodeList::GetNNodes(); ++i)
-                            {
-                                Ptr<Node> node = NodeList::GetNode(i);
-                                for (uint32_t j = 0; j < node->GetNDevices(); ++j)
-                                {
-                                    Ptr<LteUeNetDevice> ueDev = node->GetDevice(j)->GetObject<LteUeNetDevice>();
-                                    if (ueDev && ueDev->GetImsi() == imsi)
-                                    {
-                                        Ptr<LteUePhy> uePhy = ueDev->GetPhy();
-                                        if (uePhy)
-                                        {
-                                            uePhy->SetAttribute("TxPower", DoubleValue(dbm));
-                                            std::cout << "[NS3-CTRL] Successfully set UE TX power for RNTI=" << rnti << " IMSI=" << imsi << std::endl;
-                                        }
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            NS_LOG_WARN("[NS3-CTRL] Could not find IMSI for RNTI=" << rnti);
-                        }
-                    }
-                    else
-                    {
-                        NS_LOG_WARN("[NS3-CTRL] RNTI=" << rnti << " not found in UeMap, skipping TX power command");
-                    }
-                }
+                break;
+            }
+            NS_LOG_INFO("Set eNB tx power of cell " << m_cellId << " to " << action.m_value
+                                                    << " dBm");
+            Ptr<LteEnbPhy> phy = GetPhy();
+            if (phy)
+            {
+                phy->SetAttribute("TxPower", DoubleValue(action.m_value));
+            }
+            else
+            {
+                NS_LOG_ERROR("Failed to get eNB PHY for TX power setting");
+            }
+            break;
+        }
+        case E2ControlAction::UE_TX_POWER: {
+            if (ueMap.find(action.m_rnti) == ueMap.end())
+            {
+                NS_LOG_WARN("RNTI=" << action.m_rnti
+                                    << " not found in UeMap, skipping TX power command");
+                break;
             }
-            else if (filename.find("cbr_actions.csv") != std::string::npos)
+            // Get IMSI from RNTI, then find UE node
+            uint64_t imsi = m_rrc->GetImsiFromRnti(action.m_rnti);
+            if (imsi == 0)
             {
-                std::cout << "[NS3-CTRL] Found CBR control file, reading commands..." << std::endl;
-                NS_LOG_UNCOND("[NS3-CTRL] Found CBR control file, reading commands...");
-                
-                while (std::getline(csv, line))
+                NS_LOG_WARN("Could not find IMSI for RNTI=" << action.m_rnti);
+                break;
+            }
+            NS_LOG_INFO("Set UE tx power of RNTI " << action.m_rnti << " IMSI " << imsi
+                                                   << " to " << action.m_value << " dBm");
+            // Find UE node by iterating NodeList
+            for (uint32_t i = 0; i < NodeList::GetNNodes(); ++i)
+            {
+                Ptr<Node> node = NodeList::GetNode(i);
+                for (uint32_t j = 0; j < node->GetNDevices(); ++j)
                 {
-                    if (line == "")
-                    {
-                        continue;
-                    }
-                    
-                    std::stringstream lineStream(line);
-                    std::string data;
-                    
-                    std::getline(lineStream, data, ',');
-                    if (data.empty()) continue;
-                    long long timestamp{};
-                    try {
-                        timestamp = std::stoll(data);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping CBR line with invalid timestamp: " << data);
-                        continue;
-                    }
-                    
-                    std::string rate;
-                    std::getline(lineStream, data, ',');
-                    if (!data.empty())
-                    {
-                        rate = data;
-                    }
-                    
-                    std::string pktBytes;
-                    std::getline(lineStream, data, ',');
-                    if (!data.empty())
-                    {
-                        pktBytes = data;
-                    }
-                    
-                    // Find all OnOffApplication instances and update them
-                    // Search through all nodes
-                    for (uint32_t i = 0; i < NodeList::GetNNodes(); ++i)
+                    Ptr<LteUeNetDevice> ueDev = node->GetDevice(j)->GetObject<LteUeNetDevice>();
+                    if (ueDev && ueDev->GetImsi() == imsi)
                     {
-                        Ptr<Node> node = NodeList::GetNode(i);
-                        for (uint32_t j = 0; j < node->GetNApplications(); ++j)
+                        Ptr<LteUePhy> uePhy = ueDev->GetPhy();
+                        if (uePhy)
                         {
-                            Ptr<Application> app = node->GetApplication(j);
-                            Ptr<OnOffApplication> onoffApp = DynamicCast<OnOffApplication>(app);
-                            if (onoffApp)
-                            {
-                                if (!rate.empty())
-                                {
-                                    std::cout << "[NS3-CTRL] Setting CBR rate to " << rate << " for application on node " << i << std::endl;
-                                    NS_LOG_UNCOND("[NS3-CTRL] Setting CBR rate to " << rate);
-                                    onoffApp->SetAttribute("DataRate", StringValue(rate));
-                                }
-                                if (!pktBytes.empty())
-                                {
-                                    uint32_t pktSize = std::stoul(pktBytes);
-                                    std::cout << "[NS3-CTRL] Setting CBR packet size to " << pktSize << " for application on node " << i << std::endl;
-                                    NS_LOG_UNCOND("[NS3-CTRL] Setting CBR packet size to " << pktSize);
-                                    onoffApp->SetAttribute("PacketSize", UintegerValue(pktSize));
-                                }
-                            }
+                            uePhy->SetAttribute("TxPower", DoubleValue(action.m_value));
                         }
+                        break;
                     }
                 }
             }
-            else if (filename.find("prb_cap_actions.csv") != std::string::npos)
+            break;
+        }
+        case E2ControlAction::CBR: {
+            NS_LOG_INFO("Set CBR rate " << action.m_dataRate << " packet size "
+                                        << action.m_packetSize);
+            // Find all OnOffApplication instances and update them
+            for (uint32_t i = 0; i < NodeList::GetNNodes(); ++i)
             {
-                std::cout << "[NS3-CTRL] Found PRB cap control file, reading commands..." << std::endl;
-                NS_LOG_UNCOND("[NS3-CTRL] Found PRB cap control file, reading commands...");
-                auto ueMap = m_rrc->GetUeMap();
-                std::unordered_map<uint16_t, uint32_t> uePrbCaps{};
-                
-                while (std::getline(csv, line))
+                Ptr<Node> node = NodeList::GetNode(i);
+                for (uint32_t j = 0; j < node->GetNApplications(); ++j)
                 {
-                    if (line == "")
-                    {
-                        continue;
-                    }
-                    
-                    // Check if line has enough fields
-                    size_t commaCount = std::count(line.begin(), line.end(), ',');
-                    if (commaCount < 2)
+                    Ptr<OnOffApplication> onoffApp =
+                        DynamicCast<OnOffApplication>(node->GetApplication(j));
+                    if (!onoffApp)
                     {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping invalid PRB cap line (not enough fields): " << line);
-                        continue;
-                    }
-                    
-                    std::stringstream lineStream(line);
-                    std::string data;
-                    
-                    std::getline(lineStream, data, ',');
-                    if (data.empty()) continue;
-                    long long timestamp{};
-                    try {
-                        timestamp = std::stoll(data);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping PRB cap line with invalid timestamp: " << data);
-                        continue;
-                    }
-                    
-                    uint16_t rnti;
-                    std::getline(lineStream, data, ',');
-                    if (data.empty()) continue;
-                    try {
-                        rnti = std::stoi(data);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping PRB cap line with invalid RNTI: " << data);
-                        continue;
-                    }
-                    
-                    uint32_t maxPrb;
-                    std::getline(lineStream, data, ',');
-                    if (data.empty()) continue;
-                    try {
-                        maxPrb = std::stoul(data);
-                    } catch (const std::exception& e) {
-                        NS_LOG_WARN("[NS3-CTRL] Skipping PRB cap line with invalid maxPrb: " << data);
                         continue;
                     }
-                    
-                    if (ueMap.find(rnti) != ueMap.end())
+                    if (!action.m_dataRate.empty())
                     {
-                        std::cout << "[NS3-CTRL] Parsed PRB cap command: RNTI=" << rnti << " maxPrb=" << maxPrb << std::endl;
-                        NS_LOG_UNCOND("[NS3-CTRL] Parsed PRB cap command: RNTI=" << rnti << " maxPrb=" << maxPrb);
-                        uePrbCaps.insert({rnti, maxPrb});
+                        onoffApp->SetAttribute("DataRate", StringValue(action.m_dataRate));
                     }
-                    else
+                    if (action.m_packetSize != 0)
                     {
-                        NS_LOG_WARN("[NS3-CTRL] RNTI=" << rnti << " not found in UeMap, skipping PRB cap command");
+                        onoffApp->SetAttribute("PacketSize", UintegerValue(action.m_packetSize));
                     }
                 }
-                
-                // Apply PRB caps
-                // Note: This requires scheduler support. For now, we'll store it and log.
-                // The scheduler would need to be modified to respect these caps.
-                for (const auto& cap : uePrbCaps)
-                {
-                    uint16_t rnti = cap.first;
-                    uint32_t maxPrb = cap.second;
-                    std::cout << "[NS3-CTRL] PRB Cap: RNTI=" << rnti << " maxPrb=" << maxPrb 
-                              << " (Note: Scheduler modification needed for full support)" << std::endl;
-                    NS_LOG_UNCOND("[NS3-CTRL] PRB Cap: RNTI=" << rnti << " maxPrb=" << maxPrb);
-                    // TODO: Store PRB cap in a map that the scheduler can access
-                    // For now, this is a placeholder - scheduler would need to check this map
-                }
             }
-            else
+            break;
+        }
+        case E2ControlAction::PRB_CAP: {
+            if (ueMap.find(action.m_rnti) == ueMap.end())
             {
-                // Unknown file type, skip it (don't fatal error)
-                std::cout << "[NS3-CTRL] Warning: Unknown control file type: " << filename << " (skipping)" << std::endl;
-            }
-
-            csv.close();
-
-            // Update modification time tracking AFTER reading (prevents re-reading same file)
-            // Use the original fileStat.st_mtime we captured before reading
-            m_controlFileMtimes[filename] = fileStat.st_mtime;
-
-            if (!m_scheduleControlMessages)
-            { // no need to delete stuff in this mode
-                // This clears the written file without deleting the OS file reference.
-                std::ofstream csvDelete{};
-                csvDelete.open(filename.c_str(), std::ios::trunc);
-                csvDelete.close();
-                
-                // After clearing, update modification time to the new cleared file's time
-                // This ensures we don't re-read the cleared file
-                struct stat newStat;
-                if (stat(filename.c_str(), &newStat) == 0)
-                {
-                    m_controlFileMtimes[filename] = newStat.st_mtime;
-                }
-                else
-                {
-                    // File doesn't exist anymore, remove from tracking
-                    m_controlFileMtimes.erase(filename);
-                }
-
-                NS_LOG_INFO("File flushed: " << filename);
+                NS_LOG_WARN("RNTI=" << action.m_rnti
+                                    << " not found in UeMap, skipping PRB cap command");
+                break;
             }
+            // TODO: the scheduler does not enforce the caps yet, they are only logged
+            NS_LOG_INFO("PRB cap of RNTI " << action.m_rnti << ": " << action.m_maxPrb);
+            break;
+        }
+        default:
+            NS_LOG_WARN("Unknown control action type " << unsigned(action.m_type));
+            break;
         }
+    }
 
-        // Since the message digestion and the control are mutually exclusive,
-        // there is no need to reschedule this action again in the first case.
-        if (!m_scheduleControlMessages)
+    if (evictUsers)
+    { // we want this to be triggered only when we have some new data to process
+        // Triggers (or schedules) the handovers for UEs in the Off cells
+        if (!preSchedule)
         {
-            // Now that we have a semaphore control, the code will stop, thus avoiding endless
-            // function calls This means that we can safely fix the check at each m_e2Periodicity
-            // (which will be always delayed by 5ms due to the settomgs in the constructor)
-            Simulator::Schedule(Seconds(m_e2Periodicity), &LteEnbNetDevice::ReadControlFile, this);
+            m_rrc->EvictUsersFromSecondaryCell();
+        }
+        else
+        {
+            // we introduce a minimum offset of 0.001 to make sure that this is
+            // scheduled after. This may be unnecessary according to the internal
+            // working of ns-3 But ¯\_(ツ)_/¯
+            Simulator::Schedule(MilliSeconds(lastHoAllowedTimestamp + 0.001),
+                                &LteEnbRrc::EvictUsersFromSecondaryCell,
+                                m_rrc);
         }
     }
 }
@@ -912,55 +593,60 @@ LteEnbNetDevice::GetUeQoS(uint64_t imsi)
 void
 LteEnbNetDevice::ControlMessageReceivedCallback(E2AP_PDU_t* sub_req_pdu)
 {
+    // This is called by the thread of the E2 termination: the actions are
+    // only queued here, and applied by the simulator thread in DrainControlQueue
     NS_LOG_DEBUG("LteEnbNetDevice::ControlMessageReceivedCallback: Received RIC Control Message");
 
-    Ptr<RicControlMessage> controlMessage = Create<RicControlMessage>(sub_req_pdu);
-    NS_LOG_INFO("After RicControlMessage::RicControlMessage constructor");
-    NS_LOG_INFO("Request type " << controlMessage->m_requestType);
-    switch (controlMessage->m_requestType)
+    Ptr<RicControlMessage> controlMessage =
+        Create<RicControlMessage>(sub_req_pdu, PeekPointer(m_e2term));
+    const RicControlResponder& responder = controlMessage->m_responder;
+    if (m_controlSource == CONTROL_SOURCE_FILE)
     {
-    case RicControlMessage::ControlMessageRequestIdType::TS: {
-        NS_LOG_INFO("TS, do the handover");
-        // do handover
-        Ptr<OctetString> imsiString =
-            Create<OctetString>((void*)controlMessage->m_e2SmRcControlHeaderFormat1->ueId.buf,
-                                controlMessage->m_e2SmRcControlHeaderFormat1->ueId.size);
-        char* end;
-
-        uint64_t imsi = std::strtoull(imsiString->DecodeContent().c_str(), &end, 10);
-        uint16_t targetCellId = std::stoi(controlMessage->GetSecondaryCellIdHO());
-        NS_LOG_INFO("Imsi Decoded: " << imsi);
-        NS_LOG_INFO("Target Cell id " << targetCellId);
-        m_rrc->TakeUeHoControl(imsi);
-        if (!m_forceE2FileLogging)
+        NS_LOG_INFO("Control source is File, ignoring the actions of the RIC Control Message");
+        if (!controlMessage->m_simpleCommand)
         {
-            Simulator::ScheduleWithContext(1,
-                                           Seconds(0),
-                                           &LteEnbRrc::PerformHandoverToTargetCell,
-                                           m_rrc,
-                                           imsi,
-                                           targetCellId);
+            responder.ScheduleSend(m_controlContext,
+                                   {RicControlResult::INVALID_STATE, "control source is File"});
         }
-        else
+        return;
+    }
+
+    std::vector<E2ControlAction> actions;
+    if (E2ControlAction::ParseConfig(controlMessage->m_payload, actions) == 0)
+    {
+        // e.g., a "cmd" message, which is applied, and responded to, by RicControlMessage
+        NS_LOG_DEBUG("No control action in the RIC Control Message");
+        if (!controlMessage->m_simpleCommand)
         {
-            Simulator::Schedule(Seconds(0),
-                                &LteEnbRrc::PerformHandoverToTargetCell,
-                                m_rrc,
-                                imsi,
-                                targetCellId);
+            responder.ScheduleSend(m_controlContext,
+                                   {RicControlResult::BAD_REQUEST,
+                                    "no control action in the RIC Control Message"});
         }
-        break;
-    }
-    case RicControlMessage::ControlMessageRequestIdType::QoS: {
-        // use SetUeQoS()
-        NS_FATAL_ERROR("For QoS use file-based control.");
-        break;
+        return;
     }
-    default: {
-        NS_LOG_ERROR("Unrecognized id type of Ric Control Message");
-        break;
+
+    bool drainNeeded = false;
+    std::size_t numQueued = m_controlQueue.Push(actions, drainNeeded);
+    RicControlResult result;
+    if (numQueued < actions.size())
+    {
+        NS_LOG_WARN("Control queue full, dropped " << actions.size() - numQueued
+                                                   << " actions of the RIC Control Message");
+        result = {RicControlResult::INVALID_STATE,
+                  "control queue full, dropped " + std::to_string(actions.size() - numQueued) +
+                      " of " + std::to_string(actions.size()) + " actions"};
     }
+    m_e2ControlReceived = true;
+    if (drainNeeded)
+    {
+        // thread-safe, the drain runs at the current simulation time
+        Simulator::ScheduleWithContext(m_controlContext,
+                                       Seconds(0),
+                                       &LteEnbNetDevice::DrainControlQueue,
+                                       this);
     }
+    // the response follows the drain, the events of the same time running in order
+    responder.ScheduleSend(m_controlContext, result);
 }
 
 TypeId
@@ -1110,7 +796,28 @@ LteEnbNetDevice::GetTypeId(void)
                           "environment",
                           BooleanValue(false),
                           MakeBooleanAccessor(&LteEnbNetDevice::m_useSemaphores),
-                          MakeBooleanChecker());
+                          MakeBooleanChecker())
+            .AddAttribute(
+                "ControlSource",
+                "The source of the control actions. With File, the CSV control files are "
+                "read every E2Periodicity. With E2, the actions received in RIC Control "
+                "Requests are queued and applied at the next event, and the files are not "
+                "read. With Auto, the files are read until the first action is received "
+                "through E2, or always if UseSemaphores is true",
+                EnumValue(LteEnbNetDevice::CONTROL_SOURCE_AUTO),
+                MakeEnumAccessor(&LteEnbNetDevice::m_controlSource),
+                MakeEnumChecker(LteEnbNetDevice::CONTROL_SOURCE_AUTO,
+                                "Auto",
+                                LteEnbNetDevice::CONTROL_SOURCE_FILE,
+                                "File",
+                                LteEnbNetDevice::CONTROL_SOURCE_E2,
+                                "E2"))
+            .AddAttribute("ControlQueueCapacity",
+                          "The maximum number of control actions received through E2 and "
+                          "waiting to be applied, further actions are dropped",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&LteEnbNetDevice::m_controlQueueCapacity),
+                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
@@ -1124,7 +831,10 @@ LteEnbNetDevice::LteEnbNetDevice()
       m_forceE2FileLogging(false),
       m_useSemaphores(false),
       m_cuUpFileName(),
-      m_cuCpFileName()
+      m_cuCpFileName(),
+      m_controlSource(CONTROL_SOURCE_AUTO),
+      m_controlQueueCapacity(1024),
+      m_controlContext(Simulator::NO_CONTEXT)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -1139,6 +849,8 @@ LteEnbNetDevice::DoDispose()
 {
     NS_LOG_FUNCTION(this);
 
+    m_readControlFileEvent.Cancel();
+
     m_rrc->Dispose();
     m_rrc = 0;
 
@@ -1431,8 +1143,6 @@ void
 LteEnbNetDevice::UpdateConfig(void)
 {
     NS_LOG_FUNCTION(this);
-    std::cout << "[NS3-CTRL-DEBUG] UpdateConfig called for cellId=" << m_cellId 
-              << " m_controlFilename='" << m_controlFilename << "'" << std::endl;
 
     if (m_isConstructed)
     {
@@ -1449,9 +1159,6 @@ LteEnbNetDevice::UpdateConfig(void)
                           << " and CSG indication " << m_csgIndication);
         m_rrc->SetCsgId(m_csgId, m_csgIndication);
 
-        NS_LOG_UNCOND("[NS3-CTRL] UpdateConfig called: m_e2term=" << (m_e2term ? "SET" : "NULL") 
-                    << " m_controlFilename='" << m_controlFilename << "' cellId=" << m_cellId);
-        
         if (m_e2term)
         {
             NS_LOG_DEBUG("E2sim start in cell " << m_cellId << " force CSV logging "
@@ -1459,22 +1166,14 @@ LteEnbNetDevice::UpdateConfig(void)
 
             if (!m_forceE2FileLogging)
             {
+                // the RIC Control Requests are received by the E2 thread, which
+                // cannot use GetNode(): the context of the drain events is set here
+                m_controlContext = GetNode() ? GetNode()->GetId() : Simulator::NO_CONTEXT;
+                m_controlQueue.SetCapacity(m_controlQueueCapacity);
                 Simulator::Schedule(MicroSeconds(0), &E2Termination::Start, m_e2term);
-                
+
                 // Schedule control file reading even when connected to RIC (if control file is specified)
-                NS_LOG_UNCOND("[NS3-CTRL] UpdateConfig: m_controlFilename='" << m_controlFilename 
-                            << "' m_e2Periodicity=" << m_e2Periodicity << " cellId=" << m_cellId);
-                if (m_controlFilename != "")
-                {
-                    Time e2ControlPeriodicity = Seconds(m_e2Periodicity) + MilliSeconds(5);
-                    NS_LOG_UNCOND("[NS3-CTRL] Scheduling control file read for: " << m_controlFilename 
-                                << " at time: " << e2ControlPeriodicity.GetMilliSeconds() << "ms");
-                    Simulator::Schedule(e2ControlPeriodicity, &LteEnbNetDevice::ReadControlFile, this);
-                }
-                else
-                {
-                    NS_LOG_UNCOND("[NS3-CTRL] No control filename set (empty), skipping control file reading");
-                }
+                ScheduleReadControlFile(Seconds(m_e2Periodicity) + MilliSeconds(5));
             }
             else
             { // give some time for the simulation to start, TODO check value
@@ -1561,8 +1260,7 @@ LteEnbNetDevice::UpdateConfig(void)
                 }
 
                 // Set the first Control Action to happen after 5 ms to the first m_e2Periodicity
-                Time e2ControlPeriodicity = Seconds(m_e2Periodicity) + MilliSeconds(5);
-                Simulator::Schedule(e2ControlPeriodicity, &LteEnbNetDevice::ReadControlFile, this);
+                ScheduleReadControlFile(Seconds(m_e2Periodicity) + MilliSeconds(5));
             }
 
             // Regardless the offline or online mode for reporting the files, we always want to
@@ -1590,10 +1288,6 @@ LteEnbNetDevice::SetE2Termination(Ptr<E2Termination> e2term)
 {
     m_e2term = e2term;
 
-    std::cout << "[NS3-CTRL-DEBUG] SetE2Termination called for cellId=" << m_cellId 
-              << " m_controlFilename='" << m_controlFilename << "'"
-              << " m_isConstructed=" << m_isConstructed << std::endl;
-
     NS_LOG_DEBUG("Register E2SM");
 
     if (!m_forceE2FileLogging)
@@ -1610,26 +1304,10 @@ LteEnbNetDevice::SetE2Termination(Ptr<E2Termination> e2term)
                                          std::bind(&LteEnbNetDevice::ControlMessageReceivedCallback,
                                                    this,
                                                    std::placeholders::_1));
-        
+
         // Schedule control file reading if filename is set (e2term is now available)
         // Note: We don't need to check m_isConstructed - scheduling can happen before construction
-        if (m_controlFilename != "")
-        {
-            Time e2ControlPeriodicity = Seconds(m_e2Periodicity) + MilliSeconds(5);
-            double scheduled_time_ms = e2ControlPeriodicity.GetMilliSeconds();
-            double current_time_ms = Simulator::Now().GetMilliSeconds();
-            NS_LOG_UNCOND("[NS3-CTRL] SetE2Termination: Scheduling control file read for: " << m_controlFilename 
-                        << " at time: " << scheduled_time_ms << "ms (current: " << current_time_ms 
-                        << "ms, cellId=" << m_cellId << ", e2Periodicity=" << m_e2Periodicity << ")");
-            std::cout << "[NS3-CTRL] SetE2Termination: Scheduling control file read for: " << m_controlFilename 
-                      << " at time: " << scheduled_time_ms << "ms (current: " << current_time_ms 
-                      << "ms, cellId=" << m_cellId << ", e2Periodicity=" << m_e2Periodicity << ")" << std::endl;
-            Simulator::Schedule(e2ControlPeriodicity, &LteEnbNetDevice::ReadControlFile, this);
-        }
-        else
-        {
-            std::cout << "[NS3-CTRL-DEBUG] SetE2Termination: NOT scheduling - filename is empty" << std::endl;
-        }
+        ScheduleReadControlFile(Seconds(m_e2Periodicity) + MilliSeconds(5));
     }
 }
 
@@ -2012,20 +1690,7 @@ LteEnbNetDevice::BuildAndSendReportMessage(E2Termination::RicSubscriptionRequest
         if (!m_forceE2FileLogging && header != nullptr && cuUpMsg != nullptr)
         {
             NS_LOG_DEBUG("Send LTE CU-UP");
-            E2AP_PDU* pdu_cuup_ue = new E2AP_PDU;
-            encoding::generate_e2apv1_indication_request_parameterized(
-                pdu_cuup_ue,
-                params.requestorId,
-                params.instanceId,
-                params.ranFuncionId,
-                params.actionId,
-                1,                           // TODO sequence number
-                (uint8_t*)header->m_buffer,  // buffer containing the encoded header
-                header->m_size,              // size of the encoded header
-                (uint8_t*)cuUpMsg->m_buffer, // buffer containing the encoded message
-                cuUpMsg->m_size);            // size of the encoded message
-            m_e2term->SendE2Message(pdu_cuup_ue);
-            delete pdu_cuup_ue;
+            m_e2term->SendRicIndication(params, 1, header, cuUpMsg); // TODO sequence number
         }
     }
 
@@ -2039,20 +1704,7 @@ LteEnbNetDevice::BuildAndSendReportMessage(E2Termination::RicSubscriptionRequest
         if (!m_forceE2FileLogging && header != nullptr && cuCpMsg != nullptr)
         {
             NS_LOG_DEBUG("Send LTE CU-CP");
-            E2AP_PDU* pdu_cucp_ue = new E2AP_PDU;
-            encoding::generate_e2apv1_indication_request_parameterized(
-                pdu_cucp_ue,
-                params.requestorId,
-                params.instanceId,
-                params.ranFuncionId,
-                params.actionId,
-                1,                           // TODO sequence number
-                (uint8_t*)header->m_buffer,  // buffer containing the encoded header
-                header->m_size,              // size of the encoded header
-                (uint8_t*)cuCpMsg->m_buffer, // buffer containing the encoded message
-                cuCpMsg->m_size);            // size of the encoded message
-            m_e2term->SendE2Message(pdu_cucp_ue);
-            delete pdu_cucp_ue;
+            m_e2term->SendRicIndication(params, 1, header, cuCpMsg); // TODO sequence number
         }
     }
 
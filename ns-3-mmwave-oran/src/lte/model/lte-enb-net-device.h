@@ -26,6 +26,7 @@
 
 #include "ns3/component-carrier-enb.h"
 #include <semaphore.h>
+#include "ns3/e2-control-action.h"
 #include "ns3/event-id.h"
 #include "ns3/lte-net-device.h"
 #include "ns3/lte-phy.h"
@@ -35,6 +36,7 @@
 #include "ns3/traced-callback.h"
 #include <ns3/oran-interface.h>
 
+#include <atomic>
 #include <map>
 #include <vector>
 
@@ -64,6 +66,16 @@ typedef std::pair<uint64_t, uint16_t> ImsiCellIdPair_t; // TODO maybe this can b
 class LteEnbNetDevice : public LteNetDevice
 {
   public:
+    /**
+     * The source of the control actions of the external controller
+     */
+    enum ControlSource
+    {
+        CONTROL_SOURCE_AUTO, ///< the control files, until an action is received through E2
+        CONTROL_SOURCE_FILE, ///< the control files only
+        CONTROL_SOURCE_E2,   ///< the RIC Control Requests only
+    };
+
     /**
      * \brief Get the type ID.
      * \return the object TypeId
@@ -290,6 +302,23 @@ class LteEnbNetDevice : public LteNetDevice
     Ptr<KpmIndicationMessage> BuildRicIndicationMessageCuCp(std::string plmId);
     std::string GetImsiString(uint64_t imsi);
     void ReadControlFile();
+    /**
+     * Schedule the next read of the control files, replacing the pending one
+     * \param delay the delay of the read
+     */
+    void ScheduleReadControlFile(Time delay);
+    /**
+     * Apply the control actions queued by ControlMessageReceivedCallback, on
+     * the simulator thread
+     */
+    void DrainControlQueue();
+    /**
+     * Apply control actions, in order
+     * \param actions the actions
+     * \param preSchedule if true, the energy saving actions are scheduled at
+     *        their timestamp, as set by the ScheduleControlMessages attribute
+     */
+    void ApplyControlActions(const std::vector<E2ControlAction>& actions, bool preSchedule);
     std::string GetCurrentDirectory ();
 
     void RegisterNewSinrReading(uint64_t imsi, uint16_t cellId, long double sinr);
@@ -365,6 +394,14 @@ class LteEnbNetDevice : public LteNetDevice
     bool m_scheduleControlMessages;
     int m_lastValidTimestamp{0};
     std::map<std::string, time_t> m_controlFileMtimes; // Track file modification times to avoid re-reading unchanged files
+    EventId m_readControlFileEvent; //!< the next read of the control files
+
+    ControlSource m_controlSource;       //!< the source of the control actions
+    uint32_t m_controlQueueCapacity;     //!< the capacity of the queue of the E2 control actions
+    E2ControlActionQueue m_controlQueue; //!< actions received through E2, not applied yet
+    std::atomic<bool> m_e2ControlReceived{false}; //!< true once an action is received through E2
+    uint32_t m_controlContext; //!< context of the drain events, set on the simulator thread
+    std::vector<E2ControlAction> m_drainedActions; //!< buffer of DrainControlQueue
 
 }; // end of class LteEnbNetDevice
 
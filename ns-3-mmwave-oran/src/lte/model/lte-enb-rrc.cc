@@ -792,79 +792,6 @@ UeManager::PrepareHandover(uint16_t cellId)
     }
 }
 
-/*
- * Merge 2 buffers of RlcAmPdus into 1 vector with increment order of Pdus
- */
-std::vector<LteRlcAm::RetxPdu>
-UeManager::MergeBuffers(std::vector<LteRlcAm::RetxPdu> first, std::vector<LteRlcAm::RetxPdu> second)
-{
-    LteRlcAmHeader rlcamHeader_1, rlcamHeader_2;
-    std::vector<LteRlcAm::RetxPdu> result;
-    std::vector<LteRlcAm::RetxPdu>::iterator it_1 = first.begin();
-    std::vector<LteRlcAm::RetxPdu>::iterator it_2 = second.begin();
-    bool end_1_reached = false;
-    bool end_2_reached = false;
-    while (it_1 != first.end() && it_2 != second.end())
-    {
-        while (!((*it_1).m_pdu))
-        {
-            ++it_1;
-            if (it_1 == first.end())
-            {
-                end_1_reached = true;
-                break;
-            }
-        }
-        while (!((*it_2).m_pdu))
-        {
-            ++it_2;
-            if (it_2 == second.end())
-            {
-                end_2_reached = true;
-                break;
-            }
-        }
-        if (!end_1_reached && !end_2_reached)
-        {
-            (*it_1).m_pdu->PeekHeader(rlcamHeader_1);
-            (*it_2).m_pdu->PeekHeader(rlcamHeader_2);
-            if (rlcamHeader_1.GetSequenceNumber() > rlcamHeader_2.GetSequenceNumber())
-            {
-                result.push_back((*it_2));
-                ++it_2;
-            }
-            else if (rlcamHeader_2.GetSequenceNumber() > rlcamHeader_1.GetSequenceNumber())
-            {
-                result.push_back((*it_1));
-                ++it_1;
-            }
-            else
-            {
-                result.push_back((*it_1));
-                ++it_1;
-                ++it_2;
-            }
-            NS_LOG_DEBUG("first,second = " << rlcamHeader_1.GetSequenceNumber() << ","
-                                           << rlcamHeader_2.GetSequenceNumber());
-        }
-        else
-        {
-            break;
-        }
-    }
-    while (it_1 != first.end())
-    {
-        result.push_back((*it_1));
-        it_1++;
-    }
-    while (it_2 != second.end())
-    {
-        result.push_back((*it_2));
-        it_2++;
-    }
-    return result;
-}
-
 void
 UeManager::RecvHandoverRequestAck(EpcX2SapUser::HandoverRequestAckParams params)
 {
@@ -992,137 +919,11 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc,
     // RlcBuffers forwarding only for RlcAm bearers.
     if (rlc->GetObject<LteRlcAm>())
     {
-        // Copy lte-rlc-am.m_txOnBuffer to X2 forwarding buffer.
-        Ptr<LteRlcAm> rlcAm = rlc->GetObject<LteRlcAm>();
-        uint32_t txonBufferSize = rlcAm->GetTxBufferSize();
-        std::vector<Ptr<Packet>> txonBuffer = rlcAm->GetTxBuffer();
-        // m_x2forwardingBufferSize =
-        // drbIt->second->m_rlc->GetObject<LteRlcAm>()->GetTxBufferSize(); m_x2forwardingBuffer =
-        // drbIt->second->m_rlc->GetObject<LteRlcAm>()->GetTxBuffer();
-        uint32_t txedBufferSize = rlcAm->GetTxedBufferSize();
-        std::vector<LteRlcAm::RetxPdu> txedBuffer = rlcAm->GetTxedBuffer();
-        uint32_t retxBufferSize = rlcAm->GetRetxBufferSize();
-        std::vector<LteRlcAm::RetxPdu> retxBuffer = rlcAm->GetRetxBuffer();
-
-        // Translate Pdus in Rlc txed/retx buffer into RLC Sdus
-        // and put these Sdus into rlcAm->m_transmittingRlcSdus.
-        NS_LOG_INFO("retxBuffer size = " << retxBufferSize);
-        NS_LOG_INFO("txedBuffer size = " << txedBufferSize);
-        // Merge txed and retx buffers into a single buffer before doing RlcPdusToRlc.
-        if (retxBufferSize + txedBufferSize > 0)
-        {
-            std::vector<LteRlcAm::RetxPdu> sortedTxedRetxBuffer;
-            if (retxBufferSize == 0)
-            {
-                sortedTxedRetxBuffer = txedBuffer;
-            }
-            else if (txedBufferSize == 0)
-            {
-                sortedTxedRetxBuffer = retxBuffer;
-            }
-            else
-            {
-                sortedTxedRetxBuffer = MergeBuffers(txedBuffer, retxBuffer);
-            }
-            rlcAm->RlcPdusToRlcSdus(sortedTxedRetxBuffer);
-        }
-
-        // Construct the forwarding buffer
-        // Forwarding buffer = retxBuffer + txedBuffer + txonBuffer.
-        // if ( txonBufferSize > 0 )
-        //{
-        LtePdcpHeader pdcpHeader;
-        uint32_t pos = 0;
-        for (std::vector<Ptr<Packet>>::iterator it = txonBuffer.begin(); it != txonBuffer.end();
-             ++it)
-        {
-            pos++;
-            if ((*it)->GetSize() > 3)
-            {
-                (*it)->PeekHeader(pdcpHeader);
-                NS_LOG_DEBUG("txonBuffer SEQ = " << pdcpHeader.GetSequenceNumber()
-                                                 << " Size = " << (*it)->GetSize());
-            }
-            else
-            {
-                NS_LOG_UNCOND("Fragment too small in txonBuffer, pos " << pos);
-            }
-        }
-
-        // this cycle adds the SDUs given by the merge of txed and retxed buffers
-        if (rlcAm->GetTransmittingRlcSduBufferSize() > 0)
-        { // something inside the RLC AM's transmitting buffer
-            NS_LOG_DEBUG("ADDING TRANSMITTING SDUS OF RLC AM TO X2FORWARDINGBUFFER... Size = "
-                         << rlcAm->GetTransmittingRlcSduBufferSize());
-            // copy the RlcSdu buffer (map) to forwardingBuffer.
-            std::map<uint32_t, Ptr<Packet>> rlcAmTransmittingBuffer =
-                rlcAm->GetTransmittingRlcSduBuffer();
-            NS_LOG_DEBUG(" *** SIZE = " << rlcAmTransmittingBuffer.size());
-            for (std::map<uint32_t, Ptr<Packet>>::iterator it = rlcAmTransmittingBuffer.begin();
-                 it != rlcAmTransmittingBuffer.end();
-                 ++it)
-            {
-                if (it->second)
-                {
-                    NS_LOG_DEBUG(this << " add to forwarding buffer SEQ = " << it->first
-                                      << " Ptr<Packet> = " << it->second);
-                    m_x2forwardingBuffer.push_back(it->second);
-                }
-            }
-            NS_LOG_DEBUG(this << " ADDING TXONBUFFER OF RLC AM " << m_rnti
-                              << " Size = " << txonBufferSize);
-
-            Ptr<Packet> segmentedRlcsdu = rlcAm->GetSegmentedRlcsdu();
-            if (segmentedRlcsdu != NULL)
-            {
-                segmentedRlcsdu->PeekHeader(pdcpHeader);
-                NS_LOG_DEBUG(this << "SegmentedRlcSdu = " << segmentedRlcsdu->GetSize()
-                                  << " SEQ = " << pdcpHeader.GetSequenceNumber());
-                // insert the complete version of the fragmented SDU to the front of txonBuffer.
-                txonBuffer.insert(txonBuffer.begin(), segmentedRlcsdu);
-            }
-            m_x2forwardingBuffer.insert(m_x2forwardingBuffer.end(),
-                                        txonBuffer.begin(),
-                                        txonBuffer.end());
-            m_x2forwardingBufferSize += rlcAm->GetTransmittingRlcSduBufferSize() + txonBufferSize;
-
-            // Get the rlcAm
-            std::vector<Ptr<Packet>> rlcAmTxedSduBuffer = rlcAm->GetTxedRlcSduBuffer();
-            LtePdcpHeader pdcpHeader_1;
-            m_x2forwardingBuffer.at(0)->PeekHeader(pdcpHeader_1);
-            uint16_t i = 0;
-            for (std::vector<Ptr<Packet>>::iterator it = rlcAmTxedSduBuffer.begin();
-                 it != rlcAmTxedSduBuffer.end();
-                 ++it)
-            {
-                if ((*it) != NULL)
-                {
-                    (*it)->PeekHeader(pdcpHeader);
-                    NS_LOG_DEBUG("rlcAmTxedSduBuffer SEQ = " << pdcpHeader.GetSequenceNumber()
-                                                             << " Size = " << (*it)->GetSize());
-
-                    // add the previous SDU of the forwarding buffer to the forwarding buffer.
-                    if (pdcpHeader.GetSequenceNumber() >= (pdcpHeader_1.GetSequenceNumber() - 2) &&
-                        pdcpHeader.GetSequenceNumber() <= (pdcpHeader_1.GetSequenceNumber()))
-                    {
-                        NS_LOG_DEBUG("Added previous SDU to forwarding buffer SEQ = "
-                                     << pdcpHeader.GetSequenceNumber()
-                                     << " Size = " << (*it)->GetSize());
-                        m_x2forwardingBuffer.insert(m_x2forwardingBuffer.begin() + i,
-                                                    (*it)->Copy());
-                        ++i;
-                    }
-                }
-            }
-        }
-        else
-        { // TransmittingBuffer is empty. Only copy TxonBuffer.
-            NS_LOG_DEBUG(this << " ADDING TXONBUFFER OF RLC AM " << m_rnti
-                              << " Size = " << txonBufferSize);
-            m_x2forwardingBuffer = txonBuffer;
-            m_x2forwardingBufferSize += txonBufferSize;
-        }
-        //}
+        // Move the SDUs buffered in RLC AM (the ones of its txed and retx PDUs, then its
+        // txonBuffer) to the X2 forwarding buffer.
+        NS_LOG_DEBUG(this << " Detaching the buffers of RLC AM " << m_rnti);
+        m_x2forwardingBufferSize +=
+            rlc->GetObject<LteRlcAm>()->DetachBuffers(m_x2forwardingBuffer);
     }
     // For RlcUM, no forwarding available as the simulator itself (seamless HO).
     // However, as the LTE-UMTS book, PDCP txbuffer should be forwarded for seamless
@@ -1130,17 +931,17 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc,
     // be correct).
     else if (rlc->GetObject<LteRlcUm>())
     {
-        // Copy lte-rlc-um.m_txOnBuffer to X2 forwarding buffer.
-        NS_LOG_DEBUG(this << " Copying txonBuffer from RLC UM " << m_rnti);
-        m_x2forwardingBuffer = rlc->GetObject<LteRlcUm>()->GetTxBuffer();
-        m_x2forwardingBufferSize = rlc->GetObject<LteRlcUm>()->GetTxBufferSize();
+        // Move lte-rlc-um.m_txBuffer to X2 forwarding buffer.
+        NS_LOG_DEBUG(this << " Detaching txBuffer of RLC UM " << m_rnti);
+        m_x2forwardingBufferSize +=
+            rlc->GetObject<LteRlcUm>()->DetachTxBuffer(m_x2forwardingBuffer);
     }
     else if (rlc->GetObject<LteRlcUmLowLat>())
     {
-        // Copy lte-rlc-um-low-lat.m_txOnBuffer to X2 forwarding buffer.
-        NS_LOG_DEBUG(this << " Copying txonBuffer from RLC UM " << m_rnti);
-        m_x2forwardingBuffer = rlc->GetObject<LteRlcUmLowLat>()->GetTxBuffer();
-        m_x2forwardingBufferSize = rlc->GetObject<LteRlcUmLowLat>()->GetTxBufferSize();
+        // Move lte-rlc-um-low-lat.m_txBuffer to X2 forwarding buffer.
+        NS_LOG_DEBUG(this << " Detaching txBuffer of RLC UM " << m_rnti);
+        m_x2forwardingBufferSize +=
+            rlc->GetObject<LteRlcUmLowLat>()->DetachTxBuffer(m_x2forwardingBuffer);
     }
     // LteRlcAm m_txBuffer stores PDCP "PDU".
     NS_LOG_DEBUG(this << " m_x2forw buffer size = " << m_x2forwardingBufferSize);
@@ -1158,25 +959,23 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc,
                       "happened!");
     }
 
+    // the packets forwarded over X2 are sent as a single batch
+    EpcX2SapProvider::UeDataBatchParams params;
+    params.sourceCellId = m_rrc->m_cellId;
+    params.targetCellId = m_targetCellId;
+    params.gtpTeid = gtpTeid;
+    params.ueData.reserve(m_x2forwardingBuffer.size());
+    NS_LOG_DEBUG(this << " Forwarding m_x2forwardingBuffer to target eNB, gtpTeid = " << gtpTeid);
+
     while (!m_x2forwardingBuffer.empty())
     {
-        NS_LOG_DEBUG(this << " Forwarding m_x2forwardingBuffer to target eNB, gtpTeid = "
-                          << gtpTeid);
-        EpcX2Sap::UeDataParams params;
-        params.sourceCellId = m_rrc->m_cellId;
-        params.targetCellId = m_targetCellId;
-        params.gtpTeid = gtpTeid;
         // Remove tags to get PDCP SDU from PDCP PDU.
-        // Ptr<Packet> rlcSdu =  (*(m_x2forwardingBuffer.begin()))->Copy();
-        Ptr<Packet> rlcSdu = m_x2forwardingBuffer.at(0);
-        // Tags to be removed from rlcSdu (from outer to inner)
-        // LteRlcSduStatusTag rlcSduStatusTag;
-        // RlcTag  rlcTag; //rlc layer timestamp
-        // PdcpTag pdcpTag;  //pdcp layer timestamp
+        Ptr<Packet> rlcSdu = std::move(m_x2forwardingBuffer.front());
+        m_x2forwardingBuffer.pop_front();
+        m_x2forwardingBufferSize -= std::min(m_x2forwardingBufferSize, rlcSdu->GetSize());
         LtePdcpHeader pdcpHeader;
 
         NS_LOG_DEBUG("RlcSdu size = " << rlcSdu->GetSize());
-        // rlcSdu->RemoveHeader(pdcpHeader); //remove pdcp header
 
         // only forward data PDCP PDUs (1-DATA_PDU,0-CTR_PDU)
         if (rlcSdu->GetSize() >= 3)
@@ -1185,44 +984,17 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc,
             if (pdcpHeader.GetDcBit() == 1)
             { // ignore control SDU.
                 NS_LOG_LOGIC("SEQ = " << pdcpHeader.GetSequenceNumber());
-                NS_LOG_LOGIC("removed pdcp header, size = " << rlcSdu->GetSize());
 
                 rlcSdu->RemoveAllPacketTags(); // this does not remove byte tags
                 NS_LOG_LOGIC("removed tags, size = " << rlcSdu->GetSize());
-                params.ueData = rlcSdu;
-                /*
-                rlcSdu->RemovePacketTag(rlcSduStatusTag); //remove Rlc status tag.
-                NS_LOG_DEBUG ("removed rlc status tag, size = " << rlcSdu->GetSize() );
-                rlcSdu->RemovePacketTag(rlcTag);  //remove Rlc timestamp
-                NS_LOG_DEBUG ("removed rlc timestamp, size = " << rlcSdu->GetSize() );
-                //rlcSdu->RemoveByteTag(pdcpTag); //remove pdcp timestamp
-                //NS_LOG_DEBUG ("removed pdcp timestamp, size = " << rlcSdu->GetSize());
-                */
 
                 if (!mcLteToMmWaveForwarding)
                 {
                     if (!mcMmToMmWaveForwarding)
                     {
                         rlcSdu->RemoveHeader(pdcpHeader); // remove pdcp header
-
-                        NS_LOG_INFO("Forward to target cell in HO");
-                        m_rrc->m_x2SapProvider->SendUeData(params);
-                        NS_LOG_LOGIC("sourceCellId = " << params.sourceCellId);
-                        NS_LOG_LOGIC("targetCellId = " << params.targetCellId);
-                        NS_LOG_LOGIC("gtpTeid = " << params.gtpTeid);
-                        NS_LOG_LOGIC("ueData = " << params.ueData);
-                        NS_LOG_LOGIC("ueData size = " << params.ueData->GetSize());
-                    }
-                    else
-                    {
-                        NS_LOG_INFO("Forward to target cell RLC in HO");
-                        m_rrc->m_x2SapProvider->ForwardRlcPdu(params);
-                        NS_LOG_LOGIC("sourceCellId = " << params.sourceCellId);
-                        NS_LOG_LOGIC("targetCellId = " << params.targetCellId);
-                        NS_LOG_LOGIC("gtpTeid = " << params.gtpTeid);
-                        NS_LOG_LOGIC("ueData = " << params.ueData);
-                        NS_LOG_LOGIC("ueData size = " << params.ueData->GetSize());
                     }
+                    params.ueData.push_back(rlcSdu);
                 }
                 else // the target eNB has no PDCP entity. Thus re-insert the packets in the
                 // LTE eNB PDCP, which will forward them to the MmWave RLC entity.
@@ -1244,10 +1016,26 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc,
         {
             NS_LOG_UNCOND("Too small, not forwarded");
         }
-        m_x2forwardingBufferSize -= (*(m_x2forwardingBuffer.begin()))->GetSize();
-        m_x2forwardingBuffer.erase(m_x2forwardingBuffer.begin());
-        NS_LOG_LOGIC(this << " After forwarding: buffer size = " << m_x2forwardingBufferSize);
     }
+
+    if (!params.ueData.empty())
+    {
+        NS_LOG_LOGIC("sourceCellId = " << params.sourceCellId);
+        NS_LOG_LOGIC("targetCellId = " << params.targetCellId);
+        NS_LOG_LOGIC("gtpTeid = " << params.gtpTeid);
+        NS_LOG_LOGIC("ueData packets = " << params.ueData.size());
+        if (!mcMmToMmWaveForwarding)
+        {
+            NS_LOG_INFO("Forward to target cell in HO");
+            m_rrc->m_x2SapProvider->SendUeDataBatch(std::move(params));
+        }
+        else
+        {
+            NS_LOG_INFO("Forward to target cell RLC in HO");
+            m_rrc->m_x2SapProvider->ForwardRlcPduBatch(std::move(params));
+        }
+    }
+    NS_LOG_LOGIC(this << " After forwarding: buffer size = " << m_x2forwardingBufferSize);
 }
 
 LteRrcSap::RadioResourceConfigDedicated
@@ -55,6 +55,7 @@
 #include <ns3/object.h>
 #include <ns3/traced-callback.h>
 
+#include <deque>
 #include <map>
 #include <set>
 #include <vector>
@@ -459,9 +460,6 @@ class UeManager : public Object
     void RecvSecondaryCellHandoverCompleted(EpcX2SapUser::SecondaryHandoverCompletedParams params);
 
   private:
-    // Lossless HO: merge 2 buffers into 1 with increment order.
-    std::vector<LteRlcAm::RetxPdu> MergeBuffers(std::vector<LteRlcAm::RetxPdu> first,
-                                                std::vector<LteRlcAm::RetxPdu> second);
     /**
      * Forward the content of RLC buffers. For RLC UM and UM LowLat, forward txBuffer.
      * For RLC AM, forward the merge of retx and txed buffers, and txBuffer
@@ -702,7 +700,7 @@ class UeManager : public Object
      */
     EventId m_handoverLeavingTimeout;
 
-    std::vector<Ptr<Packet>> m_x2forwardingBuffer;
+    std::deque<Ptr<Packet>> m_x2forwardingBuffer;
     uint32_t m_x2forwardingBufferSize;
     uint32_t m_maxx2forwardingBufferSize;
 
@@ -50,17 +50,18 @@ LteRlcAm::LteRlcAm()
 
     // Buffers
     m_txonBufferSize = 0;
-    m_retxSegBuffer.resize(1024);
-    m_retxBuffer.resize(1024);
+    m_txonBufferOffset = 0;
+    m_retxSegBuffer.fill(RetxSegPdu());
+    m_retxBuffer.fill(RetxPdu());
     m_retxBufferSize = 0;
-    m_txedBuffer.resize(1024);
+    m_txedBuffer.fill(RetxPdu());
     m_txedBufferSize = 0;
+    m_rxonBuffer.fill(PduBuffer());
 
     // LL HO
     m_transmittingRlcSduBufferSize = 0;
     m_txedRlcSduBuffer.resize(0);
     m_txedRlcSduBufferSize = 0;
-    is_fragmented = 0;
     //
 
     m_statusPduRequested = false;
@@ -209,11 +210,13 @@ LteRlcAm::DoDispose()
 
     m_txonBuffer.clear();
     m_txonBufferSize = 0;
-    m_txedBuffer.clear();
+    m_txonBufferOffset = 0;
+    m_txedBuffer.fill(RetxPdu());
     m_txedBufferSize = 0;
-    m_retxBuffer.clear();
+    m_retxBuffer.fill(RetxPdu());
+    m_retxSegBuffer.fill(RetxSegPdu());
     m_retxBufferSize = 0;
-    m_rxonBuffer.clear();
+    m_rxonBuffer.fill(PduBuffer());
     m_sdusBuffer.clear();
     m_keepS0 = 0;
     m_keepS0Reassemble = 0;
@@ -225,7 +228,6 @@ LteRlcAm::DoDispose()
     m_expectedSeqNumber = 0;
     m_transmittingRlcSduBufferSize = 0;
     m_transmittingRlcSduBuffer.clear();
-    is_fragmented = 0;
     m_txedRlcSduBuffer.clear();
     m_txedRlcSduBufferSize = 0;
 
@@ -361,7 +363,6 @@ LteRlcAm::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txOpParam
                                                    << m_vrMs.GetValue());
         SequenceNumber10 sn;
         sn.SetModulusBase(m_vrR);
-        std::map<uint16_t, PduBuffer>::iterator pduIt;
         for (sn = m_vrR; sn < m_vrMs; sn++)
         {
             NS_LOG_LOGIC("SN = " << sn);
@@ -370,8 +371,7 @@ LteRlcAm::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txOpParam
                 NS_LOG_LOGIC("Can't fit more NACKs in STATUS PDU");
                 break;
             }
-            pduIt = m_rxonBuffer.find(sn.GetValue());
-            if (pduIt == m_rxonBuffer.end() || (!(pduIt->second.m_pduComplete)))
+            if (!m_rxonBuffer.at(sn.GetValue()).m_pduComplete)
             {
                 NS_LOG_LOGIC("adding NACK_SN " << sn.GetValue());
                 rlcAmHeader.PushNack(sn.GetValue());
@@ -381,13 +381,11 @@ LteRlcAm::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txOpParam
         // 3GPP TS 36.322 section 6.2.2.1.4 ACK SN
         // find the SN of the next not received RLC Data PDU
         // which is not reported as missing in the STATUS PDU.
-        pduIt = m_rxonBuffer.find(sn.GetValue());
-        while ((sn < m_vrMs) && (pduIt != m_rxonBuffer.end()) && (pduIt->second.m_pduComplete))
+        while ((sn < m_vrMs) && (m_rxonBuffer.at(sn.GetValue()).m_pduComplete))
         {
             NS_LOG_LOGIC("SN = " << sn << " < " << m_vrMs << " = " << (sn < m_vrMs));
             sn++;
             NS_LOG_LOGIC("SN = " << sn);
-            pduIt = m_rxonBuffer.find(sn.GetValue());
         }
 
         NS_ASSERT_MSG(sn <= m_vrMs,
@@ -547,8 +545,7 @@ LteRlcAm::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txOpParam
                     }
 
                     NS_LOG_INFO("Move SN = " << seqNumberValue << " back to txedBuffer");
-                    m_txedBuffer.at(seqNumberValue).m_pdu =
-                        m_retxBuffer.at(seqNumberValue).m_pdu->Copy();
+                    m_txedBuffer.at(seqNumberValue).m_pdu = m_retxBuffer.at(seqNumberValue).m_pdu;
                     m_txedBuffer.at(seqNumberValue).m_retxCount =
                         m_retxBuffer.at(seqNumberValue).m_retxCount;
                     NS_ASSERT_MSG(m_txedBuffer.at(seqNumberValue).m_pdu,
@@ -772,20 +769,15 @@ LteRlcAm::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txOpParam
     uint32_t dataFieldAddedSize = 0;
     std::vector<Ptr<Packet>> dataField;
 
-    // Remove the first packet from the transmission buffer.
-    // If only a segment of the packet is taken, then the remaining is given back later
+    // Take the data from the first SDU of the transmission buffer.
+    // The SDU is segmented in place: it stays in the buffer until its last byte is sent, and
+    // m_txonBufferOffset counts the bytes of it sent in the previous PDUs.
     if (m_txonBuffer.size() + m_txonQueue->GetNBytes() == 0)
     {
         NS_LOG_LOGIC("No data pending");
         return;
     }
 
-    NS_LOG_LOGIC("SDUs in TxonBuffer  = " << m_txonBuffer.size());
-    NS_LOG_LOGIC("First SDU buffer  = " << *(m_txonBuffer.begin()));
-    NS_LOG_LOGIC("First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize());
-    NS_LOG_LOGIC("Next segment size = " << nextSegmentSize);
-    NS_LOG_LOGIC("Remove SDU from TxBuffer");
-
     if (m_txonBuffer.empty())
     {
         Ptr<Packet> tempP = m_txonQueue->Dequeue()->GetPacket();
@@ -793,196 +785,117 @@ LteRlcAm::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txOpParam
         m_txonBufferSize += tempP->GetSize();
     }
 
-    Ptr<Packet> firstSegment = (*(m_txonBuffer.begin()))->Copy();
+    NS_LOG_LOGIC("SDUs in TxonBuffer  = " << m_txonBuffer.size());
+    NS_LOG_LOGIC("First SDU buffer  = " << m_txonBuffer.front());
+    NS_LOG_LOGIC("First SDU size    = " << m_txonBuffer.front()->GetSize());
+    NS_LOG_LOGIC("First SDU offset  = " << m_txonBufferOffset);
+    NS_LOG_LOGIC("Next segment size = " << nextSegmentSize);
 
     // LL HO
     // tricky: store the incomplete Rlc SDU for forwarding to
     // target eNB in lossless HO. This will reduce the work of
     // reassemling the incomplete SDU later.
     Ptr<Packet> entireSdu;
-    // store complete the last complete SDU of the txonBuffer.
-    if (!is_fragmented)
+    // store the SDU if this PDU carries its first byte.
+    if (m_txonBufferOffset == 0)
     {
-        NS_LOG_DEBUG("Last complete SDU in txonBuffer size = " << firstSegment->GetSize()
+        NS_LOG_DEBUG("Last complete SDU in txonBuffer size = " << m_txonBuffer.front()->GetSize()
                                                                << " SEQ = " << m_vtS);
-        entireSdu = (*(m_txonBuffer.begin()))->Copy();
+        entireSdu = m_txonBuffer.front();
     }
 
-    m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize();
-    NS_LOG_LOGIC("txBufferSize      = " << m_txonBufferSize);
-    m_txonBuffer.erase(m_txonBuffer.begin());
-
-    while (firstSegment && (firstSegment->GetSize() > 0) && (nextSegmentSize > 0))
+    bool moreSegments = true;
+    while (moreSegments && (nextSegmentSize > 0))
     {
-        NS_LOG_LOGIC("WHILE ( firstSegment && firstSegment->GetSize > 0 && nextSegmentSize > 0 )");
-        NS_LOG_LOGIC("    firstSegment size = " << firstSegment->GetSize());
+        Ptr<Packet> sdu = m_txonBuffer.front();
+        uint32_t sduLeftSize = sdu->GetSize() - m_txonBufferOffset;
+        NS_LOG_LOGIC("WHILE ( moreSegments && nextSegmentSize > 0 )");
+        NS_LOG_LOGIC("    sdu size left     = " << sduLeftSize);
         NS_LOG_LOGIC("    nextSegmentSize   = " << nextSegmentSize);
-        if ((firstSegment->GetSize() > nextSegmentSize) ||
+
+        // Take the minimum size, due to the 2047-bytes 3GPP exception
+        // This exception is due to the length of the LI field (just 11 bits)
+        uint32_t currSegmentSize = std::min(sduLeftSize, nextSegmentSize);
+        if (currSegmentSize < sduLeftSize || sduLeftSize > 2047)
+        {
             // Segment larger than 2047 octets can only be mapped to the end of the Data field
-            (firstSegment->GetSize() > 2047))
+            NS_LOG_LOGIC("    IF ( sduLeftSize > nextSegmentSize ||");
+            NS_LOG_LOGIC("         sduLeftSize > 2047 )");
+            moreSegments = false;
+            rlcAmHeader.PushExtensionBit(LteRlcAmHeader::DATA_FIELD_FOLLOWS);
+        }
+        else if ((nextSegmentSize - sduLeftSize <= 2) ||
+                 (m_txonBuffer.size() == 1 && m_txonQueue->GetNPackets() == 0))
+        {
+            NS_LOG_LOGIC("    IF nextSegmentSize - sduLeftSize <= 2 || txonBuffer.size == 1");
+            moreSegments = false;
+            rlcAmHeader.PushExtensionBit(LteRlcAmHeader::DATA_FIELD_FOLLOWS);
+        }
+        else // (sduLeftSize < m_nextSegmentSize) && (m_txBuffer.size () > 1)
+        {
+            NS_LOG_LOGIC("    IF sduLeftSize < NextSegmentSize && txonBuffer.size > 1");
+            rlcAmHeader.PushExtensionBit(LteRlcAmHeader::E_LI_FIELDS_FOLLOWS);
+            rlcAmHeader.PushLengthIndicator(sduLeftSize);
+        }
+        // no LengthIndicator for the last one
+
+        // The SDU goes in the Data field as it is if entirely taken, otherwise only a fragment
+        // of it is created. Its status tag depends on where the fragment is in the SDU.
+        // Note: This is the only place where a PDU is segmented and
+        // therefore its status can change
+        Ptr<Packet> newSegment = sdu;
+        if (currSegmentSize < sdu->GetSize())
         {
-            // Take the minimum size, due to the 2047-bytes 3GPP exception
-            // This exception is due to the length of the LI field (just 11 bits)
-            uint32_t currSegmentSize = std::min(firstSegment->GetSize(), nextSegmentSize);
-
-            NS_LOG_LOGIC("    IF ( firstSegment > nextSegmentSize ||");
-            NS_LOG_LOGIC("         firstSegment > 2047 )");
-
-            // Segment txBuffer.FirstBuffer and
-            // Give back the remaining segment to the transmission buffer
-            Ptr<Packet> newSegment = firstSegment->CreateFragment(0, currSegmentSize);
-            // LL HO: This firstSegment is fragmented. Update the status variable.
-            is_fragmented = 1;
-
-            NS_LOG_LOGIC("    newSegment size   = " << newSegment->GetSize());
-
-            // Status tag of the new and remaining segments
-            // Note: This is the only place where a PDU is segmented and
-            // therefore its status can change
-            LteRlcSduStatusTag oldTag, newTag;
-            firstSegment->RemovePacketTag(oldTag);
+            newSegment = sdu->CreateFragment(m_txonBufferOffset, currSegmentSize);
+            LteRlcSduStatusTag newTag;
             newSegment->RemovePacketTag(newTag);
-            if (oldTag.GetStatus() == LteRlcSduStatusTag::FULL_SDU)
+            if (m_txonBufferOffset == 0)
             {
                 newTag.SetStatus(LteRlcSduStatusTag::FIRST_SEGMENT);
-                oldTag.SetStatus(LteRlcSduStatusTag::LAST_SEGMENT);
             }
-            else if (oldTag.GetStatus() == LteRlcSduStatusTag::LAST_SEGMENT)
+            else if (currSegmentSize < sduLeftSize)
             {
                 newTag.SetStatus(LteRlcSduStatusTag::MIDDLE_SEGMENT);
-                // oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-            }
-
-            // Give back the remaining segment to the transmission buffer
-            firstSegment->RemoveAtStart(currSegmentSize);
-            NS_LOG_LOGIC(
-                "    firstSegment size (after RemoveAtStart) = " << firstSegment->GetSize());
-            if (firstSegment->GetSize() > 0)
-            {
-                firstSegment->AddPacketTag(oldTag);
-
-                // LL HO Mark the first SDU is txonBuffer is fragmented. This maybe not needed.
-                is_fragmented = 1;
-
-                // m_txonBuffer.insert (m_txonBuffer.begin (), firstSegment);
-
-                if (m_txonBuffer.empty())
-                {
-                    m_txonBuffer.push_back(firstSegment);
-                }
-                else
-                {
-                    m_txonBuffer.insert(m_txonBuffer.begin(), firstSegment);
-                }
-
-                m_txonBufferSize += (*(m_txonBuffer.begin()))->GetSize();
-
-                NS_LOG_LOGIC("    Txon buffer: Give back the remaining segment");
-                NS_LOG_LOGIC("    Txon buffers = " << m_txonBuffer.size());
-                NS_LOG_LOGIC("    Front buffer size = " << (*(m_txonBuffer.begin()))->GetSize());
-                NS_LOG_LOGIC("    txonBufferSize = " << m_txonBufferSize);
             }
             else
             {
-                // Whole segment was taken, so adjust tag
-                if (newTag.GetStatus() == LteRlcSduStatusTag::FIRST_SEGMENT)
-                {
-                    newTag.SetStatus(LteRlcSduStatusTag::FULL_SDU);
-                }
-                else if (newTag.GetStatus() == LteRlcSduStatusTag::MIDDLE_SEGMENT)
-                {
-                    newTag.SetStatus(LteRlcSduStatusTag::LAST_SEGMENT);
-                }
+                newTag.SetStatus(LteRlcSduStatusTag::LAST_SEGMENT);
             }
-            // Segment is completely taken or
-            // the remaining segment is given back to the transmission buffer
-            firstSegment = 0;
-
-            // Put status tag once it has been adjusted
             newSegment->AddPacketTag(newTag);
-
-            // Add Segment to Data field
-            dataFieldAddedSize = newSegment->GetSize();
-            dataFieldTotalSize += dataFieldAddedSize;
-            dataField.push_back(newSegment);
-            newSegment = 0;
-
-            // ExtensionBit (Next_Segment - 1) = 0
-            rlcAmHeader.PushExtensionBit(LteRlcAmHeader::DATA_FIELD_FOLLOWS);
-
-            // no LengthIndicator for the last one
-
-            nextSegmentSize -= dataFieldAddedSize;
-            nextSegmentId++;
-
-            // nextSegmentSize MUST be zero (only if segment is smaller or equal to 2047)
-
-            // (NO more segments) ? exit
-            // break;
         }
-        else if ((nextSegmentSize - firstSegment->GetSize() <= 2) ||
-                 (m_txonBuffer.size() + m_txonQueue->GetNPackets() == 0))
+        NS_LOG_LOGIC("    newSegment size   = " << newSegment->GetSize());
+
+        // Add Segment to Data field
+        dataFieldAddedSize = newSegment->GetSize();
+        dataFieldTotalSize += dataFieldAddedSize;
+        dataField.push_back(newSegment);
+        nextSegmentSize -= dataFieldAddedSize;
+        if (moreSegments)
         {
-            NS_LOG_LOGIC(
-                "    IF nextSegmentSize - firstSegment->GetSize () <= 2 || txonBuffer.size == 0");
-
-            // Add txBuffer.FirstBuffer to DataField
-            dataFieldAddedSize = firstSegment->GetSize();
-            dataFieldTotalSize += dataFieldAddedSize;
-            dataField.push_back(firstSegment);
-            firstSegment = 0;
-
-            // ExtensionBit (Next_Segment - 1) = 0
-            rlcAmHeader.PushExtensionBit(LteRlcAmHeader::DATA_FIELD_FOLLOWS);
-
-            // no LengthIndicator for the last one
-
-            nextSegmentSize -= dataFieldAddedSize;
-            nextSegmentId++;
-
-            NS_LOG_LOGIC("        SDUs in TxBuffer  = " << m_txonBuffer.size());
-            if (m_txonBuffer.size() + m_txonQueue->GetNPackets() > 0)
-            {
-                NS_LOG_LOGIC("        First SDU buffer  = " << *(m_txonBuffer.begin()));
-                NS_LOG_LOGIC(
-                    "        First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize());
-            }
-            NS_LOG_LOGIC("        Next segment size = " << nextSegmentSize);
-
-            // nextSegmentSize <= 2 (only if txBuffer is not empty)
+            nextSegmentSize -= (nextSegmentId % 2) ? (2) : (1);
+        }
+        nextSegmentId++;
 
-            // (NO more segments) ? exit
-            // break;
+        m_txonBufferSize -= currSegmentSize;
+        if (currSegmentSize < sduLeftSize)
+        {
+            // the remaining segment stays in the transmission buffer
+            m_txonBufferOffset += currSegmentSize;
+            NS_LOG_LOGIC("    Txon buffer: Keep the remaining segment, offset = "
+                         << m_txonBufferOffset);
         }
-        else // (firstSegment->GetSize () < m_nextSegmentSize) && (m_txBuffer.size () > 0)
+        else
         {
-            NS_LOG_LOGIC("    IF firstSegment < NextSegmentSize && txonBuffer.size > 0");
-            // Add txBuffer.FirstBuffer to DataField
-            dataFieldAddedSize = firstSegment->GetSize();
-            dataFieldTotalSize += dataFieldAddedSize;
-            dataField.push_back(firstSegment);
-
-            // ExtensionBit (Next_Segment - 1) = 1
-            rlcAmHeader.PushExtensionBit(LteRlcAmHeader::E_LI_FIELDS_FOLLOWS);
-
-            // LengthIndicator (Next_Segment)  = txBuffer.FirstBuffer.length()
-            rlcAmHeader.PushLengthIndicator(firstSegment->GetSize());
-
-            nextSegmentSize -= ((nextSegmentId % 2) ? (2) : (1)) + dataFieldAddedSize;
-            nextSegmentId++;
-
-            NS_LOG_LOGIC("        SDUs in TxBuffer  = " << m_txonBuffer.size());
-            if (m_txonBuffer.size() + m_txonQueue->GetNPackets() > 0)
-            {
-                NS_LOG_LOGIC("        First SDU buffer  = " << *(m_txonBuffer.begin()));
-                NS_LOG_LOGIC(
-                    "        First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize());
-            }
-            NS_LOG_LOGIC("        Next segment size = " << nextSegmentSize);
-            NS_LOG_LOGIC("        Remove SDU from TxBuffer");
-
-            // (more segments)
+            NS_LOG_LOGIC("    Remove SDU from TxBuffer");
+            m_txonBuffer.pop_front();
+            m_txonBufferOffset = 0;
+        }
+        NS_LOG_LOGIC("    txonBufferSize = " << m_txonBufferSize);
+        NS_LOG_LOGIC("    Next segment size = " << nextSegmentSize);
 
+        // (more segments)
+        if (moreSegments)
+        {
             if (m_txonBuffer.empty())
             {
                 Ptr<Packet> tempP = m_txonQueue->Dequeue()->GetPacket();
@@ -990,13 +903,9 @@ LteRlcAm::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txOpParam
                 m_txonBufferSize += tempP->GetSize();
             }
 
-            firstSegment = (*(m_txonBuffer.begin()))->Copy();
-
             // LL HO
-            // New complete SDU is taken from txonBuffer so reset the
-            // status is_fragmented.
-            is_fragmented = 0;
-            m_txedRlcSduBuffer.push_back((*(m_txonBuffer.begin()))->Copy());
+            // New complete SDU is taken from txonBuffer.
+            m_txedRlcSduBuffer.push_back(m_txonBuffer.front());
             NS_LOG_DEBUG("m_txedRlcSduBuffer.size() = " << m_txedRlcSduBuffer.size());
             if (m_txedRlcSduBuffer.size() > 1024)
             {
@@ -1008,11 +917,7 @@ LteRlcAm::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txOpParam
                                                             << " after clear and resize");
             }
             // Store the last complete SDU before segmentation in txonBuffer.
-            entireSdu = (*(m_txonBuffer.begin()))->Copy();
-
-            m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize();
-            m_txonBuffer.erase(m_txonBuffer.begin());
-            NS_LOG_LOGIC("        txBufferSize = " << m_txonBufferSize);
+            entireSdu = m_txonBuffer.front();
         }
     }
 
@@ -1158,77 +1063,140 @@ LteRlcAm::DoNotifyTxOpportunity(LteMacSapUser::TxOpportunityParameters txOpParam
     m_macSapProvider->TransmitPdu(params);
 }
 
-std::vector<Ptr<Packet>>
-LteRlcAm::GetTxBuffer()
-{
-    std::vector<Ptr<Packet>> toBeReturned;
-    if (!m_enableAqm)
-    {
-        toBeReturned.insert(toBeReturned.begin(), m_txonBuffer.begin(), m_txonBuffer.end());
-        m_txonBuffer.clear();
-        m_txonBufferSize = 0;
-    }
-    else
-    {
-        while (m_txonQueue->GetNBytes() > 0)
-        {
-            toBeReturned.push_back(m_txonQueue->Dequeue()->GetPacket());
-        }
-    }
-    return toBeReturned;
-}
-
 uint32_t
 LteRlcAm::GetTxBufferSize() const
 {
     return m_txonBufferSize + m_txonQueue->GetNBytes();
 }
 
-std::vector<LteRlcAm::RetxPdu>
-LteRlcAm::GetTxedBuffer()
-{
-    // std::vector < LteRlcAm::RetxPdu > toBeReturned;
-    // toBeReturned.insert(toBeReturned.begin(), m_txedBuffer.begin(), m_txedBuffer.end());
-    return m_txedBuffer;
-}
-
 uint32_t
 LteRlcAm::GetTxedBufferSize() const
 {
     return m_txedBufferSize;
 }
 
-std::vector<LteRlcAm::RetxPdu>
-LteRlcAm::GetRetxBuffer()
-{
-    std::vector<LteRlcAm::RetxPdu> toBeReturned;
-    toBeReturned.insert(toBeReturned.begin(), m_retxBuffer.begin(), m_retxBuffer.end());
-    return toBeReturned;
-}
-
 uint32_t
 LteRlcAm::GetRetxBufferSize() const
 {
     return m_retxBufferSize;
 }
 
-std::map<uint32_t, Ptr<Packet>>
-LteRlcAm::GetTransmittingRlcSduBuffer()
-{
-    return m_transmittingRlcSduBuffer;
-    // TODO check if it must be emptied
-}
-
 uint32_t
 LteRlcAm::GetTransmittingRlcSduBufferSize() const
 {
     return m_transmittingRlcSduBufferSize;
 }
 
-Ptr<Packet>
-LteRlcAm::GetSegmentedRlcsdu()
+// LL HO
+uint32_t
+LteRlcAm::DetachBuffers(std::deque<Ptr<Packet>>& sdus)
 {
-    return m_segmented_rlcsdu;
+    NS_LOG_FUNCTION(this << m_rnti << (uint32_t)m_lcid);
+
+    // Translate the PDUs of the txed and retx buffers into RLC SDUs, in sequence number order
+    // from VT(A) to VT(S), and put them into m_transmittingRlcSduBuffer. A PDU is either in
+    // the txed or in the retx buffer.
+    NS_LOG_INFO("retxBuffer size = " << m_retxBufferSize);
+    NS_LOG_INFO("txedBuffer size = " << m_txedBufferSize);
+    if (m_retxBufferSize + m_txedBufferSize > 0)
+    {
+        std::vector<RetxPdu> unackedPdus;
+        SequenceNumber10 sn = m_vtA;
+        sn.SetModulusBase(m_vtA);
+        SequenceNumber10 vtS = m_vtS;
+        vtS.SetModulusBase(m_vtA);
+        for (; sn < vtS; sn++)
+        {
+            const RetxPdu& retxPdu = m_retxBuffer.at(sn.GetValue());
+            const RetxPdu& txedPdu = m_txedBuffer.at(sn.GetValue());
+            if (retxPdu.m_pdu)
+            {
+                unackedPdus.push_back(retxPdu);
+            }
+            else if (txedPdu.m_pdu)
+            {
+                unackedPdus.push_back(txedPdu);
+            }
+        }
+        RlcPdusToRlcSdus(unackedPdus);
+    }
+
+    size_t first = sdus.size();
+    uint32_t bytes = 0;
+    bool retransmitting = m_transmittingRlcSduBufferSize > 0;
+    if (retransmitting)
+    {
+        NS_LOG_DEBUG(this << " detach " << m_transmittingRlcSduBuffer.size()
+                          << " transmitting SDUs, size = " << m_transmittingRlcSduBufferSize);
+        for (auto& sdu : m_transmittingRlcSduBuffer)
+        {
+            if (sdu.second)
+            {
+                NS_LOG_DEBUG(this << " detach transmitting SDU SEQ = " << sdu.first);
+                sdus.push_back(std::move(sdu.second));
+            }
+        }
+        bytes += m_transmittingRlcSduBufferSize;
+        m_transmittingRlcSduBuffer.clear();
+        m_transmittingRlcSdus.clear();
+        m_transmittingRlcSduBufferSize = 0;
+
+        // the complete version of the last SDU segmented goes before the txonBuffer, unless
+        // it is still the first SDU of the txonBuffer. Its bytes are already counted with the
+        // transmitting SDUs
+        if (m_segmented_rlcsdu && m_txonBufferOffset == 0)
+        {
+            NS_LOG_DEBUG(this << " detach segmented SDU, size = " << m_segmented_rlcsdu->GetSize());
+            sdus.push_back(m_segmented_rlcsdu);
+        }
+        m_segmented_rlcsdu = nullptr;
+    }
+
+    // the first SDU of the txonBuffer is detached entirely, even if some of its bytes were
+    // already sent
+    NS_LOG_DEBUG(this << " detach txonBuffer, size = " << GetTxBufferSize()
+                      << " offset = " << m_txonBufferOffset);
+    bytes += m_txonBufferSize + m_txonBufferOffset;
+    sdus.insert(sdus.end(),
+                std::make_move_iterator(m_txonBuffer.begin()),
+                std::make_move_iterator(m_txonBuffer.end()));
+    m_txonBuffer.clear();
+    m_txonBufferSize = 0;
+    m_txonBufferOffset = 0;
+    while (m_txonQueue->GetNBytes() > 0)
+    {
+        Ptr<Packet> p = m_txonQueue->Dequeue()->GetPacket();
+        bytes += p->GetSize();
+        sdus.push_back(p);
+    }
+
+    // the SDUs transmitted just before the first one that is not acknowledged may not have
+    // been delivered either, their copies are not counted in the bytes detached
+    if (retransmitting && sdus.size() > first)
+    {
+        LtePdcpHeader firstPdcpHeader;
+        LtePdcpHeader pdcpHeader;
+        sdus.at(first)->PeekHeader(firstPdcpHeader);
+        size_t pos = first;
+        for (const Ptr<Packet>& sdu : m_txedRlcSduBuffer)
+        {
+            if (sdu)
+            {
+                sdu->PeekHeader(pdcpHeader);
+                if (pdcpHeader.GetSequenceNumber() >= (firstPdcpHeader.GetSequenceNumber() - 2) &&
+                    pdcpHeader.GetSequenceNumber() <= (firstPdcpHeader.GetSequenceNumber()))
+                {
+                    NS_LOG_DEBUG("Added previous SDU SEQ = " << pdcpHeader.GetSequenceNumber()
+                                                             << " Size = " << sdu->GetSize());
+                    sdus.insert(sdus.begin() + pos, sdu->Copy());
+                    ++pos;
+                }
+            }
+        }
+    }
+    // the SDUs of m_txedRlcSduBuffer are shared with the SDUs detached
+    m_txedRlcSduBuffer.clear();
+    return bytes;
 }
 
 /* LL HO
@@ -1811,11 +1779,12 @@ LteRlcAm::CreateRlcSduBuffer()
 
 // LL HO
 void
-LteRlcAm::RlcPdusToRlcSdus(std::vector<LteRlcAm::RetxPdu> RlcPdus)
+LteRlcAm::RlcPdusToRlcSdus(const std::vector<LteRlcAm::RetxPdu>& RlcPdus)
 {
     NS_LOG_DEBUG(this << "in RlcPdusTo...");
     uint16_t isGotExpectedSeqNumber = 0;
-    for (std::vector<LteRlcAm::RetxPdu>::iterator it = RlcPdus.begin(); it != RlcPdus.end(); it++)
+    for (std::vector<LteRlcAm::RetxPdu>::const_iterator it = RlcPdus.begin(); it != RlcPdus.end();
+         it++)
     {
         if (!(it->m_pdu))
         {
@@ -2011,11 +1980,10 @@ LteRlcAm::DoReceivePdu(LteMacSapUser::ReceivePduParameters rxPduParams)
             //         - discard the duplicate byte segments.
             // note: re-segmentation of AMD PDU is currently not supported,
             // so we just check that the segment was not received before
-            std::map<uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find(seqNumber.GetValue());
-            if (it != m_rxonBuffer.end())
+            PduBuffer& pduBuffer = m_rxonBuffer.at(seqNumber.GetValue());
+            if (!pduBuffer.m_byteSegments.empty())
             {
-                NS_ASSERT(it->second.m_byteSegments.size() > 0);
-                // NS_ASSERT_MSG (it->second.m_byteSegments.size () == 1, "re-segmentation not
+                // NS_ASSERT_MSG (pduBuffer.m_byteSegments.size () == 1, "re-segmentation not
                 // supported");
                 NS_LOG_LOGIC("Received duplicate SN");
 
@@ -2024,8 +1992,8 @@ LteRlcAm::DoReceivePdu(LteMacSapUser::ReceivePduParameters rxPduParams)
                     NS_LOG_LOGIC("Received PDU segment");
                     // unsigned totalBytes = 0;
                     std::list<Ptr<Packet>>::iterator itSeg;
-                    //                for (itSeg = it->second.m_byteSegments.begin ();
-                    //                    itSeg != it->second.m_byteSegments.end (); itSeg++)
+                    //                for (itSeg = pduBuffer.m_byteSegments.begin ();
+                    //                    itSeg != pduBuffer.m_byteSegments.end (); itSeg++)
                     //                {
                     //                  totalBytes += (*itSeg)->GetSize ();
                     //                }
@@ -2034,39 +2002,39 @@ LteRlcAm::DoReceivePdu(LteMacSapUser::ReceivePduParameters rxPduParams)
                                 << rlcAmHeader.GetSegmentOffset() << " size= "
                                 << rlcAmHeader.GetLastOffset() - rlcAmHeader.GetSegmentOffset());
                     LteRlcAmHeader lastSegHdr;
-                    it->second.m_byteSegments.back()->PeekHeader(lastSegHdr);
+                    pduBuffer.m_byteSegments.back()->PeekHeader(lastSegHdr);
                     if (rlcAmHeader.GetSegmentOffset() == lastSegHdr.GetLastOffset() ||
                         rlcAmHeader.GetSegmentOffset() + 32768 == lastSegHdr.GetLastOffset())
                     {
                         // segment is next in sequence
-                        it->second.m_byteSegments.push_back(rxPduParams.p);
+                        pduBuffer.m_byteSegments.push_back(rxPduParams.p);
                         if (rlcAmHeader.GetLastSegmentFlag() == LteRlcAmHeader::LAST_PDU_SEGMENT)
                         {
                             // got last segment, reassemble segments
-                            it->second.m_pduComplete = true;
-                            NS_ASSERT(it->second.m_byteSegments.size() > 1);
-                            itSeg = it->second.m_byteSegments.begin();
+                            pduBuffer.m_pduComplete = true;
+                            NS_ASSERT(pduBuffer.m_byteSegments.size() > 1);
+                            itSeg = pduBuffer.m_byteSegments.begin();
                             itSeg++;
-                            for (; itSeg != it->second.m_byteSegments.end(); itSeg++)
+                            for (; itSeg != pduBuffer.m_byteSegments.end(); itSeg++)
                             {
                                 LteRlcAmHeader segHdr;
                                 (*itSeg)->RemoveHeader(segHdr);
                                 // totalBytes = segHdr.PopLengthIndicator ();
-                                it->second.m_byteSegments.front()->AddAtEnd(*itSeg);
+                                pduBuffer.m_byteSegments.front()->AddAtEnd(*itSeg);
                             }
                             // now delete all fragments after the first whole data field
-                            itSeg = it->second.m_byteSegments.begin();
+                            itSeg = pduBuffer.m_byteSegments.begin();
                             itSeg++;
-                            it->second.m_byteSegments.erase(itSeg, it->second.m_byteSegments.end());
+                            pduBuffer.m_byteSegments.erase(itSeg, pduBuffer.m_byteSegments.end());
                         }
                     }
                     else
                     {
                         // out of order segment, discard both received packet and buffered
-                        // it->second.m_byteSegments.clear ();
-                        if (it->second.m_pduComplete == false)
+                        // pduBuffer.m_byteSegments.clear ();
+                        if (pduBuffer.m_pduComplete == false)
                         {
-                            m_rxonBuffer.erase(it);
+                            pduBuffer = PduBuffer();
                             NS_LOG_LOGIC("PDU segment received out of order, discarding");
                         }
                     }
@@ -2077,7 +2045,7 @@ LteRlcAm::DoReceivePdu(LteMacSapUser::ReceivePduParameters rxPduParams)
                 if (rlcAmHeader.GetSegmentOffset() == 0)
                 {
                     NS_LOG_LOGIC("Place PDU in the reception buffer ( SN = " << seqNumber << " )");
-                    m_rxonBuffer[seqNumber.GetValue()].m_byteSegments.push_back(rxPduParams.p);
+                    pduBuffer.m_byteSegments.push_back(rxPduParams.p);
                     if (rlcAmHeader.GetResegmentationFlag() == LteRlcAmHeader::SEGMENT)
                     {
                         NS_LOG_INFO("RLC AM PDU segment received, offset= "
@@ -2085,11 +2053,11 @@ LteRlcAm::DoReceivePdu(LteMacSapUser::ReceivePduParameters rxPduParams)
                                     << rlcAmHeader.GetLastOffset() -
                                            rlcAmHeader.GetSegmentOffset());
                         // received segment
-                        m_rxonBuffer[seqNumber.GetValue()].m_pduComplete = false;
+                        pduBuffer.m_pduComplete = false;
                     }
                     else
                     {
-                        m_rxonBuffer[seqNumber.GetValue()].m_pduComplete = true;
+                        pduBuffer.m_pduComplete = true;
                     }
                 }
             }
@@ -2112,14 +2080,12 @@ LteRlcAm::DoReceivePdu(LteMacSapUser::ReceivePduParameters rxPduParams)
         //     - update VR(MS) to the SN of the first AMD PDU with SN > current VR(MS) for
         //       which not all byte segments have been received;
 
-        std::map<uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find(m_vrMs.GetValue());
-        if (it != m_rxonBuffer.end() && it->second.m_pduComplete)
+        if (m_rxonBuffer.at(m_vrMs.GetValue()).m_pduComplete)
         {
             int firstVrMs = m_vrMs.GetValue();
-            while (it != m_rxonBuffer.end() && it->second.m_pduComplete)
+            while (m_rxonBuffer.at(m_vrMs.GetValue()).m_pduComplete)
             {
                 m_vrMs++;
-                it = m_rxonBuffer.find(m_vrMs.GetValue());
                 NS_LOG_LOGIC("Incr VR(MS) = " << m_vrMs);
 
                 NS_ASSERT_MSG(firstVrMs != m_vrMs.GetValue(), "Infinite loop in RxonBuffer");
@@ -2139,25 +2105,23 @@ LteRlcAm::DoReceivePdu(LteMacSapUser::ReceivePduParameters rxPduParams)
 
         if (seqNumber == m_vrR)
         {
-            std::map<uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find(seqNumber.GetValue());
-            if (it != m_rxonBuffer.end() && it->second.m_pduComplete)
+            if (m_rxonBuffer.at(seqNumber.GetValue()).m_pduComplete)
             {
-                it = m_rxonBuffer.find(m_vrR.GetValue());
                 int firstVrR = m_vrR.GetValue();
-                while (it != m_rxonBuffer.end() && it->second.m_pduComplete)
+                while (m_rxonBuffer.at(m_vrR.GetValue()).m_pduComplete)
                 {
                     NS_LOG_LOGIC("Reassemble and Deliver ( SN = " << m_vrR << " )");
-                    NS_ASSERT_MSG(it->second.m_byteSegments.size() == 1,
+                    PduBuffer& pduBuffer = m_rxonBuffer.at(m_vrR.GetValue());
+                    NS_ASSERT_MSG(pduBuffer.m_byteSegments.size() == 1,
                                   "Too many segments. PDU Reassembly process didn't work");
-                    ReassembleAndDeliver(it->second.m_byteSegments.front());
-                    m_rxonBuffer.erase(m_vrR.GetValue());
+                    ReassembleAndDeliver(pduBuffer.m_byteSegments.front());
+                    pduBuffer = PduBuffer();
 
                     m_vrR++;
                     m_vrR.SetModulusBase(m_vrR);
                     m_vrX.SetModulusBase(m_vrR);
                     m_vrMs.SetModulusBase(m_vrR);
                     m_vrH.SetModulusBase(m_vrR);
-                    it = m_rxonBuffer.find(m_vrR.GetValue());
 
                     NS_ASSERT_MSG(firstVrR != m_vrR.GetValue(), "Infinite loop in RxonBuffer");
                 }
@@ -2245,8 +2209,7 @@ LteRlcAm::DoReceivePdu(LteMacSapUser::ReceivePduParameters rxPduParams)
                 if (m_txedBuffer.at(seqNumberValue).m_pdu)
                 {
                     NS_LOG_INFO("Move SN = " << seqNumberValue << " to retxBuffer");
-                    m_retxBuffer.at(seqNumberValue).m_pdu =
-                        m_txedBuffer.at(seqNumberValue).m_pdu->Copy();
+                    m_retxBuffer.at(seqNumberValue).m_pdu = m_txedBuffer.at(seqNumberValue).m_pdu;
                     m_retxBuffer.at(seqNumberValue).m_retxCount =
                         m_txedBuffer.at(seqNumberValue).m_retxCount;
                     m_retxBufferSize += m_retxBuffer.at(seqNumberValue).m_pdu->GetSize();
@@ -2900,11 +2863,9 @@ LteRlcAm::ExpireReorderingTimer(void)
 
     m_vrMs = m_vrX;
     int firstVrMs = m_vrMs.GetValue();
-    std::map<uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find(m_vrMs.GetValue());
-    while (it != m_rxonBuffer.end() && it->second.m_pduComplete)
+    while (m_rxonBuffer.at(m_vrMs.GetValue()).m_pduComplete)
     {
         m_vrMs++;
-        it = m_rxonBuffer.find(m_vrMs.GetValue());
 
         NS_ASSERT_MSG(firstVrMs != m_vrMs.GetValue(), "Infinite loop in ExpireReorderingTimer");
     }
@@ -2959,7 +2920,7 @@ LteRlcAm::ExpirePollRetransmitTimer(void)
                 if (pduAvailable)
                 {
                     NS_LOG_INFO("Move PDU " << sn << " from txedBuffer to retxBuffer");
-                    m_retxBuffer.at(sn).m_pdu = m_txedBuffer.at(sn).m_pdu->Copy();
+                    m_retxBuffer.at(sn).m_pdu = m_txedBuffer.at(sn).m_pdu;
                     m_retxBuffer.at(sn).m_retxCount = m_txedBuffer.at(sn).m_retxCount;
                     m_retxBufferSize += m_retxBuffer.at(sn).m_pdu->GetSize();
 
@@ -2972,14 +2933,14 @@ LteRlcAm::ExpirePollRetransmitTimer(void)
         else // If overflow happened, we retransmit from acked sequence to 1023, then from 0 to sent
              // sequence.
         {
-            for (sn = m_vtA.GetValue(); sn < 1024; sn++)
+            for (sn = m_vtA.GetValue(); sn < SN_SPACE; sn++)
             {
                 bool pduAvailable = (bool)m_txedBuffer.at(sn).m_pdu;
 
                 if (pduAvailable)
                 {
                     NS_LOG_INFO("Move PDU " << sn << " from txedBuffer to retxBuffer");
-                    m_retxBuffer.at(sn).m_pdu = m_txedBuffer.at(sn).m_pdu->Copy();
+                    m_retxBuffer.at(sn).m_pdu = m_txedBuffer.at(sn).m_pdu;
                     m_retxBuffer.at(sn).m_retxCount = m_txedBuffer.at(sn).m_retxCount;
                     m_retxBufferSize += m_retxBuffer.at(sn).m_pdu->GetSize();
 
@@ -2996,7 +2957,7 @@ LteRlcAm::ExpirePollRetransmitTimer(void)
                 if (pduAvailable)
                 {
                     NS_LOG_INFO("Move PDU " << sn << " from txedBuffer to retxBuffer");
-                    m_retxBuffer.at(sn).m_pdu = m_txedBuffer.at(sn).m_pdu->Copy();
+                    m_retxBuffer.at(sn).m_pdu = m_txedBuffer.at(sn).m_pdu;
                     m_retxBuffer.at(sn).m_retxCount = m_txedBuffer.at(sn).m_retxCount;
                     m_retxBufferSize += m_retxBuffer.at(sn).m_pdu->GetSize();
 
@@ -34,6 +34,8 @@
 #include <ns3/lte-rlc-sequence-number.h>
 #include <ns3/lte-rlc.h>
 
+#include <array>
+#include <deque>
 #include <fstream>
 #include <map>
 #include <string>
@@ -63,6 +65,9 @@ class LteRlcAm : public LteRlc
         uint16_t m_retxCount;
     };
 
+    /// Size of the 10 bit sequence number space, and of the windows indexed by sequence number
+    static constexpr uint16_t SN_SPACE = 1024;
+
     /**
      * RLC SAP
      *
@@ -76,31 +81,29 @@ class LteRlcAm : public LteRlc
     virtual void DoSendMcPdcpSdu(EpcX2Sap::UeDataParams params);
 
     // LL HO
-    std::vector<Ptr<Packet>> GetTxBuffer();
     uint32_t GetTxBufferSize() const;
-
-    std::vector<RetxPdu> GetTxedBuffer();
     uint32_t GetTxedBufferSize() const;
-
-    std::vector<RetxPdu> GetRetxBuffer();
     uint32_t GetRetxBufferSize() const;
-
-    std::map<uint32_t, Ptr<Packet>> GetTransmittingRlcSduBuffer();
     uint32_t GetTransmittingRlcSduBufferSize() const;
 
-    Ptr<Packet> GetSegmentedRlcsdu();
-    ///< translate a vector of Rlc PDUs to Rlc SDUs
-    ///< and put the Rlc SDUs into m_transmittingRlcSdus.
-    void RlcPdusToRlcSdus(std::vector<RetxPdu> Pdus);
-
-    std::vector<Ptr<Packet>> GetTxedRlcSduBuffer()
-    {
-        return m_txedRlcSduBuffer;
-    }
+    /**
+     * Move the SDUs buffered in the entity out of it, e.g., to forward them to the target
+     * cell at handover: the SDUs of the PDUs that were transmitted but not acknowledged, in
+     * sequence number order, then the SDU being segmented and the SDUs not transmitted yet.
+     * The SDUs are moved, not copied, and the entity no longer holds them. The PDUs in the
+     * transmitted and retransmission buffers stay in the entity, which may still receive
+     * their status. If some PDUs were not acknowledged, copies of the last SDUs transmitted
+     * before the first of them are put in front, as they may not have been delivered either.
+     *
+     * \param [out] sdus the queue the SDUs are appended to
+     * \return the number of bytes of the SDUs appended, without the copies put in front
+     */
+    uint32_t DetachBuffers(std::deque<Ptr<Packet>>& sdus);
 
   private:
-    // whether the last SDU in the txonBuffer is a complete SDU.
-    bool is_fragmented;
+    ///< translate a vector of Rlc PDUs to Rlc SDUs
+    ///< and put the Rlc SDUs into m_transmittingRlcSdus.
+    void RlcPdusToRlcSdus(const std::vector<RetxPdu>& Pdus);
 
     //
     std::vector<Ptr<Packet>> m_txedRlcSduBuffer;
@@ -178,7 +181,8 @@ class LteRlcAm : public LteRlc
     void BufferSizeTrace();
 
   private:
-    std::vector<Ptr<Packet>> m_txonBuffer; ///< Transmission buffer
+    std::deque<Ptr<Packet>> m_txonBuffer; ///< Transmission buffer
+    uint32_t m_txonBufferOffset; ///< bytes of the first SDU of m_txonBuffer sent in previous PDUs
 
     struct RetxSegPdu
     {
@@ -193,11 +197,12 @@ class LteRlcAm : public LteRlc
     // to assure no packet is lost.
     Ptr<Packet> m_segmented_rlcsdu;
 
-    std::vector<RetxPdu> m_txedBuffer;       ///< Buffer for transmitted and retransmitted PDUs
-                                             ///< that have not been acked but are not considered
-                                             ///< for retransmission
-    std::vector<RetxPdu> m_retxBuffer;       ///< Buffer for PDUs considered for retransmission
-    std::vector<RetxSegPdu> m_retxSegBuffer; // buffer for AM PDU segments
+    std::array<RetxPdu, SN_SPACE> m_txedBuffer; ///< Buffer for transmitted and retransmitted PDUs
+                                                ///< that have not been acked but are not
+                                                ///< considered for retransmission, indexed by SN
+    std::array<RetxPdu, SN_SPACE> m_retxBuffer; ///< Buffer for PDUs considered for
+                                                ///< retransmission, indexed by SN
+    std::array<RetxSegPdu, SN_SPACE> m_retxSegBuffer; // buffer for AM PDU segments, indexed by SN
 
     Ptr<CoDelQueueDisc> m_txonQueue;
 
@@ -225,7 +230,9 @@ class LteRlcAm : public LteRlc
         uint16_t m_currSize;
     };
 
-    std::map<uint16_t, PduBuffer> m_rxonBuffer; ///< Reception buffer
+    /// Reception buffer, indexed by SN. The PDU with a given SN was received, entirely or in
+    /// part, if the entry holds byte segments.
+    std::array<PduBuffer, SN_SPACE> m_rxonBuffer;
 
     Ptr<Packet> m_controlPduBuffer; ///< Control PDU buffer (just one PDU)
 
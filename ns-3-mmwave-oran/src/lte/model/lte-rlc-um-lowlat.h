@@ -67,7 +67,14 @@ class LteRlcUmLowLat : public LteRlc
     virtual void DoNotifyHarqDeliveryFailure();
     virtual void DoReceivePdu(LteMacSapUser::ReceivePduParameters params);
 
-    std::vector<Ptr<Packet>> GetTxBuffer();
+    /**
+     * Move the SDUs of the transmission buffer out of the entity, e.g., to forward them to
+     * the target cell at handover, leaving the buffer empty
+     *
+     * \param [out] sdus the queue the SDUs are appended to, in order
+     * \return the number of bytes of the SDUs appended
+     */
+    uint32_t DetachTxBuffer(std::deque<Ptr<Packet>>& sdus);
 
     uint32_t GetTxBufferSize()
     {
@@ -440,10 +440,17 @@ LteRlcUm::DoNotifyHarqDeliveryFailure()
     NS_LOG_FUNCTION(this);
 }
 
-std::vector<Ptr<Packet>>
-LteRlcUm::GetTxBuffer()
+uint32_t
+LteRlcUm::DetachTxBuffer(std::deque<Ptr<Packet>>& sdus)
 {
-    return m_txBuffer;
+    NS_LOG_FUNCTION(this << m_rnti << (uint32_t)m_lcid << m_txBufferSize);
+    uint32_t bytes = m_txBufferSize;
+    sdus.insert(sdus.end(),
+                std::make_move_iterator(m_txBuffer.begin()),
+                std::make_move_iterator(m_txBuffer.end()));
+    m_txBuffer.clear();
+    m_txBufferSize = 0;
+    return bytes;
 }
 
 void
@@ -30,6 +30,7 @@
 #include <ns3/epc-x2-sap.h>
 #include <ns3/event-id.h>
 
+#include <deque>
 #include <map>
 
 namespace ns3
@@ -73,7 +74,14 @@ class LteRlcUm : public LteRlc
     virtual void DoNotifyHarqDeliveryFailure();
     virtual void DoReceivePdu(LteMacSapUser::ReceivePduParameters rxPduParams);
 
-    std::vector<Ptr<Packet>> GetTxBuffer();
+    /**
+     * Move the SDUs of the transmission buffer out of the entity, e.g., to forward them to
+     * the target cell at handover, leaving the buffer empty
+     *
+     * \param [out] sdus the queue the SDUs are appended to, in order
+     * \return the number of bytes of the SDUs appended
+     */
+    uint32_t DetachTxBuffer(std::deque<Ptr<Packet>>& sdus);
 
     uint32_t GetTxBufferSize()
     {
@@ -1577,79 +1577,6 @@ LteUeRrc::DoRecvRrcConnectionSwitch(LteRrcSap::RrcConnectionSwitch msg)
     }
 }
 
-/*
- * Merge 2 buffers of RlcAmPdus into 1 vector with increment order of Pdus
- */
-std::vector<LteRlcAm::RetxPdu>
-LteUeRrc::MergeBuffers(std::vector<LteRlcAm::RetxPdu> first, std::vector<LteRlcAm::RetxPdu> second)
-{
-    LteRlcAmHeader rlcamHeader_1, rlcamHeader_2;
-    std::vector<LteRlcAm::RetxPdu> result;
-    std::vector<LteRlcAm::RetxPdu>::iterator it_1 = first.begin();
-    std::vector<LteRlcAm::RetxPdu>::iterator it_2 = second.begin();
-    bool end_1_reached = false;
-    bool end_2_reached = false;
-    while (it_1 != first.end() && it_2 != second.end())
-    {
-        while (!((*it_1).m_pdu))
-        {
-            ++it_1;
-            if (it_1 == first.end())
-            {
-                end_1_reached = true;
-                break;
-            }
-        }
-        while (!((*it_2).m_pdu))
-        {
-            ++it_2;
-            if (it_2 == second.end())
-            {
-                end_2_reached = true;
-                break;
-            }
-        }
-        if (!end_1_reached && !end_2_reached)
-        {
-            (*it_1).m_pdu->PeekHeader(rlcamHeader_1);
-            (*it_2).m_pdu->PeekHeader(rlcamHeader_2);
-            if (rlcamHeader_1.GetSequenceNumber() > rlcamHeader_2.GetSequenceNumber())
-            {
-                result.push_back((*it_2));
-                ++it_2;
-            }
-            else if (rlcamHeader_2.GetSequenceNumber() > rlcamHeader_1.GetSequenceNumber())
-            {
-                result.push_back((*it_1));
-                ++it_1;
-            }
-            else
-            {
-                result.push_back((*it_1));
-                ++it_1;
-                ++it_2;
-            }
-            NS_LOG_DEBUG("first,second = " << rlcamHeader_1.GetSequenceNumber() << ","
-                                           << rlcamHeader_2.GetSequenceNumber());
-        }
-        else
-        {
-            break;
-        }
-    }
-    while (it_1 != first.end())
-    {
-        result.push_back((*it_1));
-        it_1++;
-    }
-    while (it_2 != second.end())
-    {
-        result.push_back((*it_2));
-        it_2++;
-    }
-    return result;
-}
-
 // This code from the LL HO implementation is refactored in a function
 // in order to be used also when switching from LTE to MmWave and back
 void
@@ -1658,140 +1585,11 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
     // RlcBuffers forwarding only for RlcAm bearers.
     if (rlc->GetObject<LteRlcAm>())
     {
-        // Copy lte-rlc-am.m_txOnBuffer to X2 forwarding buffer.
-        Ptr<LteRlcAm> rlcAm = rlc->GetObject<LteRlcAm>();
-        uint32_t txonBufferSize = rlcAm->GetTxBufferSize();
-        std::vector<Ptr<Packet>> txonBuffer = rlcAm->GetTxBuffer();
-        // m_rlcBufferToBeForwardedSize =
-        // drbIt->second->m_rlc->GetObject<LteRlcAm>()->GetTxBufferSize(); m_rlcBufferToBeForwarded
-        // = drbIt->second->m_rlc->GetObject<LteRlcAm>()->GetTxBuffer();
-        uint32_t txedBufferSize = rlcAm->GetTxedBufferSize();
-        std::vector<LteRlcAm::RetxPdu> txedBuffer = rlcAm->GetTxedBuffer();
-        uint32_t retxBufferSize = rlcAm->GetRetxBufferSize();
-        std::vector<LteRlcAm::RetxPdu> retxBuffer = rlcAm->GetRetxBuffer();
-
-        // Translate Pdus in Rlc txed/retx buffer into RLC Sdus
-        // and put these Sdus into rlcAm->m_transmittingRlcSdus.
-        NS_LOG_INFO("UE RRC: retxBuffer size = " << retxBufferSize);
-        NS_LOG_INFO("UE RRC: txedBuffer size = " << txedBufferSize);
-        // Merge txed and retx buffers into a single buffer before doing RlcPdusToRlc.
-        if (retxBufferSize + txedBufferSize > 0)
-        {
-            std::vector<LteRlcAm::RetxPdu> sortedTxedRetxBuffer;
-            if (retxBufferSize == 0)
-            {
-                sortedTxedRetxBuffer = txedBuffer;
-            }
-            else if (txedBufferSize == 0)
-            {
-                sortedTxedRetxBuffer = retxBuffer;
-            }
-            else
-            {
-                sortedTxedRetxBuffer = MergeBuffers(txedBuffer, retxBuffer);
-            }
-            rlcAm->RlcPdusToRlcSdus(sortedTxedRetxBuffer);
-        }
-
-        // Construct the forwarding buffer
-        // Forwarding buffer = retxBuffer + txedBuffer + txonBuffer.
-        // if ( txonBufferSize > 0 )
-        //{
-        LtePdcpHeader pdcpHeader;
-        uint32_t pos = 0;
-        for (std::vector<Ptr<Packet>>::iterator it = txonBuffer.begin(); it != txonBuffer.end();
-             ++it)
-        {
-            pos++;
-            if ((*it)->GetSize() > 3)
-            {
-                (*it)->PeekHeader(pdcpHeader);
-                NS_LOG_DEBUG("UE RRC: txonBuffer SEQ = " << pdcpHeader.GetSequenceNumber()
-                                                         << " Size = " << (*it)->GetSize());
-            }
-            else
-            {
-                NS_LOG_UNCOND("UE RRC: Fragment too small in txonBuffer, pos " << pos);
-            }
-        }
-
-        // this cycle adds the SDUs given by the merge of txed and retxed buffers
-        if (rlcAm->GetTransmittingRlcSduBufferSize() > 0)
-        { // something inside the RLC AM's transmitting buffer
-            NS_LOG_DEBUG(
-                "UE RRC: ADDING TRANSMITTING SDUS OF RLC AM TO X2FORWARDINGBUFFER... Size = "
-                << rlcAm->GetTransmittingRlcSduBufferSize());
-            // copy the RlcSdu buffer (map) to forwardingBuffer.
-            std::map<uint32_t, Ptr<Packet>> rlcAmTransmittingBuffer =
-                rlcAm->GetTransmittingRlcSduBuffer();
-            NS_LOG_DEBUG("UE RRC:  *** SIZE = " << rlcAmTransmittingBuffer.size());
-            for (std::map<uint32_t, Ptr<Packet>>::iterator it = rlcAmTransmittingBuffer.begin();
-                 it != rlcAmTransmittingBuffer.end();
-                 ++it)
-            {
-                if (it->second)
-                {
-                    NS_LOG_DEBUG(this << " add to forwarding buffer SEQ = " << it->first
-                                      << " Ptr<Packet> = " << it->second);
-                    m_rlcBufferToBeForwarded.push_back(it->second);
-                }
-            }
-            NS_LOG_DEBUG(this << "UE RRC:  ADDING TXONBUFFER OF RLC AM " << m_rnti
-                              << " Size = " << txonBufferSize);
-
-            Ptr<Packet> segmentedRlcsdu = rlcAm->GetSegmentedRlcsdu();
-            if (segmentedRlcsdu != NULL)
-            {
-                segmentedRlcsdu->PeekHeader(pdcpHeader);
-                NS_LOG_DEBUG(this << "UE RRC: SegmentedRlcSdu = " << segmentedRlcsdu->GetSize()
-                                  << " SEQ = " << pdcpHeader.GetSequenceNumber());
-                // insert the complete version of the fragmented SDU to the front of txonBuffer.
-                txonBuffer.insert(txonBuffer.begin(), segmentedRlcsdu);
-            }
-            m_rlcBufferToBeForwarded.insert(m_rlcBufferToBeForwarded.end(),
-                                            txonBuffer.begin(),
-                                            txonBuffer.end());
-            m_rlcBufferToBeForwardedSize +=
-                rlcAm->GetTransmittingRlcSduBufferSize() + txonBufferSize;
-
-            // Get the rlcAm
-            std::vector<Ptr<Packet>> rlcAmTxedSduBuffer = rlcAm->GetTxedRlcSduBuffer();
-            LtePdcpHeader pdcpHeader_1;
-            m_rlcBufferToBeForwarded.at(0)->PeekHeader(pdcpHeader_1);
-            uint16_t i = 0;
-            for (std::vector<Ptr<Packet>>::iterator it = rlcAmTxedSduBuffer.begin();
-                 it != rlcAmTxedSduBuffer.end();
-                 ++it)
-            {
-                if ((*it) != NULL)
-                {
-                    (*it)->PeekHeader(pdcpHeader);
-                    NS_LOG_DEBUG("UE RRC: rlcAmTxedSduBuffer SEQ = "
-                                 << pdcpHeader.GetSequenceNumber()
-                                 << " Size = " << (*it)->GetSize());
-
-                    // add the previous SDU of the forwarding buffer to the forwarding buffer.
-                    if (pdcpHeader.GetSequenceNumber() >= (pdcpHeader_1.GetSequenceNumber() - 2) &&
-                        pdcpHeader.GetSequenceNumber() <= (pdcpHeader_1.GetSequenceNumber()))
-                    {
-                        NS_LOG_DEBUG("UE RRC: Added previous SDU to forwarding buffer SEQ = "
-                                     << pdcpHeader.GetSequenceNumber()
-                                     << " Size = " << (*it)->GetSize());
-                        m_rlcBufferToBeForwarded.insert(m_rlcBufferToBeForwarded.begin() + i,
-                                                        (*it)->Copy());
-                        ++i;
-                    }
-                }
-            }
-        }
-        else
-        { // TransmittingBuffer is empty. Only copy TxonBuffer.
-            NS_LOG_DEBUG(this << " UE RRC: ADDING TXONBUFFER OF RLC AM " << m_rnti
-                              << " Size = " << txonBufferSize);
-            m_rlcBufferToBeForwarded = txonBuffer;
-            m_rlcBufferToBeForwardedSize += txonBufferSize;
-        }
-        //}
+        // Move the SDUs buffered in RLC AM (the ones of its txed and retx PDUs, then its
+        // txonBuffer) to the forwarding buffer.
+        NS_LOG_DEBUG(this << " UE RRC: Detaching the buffers of RLC AM " << m_rnti);
+        m_rlcBufferToBeForwardedSize +=
+            rlc->GetObject<LteRlcAm>()->DetachBuffers(m_rlcBufferToBeForwarded);
     }
     // For RlcUM, no forwarding available as the simulator itself (seamless HO).
     // However, as the LTE-UMTS book, PDCP txbuffer should be forwarded for seamless
@@ -1799,17 +1597,17 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
     // be correct).
     else if (rlc->GetObject<LteRlcUm>())
     {
-        // Copy lte-rlc-um.m_txOnBuffer to X2 forwarding buffer.
-        NS_LOG_DEBUG(this << " UE RRC: Copying txonBuffer from RLC UM " << m_rnti);
-        m_rlcBufferToBeForwarded = rlc->GetObject<LteRlcUm>()->GetTxBuffer();
-        m_rlcBufferToBeForwardedSize = rlc->GetObject<LteRlcUm>()->GetTxBufferSize();
+        // Move lte-rlc-um.m_txBuffer to the forwarding buffer.
+        NS_LOG_DEBUG(this << " UE RRC: Detaching txBuffer of RLC UM " << m_rnti);
+        m_rlcBufferToBeForwardedSize +=
+            rlc->GetObject<LteRlcUm>()->DetachTxBuffer(m_rlcBufferToBeForwarded);
     }
     else if (rlc->GetObject<LteRlcUmLowLat>())
     {
-        // Copy lte-rlc-um-low-lat.m_txOnBuffer to X2 forwarding buffer.
-        NS_LOG_DEBUG(this << " UE RRC: Copying txonBuffer from RLC UM " << m_rnti);
-        m_rlcBufferToBeForwarded = rlc->GetObject<LteRlcUmLowLat>()->GetTxBuffer();
-        m_rlcBufferToBeForwardedSize = rlc->GetObject<LteRlcUmLowLat>()->GetTxBufferSize();
+        // Move lte-rlc-um-low-lat.m_txBuffer to the forwarding buffer.
+        NS_LOG_DEBUG(this << " UE RRC: Detaching txBuffer of RLC UM " << m_rnti);
+        m_rlcBufferToBeForwardedSize +=
+            rlc->GetObject<LteRlcUmLowLat>()->DetachTxBuffer(m_rlcBufferToBeForwarded);
     }
     // LteRlcAm m_txBuffer stores PDCP "PDU".
     NS_LOG_DEBUG(this << " UE RRC: m_x2forw buffer size = " << m_rlcBufferToBeForwardedSize);
@@ -1820,8 +1618,9 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
         NS_LOG_DEBUG(this << " UE RRC: Forwarding m_rlcBufferToBeForwarded to target eNB, lcid = "
                           << lcid);
         // Remove tags to get PDCP SDU from PDCP PDU.
-        // Ptr<Packet> rlcSdu =  (*(m_rlcBufferToBeForwarded.begin()))->Copy();
-        Ptr<Packet> rlcSdu = m_rlcBufferToBeForwarded.at(0);
+        Ptr<Packet> rlcSdu = std::move(m_rlcBufferToBeForwarded.front());
+        m_rlcBufferToBeForwarded.pop_front();
+        m_rlcBufferToBeForwardedSize -= std::min(m_rlcBufferToBeForwardedSize, rlcSdu->GetSize());
         // Tags to be removed from rlcSdu (from outer to inner)
         // LteRlcSduStatusTag rlcSduStatusTag;
         // RlcTag  rlcTag; //rlc layer timestamp
@@ -1864,8 +1663,6 @@ LteUeRrc::CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid)
         {
             NS_LOG_UNCOND("UE RRC: Too small, not forwarded");
         }
-        m_rlcBufferToBeForwardedSize -= (*(m_rlcBufferToBeForwarded.begin()))->GetSize();
-        m_rlcBufferToBeForwarded.erase(m_rlcBufferToBeForwarded.begin());
         NS_LOG_LOGIC(this << " UE RRC: After forwarding: buffer size = "
                           << m_rlcBufferToBeForwardedSize);
     }
@@ -45,6 +45,7 @@
 #include <ns3/packet.h>
 #include <ns3/traced-callback.h>
 
+#include <deque>
 #include <map>
 #include <set>
 #include <vector>
@@ -752,9 +753,6 @@ class LteUeRrc : public Object
      * @params lcid
      */
     void CopyRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint16_t lcid);
-    // Lossless HO: merge 2 buffers into 1 with increment order.
-    std::vector<LteRlcAm::RetxPdu> MergeBuffers(std::vector<LteRlcAm::RetxPdu> first,
-                                                std::vector<LteRlcAm::RetxPdu> second);
 
     std::map<uint8_t, uint8_t> m_bid2DrbidMap; ///< bid to DR bid map
 
@@ -1248,7 +1246,7 @@ class LteUeRrc : public Object
     bool m_ncRaStarted;
 
     // lossless HO
-    std::vector<Ptr<Packet>> m_rlcBufferToBeForwarded;
+    std::deque<Ptr<Packet>> m_rlcBufferToBeForwarded;
     uint32_t m_rlcBufferToBeForwardedSize;
 
   public:
@@ -0,0 +1,279 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/e2-control-action.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <thread>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Checks the parsing of the control actions from the lines of the CSV
+ * control files and from the JSON configurations of the xApp, which have to
+ * give the same actions.
+ */
+class E2ControlActionParseTestCase : public TestCase
+{
+  public:
+    E2ControlActionParseTestCase()
+        : TestCase("Parse the control actions of the CSV files and of the JSON configurations")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        E2ControlAction action;
+        NS_TEST_ASSERT_MSG_EQ(E2ControlAction::ParseCsvLine(E2ControlAction::HANDOVER,
+                                                            "120,111000000000001,1112",
+                                                            action),
+                              true,
+                              "Valid handover line rejected");
+        NS_TEST_ASSERT_MSG_EQ(action.m_timestamp, 120, "Wrong timestamp");
+        NS_TEST_ASSERT_MSG_EQ(action.m_imsi, 111000000000001ULL, "Wrong IMSI");
+        NS_TEST_ASSERT_MSG_EQ(action.m_cellId, 1112, "Wrong target cell");
+        NS_TEST_ASSERT_MSG_EQ(
+            E2ControlAction::ParseCsvLine(E2ControlAction::QOS, "5,2,0.25\r", action),
+            true,
+            "Valid QoS line rejected");
+        NS_TEST_ASSERT_MSG_EQ(action.m_rnti, 2, "Wrong RNTI");
+        NS_TEST_ASSERT_MSG_EQ(action.m_value, 0.25, "Wrong percentage");
+        NS_TEST_ASSERT_MSG_EQ(
+            E2ControlAction::ParseCsvLine(E2ControlAction::CBR, "5,50Mbps,", action),
+            true,
+            "Valid CBR line rejected");
+        NS_TEST_ASSERT_MSG_EQ(action.m_dataRate, "50Mbps", "Wrong data rate");
+        NS_TEST_ASSERT_MSG_EQ(action.m_packetSize, 0, "Wrong packet size");
+
+        for (const char* line : {"", "5,2", "x,2,0.5", "5,2,1.5", "5,-2,0.5", "5,2,0.5x"})
+        {
+            NS_TEST_ASSERT_MSG_EQ(E2ControlAction::ParseCsvLine(E2ControlAction::QOS, line, action),
+                                  false,
+                                  "Invalid QoS line '" << line << "' accepted");
+        }
+        NS_TEST_ASSERT_MSG_EQ(
+            E2ControlAction::ParseCsvLine(E2ControlAction::HANDOVER, "5,1,70000", action),
+            false,
+            "Handover to an invalid cell accepted");
+
+        E2ControlAction::Type type;
+        NS_TEST_ASSERT_MSG_EQ(E2ControlAction::GetTypeFromFileName("/tmp/ue_txpower_actions.csv",
+                                                                   type),
+                              true,
+                              "Control file not recognized");
+        NS_TEST_ASSERT_MSG_EQ(type, E2ControlAction::UE_TX_POWER, "Wrong type of control file");
+        NS_TEST_ASSERT_MSG_EQ(E2ControlAction::GetTypeFromFileName("/tmp/xue_txpower_actions.csv",
+                                                                   type),
+                              false,
+                              "Unknown file recognized");
+
+        NS_TEST_ASSERT_MSG_EQ(E2ControlAction::UeIdToRnti("111000000000002"), 2, "Wrong RNTI");
+        NS_TEST_ASSERT_MSG_EQ(E2ControlAction::UeIdToRnti("7"), 7, "Wrong RNTI");
+        NS_TEST_ASSERT_MSG_EQ(E2ControlAction::UeIdToRnti("abc"), 0, "Invalid UE id accepted");
+
+        // the JSON configuration gives the actions of the CSV lines the xApp writes
+        struct Config
+        {
+            const char* json;              //!< the configuration
+            E2ControlAction::Type type;    //!< the type of its actions
+            std::vector<const char*> csv;  //!< the equivalent CSV lines
+        };
+        std::vector<Config> configs = {
+            {R"({"type": "qos", "commands": [{"ueId": "111000000000001", "percentage": 0.7},
+                {"ueId":"111000000000002","percentage":0.5}]})",
+             E2ControlAction::QOS,
+             {"0,1,0.7", "0,2,0.5"}},
+            {R"({"type":"handover","commands":[{"imsi":"111000000000001","targetCellId":"1112"}]})",
+             E2ControlAction::HANDOVER,
+             {"0,111000000000001,1112"}},
+            {R"({"type":"energy","commands":[{"cellId":"1112","hoAllowed":0},
+                {"cellId":"1113","hoAllowed":true}]})",
+             E2ControlAction::HO_ALLOWED,
+             {"0,1112,0", "0,1113,1"}},
+            {R"({"type":"set-enb-txpower","commands":[{"cellId":"1112","dbm":43.0}]})",
+             E2ControlAction::ENB_TX_POWER,
+             {"0,1112,43.0"}},
+            {R"({"type":"set-ue-txpower","commands":[{"ueId":"111000000000002","dbm":15}]})",
+             E2ControlAction::UE_TX_POWER,
+             {"0,2,15"}},
+            {R"({"type":"set-cbr","rate":"50Mbps","pktBytes":1200})",
+             E2ControlAction::CBR,
+             {"0,50Mbps,1200"}},
+            {R"({"type":"cap-ue-prb","timestamp":30,"commands":[{"ueId":"111000000000001",
+                "maxPrb":10},{"ueId":"bad","maxPrb":5}]})",
+             E2ControlAction::PRB_CAP,
+             {"30,1,10"}},
+        };
+        for (const Config& config : configs)
+        {
+            std::vector<E2ControlAction> actions;
+            NS_TEST_ASSERT_MSG_EQ(E2ControlAction::ParseConfig(config.json, actions),
+                                  config.csv.size(),
+                                  "Wrong number of actions in " << config.json);
+            for (std::size_t i = 0; i < config.csv.size(); i++)
+            {
+                E2ControlAction expected;
+                NS_TEST_ASSERT_MSG_EQ(
+                    E2ControlAction::ParseCsvLine(config.type, config.csv[i], expected),
+                    true,
+                    "Valid line rejected");
+                const E2ControlAction& a = actions[i];
+                NS_TEST_ASSERT_MSG_EQ(a.m_type, expected.m_type, "Wrong type");
+                NS_TEST_ASSERT_MSG_EQ(a.m_timestamp, expected.m_timestamp, "Wrong timestamp");
+                NS_TEST_ASSERT_MSG_EQ(a.m_imsi, expected.m_imsi, "Wrong IMSI");
+                NS_TEST_ASSERT_MSG_EQ(a.m_rnti, expected.m_rnti, "Wrong RNTI");
+                NS_TEST_ASSERT_MSG_EQ(a.m_cellId, expected.m_cellId, "Wrong cell");
+                NS_TEST_ASSERT_MSG_EQ(a.m_value, expected.m_value, "Wrong value");
+                NS_TEST_ASSERT_MSG_EQ(a.m_dataRate, expected.m_dataRate, "Wrong data rate");
+                NS_TEST_ASSERT_MSG_EQ(a.m_packetSize, expected.m_packetSize, "Wrong packet size");
+                NS_TEST_ASSERT_MSG_EQ(a.m_maxPrb, expected.m_maxPrb, "Wrong PRB cap");
+            }
+        }
+
+        std::vector<E2ControlAction> actions;
+        for (const char* json : {R"({"cmd":"stop"})",
+                                 R"({"type":"unknown","commands":[]})",
+                                 R"({"type":"qos"})",
+                                 R"({"type":"set-cbr"})"})
+        {
+            NS_TEST_ASSERT_MSG_EQ(E2ControlAction::ParseConfig(json, actions),
+                                  0,
+                                  "Actions found in " << json);
+        }
+    }
+};
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Checks that the actions pushed to E2ControlActionQueue by other
+ * threads are drained once, in order, at the simulation time they are pushed
+ * at, and that the actions beyond the capacity are dropped.
+ */
+class E2ControlActionQueueTestCase : public TestCase
+{
+  public:
+    E2ControlActionQueueTestCase()
+        : TestCase("Drain the control actions pushed by other threads")
+    {
+    }
+
+  private:
+    /**
+     * Push actions from another thread, as the E2 termination does, and
+     * schedule the drain if needed
+     * \param numActions the number of actions
+     * \param firstTimestamp the timestamp of the first action, incremented
+     *        for the following ones
+     */
+    void PushFromThread(uint32_t numActions, int64_t firstTimestamp)
+    {
+        std::thread producer([this, numActions, firstTimestamp]() {
+            for (uint32_t i = 0; i < numActions; i++)
+            {
+                std::vector<E2ControlAction> actions(1);
+                actions[0].m_type = E2ControlAction::QOS;
+                actions[0].m_timestamp = firstTimestamp + i;
+                bool drainNeeded = false;
+                m_queue.Push(actions, drainNeeded);
+                if (drainNeeded)
+                {
+                    m_numDrainsScheduled++;
+                    Simulator::ScheduleWithContext(Simulator::NO_CONTEXT,
+                                                   Seconds(0),
+                                                   &E2ControlActionQueueTestCase::Drain,
+                                                   this);
+                }
+            }
+        });
+        producer.join();
+    }
+
+    /// Drain the queue and record the actions
+    void Drain()
+    {
+        std::vector<E2ControlAction> actions;
+        m_queue.PopAll(actions);
+        m_drainTimes.push_back(Simulator::Now());
+        for (const E2ControlAction& action : actions)
+        {
+            m_timestamps.push_back(action.m_timestamp);
+        }
+    }
+
+    void DoRun() override
+    {
+        m_queue.SetCapacity(8);
+        Simulator::Schedule(MilliSeconds(10),
+                            &E2ControlActionQueueTestCase::PushFromThread,
+                            this,
+                            5,
+                            0);
+        Simulator::Schedule(MilliSeconds(20),
+                            &E2ControlActionQueueTestCase::PushFromThread,
+                            this,
+                            12,
+                            100);
+        Simulator::Stop(MilliSeconds(50));
+        Simulator::Run();
+        Simulator::Destroy();
+
+        NS_TEST_ASSERT_MSG_EQ(m_numDrainsScheduled, 2, "One drain per burst expected");
+        NS_TEST_ASSERT_MSG_EQ(m_drainTimes.size(), 2, "Wrong number of drains");
+        NS_TEST_ASSERT_MSG_EQ(m_drainTimes[0], MilliSeconds(10), "Actions applied late");
+        NS_TEST_ASSERT_MSG_EQ(m_drainTimes[1], MilliSeconds(20), "Actions applied late");
+        NS_TEST_ASSERT_MSG_EQ(m_timestamps.size(), 13, "Wrong number of drained actions");
+        for (uint32_t i = 0; i < m_timestamps.size(); i++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(m_timestamps[i],
+                                  static_cast<int64_t>(i < 5 ? i : 100 + i - 5),
+                                  "Actions drained out of order");
+        }
+        NS_TEST_ASSERT_MSG_EQ(m_queue.GetNumDropped(), 4, "Wrong number of dropped actions");
+        NS_TEST_ASSERT_MSG_EQ(m_queue.GetSize(), 0, "Actions left in the queue");
+    }
+
+    E2ControlActionQueue m_queue;        //!< the queue
+    uint32_t m_numDrainsScheduled{0};    //!< number of drains scheduled by the producers
+    std::vector<Time> m_drainTimes;      //!< the times of the drains
+    std::vector<int64_t> m_timestamps;   //!< the timestamps of the drained actions
+};
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief E2 control action test suite
+ */
+class E2ControlActionTestSuite : public TestSuite
+{
+  public:
+    E2ControlActionTestSuite()
+        : TestSuite("lte-e2-control-action", UNIT)
+    {
+        AddTestCase(new E2ControlActionParseTestCase, TestCase::QUICK);
+        AddTestCase(new E2ControlActionQueueTestCase, TestCase::QUICK);
+    }
+};
+
+static E2ControlActionTestSuite g_e2ControlActionTestSuite; //!< the test suite
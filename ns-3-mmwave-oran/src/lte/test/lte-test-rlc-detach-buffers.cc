@@ -0,0 +1,411 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/lte-mac-sap.h"
+#include "ns3/lte-pdcp-header.h"
+#include "ns3/lte-rlc-am-header.h"
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-rlc-sap.h"
+#include "ns3/lte-rlc-um.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+const uint32_t SDU_SIZE = 1000; //!< the size of the PDCP PDUs queued in the entities
+const uint32_t NUM_SDUS = 10;   //!< the number of PDCP PDUs queued in the entities
+
+/// MAC SAP provider discarding the PDUs of the RLC entity
+class DetachMacSapProvider : public LteMacSapProvider
+{
+  public:
+    void TransmitPdu(TransmitPduParameters params) override
+    {
+    }
+
+    void ReportBufferStatus(ReportBufferStatusParameters params) override
+    {
+    }
+};
+
+/// RLC SAP user of the RLC entity, which receives nothing
+class DetachRlcSapUser : public LteRlcSapUser
+{
+  public:
+    void ReceivePdcpPdu(Ptr<Packet> p) override
+    {
+    }
+};
+
+/**
+ * Set up an RLC entity and queue NUM_SDUS PDCP PDUs of SDU_SIZE bytes in it, with PDCP SNs
+ * from 0
+ *
+ * \param rlc the entity
+ * \param macSapProvider the MAC SAP provider of the entity
+ * \param rlcSapUser the RLC SAP user of the entity
+ */
+void
+SetupRlc(Ptr<LteRlc> rlc, LteMacSapProvider* macSapProvider, LteRlcSapUser* rlcSapUser)
+{
+    rlc->SetRnti(1);
+    rlc->SetLcId(3);
+    rlc->SetLteMacSapProvider(macSapProvider);
+    rlc->SetLteRlcSapUser(rlcSapUser);
+
+    LteRlcSapProvider::TransmitPdcpPduParameters params;
+    params.rnti = 1;
+    params.lcid = 3;
+    for (uint16_t sn = 0; sn < NUM_SDUS; ++sn)
+    {
+        LtePdcpHeader pdcpHeader;
+        pdcpHeader.SetDcBit(LtePdcpHeader::DATA_PDU);
+        pdcpHeader.SetSequenceNumber(sn);
+        params.pdcpPdu = Create<Packet>(SDU_SIZE - pdcpHeader.GetSerializedSize());
+        params.pdcpPdu->AddHeader(pdcpHeader);
+        rlc->GetLteRlcSapProvider()->TransmitPdcpPdu(params);
+    }
+}
+
+/**
+ * Give a transmission opportunity to an RLC entity
+ *
+ * \param rlc the entity
+ * \param bytes the size of the opportunity
+ */
+void
+NotifyTxOpportunity(Ptr<LteRlc> rlc, uint32_t bytes)
+{
+    LteMacSapUser::TxOpportunityParameters txOpParams;
+    txOpParams.bytes = bytes;
+    txOpParams.layer = 0;
+    txOpParams.harqId = 0;
+    txOpParams.componentCarrierId = 0;
+    txOpParams.rnti = 1;
+    txOpParams.lcid = 3;
+    rlc->GetLteMacSapUser()->NotifyTxOpportunity(txOpParams);
+}
+
+/**
+ * Get the PDCP SNs of the SDUs detached from an RLC entity
+ *
+ * \param sdus the SDUs
+ * \return the PDCP SNs, -1 for the SDU fragments without a PDCP header
+ */
+std::vector<int>
+GetPdcpSns(const std::deque<Ptr<Packet>>& sdus)
+{
+    std::vector<int> sns;
+    for (const Ptr<Packet>& sdu : sdus)
+    {
+        LtePdcpHeader pdcpHeader;
+        if (sdu->GetSize() == SDU_SIZE && sdu->PeekHeader(pdcpHeader))
+        {
+            sns.push_back(pdcpHeader.GetSequenceNumber());
+        }
+        else
+        {
+            sns.push_back(-1);
+        }
+    }
+    return sns;
+}
+
+/**
+ * Format a list of PDCP SNs
+ *
+ * \param sns the SNs
+ * \return the SNs, separated by spaces
+ */
+std::string
+FormatSns(const std::vector<int>& sns)
+{
+    std::string str;
+    for (int sn : sns)
+    {
+        str += (str.empty() ? "" : " ") + std::to_string(sn);
+    }
+    return str;
+}
+
+} // namespace
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Checks that LteRlcAm::DetachBuffers forwards the SDUs in the order, and reports
+ * the bytes, that the handover forwarding got from the getters of the RLC AM buffers
+ * before the buffers were detached: the SDUs of the PDUs not acknowledged, including the
+ * complete version of the last SDU segmented even if it is also among them, then the SDUs
+ * not transmitted yet. The bytes do not count the SDU segmented again.
+ *
+ * The getters forwarded the remainder of an SDU partially transmitted, which has no PDCP
+ * header, while the SDU is detached whole, once, and counted whole.
+ */
+class LteRlcAmDetachBuffersTestCase : public TestCase
+{
+  public:
+    /// An event of the entity before its buffers are detached
+    struct Step
+    {
+        uint32_t m_txOpportunity; //!< the size of a transmission opportunity, 0 for a STATUS PDU
+        uint16_t m_ackSn;         //!< the ACK_SN of the STATUS PDU
+        std::vector<uint16_t> m_nackSns; //!< the NACK_SNs of the STATUS PDU
+    };
+
+    /**
+     * Constructor
+     *
+     * \param name the name of the scenario
+     * \param steps the events of the entity before its buffers are detached
+     * \param sns the PDCP SNs of the SDUs expected
+     * \param bytes the number of bytes expected
+     */
+    LteRlcAmDetachBuffersTestCase(std::string name,
+                                  std::vector<Step> steps,
+                                  std::vector<int> sns,
+                                  uint32_t bytes)
+        : TestCase("Detach the buffers of RLC AM: " + name),
+          m_steps(steps),
+          m_sns(sns),
+          m_bytes(bytes)
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        DetachMacSapProvider macSapProvider;
+        DetachRlcSapUser rlcSapUser;
+        Ptr<LteRlcAm> rlc = CreateObject<LteRlcAm>();
+        rlc->SetAttribute("BufferSizeFilename", StringValue("/dev/null"));
+        SetupRlc(rlc, &macSapProvider, &rlcSapUser);
+
+        for (const Step& step : m_steps)
+        {
+            if (step.m_txOpportunity > 0)
+            {
+                NotifyTxOpportunity(rlc, step.m_txOpportunity);
+                continue;
+            }
+            LteRlcAmHeader status;
+            status.SetControlPdu(LteRlcAmHeader::STATUS_PDU);
+            status.SetAckSn(SequenceNumber10(step.m_ackSn));
+            for (uint16_t nackSn : step.m_nackSns)
+            {
+                status.PushNack(nackSn);
+            }
+            LteMacSapUser::ReceivePduParameters rxPduParams;
+            rxPduParams.p = Create<Packet>();
+            rxPduParams.p->AddHeader(status);
+            rxPduParams.rnti = 1;
+            rxPduParams.lcid = 3;
+            rlc->GetLteMacSapUser()->ReceivePdu(rxPduParams);
+        }
+
+        std::deque<Ptr<Packet>> sdus;
+        uint32_t bytes = rlc->DetachBuffers(sdus);
+        NS_TEST_ASSERT_MSG_EQ(FormatSns(GetPdcpSns(sdus)),
+                              FormatSns(m_sns),
+                              "Wrong SDUs detached");
+        NS_TEST_ASSERT_MSG_EQ(bytes, m_bytes, "Wrong number of bytes detached");
+
+        NS_TEST_ASSERT_MSG_EQ(rlc->GetTxBufferSize(), 0, "SDUs left in the txonBuffer");
+        NS_TEST_ASSERT_MSG_EQ(rlc->GetTransmittingRlcSduBufferSize(),
+                              0,
+                              "SDUs left in the transmitting buffer");
+
+        rlc->Dispose();
+        Simulator::Destroy();
+    }
+
+    std::vector<Step> m_steps; //!< the events of the entity before its buffers are detached
+    std::vector<int> m_sns;    //!< the PDCP SNs of the SDUs expected
+    uint32_t m_bytes;          //!< the number of bytes expected
+};
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Checks that LteRlcUm::DetachTxBuffer forwards the SDUs of the transmission buffer
+ * in order, starting with the remainder of an SDU partially transmitted, and reports their
+ * bytes, as the handover forwarding got from LteRlcUm::GetTxBuffer and
+ * LteRlcUm::GetTxBufferSize before the buffer was detached.
+ */
+class LteRlcUmDetachTxBufferTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param name the name of the scenario
+     * \param txOpportunities the sizes of the transmission opportunities before the buffer is
+     * detached
+     * \param sns the PDCP SNs of the SDUs expected, -1 for the remainder of an SDU
+     * \param bytes the number of bytes expected
+     */
+    LteRlcUmDetachTxBufferTestCase(std::string name,
+                                   std::vector<uint32_t> txOpportunities,
+                                   std::vector<int> sns,
+                                   uint32_t bytes)
+        : TestCase("Detach the transmission buffer of RLC UM: " + name),
+          m_txOpportunities(txOpportunities),
+          m_sns(sns),
+          m_bytes(bytes)
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        DetachMacSapProvider macSapProvider;
+        DetachRlcSapUser rlcSapUser;
+        Ptr<LteRlcUm> rlc = CreateObject<LteRlcUm>();
+        SetupRlc(rlc, &macSapProvider, &rlcSapUser);
+
+        for (uint32_t txOpportunity : m_txOpportunities)
+        {
+            NotifyTxOpportunity(rlc, txOpportunity);
+        }
+
+        uint32_t txBufferSize = rlc->GetTxBufferSize();
+        std::deque<Ptr<Packet>> sdus;
+        uint32_t bytes = rlc->DetachTxBuffer(sdus);
+        NS_TEST_ASSERT_MSG_EQ(FormatSns(GetPdcpSns(sdus)),
+                              FormatSns(m_sns),
+                              "Wrong SDUs detached");
+        NS_TEST_ASSERT_MSG_EQ(bytes, m_bytes, "Wrong number of bytes detached");
+        NS_TEST_ASSERT_MSG_EQ(bytes, txBufferSize, "Bytes detached differ from the buffer size");
+        uint32_t sduBytes = 0;
+        for (const Ptr<Packet>& sdu : sdus)
+        {
+            sduBytes += sdu->GetSize();
+        }
+        NS_TEST_ASSERT_MSG_EQ(sduBytes, bytes, "Bytes detached differ from the SDUs");
+        NS_TEST_ASSERT_MSG_EQ(rlc->GetTxBufferSize(), 0, "SDUs left in the txBuffer");
+
+        rlc->Dispose();
+        Simulator::Destroy();
+    }
+
+    std::vector<uint32_t> m_txOpportunities; //!< the sizes of the transmission opportunities
+    std::vector<int> m_sns;                  //!< the PDCP SNs of the SDUs expected
+    uint32_t m_bytes;                        //!< the number of bytes expected
+};
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite of the detachment of the RLC buffers at handover
+ */
+class LteRlcDetachBuffersTestSuite : public TestSuite
+{
+  public:
+    LteRlcDetachBuffersTestSuite()
+        : TestSuite("lte-rlc-detach-buffers", UNIT)
+    {
+        // a transmission opportunity of an SDU and an RLC AM header carries one SDU whole
+        const uint32_t onePdu = SDU_SIZE + 4;
+        AddTestCase(new LteRlcAmDetachBuffersTestCase("nothing transmitted",
+                                                      {},
+                                                      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+                                                      10000),
+                    TestCase::QUICK);
+        AddTestCase(new LteRlcAmDetachBuffersTestCase(
+                        "PDUs not acknowledged",
+                        {{onePdu, 0, {}}, {onePdu, 0, {}}, {onePdu, 0, {}}},
+                        {0, 1, 2, 2, 3, 4, 5, 6, 7, 8, 9},
+                        10000),
+                    TestCase::QUICK);
+        AddTestCase(new LteRlcAmDetachBuffersTestCase(
+                        "PDUs partially acknowledged",
+                        {{onePdu, 0, {}}, {onePdu, 0, {}}, {onePdu, 0, {}}, {0, 1, {}}},
+                        {1, 2, 2, 3, 4, 5, 6, 7, 8, 9},
+                        9000),
+                    TestCase::QUICK);
+        AddTestCase(new LteRlcAmDetachBuffersTestCase(
+                        "PDUs acknowledged",
+                        {{onePdu, 0, {}}, {onePdu, 0, {}}, {onePdu, 0, {}}, {0, 3, {}}},
+                        {3, 4, 5, 6, 7, 8, 9},
+                        7000),
+                    TestCase::QUICK);
+        AddTestCase(new LteRlcAmDetachBuffersTestCase(
+                        "PDU to retransmit",
+                        {{onePdu, 0, {}},
+                         {onePdu, 0, {}},
+                         {onePdu, 0, {}},
+                         {onePdu, 0, {}},
+                         {0, 4, {1}}},
+                        {1, 3, 4, 5, 6, 7, 8, 9},
+                        7000),
+                    TestCase::QUICK);
+        AddTestCase(new LteRlcAmDetachBuffersTestCase(
+                        "two SDUs per PDU",
+                        {{2 * SDU_SIZE + 6, 0, {}}, {2 * SDU_SIZE + 6, 0, {}}},
+                        {0, 1, 2, 3, 3, 4, 5, 6, 7, 8, 9},
+                        10000),
+                    TestCase::QUICK);
+        // the getters forwarded the remainder of the SDU partially transmitted, which is now
+        // detached whole
+        AddTestCase(new LteRlcAmDetachBuffersTestCase(
+                        "SDU partially transmitted",
+                        {{onePdu, 0, {}}, {SDU_SIZE / 2, 0, {}}},
+                        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+                        10000),
+                    TestCase::QUICK);
+        AddTestCase(new LteRlcAmDetachBuffersTestCase(
+                        "SDU partially transmitted and acknowledged",
+                        {{onePdu, 0, {}}, {SDU_SIZE / 2, 0, {}}, {0, 2, {}}},
+                        {1, 2, 3, 4, 5, 6, 7, 8, 9},
+                        9000),
+                    TestCase::QUICK);
+        AddTestCase(new LteRlcAmDetachBuffersTestCase(
+                        "SDU spanning PDUs",
+                        {{SDU_SIZE + SDU_SIZE / 2, 0, {}}, {SDU_SIZE, 0, {}}},
+                        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+                        10000),
+                    TestCase::QUICK);
+
+        AddTestCase(new LteRlcUmDetachTxBufferTestCase("nothing transmitted",
+                                                       {},
+                                                       {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+                                                       10000),
+                    TestCase::QUICK);
+        AddTestCase(new LteRlcUmDetachTxBufferTestCase("SDUs transmitted",
+                                                       {SDU_SIZE + 2, SDU_SIZE + 2},
+                                                       {2, 3, 4, 5, 6, 7, 8, 9},
+                                                       8000),
+                    TestCase::QUICK);
+        AddTestCase(new LteRlcUmDetachTxBufferTestCase("SDU partially transmitted",
+                                                       {SDU_SIZE / 2},
+                                                       {-1, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+                                                       9502),
+                    TestCase::QUICK);
+    }
+};
+
+static LteRlcDetachBuffersTestSuite g_lteRlcDetachBuffersTestSuite; //!< the test suite
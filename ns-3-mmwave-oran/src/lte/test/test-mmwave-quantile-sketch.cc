@@ -0,0 +1,153 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/mmwave-quantile-sketch.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Checks the quantiles of MmWaveQuantileSketch against the exact
+ * quantiles of a heavy-tailed set of delays, also when the sketch is built
+ * by merging partial sketches.
+ */
+class MmWaveQuantileSketchAccuracyTestCase : public TestCase
+{
+  public:
+    MmWaveQuantileSketchAccuracyTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MmWaveQuantileSketchAccuracyTestCase::MmWaveQuantileSketchAccuracyTestCase()
+    : TestCase("Quantiles within the relative accuracy, merged or not")
+{
+}
+
+void
+MmWaveQuantileSketchAccuracyTestCase::DoRun()
+{
+    const double accuracy = 0.01;
+    MmWaveQuantileSketch sketch(accuracy);
+    MmWaveQuantileSketch first(accuracy);
+    MmWaveQuantileSketch second(accuracy);
+    std::vector<double> samples;
+
+    // delays in ns between 0.5 ms and about 1 s, with a long tail
+    uint32_t state = 1;
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        state = state * 1103515245 + 12345;
+        double u = ((state >> 8) % 100000 + 1) / 100001.0;
+        double delay = 5e5 / std::pow(u, 0.7);
+        samples.push_back(delay);
+        sketch.Add(delay);
+        (i % 3 ? first : second).Add(delay);
+    }
+    first.Merge(second);
+    std::sort(samples.begin(), samples.end());
+
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetCount(), samples.size(), "Wrong number of samples");
+    NS_TEST_ASSERT_MSG_EQ(first.GetCount(), samples.size(), "Wrong number of merged samples");
+    for (double q : {0.0, 0.5, 0.9, 0.95, 0.99, 0.999, 1.0})
+    {
+        double exact = samples[static_cast<std::size_t>(q * (samples.size() - 1))];
+        NS_TEST_ASSERT_MSG_EQ_TOL(sketch.GetQuantile(q),
+                                  exact,
+                                  exact * accuracy * 1.01,
+                                  "Quantile " << q << " out of the accuracy bounds");
+        NS_TEST_ASSERT_MSG_EQ_TOL(first.GetQuantile(q),
+                                  exact,
+                                  exact * accuracy * 1.01,
+                                  "Merged quantile " << q << " out of the accuracy bounds");
+    }
+
+    sketch.Reset();
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetCount(), 0, "Samples left after a reset");
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetQuantile(0.5), 0, "Empty sketch should return 0");
+    sketch.Add(0);
+    sketch.Add(0);
+    sketch.Add(1e6);
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetQuantile(0.5), 0, "Zero delays are not counted");
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetQuantile(1), 1e6, "The maximum is exact");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Checks that the memory of MmWaveQuantileSketch is bounded, and that
+ * the upper quantiles are preserved when the lowest buckets are collapsed.
+ */
+class MmWaveQuantileSketchBoundedTestCase : public TestCase
+{
+  public:
+    MmWaveQuantileSketchBoundedTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MmWaveQuantileSketchBoundedTestCase::MmWaveQuantileSketchBoundedTestCase()
+    : TestCase("Bounded number of buckets")
+{
+}
+
+void
+MmWaveQuantileSketchBoundedTestCase::DoRun()
+{
+    const uint32_t maxBins = 64;
+    MmWaveQuantileSketch sketch(0.01, maxBins);
+    // 1 ns to 1e12 ns, i.e., about 1400 buckets without collapsing
+    for (double delay = 1; delay < 1e12; delay *= 1.005)
+    {
+        sketch.Add(delay);
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(sketch.GetNumBins(), maxBins, "Too many buckets");
+    }
+    double p99 = sketch.GetQuantile(0.99);
+    double exact = std::pow(1e12, 0.99);
+    NS_TEST_ASSERT_MSG_EQ_TOL(p99, exact, exact * 0.02, "p99 lost when collapsing");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief MmWaveQuantileSketch test suite
+ */
+class MmWaveQuantileSketchTestSuite : public TestSuite
+{
+  public:
+    MmWaveQuantileSketchTestSuite();
+};
+
+MmWaveQuantileSketchTestSuite::MmWaveQuantileSketchTestSuite()
+    : TestSuite("mmwave-quantile-sketch", UNIT)
+{
+    AddTestCase(new MmWaveQuantileSketchAccuracyTestCase, TestCase::QUICK);
+    AddTestCase(new MmWaveQuantileSketchBoundedTestCase, TestCase::QUICK);
+}
+
+static MmWaveQuantileSketchTestSuite g_mmwaveQuantileSketchTestSuite; ///< the test suite
@@ -0,0 +1,134 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/mmwave-trace-sink.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Writes the same records with the TEXT and BINARY formats of
+ * MmWaveTraceSink, and checks that the binary trace converted to TSV
+ * matches the text trace.
+ */
+class MmWaveTraceSinkTestCase : public TestCase
+{
+  public:
+    MmWaveTraceSinkTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Write the test records
+     * \param format the trace format
+     * \param filename the trace file name
+     */
+    void WriteTrace(MmWaveTraceSink::Format format, const std::string& filename);
+};
+
+MmWaveTraceSinkTestCase::MmWaveTraceSinkTestCase()
+    : TestCase("Binary traces converted to TSV match the text traces")
+{
+}
+
+void
+MmWaveTraceSinkTestCase::WriteTrace(MmWaveTraceSink::Format format, const std::string& filename)
+{
+    MmWaveTraceSink sink;
+    sink.SetFormat(format);
+    // small buffer, to exercise the size threshold
+    sink.SetBufferSize(64);
+    sink.Open(filename,
+              {{"DL/UL", MmWaveTraceSink::FIELD_TAG},
+               {"time", MmWaveTraceSink::FIELD_DOUBLE},
+               {"frame", MmWaveTraceSink::FIELD_UINT32},
+               {"slot", MmWaveTraceSink::FIELD_UINT8},
+               {"rnti", MmWaveTraceSink::FIELD_UINT16},
+               {"cellId", MmWaveTraceSink::FIELD_UINT64},
+               {"offset", MmWaveTraceSink::FIELD_INT64}});
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        sink.AddTag(i % 2 ? "UL" : "DL")
+            .AddDouble(i * 0.00125)
+            .AddUint(i * 1000)
+            .AddUint(i % 8)
+            .AddUint(i + 1)
+            .AddUint(uint64_t(1) << 40)
+            .AddInt(-static_cast<int64_t>(i));
+        sink.EndRecord();
+    }
+    sink.Close();
+}
+
+void
+MmWaveTraceSinkTestCase::DoRun()
+{
+    std::string textFile = CreateTempDirFilename("trace.txt");
+    std::string binaryFile = CreateTempDirFilename("trace.bin");
+    WriteTrace(MmWaveTraceSink::TEXT, textFile);
+    WriteTrace(MmWaveTraceSink::BINARY, binaryFile);
+
+    std::ifstream text(textFile.c_str());
+    std::stringstream expected;
+    expected << text.rdbuf();
+
+    std::ifstream binary(binaryFile.c_str(), std::ios_base::binary);
+    std::ostringstream converted;
+    NS_TEST_ASSERT_MSG_EQ(MmWaveTraceSink::ConvertToText(binary, converted, '\t'),
+                          true,
+                          "The binary trace was not recognized");
+    NS_TEST_ASSERT_MSG_EQ(converted.str(), expected.str(), "Converted trace differs");
+
+    // 4 + 8 + 4 + 1 + 2 + 8 + 8 bytes per record
+    binary.clear();
+    binary.seekg(0, std::ios_base::end);
+    NS_TEST_ASSERT_MSG_GT(binary.tellg(), 100 * 35, "Records are not fixed-width");
+    NS_TEST_ASSERT_MSG_LT(binary.tellg(), 100 * 35 + 128, "Records are not fixed-width");
+
+    std::istringstream notBinary(expected.str());
+    std::ostringstream unused;
+    NS_TEST_ASSERT_MSG_EQ(MmWaveTraceSink::ConvertToText(notBinary, unused, ','),
+                          false,
+                          "A text trace was accepted as binary");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief MmWaveTraceSink test suite
+ */
+class MmWaveTraceSinkTestSuite : public TestSuite
+{
+  public:
+    MmWaveTraceSinkTestSuite();
+};
+
+MmWaveTraceSinkTestSuite::MmWaveTraceSinkTestSuite()
+    : TestSuite("mmwave-trace-sink", UNIT)
+{
+    AddTestCase(new MmWaveTraceSinkTestCase, TestCase::QUICK);
+}
+
+static MmWaveTraceSinkTestSuite g_mmwaveTraceSinkTestSuite; ///< the test suite
@@ -0,0 +1,267 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mmwave-cell-kpm-aggregator.h"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MmWaveCellKpmAggregator");
+
+namespace mmwave
+{
+
+void
+UeSpecificPhyCounters::Add(const UeSpecificPhyCounters& other)
+{
+    m_macPdu += other.m_macPdu;
+    m_macPduInitialTransmission += other.m_macPduInitialTransmission;
+    m_macPduRetransmission += other.m_macPduRetransmission;
+    m_macVolume += other.m_macVolume;
+    m_macPduQpsk += other.m_macPduQpsk;
+    m_macPdu16Qam += other.m_macPdu16Qam;
+    m_macPdu64Qam += other.m_macPdu64Qam;
+    m_macNumberOfSymbols += other.m_macNumberOfSymbols;
+    for (uint8_t i = 0; i < NUM_MCS_BINS; ++i)
+    {
+        m_macMcs[i] += other.m_macMcs[i];
+    }
+    for (uint8_t i = 0; i < NUM_SINR_BINS; ++i)
+    {
+        m_macSinrBin[i] += other.m_macSinrBin[i];
+    }
+}
+
+void
+UeSpecificPhyCounters::Subtract(const UeSpecificPhyCounters& other)
+{
+    m_macPdu -= other.m_macPdu;
+    m_macPduInitialTransmission -= other.m_macPduInitialTransmission;
+    m_macPduRetransmission -= other.m_macPduRetransmission;
+    m_macVolume -= other.m_macVolume;
+    m_macPduQpsk -= other.m_macPduQpsk;
+    m_macPdu16Qam -= other.m_macPdu16Qam;
+    m_macPdu64Qam -= other.m_macPdu64Qam;
+    m_macNumberOfSymbols -= other.m_macNumberOfSymbols;
+    for (uint8_t i = 0; i < NUM_MCS_BINS; ++i)
+    {
+        m_macMcs[i] -= other.m_macMcs[i];
+    }
+    for (uint8_t i = 0; i < NUM_SINR_BINS; ++i)
+    {
+        m_macSinrBin[i] -= other.m_macSinrBin[i];
+    }
+}
+
+uint8_t
+UeSpecificPhyCounters::GetSinrBin(double sinr)
+{
+    double sinrLog = 10 * std::log10(sinr);
+    if (sinrLog <= -6)
+    {
+        return 0;
+    }
+    else if (sinrLog <= 0)
+    {
+        return 1;
+    }
+    else if (sinrLog <= 6)
+    {
+        return 2;
+    }
+    else if (sinrLog <= 12)
+    {
+        return 3;
+    }
+    else if (sinrLog <= 18)
+    {
+        return 4;
+    }
+    else if (sinrLog <= 24)
+    {
+        return 5;
+    }
+    return 6;
+}
+
+const UeSpecificPhyCounters*
+MmWaveCellKpmAggregator::Snapshot::Find(uint16_t rnti) const
+{
+    auto it = std::lower_bound(m_ues.begin(),
+                               m_ues.end(),
+                               rnti,
+                               [](const UeSnapshot& ue, uint16_t rnti) { return ue.m_rnti < rnti; });
+    if (it != m_ues.end() && it->m_rnti == rnti)
+    {
+        return &it->m_counters;
+    }
+    return nullptr;
+}
+
+MmWaveCellKpmAggregator::MmWaveCellKpmAggregator()
+    : m_lastSnapshot(Seconds(0))
+{
+}
+
+uint32_t
+MmWaveCellKpmAggregator::GetOrCreateSlot(uint16_t rnti)
+{
+    auto slot = m_slots.find(rnti);
+    if (slot != m_slots.end())
+    {
+        return slot->second;
+    }
+    m_slots.emplace(rnti, m_ues.size());
+    m_ues.push_back(UeSlot{rnti, false, Seconds(0), UeSpecificPhyCounters{}});
+    return m_ues.size() - 1;
+}
+
+void
+MmWaveCellKpmAggregator::Update(const RxPacketTraceParams& params)
+{
+    uint32_t index = GetOrCreateSlot(params.m_rnti);
+    UeSlot& ue = m_ues[index];
+    if (!ue.m_changed)
+    {
+        ue.m_changed = true;
+        m_changed.push_back(index);
+    }
+
+    // the bins are computed once and applied to both the UE and the cell counters
+    bool initial = params.m_rv == 0;
+    uint32_t* modulation = nullptr;
+    uint32_t* cellModulation = nullptr;
+    if (params.m_mcs <= 9)
+    {
+        // MAC PDUs QPSK
+        modulation = &ue.m_counters.m_macPduQpsk;
+        cellModulation = &m_cell.m_macPduQpsk;
+    }
+    else if (params.m_mcs <= 16)
+    {
+        // MAC PDUs 16QAM
+        modulation = &ue.m_counters.m_macPdu16Qam;
+        cellModulation = &m_cell.m_macPdu16Qam;
+    }
+    else if (params.m_mcs <= 28)
+    {
+        // MAC PDUs 64QAM
+        modulation = &ue.m_counters.m_macPdu64Qam;
+        cellModulation = &m_cell.m_macPdu64Qam;
+    }
+    // MCS bins are 5 MCS wide, MCS above 29 are not counted
+    uint8_t mcsBin = params.m_mcs / 5;
+    uint8_t sinrBin = UeSpecificPhyCounters::GetSinrBin(params.m_sinr);
+
+    for (UeSpecificPhyCounters* counters : {&ue.m_counters, &m_cell})
+    {
+        counters->m_macPdu++;
+        if (initial)
+        {
+            counters->m_macPduInitialTransmission++;
+        }
+        else
+        {
+            counters->m_macPduRetransmission++;
+        }
+        counters->m_macVolume += params.m_tbSize;
+        if (mcsBin < UeSpecificPhyCounters::NUM_MCS_BINS)
+        {
+            counters->m_macMcs[mcsBin]++;
+        }
+        counters->m_macSinrBin[sinrBin]++;
+        counters->m_macNumberOfSymbols += params.m_numSym;
+    }
+    if (modulation)
+    {
+        (*modulation)++;
+        (*cellModulation)++;
+    }
+}
+
+const UeSpecificPhyCounters*
+MmWaveCellKpmAggregator::Find(uint16_t rnti) const
+{
+    auto slot = m_slots.find(rnti);
+    if (slot != m_slots.end())
+    {
+        return &m_ues[slot->second].m_counters;
+    }
+    return nullptr;
+}
+
+void
+MmWaveCellKpmAggregator::ResetUe(uint16_t rnti)
+{
+    NS_LOG_FUNCTION(this << rnti);
+    UeSlot& ue = m_ues[GetOrCreateSlot(rnti)];
+    m_cell.Subtract(ue.m_counters);
+    ue.m_counters = UeSpecificPhyCounters{};
+    ue.m_lastReset = Simulator::Now();
+}
+
+Time
+MmWaveCellKpmAggregator::GetLastResetTime(uint16_t rnti) const
+{
+    auto slot = m_slots.find(rnti);
+    if (slot != m_slots.end())
+    {
+        return std::max(m_ues[slot->second].m_lastReset, m_lastSnapshot);
+    }
+    return m_lastSnapshot;
+}
+
+void
+MmWaveCellKpmAggregator::TakeSnapshot(Snapshot& snapshot)
+{
+    NS_LOG_FUNCTION(this << m_changed.size() << m_ues.size());
+
+    std::sort(m_changed.begin(), m_changed.end(), [this](uint32_t a, uint32_t b) {
+        return m_ues[a].m_rnti < m_ues[b].m_rnti;
+    });
+
+    snapshot.m_cell = m_cell;
+    snapshot.m_ues.clear();
+    snapshot.m_ues.reserve(m_changed.size());
+    for (uint32_t index : m_changed)
+    {
+        UeSlot& ue = m_ues[index];
+        snapshot.m_ues.push_back(UeSnapshot{ue.m_rnti, ue.m_counters});
+        ue.m_counters = UeSpecificPhyCounters{};
+        ue.m_changed = false;
+    }
+    snapshot.m_window = Simulator::Now() - m_lastSnapshot;
+
+    m_changed.clear();
+    m_cell = UeSpecificPhyCounters{};
+    m_lastSnapshot = Simulator::Now();
+}
+
+uint32_t
+MmWaveCellKpmAggregator::GetNumChangedUes() const
+{
+    return m_changed.size();
+}
+
+} // namespace mmwave
+
+} // namespace ns3
@@ -0,0 +1,184 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SRC_MMWAVE_HELPER_MMWAVE_CELL_KPM_AGGREGATOR_H_
+#define SRC_MMWAVE_HELPER_MMWAVE_CELL_KPM_AGGREGATOR_H_
+
+#include <ns3/mmwave-phy-mac-common.h>
+#include <ns3/nstime.h>
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+/**
+ * UE specific counters collected by MmWavePhyTrace for E2 DU reporting.
+ * All the counters of a (RNTI, cellId) pair are kept in a single block, which
+ * is updated in place for each received TB and zeroed when the UE is reset.
+ */
+struct UeSpecificPhyCounters
+{
+    static constexpr uint8_t NUM_MCS_BINS = 6;  //!< MCS 0-4, 5-9, 10-14, 15-19, 20-24, 25-29
+    static constexpr uint8_t NUM_SINR_BINS = 7; //!< SINR bins, see GetSinrBin
+
+    uint32_t m_macPdu{0};                               //!< number of MAC PDUs
+    uint32_t m_macPduInitialTransmission{0};            //!< number of MAC PDUs (initial tx)
+    uint32_t m_macPduRetransmission{0};                 //!< number of MAC PDUs (retx)
+    uint32_t m_macVolume{0};                            //!< MAC volume (TXed bytes)
+    uint32_t m_macPduQpsk{0};                           //!< MAC PDUs with QPSK
+    uint32_t m_macPdu16Qam{0};                          //!< MAC PDUs with 16QAM
+    uint32_t m_macPdu64Qam{0};                          //!< MAC PDUs with 64QAM
+    uint32_t m_macNumberOfSymbols{0};                   //!< number of OFDM symbols
+    std::array<uint32_t, NUM_MCS_BINS> m_macMcs{};      //!< TX per MCS bin
+    std::array<uint32_t, NUM_SINR_BINS> m_macSinrBin{}; //!< TX per SINR bin
+
+    /**
+     * Add the counters of another block
+     * @param other the counters to add
+     */
+    void Add(const UeSpecificPhyCounters& other);
+
+    /**
+     * Subtract the counters of another block, which must have been added before
+     * @param other the counters to subtract
+     */
+    void Subtract(const UeSpecificPhyCounters& other);
+
+    /**
+     * Get the SINR bin of a TB: (-inf, -6], (-6, 0], (0, 6], (6, 12], (12, 18],
+     * (18, 24] and (24, inf) dB
+     * @param sinr the linear SINR
+     * @return the index of the bin
+     */
+    static uint8_t GetSinrBin(double sinr);
+};
+
+/**
+ * Cell level KPM aggregator for E2 DU reporting.
+ *
+ * Keeps, for a single cell, the counters of each UE and the running totals of
+ * the cell, both updated for each received TB, together with the list of the
+ * UEs that received a TB since the last snapshot. A DU report takes a
+ * snapshot, which copies the cell totals and the counters of the changed UEs
+ * and then zeroes them, so that its cost depends on the number of UEs that
+ * were scheduled in the reporting period and not on the number of connected
+ * UEs. The UEs that are not in the snapshot have all their counters at zero.
+ */
+class MmWaveCellKpmAggregator
+{
+  public:
+    /**
+     * Counters of a UE in a snapshot
+     */
+    struct UeSnapshot
+    {
+        uint16_t m_rnti;                  //!< RNTI of the UE
+        UeSpecificPhyCounters m_counters; //!< counters of the UE in the period
+    };
+
+    /**
+     * Counters of the cell over a reporting period
+     */
+    struct Snapshot
+    {
+        UeSpecificPhyCounters m_cell;  //!< sum of the counters of all the UEs in the period
+        std::vector<UeSnapshot> m_ues; //!< UEs that received a TB in the period, sorted by RNTI
+        Time m_window;                 //!< duration of the period
+
+        /**
+         * Find the counters of a UE
+         * @param rnti the RNTI
+         * @return the counters of the UE, or nullptr if the UE received no TB in the period
+         */
+        const UeSpecificPhyCounters* Find(uint16_t rnti) const;
+    };
+
+    MmWaveCellKpmAggregator();
+
+    /**
+     * Update the counters of the UE and of the cell with a received TB
+     * @param params the RX trace parameters of the TB
+     */
+    void Update(const RxPacketTraceParams& params);
+
+    /**
+     * Find the counters of a UE accumulated since the last reset or snapshot
+     * @param rnti the RNTI
+     * @return the counters of the UE, or nullptr if the UE has never been traced
+     */
+    const UeSpecificPhyCounters* Find(uint16_t rnti) const;
+
+    /**
+     * Zero the counters of a UE, and remove them from the cell totals
+     * @param rnti the RNTI
+     */
+    void ResetUe(uint16_t rnti);
+
+    /**
+     * Get the last time the counters of a UE were zeroed, either by ResetUe or by a snapshot
+     * @param rnti the RNTI
+     * @return the last reset time
+     */
+    Time GetLastResetTime(uint16_t rnti) const;
+
+    /**
+     * Copy the counters of the period that ends now into a snapshot, and zero them
+     * @param snapshot the snapshot to fill, whose storage is reused
+     */
+    void TakeSnapshot(Snapshot& snapshot);
+
+    /**
+     * @return the number of UEs that received a TB since the last snapshot
+     */
+    uint32_t GetNumChangedUes() const;
+
+  private:
+    /**
+     * Counters of a UE
+     */
+    struct UeSlot
+    {
+        uint16_t m_rnti;                  //!< RNTI of the UE
+        bool m_changed;                   //!< true if the UE is in m_changed
+        Time m_lastReset;                 //!< last call to ResetUe
+        UeSpecificPhyCounters m_counters; //!< counters since the last reset or snapshot
+    };
+
+    /**
+     * Get the slot of a UE, creating it if needed
+     * @param rnti the RNTI
+     * @return the index of the slot in m_ues
+     */
+    uint32_t GetOrCreateSlot(uint16_t rnti);
+
+    std::vector<UeSlot> m_ues;                      //!< dense UE slots
+    std::unordered_map<uint16_t, uint32_t> m_slots; //!< RNTI -> index in m_ues
+    std::vector<uint32_t> m_changed;                //!< slots updated since the last snapshot
+    UeSpecificPhyCounters m_cell;                   //!< running cell totals
+    Time m_lastSnapshot;                            //!< end of the last reporting period
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_HELPER_MMWAVE_CELL_KPM_AGGREGATOR_H_ */
@@ -0,0 +1,157 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mmwave-du-kpm-batch.h"
+
+#include <ns3/assert.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+MmWaveCellResourceGrid
+MmWaveCellResourceGrid::FromConfig(Ptr<MmWavePhyMacCommon> phyMacConfig)
+{
+    MmWaveCellResourceGrid grid;
+    grid.m_numRbs = phyMacConfig->GetNumRb();
+    grid.m_symbolsPerSlot = phyMacConfig->GetSymbPerSlot();
+    grid.m_slotsPerSubframe = phyMacConfig->GetSlotsPerSubframe();
+    grid.m_subframePeriod = phyMacConfig->GetSubframePeriod();
+    return grid;
+}
+
+double
+MmWaveCellResourceGrid::GetSymbolsInWindow(Time window) const
+{
+    if (m_subframePeriod.IsZero())
+    {
+        return 0;
+    }
+    // the slots are counted from the subframes, since the slot period is rounded to the ns; a
+    // slot which started in the window is counted in full
+    double slots = std::ceil(window.GetNanoSeconds() * static_cast<double>(m_slotsPerSubframe) /
+                             m_subframePeriod.GetNanoSeconds());
+    return slots * m_symbolsPerSlot;
+}
+
+double
+MmWaveCellResourceGrid::GetPrbsPerSymbol(Time window) const
+{
+    double symbols = GetSymbolsInWindow(window);
+    return symbols > 0 ? m_numRbs / symbols : 0;
+}
+
+void
+MmWaveDuKpmBatch::Clear()
+{
+    m_counters.clear();
+    m_symbols.clear();
+    m_volume.clear();
+    m_pdus.clear();
+    m_retx.clear();
+}
+
+void
+MmWaveDuKpmBatch::Add(const UeSpecificPhyCounters& counters)
+{
+    m_counters.push_back(&counters);
+    m_symbols.push_back(counters.m_macNumberOfSymbols);
+    m_volume.push_back(counters.m_macVolume);
+    // an idle UE has no retransmissions, clamping here keeps the division out of a branch
+    m_pdus.push_back(std::max<uint32_t>(counters.m_macPdu, 1));
+    m_retx.push_back(counters.m_macPduRetransmission);
+}
+
+void
+MmWaveDuKpmBatch::Compute(const MmWaveCellResourceGrid& grid, Time window)
+{
+    const std::size_t n = m_counters.size();
+    m_prb.resize(n);
+    m_throughput.resize(n);
+    m_bler.resize(n);
+
+    // the per period constants are hoisted, so that the loop has no division by
+    // the window nor branch on the UE activity
+    const double prbsPerSymbol = grid.GetPrbsPerSymbol(window);
+    const double kbitsPerByte = window.IsStrictlyPositive() ? 8e-3 / window.GetSeconds() : 0;
+
+    // one loop per KPM, each with a single input and output array, keeps the
+    // number of runtime alias checks needed by the vectoriser low
+    const double* symbols = m_symbols.data();
+    double* prb = m_prb.data();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        prb[i] = symbols[i] * prbsPerSymbol;
+    }
+
+    const double* volume = m_volume.data();
+    double* throughput = m_throughput.data();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        throughput[i] = volume[i] * kbitsPerByte;
+    }
+
+    const double* pdus = m_pdus.data();
+    const double* retx = m_retx.data();
+    double* bler = m_bler.data();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        bler[i] = retx[i] / pdus[i];
+    }
+}
+
+uint32_t
+MmWaveDuKpmBatch::GetSize() const
+{
+    return m_counters.size();
+}
+
+const UeSpecificPhyCounters&
+MmWaveDuKpmBatch::GetCounters(uint32_t i) const
+{
+    NS_ASSERT(i < m_counters.size());
+    return *m_counters[i];
+}
+
+double
+MmWaveDuKpmBatch::GetPrb(uint32_t i) const
+{
+    NS_ASSERT(i < m_prb.size());
+    return m_prb[i];
+}
+
+double
+MmWaveDuKpmBatch::GetThroughputKbps(uint32_t i) const
+{
+    NS_ASSERT(i < m_throughput.size());
+    return m_throughput[i];
+}
+
+double
+MmWaveDuKpmBatch::GetBler(uint32_t i) const
+{
+    NS_ASSERT(i < m_bler.size());
+    return m_bler[i];
+}
+
+} // namespace mmwave
+
+} // namespace ns3
@@ -0,0 +1,146 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SRC_MMWAVE_HELPER_MMWAVE_DU_KPM_BATCH_H_
+#define SRC_MMWAVE_HELPER_MMWAVE_DU_KPM_BATCH_H_
+
+#include <ns3/mmwave-cell-kpm-aggregator.h>
+#include <ns3/mmwave-phy-mac-common.h>
+#include <ns3/nstime.h>
+#include <ns3/ptr.h>
+
+#include <vector>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+/**
+ * Time-frequency resources of a cell over a reporting period, as configured by
+ * the numerology and the bandwidth of its MmWavePhyMacCommon.
+ *
+ * The mmWave PHY is TDMA, i.e., a UE scheduled in a symbol uses all the RBs of
+ * the carrier, thus the average number of PRBs used by a UE over the period is
+ * the number of its symbols over the number of symbols in the period, times
+ * the number of RBs of the carrier.
+ */
+struct MmWaveCellResourceGrid
+{
+    uint32_t m_numRbs{0};           //!< number of RBs of the carrier
+    uint32_t m_symbolsPerSlot{0};   //!< number of OFDM symbols in a slot
+    uint32_t m_slotsPerSubframe{0}; //!< number of slots in a subframe
+    Time m_subframePeriod;          //!< duration of a subframe
+
+    /**
+     * Read the current configuration of a carrier. The configuration is not
+     * cached, so that a change of bandwidth or numerology is taken into account
+     * at the next report.
+     * @param phyMacConfig the configuration of the carrier
+     * @return the resource grid
+     */
+    static MmWaveCellResourceGrid FromConfig(Ptr<MmWavePhyMacCommon> phyMacConfig);
+
+    /**
+     * @param window the duration of the reporting period
+     * @return the number of OFDM symbols in the period
+     */
+    double GetSymbolsInWindow(Time window) const;
+
+    /**
+     * @param window the duration of the reporting period
+     * @return the average number of PRBs used for each symbol allocated in the period
+     */
+    double GetPrbsPerSymbol(Time window) const;
+};
+
+/**
+ * Batch computation of the derived UE specific DU KPMs of a report.
+ *
+ * The counters needed by the KPMs are copied in structure-of-arrays form, one
+ * row per UE, so that Compute evaluates the PRB usage, the MAC throughput and
+ * the BLER of all the UEs of a cell in branch-free loops, which the compiler
+ * can vectorise. The storage is reused across reports.
+ */
+class MmWaveDuKpmBatch
+{
+  public:
+    /**
+     * Remove all the rows, keeping the storage
+     */
+    void Clear();
+
+    /**
+     * Add a UE
+     * @param counters the counters of the UE in the period, which must outlive the batch rows
+     */
+    void Add(const UeSpecificPhyCounters& counters);
+
+    /**
+     * Compute the KPMs of all the UEs
+     * @param grid the resources of the cell
+     * @param window the duration of the reporting period
+     */
+    void Compute(const MmWaveCellResourceGrid& grid, Time window);
+
+    /**
+     * @return the number of UEs
+     */
+    uint32_t GetSize() const;
+
+    /**
+     * @param i the row of the UE
+     * @return the counters of the UE
+     */
+    const UeSpecificPhyCounters& GetCounters(uint32_t i) const;
+
+    /**
+     * @param i the row of the UE
+     * @return the average number of PRBs used by the UE
+     */
+    double GetPrb(uint32_t i) const;
+
+    /**
+     * @param i the row of the UE
+     * @return the MAC throughput of the UE, in kbps
+     */
+    double GetThroughputKbps(uint32_t i) const;
+
+    /**
+     * @param i the row of the UE
+     * @return the share of retransmitted MAC PDUs of the UE
+     */
+    double GetBler(uint32_t i) const;
+
+  private:
+    std::vector<const UeSpecificPhyCounters*> m_counters; //!< counters of each UE
+
+    std::vector<double> m_symbols; //!< OFDM symbols of each UE
+    std::vector<double> m_volume;  //!< MAC volume of each UE, in bytes
+    std::vector<double> m_pdus;    //!< MAC PDUs of each UE, at least 1
+    std::vector<double> m_retx;    //!< retransmitted MAC PDUs of each UE
+
+    std::vector<double> m_prb;        //!< average PRBs of each UE
+    std::vector<double> m_throughput; //!< MAC throughput of each UE, in kbps
+    std::vector<double> m_bler;       //!< BLER of each UE
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_HELPER_MMWAVE_DU_KPM_BATCH_H_ */
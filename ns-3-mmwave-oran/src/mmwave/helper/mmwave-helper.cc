@@ -44,6 +44,7 @@
 #include <ns3/cc-helper.h>
 #include <ns3/channel-condition-model.h>
 #include <ns3/double.h>
+#include <ns3/enum.h>
 #include <ns3/epc-enb-application.h>
 #include <ns3/epc-x2.h>
 #include <ns3/file-beamforming-codebook.h>
@@ -309,7 +310,57 @@ MmWaveHelper::GetTypeId(void)
                           "Periodicity of E2 reporting (value in seconds)",
                           DoubleValue(0.1),
                           MakeDoubleAccessor(&MmWaveHelper::m_e2Periodicity),
-                          MakeDoubleChecker<double>());
+                          MakeDoubleChecker<double>())
+            .AddAttribute("RxPacketTraceFormat",
+                          "Format of the PHY reception trace (RxPacketTrace)",
+                          EnumValue(MmWaveTraceSink::TEXT),
+                          MakeEnumAccessor(&MmWaveHelper::m_rxPacketTraceFormat),
+                          MakeEnumChecker(MmWaveTraceSink::TEXT,
+                                          "Text",
+                                          MmWaveTraceSink::BINARY,
+                                          "Binary"))
+            .AddAttribute("UlPhyTransmissionTraceFormat",
+                          "Format of the UL PHY transmission trace",
+                          EnumValue(MmWaveTraceSink::TEXT),
+                          MakeEnumAccessor(&MmWaveHelper::m_ulPhyTxTraceFormat),
+                          MakeEnumChecker(MmWaveTraceSink::TEXT,
+                                          "Text",
+                                          MmWaveTraceSink::BINARY,
+                                          "Binary"))
+            .AddAttribute("DlPhyTransmissionTraceFormat",
+                          "Format of the DL PHY transmission trace",
+                          EnumValue(MmWaveTraceSink::TEXT),
+                          MakeEnumAccessor(&MmWaveHelper::m_dlPhyTxTraceFormat),
+                          MakeEnumChecker(MmWaveTraceSink::TEXT,
+                                          "Text",
+                                          MmWaveTraceSink::BINARY,
+                                          "Binary"))
+            .AddAttribute("RlcTraceFormat",
+                          "Format of the per-PDU RLC traces, used if the RLC stats are not aggregated",
+                          EnumValue(MmWaveTraceSink::TEXT),
+                          MakeEnumAccessor(&MmWaveHelper::m_rlcTraceFormat),
+                          MakeEnumChecker(MmWaveTraceSink::TEXT,
+                                          "Text",
+                                          MmWaveTraceSink::BINARY,
+                                          "Binary"))
+            .AddAttribute("PdcpTraceFormat",
+                          "Format of the per-PDU PDCP traces, used if the PDCP stats are not aggregated",
+                          EnumValue(MmWaveTraceSink::TEXT),
+                          MakeEnumAccessor(&MmWaveHelper::m_pdcpTraceFormat),
+                          MakeEnumChecker(MmWaveTraceSink::TEXT,
+                                          "Text",
+                                          MmWaveTraceSink::BINARY,
+                                          "Binary"))
+            .AddAttribute("TraceBufferSize",
+                          "Size in bytes of the write buffer of each trace file",
+                          UintegerValue(1 << 20),
+                          MakeUintegerAccessor(&MmWaveHelper::m_traceBufferSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TraceFlushInterval",
+                          "Maximum interval between two writes of a trace to file",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&MmWaveHelper::m_traceFlushInterval),
+                          MakeTimeChecker());
 
     return tid;
 }
@@ -351,6 +402,11 @@ MmWaveHelper::DoInitialize()
     MmWaveChannelModelInitialization(); // channel initialization
 
     m_phyStats = CreateObject<MmWavePhyTrace>();
+    m_phyStats->SetAttribute("OutputFormat", EnumValue(m_rxPacketTraceFormat));
+    m_phyStats->SetAttribute("UlPhyTransmissionFormat", EnumValue(m_ulPhyTxTraceFormat));
+    m_phyStats->SetAttribute("DlPhyTransmissionFormat", EnumValue(m_dlPhyTxTraceFormat));
+    m_phyStats->SetAttribute("TraceBufferSize", UintegerValue(m_traceBufferSize));
+    m_phyStats->SetAttribute("TraceFlushInterval", TimeValue(m_traceFlushInterval));
     m_radioBearerStatsConnector = CreateObject<MmWaveBearerStatsConnector>();
     m_enbStats = CreateObject<MmWaveMacTrace>();
 
@@ -3156,6 +3212,9 @@ MmWaveHelper::EnableRlcTraces(void)
     NS_ASSERT_MSG(!m_rlcStats,
                   "please make sure that MmWaveHelper::EnableRlcTraces is called at most once");
     m_rlcStats = CreateObject<MmWaveBearerStatsCalculator>("RLC");
+    m_rlcStats->SetAttribute("OutputFormat", EnumValue(m_rlcTraceFormat));
+    m_rlcStats->SetAttribute("TraceBufferSize", UintegerValue(m_traceBufferSize));
+    m_rlcStats->SetAttribute("TraceFlushInterval", TimeValue(m_traceFlushInterval));
     m_radioBearerStatsConnector->EnableRlcStats(m_rlcStats);
 }
 
@@ -3171,6 +3230,9 @@ MmWaveHelper::EnablePdcpTraces(void)
     NS_ASSERT_MSG(!m_pdcpStats,
                   "please make sure that MmWaveHelper::EnablePdcpTraces is called at most once");
     m_pdcpStats = CreateObject<MmWaveBearerStatsCalculator>("PDCP");
+    m_pdcpStats->SetAttribute("OutputFormat", EnumValue(m_pdcpTraceFormat));
+    m_pdcpStats->SetAttribute("TraceBufferSize", UintegerValue(m_traceBufferSize));
+    m_pdcpStats->SetAttribute("TraceFlushInterval", TimeValue(m_traceFlushInterval));
     m_radioBearerStatsConnector->EnablePdcpStats(m_pdcpStats);
 }
 
@@ -520,6 +520,14 @@ class MmWaveHelper : public Object
     uint16_t m_e2localPort;
     double m_e2Periodicity;
 
+    MmWaveTraceSink::Format m_rxPacketTraceFormat; //!< format of the PHY reception trace
+    MmWaveTraceSink::Format m_ulPhyTxTraceFormat;  //!< format of the UL PHY transmission trace
+    MmWaveTraceSink::Format m_dlPhyTxTraceFormat;  //!< format of the DL PHY transmission trace
+    MmWaveTraceSink::Format m_rlcTraceFormat;      //!< format of the per-PDU RLC traces
+    MmWaveTraceSink::Format m_pdcpTraceFormat;     //!< format of the per-PDU PDCP traces
+    uint32_t m_traceBufferSize;                    //!< write buffer size of the traces
+    Time m_traceFlushInterval;                     //!< maximum interval between two trace writes
+
     /**
      * This contains all the informations about each LTE component carrier
      */
@@ -34,8 +34,10 @@
 
 #include "mmwave-phy-trace.h"
 
+#include <ns3/enum.h>
 #include <ns3/log.h>
 #include <ns3/simulator.h>
+#include <ns3/uinteger.h>
 
 #include <stdio.h>
 
@@ -49,13 +51,13 @@ namespace mmwave
 
 NS_OBJECT_ENSURE_REGISTERED(MmWavePhyTrace);
 
-std::ofstream MmWavePhyTrace::m_rxPacketTraceFile;
+MmWaveTraceSink MmWavePhyTrace::m_rxPacketTraceSink;
 std::string MmWavePhyTrace::m_rxPacketTraceFilename;
 
-std::ofstream MmWavePhyTrace::m_ulPhyTraceFile{};
+MmWaveTraceSink MmWavePhyTrace::m_ulPhyTraceSink{};
 std::string MmWavePhyTrace::m_ulPhyTraceFilename{};
 
-std::ofstream MmWavePhyTrace::m_dlPhyTraceFile{};
+MmWaveTraceSink MmWavePhyTrace::m_dlPhyTraceSink{};
 std::string MmWavePhyTrace::m_dlPhyTraceFilename{};
 
 MmWavePhyTrace::MmWavePhyTrace()
@@ -64,10 +66,9 @@ MmWavePhyTrace::MmWavePhyTrace()
 
 MmWavePhyTrace::~MmWavePhyTrace()
 {
-    if (m_rxPacketTraceFile.is_open())
-    {
-        m_rxPacketTraceFile.close();
-    }
+    m_rxPacketTraceSink.Flush();
+    m_ulPhyTraceSink.Flush();
+    m_dlPhyTraceSink.Flush();
 }
 
 TypeId
@@ -92,6 +93,40 @@ MmWavePhyTrace::GetTypeId(void)
                           StringValue("DlPhyTransmissionTrace.txt"),
                           MakeStringAccessor(&MmWavePhyTrace::SetDlPhyTxOutputFilename),
                           MakeStringChecker())
+            .AddAttribute("OutputFormat",
+                          "Format of the PHY reception trace.",
+                          EnumValue(MmWaveTraceSink::TEXT),
+                          MakeEnumAccessor(&MmWavePhyTrace::SetPhyRxOutputFormat),
+                          MakeEnumChecker(MmWaveTraceSink::TEXT,
+                                          "Text",
+                                          MmWaveTraceSink::BINARY,
+                                          "Binary"))
+            .AddAttribute("UlPhyTransmissionFormat",
+                          "Format of the UL transmission trace.",
+                          EnumValue(MmWaveTraceSink::TEXT),
+                          MakeEnumAccessor(&MmWavePhyTrace::SetUlPhyTxOutputFormat),
+                          MakeEnumChecker(MmWaveTraceSink::TEXT,
+                                          "Text",
+                                          MmWaveTraceSink::BINARY,
+                                          "Binary"))
+            .AddAttribute("DlPhyTransmissionFormat",
+                          "Format of the DL transmission trace.",
+                          EnumValue(MmWaveTraceSink::TEXT),
+                          MakeEnumAccessor(&MmWavePhyTrace::SetDlPhyTxOutputFormat),
+                          MakeEnumChecker(MmWaveTraceSink::TEXT,
+                                          "Text",
+                                          MmWaveTraceSink::BINARY,
+                                          "Binary"))
+            .AddAttribute("TraceBufferSize",
+                          "Size in bytes of the write buffer of the PHY traces.",
+                          UintegerValue(1 << 20),
+                          MakeUintegerAccessor(&MmWavePhyTrace::SetTraceBufferSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TraceFlushInterval",
+                          "Maximum interval between two writes of the PHY traces to file.",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&MmWavePhyTrace::SetTraceFlushInterval),
+                          MakeTimeChecker())
 
         ;
     return tid;
@@ -118,6 +153,40 @@ MmWavePhyTrace::SetDlPhyTxOutputFilename(std::string fileName)
     m_dlPhyTraceFilename = fileName;
 }
 
+void
+MmWavePhyTrace::SetPhyRxOutputFormat(MmWaveTraceSink::Format format)
+{
+    m_rxPacketTraceSink.SetFormat(format);
+}
+
+void
+MmWavePhyTrace::SetUlPhyTxOutputFormat(MmWaveTraceSink::Format format)
+{
+    m_ulPhyTraceSink.SetFormat(format);
+}
+
+void
+MmWavePhyTrace::SetDlPhyTxOutputFormat(MmWaveTraceSink::Format format)
+{
+    m_dlPhyTraceSink.SetFormat(format);
+}
+
+void
+MmWavePhyTrace::SetTraceBufferSize(uint32_t bytes)
+{
+    m_rxPacketTraceSink.SetBufferSize(bytes);
+    m_ulPhyTraceSink.SetBufferSize(bytes);
+    m_dlPhyTraceSink.SetBufferSize(bytes);
+}
+
+void
+MmWavePhyTrace::SetTraceFlushInterval(Time interval)
+{
+    m_rxPacketTraceSink.SetFlushInterval(interval);
+    m_ulPhyTraceSink.SetFlushInterval(interval);
+    m_dlPhyTraceSink.SetFlushInterval(interval);
+}
+
 void
 MmWavePhyTrace::ReportCurrentCellRsrpSinrCallback(Ptr<MmWavePhyTrace> phyStats,
                                                   std::string path,
@@ -192,206 +261,131 @@ MmWavePhyTrace::ReportDLTbSize (uint64_t imsi, uint64_t tbSize)
 unsigned) tbSize); fflush(log_file); fclose(log_file);
 }
 */
+void
+MmWavePhyTrace::OpenPhyTxTrace(MmWaveTraceSink& sink, const std::string& fileName)
+{
+    sink.Open(fileName,
+              {{"frame", MmWaveTraceSink::FIELD_UINT32},
+               {"subF", MmWaveTraceSink::FIELD_UINT8},
+               {"slot", MmWaveTraceSink::FIELD_UINT8},
+               {"rnti", MmWaveTraceSink::FIELD_UINT16},
+               {"firstSym", MmWaveTraceSink::FIELD_UINT8},
+               {"numSym", MmWaveTraceSink::FIELD_UINT8},
+               {"type", MmWaveTraceSink::FIELD_UINT8},
+               {"tddMode", MmWaveTraceSink::FIELD_UINT8},
+               {"retxNum", MmWaveTraceSink::FIELD_UINT8},
+               {"ccId", MmWaveTraceSink::FIELD_UINT8}});
+}
+
+void
+MmWavePhyTrace::WritePhyTxTrace(MmWaveTraceSink& sink, const PhyTransmissionTraceParams& param)
+{
+    sink.AddUint(param.m_frameNum)
+        .AddUint(param.m_sfNum)
+        .AddUint(param.m_slotNum)
+        .AddUint(param.m_rnti)
+        .AddUint(param.m_symStart)
+        .AddUint(param.m_numSym)
+        .AddUint(param.m_ttiType)
+        .AddUint(param.m_tddMode)
+        .AddUint(param.m_rv)
+        .AddUint(param.m_ccId);
+    sink.EndRecord();
+}
+
 void
 MmWavePhyTrace::ReportUlPhyTransmissionCallback(Ptr<MmWavePhyTrace> phyStats,
                                                 PhyTransmissionTraceParams param)
 {
-    if (!m_ulPhyTraceFile.is_open())
+    if (!m_ulPhyTraceSink.IsOpen())
     {
-        m_ulPhyTraceFile.open(m_ulPhyTraceFilename.c_str());
-        if (!m_ulPhyTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-        m_ulPhyTraceFile
-            << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId"
-            << std::endl;
+        OpenPhyTxTrace(m_ulPhyTraceSink, m_ulPhyTraceFilename);
     }
 
     // Trace the UL PHY transmission info
-    m_ulPhyTraceFile << +param.m_frameNum << "\t" << +param.m_sfNum << "\t" << +param.m_slotNum
-                     << "\t" << +param.m_rnti << "\t" << +param.m_symStart << "\t"
-                     << +param.m_numSym << "\t" << +param.m_ttiType << "\t" << +param.m_tddMode
-                     << "\t" << +param.m_rv << "\t" << +param.m_ccId << std::endl;
+    WritePhyTxTrace(m_ulPhyTraceSink, param);
 }
 
 void
 MmWavePhyTrace::ReportDlPhyTransmissionCallback(Ptr<MmWavePhyTrace> phyStats,
                                                 PhyTransmissionTraceParams param)
 {
-    if (!m_dlPhyTraceFile.is_open())
+    if (!m_dlPhyTraceSink.IsOpen())
     {
-        m_dlPhyTraceFile.open(m_dlPhyTraceFilename.c_str());
-        if (!m_dlPhyTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-        m_dlPhyTraceFile
-            << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId"
-            << std::endl;
+        OpenPhyTxTrace(m_dlPhyTraceSink, m_dlPhyTraceFilename);
     }
 
     // Trace the DL PHY transmission info
-    m_dlPhyTraceFile << +param.m_frameNum << "\t" << +param.m_sfNum << "\t" << +param.m_slotNum
-                     << "\t" << +param.m_rnti << "\t" << +param.m_symStart << "\t"
-                     << +param.m_numSym << "\t" << +param.m_ttiType << "\t" << +param.m_tddMode
-                     << "\t" << +param.m_rv << "\t" << +param.m_ccId << std::endl;
+    WritePhyTxTrace(m_dlPhyTraceSink, param);
 }
 
-void
-MmWavePhyTrace::UpdateTraces(RxPacketTraceParams params)
+const UeSpecificPhyCounters*
+MmWavePhyTrace::FindCounters(RntiCellIdPair_t key) const
 {
-    RntiCellIdPair_t pair{params.m_rnti, params.m_cellId};
-
-    NS_LOG_LOGIC("Update trace rnti " << params.m_rnti << " cellId " << params.m_cellId);
-
-    m_macPduUeSpecific = IncreaseMapValue(m_macPduUeSpecific, pair, 1);
-
-    if (params.m_rv == 0)
-    {
-        m_macPduInitialTransmissionUeSpecific =
-            IncreaseMapValue(m_macPduInitialTransmissionUeSpecific, pair, 1);
-    }
-    else
-    {
-        m_macPduRetransmissionUeSpecific =
-            IncreaseMapValue(m_macPduRetransmissionUeSpecific, pair, 1);
-    }
-
-    // UE specific MAC volume
-    m_macVolumeUeSpecific = IncreaseMapValue(m_macVolumeUeSpecific, pair, params.m_tbSize);
-
-    if (params.m_mcs >= 0 && params.m_mcs <= 9)
-    {
-        // UE specific MAC PDUs QPSK
-        m_macPduQpskUeSpecific = IncreaseMapValue(m_macPduQpskUeSpecific, pair, 1);
-    }
-    else if (params.m_mcs >= 10 && params.m_mcs <= 16)
-    {
-        // UE specific MAC PDUs 16QAM
-        m_macPdu16QamUeSpecific = IncreaseMapValue(m_macPdu16QamUeSpecific, pair, 1);
-    }
-    else if (params.m_mcs >= 17 && params.m_mcs <= 28)
-    {
-        // UE specific MAC PDUs 64QAM
-        m_macPdu64QamUeSpecific = IncreaseMapValue(m_macPdu64QamUeSpecific, pair, 1);
-    }
-
-    if (params.m_mcs <= 4)
-    {
-        m_macMcs04UeSpecific = IncreaseMapValue(m_macMcs04UeSpecific, pair, 1);
-    }
-    else if (params.m_mcs >= 5 && params.m_mcs <= 9)
-    {
-        m_macMcs59UeSpecific = IncreaseMapValue(m_macMcs59UeSpecific, pair, 1);
-    }
-    else if (params.m_mcs >= 10 && params.m_mcs <= 14)
-    {
-        m_macMcs1014UeSpecific = IncreaseMapValue(m_macMcs1014UeSpecific, pair, 1);
-    }
-    else if (params.m_mcs >= 15 && params.m_mcs <= 19)
-    {
-        m_macMcs1519UeSpecific = IncreaseMapValue(m_macMcs1519UeSpecific, pair, 1);
-    }
-    else if (params.m_mcs >= 20 && params.m_mcs <= 24)
-    {
-        m_macMcs2024UeSpecific = IncreaseMapValue(m_macMcs2024UeSpecific, pair, 1);
-    }
-    else if (params.m_mcs >= 25 && params.m_mcs <= 29)
-    {
-        m_macMcs2529UeSpecific = IncreaseMapValue(m_macMcs2529UeSpecific, pair, 1);
-    }
-
-    double sinrLog = 10 * std::log10(params.m_sinr);
-    if (sinrLog <= -6)
+    auto cell = m_cellKpms.find(key.second);
+    if (cell != m_cellKpms.end())
     {
-        m_macSinrBin1UeSpecific = IncreaseMapValue(m_macSinrBin1UeSpecific, pair, 1);
+        return cell->second.Find(key.first);
     }
-    else if (sinrLog <= 0)
-    {
-        m_macSinrBin2UeSpecific = IncreaseMapValue(m_macSinrBin2UeSpecific, pair, 1);
-    }
-    else if (sinrLog <= 6)
-    {
-        m_macSinrBin3UeSpecific = IncreaseMapValue(m_macSinrBin3UeSpecific, pair, 1);
-    }
-    else if (sinrLog <= 12)
-    {
-        m_macSinrBin4UeSpecific = IncreaseMapValue(m_macSinrBin4UeSpecific, pair, 1);
-    }
-    else if (sinrLog <= 18)
-    {
-        m_macSinrBin5UeSpecific = IncreaseMapValue(m_macSinrBin5UeSpecific, pair, 1);
-    }
-    else if (sinrLog <= 24)
-    {
-        m_macSinrBin6UeSpecific = IncreaseMapValue(m_macSinrBin6UeSpecific, pair, 1);
-    }
-    else
-    {
-        m_macSinrBin7UeSpecific = IncreaseMapValue(m_macSinrBin7UeSpecific, pair, 1);
-    }
-
-    // UE specific number of symbols
-    m_macNumberOfSymbols = IncreaseMapValue(m_macNumberOfSymbols, pair, params.m_numSym);
+    return nullptr;
 }
 
-std::map<RntiCellIdPair_t, uint32_t>
-MmWavePhyTrace::UpdateMapValue(std::map<RntiCellIdPair_t, uint32_t> map,
-                               RntiCellIdPair_t key,
-                               uint32_t newValue)
+void
+MmWavePhyTrace::UpdateTraces(const RxPacketTraceParams& params)
 {
-    auto pair = map.find(key);
-    if (pair != map.end())
-    {
-        pair->second = newValue;
-    }
-    else
-    {
-        map[key] = newValue;
-    }
-    return map;
-}
+    NS_LOG_LOGIC("Update trace rnti " << params.m_rnti << " cellId " << params.m_cellId);
 
-std::map<RntiCellIdPair_t, uint32_t>
-MmWavePhyTrace::IncreaseMapValue(std::map<RntiCellIdPair_t, uint32_t> map,
-                                 RntiCellIdPair_t key,
-                                 uint32_t value)
-{
-    auto pair = map.find(key);
-    if (pair != map.end())
-    {
-        pair->second += value;
-    }
-    else
-    {
-        map[key] = value;
-    }
-    return map;
+    m_cellKpms[params.m_cellId].Update(params);
 }
 
-uint32_t
-MmWavePhyTrace::GetMapValue(std::map<RntiCellIdPair_t, uint32_t> map, RntiCellIdPair_t key)
+void
+MmWavePhyTrace::TakeCellKpmSnapshot(uint16_t cellId, MmWaveCellKpmAggregator::Snapshot& snapshot)
 {
-    uint32_t ret = 0;
-    auto pair = map.find(key);
-    if (pair != map.end())
-    {
-        ret = pair->second;
-    }
-    return ret;
+    NS_LOG_LOGIC("Snapshot cellId " << cellId);
+
+    m_cellKpms[cellId].TakeSnapshot(snapshot);
 }
 
-std::map<RntiCellIdPair_t, uint32_t>
-MmWavePhyTrace::ResetMapValue(std::map<RntiCellIdPair_t, uint32_t> map, RntiCellIdPair_t key)
-{
-    auto pair = map.find(key);
-    if (pair != map.end())
-    {
-        map.erase(pair);
-    }
-    m_lastReset[key] = Simulator::Now();
-    return map;
+void
+MmWavePhyTrace::WriteRxPacketTrace(const char* direction, const RxPacketTraceParams& params)
+{
+    if (!m_rxPacketTraceSink.IsOpen())
+    {
+        m_rxPacketTraceSink.Open(m_rxPacketTraceFilename,
+                                 {{"DL/UL", MmWaveTraceSink::FIELD_TAG},
+                                  {"time", MmWaveTraceSink::FIELD_DOUBLE},
+                                  {"frame", MmWaveTraceSink::FIELD_UINT32},
+                                  {"subF", MmWaveTraceSink::FIELD_UINT8},
+                                  {"slot", MmWaveTraceSink::FIELD_UINT8},
+                                  {"1stSym", MmWaveTraceSink::FIELD_UINT8},
+                                  {"symbol#", MmWaveTraceSink::FIELD_UINT8},
+                                  {"cellId", MmWaveTraceSink::FIELD_UINT64},
+                                  {"rnti", MmWaveTraceSink::FIELD_UINT16},
+                                  {"ccId", MmWaveTraceSink::FIELD_UINT8},
+                                  {"tbSize", MmWaveTraceSink::FIELD_UINT32},
+                                  {"mcs", MmWaveTraceSink::FIELD_UINT8},
+                                  {"rv", MmWaveTraceSink::FIELD_UINT8},
+                                  {"SINR(dB)", MmWaveTraceSink::FIELD_DOUBLE},
+                                  {"corrupt", MmWaveTraceSink::FIELD_UINT8},
+                                  {"TBler", MmWaveTraceSink::FIELD_DOUBLE}});
+    }
+    m_rxPacketTraceSink.AddTag(direction)
+        .AddDouble(Simulator::Now().GetSeconds())
+        .AddUint(params.m_frameNum)
+        .AddUint(params.m_sfNum)
+        .AddUint(params.m_slotNum)
+        .AddUint(params.m_symStart)
+        .AddUint(params.m_numSym)
+        .AddUint(params.m_cellId)
+        .AddUint(params.m_rnti)
+        .AddUint(params.m_ccId)
+        .AddUint(params.m_tbSize)
+        .AddUint(params.m_mcs)
+        .AddUint(params.m_rv)
+        .AddDouble(10 * std::log10(params.m_sinr))
+        .AddUint(params.m_corrupt)
+        .AddDouble(params.m_tbler);
+    m_rxPacketTraceSink.EndRecord();
 }
 
 void
@@ -399,25 +393,7 @@ MmWavePhyTrace::RxPacketTraceUeCallback(Ptr<MmWavePhyTrace> phyStats,
                                         std::string path,
                                         RxPacketTraceParams params)
 {
-    if (!m_rxPacketTraceFile.is_open())
-    {
-        m_rxPacketTraceFile.open(m_rxPacketTraceFilename.c_str());
-        m_rxPacketTraceFile << "DL/"
-                               "UL\ttime\tframe\tsubF\tslot\t1stSym\tsymbol#"
-                               "\tcellId\trnti\tccId\ttbSize\tmcs\trv\tSINR(dB)\tcorrupt\tTBler"
-                            << std::endl;
-        if (!m_rxPacketTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-    m_rxPacketTraceFile << "DL\t" << Simulator::Now().GetSeconds() << "\t" << params.m_frameNum
-                        << "\t" << +params.m_sfNum << "\t" << +params.m_slotNum << "\t"
-                        << +params.m_symStart << "\t" << +params.m_numSym << "\t" << params.m_cellId
-                        << "\t" << params.m_rnti << "\t" << +params.m_ccId << "\t"
-                        << params.m_tbSize << "\t" << +params.m_mcs << "\t" << +params.m_rv << "\t"
-                        << 10 * std::log10(params.m_sinr) << "\t" << params.m_corrupt << "\t"
-                        << params.m_tbler << std::endl;
+    WriteRxPacketTrace("DL", params);
 
     phyStats->UpdateTraces(params);
 
@@ -438,25 +414,7 @@ MmWavePhyTrace::RxPacketTraceEnbCallback(Ptr<MmWavePhyTrace> phyStats,
                                          std::string path,
                                          RxPacketTraceParams params)
 {
-    if (!m_rxPacketTraceFile.is_open())
-    {
-        m_rxPacketTraceFile.open(m_rxPacketTraceFilename.c_str());
-        m_rxPacketTraceFile << "DL/"
-                               "UL\ttime\tframe\tsubF\tslot\t1stSym\tsymbol#"
-                               "\tcellId\trnti\tccId\ttbSize\tmcs\trv\tSINR(dB)\tcorrupt\tTBler"
-                            << std::endl;
-        if (!m_rxPacketTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-    m_rxPacketTraceFile << "UL\t" << Simulator::Now().GetSeconds() << "\t" << params.m_frameNum
-                        << "\t" << +params.m_sfNum << "\t" << +params.m_slotNum << "\t"
-                        << +params.m_symStart << "\t" << +params.m_numSym << "\t" << params.m_cellId
-                        << "\t" << params.m_rnti << "\t" << +params.m_ccId << "\t"
-                        << params.m_tbSize << "\t" << +params.m_mcs << "\t" << +params.m_rv << "\t"
-                        << 10 * std::log10(params.m_sinr) << " \t" << params.m_corrupt << "\t"
-                        << params.m_tbler << std::endl;
+    WriteRxPacketTrace("UL", params);
 
     if (params.m_corrupt)
     {
@@ -474,209 +432,173 @@ void
 MmWavePhyTrace::ResetPhyTracesForRntiCellId(uint16_t rnti, uint16_t cellId)
 {
     NS_LOG_LOGIC("Reset rnti " << rnti << " cellId " << cellId);
-    RntiCellIdPair_t pair{rnti, cellId};
-
-    m_macPduUeSpecific = ResetMapValue(m_macPduUeSpecific, pair);
-
-    m_macPduInitialTransmissionUeSpecific =
-        ResetMapValue(m_macPduInitialTransmissionUeSpecific, pair);
-
-    m_macPduRetransmissionUeSpecific = ResetMapValue(m_macPduRetransmissionUeSpecific, pair);
-
-    m_macVolumeUeSpecific = ResetMapValue(m_macVolumeUeSpecific, pair);
-
-    m_macPduQpskUeSpecific = ResetMapValue(m_macPduQpskUeSpecific, pair);
-
-    m_macPdu16QamUeSpecific = ResetMapValue(m_macPdu16QamUeSpecific, pair);
-
-    m_macPdu64QamUeSpecific = ResetMapValue(m_macPdu64QamUeSpecific, pair);
 
-    m_macMcs04UeSpecific = ResetMapValue(m_macMcs04UeSpecific, pair);
-
-    m_macMcs59UeSpecific = ResetMapValue(m_macMcs59UeSpecific, pair);
-
-    m_macMcs1014UeSpecific = ResetMapValue(m_macMcs1014UeSpecific, pair);
-
-    m_macMcs1519UeSpecific = ResetMapValue(m_macMcs1519UeSpecific, pair);
-
-    m_macMcs2024UeSpecific = ResetMapValue(m_macMcs2024UeSpecific, pair);
-
-    m_macMcs2529UeSpecific = ResetMapValue(m_macMcs2529UeSpecific, pair);
-
-    m_macSinrBin1UeSpecific = ResetMapValue(m_macSinrBin1UeSpecific, pair);
-
-    m_macSinrBin2UeSpecific = ResetMapValue(m_macSinrBin2UeSpecific, pair);
-
-    m_macSinrBin3UeSpecific = ResetMapValue(m_macSinrBin3UeSpecific, pair);
-
-    m_macSinrBin4UeSpecific = ResetMapValue(m_macSinrBin4UeSpecific, pair);
-
-    m_macSinrBin5UeSpecific = ResetMapValue(m_macSinrBin5UeSpecific, pair);
-
-    m_macSinrBin6UeSpecific = ResetMapValue(m_macSinrBin6UeSpecific, pair);
-
-    m_macSinrBin7UeSpecific = ResetMapValue(m_macSinrBin7UeSpecific, pair);
-
-    m_macNumberOfSymbols = ResetMapValue(m_macNumberOfSymbols, pair);
+    m_cellKpms[cellId].ResetUe(rnti);
 }
 
 Time
 MmWavePhyTrace::GetLastResetTime(uint16_t rnti, uint16_t cellId)
 {
-    Time ret = Seconds(0);
-    RntiCellIdPair_t key{rnti, cellId};
-    if (m_lastReset.find(key) != m_lastReset.end())
+    auto cell = m_cellKpms.find(cellId);
+    if (cell != m_cellKpms.end())
     {
-        ret = m_lastReset.at(key);
+        return cell->second.GetLastResetTime(rnti);
     }
-    return ret;
+    return Seconds(0);
+}
+
+UeSpecificPhyCounters
+MmWavePhyTrace::GetPhyCountersUeSpecific(uint16_t rnti, uint16_t cellId) const
+{
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? *counters : UeSpecificPhyCounters{};
 }
 
 uint32_t
 MmWavePhyTrace::GetMacPduUeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macPduUeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macPdu : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacPduInitialTransmissionUeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macPduInitialTransmissionUeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macPduInitialTransmission : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacPduRetransmissionUeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macPduRetransmissionUeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macPduRetransmission : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacVolumeUeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macVolumeUeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macVolume : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacPduQpskUeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macPduQpskUeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macPduQpsk : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacPdu16QamUeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macPdu16QamUeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macPdu16Qam : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacPdu64QamUeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macPdu64QamUeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macPdu64Qam : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacNumberOfSymbolsUeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macNumberOfSymbols, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macNumberOfSymbols : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacMcs04UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macMcs04UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macMcs[0] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacMcs59UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macMcs59UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macMcs[1] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacMcs1014UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macMcs1014UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macMcs[2] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacMcs1519UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macMcs1519UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macMcs[3] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacMcs2024UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macMcs2024UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macMcs[4] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacMcs2529UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macMcs2529UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macMcs[5] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacSinrBin1UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macSinrBin1UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macSinrBin[0] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacSinrBin2UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macSinrBin2UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macSinrBin[1] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacSinrBin3UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macSinrBin3UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macSinrBin[2] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacSinrBin4UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macSinrBin4UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macSinrBin[3] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacSinrBin5UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macSinrBin5UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macSinrBin[4] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacSinrBin6UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macSinrBin6UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macSinrBin[5] : 0;
 }
 
 uint32_t
 MmWavePhyTrace::GetMacSinrBin7UeSpecific(uint16_t rnti, uint16_t cellId)
 {
-    RntiCellIdPair_t pair{rnti, cellId};
-    return GetMapValue(m_macSinrBin7UeSpecific, pair);
+    const UeSpecificPhyCounters* counters = FindCounters(RntiCellIdPair_t{rnti, cellId});
+    return counters ? counters->m_macSinrBin[6] : 0;
 }
 
 } // namespace mmwave
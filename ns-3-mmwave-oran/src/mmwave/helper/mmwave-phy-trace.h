@@ -32,12 +32,17 @@
 
 #ifndef SRC_MMWAVE_HELPER_MMWAVE_PHY_TRACE_H_
 #define SRC_MMWAVE_HELPER_MMWAVE_PHY_TRACE_H_
+#include <ns3/mmwave-cell-kpm-aggregator.h>
 #include <ns3/mmwave-phy-mac-common.h>
+#include <ns3/mmwave-trace-sink.h>
 #include <ns3/object.h>
 #include <ns3/spectrum-value.h>
 
+#include <array>
 #include <fstream>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -98,6 +103,36 @@ class MmWavePhyTrace : public Object
      * \param fileName the file name
      */
     void SetDlPhyTxOutputFilename(std::string fileName);
+
+    /**
+     * Sets the format of the PHY reception traces
+     * \param format the trace format
+     */
+    void SetPhyRxOutputFormat(MmWaveTraceSink::Format format);
+
+    /**
+     * Sets the format of the UL PHY tranmission traces
+     * \param format the trace format
+     */
+    void SetUlPhyTxOutputFormat(MmWaveTraceSink::Format format);
+
+    /**
+     * Sets the format of the DL PHY tranmission traces
+     * \param format the trace format
+     */
+    void SetDlPhyTxOutputFormat(MmWaveTraceSink::Format format);
+
+    /**
+     * Sets the size of the write buffer of the PHY traces
+     * \param bytes the buffer size
+     */
+    void SetTraceBufferSize(uint32_t bytes);
+
+    /**
+     * Sets the maximum interval between two writes of the PHY traces
+     * \param interval the flush interval
+     */
+    void SetTraceFlushInterval(Time interval);
     /**
      * Gets the number of MAC PDUs, UE specific
      * @param rnti
@@ -280,86 +315,68 @@ class MmWavePhyTrace : public Object
      */
     Time GetLastResetTime(uint16_t rnti, uint16_t cellId);
 
+    /**
+     * Gets all the counters of a UE in a single lookup
+     * @param rnti
+     * @param cellId
+     * @return the UE specific counters, zeroed if the UE has not been traced yet
+     */
+    UeSpecificPhyCounters GetPhyCountersUeSpecific(uint16_t rnti, uint16_t cellId) const;
+
+    /**
+     * Update the UE specific counters with a received TB
+     * @param params the RX trace parameters of the TB
+     */
+    void UpdateTraces(const RxPacketTraceParams& params);
+
+    /**
+     * Take the snapshot of the counters of a cell for a DU report, and zero them
+     * @param cellId the cell ID
+     * @param snapshot the snapshot to fill
+     */
+    void TakeCellKpmSnapshot(uint16_t cellId, MmWaveCellKpmAggregator::Snapshot& snapshot);
+
   private:
     // void ReportInterferenceTrace (uint64_t imsi, SpectrumValue& sinr);
     // void ReportDLTbSize (uint64_t imsi, uint64_t tbSize);
-    static std::ofstream m_rxPacketTraceFile;   //!< Output stream for the PHY reception trace
+    /**
+     * Open a PHY transmission trace
+     * \param sink the trace sink
+     * \param fileName the file name
+     */
+    static void OpenPhyTxTrace(MmWaveTraceSink& sink, const std::string& fileName);
+
+    /**
+     * Write a record of the PHY reception trace
+     * \param direction "DL" or "UL"
+     * \param params the RX trace parameters of the TB
+     */
+    static void WriteRxPacketTrace(const char* direction, const RxPacketTraceParams& params);
+
+    /**
+     * Write a record of a PHY transmission trace
+     * \param sink the trace sink
+     * \param param the PHY transmission parameters
+     */
+    static void WritePhyTxTrace(MmWaveTraceSink& sink, const PhyTransmissionTraceParams& param);
+
+    static MmWaveTraceSink m_rxPacketTraceSink; //!< Output sink for the PHY reception trace
     static std::string m_rxPacketTraceFilename; //!< Output filename for the PHY reception trace
 
-    static std::ofstream m_ulPhyTraceFile;   //!< Output stream for the UL PHY transmission trace
+    static MmWaveTraceSink m_ulPhyTraceSink; //!< Output sink for the UL PHY transmission trace
     static std::string m_ulPhyTraceFilename; //!< Output filename for the UL PHY transmission trace
 
-    static std::ofstream m_dlPhyTraceFile;   //!< Output stream for the DL PHY transmission trace
+    static MmWaveTraceSink m_dlPhyTraceSink; //!< Output sink for the DL PHY transmission trace
     static std::string m_dlPhyTraceFilename; //!< Output filename for the DL PHY transmission trace
 
-    std::map<RntiCellIdPair_t, uint32_t> m_macPduUeSpecific;
-    std::map<RntiCellIdPair_t, uint32_t> m_macPduInitialTransmissionUeSpecific;
-    std::map<RntiCellIdPair_t, uint32_t> m_macPduRetransmissionUeSpecific;
-    std::map<RntiCellIdPair_t, uint32_t> m_macVolumeUeSpecific;   //!< UE specific MAC volume
-    std::map<RntiCellIdPair_t, uint32_t> m_macPduQpskUeSpecific;  //!< UE specific MAC PDUs QPSK
-    std::map<RntiCellIdPair_t, uint32_t> m_macPdu16QamUeSpecific; //!< UE specific MAC PDUs 16QAM
-    std::map<RntiCellIdPair_t, uint32_t> m_macPdu64QamUeSpecific; //!< UE specific MAC PDUs 64QAM
-    std::map<RntiCellIdPair_t, uint32_t> m_macMcs04UeSpecific;    //!< UE specific TX with MCS 0-4
-    std::map<RntiCellIdPair_t, uint32_t> m_macMcs59UeSpecific;    //!< UE specific TX with MCS 5-9
-    std::map<RntiCellIdPair_t, uint32_t> m_macMcs1014UeSpecific;  //!< UE specific TX with MCS 10-14
-    std::map<RntiCellIdPair_t, uint32_t> m_macMcs1519UeSpecific;  //!< UE specific TX with MCS 15-19
-    std::map<RntiCellIdPair_t, uint32_t> m_macMcs2024UeSpecific;  //!< UE specific TX with MCS 20-24
-    std::map<RntiCellIdPair_t, uint32_t> m_macMcs2529UeSpecific;  //!< UE specific TX with MCS 25-29
-
-    std::map<RntiCellIdPair_t, uint32_t>
-        m_macSinrBin1UeSpecific; //!< UE specific TX with SINR < -6dB
-    std::map<RntiCellIdPair_t, uint32_t>
-        m_macSinrBin2UeSpecific; //!< UE specific TX with SINR -6dB to 0 dB
-    std::map<RntiCellIdPair_t, uint32_t>
-        m_macSinrBin3UeSpecific; //!< UE specific TX with SINR 0 dB to 6 dB
-    std::map<RntiCellIdPair_t, uint32_t>
-        m_macSinrBin4UeSpecific; //!< UE specific TX with SINR 6 dB to 12 dB
-    std::map<RntiCellIdPair_t, uint32_t>
-        m_macSinrBin5UeSpecific; //!< UE specific TX with SINR 12 dB to 18 dB
-    std::map<RntiCellIdPair_t, uint32_t>
-        m_macSinrBin6UeSpecific; //!< UE specific TX with SINR 18 dB to 24 dB
-    std::map<RntiCellIdPair_t, uint32_t>
-        m_macSinrBin7UeSpecific; //!< UE specific TX with SINR > 24 dB
-
-    std::map<RntiCellIdPair_t, uint32_t> m_macNumberOfSymbols; //!< UE specific number of symbols
-
-    std::map<RntiCellIdPair_t, Time> m_lastReset; //! last time UE was reset
-
-    void UpdateTraces(RxPacketTraceParams params);
-
-    /**
-     * Update the value of an entry in a map
-     * @param map
-     * @param key
-     * @param newValue
-     */
-    std::map<RntiCellIdPair_t, uint32_t> UpdateMapValue(std::map<RntiCellIdPair_t, uint32_t> map,
-                                                        RntiCellIdPair_t key,
-                                                        uint32_t newValue);
-    /**
-     * Increase the value of an entry in a map by 1
-     * @param map
-     * @param key
-     * @param newValue
-     */
-    std::map<RntiCellIdPair_t, uint32_t> IncreaseMapValue(std::map<RntiCellIdPair_t, uint32_t> map,
-                                                          RntiCellIdPair_t key,
-                                                          uint32_t value);
-
-    /**
-     * Get an entry in a map
-     * @param map
-     * @param key
-     */
-    uint32_t GetMapValue(std::map<RntiCellIdPair_t, uint32_t> map, RntiCellIdPair_t key);
-
-    /**
-     * Erase an entry in a map
-     * @param map
-     * @param key
-     */
-    std::map<RntiCellIdPair_t, uint32_t> ResetMapValue(std::map<RntiCellIdPair_t, uint32_t> map,
-                                                       RntiCellIdPair_t key);
+    /**
+     * Find the counters of a UE
+     * @param key the (RNTI, cellId) pair
+     * @return a pointer to the counters of the UE, or nullptr if the UE has never been traced
+     */
+    const UeSpecificPhyCounters* FindCounters(RntiCellIdPair_t key) const;
+
+    std::unordered_map<uint16_t, MmWaveCellKpmAggregator> m_cellKpms; //!< cellId -> KPMs
 };
 
 } // namespace mmwave
@@ -30,6 +30,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace ns3
 {
@@ -50,6 +54,200 @@ static const std::vector<uint16_t> LiftingSizeTableBG = {
 
 std::vector<std::string> MmWaveEesmErrorModel::m_bgTypeName = {"BG1", "BG2"};
 
+/**
+ * \brief A simulated BLER-SINR curve, with a uniform grid of buckets over its
+ * SINR range for the lookup
+ */
+struct EesmBlerCurve
+{
+    static constexpr uint32_t MAX_BUCKETS = 1024; //!< maximum number of buckets of a curve
+
+    std::vector<double> m_sinrDb;    //!< simulated SINR points, in dB
+    std::vector<double> m_bler;      //!< BLER of each point
+    double m_invStep{0};             //!< buckets per dB
+    std::vector<uint16_t> m_buckets; //!< a point before the start of each bucket
+
+    /**
+     * \brief Build the buckets of a simulated curve. The bucket width is the
+     * minimum distance between two points, so that a lookup scans at most one
+     * point, unless the curve would need more than MAX_BUCKETS
+     * \param sinrDb the SINR points, in dB
+     * \param bler the BLER of each point
+     */
+    EesmBlerCurve(const std::vector<double>& sinrDb, const std::vector<double>& bler)
+        : m_sinrDb(sinrDb),
+          m_bler(bler)
+    {
+        NS_ASSERT(!m_sinrDb.empty() && m_sinrDb.size() == m_bler.size());
+        NS_ASSERT(std::is_sorted(m_sinrDb.begin(), m_sinrDb.end()));
+        double range = m_sinrDb.back() - m_sinrDb.front();
+        if (range <= 0)
+        {
+            m_buckets.push_back(0);
+            return;
+        }
+        double minGap = range;
+        for (std::size_t i = 1; i < m_sinrDb.size(); ++i)
+        {
+            if (m_sinrDb[i] > m_sinrDb[i - 1])
+            {
+                minGap = std::min(minGap, m_sinrDb[i] - m_sinrDb[i - 1]);
+            }
+        }
+        double step = std::max(minGap, range / MAX_BUCKETS);
+        m_invStep = 1 / step;
+        uint32_t numBuckets = static_cast<uint32_t>(range * m_invStep) + 1;
+        // each bucket points to the last point half a bucket before its start,
+        // so that the rounding of the bucket index never skips a point
+        uint16_t point = 0;
+        for (uint32_t b = 0; b < numBuckets; ++b)
+        {
+            double start = m_sinrDb.front() + (b - 0.5) * step;
+            while (point + 1u < m_sinrDb.size() && m_sinrDb[point + 1] <= start)
+            {
+                ++point;
+            }
+            m_buckets.push_back(point);
+        }
+    }
+
+    /**
+     * \brief Get the BLER of the last simulated point not above a SINR
+     * \param sinrDb the SINR in dB
+     * \return the BLER, 1 below the curve and 0 above it
+     */
+    double Lookup(double sinrDb) const
+    {
+        if (sinrDb < m_sinrDb.front())
+        {
+            return 1.0;
+        }
+        if (sinrDb > m_sinrDb.back())
+        {
+            return 0.0;
+        }
+        std::size_t bucket = static_cast<std::size_t>((sinrDb - m_sinrDb.front()) * m_invStep);
+        std::size_t point = m_buckets[std::min(bucket, m_buckets.size() - 1)];
+        while (point + 1 < m_sinrDb.size() && m_sinrDb[point + 1] <= sinrDb)
+        {
+            ++point;
+        }
+        return m_bler[point];
+    }
+};
+
+/**
+ * \brief The curves of the simulated CB sizes of an MCS and base graph
+ */
+struct EesmCbSizeCurves
+{
+    std::vector<uint32_t> m_cbSizes;    //!< simulated CB sizes, in increasing order
+    std::vector<EesmBlerCurve> m_curves; //!< curve of each CB size
+};
+
+struct MmWaveEesmErrorModel::BlerTables
+{
+    std::vector<std::vector<EesmCbSizeCurves>> m_curves; //!< curves by base graph and MCS
+};
+
+const MmWaveEesmErrorModel::BlerTables&
+MmWaveEesmErrorModel::GetBlerTables()
+{
+    if (m_blerTables != nullptr)
+    {
+        return *m_blerTables;
+    }
+
+    // the simulated tables are static, so are the lookup tables built from them
+    static std::mutex mutex;
+    static std::map<const SimulatedBlerFromSINR*, std::unique_ptr<BlerTables>> tables;
+
+    const SimulatedBlerFromSINR* simulated = GetSimulatedBlerFromSINR();
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<BlerTables>& entry = tables[simulated];
+    if (!entry)
+    {
+        NS_LOG_LOGIC("Building the BLER lookup tables of " << simulated);
+        entry = std::make_unique<BlerTables>();
+        for (const auto& bgCurves : *simulated)
+        {
+            entry->m_curves.emplace_back();
+            for (const auto& mcsCurves : bgCurves)
+            {
+                EesmCbSizeCurves curves;
+                for (const auto& cbCurve : mcsCurves)
+                {
+                    curves.m_cbSizes.push_back(cbCurve.first);
+                    curves.m_curves.emplace_back(std::get<0>(cbCurve.second),
+                                                 std::get<1>(cbCurve.second));
+                }
+                entry->m_curves.back().push_back(std::move(curves));
+            }
+        }
+    }
+    m_blerTables = entry.get();
+    return *m_blerTables;
+}
+
+/**
+ * \brief Compute in place the exponential of non-positive values, as std::exp
+ * within 1 ulp, in a loop that the compiler can vectorise
+ *
+ * The argument is reduced to x = k ln2 + r, with |r| <= ln2 / 2, exp(r) is
+ * evaluated with its Taylor polynomial of degree 13, whose truncation error is
+ * below 1e-17, and scaled by 2^k by building the exponent bits. The scaling
+ * is split in two steps, so that the subnormal results are rounded once.
+ *
+ * On x86-64 Linux with GCC, an AVX2 clone is selected at load time when the
+ * CPU supports it; FMA is not enabled, so that both clones give the same results.
+ *
+ * \param values the arguments, in [-746, 0], replaced by their exponentials
+ * \param n the number of values
+ */
+#if defined(__x86_64__) && defined(__linux__) && defined(__GNUC__) && !defined(__clang__)
+__attribute__((target_clones("avx2", "default")))
+#endif
+static void
+ExpNonPositive(double* values, std::size_t n)
+{
+    const double log2e = 1.4426950408889634;
+    const double ln2Hi = 6.93147180369123816490e-01; // ln2 with 32 bits of mantissa
+    const double ln2Lo = 1.90821492927058770002e-10; // ln2 - ln2Hi
+    const double shifter = 6755399441055744.0;       // 1.5 * 2^52, rounds to an integer
+    const double scaleDown = std::ldexp(1.0, -538);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        double x = values[i];
+        double kd = x * log2e + shifter;
+        double k = kd - shifter;
+        double r = x - k * ln2Hi - k * ln2Lo;
+
+        double p = 1.0 / 6227020800.0;
+        p = p * r + 1.0 / 479001600.0;
+        p = p * r + 1.0 / 39916800.0;
+        p = p * r + 1.0 / 3628800.0;
+        p = p * r + 1.0 / 362880.0;
+        p = p * r + 1.0 / 40320.0;
+        p = p * r + 1.0 / 5040.0;
+        p = p * r + 1.0 / 720.0;
+        p = p * r + 1.0 / 120.0;
+        p = p * r + 1.0 / 24.0;
+        p = p * r + 1.0 / 6.0;
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+
+        // the low bits of kd hold k, with k in [-1076, 0]: 2^(k + 538) is normal
+        uint64_t bits;
+        std::memcpy(&bits, &kd, sizeof(bits));
+        bits = (bits - 0x4338000000000000ULL + 1023 + 538) << 52;
+        double scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        values[i] = p * scale * scaleDown;
+    }
+}
+
 MmWaveEesmErrorModel::MmWaveEesmErrorModel()
     : MmWaveErrorModel()
 {
@@ -85,15 +283,24 @@ MmWaveEesmErrorModel::SinrEff(const SpectrumValue& sinr,
 
     double SINR = 0.0;
     double SINRsum = 0.0;
-    SpectrumValue sinrCopy = sinr;
 
     double beta = GetBetaTable()->at(mcs);
 
-    for (uint32_t i = 0; i < map.size(); i++)
+    constexpr std::size_t CHUNK = 64;
+    double terms[CHUNK];
+    for (std::size_t begin = 0; begin < map.size(); begin += CHUNK)
     {
-        double sinrLin = sinrCopy[map.at(i)];
-        SINR = exp(-sinrLin / beta);
-        SINRsum += SINR;
+        std::size_t n = std::min(CHUNK, map.size() - begin);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            // below -746, exp underflows to 0 as well
+            terms[i] = std::max(-sinr.ValuesAt(map[begin + i]) / beta, -746.0);
+        }
+        ExpNonPositive(terms, n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            SINRsum += terms[i];
+        }
     }
 
     SINR = -beta * log(SINRsum / map.size());
@@ -103,22 +310,6 @@ MmWaveEesmErrorModel::SinrEff(const SpectrumValue& sinr,
     return SINR;
 }
 
-const std::vector<double>&
-MmWaveEesmErrorModel::GetSinrDbVectorFromSimulatedValues(MmWaveEesmErrorModel::GraphType graphType,
-                                                         uint8_t mcs,
-                                                         uint32_t cbSizeIndex) const
-{
-    return std::get<0>(GetSimulatedBlerFromSINR()->at(graphType).at(mcs).at(cbSizeIndex));
-}
-
-const std::vector<double>&
-MmWaveEesmErrorModel::GetBLERVectorFromSimulatedValues(MmWaveEesmErrorModel::GraphType graphType,
-                                                       uint8_t mcs,
-                                                       uint32_t cbSizeIndex) const
-{
-    return std::get<1>(GetSimulatedBlerFromSINR()->at(graphType).at(mcs).at(cbSizeIndex));
-}
-
 double
 MmWaveEesmErrorModel::MappingSinrBler(double sinr, uint8_t mcs, uint32_t cbSizeBit)
 {
@@ -136,40 +327,15 @@ MmWaveEesmErrorModel::MappingSinrBler(double sinr, uint8_t mcs, uint32_t cbSizeB
     // Get the index of CBSIZE in the map
     NS_LOG_INFO("For sinr " << sinr << " and mcs " << +mcs << " CbSizebit " << cbSizeBit
                             << " we got bg type " << m_bgTypeName[bg_type]);
-    auto cbMap = GetSimulatedBlerFromSINR()->at(bg_type).at(mcs);
-    auto cbIt = cbMap.upper_bound(cbSizeBit);
+    const EesmCbSizeCurves& curves = GetBlerTables().m_curves.at(bg_type).at(mcs);
+    auto cbIt = std::upper_bound(curves.m_cbSizes.begin(), curves.m_cbSizes.end(), cbSizeBit);
 
-    if (cbIt != cbMap.begin())
+    if (cbIt != curves.m_cbSizes.begin())
     {
         cbIt--;
     }
 
-    if (sinr_db < GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).front())
-    {
-        bler = 1.0;
-    }
-    else if (sinr_db > GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).back())
-    {
-        bler = 0.0;
-    }
-    else
-    {
-        // Get the index of SINR in the vector
-        auto sinrIt =
-            std::upper_bound(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                             GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).end(),
-                             sinr_db);
-
-        if (sinrIt != GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin())
-        {
-            sinrIt--;
-        }
-
-        auto sinr_index =
-            std::distance(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                          sinrIt);
-        bler = GetBLERVectorFromSimulatedValues(bg_type, mcs, cbIt->first).at(sinr_index);
-    }
+    bler = curves.m_curves[cbIt - curves.m_cbSizes.begin()].Lookup(sinr_db);
 
     NS_LOG_LOGIC("SINR effective: " << sinr << " BLER:" << bler);
     return bler;
@@ -415,5 +581,13 @@ MmWaveEesmErrorModel::GetMaxMcs() const
     return static_cast<uint8_t>(GetMcsEcrTable()->size() - 1);
 }
 
+uint8_t
+MmWaveEesmErrorModel::GetModulationOrder(uint8_t mcs) const
+{
+    NS_ASSERT(GetMcsMTable() != nullptr);
+    NS_ABORT_IF(mcs > GetMaxMcs());
+    return GetMcsMTable()->at(mcs);
+}
+
 } // namespace mmwave
 } // namespace ns3
@@ -170,6 +170,11 @@ class MmWaveEesmErrorModel : public MmWaveErrorModel
      * \brief Get the maximum MCS. It depends on NR tables being used
      */
     virtual uint8_t GetMaxMcs() const override;
+    /**
+     * \brief Get the modulation order of a given MCS, following the MCSs in NR
+     * Table1/Table2 in TS38.214
+     */
+    virtual uint8_t GetModulationOrder(uint8_t mcs) const override;
 
     typedef std::vector<double> DoubleVector;
     typedef std::tuple<DoubleVector, DoubleVector> DoubleTuple;
@@ -187,6 +192,10 @@ class MmWaveEesmErrorModel : public MmWaveErrorModel
      * \brief compute the effective SINR for the specified MCS and SINR, according
      * to the EESM method
      *
+     * The SINRs of the active RBs are gathered in contiguous chunks, whose
+     * exponentials are evaluated by a vectorisable kernel with an error within
+     * 1 ulp of std::exp, and summed in RB order.
+     *
      * \param sinr the perceived sinrs in the whole bandwidth (vector, per RB)
      * \param map the actives RBs for the TB
      * \param mcs the MCS of the TB
@@ -256,10 +265,29 @@ class MmWaveEesmErrorModel : public MmWaveErrorModel
   private:
     static std::vector<std::string> m_bgTypeName; //!< Base graph name
 
+    /**
+     * \brief Dense BLER lookup tables, defined in the implementation
+     */
+    struct BlerTables;
+
+    /**
+     * \brief Get the dense lookup tables of GetSimulatedBlerFromSINR, which are
+     * built on first use and shared by all the instances using the same table
+     * \return the lookup tables
+     */
+    const BlerTables& GetBlerTables();
+
+    const BlerTables* m_blerTables{nullptr}; //!< lookup tables, see GetBlerTables
+
     /**
      * \brief map the effective SINR into CBLER for the specified MCS and CB size,
      * according to the EESM method
      *
+     * The curve of the CB size is found in a flat table, and the SINR point in
+     * a uniform grid of buckets over the SINR range of the curve, each holding
+     * the last point before the bucket, so that the BLER is the same as with a
+     * binary search over the simulated points.
+     *
      * \param sinrEff effective SINR per bit of a code-block
      * \param mcs the MCS of the TB
      * \param cbSize the size of the CB in BITS
@@ -317,27 +345,6 @@ class MmWaveEesmErrorModel : public MmWaveErrorModel
      * the number of code blocks
      */
     std::pair<uint32_t, uint32_t> CodeBlockSegmentation(uint32_t B, GraphType bg_type) const;
-
-    /**
-     * \brief Get SinrDb Vector From Simulated Values
-     * \param graphType
-     * \param mcs
-     * \param cbSizeIndex
-     * \return
-     */
-    const std::vector<double>& GetSinrDbVectorFromSimulatedValues(GraphType graphType,
-                                                                  uint8_t mcs,
-                                                                  uint32_t cbSizeIndex) const;
-    /**
-     * \brief Get BLER Vector From Simulated Values
-     * \param graphType
-     * \param mcs
-     * \param cbSizeIndex
-     * \return
-     */
-    const std::vector<double>& GetBLERVectorFromSimulatedValues(GraphType graphType,
-                                                                uint8_t mcs,
-                                                                uint32_t cbSizeIndex) const;
 };
 
 } // namespace mmwave
@@ -202,6 +202,18 @@ class MmWaveErrorModel : public Object
      * \return the maximum MCS that is permitted with the error model
      */
     virtual uint8_t GetMaxMcs() const = 0;
+
+    /**
+     * \brief Get the modulation order of a given MCS
+     *
+     * For a given SINR vector the TBLER does not decrease with the MCS among
+     * the MCSs with the same modulation order, but it may decrease when the
+     * modulation order increases, since the effective SINR depends on it.
+     *
+     * \param mcs MCS
+     * \return the number of bits per symbol of the modulation of the MCS
+     */
+    virtual uint8_t GetModulationOrder(uint8_t mcs) const = 0;
 };
 
 } // namespace mmwave
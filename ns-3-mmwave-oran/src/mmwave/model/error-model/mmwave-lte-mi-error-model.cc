@@ -1312,5 +1312,12 @@ MmWaveLteMiErrorModel::GetMaxMcs() const
     return 28;
 }
 
+uint8_t
+MmWaveLteMiErrorModel::GetModulationOrder(uint8_t mcs) const
+{
+    NS_ABORT_IF(mcs > GetMaxMcs());
+    return ModulationSchemeForMcs[mcs];
+}
+
 } // namespace mmwave
 } // namespace ns3
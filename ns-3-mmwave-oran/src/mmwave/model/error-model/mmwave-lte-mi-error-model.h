@@ -159,6 +159,10 @@ class MmWaveLteMiErrorModel : public MmWaveErrorModel
      */
     virtual uint32_t GetMaxCbSize(uint32_t tbSize, uint8_t mcs) const override;
     virtual uint8_t GetMaxMcs() const override;
+    /**
+     * \brief Get the modulation order of a given MCS, following the MCSs in LTE
+     */
+    virtual uint8_t GetModulationOrder(uint8_t mcs) const override;
 
   private:
     /**
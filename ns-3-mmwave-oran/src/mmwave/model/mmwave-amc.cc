@@ -34,6 +34,9 @@
 #include <ns3/object-factory.h>
 #include <ns3/uinteger.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace ns3
 {
 
@@ -62,6 +65,7 @@ MmWaveAmc::SetDlMode()
 {
     NS_LOG_FUNCTION(this);
     m_emMode = MmWaveErrorModel::DL;
+    m_cqiCache.clear();
 }
 
 void
@@ -69,6 +73,7 @@ MmWaveAmc::SetUlMode()
 {
     NS_LOG_FUNCTION(this);
     m_emMode = MmWaveErrorModel::UL;
+    m_cqiCache.clear();
 }
 
 TypeId
@@ -99,6 +104,13 @@ MmWaveAmc::GetTypeId(void)
                 TypeIdValue(MmWaveEesmIrT1::GetTypeId()),
                 MakeTypeIdAccessor(&MmWaveAmc::SetErrorModelType, &MmWaveAmc::GetErrorModelType),
                 MakeTypeIdChecker())
+            .AddAttribute("CqiCacheSize",
+                          "Number of SINR vectors whose CQI feedback is cached, when AmcModel is "
+                          "set to ErrorModel. 0 disables the cache",
+                          UintegerValue(16),
+                          MakeUintegerAccessor(&MmWaveAmc::SetCqiCacheSize,
+                                               &MmWaveAmc::GetCqiCacheSize),
+                          MakeUintegerChecker<uint32_t>())
             .AddConstructor<MmWaveAmc>();
     return tid;
 }
@@ -249,40 +261,45 @@ MmWaveAmc::CreateCqiFeedbackWbTdma(const SpectrumValue& sinr, uint8_t& mcs) cons
     }
     else if (m_amcModel == ErrorModel)
     {
-        std::vector<int> rbMap;
-        int rbId = 0;
+        // FNV-1a hash of the SINR values, which also define the RB map
+        uint64_t hash = 14695981039346656037ULL;
         for (it = sinr.ConstValuesBegin(); it != sinr.ConstValuesEnd(); it++)
         {
-            if (*it != 0.0)
-            {
-                rbMap.push_back(rbId);
-            }
-            rbId += 1;
+            uint64_t bits;
+            std::memcpy(&bits, &(*it), sizeof(bits));
+            hash = (hash ^ bits) * 1099511628211ULL;
         }
 
-        mcs = 0;
-        Ptr<MmWaveErrorModelOutput> output;
-        while (mcs <= m_errorModel->GetMaxMcs())
+        for (const auto& entry : m_cqiCache)
         {
-            output =
-                m_errorModel->GetTbDecodificationStats(sinr,
-                                                       rbMap,
-                                                       CalculateTbSize(mcs, m_numSymForCqi),
-                                                       mcs,
-                                                       MmWaveErrorModel::MmWaveErrorModelHistory());
-            if (output->m_tbler > 0.1)
+            if (entry.m_hash == hash && entry.m_sinr.size() == sinr.GetValuesN() &&
+                std::equal(entry.m_sinr.begin(), entry.m_sinr.end(), sinr.ConstValuesBegin()))
             {
-                break;
+                mcs = entry.m_mcs;
+                NS_LOG_DEBUG(this << "\t MCS " << (uint16_t)mcs << "-> CQI " << +entry.m_cqi
+                                  << " (cached)");
+                return entry.m_cqi;
             }
-            mcs++;
         }
 
-        if (mcs > 0)
+        std::vector<int> rbMap;
+        int rbId = 0;
+        for (it = sinr.ConstValuesBegin(); it != sinr.ConstValuesEnd(); it++)
         {
-            mcs--;
+            if (*it != 0.0)
+            {
+                rbMap.push_back(rbId);
+            }
+            rbId += 1;
         }
 
-        if ((output->m_tbler > 0.1) && (mcs == 0))
+        // as in a search over all the MCSs in increasing order, the MCS before the
+        // first one with a TBLER above 10 % is selected, with a CQI of 0 if the
+        // first one is MCS 0 or 1
+        uint16_t firstUndecodable = FindFirstUndecodableMcs(sinr, rbMap);
+        mcs = firstUndecodable > 0 ? firstUndecodable - 1 : 0;
+
+        if (firstUndecodable <= 1)
         {
             cqi = 0;
         }
@@ -300,10 +317,67 @@ MmWaveAmc::CreateCqiFeedbackWbTdma(const SpectrumValue& sinr, uint8_t& mcs) cons
             }
         }
         NS_LOG_DEBUG(this << "\t MCS " << (uint16_t)mcs << "-> CQI " << cqi);
+
+        if (m_cqiCacheSize > 0)
+        {
+            if (m_cqiCache.size() < m_cqiCacheSize)
+            {
+                m_cqiCache.emplace_back();
+                m_cqiCacheNext = m_cqiCache.size() - 1;
+            }
+            CqiCacheEntry& entry = m_cqiCache[m_cqiCacheNext];
+            entry.m_hash = hash;
+            entry.m_sinr.assign(sinr.ConstValuesBegin(), sinr.ConstValuesEnd());
+            entry.m_cqi = cqi;
+            entry.m_mcs = mcs;
+            m_cqiCacheNext = (m_cqiCacheNext + 1) % m_cqiCacheSize;
+        }
     }
     return cqi;
 }
 
+uint16_t
+MmWaveAmc::FindFirstUndecodableMcs(const SpectrumValue& sinr, const std::vector<int>& rbMap) const
+{
+    NS_LOG_FUNCTION(this);
+
+    // the TBLER does not decrease with the MCS only among the MCSs with the same
+    // modulation order, thus each group is bisected in turn, and the search stops
+    // at the first group with an undecodable MCS
+    uint16_t groupBegin = 0;
+    for (uint8_t groupEnd : m_modulationGroupEnds)
+    {
+        // the first undecodable MCS of the group is in [low, high], where
+        // high = groupEnd means that all the MCSs of the group can be decoded
+        uint16_t low = groupBegin;
+        uint16_t high = groupEnd;
+        while (low < high)
+        {
+            uint8_t mid = (low + high) / 2;
+            Ptr<MmWaveErrorModelOutput> output =
+                m_errorModel->GetTbDecodificationStats(sinr,
+                                                       rbMap,
+                                                       CalculateTbSize(mid, m_numSymForCqi),
+                                                       mid,
+                                                       MmWaveErrorModel::MmWaveErrorModelHistory());
+            if (output->m_tbler > 0.1)
+            {
+                high = mid;
+            }
+            else
+            {
+                low = mid + 1;
+            }
+        }
+        if (low < groupEnd)
+        {
+            return low;
+        }
+        groupBegin = groupEnd;
+    }
+    return groupBegin;
+}
+
 uint8_t
 MmWaveAmc::GetCqiFromSpectralEfficiency(double s) const
 {
@@ -364,6 +438,17 @@ MmWaveAmc::SetErrorModelType(const TypeId& type)
     factory.SetTypeId(m_errorModelType);
     m_errorModel = DynamicCast<MmWaveErrorModel>(factory.Create());
     NS_ASSERT(m_errorModel != nullptr);
+    m_cqiCache.clear();
+
+    m_modulationGroupEnds.clear();
+    for (uint16_t mcs = 1; mcs <= m_errorModel->GetMaxMcs(); ++mcs)
+    {
+        if (m_errorModel->GetModulationOrder(mcs) != m_errorModel->GetModulationOrder(mcs - 1))
+        {
+            m_modulationGroupEnds.push_back(mcs);
+        }
+    }
+    m_modulationGroupEnds.push_back(m_errorModel->GetMaxMcs() + 1);
 }
 
 TypeId
@@ -373,6 +458,21 @@ MmWaveAmc::GetErrorModelType() const
     return m_errorModelType;
 }
 
+void
+MmWaveAmc::SetCqiCacheSize(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+    m_cqiCacheSize = size;
+    m_cqiCache.clear();
+    m_cqiCacheNext = 0;
+}
+
+uint32_t
+MmWaveAmc::GetCqiCacheSize() const
+{
+    return m_cqiCacheSize;
+}
+
 } // end namespace mmwave
 
 } // end namespace ns3
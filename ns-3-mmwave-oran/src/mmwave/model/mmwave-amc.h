@@ -28,6 +28,8 @@
 
 #include <ns3/mmwave-error-model.h>
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -131,6 +133,12 @@ class MmWaveAmc : public Object
      * which the gNB/UE has transmitted power, and from which the SINR can be
      * measured, during 1 OFDM symbol, is assumed.
      *
+     * With the ErrorModel AMC, the selected MCS is the one before the first
+     * MCS with a TBLER above 10 %, which is found by bisection over the MCSs of
+     * each modulation order, among which the TBLER does not decrease. The
+     * feedback of the last CqiCacheSize SINR vectors is cached, since the same
+     * SINR is often reported in several slots.
+     *
      * \param sinr the sinr values
      * \param mcsWb The calculated MCS
      * \return The calculated CQI
@@ -222,6 +230,38 @@ class MmWaveAmc : public Object
     uint32_t GetPayloadSize(uint8_t mcs, uint8_t nSym) const;
 
   private:
+    /**
+     * \brief Feedback computed for a SINR vector
+     */
+    struct CqiCacheEntry
+    {
+        uint64_t m_hash;            //!< hash of m_sinr
+        std::vector<double> m_sinr; //!< SINR values, which also define the RB map
+        uint8_t m_cqi;              //!< CQI
+        uint8_t m_mcs;              //!< MCS
+    };
+
+    /**
+     * \brief Find the first MCS whose TBLER is above 10 %, by bisection over the
+     * MCSs of each modulation order
+     * \param sinr the sinr values
+     * \param rbMap the RBs with a non-zero SINR
+     * \return the first MCS that cannot be decoded, or the maximum MCS plus one
+     */
+    uint16_t FindFirstUndecodableMcs(const SpectrumValue& sinr, const std::vector<int>& rbMap) const;
+
+    /**
+     * \brief Set the number of SINR vectors whose feedback is cached, and clear the cache
+     * \param size the number of entries, 0 to disable the cache
+     */
+    void SetCqiCacheSize(uint32_t size);
+
+    /**
+     * \brief Get the number of SINR vectors whose feedback is cached
+     * \return the number of entries
+     */
+    uint32_t GetCqiCacheSize() const;
+
     double m_ber;                       //!< The target BER. Used only by the ShannonModel AMC
     AmcModel m_amcModel;                //!< Type of the CQI feedback model
     Ptr<MmWaveErrorModel> m_errorModel; //!< Pointer to an instance of ErrorModel
@@ -232,6 +272,11 @@ class MmWaveAmc : public Object
         12; //!< The number of PDSCH OFDM symbols to be used for CQI determination. See Sec. 5.2.2.5
             //!< of TS 38.214
     Ptr<MmWavePhyMacCommon> m_phyMacConfig; //!< Pointer to an instance of MmWavePhyMacCommon
+
+    std::vector<uint8_t> m_modulationGroupEnds;    //!< first MCS after each modulation order
+    uint32_t m_cqiCacheSize{0};                    //!< maximum number of cached SINR vectors
+    mutable std::vector<CqiCacheEntry> m_cqiCache; //!< feedback of the last SINR vectors
+    mutable uint32_t m_cqiCacheNext{0};            //!< next entry to replace, round robin
 };
 
 } // end namespace mmwave
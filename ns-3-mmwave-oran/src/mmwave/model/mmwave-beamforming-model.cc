@@ -34,6 +34,7 @@
 #include "ns3/phased-array-model.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
 #include "ns3/uinteger.h"
 
 #include <algorithm>
@@ -116,6 +117,27 @@ MmWaveBeamformingModel::SetAntenna(Ptr<PhasedArrayModel> antenna)
     m_antenna = antenna;
 }
 
+void
+MmWaveBeamformingModel::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
+                                                      Ptr<PhasedArrayModel> otherAntenna)
+{
+    NS_LOG_FUNCTION(this << otherDevice << otherAntenna);
+
+    BeamformingVectors bfVectors = GetBeamformingVectorsForDevice(otherDevice, otherAntenna);
+
+    // configure the antennas to use the new beamforming vectors
+    m_antenna->SetBeamformingVector(bfVectors.first);
+    NS_LOG_LOGIC("antenna " << m_antenna << " set BF vector"
+                            << " numAntennaElem " << m_antenna->GetNumberOfElements()
+                            << " this device ID=" << m_device->GetNode()->GetId()
+                            << " otherDevice ID=" << otherDevice->GetNode()->GetId());
+    otherAntenna->SetBeamformingVector(bfVectors.second);
+    NS_LOG_LOGIC("antenna " << otherAntenna << " set BF vector"
+                            << " numAntennaElem " << otherAntenna->GetNumberOfElements()
+                            << " this device ID=" << otherDevice->GetNode()->GetId()
+                            << " otherDevice ID=" << m_device->GetNode()->GetId());
+}
+
 /*----------------------------------------------------------------------------*/
 
 NS_OBJECT_ENSURE_REGISTERED(MmWaveDftBeamforming);
@@ -138,9 +160,9 @@ MmWaveDftBeamforming::~MmWaveDftBeamforming()
 {
 }
 
-void
-MmWaveDftBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
-                                                    Ptr<PhasedArrayModel> otherAntenna)
+MmWaveBeamformingModel::BeamformingVectors
+MmWaveDftBeamforming::GetBeamformingVectorsForDevice(Ptr<NetDevice> otherDevice,
+                                                     Ptr<PhasedArrayModel> otherAntenna)
 {
     NS_LOG_FUNCTION(this << otherDevice << otherAntenna);
 
@@ -157,17 +179,17 @@ MmWaveDftBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
     // compute the azimuth and the elevation angles
     Angles completeAngle(bPos, aPos);
 
-    // configure the antenna to use the new beamforming vector
+    // compute the beamforming vector pointing the antenna to the other device
     PhasedArrayModel::ComplexVector antennaWeights = m_antenna->GetBeamformingVector(completeAngle);
-    m_antenna->SetBeamformingVector(antennaWeights);
 
     // compute the azimuth and the elevation angles for the other device
     Angles completeAngleOtherDevice(aPos, bPos);
 
-    // configure the antenna of the other device to use the new beamforming vector
+    // compute the beamforming vector pointing the antenna of the other device to this device
     PhasedArrayModel::ComplexVector otherAntennaWeights =
         otherAntenna->GetBeamformingVector(completeAngleOtherDevice);
-    otherAntenna->SetBeamformingVector(otherAntennaWeights);
+
+    return std::make_pair(antennaWeights, otherAntennaWeights);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -227,9 +249,9 @@ MmWaveSvdBeamforming::DoDispose(void)
     MmWaveBeamformingModel::DoDispose();
 }
 
-void
-MmWaveSvdBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
-                                                    Ptr<PhasedArrayModel> otherAntenna)
+MmWaveBeamformingModel::BeamformingVectors
+MmWaveSvdBeamforming::GetBeamformingVectorsForDevice(Ptr<NetDevice> otherDevice,
+                                                     Ptr<PhasedArrayModel> otherAntenna)
 {
     NS_LOG_FUNCTION(this << otherDevice << otherAntenna);
 
@@ -241,7 +263,7 @@ MmWaveSvdBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
     // this will trigger a new computation (if needed)
     auto channelMatrix = m_channel->GetChannel(thisMob, otherMob, m_antenna, otherAntenna);
 
-    std::pair<PhasedArrayModel::ComplexVector, PhasedArrayModel::ComplexVector> bfVectors;
+    BeamformingVectors bfVectors;
 
     bool toCache{false};
 
@@ -286,18 +308,6 @@ MmWaveSvdBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
         }
     }
 
-    // configure the antenna to use the new beamforming vector
-    m_antenna->SetBeamformingVector(std::get<0>(bfVectors));
-    NS_LOG_LOGIC("antenna " << m_antenna << " set BF vector"
-                            << " numAntennaElem " << m_antenna->GetNumberOfElements()
-                            << " this device ID=" << m_device->GetNode()->GetId()
-                            << " otherDevice ID=" << otherDevice->GetNode()->GetId());
-    otherAntenna->SetBeamformingVector(std::get<1>(bfVectors));
-    NS_LOG_LOGIC("antenna " << otherAntenna << " set BF vector"
-                            << " numAntennaElem " << otherAntenna->GetNumberOfElements()
-                            << " this device ID=" << otherDevice->GetNode()->GetId()
-                            << " otherDevice ID=" << m_device->GetNode()->GetId());
-
     if (toCache)
     {
         auto entry{m_cacheChannelMap.find(otherDevice)};
@@ -313,6 +323,8 @@ MmWaveSvdBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
             m_cacheBfVectors.insert(std::make_pair(otherDevice, bfVectors));
         }
     }
+
+    return bfVectors;
 }
 
 std::pair<PhasedArrayModel::ComplexVector, PhasedArrayModel::ComplexVector>
@@ -472,11 +484,21 @@ MmWaveCodebookBeamforming::GetTypeId()
                           "Specify the channel coherence time",
                           TimeValue(MilliSeconds(0.0)),
                           MakeTimeAccessor(&MmWaveCodebookBeamforming::m_updatePeriod),
-                          MakeTimeChecker());
+                          MakeTimeChecker())
+            .AddAttribute("BatchedSearch",
+                          "If true, and the PhasedArraySpectrumPropagationLossModel is a "
+                          "ThreeGppSpectrumPropagationLossModel, the gains of all the beam "
+                          "pairs are computed from a single channel matrix, instead of "
+                          "computing the received PSD of each pair. The selected pair is the "
+                          "same.",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&MmWaveCodebookBeamforming::m_batchedSearch),
+                          MakeBooleanChecker());
     return tid;
 }
 
 MmWaveCodebookBeamforming::MmWaveCodebookBeamforming()
+    : m_batchedSearch(true)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -508,6 +530,7 @@ MmWaveCodebookBeamforming::SetMmWavePhyMacCommon(Ptr<MmWavePhyMacCommon> mwpmc)
         mwpmc,
         0.0,
         activeRbs); // TODO should i copy this?
+    m_beamSearch.SetTxPsd(*m_txPsd);
 }
 
 void
@@ -530,9 +553,9 @@ MmWaveCodebookBeamforming::DoInitialize(void)
     // TODO what if SetAntenna is used?
 }
 
-void
-MmWaveCodebookBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
-                                                         Ptr<PhasedArrayModel> otherAntenna)
+MmWaveBeamformingModel::BeamformingVectors
+MmWaveCodebookBeamforming::GetBeamformingVectorsForDevice(Ptr<NetDevice> otherDevice,
+                                                          Ptr<PhasedArrayModel> otherAntenna)
 {
     NS_LOG_FUNCTION(this << otherDevice << otherAntenna);
 
@@ -564,8 +587,12 @@ MmWaveCodebookBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDev
 
     if (notFound || update)
     {
-        MmWaveCodebookBeamforming::Matrix2D powerMatrix =
-            ComputeBeamformingCodebookMatrix(otherDevice, otherAntenna);
+        MmWaveCodebookBeamforming::Matrix2D powerMatrix;
+        if (!m_batchedSearch ||
+            !ComputeBeamformingCodebookMatrixBatched(otherDevice, otherAntenna, powerMatrix))
+        {
+            powerMatrix = ComputeBeamformingCodebookMatrix(otherDevice, otherAntenna);
+        }
 
         // find best beam couple
         std::vector<double> maxPowers;
@@ -596,15 +623,12 @@ MmWaveCodebookBeamforming::SetBeamformingVectorForDevice(Ptr<NetDevice> otherDev
         m_codebookIdsCache[otherAntenna] = newEntry;
     }
 
-    // set best BF codewords for both devices
+    // best BF codewords for both devices
     Ptr<BeamformingCodebook> thisCodebook = m_antenna->GetObject<BeamformingCodebook>();
     Ptr<BeamformingCodebook> otherCodebook = otherAntenna->GetObject<BeamformingCodebook>();
 
-    PhasedArrayModel::ComplexVector thisAntennaWeights = thisCodebook->GetCodeword(thisCbIdx);
-    PhasedArrayModel::ComplexVector otherAntennaWeights = otherCodebook->GetCodeword(otherCbIdx);
-
-    m_antenna->SetBeamformingVector(thisAntennaWeights);
-    otherAntenna->SetBeamformingVector(otherAntennaWeights);
+    return std::make_pair(thisCodebook->GetCodeword(thisCbIdx),
+                          otherCodebook->GetCodeword(otherCbIdx));
 }
 
 MmWaveCodebookBeamforming::Matrix2D
@@ -649,24 +673,7 @@ MmWaveCodebookBeamforming::ComputeBeamformingCodebookMatrix(
         {
             otherAntenna->SetBeamformingVector(otherCodebook->GetCodeword(otherIdx));
 
-            Ptr<SpectrumValue> rxPsd;
-            Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters>();
-            rxParams->psd = Copy<SpectrumValue>(m_txPsd); // PSD needs to be initialized
-
-            if (m_splm)
-            {
-                rxPsd = m_splm->CalcRxPowerSpectralDensity(rxParams, thisMob, otherMob);
-            }
-            else if (m_pSplm)
-            {
-                rxPsd = m_pSplm->CalcRxPowerSpectralDensity(rxParams,
-                                                            thisMob,
-                                                            otherMob,
-                                                            m_antenna,
-                                                            otherAntenna);
-            }
-
-            double avgRxPsd = Sum(*rxPsd) / (rxPsd->GetSpectrumModel()->GetNumBands());
+            double avgRxPsd = ComputeAvgRxPsd(thisMob, otherMob, otherAntenna);
             matrix[thisIdx].push_back(avgRxPsd);
         }
     }
@@ -682,5 +689,146 @@ MmWaveCodebookBeamforming::ComputeBeamformingCodebookMatrix(
     return matrix;
 }
 
+bool
+MmWaveCodebookBeamforming::ComputeBeamformingCodebookMatrixBatched(
+    Ptr<NetDevice> otherDevice,
+    Ptr<PhasedArrayModel> otherAntenna,
+    MmWaveCodebookBeamforming::Matrix2D& matrix)
+{
+    NS_LOG_FUNCTION(this << otherDevice << otherAntenna);
+
+    Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+        DynamicCast<ThreeGppSpectrumPropagationLossModel>(m_pSplm);
+    if (m_splm || !threeGppSplm || !m_txPsd)
+    {
+        return false;
+    }
+    Ptr<MatrixBasedChannelModel> channelModel = threeGppSplm->GetChannelModel();
+
+    Ptr<BeamformingCodebook> thisCodebook = m_antenna->GetObject<BeamformingCodebook>();
+    Ptr<BeamformingCodebook> otherCodebook = otherAntenna->GetObject<BeamformingCodebook>();
+
+    Ptr<MobilityModel> thisMob = m_device->GetNode()->GetObject<MobilityModel>();
+    Ptr<MobilityModel> otherMob = otherDevice->GetNode()->GetObject<MobilityModel>();
+
+    // the channel and the parameters are the ones that the PSD of each pair would use, with
+    // this device as node a and the other device as node b
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix =
+        channelModel->GetChannel(thisMob, otherMob, m_antenna, otherAntenna);
+    Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams =
+        channelModel->GetParams(thisMob, otherMob);
+    DoubleValue frequency;
+    channelModel->GetAttribute("Frequency", frequency);
+
+    const MmWaveCodebookBeamSearch::CodebookMatrix& thisMatrix =
+        m_beamSearch.GetCodebookMatrix(thisCodebook);
+    const MmWaveCodebookBeamSearch::CodebookMatrix& otherMatrix =
+        m_beamSearch.GetCodebookMatrix(otherCodebook);
+
+    bool isReverse = channelMatrix->IsReverse(m_antenna->GetId(), otherAntenna->GetId());
+    const std::vector<double>& gains =
+        m_beamSearch.ComputeGains(channelMatrix,
+                                  channelParams,
+                                  frequency.Get(),
+                                  Simulator::Now().GetSeconds(),
+                                  thisMob->GetVelocity(),
+                                  otherMob->GetVelocity(),
+                                  isReverse ? otherMatrix : thisMatrix,
+                                  isReverse ? thisMatrix : otherMatrix);
+
+    uint32_t thisSize = thisMatrix.m_size;
+    uint32_t otherSize = otherMatrix.m_size;
+    matrix.assign(thisSize, std::vector<double>(otherSize));
+    double maxGain = 0;
+    for (uint32_t thisIdx = 0; thisIdx < thisSize; thisIdx++)
+    {
+        for (uint32_t otherIdx = 0; otherIdx < otherSize; otherIdx++)
+        {
+            double gain = isReverse ? gains[otherIdx * thisSize + thisIdx]
+                                    : gains[thisIdx * otherSize + otherIdx];
+            matrix[thisIdx][otherIdx] = gain;
+            maxGain = std::max(maxGain, gain);
+        }
+    }
+
+    // The gains differ from the PSD only by rounding errors, far below this
+    // relative tolerance: the pair of the exhaustive search is one of the pairs
+    // within the tolerance of the maximum, and any other pair is below it with
+    // either computation. The candidates are evaluated again with the PSD, so
+    // that near ties are broken exactly as by the exhaustive search.
+    const double tieTolerance = 1e-6;
+    std::vector<std::pair<uint32_t, uint32_t>> candidates;
+    for (uint32_t thisIdx = 0; thisIdx < thisSize; thisIdx++)
+    {
+        for (uint32_t otherIdx = 0; otherIdx < otherSize; otherIdx++)
+        {
+            if (matrix[thisIdx][otherIdx] >= maxGain * (1 - tieTolerance))
+            {
+                candidates.emplace_back(thisIdx, otherIdx);
+            }
+        }
+    }
+    NS_LOG_DEBUG("Matrix of size " << thisSize << "x" << otherSize << ", " << candidates.size()
+                                   << " candidates");
+
+    if (candidates.size() > 1)
+    {
+        for (const auto& candidate : candidates)
+        {
+            matrix[candidate.first][candidate.second] =
+                ComputeAvgRxPsd(threeGppSplm,
+                                thisMob,
+                                otherMob,
+                                otherAntenna,
+                                thisCodebook->GetCodeword(candidate.first),
+                                otherCodebook->GetCodeword(candidate.second));
+        }
+    }
+
+    return true;
+}
+
+double
+MmWaveCodebookBeamforming::ComputeAvgRxPsd(Ptr<MobilityModel> thisMob,
+                                           Ptr<MobilityModel> otherMob,
+                                           Ptr<PhasedArrayModel> otherAntenna) const
+{
+    Ptr<SpectrumValue> rxPsd;
+    Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters>();
+    rxParams->psd = Copy<SpectrumValue>(m_txPsd); // PSD needs to be initialized
+
+    if (m_splm)
+    {
+        rxPsd = m_splm->CalcRxPowerSpectralDensity(rxParams, thisMob, otherMob);
+    }
+    else if (m_pSplm)
+    {
+        rxPsd = m_pSplm->CalcRxPowerSpectralDensity(rxParams,
+                                                    thisMob,
+                                                    otherMob,
+                                                    m_antenna,
+                                                    otherAntenna);
+    }
+
+    return Sum(*rxPsd) / (rxPsd->GetSpectrumModel()->GetNumBands());
+}
+
+double
+MmWaveCodebookBeamforming::ComputeAvgRxPsd(Ptr<ThreeGppSpectrumPropagationLossModel> splm,
+                                           Ptr<MobilityModel> thisMob,
+                                           Ptr<MobilityModel> otherMob,
+                                           Ptr<PhasedArrayModel> otherAntenna,
+                                           const PhasedArrayModel::ComplexVector& thisW,
+                                           const PhasedArrayModel::ComplexVector& otherW) const
+{
+    // same result as the PSD computed with the vectors set on the antennas
+    ThreeGppSpectrumPropagationLossModel::RxPsdSnapshot snapshot;
+    splm->GetRxPsdSnapshot(thisMob, otherMob, m_antenna, otherAntenna, thisW, otherW, snapshot);
+    Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue>(m_txPsd);
+    ThreeGppSpectrumPropagationLossModel::CalcRxPowerSpectralDensityFromSnapshot(snapshot, *rxPsd);
+
+    return Sum(*rxPsd) / (rxPsd->GetSpectrumModel()->GetNumBands());
+}
+
 } // namespace mmwave
 } // namespace ns3
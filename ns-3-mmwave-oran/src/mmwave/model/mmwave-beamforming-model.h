@@ -21,6 +21,7 @@
 
 #include "ns3/beamforming-codebook.h"
 #include "ns3/matrix-based-channel-model.h"
+#include "ns3/mmwave-codebook-beam-search.h"
 #include "ns3/object-factory.h"
 #include "ns3/object.h"
 #include "ns3/phased-array-spectrum-propagation-loss-model.h"
@@ -37,6 +38,7 @@ class MobilityModel;
 class PhasedArrayModel;
 class NetDevice;
 class ChannelConditionModel;
+class ThreeGppSpectrumPropagationLossModel;
 
 namespace mmwave
 {
@@ -50,6 +52,13 @@ class MmWavePhyMacCommon;
 class MmWaveBeamformingModel : public Object
 {
   public:
+    /**
+     * The beamforming vectors of a pair of antennas, i.e., of the antenna of
+     * this model and of the antenna of the other device, in this order
+     */
+    using BeamformingVectors =
+        std::pair<PhasedArrayModel::ComplexVector, PhasedArrayModel::ComplexVector>;
+
     /**
      * Constructor
      */
@@ -91,13 +100,25 @@ class MmWaveBeamformingModel : public Object
     void SetAntenna(Ptr<PhasedArrayModel> antenna);
 
     /**
-     * Computes the beamforming vector to communicate with the target device and antenna
-     * and configures the antenna
+     * Computes the beamforming vectors to communicate with the target device and antenna
+     * and configures both antennas
      * \param otherDevice the target device
      * \param otherAntenna the target antenna of otherDevice
      */
     virtual void SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
-                                               Ptr<PhasedArrayModel> otherAntenna) = 0;
+                                               Ptr<PhasedArrayModel> otherAntenna);
+
+    /**
+     * Computes the beamforming vectors that SetBeamformingVectorForDevice would
+     * set, without configuring the antennas, e.g., to probe the gain towards a
+     * device other than the one currently served
+     * \param otherDevice the target device
+     * \param otherAntenna the target antenna of otherDevice
+     * \return the beamforming vectors of this antenna and of otherAntenna
+     */
+    virtual BeamformingVectors GetBeamformingVectorsForDevice(
+        Ptr<NetDevice> otherDevice,
+        Ptr<PhasedArrayModel> otherAntenna) = 0;
 
   protected:
     virtual void DoDispose(void) override;
@@ -131,13 +152,14 @@ class MmWaveDftBeamforming : public MmWaveBeamformingModel
     static TypeId GetTypeId(void);
 
     /**
-     * Computes the beamforming vector to communicate with the target device and antenna
-     * and configures the antenna
+     * Computes the beamforming vectors pointing this antenna and otherAntenna
+     * towards each other
      * \param otherDevice the target device
      * \param otherAntenna the target antenna of otherDevice
+     * \return the beamforming vectors of this antenna and of otherAntenna
      */
-    void SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
-                                       Ptr<PhasedArrayModel> otherAntenna) override;
+    BeamformingVectors GetBeamformingVectorsForDevice(Ptr<NetDevice> otherDevice,
+                                                      Ptr<PhasedArrayModel> otherAntenna) override;
 };
 
 /**
@@ -165,15 +187,15 @@ class MmWaveSvdBeamforming : public MmWaveBeamformingModel
     static TypeId GetTypeId(void);
 
     /**
-     * Computes the beamforming vector to communicate with the target device
-     * and sets the antenna.
-     * The beamforming vector is computed using a SVD-based beamforming
+     * Computes the beamforming vectors to communicate with the target device.
+     * The beamforming vectors are computed using a SVD-based beamforming
      * algorithm.
      * \param otherDevice the target device
      * \param otherAntenna the target antenna of otherDevice
+     * \return the beamforming vectors of this antenna and of otherAntenna
      */
-    void SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
-                                       Ptr<PhasedArrayModel> otherAntenna) override;
+    BeamformingVectors GetBeamformingVectorsForDevice(Ptr<NetDevice> otherDevice,
+                                                      Ptr<PhasedArrayModel> otherAntenna) override;
 
   private:
     void DoDispose(void) override;
@@ -255,13 +277,18 @@ class MmWaveCodebookBeamforming : public MmWaveBeamformingModel
     void DoInitialize(void) override;
 
     /**
-     * Computes the beamforming vector to communicate with the target device and antenna
-     * and configures the antenna
+     * Returns the codewords of the best beam pair to communicate with the
+     * target device and antenna. The best pair is searched again if it is not
+     * known yet or older than the update period. The batched search does not
+     * configure the antennas, while the exhaustive search configures them for
+     * each pair, and then restores their vectors unless it is the initial
+     * search for otherAntenna.
      * \param otherDevice the target device
      * \param otherAntenna the target antenna of otherDevice
+     * \return the beamforming vectors of this antenna and of otherAntenna
      */
-    void SetBeamformingVectorForDevice(Ptr<NetDevice> otherDevice,
-                                       Ptr<PhasedArrayModel> otherAntenna) override;
+    BeamformingVectors GetBeamformingVectorsForDevice(Ptr<NetDevice> otherDevice,
+                                                      Ptr<PhasedArrayModel> otherAntenna) override;
 
   private:
     using Matrix2D = std::vector<std::vector<double>>;
@@ -271,10 +298,57 @@ class MmWaveCodebookBeamforming : public MmWaveBeamformingModel
     Matrix2D ComputeBeamformingCodebookMatrix(Ptr<NetDevice> otherDevice,
                                               Ptr<PhasedArrayModel> otherAntenna) const;
 
+    /**
+     * Computes the same matrix as ComputeBeamformingCodebookMatrix, fetching the
+     * channel once and evaluating all the beam pairs with MmWaveCodebookBeamSearch.
+     * The pairs with a gain close to the maximum are evaluated again with the
+     * PSD, so that the selected pair is the one of the exhaustive search. The
+     * beamforming vectors of the antennas are neither used nor changed.
+     * \param otherDevice the target device
+     * \param otherAntenna the target antenna of otherDevice
+     * \param matrix the matrix of the gains, with a row for each codeword of this antenna
+     * \return false if the channel is not a ThreeGppSpectrumPropagationLossModel, in which
+     *         case the matrix is not computed
+     */
+    bool ComputeBeamformingCodebookMatrixBatched(Ptr<NetDevice> otherDevice,
+                                                 Ptr<PhasedArrayModel> otherAntenna,
+                                                 Matrix2D& matrix);
+
+    /**
+     * Computes the average received PSD with the current beamforming vectors
+     * \param thisMob the mobility model of this device
+     * \param otherMob the mobility model of the other device
+     * \param otherAntenna the target antenna of the other device
+     * \return the received PSD, averaged over the RBs
+     */
+    double ComputeAvgRxPsd(Ptr<MobilityModel> thisMob,
+                           Ptr<MobilityModel> otherMob,
+                           Ptr<PhasedArrayModel> otherAntenna) const;
+
+    /**
+     * Computes the average received PSD with the given beamforming vectors,
+     * without configuring the antennas
+     * \param splm the spectrum propagation loss model
+     * \param thisMob the mobility model of this device
+     * \param otherMob the mobility model of the other device
+     * \param otherAntenna the target antenna of the other device
+     * \param thisW the beamforming vector of this antenna
+     * \param otherW the beamforming vector of otherAntenna
+     * \return the received PSD, averaged over the RBs
+     */
+    double ComputeAvgRxPsd(Ptr<ThreeGppSpectrumPropagationLossModel> splm,
+                           Ptr<MobilityModel> thisMob,
+                           Ptr<MobilityModel> otherMob,
+                           Ptr<PhasedArrayModel> otherAntenna,
+                           const PhasedArrayModel::ComplexVector& thisW,
+                           const PhasedArrayModel::ComplexVector& otherW) const;
+
     ObjectFactory m_beamformingCodebookFactory;
     Ptr<SpectrumPropagationLossModel> m_splm;             //!<
     Ptr<PhasedArraySpectrumPropagationLossModel> m_pSplm; //!<
     Ptr<SpectrumValue> m_txPsd;
+    bool m_batchedSearch;                  //!< evaluate all the beam pairs from a single channel
+    MmWaveCodebookBeamSearch m_beamSearch; //!< the batched beam search
 
     /* struct used to store the selected beam pairs */
     struct Entry
@@ -0,0 +1,301 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/mmwave-codebook-beam-search.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+NS_LOG_COMPONENT_DEFINE("MmWaveCodebookBeamSearch");
+
+MmWaveCodebookBeamSearch::CodebookMatrix
+MmWaveCodebookBeamSearch::FromCodebook(Ptr<const BeamformingCodebook> codebook)
+{
+    CodebookMatrix matrix;
+    matrix.m_size = codebook->GetCodebookSize();
+    NS_ASSERT_MSG(matrix.m_size > 0, "Empty codebook");
+    matrix.m_numElements = codebook->GetCodeword(0).GetSize();
+    matrix.m_re.resize(matrix.m_numElements * matrix.m_size);
+    matrix.m_im.resize(matrix.m_numElements * matrix.m_size);
+
+    for (uint32_t idx = 0; idx < matrix.m_size; idx++)
+    {
+        PhasedArrayModel::ComplexVector codeword = codebook->GetCodeword(idx);
+        NS_ASSERT_MSG(codeword.GetSize() == matrix.m_numElements,
+                      "Codewords of different sizes in the same codebook");
+        for (uint32_t e = 0; e < matrix.m_numElements; e++)
+        {
+            matrix.m_re[e * matrix.m_size + idx] = codeword[e].real();
+            matrix.m_im[e * matrix.m_size + idx] = codeword[e].imag();
+        }
+    }
+    return matrix;
+}
+
+const MmWaveCodebookBeamSearch::CodebookMatrix&
+MmWaveCodebookBeamSearch::GetCodebookMatrix(Ptr<const BeamformingCodebook> codebook)
+{
+    auto it = m_codebooks.find(codebook);
+    if (it == m_codebooks.end())
+    {
+        it = m_codebooks.emplace(codebook, FromCodebook(codebook)).first;
+    }
+    return it->second;
+}
+
+void
+MmWaveCodebookBeamSearch::SetTxPsd(const SpectrumValue& txPsd)
+{
+    m_bandFc.clear();
+    m_bandPsd.clear();
+    m_numBands = txPsd.GetSpectrumModel()->GetNumBands();
+
+    // the subbands without power do not contribute to the gain
+    auto sbit = txPsd.ConstBandsBegin();
+    for (auto vit = txPsd.ConstValuesBegin(); vit != txPsd.ConstValuesEnd(); ++vit, ++sbit)
+    {
+        if (*vit != 0.0)
+        {
+            m_bandFc.push_back(sbit->fc);
+            m_bandPsd.push_back(*vit);
+        }
+    }
+}
+
+void
+MmWaveCodebookBeamSearch::ComputeClusterPhases(
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+    Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+    double frequency,
+    double time,
+    const Vector& sSpeed,
+    const Vector& uSpeed)
+{
+    const uint16_t numCluster = channelMatrix->m_channel.GetNumPages();
+    const std::size_t numActive = m_bandFc.size();
+
+    NS_ASSERT(numCluster <= channelParams->m_alpha.size());
+    NS_ASSERT(numCluster <= channelParams->m_D.size());
+    NS_ASSERT(numCluster <= channelParams->m_delay.size());
+
+    // the angles are flipped if the parameters were generated in the other direction
+    bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
+    const auto& angle = channelParams->m_angle;
+    const MatrixBasedChannelModel::DoubleVector& zoa =
+        angle[isSameDirection ? MatrixBasedChannelModel::ZOA_INDEX
+                              : MatrixBasedChannelModel::ZOD_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& zod =
+        angle[isSameDirection ? MatrixBasedChannelModel::ZOD_INDEX
+                              : MatrixBasedChannelModel::ZOA_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& aoa =
+        angle[isSameDirection ? MatrixBasedChannelModel::AOA_INDEX
+                              : MatrixBasedChannelModel::AOD_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& aod =
+        angle[isSameDirection ? MatrixBasedChannelModel::AOD_INDEX
+                              : MatrixBasedChannelModel::AOA_INDEX];
+
+    // same expressions as ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain
+    double factor = 2 * M_PI * time * frequency / 3e8;
+    m_dopplerRe.resize(numCluster);
+    m_dopplerIm.resize(numCluster);
+    m_phaseRe.resize(numCluster * numActive);
+    m_phaseIm.resize(numCluster * numActive);
+    for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+        double alpha = channelParams->m_alpha[cIndex];
+        double D = channelParams->m_D[cIndex];
+        double tempDoppler =
+            factor * ((sin(zoa[cIndex] * M_PI / 180) * cos(aoa[cIndex] * M_PI / 180) * uSpeed.x +
+                       sin(zoa[cIndex] * M_PI / 180) * sin(aoa[cIndex] * M_PI / 180) * uSpeed.y +
+                       cos(zoa[cIndex] * M_PI / 180) * uSpeed.z) +
+                      (sin(zod[cIndex] * M_PI / 180) * cos(aod[cIndex] * M_PI / 180) * sSpeed.x +
+                       sin(zod[cIndex] * M_PI / 180) * sin(aod[cIndex] * M_PI / 180) * sSpeed.y +
+                       cos(zod[cIndex] * M_PI / 180) * sSpeed.z) +
+                      2 * alpha * D);
+        m_dopplerRe[cIndex] = cos(tempDoppler);
+        m_dopplerIm[cIndex] = sin(tempDoppler);
+
+        for (std::size_t b = 0; b < numActive; b++)
+        {
+            double delay = -2 * M_PI * m_bandFc[b] * (channelParams->m_delay[cIndex]);
+            m_phaseRe[cIndex * numActive + b] = cos(delay);
+            m_phaseIm[cIndex * numActive + b] = sin(delay);
+        }
+    }
+}
+
+const std::vector<double>&
+MmWaveCodebookBeamSearch::ComputeGains(
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+    Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+    double frequency,
+    double time,
+    const Vector& sSpeed,
+    const Vector& uSpeed,
+    const CodebookMatrix& sCodebook,
+    const CodebookMatrix& uCodebook)
+{
+    NS_LOG_FUNCTION(this);
+
+    // channel[u element][s element][cluster]
+    const MatrixBasedChannelModel::Complex3DVector& channel = channelMatrix->m_channel;
+    const uint32_t numU = channel.GetNumRows();
+    const uint32_t numS = channel.GetNumCols();
+    const uint16_t numCluster = channel.GetNumPages();
+    NS_ASSERT_MSG(numU == uCodebook.m_numElements && numS == sCodebook.m_numElements,
+                  "Codebooks not matching the channel matrix");
+
+    const uint32_t sSize = sCodebook.m_size;
+    const uint32_t uSize = uCodebook.m_size;
+    const uint32_t numPairs = sSize * uSize;
+    const std::size_t numActive = m_bandFc.size();
+
+    ComputeClusterPhases(channelMatrix, channelParams, frequency, time, sSpeed, uSpeed);
+
+    // long term of each cluster, uW^T H_n sW for all the pairs, times the Doppler term. The
+    // two products keep the codeword index in the inner loops, with a broadcast scalar and
+    // contiguous rows of the codebooks
+    m_hwRe.resize(numU * sSize);
+    m_hwIm.resize(numU * sSize);
+    m_longTermRe.resize(numCluster * numPairs);
+    m_longTermIm.resize(numCluster * numPairs);
+    for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+        // H_n Ws^T, one row for each u element
+        std::fill(m_hwRe.begin(), m_hwRe.end(), 0.0);
+        std::fill(m_hwIm.begin(), m_hwIm.end(), 0.0);
+        for (uint32_t u = 0; u < numU; u++)
+        {
+            double* hwRe = m_hwRe.data() + u * sSize;
+            double* hwIm = m_hwIm.data() + u * sSize;
+            for (uint32_t s = 0; s < numS; s++)
+            {
+                const std::complex<double>& h = channel(u, s, cIndex);
+                const double hRe = h.real();
+                const double hIm = h.imag();
+                const double* wRe = sCodebook.m_re.data() + s * sSize;
+                const double* wIm = sCodebook.m_im.data() + s * sSize;
+                for (uint32_t k = 0; k < sSize; k++)
+                {
+                    hwRe[k] += hRe * wRe[k] - hIm * wIm[k];
+                    hwIm[k] += hRe * wIm[k] + hIm * wRe[k];
+                }
+            }
+        }
+
+        // Wu (H_n Ws^T), one row for each s codeword
+        const double dRe = m_dopplerRe[cIndex];
+        const double dIm = m_dopplerIm[cIndex];
+        for (uint32_t k = 0; k < sSize; k++)
+        {
+            double* ltRe = m_longTermRe.data() + cIndex * numPairs + k * uSize;
+            double* ltIm = m_longTermIm.data() + cIndex * numPairs + k * uSize;
+            std::fill(ltRe, ltRe + uSize, 0.0);
+            std::fill(ltIm, ltIm + uSize, 0.0);
+            for (uint32_t u = 0; u < numU; u++)
+            {
+                const double aRe = m_hwRe[u * sSize + k];
+                const double aIm = m_hwIm[u * sSize + k];
+                const double* wRe = uCodebook.m_re.data() + u * uSize;
+                const double* wIm = uCodebook.m_im.data() + u * uSize;
+                for (uint32_t j = 0; j < uSize; j++)
+                {
+                    ltRe[j] += aRe * wRe[j] - aIm * wIm[j];
+                    ltIm[j] += aRe * wIm[j] + aIm * wRe[j];
+                }
+            }
+            for (uint32_t j = 0; j < uSize; j++)
+            {
+                const double re = ltRe[j];
+                const double im = ltIm[j];
+                ltRe[j] = re * dRe - im * dIm;
+                ltIm[j] = re * dIm + im * dRe;
+            }
+        }
+    }
+
+    // cross correlation of the phases of each couple of clusters over the active subbands,
+    // weighted by the PSD: sum_f psd(f) conj(phase_n(f)) phase_m(f)
+    m_crossRe.resize(numCluster * numCluster);
+    m_crossIm.resize(numCluster * numCluster);
+    for (uint16_t n = 0; n < numCluster; n++)
+    {
+        const double* nRe = m_phaseRe.data() + n * numActive;
+        const double* nIm = m_phaseIm.data() + n * numActive;
+        for (uint16_t m = n; m < numCluster; m++)
+        {
+            const double* mRe = m_phaseRe.data() + m * numActive;
+            const double* mIm = m_phaseIm.data() + m * numActive;
+            double re = 0;
+            double im = 0;
+            for (std::size_t b = 0; b < numActive; b++)
+            {
+                re += m_bandPsd[b] * (nRe[b] * mRe[b] + nIm[b] * mIm[b]);
+                im += m_bandPsd[b] * (nRe[b] * mIm[b] - nIm[b] * mRe[b]);
+            }
+            m_crossRe[n * numCluster + m] = re;
+            m_crossIm[n * numCluster + m] = im;
+        }
+    }
+
+    // the sum over the subbands of psd(f) |sum_n a_n phase_n(f)|^2 is the Hermitian form
+    // sum_n sum_m conj(a_n) cross_nm a_m, which is evaluated for all the pairs at once,
+    // one couple of clusters at a time
+    m_gains.assign(numPairs, 0.0);
+    double* gains = m_gains.data();
+    for (uint16_t n = 0; n < numCluster; n++)
+    {
+        const double* nRe = m_longTermRe.data() + n * numPairs;
+        const double* nIm = m_longTermIm.data() + n * numPairs;
+        const double cRe = m_crossRe[n * numCluster + n];
+        for (uint32_t p = 0; p < numPairs; p++)
+        {
+            gains[p] += cRe * (nRe[p] * nRe[p] + nIm[p] * nIm[p]);
+        }
+        for (uint16_t m = n + 1; m < numCluster; m++)
+        {
+            const double* mRe = m_longTermRe.data() + m * numPairs;
+            const double* mIm = m_longTermIm.data() + m * numPairs;
+            const double twoCRe = 2 * m_crossRe[n * numCluster + m];
+            const double twoCIm = 2 * m_crossIm[n * numCluster + m];
+            for (uint32_t p = 0; p < numPairs; p++)
+            {
+                gains[p] += twoCRe * (nRe[p] * mRe[p] + nIm[p] * mIm[p]) -
+                            twoCIm * (nRe[p] * mIm[p] - nIm[p] * mRe[p]);
+            }
+        }
+    }
+
+    const double scale = m_numBands > 0 ? 1.0 / m_numBands : 0.0;
+    for (uint32_t p = 0; p < numPairs; p++)
+    {
+        gains[p] *= scale;
+    }
+    return m_gains;
+}
+
+} // namespace mmwave
+
+} // namespace ns3
@@ -0,0 +1,155 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SRC_MMWAVE_MODEL_MMWAVE_CODEBOOK_BEAM_SEARCH_H_
+#define SRC_MMWAVE_MODEL_MMWAVE_CODEBOOK_BEAM_SEARCH_H_
+
+#include "ns3/beamforming-codebook.h"
+#include "ns3/matrix-based-channel-model.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/vector.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+namespace mmwave
+{
+
+/**
+ * Exhaustive search over the beam pairs of two codebooks, for a channel
+ * generated by a MatrixBasedChannelModel.
+ *
+ * The gain of a pair of codewords (sW, uW) is the received PSD computed by
+ * ThreeGppSpectrumPropagationLossModel, averaged over the RBs, i.e., the
+ * average of psd(f) |sum_n uW^T H_n sW doppler_n exp(-j 2 pi f tau_n)|^2.
+ * Instead of computing the PSD once per pair, the long term components of all
+ * the pairs are obtained with two complex matrix products per cluster,
+ * H_n Ws^T and Wu (H_n Ws^T). The sum over the subbands is then a Hermitian
+ * form of the long terms, whose matrix, i.e., the cross correlation of the
+ * cluster phases weighted by the PSD, does not depend on the beams and is
+ * computed once per search. The codebooks and the intermediate results are
+ * stored as contiguous arrays of real and imaginary parts, with the beam
+ * pairs in the inner dimension, so that the inner loops can be vectorised.
+ *
+ * The gains are equal to the ones of the PSD up to the rounding errors due to
+ * the different order of the sums.
+ */
+class MmWaveCodebookBeamSearch
+{
+  public:
+    /**
+     * The codewords of a codebook, with a row for each antenna element and a
+     * column for each codeword
+     */
+    struct CodebookMatrix
+    {
+        uint32_t m_size{0};        //!< number of codewords
+        uint32_t m_numElements{0}; //!< number of antenna elements
+        std::vector<double> m_re;  //!< real parts, m_numElements x m_size
+        std::vector<double> m_im;  //!< imaginary parts, m_numElements x m_size
+    };
+
+    /**
+     * Copy the codewords of a codebook in contiguous storage
+     * \param codebook the codebook
+     * \return the codebook matrix
+     */
+    static CodebookMatrix FromCodebook(Ptr<const BeamformingCodebook> codebook);
+
+    /**
+     * Get the matrix of a codebook, which is built at the first use and then
+     * kept for the following searches
+     * \param codebook the codebook
+     * \return the codebook matrix
+     */
+    const CodebookMatrix& GetCodebookMatrix(Ptr<const BeamformingCodebook> codebook);
+
+    /**
+     * Set the transmitted PSD used to weight the subband gains
+     * \param txPsd the PSD
+     */
+    void SetTxPsd(const SpectrumValue& txPsd);
+
+    /**
+     * Compute the gains of all the beam pairs
+     * \param channelMatrix the channel, from the s to the u node
+     * \param channelParams the parameters of the channel
+     * \param frequency the carrier frequency in Hz
+     * \param time the current time in s, for the Doppler term
+     * \param sSpeed the speed of the s node
+     * \param uSpeed the speed of the u node
+     * \param sCodebook the codebook of the s node
+     * \param uCodebook the codebook of the u node
+     * \return the gains, row major, with a row for each codeword of sCodebook
+     *         and a column for each codeword of uCodebook
+     */
+    const std::vector<double>& ComputeGains(
+        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+        Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+        double frequency,
+        double time,
+        const Vector& sSpeed,
+        const Vector& uSpeed,
+        const CodebookMatrix& sCodebook,
+        const CodebookMatrix& uCodebook);
+
+  private:
+    /**
+     * Compute the Doppler term of each cluster and the phase of each cluster
+     * on each active subband, as in ThreeGppSpectrumPropagationLossModel
+     * \param channelMatrix the channel
+     * \param channelParams the parameters of the channel
+     * \param frequency the carrier frequency in Hz
+     * \param time the current time in s
+     * \param sSpeed the speed of the s node
+     * \param uSpeed the speed of the u node
+     */
+    void ComputeClusterPhases(Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                              Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+                              double frequency,
+                              double time,
+                              const Vector& sSpeed,
+                              const Vector& uSpeed);
+
+    std::map<Ptr<const BeamformingCodebook>, CodebookMatrix>
+        m_codebooks; //!< the matrices of the codebooks used so far
+
+    std::vector<double> m_bandFc;  //!< center frequency of each active subband
+    std::vector<double> m_bandPsd; //!< transmitted PSD of each active subband
+    uint32_t m_numBands{0};        //!< number of subbands, active or not
+
+    std::vector<double> m_dopplerRe; //!< Doppler term of each cluster, real part
+    std::vector<double> m_dopplerIm; //!< Doppler term of each cluster, imaginary part
+    std::vector<double> m_phaseRe;   //!< phase of each cluster and active subband, real part
+    std::vector<double> m_phaseIm;   //!< phase of each cluster and active subband, imaginary part
+
+    std::vector<double> m_hwRe;       //!< H_n Ws^T of a cluster, real part
+    std::vector<double> m_hwIm;       //!< H_n Ws^T of a cluster, imaginary part
+    std::vector<double> m_longTermRe; //!< long term of each cluster and beam pair, real part
+    std::vector<double> m_longTermIm; //!< long term of each cluster and beam pair, imaginary part
+    std::vector<double> m_crossRe;    //!< cross correlation of the cluster phases, real part
+    std::vector<double> m_crossIm; //!< cross correlation of the cluster phases, imaginary part
+    std::vector<double> m_gains;      //!< gain of each beam pair
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_MODEL_MMWAVE_CODEBOOK_BEAM_SEARCH_H_ */
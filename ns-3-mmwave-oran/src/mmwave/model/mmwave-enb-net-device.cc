@@ -50,6 +50,7 @@
 #include <ns3/lte-rlc-um-lowlat.h>
 #include <ns3/lte-rlc-um.h>
 #include <ns3/mmwave-component-carrier-enb.h>
+#include <ns3/mmwave-flex-tti-mac-scheduler.h>
 #include <ns3/mmwave-indication-message-helper.h>
 #include <ns3/node.h>
 #include <ns3/packet-burst.h>
@@ -277,6 +278,18 @@ TypeId MmWaveEnbNetDevice::GetTypeId ()
                           BooleanValue(false),
                           MakeBooleanAccessor(&MmWaveEnbNetDevice::m_reducedPmValues),
                           MakeBooleanChecker())
+            .AddAttribute("EnableTailLatencyKpm",
+                          "If true, add the p50/p95/p99 PDCP delay per UE and the p95/p99 "
+                          "PDCP delay of the cell to the CuUpReport",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&MmWaveEnbNetDevice::m_tailLatencyKpm),
+                          MakeBooleanChecker())
+            .AddAttribute("EnableIndicationArena",
+                          "If true, build the asn1c structures of each KPM report in an arena "
+                          "that is released in one shot after the encoding",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&MmWaveEnbNetDevice::m_indicationArenaEnabled),
+                          MakeBooleanChecker())
             .AddAttribute("EnableE2FileLogging",
                           "If true, force E2 indication generation and write E2 fields in csv file",
                           BooleanValue(false),
@@ -293,6 +306,8 @@ MmWaveEnbNetDevice::MmWaveEnbNetDevice()
       m_isConfigured(false),
       m_isReportingEnabled(false),
       m_reducedPmValues(false),
+      m_tailLatencyKpm(false),
+      m_indicationArenaEnabled(false),
       m_forceE2FileLogging(false),
       m_cuUpFileName(),
       m_cuCpFileName(),
@@ -712,6 +727,8 @@ MmWaveEnbNetDevice::BuildRicIndicationMessageCuUp(std::string plmId)
 
     // sum of the per-user average latency
     double perUserAverageLatencySum = 0;
+    // PDCP delay distribution of all the UEs of the cell
+    MmWaveQuantileSketch cellLatencySketch;
 
     std::unordered_map<uint64_t, std::string> uePmString{};
 
@@ -847,9 +864,25 @@ MmWaveEnbNetDevice::BuildRicIndicationMessageCuUp(std::string plmId)
                      << pdcpLatency << " pdcpThroughput " << pdcpThroughput << " rlcBitrate "
                      << rlcBitrate << " dlBler " << dlBler);
 
-        m_e2PdcpStatsCalculator->ResetResultsForImsiLcid(imsi, 3);
-
-        if (!indicationMessageHelper->IsOffline())
+        if (m_tailLatencyKpm)
+        {
+            MmWaveQuantileSketch latencySketch = m_e2PdcpStatsCalculator->GetDlDelaySketch(imsi, 3);
+            cellLatencySketch.Merge(latencySketch);
+            if (!indicationMessageHelper->IsOffline())
+            {
+                // same unit as pdcpLatency: x 0.1 ms
+                indicationMessageHelper->AddCuUpUePmItem(ueImsiComplete,
+                                                         txBytes,
+                                                         txDlPackets,
+                                                         pdcpThroughput,
+                                                         pdcpLatency,
+                                                         dlBler,
+                                                         latencySketch.GetQuantile(0.5) / 1e5,
+                                                         latencySketch.GetQuantile(0.95) / 1e5,
+                                                         latencySketch.GetQuantile(0.99) / 1e5);
+            }
+        }
+        else if (!indicationMessageHelper->IsOffline())
         {
             // Add more measurements: txBytes (PDCP bytes), txDlPackets (PDCP PDU count), 
             // pdcpThroughput, pdcpLatency, and dlBler
@@ -861,6 +894,8 @@ MmWaveEnbNetDevice::BuildRicIndicationMessageCuUp(std::string plmId)
                                                      dlBler);
         }
 
+        m_e2PdcpStatsCalculator->ResetResultsForImsiLcid(imsi, 3);
+
         // TODO enable this back once the reports are fixed
         // uePmString.insert(std::make_pair(imsi,
         //                                  ",,,,,," + std::to_string(txPdcpPduBytesNrRlc) + "," +
@@ -882,7 +917,16 @@ MmWaveEnbNetDevice::BuildRicIndicationMessageCuUp(std::string plmId)
 
     if (!indicationMessageHelper->IsOffline())
     {
-        indicationMessageHelper->AddCuUpCellPmItem(cellAverageLatency);
+        if (m_tailLatencyKpm)
+        {
+            indicationMessageHelper->AddCuUpCellPmItem(cellAverageLatency,
+                                                       cellLatencySketch.GetQuantile(0.95) / 1e5,
+                                                       cellLatencySketch.GetQuantile(0.99) / 1e5);
+        }
+        else
+        {
+            indicationMessageHelper->AddCuUpCellPmItem(cellAverageLatency);
+        }
     }
 
     // PDCP volume for the whole cell
@@ -1173,129 +1217,107 @@ MmWaveEnbNetDevice::BuildRicIndicationMessageDu(std::string plmId, uint16_t nrCe
 
     auto ueMap = m_rrc->GetUeMap();
 
-    uint32_t macPduCellSpecific = 0;
-    uint32_t macPduInitialCellSpecific = 0;
-    uint32_t macVolumeCellSpecific = 0;
-    uint32_t macQpskCellSpecific = 0;
-    uint32_t mac16QamCellSpecific = 0;
-    uint32_t mac64QamCellSpecific = 0;
-    uint32_t macRetxCellSpecific = 0;
-    uint32_t macMac04CellSpecific = 0;
-    uint32_t macMac59CellSpecific = 0;
-    uint32_t macMac1014CellSpecific = 0;
-    uint32_t macMac1519CellSpecific = 0;
-    uint32_t macMac2024CellSpecific = 0;
-    uint32_t macMac2529CellSpecific = 0;
-
-    uint32_t macSinrBin1CellSpecific = 0;
-    uint32_t macSinrBin2CellSpecific = 0;
-    uint32_t macSinrBin3CellSpecific = 0;
-    uint32_t macSinrBin4CellSpecific = 0;
-    uint32_t macSinrBin5CellSpecific = 0;
-    uint32_t macSinrBin6CellSpecific = 0;
-    uint32_t macSinrBin7CellSpecific = 0;
+    // the counters of the cell and of the UEs scheduled since the last report, which are zeroed
+    m_e2DuCalculator->TakeCellKpmSnapshot(m_cellId, m_duKpmSnapshot);
+    const UeSpecificPhyCounters& cell = m_duKpmSnapshot.m_cell;
+
+    uint32_t macPduCellSpecific = cell.m_macPdu;
+    uint32_t macPduInitialCellSpecific = cell.m_macPduInitialTransmission;
+    uint32_t macVolumeCellSpecific = cell.m_macVolume;
+    uint32_t macQpskCellSpecific = cell.m_macPduQpsk;
+    uint32_t mac16QamCellSpecific = cell.m_macPdu16Qam;
+    uint32_t mac64QamCellSpecific = cell.m_macPdu64Qam;
+    uint32_t macRetxCellSpecific = cell.m_macPduRetransmission;
+    uint32_t macMac04CellSpecific = cell.m_macMcs[0];
+    uint32_t macMac59CellSpecific = cell.m_macMcs[1];
+    uint32_t macMac1014CellSpecific = cell.m_macMcs[2];
+    uint32_t macMac1519CellSpecific = cell.m_macMcs[3];
+    uint32_t macMac2024CellSpecific = cell.m_macMcs[4];
+    uint32_t macMac2529CellSpecific = cell.m_macMcs[5];
+
+    uint32_t macSinrBin1CellSpecific = cell.m_macSinrBin[0];
+    uint32_t macSinrBin2CellSpecific = cell.m_macSinrBin[1];
+    uint32_t macSinrBin3CellSpecific = cell.m_macSinrBin[2];
+    uint32_t macSinrBin4CellSpecific = cell.m_macSinrBin[3];
+    uint32_t macSinrBin5CellSpecific = cell.m_macSinrBin[4];
+    uint32_t macSinrBin6CellSpecific = cell.m_macSinrBin[5];
+    uint32_t macSinrBin7CellSpecific = cell.m_macSinrBin[6];
+
+    m_macPduCellSpecific = macPduCellSpecific;
+    m_macVolumeCellSpecific = macVolumeCellSpecific;
 
     uint32_t rlcBufferOccupCellSpecific = 0;
 
-    uint32_t macPrbsCellSpecific = 0;
-
-    std::unordered_map<uint64_t, std::string> uePmStringDu{};
-
-    for (auto ue : ueMap)
+    // Average Number of PRBs allocated = (NR/DR)*number of RBs, where NR is the number of symbols
+    // allocated in the report time window and DR the number of symbols in the window, given the
+    // current numerology and bandwidth of the carrier
+    MmWaveCellResourceGrid grid =
+        MmWaveCellResourceGrid::FromConfig(GetMac()->GetConfigurationParameters());
+    double macPrbsCellSpecific =
+        cell.m_macNumberOfSymbols * grid.GetPrbsPerSymbol(m_duKpmSnapshot.m_window);
+
+    NS_LOG_DEBUG("macNumberOfSymbols " << cell.m_macNumberOfSymbols << " symbols in window "
+                                       << grid.GetSymbolsInWindow(m_duKpmSnapshot.m_window)
+                                       << " numRbs " << grid.m_numRbs << " scheduled UEs "
+                                       << m_duKpmSnapshot.m_ues.size());
+
+    // both the UE map and the snapshot are sorted by RNTI, the UEs that are not in the snapshot
+    // have not been scheduled since the last report
+    static const UeSpecificPhyCounters noCounters{};
+    auto scheduledUe = m_duKpmSnapshot.m_ues.cbegin();
+    m_duKpmBatch.Clear();
+    for (const auto& ue : ueMap)
     {
-        uint64_t imsi = ue.second->GetImsi();
-        std::string ueImsiComplete = GetImsiString(imsi);
         uint16_t rnti = ue.second->GetRnti();
-
-        uint32_t macPduUe = m_e2DuCalculator->GetMacPduUeSpecific(rnti, m_cellId);
-
-        macPduCellSpecific += macPduUe;
-        m_macPduCellSpecific = macPduCellSpecific;
-
-        uint32_t macPduInitialUe =
-            m_e2DuCalculator->GetMacPduInitialTransmissionUeSpecific(rnti, m_cellId);
-        macPduInitialCellSpecific += macPduInitialUe;
-
-        uint32_t macVolume = m_e2DuCalculator->GetMacVolumeUeSpecific(rnti, m_cellId);
-        macVolumeCellSpecific += macVolume;
-        m_macVolumeCellSpecific = macVolumeCellSpecific;
-
-        uint32_t macQpsk = m_e2DuCalculator->GetMacPduQpskUeSpecific(rnti, m_cellId);
-        macQpskCellSpecific += macQpsk;
-
-        uint32_t mac16Qam = m_e2DuCalculator->GetMacPdu16QamUeSpecific(rnti, m_cellId);
-        mac16QamCellSpecific += mac16Qam;
-
-        uint32_t mac64Qam = m_e2DuCalculator->GetMacPdu64QamUeSpecific(rnti, m_cellId);
-        mac64QamCellSpecific += mac64Qam;
-
-        uint32_t macRetx = m_e2DuCalculator->GetMacPduRetransmissionUeSpecific(rnti, m_cellId);
-        macRetxCellSpecific += macRetx;
-
-        // Numerator = (Sum of number of symbols across all rows (TTIs) group by cell ID and UE ID
-        // within a given time window)
-        double macNumberOfSymbols =
-            m_e2DuCalculator->GetMacNumberOfSymbolsUeSpecific(rnti, m_cellId);
-
-        auto phyMac = GetMac()->GetConfigurationParameters();
-        // Denominator = (Periodicity of the report time window in ms*number of TTIs per ms*14)
-        Time reportingWindow =
-            Simulator::Now() - m_e2DuCalculator->GetLastResetTime(rnti, m_cellId);
-        double denominatorPrb =
-            std::ceil(reportingWindow.GetNanoSeconds() / phyMac->GetSlotPeriod().GetNanoSeconds()) *
-            14;
-
-        NS_LOG_DEBUG("macNumberOfSymbols " << macNumberOfSymbols << " denominatorPrb "
-                                           << denominatorPrb);
-
-        // Average Number of PRBs allocated for the UE = (NR/DR)*139 (where 139 is the total number
-        // of PRBs available per NR cell, given numerology 2 with 60 kHz SCS)
-        double macPrb = 0;
-        if (denominatorPrb != 0)
+        while (scheduledUe != m_duKpmSnapshot.m_ues.cend() && scheduledUe->m_rnti < rnti)
         {
-            macPrb = macNumberOfSymbols / denominatorPrb *
-                     139; // TODO fix this for different numerologies
+            ++scheduledUe;
         }
-        macPrbsCellSpecific += macPrb;
-
-        uint32_t macMac04 = m_e2DuCalculator->GetMacMcs04UeSpecific(rnti, m_cellId);
-        macMac04CellSpecific += macMac04;
-
-        uint32_t macMac59 = m_e2DuCalculator->GetMacMcs59UeSpecific(rnti, m_cellId);
-        macMac59CellSpecific += macMac59;
-
-        uint32_t macMac1014 = m_e2DuCalculator->GetMacMcs1014UeSpecific(rnti, m_cellId);
-        macMac1014CellSpecific += macMac1014;
-
-        uint32_t macMac1519 = m_e2DuCalculator->GetMacMcs1519UeSpecific(rnti, m_cellId);
-        macMac1519CellSpecific += macMac1519;
-
-        uint32_t macMac2024 = m_e2DuCalculator->GetMacMcs2024UeSpecific(rnti, m_cellId);
-        macMac2024CellSpecific += macMac2024;
-
-        uint32_t macMac2529 = m_e2DuCalculator->GetMacMcs2529UeSpecific(rnti, m_cellId);
-        macMac2529CellSpecific += macMac2529;
-
-        uint32_t macSinrBin1 = m_e2DuCalculator->GetMacSinrBin1UeSpecific(rnti, m_cellId);
-        macSinrBin1CellSpecific += macSinrBin1;
-
-        uint32_t macSinrBin2 = m_e2DuCalculator->GetMacSinrBin2UeSpecific(rnti, m_cellId);
-        macSinrBin2CellSpecific += macSinrBin2;
-
-        uint32_t macSinrBin3 = m_e2DuCalculator->GetMacSinrBin3UeSpecific(rnti, m_cellId);
-        macSinrBin3CellSpecific += macSinrBin3;
-
-        uint32_t macSinrBin4 = m_e2DuCalculator->GetMacSinrBin4UeSpecific(rnti, m_cellId);
-        macSinrBin4CellSpecific += macSinrBin4;
-
-        uint32_t macSinrBin5 = m_e2DuCalculator->GetMacSinrBin5UeSpecific(rnti, m_cellId);
-        macSinrBin5CellSpecific += macSinrBin5;
+        m_duKpmBatch.Add(scheduledUe != m_duKpmSnapshot.m_ues.cend() && scheduledUe->m_rnti == rnti
+                             ? scheduledUe->m_counters
+                             : noCounters);
+    }
+    m_duKpmBatch.Compute(grid, m_duKpmSnapshot.m_window);
 
-        uint32_t macSinrBin6 = m_e2DuCalculator->GetMacSinrBin6UeSpecific(rnti, m_cellId);
-        macSinrBin6CellSpecific += macSinrBin6;
+    // (IMSI, UE specific values) of the CSV rows, only filled when logging to file
+    std::vector<std::pair<std::string, std::string>> uePmStringDu;
+    if (m_forceE2FileLogging)
+    {
+        uePmStringDu.reserve(ueMap.size());
+    }
 
-        uint32_t macSinrBin7 = m_e2DuCalculator->GetMacSinrBin7UeSpecific(rnti, m_cellId);
-        macSinrBin7CellSpecific += macSinrBin7;
+    uint32_t row = 0;
+    for (const auto& ue : ueMap)
+    {
+        uint64_t imsi = ue.second->GetImsi();
+        std::string ueImsiComplete = GetImsiString(imsi);
+        uint16_t rnti = ue.second->GetRnti();
+        const UeSpecificPhyCounters& counters = m_duKpmBatch.GetCounters(row);
+
+        uint32_t macPduUe = counters.m_macPdu;
+        uint32_t macPduInitialUe = counters.m_macPduInitialTransmission;
+        uint32_t macVolume = counters.m_macVolume;
+        uint32_t macQpsk = counters.m_macPduQpsk;
+        uint32_t mac16Qam = counters.m_macPdu16Qam;
+        uint32_t mac64Qam = counters.m_macPdu64Qam;
+        uint32_t macRetx = counters.m_macPduRetransmission;
+
+        double macPrb = m_duKpmBatch.GetPrb(row);
+
+        uint32_t macMac04 = counters.m_macMcs[0];
+        uint32_t macMac59 = counters.m_macMcs[1];
+        uint32_t macMac1014 = counters.m_macMcs[2];
+        uint32_t macMac1519 = counters.m_macMcs[3];
+        uint32_t macMac2024 = counters.m_macMcs[4];
+        uint32_t macMac2529 = counters.m_macMcs[5];
+
+        uint32_t macSinrBin1 = counters.m_macSinrBin[0];
+        uint32_t macSinrBin2 = counters.m_macSinrBin[1];
+        uint32_t macSinrBin3 = counters.m_macSinrBin[2];
+        uint32_t macSinrBin4 = counters.m_macSinrBin[3];
+        uint32_t macSinrBin5 = counters.m_macSinrBin[4];
+        uint32_t macSinrBin6 = counters.m_macSinrBin[5];
+        uint32_t macSinrBin7 = counters.m_macSinrBin[6];
 
         // get buffer occupancy info
         uint32_t rlcBufferOccup = 0;
@@ -1324,7 +1346,9 @@ MmWaveEnbNetDevice::BuildRicIndicationMessageDu(std::string plmId, uint16_t nrCe
                      << " macSinrBin1 " << macSinrBin1 << " macSinrBin2 " << macSinrBin2
                      << " macSinrBin3 " << macSinrBin3 << " macSinrBin4 " << macSinrBin4
                      << " macSinrBin5 " << macSinrBin5 << " macSinrBin6 " << macSinrBin6
-                     << " macSinrBin7 " << macSinrBin7 << " rlcBufferOccup " << rlcBufferOccup);
+                     << " macSinrBin7 " << macSinrBin7 << " rlcBufferOccup " << rlcBufferOccup
+                     << " macThroughputKbps " << m_duKpmBatch.GetThroughputKbps(row)
+                     << " macBler " << m_duKpmBatch.GetBler(row));
 
         // UE-specific Downlink IP combined EN-DC throughput from LTE eNB. Unit is kbps. Pdcp based
         // computation This value is not requested anymore, so it has been removed from the
@@ -1367,32 +1391,32 @@ MmWaveEnbNetDevice::BuildRicIndicationMessageDu(std::string plmId, uint16_t nrCe
                                                    drbThrDlUeid);
         }
 
-        uePmStringDu.insert(std::make_pair(
-            imsi,
-            std::to_string(macPduUe) + "," + std::to_string(macPduInitialUe) + "," +
-                std::to_string(macQpsk) + "," + std::to_string(mac16Qam) + "," +
-                std::to_string(mac64Qam) + "," + std::to_string(macRetx) + "," +
-                std::to_string(macVolume) + "," + std::to_string(macPrb) + "," +
-                std::to_string(macMac04) + "," + std::to_string(macMac59) + "," +
-                std::to_string(macMac1014) + "," + std::to_string(macMac1519) + "," +
-                std::to_string(macMac2024) + "," + std::to_string(macMac2529) + "," +
-                std::to_string(macSinrBin1) + "," + std::to_string(macSinrBin2) + "," +
-                std::to_string(macSinrBin3) + "," + std::to_string(macSinrBin4) + "," +
-                std::to_string(macSinrBin5) + "," + std::to_string(macSinrBin6) + "," +
-                std::to_string(macSinrBin7) + "," + std::to_string(rlcBufferOccup) + ',' +
-                std::to_string(drbThrDlUeid) + ',' + std::to_string(drbThrDlPdcpBasedUeid)));
-
-        // reset UE
-        m_e2DuCalculator->ResetPhyTracesForRntiCellId(rnti, m_cellId);
+        if (m_forceE2FileLogging)
+        {
+            uePmStringDu.emplace_back(
+                ueImsiComplete,
+                std::to_string(macPduUe) + "," + std::to_string(macPduInitialUe) + "," +
+                    std::to_string(macQpsk) + "," + std::to_string(mac16Qam) + "," +
+                    std::to_string(mac64Qam) + "," + std::to_string(macRetx) + "," +
+                    std::to_string(macVolume) + "," + std::to_string(macPrb) + "," +
+                    std::to_string(macMac04) + "," + std::to_string(macMac59) + "," +
+                    std::to_string(macMac1014) + "," + std::to_string(macMac1519) + "," +
+                    std::to_string(macMac2024) + "," + std::to_string(macMac2529) + "," +
+                    std::to_string(macSinrBin1) + "," + std::to_string(macSinrBin2) + "," +
+                    std::to_string(macSinrBin3) + "," + std::to_string(macSinrBin4) + "," +
+                    std::to_string(macSinrBin5) + "," + std::to_string(macSinrBin6) + "," +
+                    std::to_string(macSinrBin7) + "," + std::to_string(rlcBufferOccup) + ',' +
+                    std::to_string(drbThrDlUeid) + ',' + std::to_string(drbThrDlPdcpBasedUeid));
+        }
+        ++row;
     }
 
     m_drbThrDlPdcpBasedComputationUeid.clear();
     m_drbThrDlUeid.clear();
 
-    // Denominator = (Total number of rows (TTIs) within a given time window* 14)
+    // Denominator = (Total number of symbols within a given time window)
     // Numerator = (Sum of number of symbols across all rows (TTIs) group by cell ID within a given
-    // time window) * 139 Average Number of PRBs allocated for the UE = (NR/DR) (where 139 is the
-    // total number of PRBs available per NR cell, given numerology 2 with 60 kHz SCS)
+    // time window) * number of RBs of the carrier
     double prbUtilizationDl = macPrbsCellSpecific;
     // double m_prbUtilizationDlAttr = prbUtilizationDl;
 
@@ -1415,8 +1439,8 @@ MmWaveEnbNetDevice::BuildRicIndicationMessageDu(std::string plmId, uint16_t nrCe
         << macSinrBin5CellSpecific << " macSinrBin6CellSpecific " << macSinrBin6CellSpecific
         << " macSinrBin7CellSpecific " << macSinrBin7CellSpecific);
 
-    long dlAvailablePrbs = 139; // TODO this is for the current configuration, make it configurable
-    long ulAvailablePrbs = 139; // TODO this is for the current configuration, make it configurable
+    long dlAvailablePrbs = grid.m_numRbs;
+    long ulAvailablePrbs = grid.m_numRbs;
     long qci = 1;
     long dlPrbUsage = std::min((long)(prbUtilizationDl / dlAvailablePrbs * 100),
                                (long)100); // percentage of used PRBs
@@ -1464,6 +1488,35 @@ MmWaveEnbNetDevice::BuildRicIndicationMessageDu(std::string plmId, uint16_t nrCe
         epcDuVal->m_ulPrbUsage = ulPrbUsage;
 
         servedPlmnPerCell->m_perQciReportItems.insert(epcDuVal);
+
+        // with slices, the PRB usage of each slice is reported in the 5GC container
+        Ptr<MmWaveFlexTtiMacSchedulerBase> flexSched = DynamicCast<MmWaveFlexTtiMacSchedulerBase>(
+            DynamicCast<MmWaveComponentCarrierEnb>(m_ccMap.at(0))->GetMacScheduler());
+        if (flexSched && flexSched->HasSlices())
+        {
+            double prbsPerSymbol = grid.GetPrbsPerSymbol(m_duKpmSnapshot.m_window);
+            auto toUsage = [&](uint64_t symbols) {
+                return std::min((long)(symbols * prbsPerSymbol / grid.m_numRbs * 100), (long)100);
+            };
+            std::vector<MmWaveFlexTtiMacSchedulerBase::SliceKpm> sliceKpms;
+            flexSched->TakeSliceKpmSnapshot(sliceKpms);
+            for (const auto& sliceKpm : sliceKpms)
+            {
+                Ptr<FiveGcDuPmContainer> fiveGcDuVal = Create<FiveGcDuPmContainer>();
+                fiveGcDuVal->m_sst = sliceKpm.m_sNssai >> 24;
+                fiveGcDuVal->m_sd = sliceKpm.m_sNssai & MmWaveFlexTtiMacSchedulerBase::NO_SD;
+                fiveGcDuVal->m_fiveQi = qci;
+                fiveGcDuVal->m_dlPrbUsage = toUsage(sliceKpm.m_dlSymbols);
+                fiveGcDuVal->m_ulPrbUsage = toUsage(sliceKpm.m_ulSymbols);
+                NS_LOG_DEBUG("slice " << sliceKpm.m_sNssai << " UEs " << sliceKpm.m_numUes
+                                      << " DL PRB usage " << fiveGcDuVal->m_dlPrbUsage
+                                      << " UL PRB usage " << fiveGcDuVal->m_ulPrbUsage
+                                      << " DL bytes " << sliceKpm.m_dlBytes << " UL bytes "
+                                      << sliceKpm.m_ulBytes);
+                servedPlmnPerCell->m_perSliceReportItems.insert(fiveGcDuVal);
+            }
+        }
+
         cellResRep->m_servedPlmnPerCellItems.insert(servedPlmnPerCell);
 
         indicationMessageHelper->AddDuCellResRepPmItem(cellResRep);
@@ -1531,15 +1584,10 @@ MmWaveEnbNetDevice::BuildRicIndicationMessageDu(std::string plmId, uint16_t nrCe
           DRB.UEThpDl.UEID,DRB.UEThpDlPdcpBased.UEID
         */
 
-        for (auto ue : ueMap)
+        for (const auto& uePms : uePmStringDu)
         {
-            uint64_t imsi = ue.second->GetImsi();
-            std::string ueImsiComplete = GetImsiString(imsi);
-
-            auto uePms = uePmStringDu.find(imsi)->second;
-
-            std::string to_print = std::to_string(timestamp) + "," + ueImsiComplete + "," +
-                                   to_print_cell + "," + uePms + "\n";
+            std::string to_print = std::to_string(timestamp) + "," + uePms.first + "," +
+                                   to_print_cell + "," + uePms.second + "\n";
 
             csv << to_print;
         }
@@ -1566,6 +1614,7 @@ MmWaveEnbNetDevice::BuildAndSendReportMessage(E2Termination::RicSubscriptionRequ
     if (m_sendCuUp)
     {
         // Create CU-UP
+        Asn1cArenaScope arenaScope(m_indicationArenaEnabled ? &m_indicationArena : nullptr);
         Ptr<KpmIndicationHeader> header = BuildRicIndicationHeader(plmId, gnbId, m_cellId);
         Ptr<KpmIndicationMessage> cuUpMsg = BuildRicIndicationMessageCuUp(plmId);
 
@@ -1573,26 +1622,14 @@ MmWaveEnbNetDevice::BuildAndSendReportMessage(E2Termination::RicSubscriptionRequ
         if (!m_forceE2FileLogging && header != nullptr && cuUpMsg != nullptr)
         {
             NS_LOG_DEBUG("Send NR CU-UP");
-            E2AP_PDU* pdu_cuup_ue = new E2AP_PDU;
-            encoding::generate_e2apv1_indication_request_parameterized(
-                pdu_cuup_ue,
-                params.requestorId,
-                params.instanceId,
-                params.ranFuncionId,
-                params.actionId,
-                1,                           // TODO sequence number
-                (uint8_t*)header->m_buffer,  // buffer containing the encoded header
-                header->m_size,              // size of the encoded header
-                (uint8_t*)cuUpMsg->m_buffer, // buffer containing the encoded message
-                cuUpMsg->m_size);            // size of the encoded message
-            m_e2term->SendE2Message(pdu_cuup_ue);
-            delete pdu_cuup_ue;
+            m_e2term->SendRicIndication(params, 1, header, cuUpMsg); // TODO sequence number
         }
     }
 
     if (m_sendCuCp)
     {
         // Create and send CU-CP
+        Asn1cArenaScope arenaScope(m_indicationArenaEnabled ? &m_indicationArena : nullptr);
         Ptr<KpmIndicationHeader> header = BuildRicIndicationHeader(plmId, gnbId, m_cellId);
         Ptr<KpmIndicationMessage> cuCpMsg = BuildRicIndicationMessageCuCp(plmId);
 
@@ -1600,26 +1637,14 @@ MmWaveEnbNetDevice::BuildAndSendReportMessage(E2Termination::RicSubscriptionRequ
         if (!m_forceE2FileLogging && header != nullptr && cuCpMsg != nullptr)
         {
             NS_LOG_DEBUG("Send NR CU-CP");
-            E2AP_PDU* pdu_cucp_ue = new E2AP_PDU;
-            encoding::generate_e2apv1_indication_request_parameterized(
-                pdu_cucp_ue,
-                params.requestorId,
-                params.instanceId,
-                params.ranFuncionId,
-                params.actionId,
-                1,                           // TODO sequence number
-                (uint8_t*)header->m_buffer,  // buffer containing the encoded header
-                header->m_size,              // size of the encoded header
-                (uint8_t*)cuCpMsg->m_buffer, // buffer containing the encoded message
-                cuCpMsg->m_size);            // size of the encoded message
-            m_e2term->SendE2Message(pdu_cucp_ue);
-            delete pdu_cucp_ue;
+            m_e2term->SendRicIndication(params, 1, header, cuCpMsg); // TODO sequence number
         }
     }
 
     if (m_sendDu)
     {
         // Create DU
+        Asn1cArenaScope arenaScope(m_indicationArenaEnabled ? &m_indicationArena : nullptr);
         Ptr<KpmIndicationHeader> header = BuildRicIndicationHeader(plmId, gnbId, m_cellId);
         Ptr<KpmIndicationMessage> duMsg = BuildRicIndicationMessageDu(plmId, m_cellId);
 
@@ -1627,20 +1652,7 @@ MmWaveEnbNetDevice::BuildAndSendReportMessage(E2Termination::RicSubscriptionRequ
         if (!m_forceE2FileLogging && header != nullptr && duMsg != nullptr)
         {
             NS_LOG_DEBUG("Send NR DU");
-            E2AP_PDU* pdu_du_ue = new E2AP_PDU;
-            encoding::generate_e2apv1_indication_request_parameterized(
-                pdu_du_ue,
-                params.requestorId,
-                params.instanceId,
-                params.ranFuncionId,
-                params.actionId,
-                1,                          // TODO sequence number
-                (uint8_t*)header->m_buffer, // buffer containing the encoded header
-                header->m_size,             // size of the encoded header
-                (uint8_t*)duMsg->m_buffer,  // buffer containing the encoded message
-                duMsg->m_size);             // size of the encoded message
-            m_e2term->SendE2Message(pdu_du_ue);
-            delete pdu_du_ue;
+            m_e2term->SendRicIndication(params, 1, header, duMsg); // TODO sequence number
         }
     }
 
@@ -1669,12 +1681,21 @@ MmWaveEnbNetDevice::ControlMessageReceivedCallback(E2AP_PDU_t* sub_req_pdu)
     NS_LOG_DEBUG("MmWaveEnbNetDevice::ControlMessageReceivedCallback: Received RIC Control Message");
     
     // The RicControlMessage constructor will decode and apply simple commands
-    // like "move-enb", "set-mcs", "set-bandwidth" via ApplySimpleCommand
-    Ptr<RicControlMessage> controlMessage = Create<RicControlMessage>(sub_req_pdu);
-    
+    // like "set-mcs", "set-bandwidth" via ApplySimpleCommand, which responds
+    // to the request once they are applied
+    Ptr<RicControlMessage> controlMessage =
+        Create<RicControlMessage>(sub_req_pdu, PeekPointer(m_e2term));
+
     // For more complex control types, you can add a switch statement here
-    // similar to LteEnbNetDevice, but for now the simple commands are handled
-    // automatically by ApplySimpleCommand
+    // similar to LteEnbNetDevice; the other requests are rejected
+    if (!controlMessage->m_simpleCommand)
+    {
+        controlMessage->m_responder.ScheduleSend(
+            Simulator::NO_CONTEXT,
+            {controlMessage->m_payload.empty() ? RicControlResult::BAD_REQUEST
+                                               : RicControlResult::UNSUPPORTED,
+             "no cmd in the RIC Control Message"});
+    }
 }
 
 
@@ -43,6 +43,7 @@
 #include "ns3/nstime.h"
 #include "ns3/traced-callback.h"
 #include <ns3/lte-enb-rrc.h>
+#include <ns3/mmwave-du-kpm-batch.h>
 #include <ns3/mmwave-phy-trace.h>
 #include <ns3/oran-interface.h>
 
@@ -211,6 +212,8 @@ class MmWaveEnbNetDevice : public MmWaveNetDevice
     Ptr<MmWaveBearerStatsCalculator> m_e2PdcpStatsCalculator;
     Ptr<MmWaveBearerStatsCalculator> m_e2RlcStatsCalculator;
     Ptr<MmWavePhyTrace> m_e2DuCalculator;
+    MmWaveCellKpmAggregator::Snapshot m_duKpmSnapshot; //< counters of the last DU report
+    MmWaveDuKpmBatch m_duKpmBatch;                      //< UE specific KPMs of the last DU report
 
     double m_e2Periodicity;
     // TODO doxy
@@ -249,6 +252,9 @@ class MmWaveEnbNetDevice : public MmWaveNetDevice
     std::map<uint64_t, double> m_drbThrDlUeid;
     bool m_isReportingEnabled; //! true is KPM reporting cycle is active, false otherwise
     bool m_reducedPmValues;    //< if true use a reduced subset of pmvalues
+    bool m_tailLatencyKpm;     //< if true report the PDCP delay percentiles in the CU-UP report
+    bool m_indicationArenaEnabled; //< if true build the KPM reports in m_indicationArena
+    Asn1cArena m_indicationArena;  //< arena reused by the KPM reports of this cell
 
     uint16_t m_basicCellId;
 
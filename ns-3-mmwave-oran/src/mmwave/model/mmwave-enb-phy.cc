@@ -52,6 +52,9 @@
 #include <ns3/pointer.h>
 #include <ns3/random-variable-stream.h>
 #include <ns3/simulator.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
+#include <ns3/uinteger.h>
+#include <ns3/worker-pool.h>
 
 #include <algorithm>
 #include <array>
@@ -82,6 +85,7 @@ MmWaveEnbPhy::MmWaveEnbPhy(Ptr<MmWaveSpectrumPhy> dlPhy, Ptr<MmWaveSpectrumPhy>
     : MmWavePhy(dlPhy, ulPhy),
       m_prevSlot(0),
       m_prevTtiDir(TtiAllocInfo::NA),
+      m_sinrEstimateThreads(1),
       m_currSymStart(0)
 {
     m_enbCphySapProvider = new MemberLteEnbCphySapProvider<MmWaveEnbPhy>(this);
@@ -129,6 +133,14 @@ MmWaveEnbPhy::GetTypeId(void)
                           IntegerValue(320000),
                           MakeIntegerAccessor(&MmWaveEnbPhy::m_transient),
                           MakeIntegerChecker<int>())
+            .AddAttribute("SinrEstimateThreads",
+                          "Number of threads computing the received PSDs of the periodic SINR "
+                          "estimate with a ThreeGppSpectrumPropagationLossModel, including the "
+                          "simulator thread. The eNBs with the same value share the threads. The "
+                          "estimates do not depend on this value",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&MmWaveEnbPhy::m_sinrEstimateThreads),
+                          MakeUintegerChecker<uint32_t>(1))
             .AddAttribute(
                 "NoiseFigure",
                 "Loss (dB) in the Signal-to-Noise-Ratio due to non-idealities in the receiver."
@@ -203,6 +215,10 @@ MmWaveEnbPhy::DoInitialize(void)
             (double)m_transient / m_updateSinrPeriod >= 16,
             "Window too small to compute the variance according to the ApplyFilter method");
     }
+    if (m_sinrEstimateThreads > 1)
+    {
+        m_sinrEstimatePool = WorkerPool::GetShared(m_sinrEstimateThreads);
+    }
     Simulator::Schedule(MicroSeconds(0), &MmWaveEnbPhy::UpdateUeSinrEstimate, this);
     MmWavePhy::DoInitialize();
 }
@@ -210,6 +226,8 @@ MmWaveEnbPhy::DoInitialize(void)
 void
 MmWaveEnbPhy::DoDispose(void)
 {
+    m_sinrEstimatePool = nullptr;
+    m_sinrEstimateProbes.clear();
 }
 
 // TODO remove these methods
@@ -593,6 +611,39 @@ MmWaveEnbPhy::UpdateUeSinrEstimate()
     Ptr<SpectrumValue> totalReceivedPsd =
         Create<SpectrumValue>(SpectrumValue(noisePsd->GetSpectrumModel()));
 
+    // With a ThreeGppSpectrumPropagationLossModel, the loop only takes a snapshot of the channel
+    // and of the beamforming vectors of each UE, in the same order, hence with the same random
+    // draws, as the computation of the rx PSD. The beamforming vectors are the ones that would
+    // point the beams of the UE and of this eNB towards each other, but the antennas are not
+    // configured. The beamforming gains, which depend only on the snapshots, are computed after
+    // the loop, in parallel if there is a pool, unless the last estimate already computed them
+    Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+        DynamicCast<ThreeGppSpectrumPropagationLossModel>(
+            m_phasedArraySpectrumPropagationLossModel);
+    std::vector<SinrEstimateProbe*> probesToUpdate;
+    std::vector<std::pair<Ptr<SpectrumValue>, SinrEstimateProbe*>> probedRxPsds;
+    if (threeGppSplm)
+    {
+        // forget the UEs that are no longer attached
+        for (auto probe = m_sinrEstimateProbes.begin(); probe != m_sinrEstimateProbes.end();)
+        {
+            if (m_ueAttachedImsiMap.find(probe->first) == m_ueAttachedImsiMap.end())
+            {
+                probe = m_sinrEstimateProbes.erase(probe);
+            }
+            else
+            {
+                ++probe;
+            }
+        }
+        probesToUpdate.reserve(m_ueAttachedImsiMap.size());
+        probedRxPsds.reserve(m_ueAttachedImsiMap.size());
+    }
+    else
+    {
+        m_sinrEstimateProbes.clear();
+    }
+
     for (std::map<uint64_t, Ptr<NetDevice>>::iterator ue = m_ueAttachedImsiMap.begin();
          ue != m_ueAttachedImsiMap.end();
          ++ue)
@@ -641,9 +692,18 @@ MmWaveEnbPhy::UpdateUeSinrEstimate()
 
         // compute rx psd
 
-        // adjuts beamforming of antenna model wrt user
-        m_downlinkSpectrumPhy->ConfigureBeamforming(ue->second);
-        uePhy->GetDlSpectrumPhy()->ConfigureBeamforming(m_netDevice);
+        MmWaveBeamformingModel::BeamformingVectors bfVectors;
+        if (threeGppSplm)
+        {
+            // beamforming vectors of the UE and of this eNB pointed to each other
+            bfVectors = uePhy->GetDlSpectrumPhy()->GetBeamformingVectorsForDevice(m_netDevice);
+        }
+        else
+        {
+            // adjuts beamforming of antenna model wrt user
+            m_downlinkSpectrumPhy->ConfigureBeamforming(ue->second);
+            uePhy->GetDlSpectrumPhy()->ConfigureBeamforming(m_netDevice);
+        }
         // Dl, since the Ul is not actually used (TDD device)
         double pathLossDb = 0;
         if (m_propagationLoss)
@@ -674,6 +734,35 @@ MmWaveEnbPhy::UpdateUeSinrEstimate()
             rxPsd =
                 m_spectrumPropagationLossModel->CalcRxPowerSpectralDensity(rxParams, ueMob, enbMob);
         }
+        else if (threeGppSplm)
+        {
+            ThreeGppSpectrumPropagationLossModel::RxPsdSnapshot snapshot;
+            threeGppSplm->GetRxPsdSnapshot(ueMob,
+                                           enbMob,
+                                           txPam,
+                                           rxPam,
+                                           bfVectors.first,
+                                           bfVectors.second,
+                                           snapshot);
+            auto probe = m_sinrEstimateProbes.find(ue->first);
+            if (probe == m_sinrEstimateProbes.end() ||
+                !ThreeGppSpectrumPropagationLossModel::HaveSameBeamformingGain(
+                    probe->second.m_snapshot,
+                    snapshot))
+            {
+                SinrEstimateProbe& newProbe = m_sinrEstimateProbes[ue->first];
+                newProbe.m_snapshot = std::move(snapshot);
+                newProbe.m_gain = Create<SpectrumValue>(rxPsd->GetSpectrumModel());
+                *newProbe.m_gain = 1.0;
+                probesToUpdate.push_back(&newProbe);
+                probedRxPsds.emplace_back(rxPsd, &newProbe);
+            }
+            else
+            {
+                NS_LOG_LOGIC("Same beamforming gain as in the last estimate for UE " << ue->first);
+                probedRxPsds.emplace_back(rxPsd, &probe->second);
+            }
+        }
         else if (m_phasedArraySpectrumPropagationLossModel)
         {
             rxPsd = m_phasedArraySpectrumPropagationLossModel->CalcRxPowerSpectralDensity(rxParams,
@@ -683,10 +772,13 @@ MmWaveEnbPhy::UpdateUeSinrEstimate()
                                                                                           rxPam);
         }
 
-        NS_LOG_LOGIC("RxPsd " << *rxPsd);
-
         m_rxPsdMap[ue->first] = rxPsd;
-        *totalReceivedPsd += *rxPsd;
+
+        if (threeGppSplm)
+        {
+            // the antennas have not been configured
+            continue;
+        }
 
         // set back the bf vector to the main eNB
         if (ueNetDevice)
@@ -709,6 +801,35 @@ MmWaveEnbPhy::UpdateUeSinrEstimate()
         }
     }
 
+    // each task only reads its snapshot and writes its gain
+    std::function<void(uint32_t)> calcGain = [&probesToUpdate](uint32_t i) {
+        ThreeGppSpectrumPropagationLossModel::CalcRxPowerSpectralDensityFromSnapshot(
+            probesToUpdate[i]->m_snapshot,
+            *probesToUpdate[i]->m_gain);
+    };
+    if (m_sinrEstimatePool)
+    {
+        m_sinrEstimatePool->ParallelFor(probesToUpdate.size(), calcGain);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < probesToUpdate.size(); i++)
+        {
+            calcGain(i);
+        }
+    }
+    for (auto& probed : probedRxPsds)
+    {
+        *probed.first *= *probed.second->m_gain;
+    }
+
+    for (std::map<uint64_t, Ptr<SpectrumValue>>::iterator ue = m_rxPsdMap.begin();
+         ue != m_rxPsdMap.end(); ++ue)
+    {
+        NS_LOG_LOGIC("RxPsd " << *(ue->second));
+        *totalReceivedPsd += *(ue->second);
+    }
+
     for (std::map<uint64_t, Ptr<SpectrumValue>>::iterator ue = m_rxPsdMap.begin();
          ue != m_rxPsdMap.end(); ++ue)
     {
@@ -42,6 +42,9 @@
 #include <ns3/lte-enb-cphy-sap.h>
 #include <ns3/lte-enb-phy-sap.h>
 #include <ns3/mmwave-harq-phy.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
+
+#include <memory>
 
 namespace ns3
 {
@@ -49,6 +52,7 @@ namespace ns3
 typedef std::pair<uint64_t, uint64_t> pairDevices_t;
 
 class PacketBurst;
+class WorkerPool;
 
 namespace mmwave
 {
@@ -203,6 +207,17 @@ class MmWaveEnbPhy : public MmWavePhy
      */
     void TraceDlPhyTransmission(DciInfoElementTdma dciInfo, uint8_t tddType);
 
+    /**
+     * Beamforming gain between a UE and this eNB computed by the last SINR
+     * estimate, with the snapshot it was computed from
+     */
+    struct SinrEstimateProbe
+    {
+        ThreeGppSpectrumPropagationLossModel::RxPsdSnapshot
+            m_snapshot;          //!< the snapshot of the channel and of the beams
+        Ptr<SpectrumValue> m_gain; //!< the beamforming gain on each RB
+    };
+
     uint8_t m_currSlotNumTti; //!< The amount of TTIs scheduled in the current slot
 
     std::set<uint64_t> m_ueAttached;
@@ -243,6 +258,11 @@ class MmWaveEnbPhy : public MmWavePhy
     double m_transient;                   // after m_transient, we can start apply the filter
     bool m_noiseAndFilter; // If true, use noisy SINR samples, filtered. If false, just use the SINR
                            // measure
+    uint32_t m_sinrEstimateThreads; //!< threads computing the rx PSDs of the SINR estimate
+    std::shared_ptr<WorkerPool>
+        m_sinrEstimatePool; //!< pool computing the rx PSDs, if m_sinrEstimateThreads > 1
+    std::map<uint64_t, SinrEstimateProbe>
+        m_sinrEstimateProbes; //!< last beamforming gain of each attached UE, by IMSI
 
     Ptr<MmWaveHarqPhy> m_harqPhyModule;
     std::vector<int> m_channelChunks;
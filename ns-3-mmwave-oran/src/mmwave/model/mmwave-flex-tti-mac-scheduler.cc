@@ -33,9 +33,11 @@
 
 #include <ns3/abort.h>
 #include <ns3/boolean.h>
+#include <ns3/eps-bearer.h>
 #include <ns3/log.h>
 #include <ns3/lte-common.h>
 
+#include <algorithm>
 #include <cmath>
 #include <stdlib.h> /* abs */
 
@@ -47,12 +49,32 @@ namespace mmwave
 
 NS_LOG_COMPONENT_DEFINE("MmWaveFlexTtiMacScheduler");
 
+NS_OBJECT_ENSURE_REGISTERED(MmWaveFlexTtiMacSchedulerBase);
 NS_OBJECT_ENSURE_REGISTERED(MmWaveFlexTtiMacScheduler);
 
+/**
+ * Comparison of the RLC buffer requests with an RNTI, for the binary searches
+ * in m_rlcBufferReq
+ */
+struct RlcBufferReqRntiLess
+{
+    bool operator()(const MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& req,
+                    uint16_t rnti) const
+    {
+        return req.m_rnti < rnti;
+    }
+
+    bool operator()(uint16_t rnti,
+                    const MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& req) const
+    {
+        return rnti < req.m_rnti;
+    }
+};
+
 class MmWaveFlexTtiMacCschedSapProvider : public MmWaveMacCschedSapProvider
 {
   public:
-    MmWaveFlexTtiMacCschedSapProvider(MmWaveFlexTtiMacScheduler* scheduler);
+    MmWaveFlexTtiMacCschedSapProvider(MmWaveFlexTtiMacSchedulerBase* scheduler);
 
     // inherited from MmWaveMacCschedSapProvider
     virtual void CschedCellConfigReq(
@@ -68,7 +90,7 @@ class MmWaveFlexTtiMacCschedSapProvider : public MmWaveMacCschedSapProvider
 
   private:
     MmWaveFlexTtiMacCschedSapProvider();
-    MmWaveFlexTtiMacScheduler* m_scheduler;
+    MmWaveFlexTtiMacSchedulerBase* m_scheduler;
 };
 
 MmWaveFlexTtiMacCschedSapProvider::MmWaveFlexTtiMacCschedSapProvider()
@@ -76,7 +98,7 @@ MmWaveFlexTtiMacCschedSapProvider::MmWaveFlexTtiMacCschedSapProvider()
 }
 
 MmWaveFlexTtiMacCschedSapProvider::MmWaveFlexTtiMacCschedSapProvider(
-    MmWaveFlexTtiMacScheduler* scheduler)
+    MmWaveFlexTtiMacSchedulerBase* scheduler)
     : m_scheduler(scheduler)
 {
 }
@@ -119,7 +141,7 @@ MmWaveFlexTtiMacCschedSapProvider::CschedUeReleaseReq(
 class MmWaveFlexTtiMacSchedSapProvider : public MmWaveMacSchedSapProvider
 {
   public:
-    MmWaveFlexTtiMacSchedSapProvider(MmWaveFlexTtiMacScheduler* sched);
+    MmWaveFlexTtiMacSchedSapProvider(MmWaveFlexTtiMacSchedulerBase* sched);
 
     virtual void SchedDlRlcBufferReq(
         const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
@@ -135,14 +157,14 @@ class MmWaveFlexTtiMacSchedSapProvider : public MmWaveMacSchedSapProvider
 
   private:
     MmWaveFlexTtiMacSchedSapProvider();
-    MmWaveFlexTtiMacScheduler* m_scheduler;
+    MmWaveFlexTtiMacSchedulerBase* m_scheduler;
 };
 
 MmWaveFlexTtiMacSchedSapProvider::MmWaveFlexTtiMacSchedSapProvider()
 {
 }
 
-MmWaveFlexTtiMacSchedSapProvider::MmWaveFlexTtiMacSchedSapProvider(MmWaveFlexTtiMacScheduler* sched)
+MmWaveFlexTtiMacSchedSapProvider::MmWaveFlexTtiMacSchedSapProvider(MmWaveFlexTtiMacSchedulerBase* sched)
     : m_scheduler(sched)
 {
 }
@@ -196,17 +218,19 @@ MmWaveFlexTtiMacSchedSapProvider::SchedSetMcs(int mcs)
     m_scheduler->DoSchedSetMcs(mcs);
 }
 
-const unsigned MmWaveFlexTtiMacScheduler::m_macHdrSize = 0;
-const unsigned MmWaveFlexTtiMacScheduler::m_subHdrSize = 4;
-const unsigned MmWaveFlexTtiMacScheduler::m_rlcHdrSize = 3;
+const unsigned MmWaveFlexTtiMacSchedulerBase::m_macHdrSize = 0;
+const unsigned MmWaveFlexTtiMacSchedulerBase::m_subHdrSize = 4;
+const unsigned MmWaveFlexTtiMacSchedulerBase::m_rlcHdrSize = 3;
 
-const double MmWaveFlexTtiMacScheduler::m_berDl = 0.001;
+const double MmWaveFlexTtiMacSchedulerBase::m_berDl = 0.001;
+const double MmWaveFlexTtiMacSchedulerBase::m_timeWindow = 99.0;
 
-MmWaveFlexTtiMacScheduler::MmWaveFlexTtiMacScheduler()
+MmWaveFlexTtiMacSchedulerBase::MmWaveFlexTtiMacSchedulerBase()
     : m_nextRnti(0),
       m_nextRntiDl(0),
       m_nextRntiUl(0),
       m_tbUid(0),
+      m_slotPeriod(0),
       m_macSchedSapUser(0),
       m_macCschedSapUser(0)
 {
@@ -215,13 +239,13 @@ MmWaveFlexTtiMacScheduler::MmWaveFlexTtiMacScheduler()
     m_macCschedSapProvider = new MmWaveFlexTtiMacCschedSapProvider(this);
 }
 
-MmWaveFlexTtiMacScheduler::~MmWaveFlexTtiMacScheduler()
+MmWaveFlexTtiMacSchedulerBase::~MmWaveFlexTtiMacSchedulerBase()
 {
     NS_LOG_FUNCTION(this);
 }
 
 void
-MmWaveFlexTtiMacScheduler::DoDispose(void)
+MmWaveFlexTtiMacSchedulerBase::DoDispose(void)
 {
     NS_LOG_FUNCTION(this);
     m_wbCqiRxed.clear();
@@ -238,92 +262,97 @@ MmWaveFlexTtiMacScheduler::DoDispose(void)
 }
 
 TypeId
-MmWaveFlexTtiMacScheduler::GetTypeId(void)
+MmWaveFlexTtiMacSchedulerBase::GetTypeId(void)
 {
     static TypeId tid =
-        TypeId("ns3::MmWaveFlexTtiMacScheduler")
-            .SetParent<MmWaveMacScheduler>()
-            .AddConstructor<MmWaveFlexTtiMacScheduler>()
-            .AddAttribute("CqiTimerThreshold",
-                          "The number of TTIs a CQI is valid (default 1000 - 1 sec.)",
-                          UintegerValue(100),
-                          MakeUintegerAccessor(&MmWaveFlexTtiMacScheduler::m_cqiTimersThreshold),
-                          MakeUintegerChecker<uint32_t>())
-            .AddAttribute("HarqEnabled",
-                          "Activate/Deactivate the HARQ [by default is active].",
-                          BooleanValue(true),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_harqOn),
-                          MakeBooleanChecker())
-            .AddAttribute("FixedMcsDl",
-                          "Fix MCS to value set in McsDlDefault (for testing)",
-                          BooleanValue(false),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_fixedMcsDl),
-                          MakeBooleanChecker())
-            .AddAttribute("McsDefaultDl",
-                          "Fixed DL MCS (for testing)",
-                          UintegerValue(1),
-                          MakeUintegerAccessor(&MmWaveFlexTtiMacScheduler::m_mcsDefaultDl),
-                          MakeUintegerChecker<uint8_t>())
-            .AddAttribute("FixedMcsUl",
-                          "Fix MCS to value set in McsUlDefault (for testing)",
-                          BooleanValue(false),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_fixedMcsUl),
-                          MakeBooleanChecker())
-            .AddAttribute("McsDefaultUl",
-                          "Fixed UL MCS (for testing)",
-                          UintegerValue(1),
-                          MakeUintegerAccessor(&MmWaveFlexTtiMacScheduler::m_mcsDefaultUl),
-                          MakeUintegerChecker<uint8_t>())
-            .AddAttribute("DlSchedOnly",
-                          "Only schedule downlink traffic (for testing)",
-                          BooleanValue(false),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_dlOnly),
-                          MakeBooleanChecker())
-            .AddAttribute("UlSchedOnly",
-                          "Only schedule uplink traffic (for testing)",
-                          BooleanValue(false),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_ulOnly),
-                          MakeBooleanChecker())
-            .AddAttribute("FixedTti",
-                          "Fix slot size",
-                          BooleanValue(false),
-                          MakeBooleanAccessor(&MmWaveFlexTtiMacScheduler::m_fixedTti),
-                          MakeBooleanChecker())
-            .AddAttribute("SymPerSlot",
-                          "Number of symbols per slot in Fixed TTI mode",
-                          UintegerValue(6),
-                          MakeUintegerAccessor(&MmWaveFlexTtiMacScheduler::m_symPerSlot),
-                          MakeUintegerChecker<uint8_t>());
+        TypeId("ns3::MmWaveFlexTtiMacSchedulerBase").SetParent<MmWaveMacScheduler>();
+
+    return tid;
+}
+
+TypeId
+MmWaveFlexTtiMacSchedulerBase::AddCommonAttributes(TypeId tid, bool harqEnabled)
+{
+    tid.AddAttribute("CqiTimerThreshold",
+                     "The number of TTIs a CQI is valid (default 1000 - 1 sec.)",
+                     UintegerValue(100),
+                     MakeUintegerAccessor(&MmWaveFlexTtiMacSchedulerBase::m_cqiTimersThreshold),
+                     MakeUintegerChecker<uint32_t>())
+        .AddAttribute("HarqEnabled",
+                      "Activate/Deactivate the HARQ [by default is active].",
+                      BooleanValue(harqEnabled),
+                      MakeBooleanAccessor(&MmWaveFlexTtiMacSchedulerBase::m_harqOn),
+                      MakeBooleanChecker())
+        .AddAttribute("FixedMcsDl",
+                      "Fix MCS to value set in McsDlDefault (for testing)",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&MmWaveFlexTtiMacSchedulerBase::m_fixedMcsDl),
+                      MakeBooleanChecker())
+        .AddAttribute("McsDefaultDl",
+                      "Fixed DL MCS (for testing)",
+                      UintegerValue(1),
+                      MakeUintegerAccessor(&MmWaveFlexTtiMacSchedulerBase::m_mcsDefaultDl),
+                      MakeUintegerChecker<uint8_t>())
+        .AddAttribute("FixedMcsUl",
+                      "Fix MCS to value set in McsUlDefault (for testing)",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&MmWaveFlexTtiMacSchedulerBase::m_fixedMcsUl),
+                      MakeBooleanChecker())
+        .AddAttribute("McsDefaultUl",
+                      "Fixed UL MCS (for testing)",
+                      UintegerValue(1),
+                      MakeUintegerAccessor(&MmWaveFlexTtiMacSchedulerBase::m_mcsDefaultUl),
+                      MakeUintegerChecker<uint8_t>())
+        .AddAttribute("DlSchedOnly",
+                      "Only schedule downlink traffic (for testing)",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&MmWaveFlexTtiMacSchedulerBase::m_dlOnly),
+                      MakeBooleanChecker())
+        .AddAttribute("UlSchedOnly",
+                      "Only schedule uplink traffic (for testing)",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&MmWaveFlexTtiMacSchedulerBase::m_ulOnly),
+                      MakeBooleanChecker())
+        .AddAttribute("FixedTti",
+                      "Fix slot size",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&MmWaveFlexTtiMacSchedulerBase::m_fixedTti),
+                      MakeBooleanChecker())
+        .AddAttribute("SymPerSlot",
+                      "Number of symbols per slot in Fixed TTI mode",
+                      UintegerValue(6),
+                      MakeUintegerAccessor(&MmWaveFlexTtiMacSchedulerBase::m_symPerSlot),
+                      MakeUintegerChecker<uint8_t>());
 
     return tid;
 }
 
 void
-MmWaveFlexTtiMacScheduler::SetMacSchedSapUser(MmWaveMacSchedSapUser* sap)
+MmWaveFlexTtiMacSchedulerBase::SetMacSchedSapUser(MmWaveMacSchedSapUser* sap)
 {
     m_macSchedSapUser = sap;
 }
 
 void
-MmWaveFlexTtiMacScheduler::SetMacCschedSapUser(MmWaveMacCschedSapUser* sap)
+MmWaveFlexTtiMacSchedulerBase::SetMacCschedSapUser(MmWaveMacCschedSapUser* sap)
 {
     m_macCschedSapUser = sap;
 }
 
 MmWaveMacSchedSapProvider*
-MmWaveFlexTtiMacScheduler::GetMacSchedSapProvider()
+MmWaveFlexTtiMacSchedulerBase::GetMacSchedSapProvider()
 {
     return m_macSchedSapProvider;
 }
 
 MmWaveMacCschedSapProvider*
-MmWaveFlexTtiMacScheduler::GetMacCschedSapProvider()
+MmWaveFlexTtiMacSchedulerBase::GetMacCschedSapProvider()
 {
     return m_macCschedSapProvider;
 }
 
 void
-MmWaveFlexTtiMacScheduler::ConfigureCommonParameters(Ptr<MmWavePhyMacCommon> config)
+MmWaveFlexTtiMacSchedulerBase::ConfigureCommonParameters(Ptr<MmWavePhyMacCommon> config)
 {
     m_phyMacConfig = config;
     m_amc = CreateObject<MmWaveAmc>(m_phyMacConfig);
@@ -331,33 +360,33 @@ MmWaveFlexTtiMacScheduler::ConfigureCommonParameters(Ptr<MmWavePhyMacCommon> con
     m_harqTimeout = m_phyMacConfig->GetHarqTimeout();
     m_numDataSymbols = m_phyMacConfig->GetSymbPerSlot() - m_phyMacConfig->GetDlCtrlSymbols() -
                        m_phyMacConfig->GetUlCtrlSymbols();
+    m_slotPeriod = m_phyMacConfig->GetSlotPeriod().GetSeconds();
 }
 
 void
-MmWaveFlexTtiMacScheduler::DoSchedDlRlcBufferReq(
+MmWaveFlexTtiMacSchedulerBase::DoSchedDlRlcBufferReq(
     const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
 {
     NS_LOG_FUNCTION(this << params.m_rnti << (uint32_t)params.m_logicalChannelIdentity);
     // API generated by RLC for updating RLC parameters on a LC (tx and retx queues)
-    std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it =
-        m_rlcBufferReq.begin();
-    bool newLc = true;
-    while (it != m_rlcBufferReq.end())
+    auto range = std::equal_range(m_rlcBufferReq.begin(),
+                                  m_rlcBufferReq.end(),
+                                  params.m_rnti,
+                                  RlcBufferReqRntiLess());
+    auto it = std::find_if(range.first, range.second, [&params](const auto& req) {
+        return req.m_logicalChannelIdentity == params.m_logicalChannelIdentity;
+    });
+    bool newLc = (it == range.second);
+    if (newLc)
     {
-        // remove old entries of this UE-LC
-        if (((*it).m_rnti == params.m_rnti) &&
-            ((*it).m_logicalChannelIdentity == params.m_logicalChannelIdentity))
-        {
-            it = m_rlcBufferReq.erase(it);
-            newLc = false;
-        }
-        else
-        {
-            ++it;
-        }
+        m_rlcBufferReq.insert(range.second, params);
+    }
+    else
+    {
+        // replace the old entry of this UE-LC, which becomes the last LC of the UE
+        std::rotate(it, it + 1, range.second);
+        *(range.second - 1) = params;
     }
-    // add the new parameters
-    m_rlcBufferReq.insert(it, params);
     NS_LOG_INFO("BSR for RNTI " << params.m_rnti << " LC "
                                 << (uint16_t)params.m_logicalChannelIdentity << " RLC tx size "
                                 << params.m_rlcTransmissionQueueSize << " RLC retx size "
@@ -374,7 +403,7 @@ MmWaveFlexTtiMacScheduler::DoSchedDlRlcBufferReq(
 }
 
 void
-MmWaveFlexTtiMacScheduler::DoSchedDlCqiInfoReq(
+MmWaveFlexTtiMacSchedulerBase::DoSchedDlCqiInfoReq(
     const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params)
 {
     NS_LOG_FUNCTION(this);
@@ -420,7 +449,7 @@ MmWaveFlexTtiMacScheduler::DoSchedDlCqiInfoReq(
 }
 
 void
-MmWaveFlexTtiMacScheduler::DoSchedUlCqiInfoReq(
+MmWaveFlexTtiMacSchedulerBase::DoSchedUlCqiInfoReq(
     const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params)
 {
     NS_LOG_FUNCTION(this);
@@ -507,7 +536,7 @@ MmWaveFlexTtiMacScheduler::DoSchedUlCqiInfoReq(
 }
 
 void
-MmWaveFlexTtiMacScheduler::RefreshHarqProcesses()
+MmWaveFlexTtiMacSchedulerBase::RefreshHarqProcesses()
 {
     NS_LOG_FUNCTION(this);
 
@@ -565,7 +594,7 @@ MmWaveFlexTtiMacScheduler::RefreshHarqProcesses()
 }
 
 uint8_t
-MmWaveFlexTtiMacScheduler::UpdateDlHarqProcessId(uint16_t rnti)
+MmWaveFlexTtiMacSchedulerBase::UpdateDlHarqProcessId(uint16_t rnti)
 {
     NS_LOG_FUNCTION(this << rnti);
 
@@ -621,7 +650,7 @@ MmWaveFlexTtiMacScheduler::UpdateDlHarqProcessId(uint16_t rnti)
 }
 
 uint8_t
-MmWaveFlexTtiMacScheduler::UpdateUlHarqProcessId(uint16_t rnti)
+MmWaveFlexTtiMacSchedulerBase::UpdateUlHarqProcessId(uint16_t rnti)
 {
     NS_LOG_FUNCTION(this << rnti);
 
@@ -659,7 +688,7 @@ MmWaveFlexTtiMacScheduler::UpdateUlHarqProcessId(uint16_t rnti)
 }
 
 unsigned
-MmWaveFlexTtiMacScheduler::CalcMinTbSizeNumSym(unsigned mcs, unsigned bufSize, unsigned& tbSize)
+MmWaveFlexTtiMacSchedulerBase::CalcMinTbSizeNumSym(unsigned mcs, unsigned bufSize, unsigned& tbSize)
 {
     // Bisection line search is used to find the minimum number of slots (OFDM symbols)
     // needed to encode entire buffer.
@@ -710,9 +739,26 @@ MmWaveFlexTtiMacScheduler::CalcMinTbSizeNumSym(unsigned mcs, unsigned bufSize, u
     return (unsigned)numSymHigh;
 }
 
-void
-MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
-    const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
+MmWaveFlexTtiMacSchedulerBase::UeSchedInfo&
+MmWaveFlexTtiMacSchedulerBase::GetUeSchedInfo(uint16_t rnti)
+{
+    if (rnti >= m_ueSchedInfo.size())
+    {
+        m_ueSchedInfo.resize(rnti + 1);
+    }
+    UeSchedInfo& ueSchedInfo = m_ueSchedInfo[rnti];
+    if (!ueSchedInfo.m_active)
+    {
+        ueSchedInfo.m_active = true;
+        m_activeUes.push_back(rnti);
+    }
+    return ueSchedInfo;
+}
+
+bool
+MmWaveFlexTtiMacSchedulerBase::StartSlot(
+    const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params,
+    SlotState& slot)
 {
     NS_LOG_FUNCTION(this);
 
@@ -720,7 +766,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
     uint8_t sfNum = params.m_snfSf.m_sfNum;
     uint8_t slotNum = params.m_snfSf.m_slotNum;
 
-    MmWaveMacSchedSapUser::SchedConfigIndParameters ret;
+    MmWaveMacSchedSapUser::SchedConfigIndParameters& ret = slot.m_ret;
     ret.m_sfnSf = params.m_snfSf;
     ret.m_slotAllocInfo.m_sfnSf = ret.m_sfnSf;
 
@@ -745,13 +791,16 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
     // Process DL HARQ feedback
     RefreshHarqProcesses();
 
-    // m_rlcBufferReq.sort (SortRlcBufferReq);     // sort list by RNTI
+    // reset in place the scheduling state of the UEs of the previous slot
+    for (uint16_t rnti : m_activeUes)
+    {
+        m_ueSchedInfo[rnti].Reset();
+    }
+    m_activeUes.clear();
+
     //  number of DL/UL flows for new transmissions (not HARQ RETX)
     int nFlowsDl = 0;
     int nFlowsUl = 0;
-    std::map<uint16_t, struct UeSchedInfo> ueInfo;
-    std::map<uint16_t, struct UeSchedInfo>::iterator itUeInfo;
-    std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itRlcBuf;
 
     // retrieve past HARQ retx buffered
     if (m_dlHarqInfoList.size() > 0 && params.m_dlHarqInfoList.size() > 0)
@@ -794,7 +843,6 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
             }
             uint8_t harqId = m_dlHarqInfoList.at(i).m_harqProcessId;
             uint16_t rnti = m_dlHarqInfoList.at(i).m_rnti;
-            itUeInfo = ueInfo.find(rnti);
             std::map<uint16_t, UlHarqProcessesStatus_t>::iterator itStat =
                 m_dlHarqProcessesStatus.find(rnti);
             if (itStat == m_dlHarqProcessesStatus.end())
@@ -921,7 +969,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                     TtiAllocInfo ttiInfo(ttiIdx++,
                                          TtiAllocInfo::DL_slotAllocInfo,
                                          TtiAllocInfo::CTRL_DATA,
-                                         itUeInfo->first);
+                                         rnti);
                     ttiInfo.m_dci = dciInfoReTx;
                     NS_LOG_DEBUG("UE" << dciInfoReTx.m_rnti << " gets DL OFDM symbols "
                                       << +dciInfoReTx.m_symStart << "-"
@@ -949,15 +997,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                     }
                     ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ttiInfo);
                     ret.m_slotAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
-                    if (itUeInfo == ueInfo.end())
-                    {
-                        itUeInfo =
-                            ueInfo
-                                .insert(
-                                    std::pair<uint16_t, struct UeSchedInfo>(rnti, UeSchedInfo()))
-                                .first;
-                    }
-                    itUeInfo->second.m_dlSymbolsRetx = dciInfoReTx.m_numSym;
+                    GetUeSchedInfo(rnti).m_dlSymbolsRetx = dciInfoReTx.m_numSym;
                 }
                 else
                 {
@@ -967,8 +1007,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
             }
         }
 
-        m_dlHarqInfoList.clear();
-        m_dlHarqInfoList = dlInfoListUntxed;
+        m_dlHarqInfoList.swap(dlInfoListUntxed);
 
         // Process UL HARQ feedback
         for (uint16_t i = 0; i < m_ulHarqInfoList.size(); i++)
@@ -980,7 +1019,6 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
             UlHarqInfo harqInfo = m_ulHarqInfoList.at(i);
             uint8_t harqId = harqInfo.m_harqProcessId;
             uint16_t rnti = harqInfo.m_rnti;
-            itUeInfo = ueInfo.find(rnti);
             std::map<uint16_t, UlHarqProcessesStatus_t>::iterator itStat =
                 m_ulHarqProcessesStatus.find(rnti);
             if (itStat == m_ulHarqProcessesStatus.end())
@@ -1046,15 +1084,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                                       << " RETX");
                     ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ttiInfo);
                     ret.m_slotAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
-                    if (itUeInfo == ueInfo.end())
-                    {
-                        itUeInfo =
-                            ueInfo
-                                .insert(
-                                    std::pair<uint16_t, struct UeSchedInfo>(rnti, UeSchedInfo()))
-                                .first;
-                    }
-                    itUeInfo->second.m_ulSymbolsRetx = dciInfoReTx.m_numSym;
+                    GetUeSchedInfo(rnti).m_ulSymbolsRetx = dciInfoReTx.m_numSym;
                 }
                 else
                 {
@@ -1063,8 +1093,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
             }
         }
 
-        m_ulHarqInfoList.clear();
-        m_ulHarqInfoList = ulInfoListUntxed;
+        m_ulHarqInfoList.swap(ulInfoListUntxed);
     }
 
     // ********************* END OF HARQ SECTION, START OF NEW DATA SCHEDULING *********************
@@ -1073,14 +1102,8 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
     // get info on active DL flows
     if (symAvail > 0 && !m_ulOnly) // remaining symbols in current subframe after HARQ retx sched
     {
-        for (itRlcBuf = m_rlcBufferReq.begin(); itRlcBuf != m_rlcBufferReq.end(); itRlcBuf++)
+        for (auto itRlcBuf = m_rlcBufferReq.begin(); itRlcBuf != m_rlcBufferReq.end(); itRlcBuf++)
         {
-            itUeInfo = ueInfo.find(itRlcBuf->m_rnti);
-            //      if (itUeInfo != ueInfo.end () && itUeInfo->second.m_dlSymbols > 0)
-            //      {
-            //          continue;
-            //      }
-
             if ((((*itRlcBuf).m_rlcTransmissionQueueSize > 0) ||
                  ((*itRlcBuf).m_rlcRetransmissionQueueSize > 0) ||
                  ((*itRlcBuf).m_rlcStatusPduSize > 0)))
@@ -1104,27 +1127,22 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                 if (cqi != 0 ||
                     m_fixedMcsDl) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
                 {
-                    if (itUeInfo == ueInfo.end())
+                    UeSchedInfo& ueSchedInfo = GetUeSchedInfo(itRlcBuf->m_rnti);
+                    if (ueSchedInfo.m_maxDlBufSize == 0)
                     {
                         nFlowsDl++; // for simplicity, all RLC LCs are considered as a single flow
-                        itUeInfo =
-                            ueInfo
-                                .insert(std::pair<uint16_t, struct UeSchedInfo>(itRlcBuf->m_rnti,
-                                                                                UeSchedInfo()))
-                                .first;
-                    }
-                    else if (itUeInfo->second.m_maxDlBufSize == 0)
-                    {
-                        nFlowsDl++;
                     }
 
+                    ueSchedInfo.m_dlHolDelay = std::max(ueSchedInfo.m_dlHolDelay,
+                                                        itRlcBuf->m_rlcTransmissionQueueHolDelay);
+                    ueSchedInfo.m_dlArrivalRate += itRlcBuf->m_arrivalRate;
                     if (m_fixedMcsDl)
                     {
-                        itUeInfo->second.m_dlMcs = m_mcsDefaultDl;
+                        ueSchedInfo.m_dlMcs = m_mcsDefaultDl;
                     }
                     else
                     {
-                        itUeInfo->second.m_dlMcs = m_amc->GetMcsFromCqi(cqi); // get MCS
+                        ueSchedInfo.m_dlMcs = m_amc->GetMcsFromCqi(cqi); // get MCS
                     }
 
                     // temporarily store the TX queue size
@@ -1133,8 +1151,8 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                         RlcPduInfo newRlcStatusPdu;
                         newRlcStatusPdu.m_lcid = itRlcBuf->m_logicalChannelIdentity;
                         newRlcStatusPdu.m_size += itRlcBuf->m_rlcStatusPduSize + m_subHdrSize;
-                        itUeInfo->second.m_rlcPduInfo.push_back(newRlcStatusPdu);
-                        itUeInfo->second.m_maxDlBufSize +=
+                        ueSchedInfo.m_rlcPduInfo.push_back(newRlcStatusPdu);
+                        ueSchedInfo.m_maxDlBufSize +=
                             newRlcStatusPdu.m_size; // add to total DL buffer size
                     }
 
@@ -1156,8 +1174,8 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                             newRlcEl.m_size = 8;
                         }
                         newRlcEl.m_size += m_rlcHdrSize + m_subHdrSize + 10;
-                        itUeInfo->second.m_rlcPduInfo.push_back(newRlcEl);
-                        itUeInfo->second.m_maxDlBufSize +=
+                        ueSchedInfo.m_rlcPduInfo.push_back(newRlcEl);
+                        ueSchedInfo.m_maxDlBufSize +=
                             newRlcEl.m_size; // add to total DL buffer size
                     }
                 }
@@ -1211,108 +1229,140 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                         continue; // do not allocate UE in uplink
                     }
                 }
-                itUeInfo = ueInfo.find(ceBsrIt->first);
-                if (itUeInfo == ueInfo.end())
-                {
-                    itUeInfo = ueInfo
-                                   .insert(std::pair<uint16_t, struct UeSchedInfo>(ceBsrIt->first,
-                                                                                   UeSchedInfo()))
-                                   .first;
-                    nFlowsUl++;
-                }
-                else if (itUeInfo->second.m_maxUlBufSize == 0)
+                UeSchedInfo& ueSchedInfo = GetUeSchedInfo(ceBsrIt->first);
+                if (ueSchedInfo.m_maxUlBufSize == 0)
                 {
                     nFlowsUl++;
                 }
                 if (m_fixedMcsUl)
                 {
-                    itUeInfo->second.m_ulMcs = m_mcsDefaultUl;
+                    ueSchedInfo.m_ulMcs = m_mcsDefaultUl;
                 }
                 else
                 {
-                    itUeInfo->second.m_ulMcs = mcs; // m_amc->GetMcsFromCqi (cqi);  // get MCS
+                    ueSchedInfo.m_ulMcs = mcs; // m_amc->GetMcsFromCqi (cqi);  // get MCS
                 }
-                itUeInfo->second.m_maxUlBufSize = ceBsrIt->second + m_rlcHdrSize + m_subHdrSize + 8;
+                ueSchedInfo.m_maxUlBufSize = ceBsrIt->second + m_rlcHdrSize + m_subHdrSize + 8;
             }
         }
     }
 
-    int nFlowsTot = nFlowsDl + nFlowsUl;
-    if (ueInfo.size() == 0) // No new data to schedule: only UL CTRL left to schedule, then
-                            // scheduling operations are over
+    slot.m_symAvail = symAvail;
+    slot.m_symIdx = symIdx;
+    slot.m_ttiIdx = ttiIdx;
+    slot.m_nFlows = nFlowsDl + nFlowsUl;
+    if (m_activeUes.empty()) // No new data to schedule: only UL CTRL left to schedule, then
+                             // scheduling operations are over
     {
-        // Add TTI for UL control at the end of the slot
-        TtiAllocInfo ulCtrlTti(ttiIdx, TtiAllocInfo::UL_slotAllocInfo, TtiAllocInfo::CTRL, 0);
-        ulCtrlTti.m_dci.m_numSym = 1;
-        ulCtrlTti.m_dci.m_symStart = m_phyMacConfig->GetSymbPerSlot() - 1;
-        ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ulCtrlTti);
-        m_macSchedSapUser->SchedConfigInd(ret);
-        return;
+        CloseSlot(slot);
+        return false;
     }
 
     // compute requested num slots and TB size based on MCS and DL buffer size
     // final allocated slots may be less
     int totDlSymReq = 0;
     int totUlSymReq = 0;
-    for (itUeInfo = ueInfo.begin(); itUeInfo != ueInfo.end(); itUeInfo++)
+    for (uint16_t rnti : m_activeUes)
     {
+        UeSchedInfo& ueSchedInfo = m_ueSchedInfo[rnti];
         unsigned dlTbSize = 0;
         unsigned ulTbSize = 0;
-        if (itUeInfo->second.m_maxDlBufSize > 0)
+        if (ueSchedInfo.m_maxDlBufSize > 0)
         {
-            itUeInfo->second.m_maxDlSymbols = CalcMinTbSizeNumSym(itUeInfo->second.m_dlMcs,
-                                                                  itUeInfo->second.m_maxDlBufSize,
-                                                                  dlTbSize);
-            itUeInfo->second.m_maxDlBufSize = dlTbSize;
+            ueSchedInfo.m_maxDlSymbols =
+                CalcMinTbSizeNumSym(ueSchedInfo.m_dlMcs, ueSchedInfo.m_maxDlBufSize, dlTbSize);
+            ueSchedInfo.m_maxDlBufSize = dlTbSize;
             if (m_fixedTti)
             {
-                itUeInfo->second.m_maxDlSymbols =
-                    ceil((double)itUeInfo->second.m_maxDlSymbols / (double)m_symPerSlot) *
+                ueSchedInfo.m_maxDlSymbols =
+                    ceil((double)ueSchedInfo.m_maxDlSymbols / (double)m_symPerSlot) *
                     m_symPerSlot; // round up to nearest sym per TTI
             }
-            totDlSymReq += itUeInfo->second.m_maxDlSymbols;
+            totDlSymReq += ueSchedInfo.m_maxDlSymbols;
         }
-        if (itUeInfo->second.m_maxUlBufSize > 0)
+        if (ueSchedInfo.m_maxUlBufSize > 0)
         {
-            itUeInfo->second.m_maxUlSymbols =
-                CalcMinTbSizeNumSym(itUeInfo->second.m_ulMcs,
-                                    itUeInfo->second.m_maxUlBufSize + 10,
-                                    ulTbSize);
-            itUeInfo->second.m_maxUlBufSize = ulTbSize;
+            ueSchedInfo.m_maxUlSymbols = CalcMinTbSizeNumSym(ueSchedInfo.m_ulMcs,
+                                                             ueSchedInfo.m_maxUlBufSize + 10,
+                                                             ulTbSize);
+            ueSchedInfo.m_maxUlBufSize = ulTbSize;
             if (m_fixedTti)
             {
-                itUeInfo->second.m_maxUlSymbols =
-                    ceil((double)itUeInfo->second.m_maxUlSymbols / (double)m_symPerSlot) *
+                ueSchedInfo.m_maxUlSymbols =
+                    ceil((double)ueSchedInfo.m_maxUlSymbols / (double)m_symPerSlot) *
                     m_symPerSlot; // round up to nearest sym per TTI
             }
-            totUlSymReq += itUeInfo->second.m_maxUlSymbols;
+            totUlSymReq += ueSchedInfo.m_maxUlSymbols;
         }
     }
+    slot.m_totSymReq = totDlSymReq + totUlSymReq;
+
+    return true;
+}
 
-    std::map<uint16_t, struct UeSchedInfo>::iterator itUeInfoStart;
-    if (m_nextRnti != 0) // start with RNTI at which the scheduler left off
+MmWaveFlexTtiMacSchedulerBase::PolicyContext
+MmWaveFlexTtiMacSchedulerBase::GetPolicyContext() const
+{
+    PolicyContext ctx;
+    ctx.m_firstRnti = 0;
+    if (m_nextRnti != 0 && m_nextRnti < m_ueSchedInfo.size() &&
+        m_ueSchedInfo[m_nextRnti].m_active) // start with RNTI at which the scheduler left off
     {
-        itUeInfoStart = ueInfo.find(m_nextRnti);
-        if (itUeInfoStart == ueInfo.end())
-        {
-            itUeInfoStart = ueInfo.begin();
-        }
+        ctx.m_firstRnti = m_nextRnti;
     }
-    else // start with first active RNTI
+    // else start with first active RNTI
+    ctx.m_numDataSymbols = m_numDataSymbols;
+    ctx.m_slotPeriod = m_slotPeriod;
+    return ctx;
+}
+
+void
+MmWaveFlexTtiMacSchedulerBase::AllocateSymbols(SlotState& slot, bool fairShare)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_slices.empty())
     {
-        itUeInfoStart = ueInfo.begin();
+        AllocateSliceSymbols(slot, fairShare);
+        return;
     }
-    itUeInfo = itUeInfoStart;
 
-    // divide OFDM symbols evenly between active UEs, which are then evenly divided between DL and
-    // UL flows
-    if (nFlowsTot > 0)
+    int remSym = std::min(slot.m_totSymReq, slot.m_symAvail);
+    size_t ueIdx = AllocateRange(0, m_ueOrder.size(), remSym, slot.m_nFlows, fairShare);
+    m_nextRnti = m_ueOrder[ueIdx].m_rnti;
+}
+
+size_t
+MmWaveFlexTtiMacSchedulerBase::AllocateRange(size_t first,
+                                             size_t last,
+                                             int& remSym,
+                                             int nFlows,
+                                             bool fairShare)
+{
+    int nFlowsTot = nFlows;
+    // index in m_ueOrder of the UE at which the allocation stops
+    size_t ueIdx = first;
+
+    if (!fairShare)
     {
-        int remSym = totDlSymReq + totUlSymReq;
-        if (remSym > symAvail)
+        // serve each UE in full, in the order of the policy
+        for (; ueIdx < last && remSym > 0; ueIdx++)
+        {
+            UeSchedInfo& ueSchedInfo = m_ueSchedInfo[m_ueOrder[ueIdx].m_rnti];
+            ueSchedInfo.m_dlSymbols = std::min<int>(ueSchedInfo.m_maxDlSymbols, remSym);
+            remSym -= ueSchedInfo.m_dlSymbols;
+            ueSchedInfo.m_ulSymbols = std::min<int>(ueSchedInfo.m_maxUlSymbols, remSym);
+            remSym -= ueSchedInfo.m_ulSymbols;
+        }
+        if (ueIdx == last)
         {
-            remSym = symAvail;
+            ueIdx = first;
         }
+    }
+    // divide OFDM symbols evenly between active UEs, which are then evenly divided between DL and
+    // UL flows
+    else if (nFlowsTot > 0)
+    {
 
         int nSymPerFlow0 = remSym / nFlowsTot; // initial average symbols per non-retx flow
         if (nSymPerFlow0 == 0)                 // minimum of 1
@@ -1340,17 +1390,18 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
             }
             while (remSym > 0)
             {
+                UeSchedInfo& ueSchedInfo = m_ueSchedInfo[m_ueOrder[ueIdx].m_rnti];
                 int addSym = 0;
                 // deficit = difference between requested and allocated symbols
-                int deficit = itUeInfo->second.m_maxDlSymbols - itUeInfo->second.m_dlSymbols;
+                int deficit = ueSchedInfo.m_maxDlSymbols - ueSchedInfo.m_dlSymbols;
                 NS_ASSERT(deficit >= 0);
                 if (m_fixedTti)
                 {
                     deficit = ceil((double)deficit / (double)m_symPerSlot) *
                               m_symPerSlot; // round up to nearest sym per TTI
                 }
-                if (deficit > 0 && ((itUeInfo->second.m_dlSymbols +
-                                     itUeInfo->second.m_dlSymbolsRetx) <= nSymPerFlow0))
+                if (deficit > 0 &&
+                    ((ueSchedInfo.m_dlSymbols + ueSchedInfo.m_dlSymbolsRetx) <= nSymPerFlow0))
                 {
                     if (deficit < nRemSymPerFlow)
                     {
@@ -1381,13 +1432,13 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                     }
                     allocated = true;
                 }
-                itUeInfo->second.m_dlSymbols += addSym;
+                ueSchedInfo.m_dlSymbols += addSym;
                 remSym -= addSym;
                 NS_ASSERT(remSym >= 0);
 
                 addSym = 0;
                 // deficit = difference between requested and allocated symbols
-                deficit = itUeInfo->second.m_maxUlSymbols - itUeInfo->second.m_ulSymbols;
+                deficit = ueSchedInfo.m_maxUlSymbols - ueSchedInfo.m_ulSymbols;
                 NS_ASSERT(deficit >= 0);
                 if (m_fixedTti)
                 {
@@ -1400,7 +1451,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                                      m_symPerSlot; // round up to nearest sym per TTI
                 }
                 if (remSym > 0 && deficit > 0 &&
-                    ((itUeInfo->second.m_ulSymbols + itUeInfo->second.m_ulSymbolsRetx) <=
+                    ((ueSchedInfo.m_ulSymbols + ueSchedInfo.m_ulSymbolsRetx) <=
                      nSymPerFlow0))
                 {
                     if (deficit < nRemSymPerFlow)
@@ -1433,16 +1484,16 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                         allocated = true;
                     }
                 }
-                itUeInfo->second.m_ulSymbols += addSym;
+                ueSchedInfo.m_ulSymbols += addSym;
                 remSym -= addSym;
                 NS_ASSERT(remSym >= 0);
 
-                itUeInfo++;
-                if (itUeInfo == ueInfo.end())
-                { // loop around to first RNTI in map
-                    itUeInfo = ueInfo.begin();
+                ueIdx++;
+                if (ueIdx == last)
+                { // loop around to first active RNTI
+                    ueIdx = first;
                 }
-                if (itUeInfo == itUeInfoStart)
+                if (ueIdx == first)
                 { // break when looped back to initial RNTI or no symbols remain
                     break;
                 }
@@ -1450,23 +1501,122 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
         }
     }
 
-    m_nextRnti = itUeInfo->first;
+    return ueIdx;
+}
+
+void
+MmWaveFlexTtiMacSchedulerBase::AllocateSliceSymbols(SlotState& slot, bool fairShare)
+{
+    NS_LOG_FUNCTION(this);
+
+    // demand of the slices; m_last counts their UEs until m_ueOrder is grouped
+    for (Slice& slice : m_slices)
+    {
+        slice.m_symReq = 0;
+        slice.m_nFlows = 0;
+        slice.m_last = 0;
+    }
+    for (const UeWeight& ue : m_ueOrder)
+    {
+        const UeSchedInfo& ueSchedInfo = m_ueSchedInfo[ue.m_rnti];
+        Slice& slice = m_slices[ueSchedInfo.m_slice];
+        slice.m_symReq += ueSchedInfo.m_maxDlSymbols + ueSchedInfo.m_maxUlSymbols;
+        slice.m_nFlows += (ueSchedInfo.m_maxDlBufSize > 0) + (ueSchedInfo.m_maxUlBufSize > 0);
+        slice.m_last++;
+    }
+
+    // quotas, in symbols of the slot: the minimum shares first, then the symbols left go to the
+    // slices which need them, up to their maximum share (the symbols of the HARQ retransmissions
+    // are not charged to the slices)
+    int remSym = slot.m_symAvail;
+    for (uint8_t idx : m_sliceOrder)
+    {
+        Slice& slice = m_slices[idx];
+        int minSym = slice.m_quota.m_minShare * m_numDataSymbols;
+        slice.m_symLimit =
+            std::min<int>(slice.m_symReq, slice.m_quota.m_maxShare * m_numDataSymbols);
+        slice.m_symQuota = std::min({slice.m_symLimit, minSym, remSym});
+        remSym -= slice.m_symQuota;
+    }
+    for (uint8_t idx : m_sliceOrder)
+    {
+        Slice& slice = m_slices[idx];
+        int extra = std::min(slice.m_symLimit - slice.m_symQuota, remSym);
+        slice.m_symQuota += extra;
+        remSym -= extra;
+    }
+
+    // group m_ueOrder by slice, in order of priority
+    size_t first = 0;
+    for (uint8_t idx : m_sliceOrder)
+    {
+        Slice& slice = m_slices[idx];
+        size_t numUes = slice.m_last;
+        slice.m_first = first;
+        slice.m_last = first;
+        first += numUes;
+    }
+    m_sliceUeOrder.resize(m_ueOrder.size());
+    for (const UeWeight& ue : m_ueOrder)
+    {
+        m_sliceUeOrder[m_slices[m_ueSchedInfo[ue.m_rnti].m_slice].m_last++] = ue;
+    }
+    m_ueOrder.swap(m_sliceUeOrder);
+
+    // the round robin resumes in the first slice which did not get all the symbols it requested;
+    // the symbols a slice does not use are offered to the next ones
+    size_t nextIdx = 0;
+    bool limited = false;
+    int unused = 0;
+    for (uint8_t idx : m_sliceOrder)
+    {
+        Slice& slice = m_slices[idx];
+        if (slice.m_first == slice.m_last)
+        {
+            continue;
+        }
+        int sliceSym = slice.m_symQuota + std::min(unused, slice.m_symLimit - slice.m_symQuota);
+        unused -= sliceSym - slice.m_symQuota;
+        slice.m_symQuota = sliceSym;
+        size_t ueIdx =
+            AllocateRange(slice.m_first, slice.m_last, sliceSym, slice.m_nFlows, fairShare);
+        unused += sliceSym;
+        if (!limited && slice.m_symQuota < slice.m_symReq)
+        {
+            nextIdx = ueIdx;
+            limited = true;
+        }
+        NS_LOG_DEBUG("Slice " << std::hex << slice.m_sNssai << std::dec << " requested "
+                              << slice.m_symReq << " symbols, quota " << slice.m_symQuota
+                              << ", unused " << sliceSym);
+    }
+
+    m_nextRnti = m_ueOrder[nextIdx].m_rnti;
+}
+
+void
+MmWaveFlexTtiMacSchedulerBase::FinishSlot(SlotState& slot)
+{
+    NS_LOG_FUNCTION(this);
+
+    MmWaveMacSchedSapUser::SchedConfigIndParameters& ret = slot.m_ret;
+    uint8_t& symIdx = slot.m_symIdx;
+    uint8_t& ttiIdx = slot.m_ttiIdx;
 
     // create DCI elements and assign symbol indices
     // such that all DL slots are contiguous (at beginning of subframe)
     // and all UL slots are contiguous (at end of subframe)
-    itUeInfo = itUeInfoStart;
-
     // ulSymIdx -= totUlSymActual; // symbols reserved for control at end of subframe before UL ctrl
     NS_ASSERT(symIdx > 0); // Should be at least 1, as the DL CTRL TTI at the beginning of the slot
                            // should have been scheduled already
-    do
+    for (const UeWeight& ue : m_ueOrder)
     {
-        UeSchedInfo& ueSchedInfo = itUeInfo->second;
+        const uint16_t rnti = ue.m_rnti;
+        UeSchedInfo& ueSchedInfo = m_ueSchedInfo[rnti];
         if (ueSchedInfo.m_dlSymbols > 0)
         {
             DciInfoElementTdma dci;
-            dci.m_rnti = itUeInfo->first;
+            dci.m_rnti = rnti;
             dci.m_format = 0;
             dci.m_symStart = symIdx;
             dci.m_numSym = ueSchedInfo.m_dlSymbols;
@@ -1474,6 +1624,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
             dci.m_ndi = 1;
             dci.m_mcs = ueSchedInfo.m_dlMcs;
             dci.m_tbSize = m_amc->CalculateTbSize(dci.m_mcs, dci.m_numSym);
+            ueSchedInfo.m_dlTbSize = dci.m_tbSize;
             /*while (dci.m_tbSize > m_phyMacConfig->GetMaxTbSize () && dci.m_mcs > 0)
             {
                     dci.m_mcs--;
@@ -1482,14 +1633,14 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
             NS_ASSERT(symIdx <=
                       m_phyMacConfig->GetSymbPerSlot() - m_phyMacConfig->GetUlCtrlSymbols());
             dci.m_rv = 0;
-            dci.m_harqProcess = UpdateDlHarqProcessId(itUeInfo->first);
+            dci.m_harqProcess = UpdateDlHarqProcessId(rnti);
             NS_ASSERT(dci.m_harqProcess < m_phyMacConfig->GetNumHarqProcess());
-            NS_LOG_DEBUG("UE" << itUeInfo->first << " DL harqId " << +dci.m_harqProcess
+            NS_LOG_DEBUG("UE" << rnti << " DL harqId " << +dci.m_harqProcess
                               << " HARQ process assigned");
             TtiAllocInfo ttiInfo(ttiIdx++,
                                  TtiAllocInfo::DL_slotAllocInfo,
                                  TtiAllocInfo::CTRL_DATA,
-                                 itUeInfo->first);
+                                 rnti);
             ttiInfo.m_dci = dci;
             NS_LOG_DEBUG("UE" << dci.m_rnti << " gets DL OFDM symbols " << +dci.m_symStart << "-"
                               << +(dci.m_symStart + dci.m_numSym - 1) << " tbs " << dci.m_tbSize
@@ -1548,7 +1699,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                 /*for (itRlcBuf = m_rlcBufferReq.begin (); itRlcBuf != m_rlcBufferReq.end ();
                 itRlcBuf++)
                 {
-                        if(itRlcBuf->m_rnti == itUeInfo->first)
+                        if(itRlcBuf->m_rnti == rnti)
                         {
                                 if(itRlcBuf->m_rlcTransmissionQueueSize == 0)
                                 {
@@ -1557,7 +1708,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                         }
                 }*/
                 // update RLC buffer info with expected queue size after scheduling
-                UpdateDlRlcBufferInfo(itUeInfo->first,
+                UpdateDlRlcBufferInfo(rnti,
                                       ueSchedInfo.m_rlcPduInfo[i].m_lcid,
                                       ueSchedInfo.m_rlcPduInfo[i].m_size - m_subHdrSize);
                 ttiInfo.m_rlcPduInfo.push_back(ueSchedInfo.m_rlcPduInfo[i]);
@@ -1611,7 +1762,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
         if (ueSchedInfo.m_ulSymbols > 0)
         {
             DciInfoElementTdma dci;
-            dci.m_rnti = itUeInfo->first;
+            dci.m_rnti = rnti;
             dci.m_format = 1;
             NS_ASSERT(symIdx <=
                       m_phyMacConfig->GetSymbPerSlot() - m_phyMacConfig->GetUlCtrlSymbols());
@@ -1621,15 +1772,16 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
             dci.m_mcs = ueSchedInfo.m_ulMcs;
             dci.m_ndi = 1;
             dci.m_tbSize = m_amc->CalculateTbSize(dci.m_mcs, dci.m_numSym);
-            dci.m_harqProcess = UpdateUlHarqProcessId(itUeInfo->first);
-            NS_LOG_DEBUG("UE" << itUeInfo->first << " UL harqId " << +dci.m_harqProcess
+            ueSchedInfo.m_ulTbSize = dci.m_tbSize;
+            dci.m_harqProcess = UpdateUlHarqProcessId(rnti);
+            NS_LOG_DEBUG("UE" << rnti << " UL harqId " << +dci.m_harqProcess
                               << " HARQ process assigned");
             NS_ASSERT(dci.m_harqProcess < m_phyMacConfig->GetNumHarqProcess());
 
             TtiAllocInfo ttiInfo(ttiIdx++,
                                  TtiAllocInfo::UL_slotAllocInfo,
                                  TtiAllocInfo::CTRL_DATA,
-                                 itUeInfo->first);
+                                 rnti);
             ttiInfo.m_dci = dci;
 
             NS_LOG_DEBUG("UE" << dci.m_rnti << " gets UL OFDM symbols " << +dci.m_symStart << "-"
@@ -1638,7 +1790,7 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                               << +dci.m_rv << " in frame " << ret.m_sfnSf.m_frameNum << " subframe "
                               << +ret.m_sfnSf.m_sfNum << " slot " << +ret.m_sfnSf.m_slotNum);
 
-            UpdateUlRlcBufferInfo(itUeInfo->first, dci.m_tbSize - m_subHdrSize);
+            UpdateUlRlcBufferInfo(rnti, dci.m_tbSize - m_subHdrSize);
             ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ttiInfo); // add to front
             ret.m_slotAllocInfo.m_numSymAlloc += dci.m_numSym;
             std::vector<uint16_t> ueChunkMap;
@@ -1680,25 +1832,40 @@ MmWaveFlexTtiMacScheduler::DoSchedTriggerReq(
                 (*itHarqTimer).second.at(dci.m_harqProcess) = 0;
             }
         }
-        itUeInfo++;
-        if (itUeInfo == ueInfo.end())
-        { // loop around to first RNTI in map
-            itUeInfo = ueInfo.begin();
+
+        if (!m_slices.empty())
+        {
+            Slice& slice = m_slices[ueSchedInfo.m_slice];
+            slice.m_dlSymbols += ueSchedInfo.m_dlSymbols;
+            slice.m_ulSymbols += ueSchedInfo.m_ulSymbols;
+            slice.m_dlBytes += ueSchedInfo.m_dlTbSize;
+            slice.m_ulBytes += ueSchedInfo.m_ulTbSize;
         }
-    } while (itUeInfo != itUeInfoStart); // break when looped back to initial RNTI
 
+        // update the moving averages of the throughput of the UE
+        ueSchedInfo.m_avgTputDl = (1.0 - 1.0 / m_timeWindow) * ueSchedInfo.m_avgTputDl +
+                                  ueSchedInfo.m_dlTbSize / (m_timeWindow * m_slotPeriod);
+        ueSchedInfo.m_avgTputUl = (1.0 - 1.0 / m_timeWindow) * ueSchedInfo.m_avgTputUl +
+                                  ueSchedInfo.m_ulTbSize / (m_timeWindow * m_slotPeriod);
+    }
+
+    CloseSlot(slot);
+}
+
+void
+MmWaveFlexTtiMacSchedulerBase::CloseSlot(SlotState& slot)
+{
     // Add TTI for UL control at the end of the slot
-    TtiAllocInfo ulCtrlTti(ttiIdx, TtiAllocInfo::UL_slotAllocInfo, TtiAllocInfo::CTRL, 0);
+    TtiAllocInfo ulCtrlTti(slot.m_ttiIdx, TtiAllocInfo::UL_slotAllocInfo, TtiAllocInfo::CTRL, 0);
     ulCtrlTti.m_dci.m_numSym = 1;
     ulCtrlTti.m_dci.m_symStart = m_phyMacConfig->GetSymbPerSlot() - 1;
-    ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ulCtrlTti);
+    slot.m_ret.m_slotAllocInfo.m_ttiAllocInfo.push_back(ulCtrlTti);
 
-    m_macSchedSapUser->SchedConfigInd(ret);
-    return;
+    m_macSchedSapUser->SchedConfigInd(slot.m_ret);
 }
 
 void
-MmWaveFlexTtiMacScheduler::DoSchedUlMacCtrlInfoReq(
+MmWaveFlexTtiMacSchedulerBase::DoSchedUlMacCtrlInfoReq(
     const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params)
 {
     NS_LOG_FUNCTION(this);
@@ -1744,7 +1911,7 @@ MmWaveFlexTtiMacScheduler::DoSchedUlMacCtrlInfoReq(
 }
 
 void
-MmWaveFlexTtiMacScheduler::DoSchedSetMcs(int mcs)
+MmWaveFlexTtiMacSchedulerBase::DoSchedSetMcs(int mcs)
 {
     // Example: mcs in [0..28] => enable fixed MCS, mcs < 0 => disable
     NS_LOG_UNCOND("DoSchedSetMcs called with mcs=" << mcs);
@@ -1769,31 +1936,121 @@ MmWaveFlexTtiMacScheduler::DoSchedSetMcs(int mcs)
 }
 
 uint8_t
-MmWaveFlexTtiMacScheduler::GetCurrentMcsDl() const
+MmWaveFlexTtiMacSchedulerBase::GetCurrentMcsDl() const
 {
     return m_fixedMcsDl ? m_mcsDefaultDl : 255; // 255 means adaptive/not fixed
 }
 
 uint8_t
-MmWaveFlexTtiMacScheduler::GetCurrentMcsUl() const
+MmWaveFlexTtiMacSchedulerBase::GetCurrentMcsUl() const
 {
     return m_fixedMcsUl ? m_mcsDefaultUl : 255; // 255 means adaptive/not fixed
 }
 
 bool
-MmWaveFlexTtiMacScheduler::IsFixedMcsDl() const
+MmWaveFlexTtiMacSchedulerBase::IsFixedMcsDl() const
 {
     return m_fixedMcsDl;
 }
 
 bool
-MmWaveFlexTtiMacScheduler::IsFixedMcsUl() const
+MmWaveFlexTtiMacSchedulerBase::IsFixedMcsUl() const
 {
     return m_fixedMcsUl;
 }
 
+uint8_t
+MmWaveFlexTtiMacSchedulerBase::GetSliceIndex(uint32_t sNssai)
+{
+    if (m_slices.empty())
+    {
+        // the UEs not mapped to a slice are in the default slice, at index 0, which is served
+        // last unless its priority is changed
+        Slice slice{};
+        slice.m_sNssai = MakeSNssai(1);
+        slice.m_quota.m_priority = UINT8_MAX;
+        m_slices.push_back(slice);
+        m_sliceOrder.push_back(0);
+    }
+    for (size_t idx = 0; idx < m_slices.size(); ++idx)
+    {
+        if (m_slices[idx].m_sNssai == sNssai)
+        {
+            return idx;
+        }
+    }
+    NS_ABORT_MSG_IF(m_slices.size() > UINT8_MAX, "Too many slices");
+    Slice slice{};
+    slice.m_sNssai = sNssai;
+    m_slices.push_back(slice);
+    m_sliceOrder.push_back(m_slices.size() - 1);
+    return m_slices.size() - 1;
+}
+
+void
+MmWaveFlexTtiMacSchedulerBase::SetSliceQuota(uint32_t sNssai, const SliceQuota& quota)
+{
+    NS_LOG_FUNCTION(this << sNssai << quota.m_minShare << quota.m_maxShare << +quota.m_priority);
+    NS_ABORT_MSG_UNLESS(quota.m_minShare >= 0 && quota.m_minShare <= quota.m_maxShare &&
+                            quota.m_maxShare <= 1,
+                        "Invalid shares of slice " << sNssai << ": min " << quota.m_minShare
+                                                   << " max " << quota.m_maxShare);
+    m_slices[GetSliceIndex(sNssai)].m_quota = quota;
+    // in order of priority, then of creation
+    std::sort(m_sliceOrder.begin(), m_sliceOrder.end(), [this](uint8_t a, uint8_t b) {
+        return m_slices[a].m_quota.m_priority < m_slices[b].m_quota.m_priority ||
+               (m_slices[a].m_quota.m_priority == m_slices[b].m_quota.m_priority && a < b);
+    });
+}
+
+void
+MmWaveFlexTtiMacSchedulerBase::SetUeSlice(uint16_t rnti, uint32_t sNssai)
+{
+    NS_LOG_FUNCTION(this << rnti << sNssai);
+    if (rnti >= m_ueSchedInfo.size())
+    {
+        m_ueSchedInfo.resize(rnti + 1);
+    }
+    m_ueSchedInfo[rnti].m_slice = GetSliceIndex(sNssai);
+}
+
+bool
+MmWaveFlexTtiMacSchedulerBase::HasSlices() const
+{
+    return !m_slices.empty();
+}
+
+void
+MmWaveFlexTtiMacSchedulerBase::TakeSliceKpmSnapshot(std::vector<SliceKpm>& slices)
+{
+    slices.clear();
+    for (Slice& slice : m_slices)
+    {
+        slices.push_back(SliceKpm{slice.m_sNssai,
+                                  slice.m_quota,
+                                  0,
+                                  slice.m_dlSymbols,
+                                  slice.m_ulSymbols,
+                                  slice.m_dlBytes,
+                                  slice.m_ulBytes});
+        slice.m_dlSymbols = 0;
+        slice.m_ulSymbols = 0;
+        slice.m_dlBytes = 0;
+        slice.m_ulBytes = 0;
+    }
+    // the configured UEs have HARQ processes
+    for (const auto& ue : m_dlHarqProcessesStatus)
+    {
+        if (!slices.empty())
+        {
+            slices[ue.first < m_ueSchedInfo.size() ? m_ueSchedInfo[ue.first].m_slice : 0]
+                .m_numUes++;
+        }
+    }
+}
+
 // void
-// MmWaveFlexTtiMacScheduler::DoSchedSetMcs(int mcs)
+// MmWaveFlexTtiMacSchedulerBase::DoSchedSetMcs(int mcs)
 // {
 //     // Example: mcs in [0..28] => enable fixed MCS, mcs < 0 => disable
 //     if (mcs >= 0 && mcs <= 28)
@@ -1813,7 +2070,7 @@ MmWaveFlexTtiMacScheduler::IsFixedMcsUl() const
 // }
 
 bool
-MmWaveFlexTtiMacScheduler::SortRlcBufferReq(
+MmWaveFlexTtiMacSchedulerBase::SortRlcBufferReq(
     MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters i,
     MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters j)
 {
@@ -1821,7 +2078,7 @@ MmWaveFlexTtiMacScheduler::SortRlcBufferReq(
 }
 
 void
-MmWaveFlexTtiMacScheduler::RefreshDlCqiMaps(void)
+MmWaveFlexTtiMacSchedulerBase::RefreshDlCqiMaps(void)
 {
     NS_LOG_FUNCTION(this << m_wbCqiTimers.size());
     // refresh DL CQI P01 Map
@@ -1853,7 +2110,7 @@ MmWaveFlexTtiMacScheduler::RefreshDlCqiMaps(void)
 }
 
 void
-MmWaveFlexTtiMacScheduler::RefreshUlCqiMaps(void)
+MmWaveFlexTtiMacSchedulerBase::RefreshUlCqiMaps(void)
 {
     // refresh UL CQI  Map
     std::map<uint16_t, uint32_t>::iterator itUl = m_ueCqiTimers.begin();
@@ -1885,11 +2142,12 @@ MmWaveFlexTtiMacScheduler::RefreshUlCqiMaps(void)
 }
 
 void
-MmWaveFlexTtiMacScheduler::UpdateDlRlcBufferInfo(uint16_t rnti, uint8_t lcid, uint16_t size)
+MmWaveFlexTtiMacSchedulerBase::UpdateDlRlcBufferInfo(uint16_t rnti, uint8_t lcid, uint16_t size)
 {
     NS_LOG_FUNCTION(this);
-    std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-    for (it = m_rlcBufferReq.begin(); it != m_rlcBufferReq.end(); it++)
+    auto range =
+        std::equal_range(m_rlcBufferReq.begin(), m_rlcBufferReq.end(), rnti, RlcBufferReqRntiLess());
+    for (auto it = range.first; it != range.second; it++)
     {
         if (((*it).m_rnti == rnti) && ((*it).m_logicalChannelIdentity == lcid))
         {
@@ -1950,7 +2208,7 @@ MmWaveFlexTtiMacScheduler::UpdateDlRlcBufferInfo(uint16_t rnti, uint8_t lcid, ui
 }
 
 void
-MmWaveFlexTtiMacScheduler::UpdateUlRlcBufferInfo(uint16_t rnti, uint16_t size)
+MmWaveFlexTtiMacSchedulerBase::UpdateUlRlcBufferInfo(uint16_t rnti, uint16_t size)
 {
     size = size - 2; // remove the minimum RLC overhead
     std::map<uint16_t, uint32_t>::iterator it = m_ceBsrRxed.find(rnti);
@@ -1974,7 +2232,7 @@ MmWaveFlexTtiMacScheduler::UpdateUlRlcBufferInfo(uint16_t rnti, uint16_t size)
 }
 
 void
-MmWaveFlexTtiMacScheduler::DoCschedCellConfigReq(
+MmWaveFlexTtiMacSchedulerBase::DoCschedCellConfigReq(
     const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params)
 {
     NS_LOG_FUNCTION(this);
@@ -1988,7 +2246,7 @@ MmWaveFlexTtiMacScheduler::DoCschedCellConfigReq(
 }
 
 void
-MmWaveFlexTtiMacScheduler::DoCschedUeConfigReq(
+MmWaveFlexTtiMacSchedulerBase::DoCschedUeConfigReq(
     const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params)
 {
     NS_LOG_FUNCTION(this << " RNTI " << params.m_rnti << " txMode "
@@ -2034,41 +2292,54 @@ MmWaveFlexTtiMacScheduler::DoCschedUeConfigReq(
 }
 
 void
-MmWaveFlexTtiMacScheduler::DoCschedLcConfigReq(
+MmWaveFlexTtiMacSchedulerBase::DoCschedLcConfigReq(
     const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params)
 {
     NS_LOG_FUNCTION(this);
-    // Not used at this stage (LCs updated by DoSchedDlRlcBufferReq)
+    // the LCs are updated by DoSchedDlRlcBufferReq, only the delay budget of
+    // the bearers is kept, for the policies
+    if (params.m_rnti >= m_ueSchedInfo.size())
+    {
+        m_ueSchedInfo.resize(params.m_rnti + 1);
+    }
+    UeSchedInfo& ueSchedInfo = m_ueSchedInfo[params.m_rnti];
+    for (const auto& lc : params.m_logicalChannelConfigList)
+    {
+        if (lc.m_qci == 0)
+        {
+            continue; // SRB, no EPS bearer
+        }
+        EpsBearer bearer(static_cast<EpsBearer::Qci>(lc.m_qci));
+        ueSchedInfo.m_delayBudgetMs =
+            std::min(ueSchedInfo.m_delayBudgetMs, bearer.GetPacketDelayBudgetMs());
+    }
     return;
 }
 
 void
-MmWaveFlexTtiMacScheduler::DoCschedLcReleaseReq(
+MmWaveFlexTtiMacSchedulerBase::DoCschedLcReleaseReq(
     const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params)
 {
     NS_LOG_FUNCTION(this);
     for (uint16_t i = 0; i < params.m_logicalChannelIdentity.size(); i++)
     {
-        std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it =
-            m_rlcBufferReq.begin();
-        while (it != m_rlcBufferReq.end())
-        {
-            if (((*it).m_rnti == params.m_rnti) &&
-                ((*it).m_logicalChannelIdentity == params.m_logicalChannelIdentity.at(i)))
-            {
-                it = m_rlcBufferReq.erase(it);
-            }
-            else
-            {
-                it++;
-            }
-        }
+        auto range = std::equal_range(m_rlcBufferReq.begin(),
+                                      m_rlcBufferReq.end(),
+                                      params.m_rnti,
+                                      RlcBufferReqRntiLess());
+        uint8_t lcid = params.m_logicalChannelIdentity.at(i);
+        m_rlcBufferReq.erase(std::remove_if(range.first,
+                                            range.second,
+                                            [lcid](const auto& req) {
+                                                return req.m_logicalChannelIdentity == lcid;
+                                            }),
+                             range.second);
     }
     return;
 }
 
 void
-MmWaveFlexTtiMacScheduler::DoCschedUeReleaseReq(
+MmWaveFlexTtiMacSchedulerBase::DoCschedUeReleaseReq(
     const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params)
 {
     NS_LOG_FUNCTION(this << " Release RNTI " << params.m_rnti);
@@ -2083,20 +2354,20 @@ MmWaveFlexTtiMacScheduler::DoCschedUeReleaseReq(
     m_ulHarqProcessesStatus.erase(params.m_rnti);
     m_ulHarqProcessesDciInfoMap.erase(params.m_rnti);
     m_ceBsrRxed.erase(params.m_rnti);
-    std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it =
-        m_rlcBufferReq.begin();
-    while (it != m_rlcBufferReq.end())
+    auto range = std::equal_range(m_rlcBufferReq.begin(),
+                                  m_rlcBufferReq.end(),
+                                  params.m_rnti,
+                                  RlcBufferReqRntiLess());
+    for (auto it = range.first; it != range.second; it++)
     {
-        if ((*it).m_rnti == params.m_rnti)
-        {
-            NS_LOG_INFO(this << " Erase RNTI " << (*it).m_rnti << " LC "
-                             << (uint16_t)(*it).m_logicalChannelIdentity);
-            it = m_rlcBufferReq.erase(it);
-        }
-        else
-        {
-            it++;
-        }
+        NS_LOG_INFO(this << " Erase RNTI " << (*it).m_rnti << " LC "
+                         << (uint16_t)(*it).m_logicalChannelIdentity);
+    }
+    m_rlcBufferReq.erase(range.first, range.second);
+    if (params.m_rnti < m_ueSchedInfo.size())
+    {
+        // drop the statistics of the UE, the entry is reset again at the next slot if active
+        m_ueSchedInfo[params.m_rnti] = UeSchedInfo();
     }
     if (m_nextRntiUl == params.m_rnti)
     {
@@ -2111,6 +2382,27 @@ MmWaveFlexTtiMacScheduler::DoCschedUeReleaseReq(
     return;
 }
 
+MmWaveFlexTtiMacScheduler::MmWaveFlexTtiMacScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MmWaveFlexTtiMacScheduler::~MmWaveFlexTtiMacScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+MmWaveFlexTtiMacScheduler::GetTypeId(void)
+{
+    static TypeId tid = AddCommonAttributes(TypeId("ns3::MmWaveFlexTtiMacScheduler")
+                                                .SetParent<MmWaveFlexTtiMacSchedulerBase>()
+                                                .AddConstructor<MmWaveFlexTtiMacScheduler>(),
+                                            true);
+
+    return tid;
+}
+
 } // namespace mmwave
 
 } // namespace ns3
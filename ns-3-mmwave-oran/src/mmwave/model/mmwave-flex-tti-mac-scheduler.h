@@ -34,6 +34,7 @@
 #include "mmwave-mac-scheduler.h"
 #include "string"
 
+#include <algorithm>
 #include <set>
 #include <vector>
 
@@ -43,7 +44,16 @@ namespace ns3
 namespace mmwave
 {
 
-class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
+/**
+ * \ingroup mmwave
+ * \brief Engine shared by the FlexTTI schedulers
+ *
+ * Keeps the CQI, HARQ and buffer state of the UEs and performs all the steps
+ * of the scheduling of a slot, except for the choice of the order in which the
+ * UEs with new data are served, which is the policy of the
+ * MmWaveFlexTtiPolicyMacScheduler deriving from it.
+ */
+class MmWaveFlexTtiMacSchedulerBase : public MmWaveMacScheduler
 {
   public:
     typedef std::vector<uint8_t> DlHarqProcessesStatus_t;
@@ -58,9 +68,9 @@ class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
     typedef std::vector<DciInfoElementTdma> UlHarqProcessesDciInfoList_t;
     typedef std::vector<uint8_t> UlHarqProcessesStatus_t;
 
-    MmWaveFlexTtiMacScheduler();
+    MmWaveFlexTtiMacSchedulerBase();
 
-    virtual ~MmWaveFlexTtiMacScheduler();
+    virtual ~MmWaveFlexTtiMacSchedulerBase();
     virtual void DoDispose(void) override;
     static TypeId GetTypeId(void);
 
@@ -90,9 +100,11 @@ class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
     friend class MmWaveFlexTtiMacSchedSapProvider;
     friend class MmWaveFlexTtiMacCschedSapProvider;
 
-
-
-  private:
+    /**
+     * Scheduling state of a UE: the per-slot fields are reset at the beginning
+     * of each slot, the statistics used by the policies are kept until the UE
+     * is released
+     */
     struct UeSchedInfo
     {
         UeSchedInfo()
@@ -109,8 +121,59 @@ class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
               m_dlTbSize(0),
               m_ulTbSize(0),
               m_dlAllocDone(false),
-              m_ulAllocDone(false)
+              m_ulAllocDone(false),
+              m_active(false),
+              m_dlHolDelay(0),
+              m_dlArrivalRate(0),
+              m_avgTputDl(0),
+              m_avgTputUl(0),
+              m_delayBudgetMs(UINT16_MAX),
+              m_slice(0)
+        {
+        }
+
+        /**
+         * Reset the state for a new slot, keeping the memory of m_rlcPduInfo
+         */
+        void Reset()
         {
+            m_dlMcs = 0;
+            m_ulMcs = 0;
+            m_maxDlBufSize = 0;
+            m_maxUlBufSize = 0;
+            m_maxDlSymbols = 0;
+            m_maxUlSymbols = 0;
+            m_dlSymbols = 0;
+            m_ulSymbols = 0;
+            m_dlSymbolsRetx = 0;
+            m_ulSymbolsRetx = 0;
+            m_dlTbSize = 0;
+            m_ulTbSize = 0;
+            m_rlcPduInfo.clear();
+            m_dlAllocDone = false;
+            m_ulAllocDone = false;
+            m_active = false;
+            m_dlHolDelay = 0;
+            m_dlArrivalRate = 0;
+        }
+
+        /**
+         * \brief Get the bytes per symbol of the transmission requested in the
+         * current slot, the best of DL and UL
+         * \return the bytes per symbol at the MCS of the UE
+         */
+        double GetBytesPerSymbol() const
+        {
+            double rate = 0;
+            if (m_maxDlSymbols > 0)
+            {
+                rate = (double)m_maxDlBufSize / m_maxDlSymbols;
+            }
+            if (m_maxUlSymbols > 0)
+            {
+                rate = std::max(rate, (double)m_maxUlBufSize / m_maxUlSymbols);
+            }
+            return rate;
         }
 
         uint8_t m_dlMcs;         // DL MCS
@@ -130,8 +193,258 @@ class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
         std::vector<struct RlcPduInfo> m_rlcPduInfo;
         bool m_dlAllocDone;
         bool m_ulAllocDone;
+        bool m_active; // the UE has something to schedule in the current slot
+        uint16_t m_dlHolDelay;    // largest head of line delay of the DL LCs (ms)
+        double m_dlArrivalRate;   // sum of the arrival rates of the DL LCs (bytes/s)
+        double m_avgTputDl;       // moving average of the DL throughput (bytes/s)
+        double m_avgTputUl;       // moving average of the UL throughput (bytes/s)
+        uint16_t m_delayBudgetMs; // smallest packet delay budget of the bearers of the UE
+        uint8_t m_slice;          // index of the slice of the UE in m_slices
+    };
+
+    /**
+     * Information on the current slot given to the policy before the
+     * evaluation of its metric
+     */
+    struct PolicyContext
+    {
+        uint16_t m_firstRnti;      // RNTI at which the previous slot left off, 0 if not active
+        uint32_t m_numDataSymbols; // number of data symbols per slot
+        double m_slotPeriod;       // duration of a slot (s)
+    };
+
+    /**
+     * PRB quota of a network slice, as shares of the data symbols of a slot
+     */
+    struct SliceQuota
+    {
+        double m_minShare{0};  // share granted to the slice first, if it has data for it
+        double m_maxShare{1};  // share the slice never exceeds
+        uint8_t m_priority{0}; // order in which the slices get their shares, lowest first
+    };
+
+    /**
+     * Usage of a slice since the previous call of TakeSliceKpmSnapshot
+     */
+    struct SliceKpm
+    {
+        uint32_t m_sNssai;    // S-NSSAI of the slice
+        SliceQuota m_quota;   // current quota of the slice
+        uint32_t m_numUes;    // UEs mapped to the slice
+        uint64_t m_dlSymbols; // DL symbols of new transmissions
+        uint64_t m_ulSymbols; // UL symbols of new transmissions
+        uint64_t m_dlBytes;   // bytes of the DL TBs
+        uint64_t m_ulBytes;   // bytes of the UL TBs
+    };
+
+    /// SD value of the S-NSSAIs without an SD (3GPP TS 23.003)
+    static const uint32_t NO_SD = 0xFFFFFF;
+
+    /**
+     * \brief Encode an S-NSSAI, as 8 bits of SST followed by 24 bits of SD
+     * \param sst the slice/service type
+     * \param sd the slice differentiator
+     * \return the S-NSSAI
+     */
+    static uint32_t MakeSNssai(uint8_t sst, uint32_t sd = NO_SD)
+    {
+        return (uint32_t(sst) << 24) | (sd & NO_SD);
+    }
+
+    /**
+     * \brief Set the quota of a slice, creating the slice if needed.
+     *
+     * Once a slice exists, the UEs not mapped to a slice with SetUeSlice
+     * belong to the default slice, with SST 1 (eMBB), no SD, no minimum
+     * share and the lowest priority until its quota is set, and the
+     * symbols left by the HARQ retransmissions are shared among the slices
+     * with data: in order of priority, each slice first gets up to its
+     * minimum share, then the symbols still free go to the slices that need
+     * them, again in order of priority, up to their maximum share. Within a
+     * slice, the UEs are served by the policy of the scheduler.
+     * \param sNssai the S-NSSAI of the slice, see MakeSNssai
+     * \param quota the quota of the slice
+     */
+    void SetSliceQuota(uint32_t sNssai, const SliceQuota& quota);
+
+    /**
+     * \brief Map a UE to a slice, creating the slice with the default quota
+     * if needed. The mapping is kept until the UE is released.
+     * \param rnti the RNTI of the UE
+     * \param sNssai the S-NSSAI of the slice, see MakeSNssai
+     */
+    void SetUeSlice(uint16_t rnti, uint32_t sNssai);
+
+    /**
+     * \return true if slices have been configured
+     */
+    bool HasSlices() const;
+
+    /**
+     * \brief Get the usage of the slices since the previous call, and zero
+     * the counters
+     * \param slices the usage of the slices, replacing the content of the
+     * vector (empty if no slice has been configured)
+     */
+    void TakeSliceKpmSnapshot(std::vector<SliceKpm>& slices);
+
+  protected:
+    /**
+     * State of the slot being scheduled
+     */
+    struct SlotState
+    {
+        MmWaveMacSchedSapUser::SchedConfigIndParameters m_ret;
+        int m_symAvail;   // data symbols not yet allocated
+        uint8_t m_symIdx; // first symbol not yet allocated
+        uint8_t m_ttiIdx; // index of the next TTI
+        int m_nFlows;     // number of DL and UL flows with new data
+        int m_totSymReq;  // symbols requested by the flows with new data
+    };
+
+    /**
+     * Position of a UE in the order of service of the current slot
+     */
+    struct UeWeight
+    {
+        double m_weight;
+        uint16_t m_rnti;
+
+        /**
+         * Higher weights first, RNTI order for equal weights
+         */
+        bool operator<(const UeWeight& other) const
+        {
+            return m_weight > other.m_weight ||
+                   (m_weight == other.m_weight && m_rnti < other.m_rnti);
+        }
+    };
+
+    /**
+     * \brief Add the attributes of the FlexTTI schedulers to the TypeId of a
+     * concrete scheduler (Config::SetDefault only looks at the attributes
+     * declared by the TypeId it names)
+     * \param tid the TypeId of the scheduler
+     * \param harqEnabled the default value of the HarqEnabled attribute
+     * \return the TypeId
+     */
+    static TypeId AddCommonAttributes(TypeId tid, bool harqEnabled);
+
+    virtual void DoSchedTriggerReq(
+        const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params) = 0;
+
+    /**
+     * \brief Start the scheduling of a slot: refresh the CQI and HARQ state,
+     * allocate the HARQ retransmissions and collect the UEs with new data in
+     * m_activeUes, with the symbols they request
+     * \param params the trigger of the slot
+     * \param slot the state of the slot
+     * \return false if there are no UEs to schedule, the slot is then already
+     * sent to the MAC
+     */
+    bool StartSlot(const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params,
+                   SlotState& slot);
+
+    /**
+     * \return the information on the current slot for the policy
+     */
+    PolicyContext GetPolicyContext() const;
+
+    /**
+     * \brief Allocate the symbols of the slot to the UEs in m_ueOrder
+     * \param slot the state of the slot
+     * \param fairShare share the symbols evenly among the UEs, starting from
+     * the first one (round robin), instead of serving each UE in full before
+     * the next one; with slices, this applies within each slice
+     */
+    void AllocateSymbols(SlotState& slot, bool fairShare);
+
+    /**
+     * \brief Create the DCIs of the allocations, in the order of m_ueOrder,
+     * update the throughput averages and send the slot to the MAC
+     * \param slot the state of the slot
+     */
+    void FinishSlot(SlotState& slot);
+
+    /*
+     * Scheduling state of the UEs, indexed by RNTI: the entries are kept
+     * across the slots and reset in place
+     */
+    std::vector<UeSchedInfo> m_ueSchedInfo;
+    /*
+     * RNTIs of the UEs with something to schedule in the current slot
+     */
+    std::vector<uint16_t> m_activeUes;
+    /*
+     * Order of service of m_activeUes in the current slot
+     */
+    std::vector<UeWeight> m_ueOrder;
+
+  private:
+    /**
+     * A network slice: its quota, the state of the current slot and the
+     * counters reported by TakeSliceKpmSnapshot
+     */
+    struct Slice
+    {
+        uint32_t m_sNssai;
+        SliceQuota m_quota;
+        int m_symReq;   // symbols requested by the UEs of the slice in the slot
+        int m_symLimit; // symbols the slice can get in the slot, within its max share
+        int m_symQuota; // symbols of the slot granted to the slice
+        int m_nFlows;   // flows with new data of the slice in the slot
+        size_t m_first; // index in m_ueOrder of the first UE of the slice in the slot
+        size_t m_last;  // index in m_ueOrder after the last UE of the slice in the slot
+        uint64_t m_dlSymbols;
+        uint64_t m_ulSymbols;
+        uint64_t m_dlBytes;
+        uint64_t m_ulBytes;
     };
 
+    /**
+     * \brief Add the UL CTRL TTI at the end of the slot and send it to the MAC
+     * \param slot the state of the slot
+     */
+    void CloseSlot(SlotState& slot);
+
+    /**
+     * \brief Allocate the symbols of the slot to a range of the UEs in
+     * m_ueOrder
+     * \param first the index of the first UE of the range
+     * \param last the index after the last UE of the range
+     * \param remSym the symbols to allocate, decreased by the allocated ones
+     * \param nFlows the number of DL and UL flows with new data in the range
+     * \param fairShare see AllocateSymbols
+     * \return the index of the UE at which the allocation stops, first if
+     * all the UEs of the range have been considered
+     */
+    size_t AllocateRange(size_t first, size_t last, int& remSym, int nFlows, bool fairShare);
+
+    /**
+     * \brief Allocate the symbols of the slot to the slices, then to the UEs
+     * of each slice: m_ueOrder is reordered by slice, keeping the order of the
+     * UEs of a slice
+     * \param slot the state of the slot
+     * \param fairShare see AllocateSymbols
+     */
+    void AllocateSliceSymbols(SlotState& slot, bool fairShare);
+
+    /**
+     * \brief Get the index of a slice in m_slices, creating the slice with
+     * the default quota if needed (and the default slice first)
+     * \param sNssai the S-NSSAI of the slice
+     * \return the index of the slice
+     */
+    uint8_t GetSliceIndex(uint32_t sNssai);
+
+    /**
+     * \brief Get the scheduling state of a UE in the current slot, making the
+     * UE active if it is not yet
+     * \param rnti the RNTI of the UE
+     * \return the scheduling state of the UE
+     */
+    UeSchedInfo& GetUeSchedInfo(uint16_t rnti);
+
     unsigned CalcMinTbSizeNumSym(unsigned mcs, unsigned bufSize, unsigned& tbSize);
 
     uint32_t BsrId2BufferSize(uint8_t val)
@@ -199,27 +512,8 @@ class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
     void DoSchedUlMacCtrlInfoReq(
         const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
 
-    void DoSchedTriggerReq(
-        const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params);
-
-    bool DoSchedDlTriggerReq(
-        const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params,
-        MmWaveMacSchedSapUser::SchedConfigIndParameters& ret,
-        uint32_t frameNum,
-        unsigned int sfNum,
-        unsigned int islot);
-
-    bool DoSchedUlTriggerReq(
-        const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params,
-        MmWaveMacSchedSapUser::SchedConfigIndParameters& ret,
-        uint32_t frameNum,
-        unsigned int sfNum,
-        unsigned int islot);
-
     void DoSchedSetMcs(int mcs);
 
-
-
     /**
      * \brief Refresh HARQ processes according to the timers
      *
@@ -229,9 +523,10 @@ class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
     Ptr<MmWaveAmc> m_amc;
 
     /*
-     * Vectors of UE's RLC info
+     * Vectors of UE's RLC info, sorted by RNTI; the LCs of a UE are in the
+     * order of their last report
      */
-    std::list<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters> m_rlcBufferReq;
+    std::vector<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters> m_rlcBufferReq;
 
     /*
      * Map of UE's DL CQI WB received
@@ -279,6 +574,20 @@ class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
     uint8_t m_tbUid;
     uint32_t m_numChunks;
     uint32_t m_numDataSymbols;
+    double m_slotPeriod; // duration of a slot (s)
+
+    /*
+     * Network slices, the default one first, empty if slicing is not used
+     */
+    std::vector<Slice> m_slices;
+    /*
+     * Indices of m_slices in order of priority
+     */
+    std::vector<uint8_t> m_sliceOrder;
+    /*
+     * Scratch buffer of the grouping of m_ueOrder by slice
+     */
+    std::vector<UeWeight> m_sliceUeOrder;
 
     MmWaveMacSchedSapProvider* m_macSchedSapProvider;
     MmWaveMacSchedSapUser* m_macSchedSapUser;
@@ -338,6 +647,7 @@ class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
     static const unsigned m_rlcHdrSize;
 
     static const double m_berDl;
+    static const double m_timeWindow; // slots of the throughput moving averages
     bool m_fixedMcsDl;
     bool m_fixedMcsUl;
     uint8_t m_mcsDefaultDl;
@@ -350,6 +660,90 @@ class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
     uint8_t m_symPerSlot; // symbols per slot
 };
 
+/**
+ * \ingroup mmwave
+ * \brief FlexTTI scheduler serving the UEs in the order given by a policy
+ *
+ * The Policy is a metric functor, which provides:
+ * - static const bool m_fairShare: if true the symbols are shared evenly among
+ *   the UEs, starting from the first one in the order; otherwise each UE gets
+ *   all the symbols it requests before the next one is served
+ * - void Prepare (const PolicyContext& ctx), called once per slot
+ * - double operator() (uint16_t rnti, const UeSchedInfo& ue) const, the weight
+ *   of a UE with new data in the slot: higher weights are served first
+ *
+ * The metric is evaluated once per active UE and slot, after the MCS and the
+ * requested symbols of the UE are known.
+ */
+template <class Policy>
+class MmWaveFlexTtiPolicyMacScheduler : public MmWaveFlexTtiMacSchedulerBase
+{
+  protected:
+    void DoSchedTriggerReq(
+        const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params) override;
+
+    Policy m_policy;
+};
+
+template <class Policy>
+void
+MmWaveFlexTtiPolicyMacScheduler<Policy>::DoSchedTriggerReq(
+    const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
+{
+    SlotState slot;
+    if (!StartSlot(params, slot))
+    {
+        return;
+    }
+
+    m_policy.Prepare(GetPolicyContext());
+    m_ueOrder.clear();
+    for (uint16_t rnti : m_activeUes)
+    {
+        m_ueOrder.push_back(UeWeight{m_policy(rnti, m_ueSchedInfo[rnti]), rnti});
+    }
+    std::sort(m_ueOrder.begin(), m_ueOrder.end());
+
+    AllocateSymbols(slot, Policy::m_fairShare);
+    FinishSlot(slot);
+}
+
+/**
+ * \ingroup mmwave
+ * \brief Round robin policy: the UEs are served in RNTI order, starting from
+ * the one at which the previous slot left off, and share the symbols evenly
+ */
+struct MmWaveFlexTtiRrPolicy
+{
+    static const bool m_fairShare = true;
+
+    void Prepare(const MmWaveFlexTtiMacSchedulerBase::PolicyContext& ctx)
+    {
+        m_firstRnti = ctx.m_firstRnti;
+    }
+
+    double operator()(uint16_t rnti,
+                      const MmWaveFlexTtiMacSchedulerBase::UeSchedInfo& /* ue */) const
+    {
+        // the nearest RNTI after the first one is served first
+        return -(double)(uint16_t)(rnti - m_firstRnti);
+    }
+
+    uint16_t m_firstRnti{0};
+};
+
+/**
+ * \ingroup mmwave
+ * \brief Round robin FlexTTI scheduler
+ */
+class MmWaveFlexTtiMacScheduler : public MmWaveFlexTtiPolicyMacScheduler<MmWaveFlexTtiRrPolicy>
+{
+  public:
+    MmWaveFlexTtiMacScheduler();
+    ~MmWaveFlexTtiMacScheduler() override;
+    static TypeId GetTypeId(void);
+};
+
 } // namespace mmwave
 
 } // namespace ns3
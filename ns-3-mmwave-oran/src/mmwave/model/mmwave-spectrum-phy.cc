@@ -348,6 +348,19 @@ void
 MmWaveSpectrumPhy::ConfigureBeamforming(Ptr<NetDevice> device)
 {
     NS_LOG_FUNCTION(this << device);
+    m_beamforming->SetBeamformingVectorForDevice(device, GetAntennaOfDevice(device));
+}
+
+MmWaveBeamformingModel::BeamformingVectors
+MmWaveSpectrumPhy::GetBeamformingVectorsForDevice(Ptr<NetDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    return m_beamforming->GetBeamformingVectorsForDevice(device, GetAntennaOfDevice(device));
+}
+
+Ptr<PhasedArrayModel>
+MmWaveSpectrumPhy::GetAntennaOfDevice(Ptr<NetDevice> device) const
+{
     Ptr<PhasedArrayModel> antenna;
 
     // test if device is a MmWaveNetDevice
@@ -364,7 +377,7 @@ MmWaveSpectrumPhy::ConfigureBeamforming(Ptr<NetDevice> device)
         antenna = mcUeNetDevice->GetAntenna(m_componentCarrierId);
     }
 
-    m_beamforming->SetBeamformingVectorForDevice(device, antenna);
+    return antenna;
 }
 
 void
@@ -215,6 +215,15 @@ class MmWaveSpectrumPhy : public SpectrumPhy
      */
     void ConfigureBeamforming(Ptr<NetDevice> device);
 
+    /**
+     * Compute the beamforming vectors that ConfigureBeamforming would set,
+     * without changing the antenna configuration.
+     * \param device target device
+     * \return the beamforming vectors of this antenna and of the antenna of device
+     */
+    MmWaveBeamformingModel::BeamformingVectors GetBeamformingVectorsForDevice(
+        Ptr<NetDevice> device);
+
     void SetNoisePowerSpectralDensity(Ptr<const SpectrumValue> noisePsd);
     void SetTxPowerSpectralDensity(Ptr<SpectrumValue> TxPsd);
     void StartRx(Ptr<SpectrumSignalParameters> params) override;
@@ -291,6 +300,13 @@ class MmWaveSpectrumPhy : public SpectrumPhy
      */
     double Min(const SpectrumValue& specVal);
 
+    /**
+     * \brief Returns the antenna of a device for the component carrier of this PHY
+     * \param device the MmWaveNetDevice or McUeNetDevice
+     * \return the antenna
+     */
+    Ptr<PhasedArrayModel> GetAntennaOfDevice(Ptr<NetDevice> device) const;
+
     Ptr<mmWaveInterference> m_interferenceData;
     Ptr<MobilityModel> m_mobility;
     Ptr<NetDevice> m_device;
@@ -0,0 +1,225 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/mmwave-amc.h"
+#include "ns3/mmwave-eesm-cc-t1.h"
+#include "ns3/mmwave-eesm-cc-t2.h"
+#include "ns3/mmwave-eesm-ir-t1.h"
+#include "ns3/mmwave-eesm-ir-t2.h"
+#include "ns3/mmwave-lte-mi-error-model.h"
+#include "ns3/mmwave-spectrum-value-helper.h"
+#include "ns3/object-factory.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-amc-cqi-test.cc
+ * \ingroup test
+ *
+ * \brief Checks that the bisection and the cache of
+ * MmWaveAmc::CreateCqiFeedbackWbTdma select the same CQI and MCS as a linear
+ * search over all the MCSs.
+ */
+
+/**
+ * Build a set of SINR vectors: flat ones from -10 to 40 dB, and frequency
+ * selective ones with a pseudo-random fading around the same means, some of
+ * them with RBs without signal
+ * \param model the spectrum model
+ * \return the SINR vectors
+ */
+static std::vector<SpectrumValue>
+MakeSinrVectors(Ptr<const SpectrumModel> model)
+{
+    std::vector<SpectrumValue> vectors;
+    uint32_t state = 12345;
+    for (double meanDb = -10; meanDb <= 40; meanDb += 0.5)
+    {
+        SpectrumValue flat(model);
+        flat = std::pow(10, meanDb / 10);
+        vectors.push_back(flat);
+
+        SpectrumValue selective(model);
+        bool partial = (vectors.size() % 4) == 1;
+        for (auto it = selective.ValuesBegin(); it != selective.ValuesEnd(); ++it)
+        {
+            state = state * 1103515245 + 12345;
+            double fadingDb = ((state >> 8) % 2001) / 100.0 - 10;
+            bool active = !partial || (state >> 20) % 3 != 0;
+            *it = active ? std::pow(10, (meanDb + fadingDb) / 10) : 0.0;
+        }
+        vectors.push_back(selective);
+    }
+    return vectors;
+}
+
+/**
+ * The CQI feedback of the ErrorModel AMC as computed before the bisection,
+ * i.e., by trying all the MCSs in increasing order
+ * \param amc the AMC, used for the TB size
+ * \param em the error model
+ * \param sinr the SINR vector
+ * \param mcs the selected MCS
+ * \return the CQI
+ */
+static uint8_t
+LinearCqiFeedback(Ptr<MmWaveAmc> amc,
+                  Ptr<MmWaveErrorModel> em,
+                  const SpectrumValue& sinr,
+                  uint8_t& mcs)
+{
+    std::vector<int> rbMap;
+    int rbId = 0;
+    for (auto it = sinr.ConstValuesBegin(); it != sinr.ConstValuesEnd(); ++it, ++rbId)
+    {
+        if (*it != 0.0)
+        {
+            rbMap.push_back(rbId);
+        }
+    }
+
+    mcs = 0;
+    Ptr<MmWaveErrorModelOutput> output;
+    while (mcs <= em->GetMaxMcs())
+    {
+        output = em->GetTbDecodificationStats(sinr,
+                                              rbMap,
+                                              amc->CalculateTbSize(mcs, 12),
+                                              mcs,
+                                              MmWaveErrorModel::MmWaveErrorModelHistory());
+        if (output->m_tbler > 0.1)
+        {
+            break;
+        }
+        mcs++;
+    }
+    if (mcs > 0)
+    {
+        mcs--;
+    }
+
+    uint8_t cqi = 0;
+    if ((output->m_tbler > 0.1) && (mcs == 0))
+    {
+        cqi = 0;
+    }
+    else if (mcs == em->GetMaxMcs())
+    {
+        cqi = 15;
+    }
+    else
+    {
+        double s = em->GetSpectralEfficiencyForMcs(mcs);
+        while ((cqi < 15) && (em->GetSpectralEfficiencyForCqi(cqi + 1) <= s))
+        {
+            ++cqi;
+        }
+    }
+    return cqi;
+}
+
+/**
+ * \ingroup test
+ *
+ * \brief Compares the CQI feedback of MmWaveAmc with the linear search, for an error model
+ */
+class MmWaveAmcCqiTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param errorModelType the type of the error model
+     */
+    MmWaveAmcCqiTestCase(TypeId errorModelType)
+        : TestCase("CQI feedback with " + errorModelType.GetName()),
+          m_errorModelType(errorModelType)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    TypeId m_errorModelType; //!< type of the error model
+};
+
+void
+MmWaveAmcCqiTestCase::DoRun()
+{
+    Ptr<MmWavePhyMacCommon> config = CreateObject<MmWavePhyMacCommon>();
+    std::vector<SpectrumValue> vectors =
+        MakeSinrVectors(MmWaveSpectrumValueHelper::GetSpectrumModel(config));
+
+    ObjectFactory factory;
+    factory.SetTypeId(m_errorModelType);
+    Ptr<MmWaveErrorModel> em = DynamicCast<MmWaveErrorModel>(factory.Create());
+
+    Ptr<MmWaveAmc> amc = CreateObject<MmWaveAmc>(config);
+    amc->SetAttribute("ErrorModelType", TypeIdValue(m_errorModelType));
+    amc->SetAttribute("CqiCacheSize", UintegerValue(0));
+
+    Ptr<MmWaveAmc> cachedAmc = CreateObject<MmWaveAmc>(config);
+    cachedAmc->SetAttribute("ErrorModelType", TypeIdValue(m_errorModelType));
+    cachedAmc->SetAttribute("CqiCacheSize", UintegerValue(4));
+
+    for (uint32_t v = 0; v < vectors.size(); ++v)
+    {
+        uint8_t linearMcs = 0;
+        uint8_t linearCqi = LinearCqiFeedback(amc, em, vectors[v], linearMcs);
+
+        uint8_t mcs = 0;
+        uint8_t cqi = amc->CreateCqiFeedbackWbTdma(vectors[v], mcs);
+        NS_TEST_ASSERT_MSG_EQ(+mcs, +linearMcs, "Wrong MCS for SINR vector " << v);
+        NS_TEST_ASSERT_MSG_EQ(+cqi, +linearCqi, "Wrong CQI for SINR vector " << v);
+
+        // the second request of the same vector hits the cache, and the entries
+        // replaced in the meantime must not be returned for other vectors
+        for (uint32_t repeat = 0; repeat < 2; ++repeat)
+        {
+            uint8_t cachedMcs = 0;
+            uint8_t cachedCqi = cachedAmc->CreateCqiFeedbackWbTdma(vectors[v], cachedMcs);
+            NS_TEST_ASSERT_MSG_EQ(+cachedMcs, +linearMcs, "Wrong cached MCS for SINR vector " << v);
+            NS_TEST_ASSERT_MSG_EQ(+cachedCqi, +linearCqi, "Wrong cached CQI for SINR vector " << v);
+        }
+    }
+}
+
+/**
+ * \ingroup test
+ *
+ * \brief MmWaveAmc CQI feedback test suite
+ */
+class MmWaveAmcCqiTestSuite : public TestSuite
+{
+  public:
+    MmWaveAmcCqiTestSuite()
+        : TestSuite("mmwave-amc-cqi", UNIT)
+    {
+        AddTestCase(new MmWaveAmcCqiTestCase(MmWaveEesmIrT1::GetTypeId()), TestCase::QUICK);
+        AddTestCase(new MmWaveAmcCqiTestCase(MmWaveEesmIrT2::GetTypeId()), TestCase::QUICK);
+        AddTestCase(new MmWaveAmcCqiTestCase(MmWaveEesmCcT1::GetTypeId()), TestCase::QUICK);
+        AddTestCase(new MmWaveAmcCqiTestCase(MmWaveEesmCcT2::GetTypeId()), TestCase::QUICK);
+        AddTestCase(new MmWaveAmcCqiTestCase(MmWaveLteMiErrorModel::GetTypeId()),
+                    TestCase::QUICK);
+    }
+};
+
+static MmWaveAmcCqiTestSuite g_mmwaveAmcCqiTestSuite; //!< the test suite
@@ -18,16 +18,27 @@
 #include "simple-matrix-based-channel-model.h"
 
 #include "ns3/boolean.h"
+#include "ns3/channel-condition-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/double.h"
+#include "ns3/file-beamforming-codebook.h"
 #include "ns3/isotropic-antenna-model.h"
 #include "ns3/log.h"
 #include "ns3/mmwave-beamforming-model.h"
+#include "ns3/mmwave-phy-mac-common.h"
+#include "ns3/mmwave-spectrum-value-helper.h"
 #include "ns3/node.h"
 #include "ns3/object-factory.h"
 #include "ns3/pointer.h"
+#include "ns3/rng-seed-manager.h"
 #include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/three-gpp-channel-model.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
 #include "ns3/uinteger.h"
 #include "ns3/uniform-planar-array.h"
 
@@ -124,8 +135,16 @@ MmWaveDftBeamformingTestCase::DoRun(void)
                                                          "Antenna",
                                                          PointerValue(thisAntenna));
 
+    MmWaveBeamformingModel::BeamformingVectors probed =
+        bfModule->GetBeamformingVectorsForDevice(otherDevice, otherAntenna);
     bfModule->SetBeamformingVectorForDevice(otherDevice, otherAntenna);
     PhasedArrayModel::ComplexVector bfVector = thisAntenna->GetBeamformingVector();
+    NS_TEST_ASSERT_MSG_EQ((probed.first == bfVector),
+                          true,
+                          "The probed vector of this antenna is not the one set");
+    NS_TEST_ASSERT_MSG_EQ((probed.second == otherAntenna->GetBeamformingVector()),
+                          true,
+                          "The probed vector of the other antenna is not the one set");
 
     double maxGain = 0;    // used to store the max |AF|
     Angles maxAngle(0, 0); // used to store the direction where max |AF| is achieved
@@ -366,6 +385,244 @@ MmWaveSvdBeamformingTestCase::DoRun(void)
     }
 }
 
+/**
+ * This test case checks that the batched search of the MmWaveCodebookBeamforming
+ * selects the same beam pair as an exhaustive search over the received PSDs of
+ * all the pairs, on 3GPP UMa channels, in both the directions of the channel
+ */
+class MmWaveCodebookBeamformingTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param enbArray the size of the eNB array and codebook, e.g., "8x8"
+     * \param ueArray the size of the UE array and codebook
+     */
+    MmWaveCodebookBeamformingTestCase(std::string enbArray, std::string ueArray);
+
+    /**
+     * Destructor
+     */
+    virtual ~MmWaveCodebookBeamformingTestCase();
+
+  private:
+    /**
+     * Run the test
+     */
+    virtual void DoRun(void);
+
+    /**
+     * Create a device with an array and a codebook beamforming model
+     * \param array the size of the array and codebook
+     * \param mobility the mobility model of the device
+     * \return the beamforming model
+     */
+    Ptr<MmWaveCodebookBeamforming> CreateDevice(std::string array, Ptr<MobilityModel> mobility);
+
+    /**
+     * Probe and then select the beam pair with the beamforming model, and check
+     * that the probe does not configure the antennas, that the selected pair is
+     * the probed one, and that it is the pair with the highest received PSD
+     * \param bfModel the beamforming model
+     * \param otherBfModel the beamforming model of the other device
+     */
+    void CheckBeamPair(Ptr<MmWaveCodebookBeamforming> bfModel,
+                       Ptr<MmWaveCodebookBeamforming> otherBfModel);
+
+    std::string m_enbArray;                           //!< size of the eNB array
+    std::string m_ueArray;                            //!< size of the UE array
+    Ptr<MmWavePhyMacCommon> m_phyMacConfig;           //!< the PHY configuration
+    Ptr<ThreeGppSpectrumPropagationLossModel> m_splm; //!< the 3GPP channel
+    Ptr<SpectrumValue> m_txPsd;                       //!< the PSD of the search
+    uint32_t m_numChecks;                             //!< number of checked searches
+};
+
+MmWaveCodebookBeamformingTestCase::MmWaveCodebookBeamformingTestCase(std::string enbArray,
+                                                                     std::string ueArray)
+    : TestCase("Checks the MmWaveCodebookBeamforming batched search with a " + enbArray +
+               " eNB array and a " + ueArray + " UE array"),
+      m_enbArray(enbArray),
+      m_ueArray(ueArray),
+      m_numChecks(0)
+{
+    SetDataDir(NS_TEST_SOURCEDIR);
+}
+
+MmWaveCodebookBeamformingTestCase::~MmWaveCodebookBeamformingTestCase()
+{
+}
+
+Ptr<MmWaveCodebookBeamforming>
+MmWaveCodebookBeamformingTestCase::CreateDevice(std::string array, Ptr<MobilityModel> mobility)
+{
+    Ptr<Node> node = CreateObject<Node>();
+    node->AggregateObject(mobility);
+    Ptr<NetDevice> device = CreateObject<SimpleNetDevice>();
+    device->SetNode(node);
+    node->AddDevice(device);
+
+    std::size_t x = array.find('x');
+    Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray>(
+        "NumRows",
+        UintegerValue(std::stoul(array.substr(0, x))),
+        "NumColumns",
+        UintegerValue(std::stoul(array.substr(x + 1))),
+        "AntennaElement",
+        PointerValue(CreateObject<IsotropicAntennaModel>()));
+
+    ObjectFactory codebookFactory;
+    codebookFactory.SetTypeId(FileBeamformingCodebook::GetTypeId());
+    codebookFactory.Set("CodebookFilename",
+                        StringValue(CreateDataDirFilename("../model/Codebooks/" + array + ".txt")));
+
+    Ptr<MmWaveCodebookBeamforming> bfModel = CreateObjectWithAttributes<MmWaveCodebookBeamforming>(
+        "Device",
+        PointerValue(device),
+        "Antenna",
+        PointerValue(antenna),
+        "PhasedArraySpectrumPropagationLossModel",
+        PointerValue(m_splm),
+        "MmWavePhyMacCommon",
+        PointerValue(m_phyMacConfig),
+        "UpdatePeriod",
+        TimeValue(MilliSeconds(1)));
+    bfModel->SetBeamformingCodebookFactory(codebookFactory);
+    bfModel->Initialize();
+    return bfModel;
+}
+
+void
+MmWaveCodebookBeamformingTestCase::CheckBeamPair(Ptr<MmWaveCodebookBeamforming> bfModel,
+                                                 Ptr<MmWaveCodebookBeamforming> otherBfModel)
+{
+    Ptr<PhasedArrayModel> thisAntenna = bfModel->GetAntenna();
+    Ptr<PhasedArrayModel> otherAntenna = otherBfModel->GetAntenna();
+    Ptr<MobilityModel> thisMob = bfModel->GetDevice()->GetNode()->GetObject<MobilityModel>();
+    Ptr<MobilityModel> otherMob = otherBfModel->GetDevice()->GetNode()->GetObject<MobilityModel>();
+
+    // the probe searches the best pair, which is then set from the cache
+    Ptr<BeamformingCodebook> thisCodebook = thisAntenna->GetObject<BeamformingCodebook>();
+    Ptr<BeamformingCodebook> otherCodebook = otherAntenna->GetObject<BeamformingCodebook>();
+    thisAntenna->SetBeamformingVector(thisCodebook->GetCodeword(0));
+    otherAntenna->SetBeamformingVector(otherCodebook->GetCodeword(0));
+    MmWaveBeamformingModel::BeamformingVectors probed =
+        bfModel->GetBeamformingVectorsForDevice(otherBfModel->GetDevice(), otherAntenna);
+    NS_TEST_ASSERT_MSG_EQ((thisAntenna->GetBeamformingVector() == thisCodebook->GetCodeword(0)),
+                          true,
+                          "The probe changed this antenna");
+    NS_TEST_ASSERT_MSG_EQ((otherAntenna->GetBeamformingVector() == otherCodebook->GetCodeword(0)),
+                          true,
+                          "The probe changed the other antenna");
+
+    bfModel->SetBeamformingVectorForDevice(otherBfModel->GetDevice(), otherAntenna);
+    PhasedArrayModel::ComplexVector thisBfVector = thisAntenna->GetBeamformingVector();
+    PhasedArrayModel::ComplexVector otherBfVector = otherAntenna->GetBeamformingVector();
+    NS_TEST_ASSERT_MSG_EQ((probed.first == thisBfVector),
+                          true,
+                          "The probed vector of this antenna is not the one set");
+    NS_TEST_ASSERT_MSG_EQ((probed.second == otherBfVector),
+                          true,
+                          "The probed vector of the other antenna is not the one set");
+
+    // exhaustive search, the first pair with the highest PSD is selected
+    double maxRxPsd = -1;
+    uint32_t bestThisIdx = 0;
+    uint32_t bestOtherIdx = 0;
+    for (uint32_t thisIdx = 0; thisIdx < thisCodebook->GetCodebookSize(); thisIdx++)
+    {
+        thisAntenna->SetBeamformingVector(thisCodebook->GetCodeword(thisIdx));
+        for (uint32_t otherIdx = 0; otherIdx < otherCodebook->GetCodebookSize(); otherIdx++)
+        {
+            otherAntenna->SetBeamformingVector(otherCodebook->GetCodeword(otherIdx));
+
+            Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters>();
+            params->psd = Copy<SpectrumValue>(m_txPsd);
+            Ptr<SpectrumValue> rxPsd = m_splm->CalcRxPowerSpectralDensity(params,
+                                                                          thisMob,
+                                                                          otherMob,
+                                                                          thisAntenna,
+                                                                          otherAntenna);
+            double avgRxPsd = Sum(*rxPsd) / rxPsd->GetSpectrumModel()->GetNumBands();
+            if (avgRxPsd > maxRxPsd)
+            {
+                maxRxPsd = avgRxPsd;
+                bestThisIdx = thisIdx;
+                bestOtherIdx = otherIdx;
+            }
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ((thisBfVector == thisCodebook->GetCodeword(bestThisIdx)),
+                          true,
+                          "Wrong codeword for this antenna at " << Simulator::Now().As(Time::MS));
+    NS_TEST_ASSERT_MSG_EQ((otherBfVector == otherCodebook->GetCodeword(bestOtherIdx)),
+                          true,
+                          "Wrong codeword for the other antenna at "
+                              << Simulator::Now().As(Time::MS));
+    m_numChecks++;
+}
+
+void
+MmWaveCodebookBeamformingTestCase::DoRun(void)
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    m_phyMacConfig = CreateObject<MmWavePhyMacCommon>();
+    std::vector<int> activeRbs;
+    for (uint32_t i = 0; i < m_phyMacConfig->GetNumRb(); i++)
+    {
+        activeRbs.push_back(i);
+    }
+    m_txPsd =
+        MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity(m_phyMacConfig, 0.0, activeRbs);
+
+    Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+    channelModel->SetAttribute("Frequency", DoubleValue(m_phyMacConfig->GetCenterFrequency()));
+    channelModel->SetAttribute("Scenario", StringValue("UMa"));
+    channelModel->SetAttribute("ChannelConditionModel",
+                               PointerValue(CreateObject<ThreeGppUmaChannelConditionModel>()));
+    m_splm = CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    m_splm->SetChannelModel(channelModel);
+
+    Ptr<MobilityModel> enbMob = CreateObject<ConstantPositionMobilityModel>();
+    enbMob->SetPosition(Vector(0, 0, 25));
+    Ptr<MmWaveCodebookBeamforming> enbBfModel = CreateDevice(m_enbArray, enbMob);
+
+    // UEs moving in different directions, at different distances from the eNB
+    const uint32_t numUes = 4;
+    const uint32_t numSearches = 3;
+    for (uint32_t i = 0; i < numUes; i++)
+    {
+        Ptr<ConstantVelocityMobilityModel> ueMob = CreateObject<ConstantVelocityMobilityModel>();
+        double angle = 2 * M_PI * i / numUes + 0.3;
+        double distance = 30.0 + 40.0 * i;
+        ueMob->SetPosition(Vector(distance * cos(angle), distance * sin(angle), 1.5));
+        ueMob->SetVelocity(Vector(10 * sin(angle), -10 * cos(angle), 0));
+        Ptr<MmWaveCodebookBeamforming> ueBfModel = CreateDevice(m_ueArray, ueMob);
+
+        // the eNB searches first, so that the UE searches on the reversed channel
+        for (uint32_t j = 0; j < numSearches; j++)
+        {
+            Simulator::Schedule(MilliSeconds(10 * j),
+                                &MmWaveCodebookBeamformingTestCase::CheckBeamPair,
+                                this,
+                                enbBfModel,
+                                ueBfModel);
+            Simulator::Schedule(MilliSeconds(10 * j + 5),
+                                &MmWaveCodebookBeamformingTestCase::CheckBeamPair,
+                                this,
+                                ueBfModel,
+                                enbBfModel);
+        }
+    }
+
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(m_numChecks, 2 * numUes * numSearches, "Not all the searches were run");
+}
+
 /**
  * This suite tests if the beamforming module works properly
  */
@@ -381,6 +638,8 @@ MmWaveBeamformingTest::MmWaveBeamformingTest()
     // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
     AddTestCase(new MmWaveDftBeamformingTestCase, TestCase::QUICK);
     AddTestCase(new MmWaveSvdBeamformingTestCase, TestCase::QUICK);
+    AddTestCase(new MmWaveCodebookBeamformingTestCase("4x4", "2x2"), TestCase::QUICK);
+    AddTestCase(new MmWaveCodebookBeamformingTestCase("8x8", "1x4"), TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,389 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/mmwave-cell-kpm-aggregator.h"
+#include "ns3/mmwave-du-kpm-batch.h"
+#include "ns3/mmwave-phy-trace.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-cell-kpm-aggregator-test.cc
+ * \ingroup test
+ *
+ * \brief Checks the snapshots of MmWaveCellKpmAggregator, used for the E2 DU
+ * reports, against counters computed TB by TB.
+ */
+
+/**
+ * Build a pseudo-random sequence of received TBs
+ * \param n the number of TBs
+ * \param ues the number of UEs, with RNTIs from 1 to ues
+ * \param cellId the cell ID
+ * \return the TB trace parameters
+ */
+static std::vector<RxPacketTraceParams>
+MakeTbs(uint32_t n, uint32_t ues, uint16_t cellId)
+{
+    std::vector<RxPacketTraceParams> tbs(n);
+    uint32_t state = 12345 + cellId;
+    for (auto& tb : tbs)
+    {
+        state = state * 1103515245 + 12345;
+        tb = RxPacketTraceParams{};
+        tb.m_rnti = 1 + (state >> 8) % ues;
+        tb.m_cellId = cellId;
+        tb.m_mcs = (state >> 4) % 32;
+        tb.m_rv = (state >> 12) % 4 == 0 ? 1 : 0;
+        tb.m_numSym = 1 + (state >> 20) % 13;
+        tb.m_tbSize = 100 + (state >> 2) % 4000;
+        tb.m_sinr = std::pow(10, ((state >> 10) % 400 - 100) / 100.0);
+    }
+    return tbs;
+}
+
+/**
+ * Update the counters of a UE with a TB, one counter at a time
+ * \param counters the counters
+ * \param tb the TB
+ */
+static void
+ReferenceUpdate(UeSpecificPhyCounters& counters, const RxPacketTraceParams& tb)
+{
+    counters.m_macPdu++;
+    (tb.m_rv == 0 ? counters.m_macPduInitialTransmission : counters.m_macPduRetransmission)++;
+    counters.m_macVolume += tb.m_tbSize;
+    if (tb.m_mcs <= 9)
+    {
+        counters.m_macPduQpsk++;
+    }
+    else if (tb.m_mcs <= 16)
+    {
+        counters.m_macPdu16Qam++;
+    }
+    else if (tb.m_mcs <= 28)
+    {
+        counters.m_macPdu64Qam++;
+    }
+    if (tb.m_mcs <= 29)
+    {
+        counters.m_macMcs[tb.m_mcs / 5]++;
+    }
+    double sinrDb = 10 * std::log10(tb.m_sinr);
+    uint8_t bin = 0;
+    for (double threshold : {-6, 0, 6, 12, 18, 24})
+    {
+        bin += sinrDb > threshold;
+    }
+    counters.m_macSinrBin[bin]++;
+    counters.m_macNumberOfSymbols += tb.m_numSym;
+}
+
+/**
+ * \ingroup test
+ *
+ * \brief Compares two counter blocks
+ */
+static bool
+SameCounters(const UeSpecificPhyCounters& a, const UeSpecificPhyCounters& b)
+{
+    return a.m_macPdu == b.m_macPdu &&
+           a.m_macPduInitialTransmission == b.m_macPduInitialTransmission &&
+           a.m_macPduRetransmission == b.m_macPduRetransmission && a.m_macVolume == b.m_macVolume &&
+           a.m_macPduQpsk == b.m_macPduQpsk && a.m_macPdu16Qam == b.m_macPdu16Qam &&
+           a.m_macPdu64Qam == b.m_macPdu64Qam &&
+           a.m_macNumberOfSymbols == b.m_macNumberOfSymbols && a.m_macMcs == b.m_macMcs &&
+           a.m_macSinrBin == b.m_macSinrBin;
+}
+
+/**
+ * \ingroup test
+ *
+ * \brief Checks that a snapshot contains the cell totals and exactly the UEs
+ * that received a TB in the period, and that the counters restart from zero
+ */
+class MmWaveCellKpmAggregatorSnapshotTestCase : public TestCase
+{
+  public:
+    MmWaveCellKpmAggregatorSnapshotTestCase()
+        : TestCase("Snapshots of the cell and of the changed UEs")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Feed the TBs of a period and check the snapshot taken at the end
+     * \param aggregator the aggregator
+     * \param tbs the TBs of the period
+     */
+    void CheckPeriod(MmWaveCellKpmAggregator& aggregator,
+                     const std::vector<RxPacketTraceParams>& tbs);
+
+    MmWaveCellKpmAggregator::Snapshot m_snapshot; //!< reused across the periods
+};
+
+void
+MmWaveCellKpmAggregatorSnapshotTestCase::CheckPeriod(MmWaveCellKpmAggregator& aggregator,
+                                                     const std::vector<RxPacketTraceParams>& tbs)
+{
+    std::map<uint16_t, UeSpecificPhyCounters> reference;
+    UeSpecificPhyCounters cell;
+    for (const auto& tb : tbs)
+    {
+        aggregator.Update(tb);
+        ReferenceUpdate(reference[tb.m_rnti], tb);
+        ReferenceUpdate(cell, tb);
+    }
+    NS_TEST_ASSERT_MSG_EQ(aggregator.GetNumChangedUes(), reference.size(), "Wrong changed UEs");
+
+    aggregator.TakeSnapshot(m_snapshot);
+    NS_TEST_ASSERT_MSG_EQ(SameCounters(m_snapshot.m_cell, cell), true, "Wrong cell totals");
+    NS_TEST_ASSERT_MSG_EQ(m_snapshot.m_ues.size(), reference.size(), "Wrong UEs in the snapshot");
+
+    UeSpecificPhyCounters sum;
+    auto ue = m_snapshot.m_ues.begin();
+    for (const auto& ref : reference)
+    {
+        NS_TEST_ASSERT_MSG_EQ(ue->m_rnti, ref.first, "The snapshot is not sorted by RNTI");
+        NS_TEST_ASSERT_MSG_EQ(SameCounters(ue->m_counters, ref.second),
+                              true,
+                              "Wrong counters for RNTI " << ref.first);
+        NS_TEST_ASSERT_MSG_EQ(m_snapshot.Find(ref.first), &ue->m_counters, "Find failed");
+        sum.Add(ue->m_counters);
+        ++ue;
+    }
+    NS_TEST_ASSERT_MSG_EQ(SameCounters(sum, cell), true, "UE counters do not sum to the cell");
+    NS_TEST_ASSERT_MSG_EQ(aggregator.GetNumChangedUes(), 0, "Changed UEs left after a snapshot");
+    for (const auto& ref : reference)
+    {
+        NS_TEST_ASSERT_MSG_EQ(SameCounters(*aggregator.Find(ref.first), UeSpecificPhyCounters{}),
+                              true,
+                              "Counters of RNTI " << ref.first << " not zeroed");
+    }
+}
+
+void
+MmWaveCellKpmAggregatorSnapshotTestCase::DoRun()
+{
+    MmWaveCellKpmAggregator aggregator;
+
+    // all the UEs are scheduled, then only a few of them
+    CheckPeriod(aggregator, MakeTbs(5000, 50, 1));
+    CheckPeriod(aggregator, MakeTbs(20, 50, 2));
+    NS_TEST_ASSERT_MSG_LT(m_snapshot.m_ues.size(), 50, "Unchanged UEs in the snapshot");
+    NS_TEST_ASSERT_MSG_EQ(m_snapshot.Find(1000), nullptr, "Unknown RNTI found");
+
+    // a period without TBs
+    CheckPeriod(aggregator, {});
+
+    // a UE reset in the middle of a period is removed from the cell totals
+    std::vector<RxPacketTraceParams> tbs = MakeTbs(1000, 10, 3);
+    for (const auto& tb : tbs)
+    {
+        aggregator.Update(tb);
+    }
+    UeSpecificPhyCounters ue3 = *aggregator.Find(3);
+    aggregator.ResetUe(3);
+    aggregator.TakeSnapshot(m_snapshot);
+    UeSpecificPhyCounters sum;
+    for (const auto& ue : m_snapshot.m_ues)
+    {
+        sum.Add(ue.m_counters);
+    }
+    NS_TEST_ASSERT_MSG_EQ(SameCounters(sum, m_snapshot.m_cell), true, "Reset UE left in the cell");
+    UeSpecificPhyCounters cell;
+    for (const auto& tb : tbs)
+    {
+        ReferenceUpdate(cell, tb);
+    }
+    cell.Subtract(ue3);
+    NS_TEST_ASSERT_MSG_EQ(SameCounters(cell, m_snapshot.m_cell), true, "Wrong totals after reset");
+}
+
+/**
+ * \ingroup test
+ *
+ * \brief Checks that MmWavePhyTrace keeps the counters of each cell apart, and
+ * the duration of the reporting periods
+ */
+class MmWaveCellKpmAggregatorPhyTraceTestCase : public TestCase
+{
+  public:
+    MmWaveCellKpmAggregatorPhyTraceTestCase()
+        : TestCase("Per cell snapshots of MmWavePhyTrace")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+MmWaveCellKpmAggregatorPhyTraceTestCase::DoRun()
+{
+    Ptr<MmWavePhyTrace> phyTrace = CreateObject<MmWavePhyTrace>();
+    std::vector<RxPacketTraceParams> cell1 = MakeTbs(500, 20, 1);
+    std::vector<RxPacketTraceParams> cell2 = MakeTbs(300, 20, 2);
+    UeSpecificPhyCounters total1;
+    UeSpecificPhyCounters total2;
+    for (const auto& tb : cell1)
+    {
+        phyTrace->UpdateTraces(tb);
+        ReferenceUpdate(total1, tb);
+    }
+    for (const auto& tb : cell2)
+    {
+        phyTrace->UpdateTraces(tb);
+        ReferenceUpdate(total2, tb);
+    }
+
+    UeSpecificPhyCounters ue5;
+    for (const auto& tb : cell1)
+    {
+        if (tb.m_rnti == 5)
+        {
+            ReferenceUpdate(ue5, tb);
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(SameCounters(phyTrace->GetPhyCountersUeSpecific(5, 1), ue5),
+                          true,
+                          "Wrong UE counters");
+    NS_TEST_ASSERT_MSG_EQ(phyTrace->GetMacPduUeSpecific(5, 1), ue5.m_macPdu, "Wrong getter");
+
+    MmWaveCellKpmAggregator::Snapshot snapshot;
+    Simulator::Schedule(MilliSeconds(10), [&]() {
+        phyTrace->TakeCellKpmSnapshot(1, snapshot);
+    });
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(SameCounters(snapshot.m_cell, total1), true, "Wrong cell 1 totals");
+    NS_TEST_ASSERT_MSG_EQ(snapshot.m_window, MilliSeconds(10), "Wrong reporting window");
+    NS_TEST_ASSERT_MSG_EQ(phyTrace->GetLastResetTime(5, 1), MilliSeconds(10), "Wrong reset time");
+    NS_TEST_ASSERT_MSG_EQ(phyTrace->GetMacPduUeSpecific(5, 1), 0, "Cell 1 not zeroed");
+
+    Simulator::Schedule(MilliSeconds(5), [&]() {
+        phyTrace->TakeCellKpmSnapshot(2, snapshot);
+    });
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(SameCounters(snapshot.m_cell, total2), true, "Cell 2 counters lost");
+    NS_TEST_ASSERT_MSG_EQ(snapshot.m_window, MilliSeconds(15), "Wrong first reporting window");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup test
+ *
+ * \brief Checks the PRB usage, throughput and BLER computed by MmWaveDuKpmBatch
+ * for different numerologies, also after a change of bandwidth
+ */
+class MmWaveDuKpmBatchTestCase : public TestCase
+{
+  public:
+    MmWaveDuKpmBatchTestCase()
+        : TestCase("Batch DU KPMs with the numerology and bandwidth of the carrier")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+MmWaveDuKpmBatchTestCase::DoRun()
+{
+    Ptr<MmWavePhyMacCommon> config = CreateObject<MmWavePhyMacCommon>();
+    config->SetAttribute("Numerology", EnumValue(MmWavePhyMacCommon::NrNumerology2));
+    config->SetAttribute("Bandwidth", DoubleValue(100e6));
+
+    // numerology 2: 60 kHz SCS, 139 RBs in 100 MHz, 4 slots of 14 symbols per ms
+    MmWaveCellResourceGrid grid = MmWaveCellResourceGrid::FromConfig(config);
+    NS_TEST_ASSERT_MSG_EQ(grid.m_numRbs, 139, "Wrong number of RBs");
+    NS_TEST_ASSERT_MSG_EQ(grid.GetSymbolsInWindow(MilliSeconds(10)), 560, "Wrong symbols");
+
+    std::vector<UeSpecificPhyCounters> ues(3);
+    ues[0].m_macNumberOfSymbols = 280;
+    ues[0].m_macVolume = 125000;
+    ues[0].m_macPdu = 10;
+    ues[0].m_macPduRetransmission = 1;
+    ues[1].m_macNumberOfSymbols = 56;
+    ues[1].m_macPdu = 4;
+    ues[1].m_macPduRetransmission = 4;
+
+    MmWaveDuKpmBatch batch;
+    for (const auto& ue : ues)
+    {
+        batch.Add(ue);
+    }
+    batch.Compute(grid, MilliSeconds(10));
+    NS_TEST_ASSERT_MSG_EQ(batch.GetSize(), 3, "Wrong number of rows");
+    NS_TEST_ASSERT_MSG_EQ_TOL(batch.GetPrb(0), 69.5, 1e-9, "Wrong PRBs, half of the symbols");
+    NS_TEST_ASSERT_MSG_EQ_TOL(batch.GetPrb(1), 13.9, 1e-9, "Wrong PRBs, 10% of the symbols");
+    NS_TEST_ASSERT_MSG_EQ(batch.GetPrb(2), 0, "Wrong PRBs for an idle UE");
+    NS_TEST_ASSERT_MSG_EQ_TOL(batch.GetThroughputKbps(0), 1e5, 1e-6, "Wrong throughput");
+    NS_TEST_ASSERT_MSG_EQ_TOL(batch.GetBler(0), 0.1, 1e-9, "Wrong BLER");
+    NS_TEST_ASSERT_MSG_EQ(batch.GetBler(1), 1, "Wrong BLER");
+    NS_TEST_ASSERT_MSG_EQ(batch.GetBler(2), 0, "Wrong BLER for an idle UE");
+
+    // the bandwidth is doubled at runtime, the same symbols use twice the RBs
+    config->SetAttribute("Bandwidth", DoubleValue(200e6));
+    grid = MmWaveCellResourceGrid::FromConfig(config);
+    NS_TEST_ASSERT_MSG_EQ(grid.m_numRbs, 278, "Bandwidth change not applied");
+    batch.Compute(grid, MilliSeconds(10));
+    NS_TEST_ASSERT_MSG_EQ_TOL(batch.GetPrb(0), 139, 1e-9, "Wrong PRBs after the change");
+
+    // numerology 3: 120 kHz SCS, 8 slots per ms
+    config->SetAttribute("Numerology", EnumValue(MmWavePhyMacCommon::NrNumerology3));
+    config->SetAttribute("Bandwidth", DoubleValue(400e6));
+    grid = MmWaveCellResourceGrid::FromConfig(config);
+    NS_TEST_ASSERT_MSG_EQ(grid.m_numRbs, 278, "Wrong number of RBs");
+    NS_TEST_ASSERT_MSG_EQ(grid.GetSymbolsInWindow(MilliSeconds(10)), 1120, "Wrong symbols");
+    batch.Compute(grid, MilliSeconds(10));
+    NS_TEST_ASSERT_MSG_EQ_TOL(batch.GetPrb(0), 69.5, 1e-9, "Wrong PRBs, a quarter of the symbols");
+
+    // an empty window yields no usage
+    batch.Compute(grid, Seconds(0));
+    NS_TEST_ASSERT_MSG_EQ(batch.GetPrb(0), 0, "PRBs in an empty window");
+    NS_TEST_ASSERT_MSG_EQ(batch.GetThroughputKbps(0), 0, "Throughput in an empty window");
+}
+
+/**
+ * \ingroup test
+ *
+ * \brief MmWaveCellKpmAggregator test suite
+ */
+class MmWaveCellKpmAggregatorTestSuite : public TestSuite
+{
+  public:
+    MmWaveCellKpmAggregatorTestSuite()
+        : TestSuite("mmwave-cell-kpm-aggregator", UNIT)
+    {
+        AddTestCase(new MmWaveCellKpmAggregatorSnapshotTestCase, TestCase::QUICK);
+        AddTestCase(new MmWaveCellKpmAggregatorPhyTraceTestCase, TestCase::QUICK);
+        AddTestCase(new MmWaveDuKpmBatchTestCase, TestCase::QUICK);
+    }
+};
+
+static MmWaveCellKpmAggregatorTestSuite g_mmwaveCellKpmAggregatorTestSuite; //!< the test suite
@@ -0,0 +1,369 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/eps-bearer.h"
+#include "ns3/mmwave-flex-tti-mac-scheduler.h"
+#include "ns3/mmwave-flex-tti-maxweight-mac-scheduler.h"
+#include "ns3/object-factory.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-flex-tti-policy-test.cc
+ * \ingroup test
+ *
+ * \brief Checks the order in which the PF, MaxRate and MaxWeight FlexTTI
+ * schedulers serve the UEs, driven through the scheduler SAPs, and the
+ * defaults of their attributes.
+ */
+
+/**
+ * Scheduler SAP user counting the DL symbols allocated to each UE in the last
+ * slot
+ */
+class PolicyTestSchedSapUser : public MmWaveMacSchedSapUser
+{
+  public:
+    void SchedConfigInd(const struct SchedConfigIndParameters& params) override
+    {
+        m_dlSymbols.clear();
+        for (const auto& tti : params.m_slotAllocInfo.m_ttiAllocInfo)
+        {
+            if (tti.m_ttiType == TtiAllocInfo::CTRL_DATA &&
+                tti.m_tddMode == TtiAllocInfo::DL_slotAllocInfo)
+            {
+                if (tti.m_dci.m_rnti >= m_dlSymbols.size())
+                {
+                    m_dlSymbols.resize(tti.m_dci.m_rnti + 1);
+                }
+                m_dlSymbols[tti.m_dci.m_rnti] += tti.m_dci.m_numSym;
+            }
+        }
+    }
+
+    std::vector<uint32_t> m_dlSymbols; //!< DL symbols of each RNTI in the last slot
+};
+
+/**
+ * Scheduler CSCHED SAP user ignoring the confirmations
+ */
+class PolicyTestCschedSapUser : public MmWaveMacCschedSapUser
+{
+  public:
+    void CschedCellConfigCnf(const struct CschedCellConfigCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedUeConfigCnf(const struct CschedUeConfigCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedLcConfigCnf(const struct CschedLcConfigCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedLcReleaseCnf(const struct CschedLcReleaseCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedUeReleaseCnf(const struct CschedUeReleaseCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedUeConfigUpdateInd(
+        const struct CschedUeConfigUpdateIndParameters& /* params */) override
+    {
+    }
+
+    void CschedCellConfigUpdateInd(
+        const struct CschedCellConfigUpdateIndParameters& /* params */) override
+    {
+    }
+};
+
+/**
+ * DL state reported for a UE in the slot in which the order is checked
+ */
+struct PolicyTestUe
+{
+    uint8_t m_cqi;          //!< wideband CQI
+    EpsBearer::Qci m_qci;   //!< QCI of the bearer of the UE
+    uint16_t m_holDelay;    //!< head of line delay of the RLC buffer (ms)
+    uint32_t m_arrivalRate; //!< arrival rate of the RLC buffer (bytes/s)
+};
+
+/**
+ * \ingroup test
+ *
+ * \brief Two or more UEs with full DL buffers: a first UE may be served alone
+ * for some slots, to build up its average throughput, then all the UEs report
+ * their state and the UE served first, which takes all the data symbols of the
+ * slot, is checked
+ */
+class MmWaveFlexTtiPolicyTestCase : public TestCase
+{
+  public:
+    /**
+     * \param name the name of the scenario
+     * \param type the TypeId name of the scheduler
+     * \param algorithm the value of the Algorithm attribute, or empty
+     * \param ues the state of the UEs, with RNTIs from 1
+     * \param warmupRnti the RNTI served alone before the check, or 0
+     * \param firstRnti the RNTI expected to be served first
+     */
+    MmWaveFlexTtiPolicyTestCase(std::string name,
+                                std::string type,
+                                std::string algorithm,
+                                std::vector<PolicyTestUe> ues,
+                                uint16_t warmupRnti,
+                                uint16_t firstRnti);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Schedule a slot, the given UEs reporting full DL buffers
+     * \param rntis the RNTIs with data
+     */
+    void RunSlot(const std::vector<uint16_t>& rntis);
+
+    std::string m_type;               //!< the TypeId name of the scheduler
+    std::string m_algorithm;          //!< the value of the Algorithm attribute
+    std::vector<PolicyTestUe> m_ues;  //!< the state of the UEs
+    uint16_t m_warmupRnti;            //!< the RNTI served alone before the check
+    uint16_t m_firstRnti;             //!< the RNTI expected to be served first
+    uint32_t m_slot{0};               //!< the index of the next slot
+    Ptr<MmWavePhyMacCommon> m_config; //!< the configuration of the cell
+    Ptr<MmWaveFlexTtiMacSchedulerBase> m_scheduler; //!< the scheduler
+    PolicyTestSchedSapUser m_schedSapUser;          //!< the scheduler SAP user
+    PolicyTestCschedSapUser m_cschedSapUser;        //!< the CSCHED SAP user
+};
+
+MmWaveFlexTtiPolicyTestCase::MmWaveFlexTtiPolicyTestCase(std::string name,
+                                                         std::string type,
+                                                         std::string algorithm,
+                                                         std::vector<PolicyTestUe> ues,
+                                                         uint16_t warmupRnti,
+                                                         uint16_t firstRnti)
+    : TestCase("Order of " + type + (algorithm.empty() ? "" : " " + algorithm) + ": " + name),
+      m_type(type),
+      m_algorithm(algorithm),
+      m_ues(ues),
+      m_warmupRnti(warmupRnti),
+      m_firstRnti(firstRnti)
+{
+}
+
+void
+MmWaveFlexTtiPolicyTestCase::RunSlot(const std::vector<uint16_t>& rntis)
+{
+    MmWaveMacSchedSapProvider* sched = m_scheduler->GetMacSchedSapProvider();
+    MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters dlCqi;
+    for (uint16_t rnti : rntis)
+    {
+        const PolicyTestUe& ue = m_ues[rnti - 1];
+        MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters rlc;
+        rlc.m_rnti = rnti;
+        rlc.m_logicalChannelIdentity = 3;
+        rlc.m_rlcTransmissionQueueSize = 1000000;
+        rlc.m_rlcTransmissionQueueHolDelay = ue.m_holDelay;
+        rlc.m_rlcRetransmissionQueueSize = 0;
+        rlc.m_rlcRetransmissionHolDelay = 0;
+        rlc.m_rlcStatusPduSize = 0;
+        rlc.m_arrivalRate = ue.m_arrivalRate;
+        sched->SchedDlRlcBufferReq(rlc);
+
+        DlCqiInfo cqi;
+        cqi.m_rnti = rnti;
+        cqi.m_ri = 1;
+        cqi.m_cqiType = DlCqiInfo::WB;
+        cqi.m_wbCqi = ue.m_cqi;
+        cqi.m_wbPmi = 0;
+        dlCqi.m_cqiList.push_back(cqi);
+    }
+    sched->SchedDlCqiInfoReq(dlCqi);
+
+    const uint32_t slotsPerSubframe = m_config->GetSlotsPerSubframe();
+    const uint32_t subframesPerFrame = m_config->GetSubframesPerFrame();
+    MmWaveMacSchedSapProvider::SchedTriggerReqParameters trigger;
+    trigger.m_snfSf = SfnSf(m_slot / (slotsPerSubframe * subframesPerFrame),
+                            (m_slot / slotsPerSubframe) % subframesPerFrame,
+                            m_slot % slotsPerSubframe);
+    sched->SchedTriggerReq(trigger);
+    ++m_slot;
+}
+
+void
+MmWaveFlexTtiPolicyTestCase::DoRun()
+{
+    m_config = CreateObject<MmWavePhyMacCommon>();
+    m_scheduler = ObjectFactory(m_type).Create<MmWaveFlexTtiMacSchedulerBase>();
+    m_scheduler->SetAttribute("HarqEnabled", BooleanValue(false));
+    if (!m_algorithm.empty())
+    {
+        m_scheduler->SetAttribute("Algorithm", StringValue(m_algorithm));
+    }
+    m_scheduler->ConfigureCommonParameters(m_config);
+    m_scheduler->SetMacSchedSapUser(&m_schedSapUser);
+    m_scheduler->SetMacCschedSapUser(&m_cschedSapUser);
+    std::vector<uint16_t> rntis;
+    for (uint16_t rnti = 1; rnti <= m_ues.size(); ++rnti)
+    {
+        MmWaveMacCschedSapProvider::CschedUeConfigReqParameters ueConfig;
+        ueConfig.m_rnti = rnti;
+        m_scheduler->GetMacCschedSapProvider()->CschedUeConfigReq(ueConfig);
+
+        MmWaveMacCschedSapProvider::CschedLcConfigReqParameters lcConfig;
+        lcConfig.m_rnti = rnti;
+        lcConfig.m_reconfigureFlag = false;
+        LogicalChannelConfigListElement_s lc;
+        lc.m_logicalChannelIdentity = 3;
+        lc.m_qci = m_ues[rnti - 1].m_qci;
+        lcConfig.m_logicalChannelConfigList.push_back(lc);
+        m_scheduler->GetMacCschedSapProvider()->CschedLcConfigReq(lcConfig);
+
+        rntis.push_back(rnti);
+    }
+
+    const uint32_t numDataSymbols =
+        m_config->GetSymbPerSlot() - m_config->GetDlCtrlSymbols() - m_config->GetUlCtrlSymbols();
+    if (m_warmupRnti != 0)
+    {
+        for (uint32_t slot = 0; slot < 100; ++slot)
+        {
+            RunSlot({m_warmupRnti});
+        }
+        std::vector<uint32_t> dlSymbols = m_schedSapUser.m_dlSymbols;
+        dlSymbols.resize(m_ues.size() + 1);
+        NS_TEST_ASSERT_MSG_EQ(dlSymbols[m_warmupRnti], numDataSymbols, "UE not served alone");
+    }
+
+    // the UEs are served in full in the order of the policy: with full
+    // buffers, the first one takes all the data symbols
+    RunSlot(rntis);
+    std::vector<uint32_t> dlSymbols = m_schedSapUser.m_dlSymbols;
+    dlSymbols.resize(m_ues.size() + 1);
+    for (uint16_t rnti : rntis)
+    {
+        NS_TEST_ASSERT_MSG_EQ(dlSymbols[rnti],
+                              (rnti == m_firstRnti ? numDataSymbols : 0),
+                              "Wrong DL symbols of RNTI " << rnti);
+    }
+
+    m_scheduler->Dispose();
+}
+
+/**
+ * \ingroup test
+ *
+ * \brief The defaults of the Algorithm and HarqEnabled attributes of the
+ * schedulers are those of their TypeIds before they shared the FlexTTI engine
+ */
+class MmWaveFlexTtiPolicyDefaultsTestCase : public TestCase
+{
+  public:
+    MmWaveFlexTtiPolicyDefaultsTestCase()
+        : TestCase("Attribute defaults of the FlexTTI schedulers")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        const std::vector<std::pair<std::string, bool>> harqDefaults = {
+            {"ns3::MmWaveFlexTtiMacScheduler", true},
+            {"ns3::MmWaveFlexTtiPfMacScheduler", false},
+            {"ns3::MmWaveFlexTtiMaxRateMacScheduler", false},
+            {"ns3::MmWaveFlexTtiMaxWeightMacScheduler", false},
+        };
+        for (const auto& harqDefault : harqDefaults)
+        {
+            Ptr<Object> scheduler = ObjectFactory(harqDefault.first).Create();
+            BooleanValue harqEnabled;
+            scheduler->GetAttribute("HarqEnabled", harqEnabled);
+            NS_TEST_ASSERT_MSG_EQ(harqEnabled.Get(),
+                                  harqDefault.second,
+                                  "Wrong HarqEnabled default of " << harqDefault.first);
+        }
+
+        Ptr<Object> maxWeight = ObjectFactory("ns3::MmWaveFlexTtiMaxWeightMacScheduler").Create();
+        EnumValue algorithm;
+        maxWeight->GetAttribute("Algorithm", algorithm);
+        NS_TEST_ASSERT_MSG_EQ(algorithm.Get(),
+                              MmWaveFlexTtiMaxWeightPolicy::EDF,
+                              "Wrong Algorithm default");
+    }
+};
+
+/**
+ * \ingroup test
+ *
+ * \brief FlexTTI scheduling policy test suite
+ */
+class MmWaveFlexTtiPolicyTestSuite : public TestSuite
+{
+  public:
+    MmWaveFlexTtiPolicyTestSuite()
+        : TestSuite("mmwave-flex-tti-policy", UNIT)
+    {
+        const EpsBearer::Qci qci = EpsBearer::NGBR_VIDEO_TCP_DEFAULT;
+
+        // equal rates: the UE not served yet has the lower average throughput
+        AddTestCase(new MmWaveFlexTtiPolicyTestCase("lower average throughput first",
+                                                    "ns3::MmWaveFlexTtiPfMacScheduler",
+                                                    "",
+                                                    {{15, qci, 0, 0}, {15, qci, 0, 0}},
+                                                    1,
+                                                    2),
+                    TestCase::QUICK);
+        AddTestCase(new MmWaveFlexTtiPolicyTestCase("higher MCS first",
+                                                    "ns3::MmWaveFlexTtiMaxRateMacScheduler",
+                                                    "",
+                                                    {{5, qci, 0, 0}, {15, qci, 0, 0}},
+                                                    0,
+                                                    2),
+                    TestCase::QUICK);
+        // a HOL delay of 100 ms out of a budget of 300 ms is less urgent than
+        // one of 20 ms out of 50 ms
+        AddTestCase(
+            new MmWaveFlexTtiPolicyTestCase("larger delay relative to the budget first",
+                                            "ns3::MmWaveFlexTtiMaxWeightMacScheduler",
+                                            "EDF",
+                                            {{15, qci, 100, 0}, {15, EpsBearer::GBR_GAMING, 20, 0}},
+                                            0,
+                                            2),
+            TestCase::QUICK);
+        // the UE served alone has the higher arrival rate, but its average
+        // throughput is above it
+        AddTestCase(new MmWaveFlexTtiPolicyTestCase("larger delivery debt first",
+                                                    "ns3::MmWaveFlexTtiMaxWeightMacScheduler",
+                                                    "DeliveryDebt",
+                                                    {{15, qci, 0, 2000000}, {15, qci, 0, 1000000}},
+                                                    1,
+                                                    2),
+                    TestCase::QUICK);
+        AddTestCase(new MmWaveFlexTtiPolicyDefaultsTestCase, TestCase::QUICK);
+    }
+};
+
+static MmWaveFlexTtiPolicyTestSuite g_mmwaveFlexTtiPolicyTestSuite; //!< the test suite
@@ -0,0 +1,291 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/mmwave-flex-tti-mac-scheduler.h"
+#include "ns3/object-factory.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-flex-tti-slice-test.cc
+ * \ingroup test
+ *
+ * \brief Checks the PRB quotas of the slices of the FlexTTI schedulers, with
+ * UEs with full DL buffers, driven through the scheduler SAPs.
+ */
+
+/**
+ * Scheduler SAP user counting the DL symbols allocated to each UE
+ */
+class SliceTestSchedSapUser : public MmWaveMacSchedSapUser
+{
+  public:
+    void SchedConfigInd(const struct SchedConfigIndParameters& params) override
+    {
+        for (const auto& tti : params.m_slotAllocInfo.m_ttiAllocInfo)
+        {
+            if (tti.m_ttiType == TtiAllocInfo::CTRL_DATA &&
+                tti.m_tddMode == TtiAllocInfo::DL_slotAllocInfo)
+            {
+                if (tti.m_dci.m_rnti >= m_dlSymbols.size())
+                {
+                    m_dlSymbols.resize(tti.m_dci.m_rnti + 1);
+                }
+                m_dlSymbols[tti.m_dci.m_rnti] += tti.m_dci.m_numSym;
+            }
+        }
+    }
+
+    std::vector<uint64_t> m_dlSymbols; //!< DL symbols of each RNTI
+};
+
+/**
+ * Scheduler CSCHED SAP user ignoring the confirmations
+ */
+class SliceTestCschedSapUser : public MmWaveMacCschedSapUser
+{
+  public:
+    void CschedCellConfigCnf(const struct CschedCellConfigCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedUeConfigCnf(const struct CschedUeConfigCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedLcConfigCnf(const struct CschedLcConfigCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedLcReleaseCnf(const struct CschedLcReleaseCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedUeReleaseCnf(const struct CschedUeReleaseCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedUeConfigUpdateInd(
+        const struct CschedUeConfigUpdateIndParameters& /* params */) override
+    {
+    }
+
+    void CschedCellConfigUpdateInd(
+        const struct CschedCellConfigUpdateIndParameters& /* params */) override
+    {
+    }
+};
+
+/**
+ * \ingroup test
+ *
+ * \brief Six UEs in three slices: two in a slice with a low maximum share,
+ * two in a slice with a high minimum share and two in the default slice
+ */
+class MmWaveFlexTtiSliceTestCase : public TestCase
+{
+  public:
+    /**
+     * \param type the TypeId name of the scheduler
+     * \param backlogged the RNTIs with data, among 1 to 6
+     */
+    MmWaveFlexTtiSliceTestCase(std::string type, std::vector<uint16_t> backlogged);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Schedule slots, the backlogged UEs reporting full DL buffers
+     * \param slots the number of slots
+     */
+    void RunSlots(uint32_t slots);
+
+    std::string m_type;                 //!< the TypeId name of the scheduler
+    std::vector<uint16_t> m_backlogged; //!< the RNTIs with data
+    Ptr<MmWavePhyMacCommon> m_config;   //!< the configuration of the cell
+    Ptr<MmWaveFlexTtiMacSchedulerBase> m_scheduler; //!< the scheduler
+    SliceTestSchedSapUser m_schedSapUser;           //!< the scheduler SAP user
+    SliceTestCschedSapUser m_cschedSapUser;         //!< the CSCHED SAP user
+};
+
+MmWaveFlexTtiSliceTestCase::MmWaveFlexTtiSliceTestCase(std::string type,
+                                                       std::vector<uint16_t> backlogged)
+    : TestCase("Slice quotas of " + type + " with " + std::to_string(backlogged.size()) +
+               " backlogged UEs"),
+      m_type(type),
+      m_backlogged(backlogged)
+{
+}
+
+void
+MmWaveFlexTtiSliceTestCase::RunSlots(uint32_t slots)
+{
+    MmWaveMacSchedSapProvider* sched = m_scheduler->GetMacSchedSapProvider();
+    const uint32_t slotsPerSubframe = m_config->GetSlotsPerSubframe();
+    const uint32_t subframesPerFrame = m_config->GetSubframesPerFrame();
+    for (uint32_t slot = 0; slot < slots; ++slot)
+    {
+        MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters dlCqi;
+        for (uint16_t rnti : m_backlogged)
+        {
+            MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters rlc;
+            rlc.m_rnti = rnti;
+            rlc.m_logicalChannelIdentity = 3;
+            rlc.m_rlcTransmissionQueueSize = 1000000;
+            rlc.m_rlcTransmissionQueueHolDelay = 0;
+            rlc.m_rlcRetransmissionQueueSize = 0;
+            rlc.m_rlcRetransmissionHolDelay = 0;
+            rlc.m_rlcStatusPduSize = 0;
+            rlc.m_arrivalRate = 0;
+            sched->SchedDlRlcBufferReq(rlc);
+
+            DlCqiInfo cqi;
+            cqi.m_rnti = rnti;
+            cqi.m_ri = 1;
+            cqi.m_cqiType = DlCqiInfo::WB;
+            cqi.m_wbCqi = 15;
+            cqi.m_wbPmi = 0;
+            dlCqi.m_cqiList.push_back(cqi);
+        }
+        sched->SchedDlCqiInfoReq(dlCqi);
+
+        MmWaveMacSchedSapProvider::SchedTriggerReqParameters trigger;
+        trigger.m_snfSf = SfnSf(slot / (slotsPerSubframe * subframesPerFrame),
+                                (slot / slotsPerSubframe) % subframesPerFrame,
+                                slot % slotsPerSubframe);
+        sched->SchedTriggerReq(trigger);
+    }
+}
+
+void
+MmWaveFlexTtiSliceTestCase::DoRun()
+{
+    m_config = CreateObject<MmWavePhyMacCommon>();
+    m_scheduler = ObjectFactory(m_type).Create<MmWaveFlexTtiMacSchedulerBase>();
+    m_scheduler->SetAttribute("HarqEnabled", BooleanValue(false));
+    m_scheduler->ConfigureCommonParameters(m_config);
+    m_scheduler->SetMacSchedSapUser(&m_schedSapUser);
+    m_scheduler->SetMacCschedSapUser(&m_cschedSapUser);
+    for (uint16_t rnti = 1; rnti <= 6; ++rnti)
+    {
+        MmWaveMacCschedSapProvider::CschedUeConfigReqParameters ueConfig;
+        ueConfig.m_rnti = rnti;
+        m_scheduler->GetMacCschedSapProvider()->CschedUeConfigReq(ueConfig);
+    }
+
+    // without slices, all the data symbols go to the UEs
+    const uint32_t slots = 1000;
+    const int numDataSymbols =
+        m_config->GetSymbPerSlot() - m_config->GetDlCtrlSymbols() - m_config->GetUlCtrlSymbols();
+    std::vector<MmWaveFlexTtiMacSchedulerBase::SliceKpm> kpms;
+    RunSlots(slots);
+    m_scheduler->TakeSliceKpmSnapshot(kpms);
+    NS_TEST_ASSERT_MSG_EQ(kpms.empty(), true, "Slices without configuration");
+    uint64_t total = 0;
+    for (uint64_t sym : m_schedSapUser.m_dlSymbols)
+    {
+        total += sym;
+    }
+    NS_TEST_ASSERT_MSG_EQ(total, uint64_t(slots) * numDataSymbols, "Symbols left unused");
+
+    // slice A caps UEs 1 and 2 at 30%, slice B grants 50% to UEs 3 and 4, up to 60%, UEs 5 and 6
+    // are in the default slice
+    const uint32_t sliceA = MmWaveFlexTtiMacSchedulerBase::MakeSNssai(2, 1);
+    const uint32_t sliceB = MmWaveFlexTtiMacSchedulerBase::MakeSNssai(3);
+    m_scheduler->SetSliceQuota(sliceA, {0.2, 0.3, 0});
+    m_scheduler->SetSliceQuota(sliceB, {0.5, 0.6, 1});
+    m_scheduler->SetUeSlice(1, sliceA);
+    m_scheduler->SetUeSlice(2, sliceA);
+    m_scheduler->SetUeSlice(3, sliceB);
+    m_scheduler->SetUeSlice(4, sliceB);
+    NS_TEST_ASSERT_MSG_EQ(m_scheduler->HasSlices(), true, "Slices not configured");
+
+    m_schedSapUser.m_dlSymbols.assign(7, 0);
+    RunSlots(slots);
+    m_scheduler->TakeSliceKpmSnapshot(kpms);
+    NS_TEST_ASSERT_MSG_EQ(kpms.size(), 3, "Wrong number of slices");
+    NS_TEST_ASSERT_MSG_EQ(kpms[0].m_sNssai,
+                          MmWaveFlexTtiMacSchedulerBase::MakeSNssai(1),
+                          "The default slice comes first");
+    NS_TEST_ASSERT_MSG_EQ(kpms[1].m_sNssai, sliceA, "Wrong S-NSSAI");
+    NS_TEST_ASSERT_MSG_EQ(kpms[2].m_sNssai, sliceB, "Wrong S-NSSAI");
+
+    const std::vector<uint64_t>& ue = m_schedSapUser.m_dlSymbols;
+    uint64_t symA = ue[1] + ue[2];
+    uint64_t symB = ue[3] + ue[4];
+    uint64_t symDefault = ue[5] + ue[6];
+    NS_TEST_ASSERT_MSG_EQ(kpms[1].m_dlSymbols, symA, "Wrong DL symbols of slice A");
+    NS_TEST_ASSERT_MSG_EQ(kpms[2].m_dlSymbols, symB, "Wrong DL symbols of slice B");
+    NS_TEST_ASSERT_MSG_EQ(kpms[0].m_dlSymbols, symDefault, "Wrong DL symbols of the default slice");
+    NS_TEST_ASSERT_MSG_EQ(kpms[0].m_numUes, 2, "Wrong UEs of the default slice");
+    NS_TEST_ASSERT_MSG_EQ(kpms[1].m_numUes, 2, "Wrong UEs of slice A");
+    NS_TEST_ASSERT_MSG_GT(kpms[1].m_dlBytes, 0, "No DL bytes in slice A");
+
+    uint64_t maxA = uint64_t(slots) * int(0.3 * numDataSymbols);
+    uint64_t maxB = uint64_t(slots) * int(0.6 * numDataSymbols);
+    NS_TEST_ASSERT_MSG_EQ((symA <= maxA), true, "Slice A above its maximum share");
+    NS_TEST_ASSERT_MSG_EQ((symB <= maxB), true, "Slice B above its maximum share");
+    if (m_backlogged.size() == 6)
+    {
+        // both slices reach their maximum share, the default slice gets the rest
+        NS_TEST_ASSERT_MSG_EQ(symA, maxA, "Slice A below its maximum share");
+        NS_TEST_ASSERT_MSG_EQ(symB, maxB, "Slice B below its maximum share");
+        NS_TEST_ASSERT_MSG_EQ(symA + symB + symDefault,
+                              uint64_t(slots) * numDataSymbols,
+                              "Symbols left unused");
+    }
+    else
+    {
+        // only the UEs of slice A have data: the slice is capped, even if the other slices have no data
+        NS_TEST_ASSERT_MSG_EQ(symA, maxA, "Slice A not capped");
+        NS_TEST_ASSERT_MSG_EQ(symB + symDefault, 0, "Symbols to slices without data");
+    }
+
+    // the counters are zeroed by the snapshot
+    m_scheduler->TakeSliceKpmSnapshot(kpms);
+    NS_TEST_ASSERT_MSG_EQ(kpms[1].m_dlSymbols, 0, "Counters not zeroed");
+
+    m_scheduler->Dispose();
+}
+
+/**
+ * \ingroup test
+ *
+ * \brief FlexTTI slice test suite
+ */
+class MmWaveFlexTtiSliceTestSuite : public TestSuite
+{
+  public:
+    MmWaveFlexTtiSliceTestSuite()
+        : TestSuite("mmwave-flex-tti-slice", UNIT)
+    {
+        AddTestCase(new MmWaveFlexTtiSliceTestCase("ns3::MmWaveFlexTtiMacScheduler",
+                                                   {1, 2, 3, 4, 5, 6}),
+                    TestCase::QUICK);
+        AddTestCase(new MmWaveFlexTtiSliceTestCase("ns3::MmWaveFlexTtiPfMacScheduler",
+                                                   {1, 2, 3, 4, 5, 6}),
+                    TestCase::QUICK);
+        AddTestCase(new MmWaveFlexTtiSliceTestCase("ns3::MmWaveFlexTtiMacScheduler", {1, 2}),
+                    TestCase::QUICK);
+    }
+};
+
+static MmWaveFlexTtiSliceTestSuite g_mmwaveFlexTtiSliceTestSuite; //!< the test suite
@@ -24,6 +24,9 @@
 #include "ns3/mmwave-eesm-ir-t2.h"
 #include "ns3/test.h"
 
+#include <cmath>
+#include <limits>
+
 using namespace ns3;
 using namespace mmwave;
 
@@ -35,6 +38,9 @@ using namespace mmwave;
  * The test checks two issues: 1) LDPC base graph (BG) selection works properly, and 2)
  * BLER values are properly obtained from the BLER-SINR look up tables for different
  * block sizes, MCS Tables, BG types, and SINR values.
+ * It also checks the lookup tables and the exponential kernel of the EESM
+ * model against a direct evaluation: the BLER must be the same, and the
+ * effective SINR within a relative error of 1e-12.
  *
  */
 
@@ -63,6 +69,13 @@ class MmWaveL2smEesmTestCase : public TestCase
     void TestMappingSinrBler2(const Ptr<MmWaveEesmErrorModel>& em);
     void TestBgType1(const Ptr<MmWaveEesmErrorModel>& em);
     void TestBgType2(const Ptr<MmWaveEesmErrorModel>& em);
+    void TestLookupTables(const Ptr<MmWaveEesmErrorModel>& em);
+    void TestSinrEff(const Ptr<MmWaveEesmErrorModel>& em);
+
+    double ReferenceMappingSinrBler(const Ptr<MmWaveEesmErrorModel>& em,
+                                    double sinr,
+                                    uint8_t mcs,
+                                    uint32_t cbSizeBit);
 
     void TestEesmCcTable1();
     void TestEesmCcTable2();
@@ -225,6 +238,151 @@ MmWaveL2smEesmTestCase::TestMappingSinrBler2(const Ptr<MmWaveEesmErrorModel>& em
     }
 }
 
+/**
+ * \brief The BLER of a CB by a binary search over the simulated points
+ * \param em the error model
+ * \param sinr the effective SINR
+ * \param mcs the MCS
+ * \param cbSizeBit the CB size in bits
+ * \return the BLER
+ */
+double
+MmWaveL2smEesmTestCase::ReferenceMappingSinrBler(const Ptr<MmWaveEesmErrorModel>& em,
+                                                 double sinr,
+                                                 uint8_t mcs,
+                                                 uint32_t cbSizeBit)
+{
+    double sinrDb = 10 * std::log10(sinr);
+    const auto& cbMap =
+        em->GetSimulatedBlerFromSINR()->at(em->GetBaseGraphType(cbSizeBit, mcs)).at(mcs);
+    auto cbIt = cbMap.upper_bound(cbSizeBit);
+    if (cbIt != cbMap.begin())
+    {
+        cbIt--;
+    }
+    const auto& sinrDbPoints = std::get<0>(cbIt->second);
+    if (sinrDb < sinrDbPoints.front())
+    {
+        return 1.0;
+    }
+    if (sinrDb > sinrDbPoints.back())
+    {
+        return 0.0;
+    }
+    auto point = std::upper_bound(sinrDbPoints.begin(), sinrDbPoints.end(), sinrDb);
+    if (point != sinrDbPoints.begin())
+    {
+        point--;
+    }
+    return std::get<1>(cbIt->second).at(point - sinrDbPoints.begin());
+}
+
+void
+MmWaveL2smEesmTestCase::TestLookupTables(const Ptr<MmWaveEesmErrorModel>& em)
+{
+    // every simulated point, the SINRs next to it and the midpoints, for every
+    // simulated CB size and its neighbours
+    for (uint8_t mcs = 0; mcs <= em->GetMaxMcs(); ++mcs)
+    {
+        for (const auto& bgCurves : *em->GetSimulatedBlerFromSINR())
+        {
+            for (const auto& cbCurve : bgCurves.at(mcs))
+            {
+                std::vector<double> sinrDbs;
+                const auto& points = std::get<0>(cbCurve.second);
+                for (std::size_t i = 0; i < points.size(); ++i)
+                {
+                    sinrDbs.push_back(points[i]);
+                    sinrDbs.push_back(std::nextafter(points[i], -1e3));
+                    sinrDbs.push_back(std::nextafter(points[i], 1e3));
+                    sinrDbs.push_back(i + 1 < points.size() ? (points[i] + points[i + 1]) / 2
+                                                            : points[i] + 1);
+                }
+                sinrDbs.push_back(points.front() - 1);
+
+                for (uint32_t cbSize : {cbCurve.first, cbCurve.first + 1})
+                {
+                    for (double sinrDb : sinrDbs)
+                    {
+                        double sinr = std::pow(10, sinrDb / 10);
+                        NS_TEST_ASSERT_MSG_EQ(em->MappingSinrBler(sinr, mcs, cbSize),
+                                              ReferenceMappingSinrBler(em, sinr, mcs, cbSize),
+                                              "The lookup table differs from the simulated "
+                                              "curve. SINR="
+                                                  << sinrDb << " dB MCS " << +mcs << " CBS "
+                                                  << cbSize);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+MmWaveL2smEesmTestCase::TestSinrEff(const Ptr<MmWaveEesmErrorModel>& em)
+{
+    Bands bands;
+    for (uint32_t rb = 0; rb < 278; ++rb)
+    {
+        BandInfo band;
+        band.fl = rb;
+        band.fc = rb + 0.5;
+        band.fh = rb + 1;
+        bands.push_back(band);
+    }
+    Ptr<const SpectrumModel> model = Create<SpectrumModel>(bands);
+
+    uint32_t state = 12345;
+    for (double meanDb = -20; meanDb <= 60; meanDb += 2.5)
+    {
+        SpectrumValue sinr(model);
+        for (auto it = sinr.ValuesBegin(); it != sinr.ValuesEnd(); ++it)
+        {
+            state = state * 1103515245 + 12345;
+            *it = std::pow(10, (meanDb + ((state >> 8) % 2001) / 100.0 - 10) / 10);
+        }
+
+        // all the RBs, a single RB, and a map that is not a multiple of the kernel chunk
+        std::vector<std::vector<int>> maps(3);
+        for (int rb = 0; rb < 278; ++rb)
+        {
+            maps[0].push_back(rb);
+        }
+        maps[1].push_back(100);
+        for (int rb = 3; rb < 278; rb += 2)
+        {
+            maps[2].push_back(rb);
+        }
+
+        for (const auto& map : maps)
+        {
+            for (uint8_t mcs = 0; mcs <= em->GetMaxMcs(); ++mcs)
+            {
+                double beta = em->GetBetaTable()->at(mcs);
+                double sum = 0;
+                for (int rb : map)
+                {
+                    sum += std::exp(-sinr[rb] / beta);
+                }
+                double expected = -beta * std::log(sum / map.size());
+                double actual = em->SinrEff(sinr, map, mcs);
+                if (std::isinf(expected))
+                {
+                    NS_TEST_ASSERT_MSG_EQ(actual, expected, "Wrong SINR eff for MCS " << +mcs);
+                }
+                else
+                {
+                    NS_TEST_ASSERT_MSG_EQ_TOL(actual,
+                                              expected,
+                                              1e-12 * std::max(1.0, std::abs(expected)),
+                                              "Wrong SINR eff for MCS " << +mcs << " mean SINR "
+                                                                        << meanDb << " dB");
+                }
+            }
+        }
+    }
+}
+
 void
 MmWaveL2smEesmTestCase::TestEesmCcTable1()
 {
@@ -238,6 +396,8 @@ MmWaveL2smEesmTestCase::TestEesmCcTable1()
     // Test here the functions:
     TestBgType1(em);
     TestMappingSinrBler1(em);
+    TestLookupTables(em);
+    TestSinrEff(em);
 }
 
 void
@@ -253,6 +413,8 @@ MmWaveL2smEesmTestCase::TestEesmCcTable2()
     // Test here the functions:
     TestBgType2(em);
     TestMappingSinrBler2(em);
+    TestLookupTables(em);
+    TestSinrEff(em);
 }
 
 void
@@ -268,6 +430,8 @@ MmWaveL2smEesmTestCase::TestEesmIrTable1()
     // Test here the functions:
     TestBgType1(em);
     TestMappingSinrBler1(em);
+    TestLookupTables(em);
+    TestSinrEff(em);
 }
 
 void
@@ -283,6 +447,8 @@ MmWaveL2smEesmTestCase::TestEesmIrTable2()
     // Test here the functions:
     TestBgType2(em);
     TestMappingSinrBler2(em);
+    TestLookupTables(em);
+    TestSinrEff(em);
 }
 
 void
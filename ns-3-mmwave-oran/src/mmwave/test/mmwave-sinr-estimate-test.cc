@@ -0,0 +1,289 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/angles.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/isotropic-antenna-model.h"
+#include "ns3/mmwave-phy-mac-common.h"
+#include "ns3/mmwave-spectrum-value-helper.h"
+#include "ns3/worker-pool.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/three-gpp-channel-model.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/uinteger.h"
+#include "ns3/uniform-planar-array.h"
+
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-sinr-estimate-test.cc
+ * \ingroup test
+ *
+ * \brief Checks the parallel computation of the received PSDs of the periodic
+ * SINR estimate of MmWaveEnbPhy.
+ */
+
+/**
+ * \ingroup test
+ *
+ * \brief Checks that WorkerPool runs every task of each job exactly once
+ */
+class WorkerPoolTestCase : public TestCase
+{
+  public:
+    WorkerPoolTestCase()
+        : TestCase("Each task of a job is run once")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        for (uint32_t numThreads : {1, 2, 4})
+        {
+            WorkerPool pool(numThreads);
+            NS_TEST_ASSERT_MSG_EQ(pool.GetNumThreads(), numThreads, "Wrong number of threads");
+            for (uint32_t numTasks : {0, 1, 3, 64, 1000})
+            {
+                std::vector<uint32_t> runs(numTasks, 0);
+                std::vector<uint64_t> outputs(numTasks, 0);
+                for (uint32_t job = 0; job < 10; job++)
+                {
+                    pool.ParallelFor(numTasks, [&runs, &outputs, job](uint32_t i) {
+                        runs[i]++;
+                        outputs[i] += static_cast<uint64_t>(i) * i + job;
+                    });
+                }
+                for (uint32_t i = 0; i < numTasks; i++)
+                {
+                    NS_TEST_ASSERT_MSG_EQ(runs[i], 10, "Task " << i << " not run once per job");
+                    NS_TEST_ASSERT_MSG_EQ(outputs[i],
+                                          10 * static_cast<uint64_t>(i) * i + 45,
+                                          "Wrong output of task " << i);
+                }
+            }
+        }
+
+        std::shared_ptr<WorkerPool> pool = WorkerPool::GetShared(3);
+        NS_TEST_ASSERT_MSG_EQ((WorkerPool::GetShared(3) == pool),
+                              true,
+                              "Pools with the same number of threads not shared");
+        NS_TEST_ASSERT_MSG_EQ((WorkerPool::GetShared(2) != pool),
+                              true,
+                              "Pools with a different number of threads shared");
+    }
+};
+
+/**
+ * \ingroup test
+ *
+ * \brief Checks that the received PSDs computed in parallel from snapshots of
+ * the channels are equal, bit for bit, to the ones computed one after the
+ * other by ThreeGppSpectrumPropagationLossModel, with the eNB beam pointed
+ * to each UE in turn as in MmWaveEnbPhy::UpdateUeSinrEstimate
+ */
+class MmWaveParallelRxPsdTestCase : public TestCase
+{
+  public:
+    MmWaveParallelRxPsdTestCase()
+        : TestCase("Rx PSDs computed in parallel from snapshots")
+    {
+    }
+
+  private:
+    /**
+     * Create a node with a device, a mobility model and an antenna array
+     * \param position the position of the node
+     * \param velocity the velocity of the node
+     * \param rows the number of rows of the array
+     * \param columns the number of columns of the array
+     * \param antenna the antenna array, set by the function
+     * \return the mobility model of the node
+     */
+    static Ptr<MobilityModel> CreateNode(Vector position,
+                                         Vector velocity,
+                                         uint32_t rows,
+                                         uint32_t columns,
+                                         Ptr<PhasedArrayModel>& antenna)
+    {
+        Ptr<ConstantVelocityMobilityModel> mobility =
+            CreateObject<ConstantVelocityMobilityModel>();
+        mobility->SetPosition(position);
+        mobility->SetVelocity(velocity);
+        Ptr<Node> node = CreateObject<Node>();
+        node->AggregateObject(mobility);
+        Ptr<NetDevice> device = CreateObject<SimpleNetDevice>();
+        device->SetNode(node);
+        node->AddDevice(device);
+        antenna = CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumRows",
+            UintegerValue(rows),
+            "NumColumns",
+            UintegerValue(columns),
+            "AntennaElement",
+            PointerValue(CreateObject<IsotropicAntennaModel>()));
+        return mobility;
+    }
+
+    /**
+     * Point an antenna array towards a node
+     * \param antenna the antenna array
+     * \param thisMob the mobility model of the node of the array
+     * \param otherMob the mobility model of the other node
+     */
+    static void PointBeam(Ptr<PhasedArrayModel> antenna,
+                          Ptr<MobilityModel> thisMob,
+                          Ptr<MobilityModel> otherMob)
+    {
+        Angles angles(otherMob->GetPosition(), thisMob->GetPosition());
+        antenna->SetBeamformingVector(antenna->GetBeamformingVector(angles));
+    }
+
+    /**
+     * Compute the rx PSDs of the UEs at the current time and compare them
+     * \param splm the spectrum propagation loss model
+     * \param pool the pool
+     */
+    void Check(Ptr<ThreeGppSpectrumPropagationLossModel> splm, WorkerPool* pool)
+    {
+        Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters>();
+        txParams->psd = m_txPsd;
+
+        std::vector<Ptr<SpectrumValue>> expected;
+        std::vector<ThreeGppSpectrumPropagationLossModel::RxPsdSnapshot> snapshots(
+            m_ueMobs.size());
+        std::vector<Ptr<SpectrumValue>> rxPsds;
+        for (uint32_t i = 0; i < m_ueMobs.size(); i++)
+        {
+            PointBeam(m_enbAntenna, m_enbMob, m_ueMobs[i]);
+            PointBeam(m_ueAntennas[i], m_ueMobs[i], m_enbMob);
+            expected.push_back(splm->DoCalcRxPowerSpectralDensity(txParams,
+                                                                  m_ueMobs[i],
+                                                                  m_enbMob,
+                                                                  m_ueAntennas[i],
+                                                                  m_enbAntenna));
+            splm->GetRxPsdSnapshot(m_ueMobs[i],
+                                   m_enbMob,
+                                   m_ueAntennas[i],
+                                   m_enbAntenna,
+                                   snapshots[i]);
+            rxPsds.push_back(m_txPsd->Copy());
+        }
+
+        // the beams are moved before the rx PSDs are computed
+        PointBeam(m_enbAntenna, m_enbMob, m_ueMobs[0]);
+        pool->ParallelFor(m_ueMobs.size(), [&snapshots, &rxPsds](uint32_t i) {
+            ThreeGppSpectrumPropagationLossModel::CalcRxPowerSpectralDensityFromSnapshot(
+                snapshots[i],
+                *rxPsds[i]);
+        });
+
+        for (uint32_t i = 0; i < m_ueMobs.size(); i++)
+        {
+            for (uint32_t b = 0; b < m_txPsd->GetValuesN(); b++)
+            {
+                NS_TEST_ASSERT_MSG_EQ((*rxPsds[i])[b],
+                                      (*expected[i])[b],
+                                      "Different rx PSD for UE " << i << " on RB " << b);
+            }
+        }
+        m_numChecks++;
+    }
+
+    void DoRun() override
+    {
+        Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+        Ptr<ThreeGppSpectrumPropagationLossModel> splm =
+            CreateObject<ThreeGppSpectrumPropagationLossModel>();
+        splm->SetChannelModel(channelModel);
+        splm->SetChannelModelAttribute("Frequency", DoubleValue(28e9));
+        splm->SetChannelModelAttribute("Scenario", StringValue("UMa"));
+        splm->SetChannelModelAttribute(
+            "ChannelConditionModel",
+            PointerValue(CreateObject<ThreeGppUmaChannelConditionModel>()));
+        splm->SetChannelModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(10)));
+
+        m_enbMob = CreateNode(Vector(0, 0, 25), Vector(0, 0, 0), 8, 8, m_enbAntenna);
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            Ptr<PhasedArrayModel> antenna;
+            m_ueMobs.push_back(CreateNode(Vector(20 + 10 * i, 15.0 * (i % 5) - 30, 1.5),
+                                          Vector(i % 3, 1, 0),
+                                          4,
+                                          4,
+                                          antenna));
+            m_ueAntennas.push_back(antenna);
+        }
+
+        Ptr<MmWavePhyMacCommon> phyMacConfig = CreateObject<MmWavePhyMacCommon>();
+        std::vector<int> rbs;
+        for (uint32_t i = 0; i < phyMacConfig->GetNumRb(); i++)
+        {
+            rbs.push_back(i);
+        }
+        m_txPsd = MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity(phyMacConfig, 23, rbs);
+
+        // the channels are updated between the checks
+        WorkerPool pool(4);
+        for (uint32_t t = 0; t < 3; t++)
+        {
+            Simulator::Schedule(MilliSeconds(1 + 15 * t),
+                                &MmWaveParallelRxPsdTestCase::Check,
+                                this,
+                                splm,
+                                &pool);
+        }
+        Simulator::Run();
+        Simulator::Destroy();
+        NS_TEST_ASSERT_MSG_EQ(m_numChecks, 3, "Missing checks");
+    }
+
+    Ptr<MobilityModel> m_enbMob;                     //!< the mobility model of the eNB
+    Ptr<PhasedArrayModel> m_enbAntenna;              //!< the antenna array of the eNB
+    std::vector<Ptr<MobilityModel>> m_ueMobs;        //!< the mobility models of the UEs
+    std::vector<Ptr<PhasedArrayModel>> m_ueAntennas; //!< the antenna arrays of the UEs
+    Ptr<SpectrumValue> m_txPsd;                      //!< the tx PSD
+    uint32_t m_numChecks{0};                         //!< number of checks done
+};
+
+/**
+ * \ingroup test
+ *
+ * \brief Parallel SINR estimate test suite
+ */
+class MmWaveSinrEstimateTestSuite : public TestSuite
+{
+  public:
+    MmWaveSinrEstimateTestSuite()
+        : TestSuite("mmwave-sinr-estimate", UNIT)
+    {
+        AddTestCase(new WorkerPoolTestCase, TestCase::QUICK);
+        AddTestCase(new MmWaveParallelRxPsdTestCase, TestCase::QUICK);
+    }
+};
+
+static MmWaveSinrEstimateTestSuite g_mmwaveSinrEstimateTestSuite; //!< the test suite
@@ -21,6 +21,7 @@
 
 #include "three-gpp-channel-model.h"
 
+#include "ns3/abort.h"
 #include "ns3/double.h"
 #include "ns3/integer.h"
 #include "ns3/log.h"
@@ -29,6 +30,8 @@
 #include "ns3/phased-array-model.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "worker-pool.h"
 #include <ns3/simulator.h>
 
 #include <algorithm>
@@ -244,9 +247,9 @@ static const double sqrtC_office_NLOS[6][6] = {
     {0, -0.069282, 0.295397, 0.430696, 0.468462, 0.709214},
 };
 
-ThreeGppChannelModel::ThreeGppChannelModel()
+void
+ThreeGppChannelModel::RandomVariables::Create(int64_t stream)
 {
-    NS_LOG_FUNCTION(this);
     m_uniformRv = CreateObject<UniformRandomVariable>();
     m_uniformRvShuffle = CreateObject<UniformRandomVariable>();
     m_uniformRvDoppler = CreateObject<UniformRandomVariable>();
@@ -254,6 +257,29 @@ ThreeGppChannelModel::ThreeGppChannelModel()
     m_normalRv = CreateObject<NormalRandomVariable>();
     m_normalRv->SetAttribute("Mean", DoubleValue(0.0));
     m_normalRv->SetAttribute("Variance", DoubleValue(1.0));
+
+    if (stream >= 0)
+    {
+        m_normalRv->SetStream(stream);
+        m_uniformRv->SetStream(stream + 1);
+        m_uniformRvShuffle->SetStream(stream + 2);
+        m_uniformRvDoppler->SetStream(stream + 3);
+    }
+}
+
+ThreeGppChannelModel::NodePairState
+ThreeGppChannelModel::NodePairState::Reverse() const
+{
+    NodePairState reverse = *this;
+    std::swap(reverse.m_aId, reverse.m_bId);
+    std::swap(reverse.m_aPosition, reverse.m_bPosition);
+    return reverse;
+}
+
+ThreeGppChannelModel::ThreeGppChannelModel()
+{
+    NS_LOG_FUNCTION(this);
+    m_rv.Create();
 }
 
 ThreeGppChannelModel::~ThreeGppChannelModel()
@@ -273,6 +299,10 @@ ThreeGppChannelModel::DoDispose()
 
     m_channelParamsMap.clear();
     m_channelConditionModel = nullptr;
+    m_prefetchEvent.Cancel();
+    m_prefetchPairs.clear();
+    m_prefetchPool = nullptr;
+    m_prefetchPending = false;
 }
 
 TypeId
@@ -336,6 +366,27 @@ ThreeGppChannelModel::GetTypeId()
                           DoubleValue(0.0),
                           MakeDoubleAccessor(&ThreeGppChannelModel::m_vScatt),
                           MakeDoubleChecker<double>(0.0))
+            // attributes for the prefetch of the channels
+            .AddAttribute("PrefetchThreads",
+                          "If not 0, the channels of all the pairs of nodes and antennas used "
+                          "since the previous update are generated again at each UpdatePeriod, "
+                          "with this number of threads, instead of when they are used",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::m_prefetchThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("PrefetchLead",
+                          "How long before each update the channels are generated, with "
+                          "PrefetchThreads. It must be less than UpdatePeriod",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&ThreeGppChannelModel::m_prefetchLead),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("PrefetchStream",
+                          "With PrefetchThreads, the random variables of the pair of nodes "
+                          "first used i-th are assigned the four streams from "
+                          "PrefetchStream + 4 i. If -1, they are assigned automatically",
+                          IntegerValue(-1),
+                          MakeIntegerAccessor(&ThreeGppChannelModel::m_prefetchStream),
+                          MakeIntegerChecker<int64_t>(-1))
 
         ;
     return tid;
@@ -1077,6 +1128,15 @@ ThreeGppChannelModel::ChannelParamsNeedsUpdate(Ptr<const ThreeGppChannelParams>
         update = true;
     }
 
+    // with prefetch, the channel is also updated if it was generated before the last update
+    if (m_prefetchThreads > 0 && channelParams->m_generatedTime < m_lastUpdateTime)
+    {
+        NS_LOG_DEBUG("Generation time " << channelParams->m_generatedTime.As(Time::NS)
+                                        << " last update "
+                                        << m_lastUpdateTime.As(Time::NS));
+        update = true;
+    }
+
     return update;
 }
 
@@ -1108,6 +1168,11 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
     // Compute the channel matrix key. The key is reciprocal, i.e., key (a, b) = key (b, a)
     uint64_t channelMatrixKey = GetKey(aAntenna->GetId(), bAntenna->GetId());
 
+    // with prefetch, the pair is generated again at the next update, with its own
+    // random variables
+    const RandomVariables& rv =
+        m_prefetchThreads > 0 ? RegisterPrefetchPair(aMob, bMob, aAntenna, bAntenna) : m_rv;
+
     // retrieve the channel condition
     Ptr<const ChannelCondition> condition =
         m_channelConditionModel->GetChannelCondition(aMob, bMob);
@@ -1133,17 +1198,9 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
         notFoundParams = true;
     }
 
-    double x = aMob->GetPosition().x - bMob->GetPosition().x;
-    double y = aMob->GetPosition().y - bMob->GetPosition().y;
-    double distance2D = sqrt(x * x + y * y);
-
-    // NOTE we assume hUT = min (height(a), height(b)) and
-    // hBS = max (height (a), height (b))
-    double hUt = std::min(aMob->GetPosition().z, bMob->GetPosition().z);
-    double hBs = std::max(aMob->GetPosition().z, bMob->GetPosition().z);
-
     // get the 3GPP parameters
-    Ptr<const ParamsTable> table3gpp = GetThreeGppTable(condition, hBs, hUt, distance2D);
+    NodePairState nodes = GetNodePairState(aMob, bMob, Seconds(0));
+    Ptr<const ParamsTable> table3gpp = GetNodePairTable(condition, nodes);
 
     if (notFoundParams || updateParams)
     {
@@ -1155,9 +1212,17 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
         // shuffle all the arrays to perform random coupling
         // Step 9: Generate the cross polarization power ratios
         // Step 10: Draw initial phases
-        channelParams = GenerateChannelParameters(condition, table3gpp, aMob, bMob);
+        channelParams = GenerateChannelParameters(condition, table3gpp, nodes, rv);
         // store or replace the channel parameters
         m_channelParamsMap[channelParamsKey] = channelParams;
+
+        // a channel of the pair prefetched for the next update would replace this one
+        // generated later, so it is discarded
+        auto prefetchIt = m_prefetchPairs.find(channelParamsKey);
+        if (prefetchIt != m_prefetchPairs.end())
+        {
+            prefetchIt->second.m_channelParams = nullptr;
+        }
     }
 
     if (m_channelMatrixMap.find(channelMatrixKey) != m_channelMatrixMap.end())
@@ -1178,7 +1243,7 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
     if (notFoundMatrix || updateMatrix)
     {
         // channel matrix not found or has to be updated, generate a new one
-        channelMatrix = GetNewChannel(channelParams, table3gpp, aMob, bMob, aAntenna, bAntenna);
+        channelMatrix = GetNewChannel(channelParams, table3gpp, nodes, aAntenna, bAntenna);
 
         channelMatrix->m_antennaPair =
             std::make_pair(aAntenna->GetId(),
@@ -1212,18 +1277,217 @@ ThreeGppChannelModel::GetParams(Ptr<const MobilityModel> aMob, Ptr<const Mobilit
     }
 }
 
+Ptr<const ThreeGppChannelModel::ParamsTable>
+ThreeGppChannelModel::GetNodePairTable(Ptr<const ChannelCondition> channelCondition,
+                                       const NodePairState& nodes) const
+{
+    double x = nodes.m_aPosition.x - nodes.m_bPosition.x;
+    double y = nodes.m_aPosition.y - nodes.m_bPosition.y;
+    double distance2D = sqrt(x * x + y * y);
+
+    // NOTE we assume hUT = min (height(a), height(b)) and
+    // hBS = max (height (a), height (b))
+    double hUt = std::min(nodes.m_aPosition.z, nodes.m_bPosition.z);
+    double hBs = std::max(nodes.m_aPosition.z, nodes.m_bPosition.z);
+
+    return GetThreeGppTable(channelCondition, hBs, hUt, distance2D);
+}
+
+ThreeGppChannelModel::NodePairState
+ThreeGppChannelModel::GetNodePairState(Ptr<const MobilityModel> aMob,
+                                       Ptr<const MobilityModel> bMob,
+                                       Time lead)
+{
+    NodePairState nodes;
+    nodes.m_aId = aMob->GetObject<Node>()->GetId();
+    nodes.m_bId = bMob->GetObject<Node>()->GetId();
+    nodes.m_aPosition = aMob->GetPosition();
+    nodes.m_bPosition = bMob->GetPosition();
+    nodes.m_generatedTime = Simulator::Now() + lead;
+    if (!lead.IsZero())
+    {
+        double t = lead.GetSeconds();
+        Vector aVelocity = aMob->GetVelocity();
+        Vector bVelocity = bMob->GetVelocity();
+        nodes.m_aPosition =
+            nodes.m_aPosition + Vector(aVelocity.x * t, aVelocity.y * t, aVelocity.z * t);
+        nodes.m_bPosition =
+            nodes.m_bPosition + Vector(bVelocity.x * t, bVelocity.y * t, bVelocity.z * t);
+    }
+    return nodes;
+}
+
+const ThreeGppChannelModel::RandomVariables&
+ThreeGppChannelModel::RegisterPrefetchPair(Ptr<const MobilityModel> aMob,
+                                           Ptr<const MobilityModel> bMob,
+                                           Ptr<const PhasedArrayModel> aAntenna,
+                                           Ptr<const PhasedArrayModel> bAntenna)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_updatePeriod <= m_prefetchLead,
+                    "The prefetch needs an UpdatePeriod longer than PrefetchLead");
+
+    uint32_t aId = aMob->GetObject<Node>()->GetId();
+    uint32_t bId = bMob->GetObject<Node>()->GetId();
+    auto [it, newPair] = m_prefetchPairs.try_emplace(GetKey(aId, bId));
+    PrefetchNodePair& pair = it->second;
+    if (newPair)
+    {
+        // the streams of the random variables follow the order in which the pairs
+        // are first used, so they do not depend on the threads
+        NS_LOG_DEBUG("New prefetch pair " << aId << " " << bId);
+        pair.m_aMob = aMob;
+        pair.m_bMob = bMob;
+        pair.m_rv.Create(m_prefetchStream < 0
+                             ? -1
+                             : m_prefetchStream + 4 * static_cast<int64_t>(m_prefetchNumPairs));
+        m_prefetchNumPairs++;
+    }
+    pair.m_used = true;
+
+    uint64_t channelMatrixKey = GetKey(aAntenna->GetId(), bAntenna->GetId());
+    if (pair.m_antennaPairs.find(channelMatrixKey) == pair.m_antennaPairs.end())
+    {
+        PrefetchAntennaPair& antennaPair = pair.m_antennaPairs[channelMatrixKey];
+        antennaPair.m_key = channelMatrixKey;
+        antennaPair.m_aAntenna = aAntenna;
+        antennaPair.m_bAntenna = bAntenna;
+        antennaPair.m_reverse = (pair.m_aMob != aMob);
+    }
+
+    if (!m_prefetchEvent.IsRunning())
+    {
+        if (!m_prefetchPool && m_prefetchThreads > 1)
+        {
+            m_prefetchPool = WorkerPool::GetShared(m_prefetchThreads);
+        }
+        m_prefetchUpdateTime = Simulator::Now() + m_updatePeriod;
+        m_prefetchEvent = Simulator::Schedule(m_updatePeriod - m_prefetchLead,
+                                              &ThreeGppChannelModel::PrefetchChannels,
+                                              this);
+    }
+    return pair.m_rv;
+}
+
+void
+ThreeGppChannelModel::PrefetchChannels()
+{
+    NS_LOG_FUNCTION(this);
+    Time lead = m_prefetchUpdateTime - Simulator::Now();
+
+    // the inputs depending on the simulator are taken here, and the generation
+    // of each pair of nodes only writes to its own outputs
+    std::vector<PrefetchNodePair*> pairs;
+    for (auto it = m_prefetchPairs.begin(); it != m_prefetchPairs.end();)
+    {
+        PrefetchNodePair& pair = it->second;
+        if (!pair.m_used)
+        {
+            NS_LOG_DEBUG("Prefetch pair " << it->first << " not used since the previous update");
+            it = m_prefetchPairs.erase(it);
+            continue;
+        }
+        pair.m_used = false;
+        pair.m_condition = m_channelConditionModel->GetChannelCondition(pair.m_aMob, pair.m_bMob);
+        pair.m_state = GetNodePairState(pair.m_aMob, pair.m_bMob, lead);
+        pair.m_table3gpp = GetNodePairTable(pair.m_condition, pair.m_state);
+        pairs.push_back(&pair);
+        ++it;
+    }
+    if (pairs.empty())
+    {
+        // the next pair used schedules the next update
+        return;
+    }
+
+    auto generate = [this, &pairs](uint32_t i) {
+        PrefetchNodePair& pair = *pairs[i];
+        pair.m_channelParams =
+            GenerateChannelParameters(pair.m_condition, pair.m_table3gpp, pair.m_state, pair.m_rv);
+        NodePairState reverse = pair.m_state.Reverse();
+        for (auto& [key, antennaPair] : pair.m_antennaPairs)
+        {
+            const NodePairState& nodes = antennaPair.m_reverse ? reverse : pair.m_state;
+            antennaPair.m_channelMatrix = GetNewChannel(pair.m_channelParams,
+                                                       pair.m_table3gpp,
+                                                       nodes,
+                                                       antennaPair.m_aAntenna,
+                                                       antennaPair.m_bAntenna);
+            antennaPair.m_channelMatrix->m_antennaPair =
+                std::make_pair(antennaPair.m_aAntenna->GetId(), antennaPair.m_bAntenna->GetId());
+        }
+    };
+    // the logs are not thread safe
+    if (m_prefetchPool && g_log.IsNoneEnabled())
+    {
+        m_prefetchPool->ParallelFor(pairs.size(), generate);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < pairs.size(); i++)
+        {
+            generate(i);
+        }
+    }
+    NS_LOG_DEBUG("Prefetched " << pairs.size() << " pairs for "
+                               << m_prefetchUpdateTime.As(Time::MS));
+
+    m_prefetchPending = true;
+    if (lead.IsZero())
+    {
+        CommitPrefetchedChannels();
+    }
+    else
+    {
+        m_prefetchEvent =
+            Simulator::Schedule(lead, &ThreeGppChannelModel::CommitPrefetchedChannels, this);
+    }
+}
+
+void
+ThreeGppChannelModel::CommitPrefetchedChannels()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& [key, pair] : m_prefetchPairs)
+    {
+        // the channels are missing if the pair was added after the generation, or
+        // if they were discarded
+        if (pair.m_channelParams)
+        {
+            m_channelParamsMap[key] = pair.m_channelParams;
+        }
+        for (auto& [matrixKey, antennaPair] : pair.m_antennaPairs)
+        {
+            if (pair.m_channelParams && antennaPair.m_channelMatrix)
+            {
+                m_channelMatrixMap[matrixKey] = antennaPair.m_channelMatrix;
+            }
+            antennaPair.m_channelMatrix = nullptr;
+        }
+        pair.m_condition = nullptr;
+        pair.m_table3gpp = nullptr;
+        pair.m_channelParams = nullptr;
+    }
+    m_prefetchPending = false;
+    m_lastUpdateTime = m_prefetchUpdateTime;
+
+    m_prefetchUpdateTime += m_updatePeriod;
+    m_prefetchEvent = Simulator::Schedule(m_prefetchUpdateTime - m_prefetchLead - Simulator::Now(),
+                                          &ThreeGppChannelModel::PrefetchChannels,
+                                          this);
+}
+
 Ptr<ThreeGppChannelModel::ThreeGppChannelParams>
-ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition> channelCondition,
-                                                const Ptr<const ParamsTable> table3gpp,
-                                                const Ptr<const MobilityModel> aMob,
-                                                const Ptr<const MobilityModel> bMob) const
+ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition>& channelCondition,
+                                                const Ptr<const ParamsTable>& table3gpp,
+                                                const NodePairState& nodes,
+                                                const RandomVariables& rv) const
 {
     NS_LOG_FUNCTION(this);
     // create a channel matrix instance
     Ptr<ThreeGppChannelParams> channelParams = Create<ThreeGppChannelParams>();
-    channelParams->m_generatedTime = Simulator::Now();
-    channelParams->m_nodeIds =
-        std::make_pair(aMob->GetObject<Node>()->GetId(), bMob->GetObject<Node>()->GetId());
+    channelParams->m_generatedTime = nodes.m_generatedTime;
+    channelParams->m_nodeIds = std::make_pair(nodes.m_aId, nodes.m_bId);
     channelParams->m_losCondition = channelCondition->GetLosCondition();
     channelParams->m_o2iCondition = channelCondition->GetO2iCondition();
 
@@ -1239,7 +1503,7 @@ ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition
     // Generate paramNum independent LSPs.
     for (uint8_t iter = 0; iter < paramNum; iter++)
     {
-        LSPsIndep.push_back(m_normalRv->GetValue());
+        LSPsIndep.push_back(rv.m_normalRv->GetValue());
     }
     for (uint8_t row = 0; row < paramNum; row++)
     {
@@ -1292,7 +1556,7 @@ ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition
     double minTau = 100.0;
     for (uint8_t cIndex = 0; cIndex < table3gpp->m_numOfCluster; cIndex++)
     {
-        double tau = -1 * table3gpp->m_rTau * DS * log(m_uniformRv->GetValue(0, 1)); //(7.5-1)
+        double tau = -1 * table3gpp->m_rTau * DS * log(rv.m_uniformRv->GetValue(0, 1)); //(7.5-1)
         if (minTau > tau)
         {
             minTau = tau;
@@ -1317,7 +1581,8 @@ ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition
         double power =
             exp(-1 * clusterDelay[cIndex] * (table3gpp->m_rTau - 1) / table3gpp->m_rTau / DS) *
             pow(10,
-                -1 * m_normalRv->GetValue() * table3gpp->m_perClusterShadowingStd / 10.0); //(7.5-5)
+                -1 * rv.m_normalRv->GetValue() * table3gpp->m_perClusterShadowingStd /
+                    10.0); //(7.5-5)
         powerSum += power;
         clusterPower.push_back(power);
     }
@@ -1495,31 +1760,31 @@ ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition
         clusterZod.push_back(ZSD * angle);
     }
 
-    Angles sAngle(bMob->GetPosition(), aMob->GetPosition());
-    Angles uAngle(aMob->GetPosition(), bMob->GetPosition());
+    Angles sAngle(nodes.m_bPosition, nodes.m_aPosition);
+    Angles uAngle(nodes.m_aPosition, nodes.m_bPosition);
 
     for (uint8_t cIndex = 0; cIndex < channelParams->m_reducedClusterNumber; cIndex++)
     {
         int Xn = 1;
-        if (m_uniformRv->GetValue(0, 1) < 0.5)
+        if (rv.m_uniformRv->GetValue(0, 1) < 0.5)
         {
             Xn = -1;
         }
-        clusterAoa[cIndex] = clusterAoa[cIndex] * Xn + (m_normalRv->GetValue() * ASA / 7.0) +
+        clusterAoa[cIndex] = clusterAoa[cIndex] * Xn + (rv.m_normalRv->GetValue() * ASA / 7.0) +
                              RadiansToDegrees(uAngle.GetAzimuth()); //(7.5-11)
-        clusterAod[cIndex] = clusterAod[cIndex] * Xn + (m_normalRv->GetValue() * ASD / 7.0) +
+        clusterAod[cIndex] = clusterAod[cIndex] * Xn + (rv.m_normalRv->GetValue() * ASD / 7.0) +
                              RadiansToDegrees(sAngle.GetAzimuth());
         if (channelCondition->IsO2i())
         {
             clusterZoa[cIndex] =
-                clusterZoa[cIndex] * Xn + (m_normalRv->GetValue() * ZSA / 7.0) + 90; //(7.5-16)
+                clusterZoa[cIndex] * Xn + (rv.m_normalRv->GetValue() * ZSA / 7.0) + 90; //(7.5-16)
         }
         else
         {
-            clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (m_normalRv->GetValue() * ZSA / 7.0) +
+            clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (rv.m_normalRv->GetValue() * ZSA / 7.0) +
                                  RadiansToDegrees(uAngle.GetInclination()); //(7.5-16)
         }
-        clusterZod[cIndex] = clusterZod[cIndex] * Xn + (m_normalRv->GetValue() * ZSD / 7.0) +
+        clusterZod[cIndex] = clusterZod[cIndex] * Xn + (rv.m_normalRv->GetValue() * ZSD / 7.0) +
                              RadiansToDegrees(sAngle.GetInclination()) +
                              table3gpp->m_offsetZOD; //(7.5-19)
     }
@@ -1605,7 +1870,7 @@ ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition
     DoubleVector attenuationDb;
     if (m_blockage)
     {
-        attenuationDb = CalcAttenuationOfBlockage(channelParams, clusterAoa, clusterZoa);
+        attenuationDb = CalcAttenuationOfBlockage(channelParams, clusterAoa, clusterZoa, rv);
         for (uint8_t cInd = 0; cInd < channelParams->m_reducedClusterNumber; cInd++)
         {
             channelParams->m_clusterPower[cInd] =
@@ -1658,48 +1923,56 @@ ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition
 
     for (uint8_t cIndex = 0; cIndex < channelParams->m_reducedClusterNumber; cIndex++)
     {
-        Shuffle(&rayAodRadian[cIndex][0], &rayAodRadian[cIndex][table3gpp->m_raysPerCluster]);
-        Shuffle(&rayAoaRadian[cIndex][0], &rayAoaRadian[cIndex][table3gpp->m_raysPerCluster]);
-        Shuffle(&rayZodRadian[cIndex][0], &rayZodRadian[cIndex][table3gpp->m_raysPerCluster]);
-        Shuffle(&rayZoaRadian[cIndex][0], &rayZoaRadian[cIndex][table3gpp->m_raysPerCluster]);
+        Shuffle(&rayAodRadian[cIndex][0],
+                &rayAodRadian[cIndex][table3gpp->m_raysPerCluster],
+                rv.m_uniformRvShuffle);
+        Shuffle(&rayAoaRadian[cIndex][0],
+                &rayAoaRadian[cIndex][table3gpp->m_raysPerCluster],
+                rv.m_uniformRvShuffle);
+        Shuffle(&rayZodRadian[cIndex][0],
+                &rayZodRadian[cIndex][table3gpp->m_raysPerCluster],
+                rv.m_uniformRvShuffle);
+        Shuffle(&rayZoaRadian[cIndex][0],
+                &rayZoaRadian[cIndex][table3gpp->m_raysPerCluster],
+                rv.m_uniformRvShuffle);
     }
 
     // store values
-    channelParams->m_rayAodRadian = rayAodRadian;
-    channelParams->m_rayAoaRadian = rayAoaRadian;
-    channelParams->m_rayZodRadian = rayZodRadian;
-    channelParams->m_rayZoaRadian = rayZoaRadian;
+    channelParams->m_rayAodRadian = std::move(rayAodRadian);
+    channelParams->m_rayAoaRadian = std::move(rayAoaRadian);
+    channelParams->m_rayZodRadian = std::move(rayZodRadian);
+    channelParams->m_rayZoaRadian = std::move(rayZoaRadian);
 
     // Step 9: Generate the cross polarization power ratios
     // Step 10: Draw initial phases
     Double2DVector crossPolarizationPowerRatios; // vector containing the cross polarization power
                                                  // ratios, as defined by 7.5-21
-    Double3DVector clusterPhase; // rayAoaRadian[n][m], where n is cluster index, m is ray index
+    Double2DVector clusterPhase; // clusterPhase[n][4 * m + p], where n is cluster index, m is ray
+                                 // index and p the index of the combination of polarizations
     for (uint8_t nInd = 0; nInd < channelParams->m_reducedClusterNumber; nInd++)
     {
-        DoubleVector temp; // used to store the XPR values
-        Double2DVector
-            temp2; // used to store the PHI values for all the possible combination of polarization
+        DoubleVector temp;  // used to store the XPR values
+        DoubleVector temp2; // used to store the PHI values for all the possible combination of
+                            // polarization, for all the rays
+        temp2.reserve(4 * table3gpp->m_raysPerCluster);
         for (uint8_t mInd = 0; mInd < table3gpp->m_raysPerCluster; mInd++)
         {
             double uXprLinear = pow(10, table3gpp->m_uXpr / 10.0);     // convert to linear
             double sigXprLinear = pow(10, table3gpp->m_sigXpr / 10.0); // convert to linear
 
             temp.push_back(
-                std::pow(10, (m_normalRv->GetValue() * sigXprLinear + uXprLinear) / 10.0));
-            DoubleVector temp3; // used to store the PHI values
+                std::pow(10, (rv.m_normalRv->GetValue() * sigXprLinear + uXprLinear) / 10.0));
             for (uint8_t pInd = 0; pInd < 4; pInd++)
             {
-                temp3.push_back(m_uniformRv->GetValue(-1 * M_PI, M_PI));
+                temp2.push_back(rv.m_uniformRv->GetValue(-1 * M_PI, M_PI));
             }
-            temp2.push_back(temp3);
         }
         crossPolarizationPowerRatios.push_back(temp);
         clusterPhase.push_back(temp2);
     }
     // store the cluster phase
-    channelParams->m_clusterPhase = clusterPhase;
-    channelParams->m_crossPolarizationPowerRatios = crossPolarizationPowerRatios;
+    channelParams->m_clusterPhase = std::move(clusterPhase);
+    channelParams->m_crossPolarizationPowerRatios = std::move(crossPolarizationPowerRatios);
 
     uint8_t cluster1st = 0;
     uint8_t cluster2nd = 0; // first and second strongest cluster;
@@ -1818,8 +2091,8 @@ ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition
         double D = 0;
         if (cIndex != 0)
         {
-            alpha = m_uniformRvDoppler->GetValue(-1, 1);
-            D = m_uniformRvDoppler->GetValue(-m_vScatt, m_vScatt);
+            alpha = rv.m_uniformRvDoppler->GetValue(-1, 1);
+            D = rv.m_uniformRvDoppler->GetValue(-m_vScatt, m_vScatt);
         }
         dopplerTermAlpha.push_back(alpha);
         dopplerTermD.push_back(D);
@@ -1831,12 +2104,11 @@ ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition
 }
 
 Ptr<MatrixBasedChannelModel::ChannelMatrix>
-ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelParams,
-                                    Ptr<const ParamsTable> table3gpp,
-                                    const Ptr<const MobilityModel> sMob,
-                                    const Ptr<const MobilityModel> uMob,
-                                    Ptr<const PhasedArrayModel> sAntenna,
-                                    Ptr<const PhasedArrayModel> uAntenna) const
+ThreeGppChannelModel::GetNewChannel(const Ptr<const ThreeGppChannelParams>& channelParams,
+                                    const Ptr<const ParamsTable>& table3gpp,
+                                    const NodePairState& nodes,
+                                    const Ptr<const PhasedArrayModel>& sAntenna,
+                                    const Ptr<const PhasedArrayModel>& uAntenna) const
 {
     NS_LOG_FUNCTION(this);
 
@@ -1844,36 +2116,24 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
 
     // create a channel matrix instance
     Ptr<ChannelMatrix> channelMatrix = Create<ChannelMatrix>();
-    channelMatrix->m_generatedTime = Simulator::Now();
+    channelMatrix->m_generatedTime = nodes.m_generatedTime;
     // save in which order is generated this matrix
-    channelMatrix->m_nodeIds =
-        std::make_pair(sMob->GetObject<Node>()->GetId(), uMob->GetObject<Node>()->GetId());
+    channelMatrix->m_nodeIds = std::make_pair(nodes.m_aId, nodes.m_bId);
     // check if channelParams structure is generated in direction s-to-u or u-to-s
     bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-    MatrixBasedChannelModel::Double2DVector rayAodRadian;
-    MatrixBasedChannelModel::Double2DVector rayAoaRadian;
-    MatrixBasedChannelModel::Double2DVector rayZodRadian;
-    MatrixBasedChannelModel::Double2DVector rayZoaRadian;
-
     // if channel params is generated in the same direction in which we
     // generate the channel matrix, angles and zenith od departure and arrival are ok,
-    // just set them to corresponding variable that will be used for the generation
+    // just refer to them with the corresponding variable that will be used for the generation
     // of channel matrix, otherwise we need to flip angles and zeniths of departure and arrival
-    if (isSameDirection)
-    {
-        rayAodRadian = channelParams->m_rayAodRadian;
-        rayAoaRadian = channelParams->m_rayAoaRadian;
-        rayZodRadian = channelParams->m_rayZodRadian;
-        rayZoaRadian = channelParams->m_rayZoaRadian;
-    }
-    else
-    {
-        rayAodRadian = channelParams->m_rayAoaRadian;
-        rayAoaRadian = channelParams->m_rayAodRadian;
-        rayZodRadian = channelParams->m_rayZoaRadian;
-        rayZoaRadian = channelParams->m_rayZodRadian;
-    }
+    const Double2DVector& rayAodRadian =
+        isSameDirection ? channelParams->m_rayAodRadian : channelParams->m_rayAoaRadian;
+    const Double2DVector& rayAoaRadian =
+        isSameDirection ? channelParams->m_rayAoaRadian : channelParams->m_rayAodRadian;
+    const Double2DVector& rayZodRadian =
+        isSameDirection ? channelParams->m_rayZodRadian : channelParams->m_rayZoaRadian;
+    const Double2DVector& rayZoaRadian =
+        isSameDirection ? channelParams->m_rayZoaRadian : channelParams->m_rayZodRadian;
 
     // Step 11: Generate channel coefficients for each cluster n and each receiver
     //  and transmitter element pair u,s.
@@ -1897,7 +2157,7 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
     NS_ASSERT(channelParams->m_reducedClusterNumber <= rayZodRadian.size());
     NS_ASSERT(channelParams->m_reducedClusterNumber <= rayAoaRadian.size());
     NS_ASSERT(channelParams->m_reducedClusterNumber <= rayAodRadian.size());
-    NS_ASSERT(table3gpp->m_raysPerCluster <= channelParams->m_clusterPhase[0].size());
+    NS_ASSERT(4 * table3gpp->m_raysPerCluster <= channelParams->m_clusterPhase[0].size());
     NS_ASSERT(table3gpp->m_raysPerCluster <=
               channelParams->m_crossPolarizationPowerRatios[0].size());
     NS_ASSERT(table3gpp->m_raysPerCluster <= rayZoaRadian[0].size());
@@ -1905,52 +2165,49 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
     NS_ASSERT(table3gpp->m_raysPerCluster <= rayAoaRadian[0].size());
     NS_ASSERT(table3gpp->m_raysPerCluster <= rayAodRadian[0].size());
 
-    double x = sMob->GetPosition().x - uMob->GetPosition().x;
-    double y = sMob->GetPosition().y - uMob->GetPosition().y;
+    double x = nodes.m_aPosition.x - nodes.m_bPosition.x;
+    double y = nodes.m_aPosition.y - nodes.m_bPosition.y;
     double distance2D = sqrt(x * x + y * y);
     // NOTE we assume hUT = min (height(a), height(b)) and
     // hBS = max (height (a), height (b))
-    double hUt = std::min(sMob->GetPosition().z, uMob->GetPosition().z);
-    double hBs = std::max(sMob->GetPosition().z, uMob->GetPosition().z);
+    double hUt = std::min(nodes.m_aPosition.z, nodes.m_bPosition.z);
+    double hBs = std::max(nodes.m_aPosition.z, nodes.m_bPosition.z);
     // compute the 3D distance using eq. 7.4-1
     double distance3D = std::sqrt(distance2D * distance2D + (hBs - hUt) * (hBs - hUt));
 
-    Angles sAngle(uMob->GetPosition(), sMob->GetPosition());
-    Angles uAngle(sMob->GetPosition(), uMob->GetPosition());
-
-    Complex2DVector raysPreComp(channelParams->m_reducedClusterNumber,
-                                table3gpp->m_raysPerCluster); // stores part of the ray expression,
-    // cached as independent from the u- and s-indexes
-    Double2DVector sinCosA; // cached multiplications of sin and cos of the ZoA and AoA angles
-    Double2DVector sinSinA; // cached multiplications of sines of the ZoA and AoA angles
-    Double2DVector cosZoA;  // cached cos of the ZoA angle
-    Double2DVector sinCosD; // cached multiplications of sin and cos of the ZoD and AoD angles
-    Double2DVector sinSinD; // cached multiplications of the cosines of the ZoA and AoA angles
-    Double2DVector cosZoD;  // cached cos of the ZoD angle
-
-    // resize to appropriate dimensions
-    sinCosA.resize(channelParams->m_reducedClusterNumber);
-    sinSinA.resize(channelParams->m_reducedClusterNumber);
-    cosZoA.resize(channelParams->m_reducedClusterNumber);
-    sinCosD.resize(channelParams->m_reducedClusterNumber);
-    sinSinD.resize(channelParams->m_reducedClusterNumber);
-    cosZoD.resize(channelParams->m_reducedClusterNumber);
-    for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+    Angles sAngle(nodes.m_bPosition, nodes.m_aPosition);
+    Angles uAngle(nodes.m_aPosition, nodes.m_bPosition);
+
+    // the locations of the antenna elements
+    std::vector<Vector> uLocs(uSize);
+    for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+    {
+        uLocs[uIndex] = uAntenna->GetElementLocation(uIndex);
+    }
+    std::vector<Vector> sLocs(sSize);
+    for (size_t sIndex = 0; sIndex < sSize; sIndex++)
     {
-        sinCosA[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinSinA[nIndex].resize(table3gpp->m_raysPerCluster);
-        cosZoA[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinCosD[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinSinD[nIndex].resize(table3gpp->m_raysPerCluster);
-        cosZoD[nIndex].resize(table3gpp->m_raysPerCluster);
+        sLocs[sIndex] = sAntenna->GetElementLocation(sIndex);
     }
+
+    uint8_t numRays = table3gpp->m_raysPerCluster;
+    size_t numRayTerms = channelParams->m_reducedClusterNumber * numRays;
+    // The following caches are indexed by nIndex * numRays + mIndex
+    std::vector<std::complex<double>> raysPreComp(numRayTerms); // stores part of the ray
+    // expression, cached as independent from the u- and s-indexes
+    DoubleVector sinCosA(numRayTerms); // cached multiplications of sin and cos of the ZoA and AoA
+    DoubleVector sinSinA(numRayTerms); // cached multiplications of sines of the ZoA and AoA angles
+    DoubleVector cosZoA(numRayTerms);  // cached cos of the ZoA angle
+    DoubleVector sinCosD(numRayTerms); // cached multiplications of sin and cos of the ZoD and AoD
+    DoubleVector sinSinD(numRayTerms); // cached multiplications of the cosines of the ZoA and AoA
+    DoubleVector cosZoD(numRayTerms);  // cached cos of the ZoD angle
+
     // pre-compute the terms which are independent from uIndex and sIndex
     for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
     {
-        for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+        for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
         {
-            DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
-            NS_ASSERT(4 <= initialPhase.size());
+            const double* initialPhase = &channelParams->m_clusterPhase[nIndex][4 * mIndex];
             double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
 
             // cache the component of the "rays" terms which depend on the random angle of arrivals
@@ -1961,7 +2218,8 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
             auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna->GetElementFieldPattern(
                 Angles(channelParams->m_rayAodRadian[nIndex][mIndex],
                        channelParams->m_rayZodRadian[nIndex][mIndex]));
-            raysPreComp(nIndex, mIndex) =
+            size_t rIndex = nIndex * numRays + mIndex;
+            raysPreComp[rIndex] =
                 std::complex<double>(cos(initialPhase[0]), sin(initialPhase[0])) *
                     rxFieldPatternTheta * txFieldPatternTheta +
                 std::complex<double>(cos(initialPhase[1]), sin(initialPhase[1])) *
@@ -1976,18 +2234,54 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
             double sinRayZoa = sin(rayZoaRadian[nIndex][mIndex]);
             double sinRayAoa = cos(rayAoaRadian[nIndex][mIndex]);
             double cosRayAoa = cos(rayAoaRadian[nIndex][mIndex]);
-            sinCosA[nIndex][mIndex] = sinRayZoa * cosRayAoa;
-            sinSinA[nIndex][mIndex] = sinRayZoa * sinRayAoa;
-            cosZoA[nIndex][mIndex] = cos(rayZoaRadian[nIndex][mIndex]);
+            sinCosA[rIndex] = sinRayZoa * cosRayAoa;
+            sinSinA[rIndex] = sinRayZoa * sinRayAoa;
+            cosZoA[rIndex] = cos(rayZoaRadian[nIndex][mIndex]);
 
             // cache the component of the "txPhaseDiff" terms which depend on the random angle of
             // departure only
             double sinRayZod = sin(rayZodRadian[nIndex][mIndex]);
             double sinRayAod = cos(rayAodRadian[nIndex][mIndex]);
             double cosRayAod = cos(rayAodRadian[nIndex][mIndex]);
-            sinCosD[nIndex][mIndex] = sinRayZod * cosRayAod;
-            sinSinD[nIndex][mIndex] = sinRayZod * sinRayAod;
-            cosZoD[nIndex][mIndex] = cos(rayZodRadian[nIndex][mIndex]);
+            sinCosD[rIndex] = sinRayZod * cosRayAod;
+            sinSinD[rIndex] = sinRayZod * sinRayAod;
+            cosZoD[rIndex] = cos(rayZodRadian[nIndex][mIndex]);
+        }
+    }
+
+    // The phase terms exp(j rxPhaseDiff) depend on (n, u, m) and the terms
+    // exp(j txPhaseDiff) on (n, s, m): compute them once, instead of once per
+    // (u, s) pair, and store them with the rays in the inner dimension
+    std::vector<std::complex<double>> rxPhases(numRayTerms * uSize);
+    std::vector<std::complex<double>> txPhases(numRayTerms * sSize);
+    for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+    {
+        for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+        {
+            const Vector& uLoc = uLocs[uIndex];
+            std::complex<double>* rxPhase = &rxPhases[(nIndex * uSize + uIndex) * numRays];
+            for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
+            {
+                size_t rIndex = nIndex * numRays + mIndex;
+                // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
+                double rxPhaseDiff = 2 * M_PI *
+                                     (sinCosA[rIndex] * uLoc.x + sinSinA[rIndex] * uLoc.y +
+                                      cosZoA[rIndex] * uLoc.z);
+                rxPhase[mIndex] = std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff));
+            }
+        }
+        for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+            const Vector& sLoc = sLocs[sIndex];
+            std::complex<double>* txPhase = &txPhases[(nIndex * sSize + sIndex) * numRays];
+            for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
+            {
+                size_t rIndex = nIndex * numRays + mIndex;
+                double txPhaseDiff = 2 * M_PI *
+                                     (sinCosD[rIndex] * sLoc.x + sinSinD[rIndex] * sLoc.y +
+                                      cosZoD[rIndex] * sLoc.z);
+                txPhase[mIndex] = std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+            }
         }
     }
 
@@ -1996,39 +2290,29 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
     uint8_t numSubClustersAdded = 0;
     for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
     {
+        const std::complex<double>* rayPreComp = &raysPreComp[nIndex * numRays];
+        double rayScale =
+            sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
         for (size_t uIndex = 0; uIndex < uSize; uIndex++)
         {
-            Vector uLoc = uAntenna->GetElementLocation(uIndex);
+            const std::complex<double>* rxPhase = &rxPhases[(nIndex * uSize + uIndex) * numRays];
 
             for (size_t sIndex = 0; sIndex < sSize; sIndex++)
             {
-                Vector sLoc = sAntenna->GetElementLocation(sIndex);
+                const std::complex<double>* txPhase =
+                    &txPhases[(nIndex * sSize + sIndex) * numRays];
                 // Compute the N-2 weakest cluster, assuming 0 slant angle and a
                 // polarization slant angle configured in the array (7.5-22)
                 if (nIndex != channelParams->m_cluster1st && nIndex != channelParams->m_cluster2nd)
                 {
                     std::complex<double> rays(0, 0);
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                    for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
                     {
-                        // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                        double rxPhaseDiff =
-                            2 * M_PI *
-                            (sinCosA[nIndex][mIndex] * uLoc.x + sinSinA[nIndex][mIndex] * uLoc.y +
-                             cosZoA[nIndex][mIndex] * uLoc.z);
-
-                        double txPhaseDiff =
-                            2 * M_PI *
-                            (sinCosD[nIndex][mIndex] * sLoc.x + sinSinD[nIndex][mIndex] * sLoc.y +
-                             cosZoD[nIndex][mIndex] * sLoc.z);
-
                         // NOTE Doppler is computed in the CalcBeamformingGain function and is
                         // simplified to only account for the center angle of each cluster.
-                        rays += raysPreComp(nIndex, mIndex) *
-                                std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                                std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+                        rays += rayPreComp[mIndex] * rxPhase[mIndex] * txPhase[mIndex];
                     }
-                    rays *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
+                    rays *= rayScale;
                     hUsn(uIndex, sIndex, nIndex) = rays;
                 }
                 else //(7.5-28)
@@ -2037,24 +2321,12 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
                     std::complex<double> raysSub2(0, 0);
                     std::complex<double> raysSub3(0, 0);
 
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                    for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
                     {
                         // ZML:Just remind me that the angle offsets for the 3 subclusters were not
                         // generated correctly.
-                        double rxPhaseDiff =
-                            2 * M_PI *
-                            (sinCosA[nIndex][mIndex] * uLoc.x + sinSinA[nIndex][mIndex] * uLoc.y +
-                             cosZoA[nIndex][mIndex] * uLoc.z);
-
-                        double txPhaseDiff =
-                            2 * M_PI *
-                            (sinCosD[nIndex][mIndex] * sLoc.x + sinSinD[nIndex][mIndex] * sLoc.y +
-                             cosZoD[nIndex][mIndex] * sLoc.z);
-
                         std::complex<double> raySub =
-                            raysPreComp(nIndex, mIndex) *
-                            std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                            std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+                            rayPreComp[mIndex] * rxPhase[mIndex] * txPhase[mIndex];
 
                         switch (mIndex)
                         {
@@ -2077,12 +2349,9 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
                             break;
                         }
                     }
-                    raysSub1 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub2 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub3 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
+                    raysSub1 *= rayScale;
+                    raysSub2 *= rayScale;
+                    raysSub3 *= rayScale;
                     hUsn(uIndex, sIndex, nIndex) = raysSub1;
                     hUsn(uIndex,
                          sIndex,
@@ -2115,44 +2384,48 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
         const double sinSAngleAz = sin(sAngle.GetAzimuth());
         const double cosSAngleAz = cos(sAngle.GetAzimuth());
 
+        // the field patterns and the K factor do not depend on uIndex and sIndex
+        auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna->GetElementFieldPattern(
+            Angles(uAngle.GetAzimuth(), uAngle.GetInclination()));
+        auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna->GetElementFieldPattern(
+            Angles(sAngle.GetAzimuth(), sAngle.GetInclination()));
+        double kLinear = pow(10, channelParams->m_K_factor / 10.0);
+        double nlosScale = sqrt(1.0 / (kLinear + 1));
+        double losScale = sqrt(kLinear / (1 + kLinear));
+        double losAttenuation = pow(10, channelParams->m_attenuation_dB[0] / 10.0);
+
+        std::vector<std::complex<double>> txLosPhases(sSize);
+        for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+            const Vector& sLoc = sLocs[sIndex];
+            double txPhaseDiff =
+                2 * M_PI *
+                (sinSAngleIncl * cosSAngleAz * sLoc.x + sinSAngleIncl * sinSAngleAz * sLoc.y +
+                 cosSAngleIncl * sLoc.z);
+            txLosPhases[sIndex] = std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+        }
+
         for (size_t uIndex = 0; uIndex < uSize; uIndex++)
         {
-            Vector uLoc = uAntenna->GetElementLocation(uIndex);
+            const Vector& uLoc = uLocs[uIndex];
             double rxPhaseDiff = 2 * M_PI *
                                  (sinUAngleIncl * cosUAngleAz * uLoc.x +
                                   sinUAngleIncl * sinUAngleAz * uLoc.y + cosUAngleIncl * uLoc.z);
+            std::complex<double> rxLosPhase(cos(rxPhaseDiff), sin(rxPhaseDiff));
 
             for (size_t sIndex = 0; sIndex < sSize; sIndex++)
             {
-                Vector sLoc = sAntenna->GetElementLocation(sIndex);
-                std::complex<double> ray(0, 0);
-                double txPhaseDiff =
-                    2 * M_PI *
-                    (sinSAngleIncl * cosSAngleAz * sLoc.x + sinSAngleIncl * sinSAngleAz * sLoc.y +
-                     cosSAngleIncl * sLoc.z);
-
-                auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna->GetElementFieldPattern(
-                    Angles(uAngle.GetAzimuth(), uAngle.GetInclination()));
-                auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna->GetElementFieldPattern(
-                    Angles(sAngle.GetAzimuth(), sAngle.GetInclination()));
-
-                ray = (rxFieldPatternTheta * txFieldPatternTheta -
-                       rxFieldPatternPhi * txFieldPatternPhi) *
-                      phaseDiffDueToDistance *
-                      std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                      std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-
-                double kLinear = pow(10, channelParams->m_K_factor / 10.0);
+                std::complex<double> ray = (rxFieldPatternTheta * txFieldPatternTheta -
+                                            rxFieldPatternPhi * txFieldPatternPhi) *
+                                           phaseDiffDueToDistance * rxLosPhase *
+                                           txLosPhases[sIndex];
+
                 // the LOS path should be attenuated if blockage is enabled.
-                hUsn(uIndex, sIndex, 0) =
-                    sqrt(1.0 / (kLinear + 1)) * hUsn(uIndex, sIndex, 0) +
-                    sqrt(kLinear / (1 + kLinear)) * ray /
-                        pow(10,
-                            channelParams->m_attenuation_dB[0] / 10.0); //(7.5-30) for tau = tau1
+                hUsn(uIndex, sIndex, 0) = nlosScale * hUsn(uIndex, sIndex, 0) +
+                                          losScale * ray / losAttenuation; //(7.5-30) for tau = tau1
                 for (uint16_t nIndex = 1; nIndex < hUsn.GetNumPages(); nIndex++)
                 {
-                    hUsn(uIndex, sIndex, nIndex) *=
-                        sqrt(1.0 / (kLinear + 1)); //(7.5-30) for tau = tau2...tauN
+                    hUsn(uIndex, sIndex, nIndex) *= nlosScale; //(7.5-30) for tau = tau2...tauN
                 }
             }
         }
@@ -2173,7 +2446,7 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
     NS_LOG_INFO("size of coefficient matrix (rows, columns, clusters) = ("
                 << hUsn.GetNumRows() << ", " << hUsn.GetNumCols() << ", " << hUsn.GetNumPages()
                 << ")");
-    channelMatrix->m_channel = hUsn;
+    channelMatrix->m_channel = std::move(hUsn);
 
     return channelMatrix;
 }
@@ -2201,9 +2474,10 @@ ThreeGppChannelModel::WrapAngles(double azimuthRad, double inclinationRad)
 
 MatrixBasedChannelModel::DoubleVector
 ThreeGppChannelModel::CalcAttenuationOfBlockage(
-    const Ptr<ThreeGppChannelModel::ThreeGppChannelParams> channelParams,
+    const Ptr<ThreeGppChannelModel::ThreeGppChannelParams>& channelParams,
     const DoubleVector& clusterAOA,
-    const DoubleVector& clusterZOA) const
+    const DoubleVector& clusterZOA,
+    const RandomVariables& rv) const
 {
     NS_LOG_FUNCTION(this);
 
@@ -2238,18 +2512,18 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage(
         {
             // draw value from table 7.6.4.1-2 Blocking region parameters
             DoubleVector table;
-            table.push_back(m_normalRv->GetValue()); // phi_k: store the normal RV that will be
+            table.push_back(rv.m_normalRv->GetValue()); // phi_k: store the normal RV that will be
                                                      // mapped to uniform (0,360) later.
             if (m_scenario == "InH-OfficeMixed" || m_scenario == "InH-OfficeOpen")
             {
-                table.push_back(m_uniformRv->GetValue(15, 45)); // x_k
+                table.push_back(rv.m_uniformRv->GetValue(15, 45)); // x_k
                 table.push_back(90);                            // Theta_k
-                table.push_back(m_uniformRv->GetValue(5, 15));  // y_k
+                table.push_back(rv.m_uniformRv->GetValue(5, 15));  // y_k
                 table.push_back(2);                             // r
             }
             else
             {
-                table.push_back(m_uniformRv->GetValue(5, 15)); // x_k
+                table.push_back(rv.m_uniformRv->GetValue(5, 15)); // x_k
                 table.push_back(90);                           // Theta_k
                 table.push_back(5);                            // y_k
                 table.push_back(10);                           // r
@@ -2319,7 +2593,7 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage(
                 // Generate a new correlated normal RV with the following formula
                 channelParams->m_nonSelfBlocking[blockInd][PHI_INDEX] =
                     R * channelParams->m_nonSelfBlocking[blockInd][PHI_INDEX] +
-                    sqrt(1 - R * R) * m_normalRv->GetValue();
+                    sqrt(1 - R * R) * rv.m_normalRv->GetValue();
             }
         }
     }
@@ -2452,11 +2726,13 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage(
 }
 
 void
-ThreeGppChannelModel::Shuffle(double* first, double* last) const
+ThreeGppChannelModel::Shuffle(double* first,
+                              double* last,
+                              const Ptr<UniformRandomVariable>& rv) const
 {
     for (auto i = (last - first) - 1; i > 0; --i)
     {
-        std::swap(first[i], first[m_uniformRvShuffle->GetInteger(0, i)]);
+        std::swap(first[i], first[rv->GetInteger(0, i)]);
     }
 }
 
@@ -2464,10 +2740,10 @@ int64_t
 ThreeGppChannelModel::AssignStreams(int64_t stream)
 {
     NS_LOG_FUNCTION(this << stream);
-    m_normalRv->SetStream(stream);
-    m_uniformRv->SetStream(stream + 1);
-    m_uniformRvShuffle->SetStream(stream + 2);
-    m_uniformRvDoppler->SetStream(stream + 3);
+    m_rv.m_normalRv->SetStream(stream);
+    m_rv.m_uniformRv->SetStream(stream + 1);
+    m_rv.m_uniformRvShuffle->SetStream(stream + 2);
+    m_rv.m_uniformRvDoppler->SetStream(stream + 3);
     return 4;
 }
 
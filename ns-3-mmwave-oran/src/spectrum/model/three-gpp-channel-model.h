@@ -24,15 +24,19 @@
 #include "ns3/angles.h"
 #include <ns3/boolean.h>
 #include <ns3/channel-condition-model.h>
+#include <ns3/event-id.h>
 #include <ns3/matrix-based-channel-model.h>
 
 #include <complex.h>
+#include <map>
+#include <memory>
 #include <unordered_map>
 
 namespace ns3
 {
 
 class MobilityModel;
+class WorkerPool;
 
 /**
  * \ingroup spectrum
@@ -41,6 +45,16 @@ class MobilityModel;
  * The class implements the channel matrix generation procedure
  * described in 3GPP TR 38.901.
  *
+ * By default, the channel of a pair of nodes and antennas is generated when
+ * it is first used, and again when it is first used after UpdatePeriod. With
+ * the PrefetchThreads attribute, the channels of all the pairs used since the
+ * previous update are instead generated again all at once, at each
+ * UpdatePeriod, on a WorkerPool. Each pair of nodes then draws its channels
+ * from its own random streams, so that they do not depend on the number of
+ * threads nor on the order of the generations. With PrefetchLead, the update
+ * is computed ahead of its time, so that the event loop only looks up the
+ * channels.
+ *
  * \see GetChannel
  */
 class ThreeGppChannelModel : public MatrixBasedChannelModel
@@ -104,7 +118,8 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
      * Looks for the channel matrix associated to the aMob and bMob pair in m_channelMatrixMap.
      * If found, it checks if it has to be updated. If not found or if it has to
      * be updated, it generates a new uncorrelated channel matrix using the
-     * method GetNewChannel and updates m_channelMap.
+     * method GetNewChannel and updates m_channelMap. With prefetch, the pair is
+     * also added to the ones generated again at the next update.
      *
      * \param aMob mobility model of the a device
      * \param bMob mobility model of the b device
@@ -129,7 +144,8 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
                                        Ptr<const MobilityModel> bMob) const override;
     /**
      * \brief Assign a fixed random variable stream number to the random variables
-     * used by this model.
+     * used by this model. With prefetch, the random variables of the pairs of
+     * nodes are instead assigned the streams set by the PrefetchStream attribute.
      *
      * \param stream first stream index to use
      * \return the number of stream indices assigned by this model
@@ -156,8 +172,48 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
      * \brief Shuffle the elements of a simple sequence container of type double
      * \param first Pointer to the first element among the elements to be shuffled
      * \param last Pointer to the last element among the elements to be shuffled
+     * \param rv the uniform random variable to draw from
+     */
+    void Shuffle(double* first, double* last, const Ptr<UniformRandomVariable>& rv) const;
+
+    /**
+     * The random variables used to generate the channel parameters. The model
+     * has its own set and, with prefetch, each pair of nodes has its own set.
+     */
+    struct RandomVariables
+    {
+        Ptr<UniformRandomVariable> m_uniformRv; //!< uniform random variable
+        Ptr<NormalRandomVariable> m_normalRv;   //!< normal random variable
+        Ptr<UniformRandomVariable>
+            m_uniformRvShuffle; //!< uniform random variable used to shuffle array in GetNewChannel
+        Ptr<UniformRandomVariable> m_uniformRvDoppler; //!< uniform random variable, used to compute
+                                                       //!< the additional Doppler contribution
+
+        /**
+         * Create the random variables
+         * \param stream the first of the four streams to assign, or -1 to
+         *        assign them automatically
+         */
+        void Create(int64_t stream = -1);
+    };
+
+    /**
+     * The state of the nodes a and b that the generation of their channel
+     * depends on, taken from their mobility models
      */
-    void Shuffle(double* first, double* last) const;
+    struct NodePairState
+    {
+        uint32_t m_aId{0};   //!< the ID of node a
+        uint32_t m_bId{0};   //!< the ID of node b
+        Vector m_aPosition;  //!< the position of node a
+        Vector m_bPosition;  //!< the position of node b
+        Time m_generatedTime; //!< the generation time of the channel
+
+        /**
+         * \return the same state, with a and b swapped
+         */
+        NodePairState Reverse() const;
+    };
 
     /**
      * Extends the struct ChannelParams by including information that is used
@@ -191,7 +247,8 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
             m_rayZodRadian; //!< the vector containing ZOD angles
         MatrixBasedChannelModel::Double2DVector
             m_rayZoaRadian; //!< the vector containing ZOA angles
-        MatrixBasedChannelModel::Double3DVector m_clusterPhase; //!< the initial random phases
+        MatrixBasedChannelModel::Double2DVector
+            m_clusterPhase; //!< the 4 initial random phases of each ray, phase[n][4 * m + p]
         MatrixBasedChannelModel::Double2DVector
             m_crossPolarizationPowerRatios; //!< cross polarization power ratios
         Vector m_speed;                     //!< velocity
@@ -284,50 +341,55 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
      *
      * All relevant generated parameters are added then to ThreeGppChannelParams
      * which is the return value of this function.
+     * The function neither uses the simulator nor copies the given pointers,
+     * so that it can be called concurrently for different pairs of nodes.
+     *
      * \param channelCondition the channel condition
      * \param table3gpp the 3gpp parameters from the table
-     * \param aMob the a node mobility model
-     * \param bMob the b node mobility model
+     * \param nodes the state of the a and b nodes
+     * \param rv the random variables to draw from
      * \return ThreeGppChannelParams structure with all the channel parameters generated
      * according 38.901 steps from 4 to 10.
      */
     Ptr<ThreeGppChannelParams> GenerateChannelParameters(
-        const Ptr<const ChannelCondition> channelCondition,
-        const Ptr<const ParamsTable> table3gpp,
-        const Ptr<const MobilityModel> aMob,
-        const Ptr<const MobilityModel> bMob) const;
+        const Ptr<const ChannelCondition>& channelCondition,
+        const Ptr<const ParamsTable>& table3gpp,
+        const NodePairState& nodes,
+        const RandomVariables& rv) const;
 
     /**
      * Compute the channel matrix between two nodes a and b, and their
      * antenna arrays aAntenna and bAntenna using the procedure
-     * described in 3GPP TR 38.901
+     * described in 3GPP TR 38.901. The function neither uses the simulator nor
+     * copies the given pointers, so that it can be called concurrently for
+     * different pairs of antennas.
      * \param channelParams the channel parameters previously generated for the pair of
      * nodes a and b
      * \param table3gpp the 3gpp parameters table
-     * \param sMob the mobility model of node s
-     * \param uMob the mobility model of node u
+     * \param nodes the state of the nodes, with s as node a and u as node b
      * \param sAntenna the antenna array of node s
      * \param uAntenna the antenna array of node u
      * \return the channel realization
      */
 
-    virtual Ptr<ChannelMatrix> GetNewChannel(Ptr<const ThreeGppChannelParams> channelParams,
-                                             Ptr<const ParamsTable> table3gpp,
-                                             const Ptr<const MobilityModel> sMob,
-                                             const Ptr<const MobilityModel> uMob,
-                                             Ptr<const PhasedArrayModel> sAntenna,
-                                             Ptr<const PhasedArrayModel> uAntenna) const;
+    virtual Ptr<ChannelMatrix> GetNewChannel(const Ptr<const ThreeGppChannelParams>& channelParams,
+                                             const Ptr<const ParamsTable>& table3gpp,
+                                             const NodePairState& nodes,
+                                             const Ptr<const PhasedArrayModel>& sAntenna,
+                                             const Ptr<const PhasedArrayModel>& uAntenna) const;
     /**
      * Applies the blockage model A described in 3GPP TR 38.901
      * \param channelParams the channel parameters structure
      * \param clusterAOA vector containing the azimuth angle of arrival for each cluster
      * \param clusterZOA vector containing the zenith angle of arrival for each cluster
+     * \param rv the random variables to draw from
      * \return vector containing the power attenuation for each cluster
      */
     DoubleVector CalcAttenuationOfBlockage(
-        const Ptr<ThreeGppChannelModel::ThreeGppChannelParams> channelParams,
+        const Ptr<ThreeGppChannelModel::ThreeGppChannelParams>& channelParams,
         const DoubleVector& clusterAOA,
-        const DoubleVector& clusterZOA) const;
+        const DoubleVector& clusterZOA,
+        const RandomVariables& rv) const;
 
     /**
      * Check if the channel params has to be updated
@@ -348,6 +410,85 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
     bool ChannelMatrixNeedsUpdate(Ptr<const ThreeGppChannelParams> channelParams,
                                   Ptr<const ChannelMatrix> channelMatrix);
 
+    /**
+     * Get the parameters needed to generate the channel of two nodes
+     * \param channelCondition the channel condition
+     * \param nodes the state of the nodes
+     * \return the parameters table
+     */
+    Ptr<const ParamsTable> GetNodePairTable(Ptr<const ChannelCondition> channelCondition,
+                                            const NodePairState& nodes) const;
+
+    /**
+     * Take the state of two nodes from their mobility models
+     * \param aMob the mobility model of node a
+     * \param bMob the mobility model of node b
+     * \param lead the time until the generation: the positions are extrapolated
+     *        with the current velocities
+     * \return the state of the nodes
+     */
+    static NodePairState GetNodePairState(Ptr<const MobilityModel> aMob,
+                                          Ptr<const MobilityModel> bMob,
+                                          Time lead);
+
+    /**
+     * Add a pair of nodes and antennas to the ones generated again at each
+     * update, or mark it as used if it is already there, and schedule the next
+     * update if needed
+     * \param aMob mobility model of the a device
+     * \param bMob mobility model of the b device
+     * \param aAntenna antenna of the a device
+     * \param bAntenna antenna of the b device
+     * \return the random variables of the pair of nodes
+     */
+    const RandomVariables& RegisterPrefetchPair(Ptr<const MobilityModel> aMob,
+                                                Ptr<const MobilityModel> bMob,
+                                                Ptr<const PhasedArrayModel> aAntenna,
+                                                Ptr<const PhasedArrayModel> bAntenna);
+
+    /**
+     * Generate the channels of all the pairs used since the previous update,
+     * for the update at time Now () + m_prefetchLead, in parallel if there is
+     * a pool, and install them at that time. The pairs not used since the
+     * previous update are forgotten.
+     */
+    void PrefetchChannels();
+
+    /**
+     * Install the channels generated by PrefetchChannels
+     */
+    void CommitPrefetchedChannels();
+
+    /**
+     * A pair of antennas whose channel is generated again at each update
+     */
+    struct PrefetchAntennaPair
+    {
+        uint64_t m_key{0};                      //!< the key of the channel matrix
+        Ptr<const PhasedArrayModel> m_aAntenna; //!< the antenna of node a
+        Ptr<const PhasedArrayModel> m_bAntenna; //!< the antenna of node b
+        bool m_reverse{false};                  //!< whether the antennas are of b and a instead
+        Ptr<ChannelMatrix> m_channelMatrix;     //!< the prefetched channel matrix
+    };
+
+    /**
+     * A pair of nodes whose channel is generated again at each update, with
+     * its pairs of antennas
+     */
+    struct PrefetchNodePair
+    {
+        Ptr<const MobilityModel> m_aMob;                //!< the mobility model of node a
+        Ptr<const MobilityModel> m_bMob;                //!< the mobility model of node b
+        RandomVariables m_rv;                           //!< the random variables of the pair
+        std::map<uint64_t, PrefetchAntennaPair> m_antennaPairs; //!< the pairs of antennas, by key
+        bool m_used{false};                             //!< whether used since the previous update
+        // inputs and outputs of the generation
+        Ptr<const ChannelCondition> m_condition;  //!< the channel condition
+        Ptr<const ParamsTable> m_table3gpp;       //!< the 3gpp parameters table
+        NodePairState m_state;                    //!< the state of the nodes
+        Ptr<ThreeGppChannelParams> m_channelParams; //!< the prefetched channel parameters
+    };
+
     std::unordered_map<uint64_t, Ptr<ChannelMatrix>>
         m_channelMatrixMap; //!< map containing the channel realizations per pair of
                             //!< PhasedAntennaArray instances, the key of this map is reciprocal
@@ -360,17 +501,12 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
     double m_frequency;     //!< the operating frequency
     std::string m_scenario; //!< the 3GPP scenario
     Ptr<ChannelConditionModel> m_channelConditionModel; //!< the channel condition model
-    Ptr<UniformRandomVariable> m_uniformRv;             //!< uniform random variable
-    Ptr<NormalRandomVariable> m_normalRv;               //!< normal random variable
-    Ptr<UniformRandomVariable>
-        m_uniformRvShuffle; //!< uniform random variable used to shuffle array in GetNewChannel
+    RandomVariables m_rv; //!< the random variables, used without prefetch
 
     // Variable used to compute the additional Doppler contribution for the delayed
     // (reflected) paths, as described in 3GPP TR 37.885 v15.3.0, Sec. 6.2.3.
     double m_vScatt; //!< value used to compute the additional Doppler contribution for the delayed
                      //!< paths
-    Ptr<UniformRandomVariable> m_uniformRvDoppler; //!< uniform random variable, used to compute the
-                                                   //!< additional Doppler contribution
 
     // parameters for the blockage model
     bool m_blockage;               //!< enables the blockage model A
@@ -378,6 +514,19 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
     bool m_portraitMode;           //!< true if portrait mode, false if landscape
     double m_blockerSpeed;         //!< the blocker speed
 
+    // parameters and state of the prefetch
+    uint32_t m_prefetchThreads; //!< threads generating the channels at each update, 0 to disable
+    Time m_prefetchLead;        //!< how long before each update the channels are generated
+    int64_t m_prefetchStream;   //!< the first stream of the pairs of nodes, -1 for automatic
+    uint64_t m_prefetchNumPairs{0}; //!< the number of pairs of nodes added so far
+    std::shared_ptr<WorkerPool> m_prefetchPool; //!< the pool, if m_prefetchThreads > 1
+    std::map<uint64_t, PrefetchNodePair>
+        m_prefetchPairs;        //!< the pairs generated at each update, by channel params key
+    EventId m_prefetchEvent;    //!< the event of the next generation
+    Time m_prefetchUpdateTime;  //!< the time of the next update
+    Time m_lastUpdateTime;      //!< the time of the last update installed
+    bool m_prefetchPending{false}; //!< whether prefetched channels are waiting to be installed
+
     static const uint8_t PHI_INDEX = 0; //!< index of the PHI value in the m_nonSelfBlocking array
     static const uint8_t X_INDEX = 1;   //!< index of the X value in the m_nonSelfBlocking array
     static const uint8_t THETA_INDEX =
@@ -24,6 +24,7 @@
 #include "spectrum-signal-parameters.h"
 #include "three-gpp-channel-model.h"
 
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/net-device.h"
@@ -73,7 +74,17 @@ ThreeGppSpectrumPropagationLossModel::GetTypeId()
                 StringValue("ns3::ThreeGppChannelModel"),
                 MakePointerAccessor(&ThreeGppSpectrumPropagationLossModel::SetChannelModel,
                                     &ThreeGppSpectrumPropagationLossModel::GetChannelModel),
-                MakePointerChecker<MatrixBasedChannelModel>());
+                MakePointerChecker<MatrixBasedChannelModel>())
+            .AddAttribute(
+                "CacheDelayPhases",
+                "If true, the phases exp(-j 2 pi f tau_n) of the delays of the clusters on each "
+                "band are kept with the long term component of each pair of antenna arrays, "
+                "instead of being computed for each PSD. This saves a cos and a sin per band "
+                "and cluster on each PSD, at the cost of 16 bytes per band and cluster for "
+                "each pair, e.g., about 25 KB with 72 bands.",
+                BooleanValue(false),
+                MakeBooleanAccessor(&ThreeGppSpectrumPropagationLossModel::m_cacheDelayPhases),
+                MakeBooleanChecker());
     return tid;
 }
 
@@ -136,25 +147,93 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm(
 
 Ptr<SpectrumValue>
 ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
-    Ptr<SpectrumValue> txPsd,
-    PhasedArrayModel::ComplexVector longTerm,
-    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+    Ptr<const SpectrumValue> txPsd,
+    Ptr<LongTerm> longTerm,
     Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
     const ns3::Vector& sSpeed,
     const ns3::Vector& uSpeed) const
 {
     NS_LOG_FUNCTION(this);
 
+    // the delay phases only depend on the channel params and on the bands
+    std::vector<std::complex<double>> delayPhases;
+    const std::vector<std::complex<double>>* phases = &delayPhases;
+    if (!m_cacheDelayPhases)
+    {
+        CalcDelayPhases(*txPsd,
+                        *channelParams,
+                        longTerm->m_channel->m_channel.GetNumPages(),
+                        delayPhases);
+    }
+    else
+    {
+        if (longTerm->m_params != channelParams ||
+            longTerm->m_spectrumModelUid != txPsd->GetSpectrumModelUid())
+        {
+            NS_LOG_DEBUG("compute the delay phases");
+            CalcDelayPhases(*txPsd,
+                            *channelParams,
+                            longTerm->m_channel->m_channel.GetNumPages(),
+                            longTerm->m_delayPhases);
+            longTerm->m_params = channelParams;
+            longTerm->m_spectrumModelUid = txPsd->GetSpectrumModelUid();
+        }
+        phases = &longTerm->m_delayPhases;
+    }
+
     Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue>(txPsd);
+    ApplyBeamformingGain(*tempPsd,
+                         longTerm->m_longTerm,
+                         *phases,
+                         *longTerm->m_channel,
+                         *channelParams,
+                         sSpeed,
+                         uSpeed,
+                         Simulator::Now().GetSeconds(),
+                         GetFrequency());
+    return tempPsd;
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::CalcDelayPhases(
+    const SpectrumValue& psd,
+    const MatrixBasedChannelModel::ChannelParams& channelParams,
+    uint16_t numCluster,
+    std::vector<std::complex<double>>& delayPhases)
+{
+    NS_ASSERT(numCluster <= channelParams.m_delay.size());
+    delayPhases.resize(psd.GetValuesN() * numCluster);
+    auto phaseIt = delayPhases.begin();
+    for (auto sbit = psd.ConstBandsBegin(); sbit != psd.ConstBandsEnd(); sbit++)
+    {
+        double fsb = (*sbit).fc; // center frequency of the sub-band
+        for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
+        {
+            double delay = -2 * M_PI * fsb * (channelParams.m_delay[cIndex]);
+            *phaseIt++ = std::complex<double>(cos(delay), sin(delay));
+        }
+    }
+}
 
+void
+ThreeGppSpectrumPropagationLossModel::ApplyBeamformingGain(
+    SpectrumValue& psd,
+    const PhasedArrayModel::ComplexVector& longTerm,
+    const std::vector<std::complex<double>>& delayPhases,
+    const MatrixBasedChannelModel::ChannelMatrix& channelMatrix,
+    const MatrixBasedChannelModel::ChannelParams& channelParams,
+    const ns3::Vector& sSpeed,
+    const ns3::Vector& uSpeed,
+    double time,
+    double frequency)
+{
     // channel[cluster][rx][tx]
-    uint16_t numCluster = channelMatrix->m_channel.GetNumPages();
+    uint16_t numCluster = channelMatrix.m_channel.GetNumPages();
 
     // compute the doppler term
     // NOTE the update of Doppler is simplified by only taking the center angle of
     // each cluster in to consideration.
-    double slotTime = Simulator::Now().GetSeconds();
-    double factor = 2 * M_PI * slotTime * GetFrequency() / 3e8;
+    double factor = 2 * M_PI * time * frequency / 3e8;
     PhasedArrayModel::ComplexVector doppler(numCluster);
 
     // The following asserts might seem paranoic, but it is important to
@@ -162,40 +241,35 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     // are of the correct dimensions before using the operator [].
     // If you dont understand the comment read about the difference of .at()
     // and [] operators, ...
-    NS_ASSERT(numCluster <= channelParams->m_alpha.size());
-    NS_ASSERT(numCluster <= channelParams->m_D.size());
-    NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX].size());
-    NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX].size());
-    NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX].size());
-    NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX].size());
+    NS_ASSERT(numCluster <= channelParams.m_alpha.size());
+    NS_ASSERT(numCluster <= channelParams.m_D.size());
+    NS_ASSERT(numCluster <= channelParams.m_angle[MatrixBasedChannelModel::ZOA_INDEX].size());
+    NS_ASSERT(numCluster <= channelParams.m_angle[MatrixBasedChannelModel::ZOD_INDEX].size());
+    NS_ASSERT(numCluster <= channelParams.m_angle[MatrixBasedChannelModel::AOA_INDEX].size());
+    NS_ASSERT(numCluster <= channelParams.m_angle[MatrixBasedChannelModel::AOD_INDEX].size());
     NS_ASSERT(numCluster <= longTerm.GetSize());
+    NS_ASSERT(delayPhases.size() == psd.GetValuesN() * numCluster);
 
     // check if channelParams structure is generated in direction s-to-u or u-to-s
-    bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
-
-    MatrixBasedChannelModel::DoubleVector zoa;
-    MatrixBasedChannelModel::DoubleVector zod;
-    MatrixBasedChannelModel::DoubleVector aoa;
-    MatrixBasedChannelModel::DoubleVector aod;
+    bool isSameDirection = (channelParams.m_nodeIds == channelMatrix.m_nodeIds);
 
     // if channel params is generated in the same direction in which we
     // generate the channel matrix, angles and zenith od departure and arrival are ok,
-    // just set them to corresponding variable that will be used for the generation
+    // just refer to them with the corresponding variable that will be used for the generation
     // of channel matrix, otherwise we need to flip angles and zeniths of departure and arrival
-    if (isSameDirection)
-    {
-        zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-        zod = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-        aoa = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-        aod = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-    else
-    {
-        zod = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-        zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-        aod = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-        aoa = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
+    const auto& angle = channelParams.m_angle;
+    const MatrixBasedChannelModel::DoubleVector& zoa =
+        angle[isSameDirection ? MatrixBasedChannelModel::ZOA_INDEX
+                              : MatrixBasedChannelModel::ZOD_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& zod =
+        angle[isSameDirection ? MatrixBasedChannelModel::ZOD_INDEX
+                              : MatrixBasedChannelModel::ZOA_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& aoa =
+        angle[isSameDirection ? MatrixBasedChannelModel::AOA_INDEX
+                              : MatrixBasedChannelModel::AOD_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& aod =
+        angle[isSameDirection ? MatrixBasedChannelModel::AOD_INDEX
+                              : MatrixBasedChannelModel::AOA_INDEX];
 
     for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
@@ -210,8 +284,8 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
         // By default, m_vScatt is set to 0, so there is no additional Doppler
         // contribution.
 
-        double alpha = channelParams->m_alpha[cIndex];
-        double D = channelParams->m_D[cIndex];
+        double alpha = channelParams.m_alpha[cIndex];
+        double D = channelParams.m_D[cIndex];
 
         // cluster angle angle[direction][n], where direction = 0(aoa), 1(zoa).
         double tempDoppler =
@@ -229,37 +303,31 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
 
     // apply the doppler term and the propagation delay to the long term component
     // to obtain the beamforming gain
-    auto vit = tempPsd->ValuesBegin();      // psd iterator
-    auto sbit = tempPsd->ConstBandsBegin(); // band iterator
-    while (vit != tempPsd->ValuesEnd())
+    auto vit = psd.ValuesBegin(); // psd iterator
+    const std::complex<double>* delayPhase = delayPhases.data(); // delay phases of the band
+    while (vit != psd.ValuesEnd())
     {
         if ((*vit) != 0.00)
         {
             std::complex<double> subsbandGain(0.0, 0.0);
-            double fsb = (*sbit).fc; // center frequency of the sub-band
             for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
             {
-                double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]);
-                subsbandGain = subsbandGain + longTerm[cIndex] * doppler[cIndex] *
-                                                  std::complex<double>(cos(delay), sin(delay));
+                subsbandGain =
+                    subsbandGain + longTerm[cIndex] * doppler[cIndex] * delayPhase[cIndex];
             }
             *vit = (*vit) * (norm(subsbandGain));
         }
         vit++;
-        sbit++;
+        delayPhase += numCluster;
     }
-    return tempPsd;
 }
 
-PhasedArrayModel::ComplexVector
+Ptr<ThreeGppSpectrumPropagationLossModel::LongTerm>
 ThreeGppSpectrumPropagationLossModel::GetLongTerm(
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
     Ptr<const PhasedArrayModel> aPhasedArrayModel,
     Ptr<const PhasedArrayModel> bPhasedArrayModel) const
 {
-    PhasedArrayModel::ComplexVector
-        longTerm; // vector containing the long term component for each cluster
-
     // check if the channel matrix was generated considering a as the s-node and
     // b as the u-node or vice-versa
     PhasedArrayModel::ComplexVector sW;
@@ -275,49 +343,40 @@ ThreeGppSpectrumPropagationLossModel::GetLongTerm(
         uW = aPhasedArrayModel->GetBeamformingVector();
     }
 
-    bool update = false;   // indicates whether the long term has to be updated
-    bool notFound = false; // indicates if the long term has not been computed yet
-
     // compute the long term key, the key is unique for each tx-rx pair
     uint64_t longTermId =
         MatrixBasedChannelModel::GetKey(aPhasedArrayModel->GetId(), bPhasedArrayModel->GetId());
 
     // look for the long term in the map and check if it is valid
-    if (m_longTermMap.find(longTermId) != m_longTermMap.end())
+    Ptr<LongTerm>& longTermItem = m_longTermMap[longTermId];
+    if (longTermItem)
     {
         NS_LOG_DEBUG("found the long term component in the map");
-        longTerm = m_longTermMap[longTermId]->m_longTerm;
 
         // check if the channel matrix has been updated
         // or the s beam has been changed
         // or the u beam has been changed
-        update = (m_longTermMap[longTermId]->m_channel->m_generatedTime !=
-                      channelMatrix->m_generatedTime ||
-                  m_longTermMap[longTermId]->m_sW != sW || m_longTermMap[longTermId]->m_uW != uW);
+        if (longTermItem->m_channel->m_generatedTime == channelMatrix->m_generatedTime &&
+            longTermItem->m_sW == sW && longTermItem->m_uW == uW)
+        {
+            return longTermItem;
+        }
     }
     else
     {
         NS_LOG_DEBUG("long term component NOT found");
-        notFound = true;
+        longTermItem = Create<LongTerm>();
     }
 
-    if (update || notFound)
-    {
-        NS_LOG_DEBUG("compute the long term");
-        // compute the long term component
-        longTerm = CalcLongTerm(channelMatrix, sW, uW);
-
-        // store the long term
-        Ptr<LongTerm> longTermItem = Create<LongTerm>();
-        longTermItem->m_longTerm = longTerm;
-        longTermItem->m_channel = channelMatrix;
-        longTermItem->m_sW = sW;
-        longTermItem->m_uW = uW;
-
-        m_longTermMap[longTermId] = longTermItem;
-    }
+    // compute the long term component and store it, the delay phases are kept
+    // as they only depend on the channel params
+    NS_LOG_DEBUG("compute the long term");
+    longTermItem->m_longTerm = CalcLongTerm(channelMatrix, sW, uW);
+    longTermItem->m_channel = channelMatrix;
+    longTermItem->m_sW = std::move(sW);
+    longTermItem->m_uW = std::move(uW);
 
-    return longTerm;
+    return longTermItem;
 }
 
 Ptr<SpectrumValue>
@@ -336,8 +395,6 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity(
     NS_ASSERT_MSG(a->GetDistanceFrom(b) > 0.0,
                   "The position of a and b devices cannot be the same");
 
-    Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue>(params->psd);
-
     // retrieve the antenna of device a
     NS_ASSERT_MSG(aPhasedArrayModel, "Antenna not found for node " << aId);
     NS_LOG_DEBUG("a node " << a->GetObject<Node>() << " antenna " << aPhasedArrayModel);
@@ -352,18 +409,129 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity(
         m_channelModel->GetParams(a, b);
 
     // retrieve the long term component
-    PhasedArrayModel::ComplexVector longTerm =
-        GetLongTerm(channelMatrix, aPhasedArrayModel, bPhasedArrayModel);
+    Ptr<LongTerm> longTerm = GetLongTerm(channelMatrix, aPhasedArrayModel, bPhasedArrayModel);
+
+    // apply the beamforming gain to a copy of the tx PSD
+    return CalcBeamformingGain(params->psd,
+                               longTerm,
+                               channelParams,
+                               a->GetVelocity(),
+                               b->GetVelocity());
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::GetRxPsdSnapshot(
+    Ptr<const MobilityModel> a,
+    Ptr<const MobilityModel> b,
+    Ptr<const PhasedArrayModel> aPhasedArrayModel,
+    Ptr<const PhasedArrayModel> bPhasedArrayModel,
+    RxPsdSnapshot& snapshot) const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(aPhasedArrayModel && bPhasedArrayModel);
+    GetRxPsdSnapshot(a,
+                     b,
+                     aPhasedArrayModel,
+                     bPhasedArrayModel,
+                     aPhasedArrayModel->GetBeamformingVector(),
+                     bPhasedArrayModel->GetBeamformingVector(),
+                     snapshot);
+}
 
-    // apply the beamforming gain
-    rxPsd = CalcBeamformingGain(rxPsd,
-                                longTerm,
-                                channelMatrix,
-                                channelParams,
-                                a->GetVelocity(),
-                                b->GetVelocity());
+void
+ThreeGppSpectrumPropagationLossModel::GetRxPsdSnapshot(
+    Ptr<const MobilityModel> a,
+    Ptr<const MobilityModel> b,
+    Ptr<const PhasedArrayModel> aPhasedArrayModel,
+    Ptr<const PhasedArrayModel> bPhasedArrayModel,
+    const PhasedArrayModel::ComplexVector& aW,
+    const PhasedArrayModel::ComplexVector& bW,
+    RxPsdSnapshot& snapshot) const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(a->GetObject<Node>()->GetId() != b->GetObject<Node>()->GetId());
+    NS_ASSERT_MSG(a->GetDistanceFrom(b) > 0.0,
+                  "The position of a and b devices cannot be the same");
+    NS_ASSERT(aPhasedArrayModel && bPhasedArrayModel);
+    NS_ASSERT(aW.GetSize() == aPhasedArrayModel->GetNumberOfElements());
+    NS_ASSERT(bW.GetSize() == bPhasedArrayModel->GetNumberOfElements());
+
+    snapshot.m_channel = m_channelModel->GetChannel(a, b, aPhasedArrayModel, bPhasedArrayModel);
+    snapshot.m_params = m_channelModel->GetParams(a, b);
+
+    // same s and u nodes as in GetLongTerm
+    bool isReverse =
+        snapshot.m_channel->IsReverse(aPhasedArrayModel->GetId(), bPhasedArrayModel->GetId());
+    snapshot.m_sW = isReverse ? bW : aW;
+    snapshot.m_uW = isReverse ? aW : bW;
+
+    // same speeds as in DoCalcRxPowerSpectralDensity
+    snapshot.m_sSpeed = a->GetVelocity();
+    snapshot.m_uSpeed = b->GetVelocity();
+    snapshot.m_time = Simulator::Now().GetSeconds();
+    snapshot.m_frequency = GetFrequency();
+}
 
-    return rxPsd;
+bool
+ThreeGppSpectrumPropagationLossModel::HaveSameBeamformingGain(const RxPsdSnapshot& first,
+                                                              const RxPsdSnapshot& second)
+{
+    if (first.m_channel != second.m_channel || first.m_params != second.m_params ||
+        first.m_channel->m_generatedTime != second.m_channel->m_generatedTime ||
+        first.m_frequency != second.m_frequency || first.m_sSpeed != second.m_sSpeed ||
+        first.m_uSpeed != second.m_uSpeed || first.m_sW != second.m_sW ||
+        first.m_uW != second.m_uW)
+    {
+        return false;
+    }
+    if (first.m_time == second.m_time)
+    {
+        return true;
+    }
+
+    // the argument of the Doppler term of each cluster is the product of a
+    // factor proportional to the time and of a sum of terms proportional to
+    // the speeds and to alpha * D, see ApplyBeamformingGain: if all these
+    // terms are zero, the Doppler term is exactly 1 at any time
+    const Vector zero(0, 0, 0);
+    if (first.m_sSpeed != zero || first.m_uSpeed != zero)
+    {
+        return false;
+    }
+    uint16_t numCluster = first.m_channel->m_channel.GetNumPages();
+    for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+        if (first.m_params->m_alpha[cIndex] * first.m_params->m_D[cIndex] != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::CalcRxPowerSpectralDensityFromSnapshot(
+    const RxPsdSnapshot& snapshot,
+    SpectrumValue& psd)
+{
+    // same computation as CalcLongTerm, without the cache
+    PhasedArrayModel::ComplexVector longTerm =
+        snapshot.m_channel->m_channel.MultiplyByLeftAndRightMatrix(snapshot.m_uW.Transpose(),
+                                                                   snapshot.m_sW);
+    std::vector<std::complex<double>> delayPhases;
+    CalcDelayPhases(psd,
+                    *snapshot.m_params,
+                    snapshot.m_channel->m_channel.GetNumPages(),
+                    delayPhases);
+    ApplyBeamformingGain(psd,
+                         longTerm,
+                         delayPhases,
+                         *snapshot.m_channel,
+                         *snapshot.m_params,
+                         snapshot.m_sSpeed,
+                         snapshot.m_uSpeed,
+                         snapshot.m_time,
+                         snapshot.m_frequency);
 }
 
 } // namespace ns3
@@ -28,6 +28,7 @@
 #include <complex.h>
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -125,6 +126,101 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
         Ptr<const PhasedArrayModel> aPhasedArrayModel,
         Ptr<const PhasedArrayModel> bPhasedArrayModel) const override;
 
+    /**
+     * Data structure that stores the inputs of the computation of the received
+     * PSD for a tx-rx pair, at a given time
+     */
+    struct RxPsdSnapshot
+    {
+        Ptr<const MatrixBasedChannelModel::ChannelMatrix>
+            m_channel; //!< the channel matrix between the two nodes
+        Ptr<const MatrixBasedChannelModel::ChannelParams>
+            m_params;                         //!< the parameters of the channel
+        PhasedArrayModel::ComplexVector m_sW; //!< the beamforming vector of the s node
+        PhasedArrayModel::ComplexVector m_uW; //!< the beamforming vector of the u node
+        Vector m_sSpeed;                      //!< the speed of the first node
+        Vector m_uSpeed;                      //!< the speed of the second node
+        double m_time{0.0};                   //!< the time of the snapshot in s
+        double m_frequency{0.0};              //!< the operating frequency in Hz
+    };
+
+    /**
+     * \brief Takes a snapshot of the inputs of DoCalcRxPowerSpectralDensity
+     *
+     * The channel is retrieved, and generated or updated if needed, exactly as
+     * in DoCalcRxPowerSpectralDensity, hence with the same random draws. The
+     * beamforming vectors are copied, so the antennas can be pointed
+     * elsewhere before the received PSD is computed with
+     * CalcRxPowerSpectralDensityFromSnapshot.
+     *
+     * \param a first node mobility model
+     * \param b second node mobility model
+     * \param aPhasedArrayModel the antenna array of the first node
+     * \param bPhasedArrayModel the antenna array of the second node
+     * \param snapshot the snapshot to fill
+     */
+    void GetRxPsdSnapshot(Ptr<const MobilityModel> a,
+                          Ptr<const MobilityModel> b,
+                          Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                          Ptr<const PhasedArrayModel> bPhasedArrayModel,
+                          RxPsdSnapshot& snapshot) const;
+
+    /**
+     * \brief Takes a snapshot of the inputs of DoCalcRxPowerSpectralDensity for
+     * given beamforming vectors
+     *
+     * Same as the other GetRxPsdSnapshot, but the beamforming vectors of the
+     * snapshot are the given ones instead of the ones currently set on the
+     * antennas. The antennas are only used to retrieve the channel. This makes
+     * it possible to probe the gain of a pair of beams without configuring the
+     * antennas.
+     *
+     * \param a first node mobility model
+     * \param b second node mobility model
+     * \param aPhasedArrayModel the antenna array of the first node
+     * \param bPhasedArrayModel the antenna array of the second node
+     * \param aW the beamforming vector of the first node
+     * \param bW the beamforming vector of the second node
+     * \param snapshot the snapshot to fill
+     */
+    void GetRxPsdSnapshot(Ptr<const MobilityModel> a,
+                          Ptr<const MobilityModel> b,
+                          Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                          Ptr<const PhasedArrayModel> bPhasedArrayModel,
+                          const PhasedArrayModel::ComplexVector& aW,
+                          const PhasedArrayModel::ComplexVector& bW,
+                          RxPsdSnapshot& snapshot) const;
+
+    /**
+     * \brief Checks whether two snapshots yield the same beamforming gain
+     *
+     * This is the case if they have the same channel realization, beamforming
+     * vectors, speeds and frequency, and either the same time or a Doppler
+     * term that does not depend on the time, i.e., static nodes and no
+     * moving scatterers. A gain computed from the first snapshot can then be
+     * used for the second, bit for bit.
+     *
+     * \param first the first snapshot
+     * \param second the second snapshot
+     * \return true if the beamforming gains are equal
+     */
+    static bool HaveSameBeamformingGain(const RxPsdSnapshot& first, const RxPsdSnapshot& second);
+
+    /**
+     * \brief Computes the received PSD from a snapshot
+     *
+     * The result is the one of DoCalcRxPowerSpectralDensity at the time of the
+     * snapshot, bit for bit. The function neither accesses the model nor
+     * copies or releases any Ptr, so it can be called concurrently from
+     * several threads, for different snapshots and PSDs, while the simulator
+     * is not running.
+     *
+     * \param snapshot the snapshot
+     * \param psd the tx PSD, replaced by the rx PSD
+     */
+    static void CalcRxPowerSpectralDensityFromSnapshot(const RxPsdSnapshot& snapshot,
+                                                       SpectrumValue& psd);
+
   private:
     /**
      * Data structure that stores the long term component for a tx-rx pair
@@ -139,6 +235,12 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
             m_sW; //!< the beamforming vector for the node s used to compute the long term
         PhasedArrayModel::ComplexVector
             m_uW; //!< the beamforming vector for the node u used to compute the long term
+        Ptr<const MatrixBasedChannelModel::ChannelParams>
+            m_params; //!< the channel params used to compute m_delayPhases
+        SpectrumModelUid_t m_spectrumModelUid{0}; //!< the spectrum model of m_delayPhases
+        std::vector<std::complex<double>>
+            m_delayPhases; //!< the delay phase of each band and cluster, see CalcDelayPhases,
+                           //!< empty unless m_cacheDelayPhases
     };
 
     /**
@@ -150,13 +252,13 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
     /**
      * Looks for the long term component in m_longTermMap. If found, checks
      * whether it has to be updated. If not found or if it has to be updated,
-     * calls the method CalcLongTerm to compute it.
+     * calls the method CalcLongTerm to compute it, in the item of the map.
      * \param channelMatrix the channel matrix
      * \param aPhasedArrayModel the antenna array of the tx device
      * \param bPhasedArrayModel the antenna array of the rx device
-     * \return vector containing the long term component for each cluster
+     * \return the item of the map, with the long term component for each cluster
      */
-    PhasedArrayModel::ComplexVector GetLongTerm(
+    Ptr<LongTerm> GetLongTerm(
         Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
         Ptr<const PhasedArrayModel> aPhasedArrayModel,
         Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
@@ -173,26 +275,64 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
         const PhasedArrayModel::ComplexVector& uW) const;
 
     /**
-     * Computes the beamforming gain and applies it to the tx PSD
+     * Computes the beamforming gain and applies it to the tx PSD. If
+     * m_cacheDelayPhases, the delay phases are computed at the first use of
+     * the long term item with the spectrum model of the PSD and the channel
+     * params, and then kept in the item, otherwise they are computed for each
+     * PSD.
      * \param txPsd the tx PSD
-     * \param longTerm the long term component
-     * \param channelMatrix The channel matrix structure
+     * \param longTerm the long term item
      * \param channelParams The channel params structure
      * \param sSpeed speed of the first node
      * \param uSpeed speed of the second node
      * \return the rx PSD
      */
     Ptr<SpectrumValue> CalcBeamformingGain(
-        Ptr<SpectrumValue> txPsd,
-        PhasedArrayModel::ComplexVector longTerm,
-        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+        Ptr<const SpectrumValue> txPsd,
+        Ptr<LongTerm> longTerm,
         Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
         const Vector& sSpeed,
         const Vector& uSpeed) const;
 
-    mutable std::unordered_map<uint64_t, Ptr<const LongTerm>>
+    /**
+     * Computes the phase exp(-j 2 pi f tau_n) of the delay of each cluster n on
+     * each band of a PSD, active or not
+     * \param psd the PSD, which only provides the bands
+     * \param channelParams The channel params structure
+     * \param numCluster the number of clusters
+     * \param delayPhases the phases, with a row of numCluster values for each band
+     */
+    static void CalcDelayPhases(const SpectrumValue& psd,
+                                const MatrixBasedChannelModel::ChannelParams& channelParams,
+                                uint16_t numCluster,
+                                std::vector<std::complex<double>>& delayPhases);
+
+    /**
+     * Applies the beamforming gain to a PSD, in place
+     * \param psd the tx PSD, replaced by the rx PSD
+     * \param longTerm the long term component
+     * \param delayPhases the delay phases, see CalcDelayPhases
+     * \param channelMatrix The channel matrix structure
+     * \param channelParams The channel params structure
+     * \param sSpeed speed of the first node
+     * \param uSpeed speed of the second node
+     * \param time the current time in s
+     * \param frequency the operating frequency in Hz
+     */
+    static void ApplyBeamformingGain(SpectrumValue& psd,
+                                     const PhasedArrayModel::ComplexVector& longTerm,
+                                     const std::vector<std::complex<double>>& delayPhases,
+                                     const MatrixBasedChannelModel::ChannelMatrix& channelMatrix,
+                                     const MatrixBasedChannelModel::ChannelParams& channelParams,
+                                     const Vector& sSpeed,
+                                     const Vector& uSpeed,
+                                     double time,
+                                     double frequency);
+
+    mutable std::unordered_map<uint64_t, Ptr<LongTerm>>
         m_longTermMap;                           //!< map containing the long term components
     Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
+    bool m_cacheDelayPhases{false}; //!< keep the delay phases in the long term items
 };
 } // namespace ns3
 
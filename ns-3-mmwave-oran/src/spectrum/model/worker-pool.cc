@@ -0,0 +1,148 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "worker-pool.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <map>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("WorkerPool");
+
+WorkerPool::WorkerPool(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    NS_ASSERT_MSG(numThreads > 0, "A pool needs at least one thread");
+    m_workers.reserve(numThreads - 1);
+    for (uint32_t i = 1; i < numThreads; i++)
+    {
+        m_workers.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    NS_LOG_FUNCTION(this);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_startCv.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+std::shared_ptr<WorkerPool>
+WorkerPool::GetShared(uint32_t numThreads)
+{
+    // only called from the event loop
+    static std::map<uint32_t, std::weak_ptr<WorkerPool>> pools;
+    std::shared_ptr<WorkerPool> pool = pools[numThreads].lock();
+    if (!pool)
+    {
+        pool = std::make_shared<WorkerPool>(numThreads);
+        pools[numThreads] = pool;
+    }
+    return pool;
+}
+
+uint32_t
+WorkerPool::GetNumThreads() const
+{
+    return m_workers.size() + 1;
+}
+
+void
+WorkerPool::ParallelFor(uint32_t numTasks, const std::function<void(uint32_t)>& task)
+{
+    NS_LOG_FUNCTION(this << numTasks);
+    if (m_workers.empty() || numTasks < 2)
+    {
+        for (uint32_t i = 0; i < numTasks; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_numTasks = numTasks;
+        m_nextTask.store(0, std::memory_order_relaxed);
+        m_busyWorkers = m_workers.size();
+        m_generation++;
+    }
+    m_startCv.notify_all();
+
+    RunTasks();
+
+    // the task outputs written by the workers are visible once they are done
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this] { return m_busyWorkers == 0; });
+    m_task = nullptr;
+    m_numTasks = 0;
+}
+
+void
+WorkerPool::WorkerLoop()
+{
+    uint64_t seenGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCv.wait(lock, [this, seenGeneration] {
+                return m_stop || m_generation != seenGeneration;
+            });
+            if (m_stop)
+            {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        RunTasks();
+
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            last = (--m_busyWorkers == 0);
+        }
+        if (last)
+        {
+            m_doneCv.notify_one();
+        }
+    }
+}
+
+void
+WorkerPool::RunTasks()
+{
+    // m_task and m_numTasks do not change until all the workers are done
+    for (uint32_t i = m_nextTask.fetch_add(1, std::memory_order_relaxed); i < m_numTasks;
+         i = m_nextTask.fetch_add(1, std::memory_order_relaxed))
+    {
+        (*m_task)(i);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,110 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup spectrum
+ *
+ * Fixed set of threads that run the independent tasks of a job, for the
+ * computations that the event loop can fan out, e.g., the generation of the
+ * channels of ThreeGppChannelModel at each update, or the received PSDs of a
+ * periodic SINR estimate.
+ *
+ * A job is run by ParallelFor, which returns when all its tasks are done. The
+ * calling thread runs tasks as well, so a pool of N threads starts N - 1
+ * workers. The tasks are taken in index order, but the thread that runs a task
+ * is not specified: a task must only write its own outputs, and must not use
+ * the simulator, the logging or the reference counts of shared objects.
+ */
+class WorkerPool
+{
+  public:
+    /**
+     * Create a pool and start its workers
+     * \param numThreads the number of threads running the tasks, caller included
+     */
+    explicit WorkerPool(uint32_t numThreads);
+
+    /**
+     * Stop and join the workers
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * Get a pool shared by all the users asking for the same number of
+     * threads, created at the first request and destroyed with its last user
+     * \param numThreads the number of threads running the tasks, caller included
+     * \return the pool
+     */
+    static std::shared_ptr<WorkerPool> GetShared(uint32_t numThreads);
+
+    /**
+     * \return the number of threads running the tasks, caller included
+     */
+    uint32_t GetNumThreads() const;
+
+    /**
+     * Run task(0), ..., task(numTasks - 1) and wait for their completion. Must
+     * not be called concurrently, nor from a task.
+     * \param numTasks the number of tasks
+     * \param task the task
+     */
+    void ParallelFor(uint32_t numTasks, const std::function<void(uint32_t)>& task);
+
+  private:
+    /**
+     * Body of the workers: wait for a job, run its tasks, repeat
+     */
+    void WorkerLoop();
+
+    /**
+     * Run the tasks of the current job until none is left
+     */
+    void RunTasks();
+
+    std::vector<std::thread> m_workers; //!< the worker threads
+
+    std::mutex m_mutex;                //!< protects the job state below
+    std::condition_variable m_startCv; //!< signals a new job, or the stop, to the workers
+    std::condition_variable m_doneCv;  //!< signals the end of the job to the caller
+    uint64_t m_generation{0};          //!< number of jobs started so far
+    uint32_t m_busyWorkers{0};         //!< workers still running the current job
+    bool m_stop{false};                //!< true when the workers have to exit
+
+    const std::function<void(uint32_t)>* m_task{nullptr}; //!< the task of the current job
+    uint32_t m_numTasks{0};                               //!< tasks of the current job
+    std::atomic<uint32_t> m_nextTask{0};                  //!< next task to be taken
+};
+
+} // namespace ns3
+
+#endif /* WORKER_POOL_H */
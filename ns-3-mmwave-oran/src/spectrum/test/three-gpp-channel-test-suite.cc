@@ -20,7 +20,9 @@
 #include "ns3/channel-condition-model.h"
 #include "ns3/config.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/double.h"
+#include "ns3/integer.h"
 #include "ns3/isotropic-antenna-model.h"
 #include "ns3/log.h"
 #include "ns3/node-container.h"
@@ -461,6 +463,8 @@ struct CheckLongTermUpdateParams
  * 2) checks if the long term component is updated when changing the beamforming
  *    vectors
  * 3) checks if the long term is updated when changing the channel matrix
+ * 4) checks if the rx PSD computed from a snapshot of the channel and of the
+ *    beamforming vectors is the same as the one of DoCalcRxPowerSpectralDensity
  */
 class ThreeGppSpectrumPropagationLossModelTest : public TestCase
 {
@@ -654,6 +658,12 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun()
                           true,
                           "The long term for the direct and the reverse channel are different");
 
+    // 4) check that the rx PSD computed from a snapshot is the same, also if the
+    // beamforming vectors change after the snapshot
+    ThreeGppSpectrumPropagationLossModel::RxPsdSnapshot snapshot;
+    lossModel->GetRxPsdSnapshot(txMob, rxMob, txAntenna, rxAntenna, snapshot);
+    PhasedArrayModel::ComplexVector txBfVectorOld = txAntenna->GetBeamformingVector();
+    PhasedArrayModel::ComplexVector rxBfVectorOld = rxAntenna->GetBeamformingVector();
     // 2) check if the long term is updated when changing the BF vector
     // change the position of the rx device and recompute the beamforming vectors
     rxMob->SetPosition(Vector(10.0, 5.0, 10.0));
@@ -661,12 +671,59 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun()
     txBfVector[0] = std::complex<double>(0.0, 0.0);
     txAntenna->SetBeamformingVector(txBfVector);
 
+    Ptr<SpectrumValue> rxPsdSnapshot = txPsd->Copy();
+    ThreeGppSpectrumPropagationLossModel::CalcRxPowerSpectralDensityFromSnapshot(snapshot,
+                                                                                 *rxPsdSnapshot);
+    NS_TEST_ASSERT_MSG_EQ(ArePsdEqual(rxPsdOld, rxPsdSnapshot),
+                          true,
+                          "The rx PSD computed from the snapshot is different");
+
     rxPsdNew =
         lossModel->DoCalcRxPowerSpectralDensity(txParams, rxMob, txMob, rxAntenna, txAntenna);
     NS_TEST_ASSERT_MSG_EQ(ArePsdEqual(rxPsdOld, rxPsdNew),
                           false,
                           "Changing the BF vectors the rx PSD does not change");
 
+    // 5) check that a snapshot with given beamforming vectors does not depend on
+    // the ones set on the antennas, and has the same gain as the one taken with
+    // these vectors set on the antennas, also later, since the nodes do not move
+    ThreeGppSpectrumPropagationLossModel::RxPsdSnapshot probe;
+    lossModel
+        ->GetRxPsdSnapshot(txMob, rxMob, txAntenna, rxAntenna, txBfVectorOld, rxBfVectorOld, probe);
+    NS_TEST_ASSERT_MSG_EQ((txAntenna->GetBeamformingVector() == txBfVector),
+                          true,
+                          "The snapshot changed the BF vector of the antenna");
+    NS_TEST_ASSERT_MSG_EQ(ThreeGppSpectrumPropagationLossModel::HaveSameBeamformingGain(snapshot,
+                                                                                        probe),
+                          true,
+                          "Same beams and channel, but different gain");
+    ThreeGppSpectrumPropagationLossModel::RxPsdSnapshot current;
+    lossModel->GetRxPsdSnapshot(txMob, rxMob, txAntenna, rxAntenna, current);
+    NS_TEST_ASSERT_MSG_EQ(ThreeGppSpectrumPropagationLossModel::HaveSameBeamformingGain(snapshot,
+                                                                                        current),
+                          false,
+                          "Different beams, but same gain");
+    Simulator::Schedule(MilliSeconds(50), [=]() {
+        ThreeGppSpectrumPropagationLossModel::RxPsdSnapshot laterProbe;
+        lossModel->GetRxPsdSnapshot(txMob,
+                                    rxMob,
+                                    txAntenna,
+                                    rxAntenna,
+                                    txBfVectorOld,
+                                    rxBfVectorOld,
+                                    laterProbe);
+        NS_TEST_ASSERT_MSG_EQ(
+            ThreeGppSpectrumPropagationLossModel::HaveSameBeamformingGain(snapshot, laterProbe),
+            true,
+            "Static nodes and same channel, but different gain");
+        Ptr<SpectrumValue> rxPsdProbe = txPsd->Copy();
+        ThreeGppSpectrumPropagationLossModel::CalcRxPowerSpectralDensityFromSnapshot(laterProbe,
+                                                                                     *rxPsdProbe);
+        NS_TEST_ASSERT_MSG_EQ(ArePsdEqual(rxPsdOld, rxPsdProbe),
+                              true,
+                              "The rx PSD computed from the later probe is different");
+    });
+
     // update rxPsdOld
     rxPsdOld = rxPsdNew;
 
@@ -682,6 +739,210 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the prefetch of the channels of ThreeGppChannelModel.
+ * It checks that the channels used are generated at each update, before they
+ * are used again, and that they do not depend on the number of threads.
+ */
+class ThreeGppChannelPrefetchTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ThreeGppChannelPrefetchTest();
+
+    /**
+     * Destructor
+     */
+    ~ThreeGppChannelPrefetchTest() override;
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+
+    /**
+     * A channel matrix returned by GetChannel
+     */
+    struct Realization
+    {
+        Time m_time;                                 //!< the time of the call
+        Time m_generatedTime;                        //!< the generation time of the matrix
+        std::vector<std::complex<double>> m_values; //!< the coefficients of the matrix
+    };
+
+    /**
+     * Get the channels between the BS and each UE, half of them from the UE side
+     * \param channelModel the channel model
+     * \param realizations the vector where the channels are stored, or nullptr
+     */
+    void GetChannels(Ptr<ThreeGppChannelModel> channelModel,
+                     std::vector<Realization>* realizations);
+
+    /**
+     * Run the scenario with prefetch
+     * \param numThreads the value of the PrefetchThreads attribute
+     * \param lead the value of the PrefetchLead attribute
+     * \return the channels returned at the checked times
+     */
+    std::vector<Realization> RunScenario(uint32_t numThreads, Time lead);
+
+    Ptr<MobilityModel> m_bsMob;                      //!< the mobility model of the BS
+    Ptr<PhasedArrayModel> m_bsAntenna;               //!< the antenna of the BS
+    std::vector<Ptr<MobilityModel>> m_ueMobs;        //!< the mobility models of the UEs
+    std::vector<Ptr<PhasedArrayModel>> m_ueAntennas; //!< the antennas of the UEs
+};
+
+ThreeGppChannelPrefetchTest::ThreeGppChannelPrefetchTest()
+    : TestCase("Check the prefetch of the channel realizations")
+{
+}
+
+ThreeGppChannelPrefetchTest::~ThreeGppChannelPrefetchTest()
+{
+}
+
+void
+ThreeGppChannelPrefetchTest::GetChannels(Ptr<ThreeGppChannelModel> channelModel,
+                                         std::vector<Realization>* realizations)
+{
+    for (uint32_t i = 0; i < m_ueMobs.size(); i++)
+    {
+        Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix =
+            i % 2 == 0
+                ? channelModel->GetChannel(m_bsMob, m_ueMobs[i], m_bsAntenna, m_ueAntennas[i])
+                : channelModel->GetChannel(m_ueMobs[i], m_bsMob, m_ueAntennas[i], m_bsAntenna);
+        if (realizations)
+        {
+            const auto& values = channelMatrix->m_channel.GetValues();
+            realizations->push_back(
+                {Simulator::Now(),
+                 channelMatrix->m_generatedTime,
+                 std::vector<std::complex<double>>(std::begin(values), std::end(values))});
+        }
+    }
+}
+
+std::vector<ThreeGppChannelPrefetchTest::Realization>
+ThreeGppChannelPrefetchTest::RunScenario(uint32_t numThreads, Time lead)
+{
+    Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+    channelModel->SetAttribute("Frequency", DoubleValue(28.0e9));
+    channelModel->SetAttribute("Scenario", StringValue("UMa"));
+    channelModel->SetAttribute("ChannelConditionModel",
+                               PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+    channelModel->SetAttribute("UpdatePeriod", TimeValue(MilliSeconds(10)));
+    channelModel->SetAttribute("PrefetchThreads", UintegerValue(numThreads));
+    channelModel->SetAttribute("PrefetchLead", TimeValue(lead));
+    channelModel->SetAttribute("PrefetchStream", IntegerValue(100));
+
+    auto createNode = [](Vector position, Vector velocity, uint32_t numElements) {
+        Ptr<ConstantVelocityMobilityModel> mobility =
+            CreateObject<ConstantVelocityMobilityModel>();
+        mobility->SetPosition(position);
+        mobility->SetVelocity(velocity);
+        Ptr<Node> node = CreateObject<Node>();
+        node->AggregateObject(mobility);
+        Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+        node->AddDevice(device);
+        device->SetNode(node);
+        Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumColumns",
+            UintegerValue(numElements),
+            "NumRows",
+            UintegerValue(numElements),
+            "AntennaElement",
+            PointerValue(CreateObject<IsotropicAntennaModel>()));
+        return std::make_pair(Ptr<MobilityModel>(mobility), antenna);
+    };
+    std::tie(m_bsMob, m_bsAntenna) = createNode(Vector(0.0, 0.0, 25.0), Vector(0.0, 0.0, 0.0), 4);
+    m_ueMobs.clear();
+    m_ueAntennas.clear();
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        auto [ueMob, ueAntenna] =
+            createNode(Vector(30.0 + 20.0 * i, 10.0 * (i % 3), 1.5), Vector(i % 4, 2.0, 0.0), 2);
+        m_ueMobs.push_back(ueMob);
+        m_ueAntennas.push_back(ueAntenna);
+    }
+
+    // the channels are first generated at 1 ms, and updated at 11, 21 and 31 ms
+    std::vector<Realization> realizations;
+    Simulator::Schedule(MilliSeconds(1),
+                        &ThreeGppChannelPrefetchTest::GetChannels,
+                        this,
+                        channelModel,
+                        nullptr);
+    for (double timeMs : {9.5, 12.0, 19.5, 22.0, 32.0})
+    {
+        Simulator::Schedule(MicroSeconds(timeMs * 1000),
+                            &ThreeGppChannelPrefetchTest::GetChannels,
+                            this,
+                            channelModel,
+                            &realizations);
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+    return realizations;
+}
+
+void
+ThreeGppChannelPrefetchTest::DoRun()
+{
+    for (Time lead : {MilliSeconds(0), MilliSeconds(3)})
+    {
+        std::vector<Realization> serial = RunScenario(1, lead);
+        std::vector<Realization> parallel = RunScenario(4, lead);
+        NS_TEST_ASSERT_MSG_EQ(serial.size(), 5 * m_ueMobs.size(), "Missing channels");
+        NS_TEST_ASSERT_MSG_EQ(parallel.size(), serial.size(), "Missing channels");
+
+        for (std::size_t i = 0; i < serial.size(); i++)
+        {
+            // the channel used is the one of the last update, i.e., generated before
+            // it is used, or the first one before the first update
+            Time updateTime = MilliSeconds(1);
+            while (updateTime + MilliSeconds(10) <= serial[i].m_time)
+            {
+                updateTime += MilliSeconds(10);
+            }
+            NS_TEST_ASSERT_MSG_EQ(serial[i].m_generatedTime,
+                                  updateTime,
+                                  "Channel not prefetched at "
+                                      << serial[i].m_time.As(Time::MS) << " with lead "
+                                      << lead.As(Time::MS));
+            NS_TEST_ASSERT_MSG_EQ(parallel[i].m_generatedTime,
+                                  updateTime,
+                                  "Channel not prefetched at "
+                                      << serial[i].m_time.As(Time::MS) << " with lead "
+                                      << lead.As(Time::MS));
+
+            NS_TEST_ASSERT_MSG_EQ(parallel[i].m_values.size(),
+                                  serial[i].m_values.size(),
+                                  "Different channel sizes");
+            for (std::size_t j = 0; j < serial[i].m_values.size(); j++)
+            {
+                NS_TEST_ASSERT_MSG_EQ(parallel[i].m_values[j],
+                                      serial[i].m_values[j],
+                                      "Different channels with 1 and 4 threads");
+            }
+        }
+
+        // the channels change at each update
+        std::size_t numUes = m_ueMobs.size();
+        for (std::size_t i = numUes; i < serial.size(); i++)
+        {
+            bool sameUpdate = serial[i].m_generatedTime == serial[i - numUes].m_generatedTime;
+            NS_TEST_ASSERT_MSG_EQ((serial[i].m_values == serial[i - numUes].m_values),
+                                  sameUpdate,
+                                  "Channel not updated at " << serial[i].m_time.As(Time::MS));
+        }
+    }
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -702,6 +963,7 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite()
     AddTestCase(new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
     AddTestCase(new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
     AddTestCase(new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+    AddTestCase(new ThreeGppChannelPrefetchTest, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
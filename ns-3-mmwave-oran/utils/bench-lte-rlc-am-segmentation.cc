@@ -0,0 +1,226 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the segmentation of the transmitter
+// of an RLC AM entity. For each offered load in 'rates' (in Gbps), 'slots'
+// slots of 'slotUs' microseconds are simulated: at the start of each slot the
+// PDCP PDUs of 'sduSize' bytes offered in the slot are queued, the MAC asks
+// for a PDU of 110% of the bytes offered in a slot, and a STATUS PDU
+// acknowledges all the PDUs transmitted. 'backlog' bytes are queued before
+// the first slot, to emulate a deep buffer. The throughput reported is the
+// rate of bytes put in RLC PDUs per second of wall time.
+// Sample usage:  ./ns3 run 'bench-lte-rlc-am-segmentation --rates=1,5,10'
+
+#include "ns3/command-line.h"
+#include "ns3/lte-mac-sap.h"
+#include "ns3/lte-pdcp-header.h"
+#include "ns3/lte-rlc-am-header.h"
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-rlc-sap.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+/// MAC SAP provider recording the PDUs of the RLC entity
+class BenchMacSapProvider : public LteMacSapProvider
+{
+  public:
+    void TransmitPdu(TransmitPduParameters params) override
+    {
+        LteRlcAmHeader rlcAmHeader;
+        params.pdu->PeekHeader(rlcAmHeader);
+        if (rlcAmHeader.IsDataPdu())
+        {
+            m_lastSn = rlcAmHeader.GetSequenceNumber();
+            m_bytes += params.pdu->GetSize();
+            ++m_pdus;
+        }
+    }
+
+    void ReportBufferStatus(ReportBufferStatusParameters params) override
+    {
+    }
+
+    SequenceNumber10 m_lastSn; //!< the SN of the last data PDU transmitted
+    uint64_t m_bytes{0};       //!< the bytes of the data PDUs transmitted
+    uint64_t m_pdus{0};        //!< the number of data PDUs transmitted
+};
+
+/// RLC SAP user of the RLC entity, which receives nothing
+class BenchRlcSapUser : public LteRlcSapUser
+{
+  public:
+    void ReceivePdcpPdu(Ptr<Packet> p) override
+    {
+    }
+};
+
+/**
+ * Queue PDCP PDUs in an RLC AM entity
+ *
+ * \param rlc the entity
+ * \param bytes the number of bytes to queue
+ * \param sduSize the size of the PDCP PDUs
+ * \param [in,out] sn the PDCP SN of the next PDCP PDU
+ */
+static void
+Enqueue(Ptr<LteRlcAm> rlc, uint64_t bytes, uint32_t sduSize, uint16_t& sn)
+{
+    LteRlcSapProvider::TransmitPdcpPduParameters params;
+    params.rnti = 1;
+    params.lcid = 3;
+    for (uint64_t queued = 0; queued < bytes; queued += sduSize)
+    {
+        LtePdcpHeader pdcpHeader;
+        pdcpHeader.SetDcBit(LtePdcpHeader::DATA_PDU);
+        pdcpHeader.SetSequenceNumber(sn);
+        sn = (sn + 1) % 4096;
+        params.pdcpPdu = Create<Packet>(sduSize - pdcpHeader.GetSerializedSize());
+        params.pdcpPdu->AddHeader(pdcpHeader);
+        rlc->GetLteRlcSapProvider()->TransmitPdcpPdu(params);
+    }
+}
+
+/**
+ * Run a slot: queue the PDCP PDUs offered, transmit a PDU and acknowledge it
+ *
+ * \param rlc the entity
+ * \param macSapProvider the MAC SAP provider of the entity
+ * \param txOpParams the transmission opportunity of the slot
+ * \param slotBytes the bytes offered in the slot
+ * \param sduSize the size of the PDCP PDUs
+ * \param [in,out] sn the PDCP SN of the next PDCP PDU
+ */
+static void
+Slot(Ptr<LteRlcAm> rlc,
+     const BenchMacSapProvider* macSapProvider,
+     LteMacSapUser::TxOpportunityParameters txOpParams,
+     uint64_t slotBytes,
+     uint32_t sduSize,
+     uint16_t* sn)
+{
+    Enqueue(rlc, slotBytes, sduSize, *sn);
+    rlc->GetLteMacSapUser()->NotifyTxOpportunity(txOpParams);
+
+    LteRlcAmHeader status;
+    status.SetControlPdu(LteRlcAmHeader::STATUS_PDU);
+    status.SetAckSn(macSapProvider->m_lastSn + 1);
+    LteMacSapUser::ReceivePduParameters rxPduParams;
+    rxPduParams.p = Create<Packet>();
+    rxPduParams.p->AddHeader(status);
+    rxPduParams.rnti = 1;
+    rxPduParams.lcid = 3;
+    rlc->GetLteMacSapUser()->ReceivePdu(rxPduParams);
+}
+
+/**
+ * Run the benchmark at an offered load
+ *
+ * \param rateGbps the offered load, in Gbps
+ * \param slots the number of slots
+ * \param slotUs the duration of a slot, in microseconds
+ * \param sduSize the size of the PDCP PDUs
+ * \param backlog the bytes queued before the first slot
+ */
+static void
+Run(double rateGbps, uint32_t slots, uint32_t slotUs, uint32_t sduSize, uint64_t backlog)
+{
+    uint64_t slotBytes = static_cast<uint64_t>(rateGbps * 1e9 / 8 * slotUs * 1e-6);
+    LteMacSapUser::TxOpportunityParameters txOpParams;
+    txOpParams.bytes = static_cast<uint32_t>(slotBytes * 1.1);
+    txOpParams.layer = 0;
+    txOpParams.harqId = 0;
+    txOpParams.componentCarrierId = 0;
+    txOpParams.rnti = 1;
+    txOpParams.lcid = 3;
+
+    BenchMacSapProvider macSapProvider;
+    BenchRlcSapUser rlcSapUser;
+    Ptr<LteRlcAm> rlc = CreateObject<LteRlcAm>();
+    rlc->SetAttribute("MaxTxBufferSize",
+                      UintegerValue(backlog + (slots + 1) * (slotBytes + sduSize)));
+    rlc->SetRnti(1);
+    rlc->SetLcId(3);
+    rlc->SetLteMacSapProvider(&macSapProvider);
+    rlc->SetLteRlcSapUser(&rlcSapUser);
+    rlc->SetAttribute("BufferSizeFilename", StringValue("/dev/null"));
+
+    uint16_t sn = 0;
+    Enqueue(rlc, backlog, sduSize, sn);
+
+    for (uint32_t slot = 0; slot < slots; ++slot)
+    {
+        Simulator::Schedule(MicroSeconds(slot * slotUs),
+                            &Slot,
+                            rlc,
+                            &macSapProvider,
+                            txOpParams,
+                            slotBytes,
+                            sduSize,
+                            &sn);
+    }
+    Simulator::Stop(MicroSeconds(slots * slotUs));
+
+    SystemWallClockMs time;
+    time.Start();
+    Simulator::Run();
+    int64_t ms = time.End();
+
+    std::cout << std::setw(6) << rateGbps << " Gbps\t" << ms << " ms\t" << macSapProvider.m_pdus
+              << " PDUs\t" << macSapProvider.m_bytes << " bytes\t"
+              << (ms > 0 ? macSapProvider.m_bytes * 8.0 / ms / 1e6 : 0) << " Gbps segmented"
+              << std::endl;
+
+    rlc->Dispose();
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string rates = "1,5,10";
+    uint32_t slots = 8000;
+    uint32_t slotUs = 125;
+    uint32_t sduSize = 1400;
+    uint64_t backlog = 10000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("rates", "comma separated offered loads, in Gbps", rates);
+    cmd.AddValue("slots", "number of slots", slots);
+    cmd.AddValue("slotUs", "duration of a slot, in microseconds", slotUs);
+    cmd.AddValue("sduSize", "size of the PDCP PDUs", sduSize);
+    cmd.AddValue("backlog", "number of bytes queued before the first slot", backlog);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-lte-rlc-am-segmentation with slots=" << slots
+              << " slotUs=" << slotUs << " sduSize=" << sduSize << " backlog=" << backlog
+              << std::endl;
+
+    std::istringstream rateStream(rates);
+    std::string rate;
+    while (std::getline(rateStream, rate, ','))
+    {
+        Run(std::stod(rate), slots, slotUs, sduSize, backlog);
+    }
+    return 0;
+}
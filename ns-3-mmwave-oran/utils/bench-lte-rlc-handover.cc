@@ -0,0 +1,452 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the wall time of the data forwarding
+// step of a handover, as run by UeManager::ForwardRlcBuffers in the source
+// eNB: the buffers of an RLC AM entity holding 'bytes' bytes of PDCP PDUs of
+// 'sduSize' bytes, of which 'txed' were transmitted and not acknowledged, are
+// detached, the PDCP headers and the tags of the SDUs are removed, and the
+// SDUs are sent over X2. The X2 send is timed both as a single
+// EpcX2SapProvider::SendUeDataBatch and as one SendUeData per SDU. The X2-U
+// socket of EpcX2 only counts the packets, so that the time of the UDP/IP
+// stack, which is the same in both cases, is not included.
+// Sample usage:  ./ns3 run 'bench-lte-rlc-handover --bytes=10000000'
+
+#include "ns3/command-line.h"
+#include "ns3/epc-x2-sap.h"
+#include "ns3/epc-x2.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/lte-mac-sap.h"
+#include "ns3/lte-pdcp-header.h"
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-rlc-sap.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <deque>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/// MAC SAP provider dropping the PDUs of the RLC entity
+class BenchMacSapProvider : public LteMacSapProvider
+{
+  public:
+    void TransmitPdu(TransmitPduParameters params) override
+    {
+        ++m_pdus;
+    }
+
+    void ReportBufferStatus(ReportBufferStatusParameters params) override
+    {
+    }
+
+    uint32_t m_pdus{0}; //!< the number of PDUs transmitted
+};
+
+/// RLC SAP user of the RLC entity, which receives nothing
+class BenchRlcSapUser : public LteRlcSapUser
+{
+  public:
+    void ReceivePdcpPdu(Ptr<Packet> p) override
+    {
+    }
+};
+
+/// UDP socket counting the packets sent, without sending them
+class BenchSocket : public Socket
+{
+  public:
+    /**
+     * \param node the node of the socket
+     */
+    BenchSocket(Ptr<Node> node)
+        : m_node(node)
+    {
+    }
+
+    int SendTo(Ptr<Packet> p, uint32_t flags, const Address& toAddress) override
+    {
+        ++m_packets;
+        m_bytes += p->GetSize();
+        return p->GetSize();
+    }
+
+    int Send(Ptr<Packet> p, uint32_t flags) override
+    {
+        return SendTo(p, flags, Address());
+    }
+
+    enum Socket::SocketErrno GetErrno() const override
+    {
+        return ERROR_NOTERROR;
+    }
+
+    enum Socket::SocketType GetSocketType() const override
+    {
+        return NS3_SOCK_DGRAM;
+    }
+
+    Ptr<Node> GetNode() const override
+    {
+        return m_node;
+    }
+
+    int Bind(const Address& address) override
+    {
+        return 0;
+    }
+
+    int Bind() override
+    {
+        return 0;
+    }
+
+    int Bind6() override
+    {
+        return 0;
+    }
+
+    int Close() override
+    {
+        return 0;
+    }
+
+    int ShutdownSend() override
+    {
+        return 0;
+    }
+
+    int ShutdownRecv() override
+    {
+        return 0;
+    }
+
+    int Connect(const Address& address) override
+    {
+        return 0;
+    }
+
+    int Listen() override
+    {
+        return 0;
+    }
+
+    uint32_t GetTxAvailable() const override
+    {
+        return UINT32_MAX;
+    }
+
+    uint32_t GetRxAvailable() const override
+    {
+        return 0;
+    }
+
+    Ptr<Packet> Recv(uint32_t maxSize, uint32_t flags) override
+    {
+        return nullptr;
+    }
+
+    Ptr<Packet> RecvFrom(uint32_t maxSize, uint32_t flags, Address& fromAddress) override
+    {
+        return nullptr;
+    }
+
+    int GetSockName(Address& address) const override
+    {
+        return 0;
+    }
+
+    int GetPeerName(Address& address) const override
+    {
+        return 0;
+    }
+
+    bool SetAllowBroadcast(bool allowBroadcast) override
+    {
+        return false;
+    }
+
+    bool GetAllowBroadcast() const override
+    {
+        return false;
+    }
+
+    uint64_t m_packets{0}; //!< the number of packets sent
+    uint64_t m_bytes{0};   //!< the bytes of the packets sent
+
+  private:
+    Ptr<Node> m_node; //!< the node of the socket
+};
+
+/// UDP socket factory of the node of EpcX2, creating BenchSocket instances
+class BenchUdpSocketFactory : public UdpSocketFactory
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::BenchUdpSocketFactory")
+                                .SetParent<UdpSocketFactory>()
+                                .AddConstructor<BenchUdpSocketFactory>();
+        return tid;
+    }
+
+    Ptr<Socket> CreateSocket() override
+    {
+        Ptr<BenchSocket> socket = CreateObject<BenchSocket>(GetObject<Node>());
+        m_sockets.push_back(socket);
+        return socket;
+    }
+
+    /**
+     * \return the number of packets sent by the sockets created
+     */
+    uint64_t GetPackets() const
+    {
+        uint64_t packets = 0;
+        for (const auto& socket : m_sockets)
+        {
+            packets += socket->m_packets;
+        }
+        return packets;
+    }
+
+    /**
+     * \return the bytes of the packets sent by the sockets created
+     */
+    uint64_t GetBytes() const
+    {
+        uint64_t bytes = 0;
+        for (const auto& socket : m_sockets)
+        {
+            bytes += socket->m_bytes;
+        }
+        return bytes;
+    }
+
+  private:
+    std::vector<Ptr<BenchSocket>> m_sockets; //!< the sockets created
+};
+
+/**
+ * Fill an RLC AM entity and transmit some of its PDUs
+ *
+ * \param rlc the entity
+ * \param bytes the number of bytes of PDCP PDUs to buffer
+ * \param sduSize the size of the PDCP PDUs
+ * \param txed the number of PDUs to transmit
+ */
+static void
+FillRlc(Ptr<LteRlcAm> rlc, uint32_t bytes, uint32_t sduSize, uint32_t txed)
+{
+    LteRlcSapProvider::TransmitPdcpPduParameters params;
+    params.rnti = 1;
+    params.lcid = 3;
+    for (uint32_t sn = 0; sn * sduSize < bytes; ++sn)
+    {
+        LtePdcpHeader pdcpHeader;
+        pdcpHeader.SetDcBit(LtePdcpHeader::DATA_PDU);
+        pdcpHeader.SetSequenceNumber(sn % 4096);
+        params.pdcpPdu = Create<Packet>(sduSize - pdcpHeader.GetSerializedSize());
+        params.pdcpPdu->AddHeader(pdcpHeader);
+        rlc->GetLteRlcSapProvider()->TransmitPdcpPdu(params);
+    }
+
+    LteMacSapUser::TxOpportunityParameters txOpParams;
+    txOpParams.bytes = sduSize + 4; // a whole SDU and the RLC header
+    txOpParams.layer = 0;
+    txOpParams.harqId = 0;
+    txOpParams.componentCarrierId = 0;
+    txOpParams.rnti = 1;
+    txOpParams.lcid = 3;
+    for (uint32_t i = 0; i < txed; ++i)
+    {
+        rlc->GetLteMacSapUser()->NotifyTxOpportunity(txOpParams);
+    }
+}
+
+/**
+ * Forward the buffers of an RLC AM entity, as UeManager::ForwardRlcBuffers
+ *
+ * \param rlc the entity
+ * \param [out] batch the SDUs forwarded over X2
+ * \return the number of bytes detached from the entity
+ */
+static uint32_t
+ForwardRlc(Ptr<LteRlcAm> rlc, EpcX2SapProvider::UeDataBatchParams& batch)
+{
+    std::deque<Ptr<Packet>> forwardingBuffer;
+    uint32_t bytes = rlc->DetachBuffers(forwardingBuffer);
+    batch.ueData.reserve(forwardingBuffer.size());
+    while (!forwardingBuffer.empty())
+    {
+        Ptr<Packet> rlcSdu = std::move(forwardingBuffer.front());
+        forwardingBuffer.pop_front();
+        LtePdcpHeader pdcpHeader;
+        if (rlcSdu->GetSize() >= 3)
+        {
+            rlcSdu->PeekHeader(pdcpHeader);
+            if (pdcpHeader.GetDcBit() == 1)
+            {
+                rlcSdu->RemoveAllPacketTags();
+                rlcSdu->RemoveHeader(pdcpHeader);
+                batch.ueData.push_back(rlcSdu);
+            }
+        }
+    }
+    return bytes;
+}
+
+/**
+ * Create an RLC AM entity, fill it and forward its buffers
+ *
+ * \param macSapProvider the MAC SAP provider of the entity
+ * \param rlcSapUser the RLC SAP user of the entity
+ * \param bytes the number of bytes of PDCP PDUs to buffer
+ * \param sduSize the size of the PDCP PDUs
+ * \param txed the number of PDUs to transmit
+ * \param [out] batch the SDUs forwarded over X2
+ * \param [out] detached the number of bytes detached from the entity
+ * \return the wall time of the forwarding, in ms
+ */
+static int64_t
+FillAndForwardRlc(LteMacSapProvider* macSapProvider,
+                  LteRlcSapUser* rlcSapUser,
+                  uint32_t bytes,
+                  uint32_t sduSize,
+                  uint32_t txed,
+                  EpcX2SapProvider::UeDataBatchParams& batch,
+                  uint32_t& detached)
+{
+    Ptr<LteRlcAm> rlc = CreateObject<LteRlcAm>();
+    rlc->SetAttribute("MaxTxBufferSize", UintegerValue(2 * bytes));
+    rlc->SetRnti(1);
+    rlc->SetLcId(3);
+    rlc->SetLteMacSapProvider(macSapProvider);
+    rlc->SetLteRlcSapUser(rlcSapUser);
+    FillRlc(rlc, bytes, sduSize, txed);
+
+    SystemWallClockMs time;
+    time.Start();
+    detached = ForwardRlc(rlc, batch);
+    int64_t ms = time.End();
+    rlc->Dispose();
+    return ms;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t bytes = 10000000;
+    uint32_t sduSize = 1400;
+    uint32_t txed = 512;
+    uint32_t runs = 5;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("bytes", "number of bytes buffered in RLC", bytes);
+    cmd.AddValue("sduSize", "size of the PDCP PDUs", sduSize);
+    cmd.AddValue("txed", "number of PDUs transmitted and not acknowledged", txed);
+    cmd.AddValue("runs", "number of handovers", runs);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-lte-rlc-handover with bytes=" << bytes << " sduSize=" << sduSize
+              << " txed=" << txed << std::endl;
+
+    BenchMacSapProvider macSapProvider;
+    BenchRlcSapUser rlcSapUser;
+
+    // the source eNB, with an X2 interface towards the cell 2
+    Ptr<Node> enb = CreateObject<Node>();
+    Ptr<BenchUdpSocketFactory> socketFactory = CreateObject<BenchUdpSocketFactory>();
+    enb->AggregateObject(socketFactory);
+    Ptr<EpcX2> x2 = CreateObject<EpcX2>();
+    enb->AggregateObject(x2);
+    x2->AddX2Interface(1, Ipv4Address("10.0.0.1"), 2, Ipv4Address("10.0.0.2"));
+    EpcX2SapProvider* x2SapProvider = x2->GetEpcX2SapProvider();
+
+    int64_t detachMs = 0;
+    int64_t loopMs = 0;
+    int64_t batchMs = 0;
+    for (uint32_t run = 0; run < runs; ++run)
+    {
+        // one SendUeData per SDU
+        EpcX2SapProvider::UeDataBatchParams loop;
+        uint32_t detached;
+        detachMs += FillAndForwardRlc(&macSapProvider,
+                                      &rlcSapUser,
+                                      bytes,
+                                      sduSize,
+                                      txed,
+                                      loop,
+                                      detached);
+        uint64_t packets = socketFactory->GetPackets();
+        uint64_t sent = socketFactory->GetBytes();
+        SystemWallClockMs time;
+        time.Start();
+        EpcX2SapProvider::UeDataParams params;
+        params.sourceCellId = 1;
+        params.targetCellId = 2;
+        params.gtpTeid = 1;
+        for (const Ptr<Packet>& packet : loop.ueData)
+        {
+            params.ueData = packet;
+            x2SapProvider->SendUeData(params);
+        }
+        int64_t ms = time.End();
+        loopMs += ms;
+        std::cout << "loop:  " << ms << " ms\t" << socketFactory->GetPackets() - packets
+                  << " packets, " << socketFactory->GetBytes() - sent << " bytes sent, "
+                  << detached << " bytes detached" << std::endl;
+
+        // a single SendUeDataBatch
+        EpcX2SapProvider::UeDataBatchParams batch;
+        detachMs += FillAndForwardRlc(&macSapProvider,
+                                      &rlcSapUser,
+                                      bytes,
+                                      sduSize,
+                                      txed,
+                                      batch,
+                                      detached);
+        batch.sourceCellId = 1;
+        batch.targetCellId = 2;
+        batch.gtpTeid = 1;
+        packets = socketFactory->GetPackets();
+        sent = socketFactory->GetBytes();
+        time.Start();
+        x2SapProvider->SendUeDataBatch(batch);
+        ms = time.End();
+        batchMs += ms;
+        std::cout << "batch: " << ms << " ms\t" << socketFactory->GetPackets() - packets
+                  << " packets, " << socketFactory->GetBytes() - sent << " bytes sent, "
+                  << detached << " bytes detached" << std::endl;
+    }
+    std::cout << static_cast<double>(detachMs) / (2 * runs) << " ms per detach, "
+              << static_cast<double>(loopMs) / runs << " ms per SendUeData loop, "
+              << static_cast<double>(batchMs) / runs << " ms per SendUeDataBatch" << std::endl;
+
+    x2->Dispose();
+    enb->Dispose();
+    Simulator::Destroy();
+    return 0;
+}
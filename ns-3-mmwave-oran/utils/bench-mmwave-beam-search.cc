@@ -0,0 +1,211 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the codebook beam search of
+// MmWaveCodebookBeamforming, i.e., the selection of the best beam pair between
+// an eNB and a UE over a 3GPP UMa channel, with the batched search and with the
+// exhaustive search over the received PSDs of all the beam pairs. The eNB uses
+// each of the shipped codebooks in turn, the UE the one given by --ue.
+// Sample usage:  ./ns3 run 'bench-mmwave-beam-search --n=20 --ue=4x4'
+
+#include "ns3/boolean.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/command-line.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/file-beamforming-codebook.h"
+#include "ns3/isotropic-antenna-model.h"
+#include "ns3/mmwave-beamforming-model.h"
+#include "ns3/mmwave-phy-mac-common.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/three-gpp-channel-model.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/uinteger.h"
+#include "ns3/uniform-planar-array.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <string>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * Create a device with an array and a codebook beamforming model
+ * \param array the size of the array and codebook, e.g., "8x8"
+ * \param codebookDir the directory of the codebook files
+ * \param position the position of the device
+ * \param splm the channel
+ * \param batched whether the beamforming model uses the batched search
+ * \return the beamforming model
+ */
+static Ptr<MmWaveCodebookBeamforming>
+CreateDevice(std::string array,
+             std::string codebookDir,
+             Vector position,
+             Ptr<ThreeGppSpectrumPropagationLossModel> splm,
+             bool batched)
+{
+    Ptr<ConstantVelocityMobilityModel> mobility = CreateObject<ConstantVelocityMobilityModel>();
+    mobility->SetPosition(position);
+    mobility->SetVelocity(Vector(0, 3, 0));
+    Ptr<Node> node = CreateObject<Node>();
+    node->AggregateObject(mobility);
+    Ptr<NetDevice> device = CreateObject<SimpleNetDevice>();
+    device->SetNode(node);
+    node->AddDevice(device);
+
+    std::size_t x = array.find('x');
+    Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray>(
+        "NumRows",
+        UintegerValue(std::stoul(array.substr(0, x))),
+        "NumColumns",
+        UintegerValue(std::stoul(array.substr(x + 1))),
+        "AntennaElement",
+        PointerValue(CreateObject<IsotropicAntennaModel>()));
+
+    ObjectFactory codebookFactory;
+    codebookFactory.SetTypeId(FileBeamformingCodebook::GetTypeId());
+    codebookFactory.Set("CodebookFilename", StringValue(codebookDir + "/" + array + ".txt"));
+
+    // the beam pair is searched again at each call
+    Ptr<MmWaveCodebookBeamforming> bfModel = CreateObjectWithAttributes<MmWaveCodebookBeamforming>(
+        "Device",
+        PointerValue(device),
+        "Antenna",
+        PointerValue(antenna),
+        "PhasedArraySpectrumPropagationLossModel",
+        PointerValue(splm),
+        "MmWavePhyMacCommon",
+        PointerValue(CreateObject<MmWavePhyMacCommon>()),
+        "UpdatePeriod",
+        TimeValue(NanoSeconds(1)),
+        "BatchedSearch",
+        BooleanValue(batched));
+    bfModel->SetBeamformingCodebookFactory(codebookFactory);
+    bfModel->Initialize();
+    return bfModel;
+}
+
+/**
+ * Run a sequence of beam searches between an eNB and a UE
+ * \param enbArray the size of the eNB array
+ * \param ueArray the size of the UE array
+ * \param codebookDir the directory of the codebook files
+ * \param n the number of searches
+ * \param batched whether the batched search is used
+ * \return the elapsed time in ms
+ */
+static uint64_t
+RunBeamSearch(std::string enbArray,
+              std::string ueArray,
+              std::string codebookDir,
+              uint32_t n,
+              bool batched)
+{
+    Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+    channelModel->SetAttribute("Frequency", DoubleValue(28e9));
+    channelModel->SetAttribute("Scenario", StringValue("UMa"));
+    channelModel->SetAttribute("ChannelConditionModel",
+                               PointerValue(CreateObject<ThreeGppUmaChannelConditionModel>()));
+    Ptr<ThreeGppSpectrumPropagationLossModel> splm =
+        CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    splm->SetChannelModel(channelModel);
+
+    Ptr<MmWaveCodebookBeamforming> enbBfModel =
+        CreateDevice(enbArray, codebookDir, Vector(0, 0, 25), splm, batched);
+    Ptr<MmWaveCodebookBeamforming> ueBfModel =
+        CreateDevice(ueArray, codebookDir, Vector(80, 40, 1.5), splm, batched);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Simulator::Schedule(MicroSeconds(i),
+                            &MmWaveCodebookBeamforming::SetBeamformingVectorForDevice,
+                            enbBfModel,
+                            ueBfModel->GetDevice(),
+                            ueBfModel->GetAntenna());
+    }
+
+    SystemWallClockMs time;
+    time.Start();
+    Simulator::Run();
+    uint64_t deltaMs = time.End();
+    Simulator::Destroy();
+    return deltaMs;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 20;
+    std::string ueArray = "4x4";
+    std::string codebookDir = "src/mmwave/model/Codebooks";
+    bool exhaustive = true;
+    uint32_t minIterations = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the codebook beam search");
+    cmd.AddValue("n", "number of beam searches per run", n);
+    cmd.AddValue("ue", "size of the UE array and codebook", ueArray);
+    cmd.AddValue("codebook-dir", "directory of the codebook files", codebookDir);
+    cmd.AddValue("exhaustive", "also run the exhaustive search", exhaustive);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-mmwave-beam-search with n=" << n << " ue=" << ueArray
+              << std::endl;
+
+    for (std::string enbArray : {"1x1",
+                                 "1x2",
+                                 "2x1",
+                                 "1x4",
+                                 "4x1",
+                                 "2x2",
+                                 "1x8",
+                                 "8x1",
+                                 "4x4",
+                                 "4x8",
+                                 "8x4",
+                                 "8x8"})
+    {
+        for (bool batched : {true, false})
+        {
+            if (!batched && !exhaustive)
+            {
+                continue;
+            }
+            uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+            for (uint32_t i = 0; i < minIterations; i++)
+            {
+                minDelay =
+                    std::min(minDelay, RunBeamSearch(enbArray, ueArray, codebookDir, n, batched));
+            }
+            double usPerSearch = minDelay * 1e3 / n;
+            std::cout << usPerSearch << " us/search"
+                      << " (" << minDelay << " ms elapsed)\teNB " << enbArray << " UE " << ueArray
+                      << (batched ? " batched" : " exhaustive") << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the per-TB cost of the EESM error
+// models, i.e., of MmWaveEesmErrorModel::GetTbDecodificationStats, for the
+// MCS Table1/Table2 and the IR/CC HARQ variants. Each TB spans 'rbs' RBs with
+// a pseudo-random frequency selective SINR; the "first tx" runs have an empty
+// HARQ history, while the "retx" runs combine the TB with a previous one.
+// Sample usage:  ./ns3 run 'bench-mmwave-eesm --n=100000 --rbs=139'
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/mmwave-eesm-cc-t1.h"
+#include "ns3/mmwave-eesm-cc-t2.h"
+#include "ns3/mmwave-eesm-ir-t1.h"
+#include "ns3/mmwave-eesm-ir-t2.h"
+#include "ns3/object-factory.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * A TB to be decoded
+ */
+struct BenchTb
+{
+    uint32_t m_vector; //!< index of the SINR vector
+    uint8_t m_mcs;     //!< MCS
+    uint32_t m_size;   //!< TB size in bytes
+};
+
+/**
+ * Build a set of pseudo-random SINR vectors, with a mean between -5 and 30 dB
+ * and a frequency selective fading of +-10 dB
+ * \param count the number of vectors
+ * \param rbs the number of RBs
+ * \return the SINR vectors
+ */
+static std::vector<SpectrumValue>
+MakeSinrVectors(uint32_t count, uint32_t rbs)
+{
+    Bands bands;
+    for (uint32_t rb = 0; rb < rbs; ++rb)
+    {
+        BandInfo band;
+        band.fl = rb;
+        band.fc = rb + 0.5;
+        band.fh = rb + 1;
+        bands.push_back(band);
+    }
+    Ptr<const SpectrumModel> model = Create<SpectrumModel>(bands);
+
+    std::vector<SpectrumValue> vectors;
+    uint32_t state = 12345;
+    for (uint32_t v = 0; v < count; ++v)
+    {
+        SpectrumValue sinr(model);
+        double meanDb = -5 + 35.0 * v / count;
+        for (auto it = sinr.ValuesBegin(); it != sinr.ValuesEnd(); ++it)
+        {
+            state = state * 1103515245 + 12345;
+            *it = std::pow(10, (meanDb + ((state >> 8) % 2001) / 100.0 - 10) / 10);
+        }
+        vectors.push_back(sinr);
+    }
+    return vectors;
+}
+
+/**
+ * Decode a sequence of TBs
+ * \param type the type of the error model
+ * \param vectors the SINR vectors
+ * \param rbMap the RB map of the TBs
+ * \param tbs the TBs
+ * \param retx whether the TBs are retransmissions of a TB on the previous SINR vector
+ * \return the elapsed time in ms
+ */
+static uint64_t
+RunEesm(TypeId type,
+        const std::vector<SpectrumValue>& vectors,
+        const std::vector<int>& rbMap,
+        const std::vector<BenchTb>& tbs,
+        bool retx)
+{
+    ObjectFactory factory;
+    factory.SetTypeId(type);
+
+    // the histories are built before the timed loop
+    std::vector<MmWaveErrorModel::MmWaveErrorModelHistory> histories(tbs.size());
+    if (retx)
+    {
+        Ptr<MmWaveErrorModel> em = DynamicCast<MmWaveErrorModel>(factory.Create());
+        for (uint32_t i = 0; i < tbs.size(); ++i)
+        {
+            const SpectrumValue& previous = vectors[(tbs[i].m_vector + 1) % vectors.size()];
+            histories[i].push_back(em->GetTbDecodificationStats(previous,
+                                                                rbMap,
+                                                                tbs[i].m_size,
+                                                                tbs[i].m_mcs,
+                                                                {}));
+        }
+    }
+
+    double sum = 0;
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i = 0; i < tbs.size(); ++i)
+    {
+        // as in MmWaveSpectrumPhy, one error model is created for each TB
+        Ptr<MmWaveErrorModel> em = DynamicCast<MmWaveErrorModel>(factory.Create());
+        sum += em->GetTbDecodificationStats(vectors[tbs[i].m_vector],
+                                            rbMap,
+                                            tbs[i].m_size,
+                                            tbs[i].m_mcs,
+                                            histories[i])
+                   ->m_tbler;
+    }
+    uint64_t deltaMs = time.End();
+    NS_ABORT_MSG_UNLESS(sum >= 0 && sum <= tbs.size(), "invalid TBLER");
+    return deltaMs;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 100000;
+    uint32_t rbs = 139;
+    uint32_t numVectors = 1000;
+    uint32_t minIterations = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the EESM error models");
+    cmd.AddValue("n", "number of decoded TBs per run", n);
+    cmd.AddValue("rbs", "number of RBs of each TB", rbs);
+    cmd.AddValue("vectors", "number of distinct SINR vectors", numVectors);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-mmwave-eesm with n=" << n << " rbs=" << rbs << std::endl;
+
+    std::vector<SpectrumValue> vectors = MakeSinrVectors(numVectors, rbs);
+    std::vector<int> rbMap(rbs);
+    for (uint32_t rb = 0; rb < rbs; ++rb)
+    {
+        rbMap[rb] = rb;
+    }
+
+    for (TypeId type : {MmWaveEesmIrT1::GetTypeId(),
+                        MmWaveEesmIrT2::GetTypeId(),
+                        MmWaveEesmCcT1::GetTypeId(),
+                        MmWaveEesmCcT2::GetTypeId()})
+    {
+        ObjectFactory factory;
+        factory.SetTypeId(type);
+        Ptr<MmWaveErrorModel> em = DynamicCast<MmWaveErrorModel>(factory.Create());
+
+        // a TB over all the RBs of 12 OFDM symbols, with a pseudo-random MCS
+        std::vector<BenchTb> tbs(n);
+        uint32_t state = 54321;
+        for (auto& tb : tbs)
+        {
+            state = state * 1103515245 + 12345;
+            tb.m_vector = (state >> 8) % numVectors;
+            tb.m_mcs = (state >> 4) % (em->GetMaxMcs() + 1);
+            tb.m_size = em->GetPayloadSize(10, tb.m_mcs, rbs * 12, MmWaveErrorModel::DL);
+        }
+
+        for (bool retx : {false, true})
+        {
+            uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+            for (uint32_t i = 0; i < minIterations; i++)
+            {
+                minDelay = std::min(minDelay, RunEesm(type, vectors, rbMap, tbs, retx));
+            }
+            double nsPerTb = minDelay * 1e6 / n;
+            std::cout << nsPerTb << " ns/TB"
+                      << " (" << minDelay << " ms elapsed)\t" << type.GetName()
+                      << (retx ? " retx" : " first tx") << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,340 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the per-slot cost of
+// MmWaveFlexTtiMacScheduler (or of the FlexTTI scheduler of type 'scheduler'),
+// driven through its SAPs as by MmWaveEnbMac, for
+// cells of 10, 50 and 200 UEs (or 'ues' UEs). Every slot, a pseudo-random
+// subset of the UEs reports its DL RLC buffers, its BSR and its DL CQI, the
+// UL TBs of the previous slot get their UL CQI, and the HARQ feedback of the
+// TBs of the previous slot is a NACK with probability 'nack'. The UL MCS is
+// computed from the UL CQI with the EESM of MmWaveAmc, which dominates the
+// cost of a slot: with '--ulCqi=false' there is none, and the UL MCS is 0.
+// The digest printed with each result identifies the scheduling decisions:
+// a change of the scheduler that is not meant to alter them must keep it.
+// Sample usage:  ./ns3 run 'bench-mmwave-flex-tti-scheduler --slots=20000'
+
+#include "ns3/command-line.h"
+#include "ns3/mmwave-flex-tti-mac-scheduler.h"
+#include "ns3/object-factory.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * Scheduler SAP user keeping the last slot allocation, and a digest of all
+ * the allocations
+ */
+class BenchSchedSapUser : public MmWaveMacSchedSapUser
+{
+  public:
+    void SchedConfigInd(const struct SchedConfigIndParameters& params) override
+    {
+        m_last = params;
+        for (const auto& tti : params.m_slotAllocInfo.m_ttiAllocInfo)
+        {
+            Add(tti.m_ttiIdx);
+            Add(tti.m_tddMode);
+            Add(tti.m_ttiType);
+            Add(tti.m_dci.m_rnti);
+            Add(tti.m_dci.m_format);
+            Add(tti.m_dci.m_symStart);
+            Add(tti.m_dci.m_numSym);
+            Add(tti.m_dci.m_mcs);
+            Add(tti.m_dci.m_tbSize);
+            Add(tti.m_dci.m_ndi);
+            Add(tti.m_dci.m_rv);
+            Add(tti.m_dci.m_harqProcess);
+            for (const auto& pdu : tti.m_rlcPduInfo)
+            {
+                Add(pdu.m_lcid);
+                Add(pdu.m_size);
+            }
+        }
+    }
+
+    SchedConfigIndParameters m_last; //!< the last slot allocation
+    uint64_t m_digest{14695981039346656037ULL}; //!< FNV-1a of the allocations
+
+  private:
+    /**
+     * Add a value to the digest
+     * \param value the value
+     */
+    void Add(uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            m_digest = (m_digest ^ ((value >> (8 * i)) & 0xff)) * 1099511628211ULL;
+        }
+    }
+};
+
+/**
+ * Scheduler CSCHED SAP user ignoring the confirmations
+ */
+class BenchCschedSapUser : public MmWaveMacCschedSapUser
+{
+  public:
+    void CschedCellConfigCnf(const struct CschedCellConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigCnf(const struct CschedUeConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcConfigCnf(const struct CschedLcConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcReleaseCnf(const struct CschedLcReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeReleaseCnf(const struct CschedUeReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigUpdateInd(const struct CschedUeConfigUpdateIndParameters& params) override
+    {
+    }
+
+    void CschedCellConfigUpdateInd(
+        const struct CschedCellConfigUpdateIndParameters& params) override
+    {
+    }
+};
+
+/**
+ * A linear congruential generator, so that the workload is the same on all
+ * the platforms
+ */
+class BenchRandom
+{
+  public:
+    /**
+     * \param bound the bound of the value
+     * \return a pseudo-random value in [0, bound)
+     */
+    uint32_t Next(uint32_t bound)
+    {
+        m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (m_state >> 33) % bound;
+    }
+
+  private:
+    uint64_t m_state{12345}; //!< the state of the generator
+};
+
+/**
+ * Run the scheduler for a number of slots
+ * \param numUes the number of UEs of the cell
+ * \param type the TypeId name of the scheduler
+ * \param slots the number of slots
+ * \param nackProb the probability of a HARQ NACK
+ * \param ulCqi whether the UL TBs get their UL CQI
+ * \param digest the digest of the scheduling decisions
+ * \return the elapsed time in ms
+ */
+static uint64_t
+RunScheduler(const std::string& type,
+             uint32_t numUes,
+             uint32_t slots,
+             double nackProb,
+             bool ulCqi,
+             uint64_t& digest)
+{
+    Ptr<MmWavePhyMacCommon> config = CreateObject<MmWavePhyMacCommon>();
+    Ptr<MmWaveMacScheduler> scheduler = ObjectFactory(type).Create<MmWaveMacScheduler>();
+    BenchSchedSapUser schedSapUser;
+    BenchCschedSapUser cschedSapUser;
+    scheduler->ConfigureCommonParameters(config);
+    scheduler->SetMacSchedSapUser(&schedSapUser);
+    scheduler->SetMacCschedSapUser(&cschedSapUser);
+    MmWaveMacSchedSapProvider* sched = scheduler->GetMacSchedSapProvider();
+    MmWaveMacCschedSapProvider* csched = scheduler->GetMacCschedSapProvider();
+
+    for (uint16_t rnti = 1; rnti <= numUes; ++rnti)
+    {
+        MmWaveMacCschedSapProvider::CschedUeConfigReqParameters ueConfig;
+        ueConfig.m_rnti = rnti;
+        csched->CschedUeConfigReq(ueConfig);
+    }
+
+    BenchRandom random;
+    const uint32_t nackThreshold = nackProb * 1000;
+    const uint32_t slotsPerSubframe = config->GetSlotsPerSubframe();
+    const uint32_t subframesPerFrame = config->GetSubframesPerFrame();
+
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t slot = 0; slot < slots; ++slot)
+    {
+        uint32_t frameNum = slot / (slotsPerSubframe * subframesPerFrame);
+        uint8_t sfNum = (slot / slotsPerSubframe) % subframesPerFrame;
+        uint8_t slotNum = slot % slotsPerSubframe;
+
+        // about a quarter of the UEs report each buffer and CQI, on two DRBs
+        MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters dlCqi;
+        MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsr;
+        for (uint16_t rnti = 1; rnti <= numUes; ++rnti)
+        {
+            for (uint8_t lcid = 3; lcid <= 4; ++lcid)
+            {
+                if (random.Next(4) == 0)
+                {
+                    MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters rlc;
+                    rlc.m_rnti = rnti;
+                    rlc.m_logicalChannelIdentity = lcid;
+                    rlc.m_rlcTransmissionQueueSize = random.Next(4) ? random.Next(20000) : 0;
+                    rlc.m_rlcTransmissionQueueHolDelay = 0;
+                    rlc.m_rlcRetransmissionQueueSize = random.Next(8) ? 0 : random.Next(2000);
+                    rlc.m_rlcRetransmissionHolDelay = 0;
+                    rlc.m_rlcStatusPduSize = random.Next(8) ? 0 : 2 + random.Next(20);
+                    rlc.m_arrivalRate = 0;
+                    sched->SchedDlRlcBufferReq(rlc);
+                }
+            }
+            if (random.Next(4) == 0)
+            {
+                MacCeElement ce;
+                ce.m_rnti = rnti;
+                ce.m_macCeType = MacCeElement::BSR;
+                ce.m_macCeValue.m_phr = 0;
+                ce.m_macCeValue.m_crnti = 0;
+                ce.m_macCeValue.m_bufferStatus = {uint8_t(random.Next(40)), 0, 0, 0};
+                bsr.m_macCeList.push_back(ce);
+            }
+            if (random.Next(4) == 0)
+            {
+                DlCqiInfo cqi;
+                cqi.m_rnti = rnti;
+                cqi.m_ri = 1;
+                cqi.m_cqiType = DlCqiInfo::WB;
+                cqi.m_wbCqi = random.Next(16);
+                cqi.m_wbPmi = 0;
+                dlCqi.m_cqiList.push_back(cqi);
+            }
+        }
+        sched->SchedDlCqiInfoReq(dlCqi);
+        sched->SchedUlMacCtrlInfoReq(bsr);
+
+        // UL CQI and HARQ feedback of the TBs of the previous slot
+        MmWaveMacSchedSapProvider::SchedTriggerReqParameters trigger;
+        trigger.m_snfSf = SfnSf(frameNum, sfNum, slotNum);
+        if (slot > 0)
+        {
+            const SlotAllocInfo& previous = schedSapUser.m_last.m_slotAllocInfo;
+            for (const auto& tti : previous.m_ttiAllocInfo)
+            {
+                if (tti.m_ttiType != TtiAllocInfo::CTRL_DATA)
+                {
+                    continue;
+                }
+                bool nack = random.Next(1000) < nackThreshold;
+                if (tti.m_tddMode == TtiAllocInfo::DL_slotAllocInfo)
+                {
+                    DlHarqInfo harq;
+                    harq.m_rnti = tti.m_dci.m_rnti;
+                    harq.m_harqProcessId = tti.m_dci.m_harqProcess;
+                    harq.m_harqStatus = nack ? DlHarqInfo::NACK : DlHarqInfo::ACK;
+                    harq.m_numRetx = tti.m_dci.m_rv;
+                    trigger.m_dlHarqInfoList.push_back(harq);
+                }
+                else
+                {
+                    UlHarqInfo harq;
+                    harq.m_rnti = tti.m_dci.m_rnti;
+                    harq.m_harqProcessId = tti.m_dci.m_harqProcess;
+                    harq.m_receptionStatus = nack ? UlHarqInfo::NotOk : UlHarqInfo::Ok;
+                    harq.m_numRetx = tti.m_dci.m_rv;
+                    trigger.m_ulHarqInfoList.push_back(harq);
+
+                    if (ulCqi && tti.m_dci.m_rv == 0)
+                    {
+                        MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters ulCqi;
+                        ulCqi.m_sfnSf = previous.m_sfnSf;
+                        ulCqi.m_sfnSf.m_symStart = tti.m_dci.m_symStart;
+                        ulCqi.m_ulCqi.m_type = UlCqiInfo::PUSCH;
+                        ulCqi.m_ulCqi.m_sinr.assign(config->GetNumRb(), 1 + random.Next(1000));
+                        sched->SchedUlCqiInfoReq(ulCqi);
+                    }
+                }
+            }
+        }
+        sched->SchedTriggerReq(trigger);
+    }
+    uint64_t deltaMs = time.End();
+
+    digest = schedSapUser.m_digest;
+    scheduler->Dispose();
+    return deltaMs;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t slots = 20000;
+    uint32_t ues = 0;
+    double nackProb = 0.1;
+    bool ulCqi = true;
+    uint32_t minIterations = 1;
+    std::string scheduler = "ns3::MmWaveFlexTtiMacScheduler";
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the slot scheduling of MmWaveFlexTtiMacScheduler");
+    cmd.AddValue("slots", "number of scheduled slots per run", slots);
+    cmd.AddValue("ues", "number of UEs of the cell, 0 for 10, 50 and 200", ues);
+    cmd.AddValue("nack", "probability of a HARQ NACK", nackProb);
+    cmd.AddValue("ulCqi", "whether the UL TBs get their UL CQI", ulCqi);
+    cmd.AddValue("scheduler", "TypeId name of the FlexTTI scheduler", scheduler);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-mmwave-flex-tti-scheduler with slots=" << slots
+              << " scheduler=" << scheduler << std::endl;
+
+    std::vector<uint32_t> cells = {10, 50, 200};
+    if (ues > 0)
+    {
+        cells = {ues};
+    }
+    for (uint32_t numUes : cells)
+    {
+        uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+        uint64_t digest = 0;
+        for (uint32_t i = 0; i < minIterations; i++)
+        {
+            minDelay = std::min(minDelay,
+                                RunScheduler(scheduler, numUes, slots, nackProb, ulCqi, digest));
+        }
+        double slotsPerSec = slots * 1000.0 / std::max<uint64_t>(minDelay, 1);
+        std::cout << slotsPerSec << " slots/s"
+                  << " (" << minDelay << " ms elapsed)\t" << numUes << " UEs, digest " << std::hex
+                  << digest << std::dec << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,258 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the per-TB cost of the UE specific
+// DU counters kept by MmWavePhyTrace for E2 reporting, for 'ues' UEs spread
+// over 'cells' cells. The "legacy" run reproduces the previous storage, i.e.,
+// one std::map per counter, copied by value on every update.
+// The "report" runs measure the cost of the E2 DU reports of a cell with 'ues'
+// connected UEs, of which only 'changed' are scheduled in each period, either
+// reading every counter of every UE or taking a snapshot of the cell KPMs.
+// Sample usage:  ./ns3 run 'bench-mmwave-phy-trace --n=1000000 --ues=100 --cells=10'
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/mmwave-phy-trace.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <vector>
+
+using namespace ns3;
+using namespace mmwave;
+
+/// Number of per-UE counters updated by MmWavePhyTrace
+static const uint32_t NUM_COUNTERS = 21;
+
+/**
+ * Build a pseudo-random sequence of received TBs
+ * \param n the number of TBs
+ * \param ues the number of UEs per cell
+ * \param cells the number of cells
+ * \return the TB trace parameters
+ */
+static std::vector<RxPacketTraceParams>
+MakeTbs(uint32_t n, uint32_t ues, uint32_t cells)
+{
+    std::vector<RxPacketTraceParams> tbs(n);
+    uint32_t state = 12345;
+    for (auto& tb : tbs)
+    {
+        state = state * 1103515245 + 12345;
+        tb = RxPacketTraceParams{};
+        tb.m_rnti = 1 + (state >> 8) % ues;
+        tb.m_cellId = 1 + (state >> 16) % cells;
+        tb.m_mcs = (state >> 4) % 29;
+        tb.m_rv = (state >> 12) % 4 == 0 ? 1 : 0;
+        tb.m_numSym = 1 + (state >> 20) % 13;
+        tb.m_tbSize = 100 + (state >> 2) % 4000;
+        tb.m_sinr = 0.1 + (state >> 10) % 1000;
+    }
+    return tbs;
+}
+
+/**
+ * Update the counters of a TB with the previous by-value map storage
+ * \param maps the counter maps
+ * \param tb the TB
+ */
+static void
+LegacyUpdate(std::vector<std::map<RntiCellIdPair_t, uint32_t>>& maps,
+             const RxPacketTraceParams& tb)
+{
+    auto increase = [](std::map<RntiCellIdPair_t, uint32_t> map,
+                       RntiCellIdPair_t key,
+                       uint32_t value) {
+        map[key] += value;
+        return map;
+    };
+    RntiCellIdPair_t pair{tb.m_rnti, tb.m_cellId};
+    maps[0] = increase(maps[0], pair, 1);
+    maps[tb.m_rv == 0 ? 1 : 2] = increase(maps[tb.m_rv == 0 ? 1 : 2], pair, 1);
+    maps[3] = increase(maps[3], pair, tb.m_tbSize);
+    uint32_t mod = tb.m_mcs <= 9 ? 4 : (tb.m_mcs <= 16 ? 5 : 6);
+    maps[mod] = increase(maps[mod], pair, 1);
+    maps[7 + tb.m_mcs / 5] = increase(maps[7 + tb.m_mcs / 5], pair, 1);
+    double sinrBin = std::ceil((10 * std::log10(tb.m_sinr) + 6) / 6);
+    uint32_t sinrIdx = 13 + static_cast<uint32_t>(std::min(6.0, std::max(0.0, sinrBin)));
+    maps[sinrIdx] = increase(maps[sinrIdx], pair, 1);
+    maps[20] = increase(maps[20], pair, tb.m_numSym);
+}
+
+static uint64_t
+RunLegacy(const std::vector<RxPacketTraceParams>& tbs)
+{
+    std::vector<std::map<RntiCellIdPair_t, uint32_t>> maps(NUM_COUNTERS);
+    SystemWallClockMs time;
+    time.Start();
+    for (const auto& tb : tbs)
+    {
+        LegacyUpdate(maps, tb);
+    }
+    return time.End();
+}
+
+static uint64_t
+RunPhyTrace(const std::vector<RxPacketTraceParams>& tbs, uint32_t ues, uint32_t cells)
+{
+    Ptr<MmWavePhyTrace> phyTrace = CreateObject<MmWavePhyTrace>();
+    SystemWallClockMs time;
+    time.Start();
+    for (const auto& tb : tbs)
+    {
+        phyTrace->UpdateTraces(tb);
+    }
+    // emulate one E2 DU report
+    uint64_t sum = 0;
+    for (uint16_t cellId = 1; cellId <= cells; ++cellId)
+    {
+        for (uint16_t rnti = 1; rnti <= ues; ++rnti)
+        {
+            sum += phyTrace->GetMacPduUeSpecific(rnti, cellId);
+            phyTrace->ResetPhyTracesForRntiCellId(rnti, cellId);
+        }
+    }
+    uint64_t deltaMs = time.End();
+    NS_ABORT_MSG_UNLESS(sum == tbs.size(), "lost TBs in the counters");
+    return deltaMs;
+}
+
+/**
+ * Emulate the E2 DU reports of a cell
+ * \param reports the number of reports
+ * \param ues the number of connected UEs
+ * \param changed the number of UEs scheduled in each reporting period
+ * \param snapshot whether to take a snapshot of the cell KPMs, or to read all the counters
+ * \return the elapsed time in ms, including the updates of the scheduled UEs
+ */
+static uint64_t
+RunReports(uint32_t reports, uint32_t ues, uint32_t changed, bool snapshot)
+{
+    Ptr<MmWavePhyTrace> phyTrace = CreateObject<MmWavePhyTrace>();
+    MmWaveCellKpmAggregator::Snapshot cellKpms;
+    RxPacketTraceParams tb{};
+    tb.m_cellId = 1;
+    tb.m_mcs = 20;
+    tb.m_numSym = 4;
+    tb.m_tbSize = 1000;
+    tb.m_sinr = 100;
+
+    uint64_t sum = 0;
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t report = 0; report < reports; ++report)
+    {
+        for (uint32_t i = 0; i < changed; ++i)
+        {
+            tb.m_rnti = 1 + (report * changed + i) % ues;
+            phyTrace->UpdateTraces(tb);
+        }
+
+        if (snapshot)
+        {
+            phyTrace->TakeCellKpmSnapshot(tb.m_cellId, cellKpms);
+            sum += cellKpms.m_cell.m_macPdu;
+        }
+        else
+        {
+            for (uint16_t rnti = 1; rnti <= ues; ++rnti)
+            {
+                UeSpecificPhyCounters counters = phyTrace->GetPhyCountersUeSpecific(rnti, 1);
+                sum += counters.m_macPdu;
+                phyTrace->ResetPhyTracesForRntiCellId(rnti, 1);
+            }
+        }
+    }
+    uint64_t deltaMs = time.End();
+    NS_ABORT_MSG_UNLESS(sum == uint64_t(reports) * changed, "lost TBs in the reports");
+    return deltaMs;
+}
+
+static void
+Report(const char* name, uint32_t n, uint64_t minDelay)
+{
+    double nsPerTb = minDelay * 1e6 / n;
+    std::cout << nsPerTb << " ns/TB"
+              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 1000000;
+    uint32_t ues = 100;
+    uint32_t cells = 10;
+    uint32_t minIterations = 1;
+    bool legacy = true;
+    uint32_t reports = 10000;
+    uint32_t changed = 10;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the MmWavePhyTrace UE specific counters");
+    cmd.AddValue("n", "number of received TBs", n);
+    cmd.AddValue("ues", "number of UEs per cell", ues);
+    cmd.AddValue("cells", "number of cells", cells);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.AddValue("legacy", "also run the map-copy baseline", legacy);
+    cmd.AddValue("reports", "number of E2 DU reports", reports);
+    cmd.AddValue("changed", "number of UEs scheduled in each reporting period", changed);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-mmwave-phy-trace with n=" << n << " ues=" << ues
+              << " cells=" << cells << std::endl;
+
+    std::vector<RxPacketTraceParams> tbs = MakeTbs(n, ues, cells);
+
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < minIterations; i++)
+    {
+        minDelay = std::min(minDelay, RunPhyTrace(tbs, ues, cells));
+    }
+    Report("MmWavePhyTrace counter blocks", n, minDelay);
+
+    if (legacy)
+    {
+        minDelay = std::numeric_limits<uint64_t>::max();
+        for (uint32_t i = 0; i < minIterations; i++)
+        {
+            minDelay = std::min(minDelay, RunLegacy(tbs));
+        }
+        Report("Legacy by-value maps", n, minDelay);
+    }
+
+    for (bool snapshot : {true, false})
+    {
+        minDelay = std::numeric_limits<uint64_t>::max();
+        for (uint32_t i = 0; i < minIterations; i++)
+        {
+            minDelay = std::min(minDelay, RunReports(reports, ues, changed, snapshot));
+        }
+        double usPerReport = minDelay * 1e3 / reports;
+        std::cout << usPerReport << " us/report (" << changed << " of " << ues
+                  << " UEs scheduled)\t"
+                  << (snapshot ? "Cell KPM snapshot" : "All the counters of all the UEs")
+                  << std::endl;
+    }
+
+    Simulator::Destroy();
+    return 0;
+}
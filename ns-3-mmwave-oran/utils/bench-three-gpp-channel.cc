@@ -0,0 +1,234 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the 3GPP channel of
+// ThreeGppSpectrumPropagationLossModel between a gNB and a set of UEs, with
+// square arrays of the same size at both ends. For each size, it reports the
+// time to generate the channel of a pair, the heap memory held per pair after
+// the first received PSD (channel matrix, parameters and long term), and the
+// time to compute a received PSD, with the long term component cached and
+// with the gNB beam changed before each PSD. 'cacheDelayPhases' sets the
+// attribute of the same name of ThreeGppSpectrumPropagationLossModel.
+// Sample usage:  ./ns3 run 'bench-three-gpp-channel --pairs=20 --rounds=200'
+
+#include "ns3/boolean.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/command-line.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/isotropic-antenna-model.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/three-gpp-channel-model.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/uinteger.h"
+#include "ns3/uniform-planar-array.h"
+
+#include <iostream>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace ns3;
+
+/**
+ * \return the bytes allocated on the heap, including the large blocks
+ *         allocated with mmap, or 0 if unknown
+ */
+static uint64_t
+GetHeapBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Create a node with a device, a mobility model and a square array
+ * \param position the position of the node
+ * \param velocity the velocity of the node
+ * \param size the number of rows and columns of the array
+ * \param antenna the array, set by the function
+ * \return the mobility model of the node
+ */
+static Ptr<MobilityModel>
+CreateNode(Vector position, Vector velocity, uint32_t size, Ptr<PhasedArrayModel>& antenna)
+{
+    Ptr<ConstantVelocityMobilityModel> mobility = CreateObject<ConstantVelocityMobilityModel>();
+    mobility->SetPosition(position);
+    mobility->SetVelocity(velocity);
+    Ptr<Node> node = CreateObject<Node>();
+    node->AggregateObject(mobility);
+    Ptr<NetDevice> device = CreateObject<SimpleNetDevice>();
+    device->SetNode(node);
+    node->AddDevice(device);
+    antenna = CreateObjectWithAttributes<UniformPlanarArray>(
+        "NumRows",
+        UintegerValue(size),
+        "NumColumns",
+        UintegerValue(size),
+        "AntennaElement",
+        PointerValue(CreateObject<IsotropicAntennaModel>()));
+    return mobility;
+}
+
+/**
+ * Run the benchmark for a size of the arrays
+ * \param size the number of rows and columns of the arrays
+ * \param numPairs the number of UEs
+ * \param numRounds the number of PSDs computed for each UE
+ * \param numRbs the number of RBs of the PSD
+ * \param cacheDelayPhases whether the delay phases are kept with the long term
+ */
+static void
+RunChannel(uint32_t size,
+           uint32_t numPairs,
+           uint32_t numRounds,
+           uint32_t numRbs,
+           bool cacheDelayPhases)
+{
+    Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+    channelModel->SetAttribute("Frequency", DoubleValue(28e9));
+    channelModel->SetAttribute("Scenario", StringValue("UMa"));
+    channelModel->SetAttribute("ChannelConditionModel",
+                               PointerValue(CreateObject<ThreeGppUmaChannelConditionModel>()));
+    Ptr<ThreeGppSpectrumPropagationLossModel> splm =
+        CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    splm->SetChannelModel(channelModel);
+    splm->SetAttribute("CacheDelayPhases", BooleanValue(cacheDelayPhases));
+
+    Ptr<PhasedArrayModel> gnbAntenna;
+    Ptr<MobilityModel> gnbMob = CreateNode(Vector(0, 0, 25), Vector(0, 0, 0), size, gnbAntenna);
+    std::vector<Ptr<MobilityModel>> ueMobs;
+    std::vector<Ptr<PhasedArrayModel>> ueAntennas;
+    for (uint32_t i = 0; i < numPairs; i++)
+    {
+        Ptr<PhasedArrayModel> antenna;
+        ueMobs.push_back(CreateNode(Vector(30.0 + 10.0 * i, 20.0 * (i % 7) - 60.0, 1.5),
+                                    Vector(1.0 * (i % 3), 3.0, 0.0),
+                                    size,
+                                    antenna));
+        ueAntennas.push_back(antenna);
+    }
+
+    // a PSD over numRbs RBs of 180 kHz around 28 GHz
+    std::vector<double> centerFrequencies;
+    for (uint32_t i = 0; i < numRbs; i++)
+    {
+        centerFrequencies.push_back(28e9 + 180e3 * (i - numRbs / 2.0));
+    }
+    Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters>();
+    txParams->psd = Create<SpectrumValue>(Create<SpectrumModel>(centerFrequencies));
+    *txParams->psd = 1e-9;
+
+    // two gNB beams, alternated to force the update of the long term component
+    std::vector<PhasedArrayModel::ComplexVector> gnbBeams = {
+        gnbAntenna->GetBeamformingVector(Angles(ueMobs[0]->GetPosition(), gnbMob->GetPosition())),
+        gnbAntenna->GetBeamformingVector(
+            Angles(ueMobs[numPairs - 1]->GetPosition(), gnbMob->GetPosition()))};
+    gnbAntenna->SetBeamformingVector(gnbBeams[0]);
+    for (uint32_t i = 0; i < numPairs; i++)
+    {
+        ueAntennas[i]->SetBeamformingVector(ueAntennas[i]->GetBeamformingVector(
+            Angles(gnbMob->GetPosition(), ueMobs[i]->GetPosition())));
+    }
+
+    uint64_t heapBefore = GetHeapBytes();
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i = 0; i < numPairs; i++)
+    {
+        splm->DoCalcRxPowerSpectralDensity(txParams, gnbMob, ueMobs[i], gnbAntenna, ueAntennas[i]);
+    }
+    uint64_t generationMs = time.End();
+    uint64_t heapAfter = GetHeapBytes();
+
+    time.Start();
+    for (uint32_t r = 0; r < numRounds; r++)
+    {
+        for (uint32_t i = 0; i < numPairs; i++)
+        {
+            splm->DoCalcRxPowerSpectralDensity(txParams,
+                                               gnbMob,
+                                               ueMobs[i],
+                                               gnbAntenna,
+                                               ueAntennas[i]);
+        }
+    }
+    uint64_t cachedMs = time.End();
+
+    time.Start();
+    for (uint32_t r = 0; r < numRounds; r++)
+    {
+        gnbAntenna->SetBeamformingVector(gnbBeams[(r + 1) % 2]);
+        for (uint32_t i = 0; i < numPairs; i++)
+        {
+            splm->DoCalcRxPowerSpectralDensity(txParams,
+                                               gnbMob,
+                                               ueMobs[i],
+                                               gnbAntenna,
+                                               ueAntennas[i]);
+        }
+    }
+    uint64_t updatedMs = time.End();
+
+    uint64_t numPsds = static_cast<uint64_t>(numRounds) * numPairs;
+    std::cout << size << "x" << size << "\t" << generationMs * 1e3 / numPairs << " us/channel\t"
+              << (heapAfter - heapBefore) / numPairs << " B/pair\t" << cachedMs * 1e3 / numPsds
+              << " us/psd (cached)\t" << updatedMs * 1e3 / numPsds << " us/psd (new beam)"
+              << std::endl;
+
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t numPairs = 20;
+    uint32_t numRounds = 200;
+    uint32_t numRbs = 72;
+    bool cacheDelayPhases = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the 3GPP channel generation and received PSD computation");
+    cmd.AddValue("pairs", "number of gNB-UE pairs", numPairs);
+    cmd.AddValue("rounds", "number of PSDs per pair", numRounds);
+    cmd.AddValue("rbs", "number of RBs of the PSD", numRbs);
+    cmd.AddValue("cacheDelayPhases",
+                 "keep the delay phases with the long term components",
+                 cacheDelayPhases);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-three-gpp-channel with pairs=" << numPairs
+              << " rounds=" << numRounds << " rbs=" << numRbs
+              << " cacheDelayPhases=" << cacheDelayPhases << std::endl;
+
+    for (uint32_t size : {4, 8})
+    {
+        RunChannel(size, numPairs, numRounds, numRbs, cacheDelayPhases);
+    }
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts the binary traces written by the mmWave module
+// (e.g., with MmWaveHelper::RxPacketTraceFormat=Binary) to CSV or TSV.
+// Sample usage:
+//   ./ns3 run 'mmwave-trace-converter --input=RxPacketTrace.txt --output=RxPacketTrace.csv'
+
+#include "ns3/command-line.h"
+#include "ns3/mmwave-trace-sink.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+using namespace mmwave;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+    std::string format = "csv";
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Convert a binary mmWave trace to CSV or TSV");
+    cmd.AddValue("input", "binary trace file", input);
+    cmd.AddValue("output", "output file, standard output if empty", output);
+    cmd.AddValue("format", "output format, csv or tsv", format);
+    cmd.Parse(argc, argv);
+
+    if (input.empty() || (format != "csv" && format != "tsv"))
+    {
+        cmd.PrintHelp(std::cerr);
+        return 1;
+    }
+
+    std::ifstream in(input.c_str(), std::ios_base::binary);
+    if (!in.is_open())
+    {
+        std::cerr << "Can't open file " << input << std::endl;
+        return 1;
+    }
+
+    std::ofstream outFile;
+    if (!output.empty())
+    {
+        outFile.open(output.c_str());
+        if (!outFile.is_open())
+        {
+            std::cerr << "Can't open file " << output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : outFile;
+
+    if (!MmWaveTraceSink::ConvertToText(in, out, format == "csv" ? ',' : '\t'))
+    {
+        std::cerr << input << " is not a binary mmWave trace" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -236,6 +236,19 @@ int sctp_send_data(int &socket_fd, sctp_buffer_t &data)
   return sent_len;
 }
 
+int sctp_send_buffer(int &socket_fd, const uint8_t *buffer, size_t len)
+{
+  LOG_D("[SCTP] sending buffer of size %zu", len);
+  int sent_len = send(socket_fd, buffer, len, 0);
+
+  if(sent_len == -1) {
+    LOG_E("[SCTP] sctp_send_buffer, error message: %s", strerror(errno));
+    exit(EXIT_FAILURE);
+  }
+
+  return sent_len;
+}
+
 int sctp_send_data_X2AP(int &socket_fd, sctp_buffer_t &data)
 {
   /*
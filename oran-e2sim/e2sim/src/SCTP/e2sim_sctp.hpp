@@ -20,6 +20,8 @@
 #ifndef E2SIM_SCTP_HPP
 #define E2SIM_SCTP_HPP
 
+#include <stdint.h>
+
 #include "e2sim_defs.h"
 
 const int SERVER_LISTEN_QUEUE_SIZE  = 10;
@@ -32,6 +34,8 @@ int sctp_accept_connection(const char *server_ip_str, const int server_fd);
 
 int sctp_send_data(int &socket_fd, sctp_buffer_t &data);
 
+int sctp_send_buffer(int &socket_fd, const uint8_t *buffer, size_t len);
+
 int sctp_send_data_X2AP(int &socket_fd, sctp_buffer_t &data);
 
 int sctp_receive_data(int &socket_fd, sctp_buffer_t &data);
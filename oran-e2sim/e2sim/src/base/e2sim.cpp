@@ -32,6 +32,11 @@
 
 using namespace std;
 
+E2Sim::~E2Sim() {
+  stop_sender();
+  free(sync_pdu.buf);
+}
+
 std::unordered_map<long , OCTET_STRING_t*> E2Sim::getRegistered_ran_functions() {
   return ran_functions_registered;
 }
@@ -84,17 +89,95 @@ void E2Sim::register_e2sm(long func_id, OCTET_STRING_t *ostr) {
 
 void E2Sim::encode_and_send_sctp_data(E2AP_PDU_t* pdu)
 {
-  uint8_t       *buf;
-  sctp_buffer_t data;
+  encode_and_dispatch(pdu);
+  ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_E2AP_PDU, pdu);
+}
+
+void E2Sim::send_indication(long requestorId, long instanceId, long ranFunctionId, long actionId, long seqNum, const uint8_t *ind_header_buf, int header_length, const uint8_t *ind_message_buf, int message_length)
+{
+  encoding::indication_pdu ind;
+  encoding::build_e2apv1_indication_by_reference(ind, requestorId, instanceId, ranFunctionId, actionId, seqNum, ind_header_buf, header_length, ind_message_buf, message_length);
+  // the PDU lives on the stack and references the caller's buffers, it must not be freed
+  encode_and_dispatch(&ind.pdu);
+}
+
+void E2Sim::encode_and_dispatch(const E2AP_PDU_t* pdu)
+{
+  // encode on the caller's thread, straight into a buffer that is reused
+  // across messages; with the outbound queue the sender thread only writes
+  // it to the socket
+  OutboundPdu out = outbound_queue ? outbound_queue->acquire() : sync_pdu;
+  out.len = 0;
+
+  asn_enc_rval_t er = asn_encode(nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2AP_PDU, pdu, append_to_outbound_pdu, &out);
+  if (er.encoded < 0) {
+    LOG_E("[E2AP ASN] Unable to aper encode %s", er.failed_type ? er.failed_type->name : "");
+    exit(EXIT_FAILURE);
+  }
+  LOG_D("[E2AP ASN] Encoded succesfully, encoded size = %zu", out.len);
+
+  if (outbound_queue) {
+    if (!outbound_queue->push(out)) {
+      LOG_E("[SCTP] Outbound queue closed, PDU discarded");
+    }
+    return;
+  }
+
+  sctp_send_buffer(client_fd, out.buf, out.len);
+  sync_pdu = out;
+}
+
+void E2Sim::enable_outbound_queue(size_t high_water_mark, OutboundPolicy policy)
+{
+  if (high_water_mark == 0) {
+    outbound_queue.reset();
+    return;
+  }
+  outbound_queue.reset(new OutboundQueue(high_water_mark, policy));
+}
+
+OutboundQueueStats E2Sim::get_outbound_stats()
+{
+  if (outbound_queue) {
+    return outbound_queue->get_stats();
+  }
+  return OutboundQueueStats{};
+}
 
-  data.len = e2ap_asn1c_encode_pdu(pdu, &buf);
-  memcpy(data.buffer, buf, min(data.len, MAX_SCTP_BUFFER));
+void E2Sim::defer_control_acknowledge(bool deferred)
+{
+  control_acknowledge_deferred = deferred;
+}
+
+bool E2Sim::is_control_acknowledge_deferred() const
+{
+  return control_acknowledge_deferred;
+}
 
-  // LOG_I("Send data to client_fd %d", client_fd);
-  // LOG_I("SYNS FAN INTE %d", data.len);
-  sctp_send_data(client_fd, data);
+void E2Sim::sender_loop()
+{
+  OutboundPdu pdu;
+  while (outbound_queue->wait_pop(pdu)) {
+    sctp_send_buffer(client_fd, pdu.buf, pdu.len);
+    outbound_queue->record_sent(pdu);
+    outbound_queue->release(pdu);
+  }
 }
 
+void E2Sim::stop_sender()
+{
+  // Called by run_loop on the e2sim thread and by the destructor on the
+  // thread that owns this object: the first caller closes the queue and joins
+  // the sender, the other one waits for it to be done.
+  std::call_once(sender_stop_once, [this]() {
+    if (outbound_queue) {
+      outbound_queue->close();
+    }
+    if (sender_thread.joinable()) {
+      sender_thread.join();
+    }
+  });
+}
 
 void E2Sim::wait_for_sctp_data()
 {
@@ -180,6 +263,10 @@ int E2Sim::run_loop(std::string server_ip, uint16_t server_port, uint16_t local_
         LOG_E("[SCTP] Unable to send E2-SETUP-REQUEST to peer");
     }
 
+    if (outbound_queue) {
+        sender_thread = std::thread(&E2Sim::sender_loop, this);
+    }
+
     LOG_D("[SCTP] Waiting for SCTP data");
 
     try {
@@ -197,5 +284,7 @@ int E2Sim::run_loop(std::string server_ip, uint16_t server_port, uint16_t local_
         LOG_E("SIGINT raised, possible cause: %s", strsignal(SIGINT));
     }
 
+    stop_sender();
+
     return EXIT_SUCCESS;
 }
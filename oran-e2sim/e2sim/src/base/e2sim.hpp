@@ -22,7 +22,12 @@
 
 #include <unordered_map>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+
+#include "outbound_queue.hpp"
 
 extern "C" {
 #include "E2AP-PDU.h"
@@ -34,6 +39,8 @@ typedef std::function<void(E2AP_PDU_t*)> SmCallback;
 
 class E2Sim {
 public:
+  ~E2Sim();
+
   std::unordered_map<long, OCTET_STRING_t *> getRegistered_ran_functions();
 
   void generate_e2apv1_subscription_response_success(E2AP_PDU *e2ap_pdu, long reqActionIdsAccepted[], long reqActionIdsRejected[], int accept_size, int reject_size, long reqRequestorId, long reqInstanceId);
@@ -50,6 +57,25 @@ public:
 
   void encode_and_send_sctp_data(E2AP_PDU_t* pdu);
 
+  // Encode a RIC indication and send it. Unlike generate_e2apv1_indication_request_parameterized
+  // followed by encode_and_send_sctp_data, the header and message are not copied into an
+  // intermediate PDU tree, and no memory is allocated per indication in steady state.
+  void send_indication(long requestorId, long instanceId, long ranFunctionId, long actionId, long seqNum, const uint8_t *ind_header_buf, int header_length, const uint8_t *ind_message_buf, int message_length);
+
+  // Send the encoded PDUs from a dedicated thread instead of the caller's.
+  // Must be called before run_loop; a high_water_mark of 0 keeps the
+  // synchronous sends.
+  void enable_outbound_queue(size_t high_water_mark, OutboundPolicy policy);
+
+  OutboundQueueStats get_outbound_stats();
+
+  // Do not acknowledge the RIC control requests on reception: the callback of
+  // the service model sends the acknowledge or failure once the control is
+  // applied. Must be called before run_loop.
+  void defer_control_acknowledge(bool deferred);
+
+  bool is_control_acknowledge_deferred() const;
+
   int run_loop(int argc, char* argv[]);
 
   int run_loop(std::string server_ip, uint16_t server_port, uint16_t local_port, std::string gnb_id, std::string plmn_id);
@@ -63,6 +89,17 @@ private:
     int client_fd {0};
     void wait_for_sctp_data();
 
+    void encode_and_dispatch(const E2AP_PDU_t* pdu);
+
+    bool control_acknowledge_deferred {false};
+
+    OutboundPdu sync_pdu {nullptr, 0, 0, {}}; // encoding buffer when the outbound queue is disabled
+    std::unique_ptr<OutboundQueue> outbound_queue;
+    std::thread sender_thread;
+    std::once_flag sender_stop_once; // run_loop and the destructor both stop the sender
+    void sender_loop();
+    void stop_sender();
+
 };
 
 #endif
@@ -0,0 +1,264 @@
+/*****************************************************************************
+#                                                                            *
+# Licensed under the Apache License, Version 2.0 (the "License");            *
+# you may not use this file except in compliance with the License.           *
+# You may obtain a copy of the License at                                    *
+#                                                                            *
+#      http://www.apache.org/licenses/LICENSE-2.0                            *
+#                                                                            *
+# Unless required by applicable law or agreed to in writing, software        *
+# distributed under the License is distributed on an "AS IS" BASIS,          *
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+# See the License for the specific language governing permissions and        *
+# limitations under the License.                                             *
+#                                                                            *
+******************************************************************************/
+
+#include "outbound_queue.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+int append_to_outbound_pdu(const void *data, size_t size, void *key) {
+  auto *pdu = static_cast<OutboundPdu *>(key);
+  if (pdu->len + size > pdu->capacity) {
+    size_t capacity = std::max<size_t>(pdu->capacity * 2, 4096);
+    while (capacity < pdu->len + size) {
+      capacity *= 2;
+    }
+    auto *buf = static_cast<uint8_t *>(realloc(pdu->buf, capacity));
+    if (!buf) {
+      return -1;
+    }
+    pdu->buf = buf;
+    pdu->capacity = capacity;
+  }
+  memcpy(pdu->buf + pdu->len, data, size);
+  pdu->len += size;
+  return 0;
+}
+
+OutboundQueue::Ring::Ring(size_t capacity)
+    : cells(new Cell[capacity]),
+      mask(capacity - 1),
+      enqueue_pos(0),
+      dequeue_pos(0) {
+  for (size_t i = 0; i < capacity; i++) {
+    cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool OutboundQueue::Ring::try_push(const OutboundPdu &pdu) {
+  size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+  for (;;) {
+    Cell &cell = cells[pos & mask];
+    size_t seq = cell.sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+    if (diff == 0) {
+      if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        cell.pdu = pdu;
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false; // full
+    } else {
+      pos = enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool OutboundQueue::Ring::try_pop(OutboundPdu &pdu) {
+  size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+  for (;;) {
+    Cell &cell = cells[pos & mask];
+    size_t seq = cell.sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+    if (diff == 0) {
+      if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        pdu = cell.pdu;
+        cell.sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false; // empty
+    } else {
+      pos = dequeue_pos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+size_t OutboundQueue::Ring::depth() const {
+  size_t head = dequeue_pos.load(std::memory_order_relaxed);
+  size_t tail = enqueue_pos.load(std::memory_order_relaxed);
+  return tail > head ? tail - head : 0;
+}
+
+size_t OutboundQueue::ring_capacity(size_t high_water_mark) {
+  // the ring must be a power of two, and larger than the high-water mark so
+  // that the mark, and not the ring, is what limits the producers
+  size_t capacity = 2;
+  while (capacity <= high_water_mark) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+OutboundQueue::OutboundQueue(size_t high_water_mark, OutboundPolicy policy)
+    : high_water_mark(std::max<size_t>(high_water_mark, 1)),
+      policy(policy),
+      pending(ring_capacity(this->high_water_mark)),
+      spare(ring_capacity(this->high_water_mark)),
+      closed(false),
+      consumer_waiting(false),
+      producers_waiting(0),
+      enqueued(0),
+      sent(0),
+      dropped(0),
+      blocked(0),
+      max_depth(0),
+      latency_sum_ns(0),
+      latency_max_ns(0) {
+}
+
+OutboundQueue::~OutboundQueue() {
+  OutboundPdu pdu;
+  while (pending.try_pop(pdu)) {
+    free(pdu.buf);
+  }
+  while (spare.try_pop(pdu)) {
+    free(pdu.buf);
+  }
+}
+
+OutboundPdu OutboundQueue::acquire() {
+  OutboundPdu pdu{nullptr, 0, 0, {}};
+  spare.try_pop(pdu);
+  pdu.len = 0;
+  return pdu;
+}
+
+void OutboundQueue::release(OutboundPdu &pdu) {
+  if (!pdu.buf || !spare.try_push(pdu)) {
+    free(pdu.buf);
+  }
+  pdu.buf = nullptr;
+  pdu.len = 0;
+  pdu.capacity = 0;
+}
+
+bool OutboundQueue::push(OutboundPdu &pdu) {
+  pdu.enqueued = std::chrono::steady_clock::now();
+  bool waited = false;
+
+  while (!closed.load(std::memory_order_acquire)) {
+    if (pending.depth() >= high_water_mark) {
+      if (policy == OutboundPolicy::DROP_OLDEST) {
+        OutboundPdu oldest;
+        if (pending.try_pop(oldest)) {
+          release(oldest);
+          dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+      } else {
+        if (!waited) {
+          blocked.fetch_add(1, std::memory_order_relaxed);
+          waited = true;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        producers_waiting.fetch_add(1);
+        // pairs with the fence in wait_pop: either the consumer sees the
+        // count and notifies, or the depth checked here includes its pop
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        space_cv.wait(lock, [this] {
+          return closed.load(std::memory_order_acquire) || pending.depth() < high_water_mark;
+        });
+        producers_waiting.fetch_sub(1);
+      }
+      continue;
+    }
+
+    if (!pending.try_push(pdu)) {
+      continue;
+    }
+
+    enqueued.fetch_add(1, std::memory_order_relaxed);
+    uint64_t d = pending.depth();
+    uint64_t prev = max_depth.load(std::memory_order_relaxed);
+    while (d > prev && !max_depth.compare_exchange_weak(prev, d, std::memory_order_relaxed)) {
+    }
+
+    if (consumer_waiting.load()) {
+      std::lock_guard<std::mutex> lock(wake_mutex);
+      wake_cv.notify_one();
+    }
+    return true;
+  }
+
+  release(pdu);
+  return false;
+}
+
+bool OutboundQueue::wait_pop(OutboundPdu &pdu) {
+  for (;;) {
+    if (pending.try_pop(pdu)) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (producers_waiting.load() > 0) {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        space_cv.notify_all();
+      }
+      return true;
+    }
+    if (closed.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    consumer_waiting.store(true);
+    // a producer that enqueued before seeing the flag will not notify, so
+    // check again while holding the mutex
+    if (pending.try_pop(pdu)) {
+      consumer_waiting.store(false);
+      if (producers_waiting.load() > 0) {
+        space_cv.notify_all();
+      }
+      return true;
+    }
+    wake_cv.wait_for(lock, std::chrono::milliseconds(10));
+    consumer_waiting.store(false);
+  }
+}
+
+void OutboundQueue::record_sent(const OutboundPdu &pdu) {
+  uint64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - pdu.enqueued)
+                         .count();
+  sent.fetch_add(1, std::memory_order_relaxed);
+  latency_sum_ns.fetch_add(latency, std::memory_order_relaxed);
+  uint64_t prev = latency_max_ns.load(std::memory_order_relaxed);
+  while (latency > prev &&
+         !latency_max_ns.compare_exchange_weak(prev, latency, std::memory_order_relaxed)) {
+  }
+}
+
+void OutboundQueue::close() {
+  closed.store(true, std::memory_order_release);
+  std::lock_guard<std::mutex> lock(wake_mutex);
+  wake_cv.notify_all();
+  space_cv.notify_all();
+}
+
+OutboundQueueStats OutboundQueue::get_stats() const {
+  OutboundQueueStats stats{};
+  stats.depth = pending.depth();
+  stats.max_depth = max_depth.load(std::memory_order_relaxed);
+  stats.enqueued = enqueued.load(std::memory_order_relaxed);
+  stats.sent = sent.load(std::memory_order_relaxed);
+  stats.dropped = dropped.load(std::memory_order_relaxed);
+  stats.blocked = blocked.load(std::memory_order_relaxed);
+  if (stats.sent > 0) {
+    stats.mean_latency_us = latency_sum_ns.load(std::memory_order_relaxed) / 1e3 / stats.sent;
+  }
+  stats.max_latency_us = latency_max_ns.load(std::memory_order_relaxed) / 1e3;
+  return stats;
+}
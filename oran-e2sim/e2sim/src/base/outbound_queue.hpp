@@ -0,0 +1,172 @@
+/*****************************************************************************
+#                                                                            *
+# Licensed under the Apache License, Version 2.0 (the "License");            *
+# you may not use this file except in compliance with the License.           *
+# You may obtain a copy of the License at                                    *
+#                                                                            *
+#      http://www.apache.org/licenses/LICENSE-2.0                            *
+#                                                                            *
+# Unless required by applicable law or agreed to in writing, software        *
+# distributed under the License is distributed on an "AS IS" BASIS,          *
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+# See the License for the specific language governing permissions and        *
+# limitations under the License.                                             *
+#                                                                            *
+******************************************************************************/
+
+#ifndef E2SIM_OUTBOUND_QUEUE_HPP
+#define E2SIM_OUTBOUND_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/**
+ * What to do when a PDU is enqueued and the queue is at its high-water mark
+ */
+enum class OutboundPolicy {
+  DROP_OLDEST, // discard the oldest queued PDU to make room
+  BLOCK        // wait until the sender thread has drained below the mark
+};
+
+/**
+ * Snapshot of the counters of an OutboundQueue
+ */
+struct OutboundQueueStats {
+  uint64_t depth;          // PDUs currently queued
+  uint64_t max_depth;      // largest depth observed at enqueue time
+  uint64_t enqueued;       // PDUs accepted by push
+  uint64_t sent;           // PDUs handed to the socket
+  uint64_t dropped;        // PDUs discarded by the DROP_OLDEST policy
+  uint64_t blocked;        // push calls that had to wait with the BLOCK policy
+  double mean_latency_us;  // mean enqueue-to-wire latency
+  double max_latency_us;   // max enqueue-to-wire latency
+};
+
+/**
+ * An encoded E2AP PDU. The buffer is allocated with malloc and grows as
+ * needed; once sent it is handed back to the queue with release(), so that
+ * the next PDU can be encoded in it without allocating.
+ */
+struct OutboundPdu {
+  uint8_t *buf;
+  size_t len;
+  size_t capacity;
+  std::chrono::steady_clock::time_point enqueued;
+};
+
+/**
+ * asn_app_consume_bytes_f that appends the encoder output to an OutboundPdu,
+ * growing its buffer if needed
+ */
+int append_to_outbound_pdu(const void *data, size_t size, void *pdu);
+
+/**
+ * Bounded lock-free FIFO of encoded PDUs, filled by the threads that generate
+ * E2 messages (the ns-3 event loop and the e2sim receive loop) and drained by
+ * a single sender thread. The ring follows the bounded MPMC design by
+ * D. Vyukov: each slot carries a sequence number, so producers and the
+ * consumer only contend on a CAS of their own position.
+ *
+ * The consumer sleeps on a condition variable when the ring is empty;
+ * producers only take the mutex to wake it up when it is actually sleeping.
+ * Likewise, with the BLOCK policy producers sleep on a second condition
+ * variable while the queue is at the high-water mark, and the consumer only
+ * takes the mutex to wake them up when some are sleeping.
+ *
+ * Sent buffers are kept in a second ring of the same size and reused by
+ * acquire(), so in steady state no memory is allocated per PDU.
+ */
+class OutboundQueue {
+public:
+  OutboundQueue(size_t high_water_mark, OutboundPolicy policy);
+  ~OutboundQueue();
+
+  OutboundQueue(const OutboundQueue &) = delete;
+  OutboundQueue &operator=(const OutboundQueue &) = delete;
+
+  /**
+   * Get an empty buffer to encode a PDU into, reusing a sent one if possible
+   */
+  OutboundPdu acquire();
+
+  /**
+   * Give back the buffer of a PDU that has been sent or discarded
+   */
+  void release(OutboundPdu &pdu);
+
+  /**
+   * Enqueue an encoded PDU, applying the policy if the queue is at the
+   * high-water mark. The queue takes ownership of the buffer.
+   * @return false if the queue has been closed, in which case the buffer is
+   *         released
+   */
+  bool push(OutboundPdu &pdu);
+
+  /**
+   * Dequeue the oldest PDU, waiting until one is available
+   * @return false if the queue has been closed and is empty
+   */
+  bool wait_pop(OutboundPdu &pdu);
+
+  /**
+   * Account for a PDU that has been written to the socket
+   */
+  void record_sent(const OutboundPdu &pdu);
+
+  /**
+   * Wake up the consumer and the blocked producers; subsequent push calls fail
+   */
+  void close();
+
+  OutboundQueueStats get_stats() const;
+
+private:
+  class Ring {
+  public:
+    explicit Ring(size_t capacity);
+    bool try_push(const OutboundPdu &pdu);
+    bool try_pop(OutboundPdu &pdu);
+    size_t depth() const;
+
+  private:
+    struct Cell {
+      std::atomic<size_t> sequence;
+      OutboundPdu pdu;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> enqueue_pos;
+    alignas(64) std::atomic<size_t> dequeue_pos;
+  };
+
+  static size_t ring_capacity(size_t high_water_mark);
+
+  size_t high_water_mark;
+  OutboundPolicy policy;
+  Ring pending;
+  Ring spare;
+
+  std::atomic<bool> closed;
+  std::atomic<bool> consumer_waiting;
+  std::atomic<uint32_t> producers_waiting;
+  std::mutex wake_mutex;
+  std::condition_variable wake_cv;
+  std::condition_variable space_cv;
+
+  std::atomic<uint64_t> enqueued;
+  std::atomic<uint64_t> sent;
+  std::atomic<uint64_t> dropped;
+  std::atomic<uint64_t> blocked;
+  std::atomic<uint64_t> max_depth;
+  std::atomic<uint64_t> latency_sum_ns;
+  std::atomic<uint64_t> latency_max_ns;
+};
+
+#endif
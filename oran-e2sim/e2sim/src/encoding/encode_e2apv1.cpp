@@ -292,6 +292,110 @@ void encoding::generate_e2apv1_ric_control_acknowledge(E2AP_PDU_t *control_resp_
     control_resp_pdu->choice.successfulOutcome = successOutcome;
 }
 
+void encoding::generate_e2apv1_ric_control_acknowledge_parameterized(E2AP_PDU_t *control_ack_pdu,
+                                                                    long requestorId,
+                                                                    long instanceId,
+                                                                    long ranFunctionId,
+                                                                    const uint8_t *outcome_buf,
+                                                                    int outcome_length) {
+
+    auto *req_id_ie = (RICcontrolAcknowledge_IEs_t *) calloc(1, sizeof(RICcontrolAcknowledge_IEs_t));
+    req_id_ie->id = ProtocolIE_ID_id_RICrequestID;
+    req_id_ie->criticality = Criticality_reject;
+    req_id_ie->value.present = RICcontrolAcknowledge_IEs__value_PR_RICrequestID;
+    req_id_ie->value.choice.RICrequestID.ricRequestorID = requestorId;
+    req_id_ie->value.choice.RICrequestID.ricInstanceID = instanceId;
+
+    auto *ran_func_id_ie = (RICcontrolAcknowledge_IEs_t *) calloc(1, sizeof(RICcontrolAcknowledge_IEs_t));
+    ran_func_id_ie->id = ProtocolIE_ID_id_RANfunctionID;
+    ran_func_id_ie->criticality = Criticality_reject;
+    ran_func_id_ie->value.present = RICcontrolAcknowledge_IEs__value_PR_RANfunctionID;
+    ran_func_id_ie->value.choice.RANfunctionID = ranFunctionId;
+
+    auto *ric_control_status_ie = (RICcontrolAcknowledge_IEs_t *) calloc(1, sizeof(RICcontrolAcknowledge_IEs_t));
+    ric_control_status_ie->id = ProtocolIE_ID_id_RICcontrolStatus;
+    ric_control_status_ie->criticality = Criticality_reject;
+    ric_control_status_ie->value.present = RICcontrolAcknowledge_IEs__value_PR_RICcontrolStatus;
+    ric_control_status_ie->value.choice.RICcontrolStatus = RICcontrolStatus_success;
+
+    auto *successOutcome = (SuccessfulOutcome_t *) calloc(1, sizeof(SuccessfulOutcome_t));
+    successOutcome->procedureCode = ProcedureCode_id_RICcontrol;
+    successOutcome->criticality = Criticality_reject;
+    successOutcome->value.present = SuccessfulOutcome__value_PR_RICcontrolAcknowledge;
+
+    RICcontrolAcknowledge_t &ack = successOutcome->value.choice.RICcontrolAcknowledge;
+    ASN_SEQUENCE_ADD(&ack.protocolIEs.list, req_id_ie);
+    ASN_SEQUENCE_ADD(&ack.protocolIEs.list, ran_func_id_ie);
+    ASN_SEQUENCE_ADD(&ack.protocolIEs.list, ric_control_status_ie);
+
+    if (outcome_length > 0) {
+        auto *outcome_ie = (RICcontrolAcknowledge_IEs_t *) calloc(1, sizeof(RICcontrolAcknowledge_IEs_t));
+        outcome_ie->id = ProtocolIE_ID_id_RICcontrolOutcome;
+        outcome_ie->criticality = Criticality_reject;
+        outcome_ie->value.present = RICcontrolAcknowledge_IEs__value_PR_RICcontrolOutcome;
+        outcome_ie->value.choice.RICcontrolOutcome.buf = (uint8_t *) calloc(1, outcome_length);
+        outcome_ie->value.choice.RICcontrolOutcome.size = outcome_length;
+        memcpy(outcome_ie->value.choice.RICcontrolOutcome.buf, outcome_buf, outcome_length);
+        ASN_SEQUENCE_ADD(&ack.protocolIEs.list, outcome_ie);
+    }
+
+    control_ack_pdu->present = E2AP_PDU_PR_successfulOutcome;
+    control_ack_pdu->choice.successfulOutcome = successOutcome;
+}
+
+void encoding::generate_e2apv1_ric_control_failure(E2AP_PDU_t *control_fail_pdu,
+                                                   long requestorId,
+                                                   long instanceId,
+                                                   long ranFunctionId,
+                                                   long ricCause,
+                                                   const uint8_t *outcome_buf,
+                                                   int outcome_length) {
+
+    auto *req_id_ie = (RICcontrolFailure_IEs_t *) calloc(1, sizeof(RICcontrolFailure_IEs_t));
+    req_id_ie->id = ProtocolIE_ID_id_RICrequestID;
+    req_id_ie->criticality = Criticality_reject;
+    req_id_ie->value.present = RICcontrolFailure_IEs__value_PR_RICrequestID;
+    req_id_ie->value.choice.RICrequestID.ricRequestorID = requestorId;
+    req_id_ie->value.choice.RICrequestID.ricInstanceID = instanceId;
+
+    auto *ran_func_id_ie = (RICcontrolFailure_IEs_t *) calloc(1, sizeof(RICcontrolFailure_IEs_t));
+    ran_func_id_ie->id = ProtocolIE_ID_id_RANfunctionID;
+    ran_func_id_ie->criticality = Criticality_reject;
+    ran_func_id_ie->value.present = RICcontrolFailure_IEs__value_PR_RANfunctionID;
+    ran_func_id_ie->value.choice.RANfunctionID = ranFunctionId;
+
+    auto *cause_ie = (RICcontrolFailure_IEs_t *) calloc(1, sizeof(RICcontrolFailure_IEs_t));
+    cause_ie->id = ProtocolIE_ID_id_Cause;
+    cause_ie->criticality = Criticality_ignore;
+    cause_ie->value.present = RICcontrolFailure_IEs__value_PR_Cause;
+    cause_ie->value.choice.Cause.present = Cause_PR_ricRequest;
+    cause_ie->value.choice.Cause.choice.ricRequest = ricCause;
+
+    auto *unsuccessfulOutcome = (UnsuccessfulOutcome_t *) calloc(1, sizeof(UnsuccessfulOutcome_t));
+    unsuccessfulOutcome->procedureCode = ProcedureCode_id_RICcontrol;
+    unsuccessfulOutcome->criticality = Criticality_reject;
+    unsuccessfulOutcome->value.present = UnsuccessfulOutcome__value_PR_RICcontrolFailure;
+
+    RICcontrolFailure_t &failure = unsuccessfulOutcome->value.choice.RICcontrolFailure;
+    ASN_SEQUENCE_ADD(&failure.protocolIEs.list, req_id_ie);
+    ASN_SEQUENCE_ADD(&failure.protocolIEs.list, ran_func_id_ie);
+    ASN_SEQUENCE_ADD(&failure.protocolIEs.list, cause_ie);
+
+    if (outcome_length > 0) {
+        auto *outcome_ie = (RICcontrolFailure_IEs_t *) calloc(1, sizeof(RICcontrolFailure_IEs_t));
+        outcome_ie->id = ProtocolIE_ID_id_RICcontrolOutcome;
+        outcome_ie->criticality = Criticality_reject;
+        outcome_ie->value.present = RICcontrolFailure_IEs__value_PR_RICcontrolOutcome;
+        outcome_ie->value.choice.RICcontrolOutcome.buf = (uint8_t *) calloc(1, outcome_length);
+        outcome_ie->value.choice.RICcontrolOutcome.size = outcome_length;
+        memcpy(outcome_ie->value.choice.RICcontrolOutcome.buf, outcome_buf, outcome_length);
+        ASN_SEQUENCE_ADD(&failure.protocolIEs.list, outcome_ie);
+    }
+
+    control_fail_pdu->present = E2AP_PDU_PR_unsuccessfulOutcome;
+    control_fail_pdu->choice.unsuccessfulOutcome = unsuccessfulOutcome;
+}
+
 void encoding::generate_e2apv1_setup_response(E2AP_PDU_t *e2ap_pdu) {
 
     auto *resp_ies1 = (E2setupResponseIEs_t *) calloc(1, sizeof(E2setupResponseIEs_t));
@@ -693,7 +797,7 @@ void encoding::generate_e2apv1_indication_request_parameterized(E2AP_PDU *e2ap_p
     ricind_ies6->value.choice.RICindicationHeader.size = header_length;
     memcpy(ricind_ies6->value.choice.RICindicationHeader.buf, ind_header_buf, header_length);
 
-    ricind_ies7->value.choice.RICindicationMessage.buf = (uint8_t *) calloc(1, 8192);
+    ricind_ies7->value.choice.RICindicationMessage.buf = (uint8_t *) calloc(1, message_length);
 
     ricind_ies7->id = ProtocolIE_ID_id_RICindicationMessage;
 
@@ -757,3 +861,81 @@ void encoding::generate_e2apv1_indication_request_parameterized(E2AP_PDU *e2ap_p
         xer_fprint(stderr, &asn_DEF_E2AP_PDU, e2ap_pdu);
     free(errbuff);
 }
+
+void encoding::build_e2apv1_indication_by_reference(indication_pdu &ind,
+                                                   long requestorId,
+                                                   long instanceId,
+                                                   long ranFunctionId,
+                                                   long actionId,
+                                                   long seqNum,
+                                                   const uint8_t *ind_header_buf,
+                                                   int header_length,
+                                                   const uint8_t *ind_message_buf,
+                                                   int message_length) {
+
+    memset(&ind, 0, sizeof(ind));
+
+    // same IEs, in the same order, as generate_e2apv1_indication_request_parameterized
+    RICindication_IEs_t *ies = ind.ies;
+
+    ies[0].id = ProtocolIE_ID_id_RICrequestID;
+    ies[0].criticality = Criticality_reject;
+    ies[0].value.present = RICindication_IEs__value_PR_RICrequestID;
+    ies[0].value.choice.RICrequestID.ricRequestorID = requestorId;
+    ies[0].value.choice.RICrequestID.ricInstanceID = instanceId;
+
+    ies[1].id = ProtocolIE_ID_id_RANfunctionID;
+    ies[1].criticality = Criticality_reject;
+    ies[1].value.present = RICindication_IEs__value_PR_RANfunctionID;
+    ies[1].value.choice.RANfunctionID = ranFunctionId;
+
+    ies[2].id = ProtocolIE_ID_id_RICactionID;
+    ies[2].criticality = Criticality_reject;
+    ies[2].value.present = RICindication_IEs__value_PR_RICactionID;
+    ies[2].value.choice.RICactionID = actionId;
+
+    ies[3].id = ProtocolIE_ID_id_RICindicationSN;
+    ies[3].criticality = Criticality_reject;
+    ies[3].value.present = RICindication_IEs__value_PR_RICindicationSN;
+    ies[3].value.choice.RICindicationSN = seqNum;
+
+    ies[4].id = ProtocolIE_ID_id_RICindicationType;
+    ies[4].criticality = Criticality_reject;
+    ies[4].value.present = RICindication_IEs__value_PR_RICindicationType;
+    ies[4].value.choice.RICindicationType = RICindicationType_report;
+
+    ies[5].id = ProtocolIE_ID_id_RICindicationHeader;
+    ies[5].criticality = Criticality_reject;
+    ies[5].value.present = RICindication_IEs__value_PR_RICindicationHeader;
+    ies[5].value.choice.RICindicationHeader.buf = const_cast<uint8_t *>(ind_header_buf);
+    ies[5].value.choice.RICindicationHeader.size = header_length;
+
+    ies[6].id = ProtocolIE_ID_id_RICindicationMessage;
+    ies[6].criticality = Criticality_reject;
+    ies[6].value.present = RICindication_IEs__value_PR_RICindicationMessage;
+    ies[6].value.choice.RICindicationMessage.buf = const_cast<uint8_t *>(ind_message_buf);
+    ies[6].value.choice.RICindicationMessage.size = message_length;
+
+    static uint8_t cpid_buf[] = {'c', 'p', 'i', 'd'};
+    ies[7].id = ProtocolIE_ID_id_RICcallProcessID;
+    ies[7].criticality = Criticality_reject;
+    ies[7].value.present = RICindication_IEs__value_PR_RICcallProcessID;
+    ies[7].value.choice.RICcallProcessID.buf = cpid_buf;
+    ies[7].value.choice.RICcallProcessID.size = sizeof(cpid_buf);
+
+    for (int i = 0; i < 8; i++) {
+        ind.ie_list[i] = &ies[i];
+    }
+
+    RICindication_t &ricindication = ind.initmsg.value.choice.RICindication;
+    ricindication.protocolIEs.list.array = ind.ie_list;
+    ricindication.protocolIEs.list.count = 8;
+    ricindication.protocolIEs.list.size = 8;
+
+    ind.initmsg.procedureCode = ProcedureCode_id_RICindication;
+    ind.initmsg.criticality = Criticality_ignore;
+    ind.initmsg.value.present = InitiatingMessage__value_PR_RICindication;
+
+    ind.pdu.present = E2AP_PDU_PR_initiatingMessage;
+    ind.pdu.choice.initiatingMessage = &ind.initmsg;
+}
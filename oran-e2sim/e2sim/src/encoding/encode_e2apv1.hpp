@@ -29,6 +29,8 @@ extern "C" {
 
 #include "E2AP-PDU.h"
 #include "OCTET_STRING.h"
+#include "InitiatingMessage.h"
+#include "ProtocolIE-Field.h"
 
 }
 
@@ -39,6 +41,16 @@ namespace encoding {
     OCTET_STRING_t *ranFunctionDesc;
     long ranFunctionRev;
   };
+
+  // Storage for a RIC indication built without heap allocations. The octet
+  // strings point to the caller's buffers, so the PDU must not be freed with
+  // ASN_STRUCT_FREE and is only valid as long as those buffers are.
+  struct indication_pdu {
+    E2AP_PDU_t pdu;
+    InitiatingMessage_t initmsg;
+    RICindication_IEs_t ies[8];
+    RICindication_IEs_t *ie_list[8];
+  };
   
   long get_function_id_from_subscription(E2AP_PDU_t *e2ap_pdu);
   
@@ -52,12 +64,21 @@ namespace encoding {
 
   void generate_e2apv1_ric_control_acknowledge(E2AP_PDU_t *control_resp_pdu);
 
+  // RIC control acknowledge / failure of a given request, sent once the control
+  // has been applied. The outcome, e.g., a JSON report, is copied into the
+  // optional RICcontrolOutcome IE, omitted if outcome_length is 0.
+  void generate_e2apv1_ric_control_acknowledge_parameterized(E2AP_PDU_t *control_ack_pdu, long requestorId, long instanceId, long ranFunctionId, const uint8_t *outcome_buf, int outcome_length);
+
+  void generate_e2apv1_ric_control_failure(E2AP_PDU_t *control_fail_pdu, long requestorId, long instanceId, long ranFunctionId, long ricCause, const uint8_t *outcome_buf, int outcome_length);
+
   void generate_e2apv1_subscription_response(E2AP_PDU_t *sub_resp_pdu, E2AP_PDU_t *sub_req_pdu);
   
   void generate_e2apv1_subscription_response_success(E2AP_PDU *e2ap_pdu, long reqActionIdsAccepted[], long reqActionIdsRejected[], int accept_size, int reject_size, long reqRequestorId, long reqInstanceId);
   
   void generate_e2apv1_indication_request_parameterized(E2AP_PDU *e2ap_pdu, long requestorId, long instanceId, long ranFunctionId, long actionId, long seqNum, uint8_t *ind_header_buf, int header_length, uint8_t *ind_message_buf, int message_length);
   
+  void build_e2apv1_indication_by_reference(indication_pdu &ind, long requestorId, long instanceId, long ranFunctionId, long actionId, long seqNum, const uint8_t *ind_header_buf, int header_length, const uint8_t *ind_message_buf, int message_length);
+
   void generate_e2apv1_service_update(E2AP_PDU_t *e2ap_pdu, std::vector<ran_func_info> all_funcs);
 
   long get_function_id_from_control_request(E2AP_PDU_t *pdu);
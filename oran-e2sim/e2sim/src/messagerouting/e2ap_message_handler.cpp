@@ -242,6 +242,11 @@ void e2ap_handle_RICControlRequest(E2AP_PDU_t *pdu, int &socket_fd, E2Sim *e2sim
         LOG_E("Error: No RAN Function with this ID exists");
     }
 
+    if (func_exists && e2sim->is_control_acknowledge_deferred()) {
+        // the service model acknowledges the request once it is applied
+        return;
+    }
+
     auto* res_pdu = (E2AP_PDU_t*)calloc(1, sizeof(E2AP_PDU));
     encoding::generate_e2apv1_ric_control_acknowledge(res_pdu);
 